@@ -38,6 +38,28 @@ namespace BlackJawz::Component
             ++size;
         }
 
+        // Insert components for many new entities in one pass, used when loading scenes
+        void InsertBulk(const std::vector<BlackJawz::Entity::Entity>& entities, std::vector<T>&& components)
+        {
+            entityToIndex.reserve(size + entities.size());
+            indexToEntity.reserve(size + entities.size());
+
+            for (size_t i = 0; i < entities.size(); ++i)
+            {
+                if (HasData(entities[i]))
+                {
+                    componentArray[entityToIndex[entities[i]]] = std::move(components[i]);
+                    continue;
+                }
+
+                size_t index = size;
+                entityToIndex[entities[i]] = index;
+                indexToEntity[index] = entities[i];
+                componentArray[index] = std::move(components[i]);
+                ++size;
+            }
+        }
+
         void RemoveData(BlackJawz::Entity::Entity entity)
         {
             // Ensure the entity exists
@@ -51,13 +73,16 @@ namespace BlackJawz::Component
             if (index != lastIndex)
             {
                 // Move last element into the deleted entity's slot
-                componentArray[index] = componentArray[lastIndex];
+                componentArray[index] = std::move(componentArray[lastIndex]);
 
                 BlackJawz::Entity::Entity lastEntity = indexToEntity[lastIndex];
                 entityToIndex[lastEntity] = index;  // Update moved entity's index
                 indexToEntity[index] = lastEntity;
             }
 
+            // Release what the vacated slot holds, textures and buffers would stay alive otherwise
+            componentArray[lastIndex] = T();
+
             // Erase entity references
             entityToIndex.erase(entity);
             indexToEntity.erase(index); // Fix: Erase `index`, not `lastIndex`
@@ -0,0 +1,50 @@
+#pragma once
+#include "../pch.h"
+#include "Components.h"
+#include "../Scene/SceneReflection.h"
+
+// Field lists of the components stored in scene files. Each field names the table slot it is
+// saved in, so conversions to and from the scene records pair fields by slot.
+namespace BlackJawz::Scene::Reflection
+{
+	template <> struct FloatCount<DirectX::XMFLOAT3> : std::integral_constant<uint32_t, 3> {};
+	template <> struct FloatCount<DirectX::XMFLOAT4> : std::integral_constant<uint32_t, 4> {};
+	template <> struct FloatCount<DirectX::XMFLOAT4X4> : std::integral_constant<uint32_t, 16> {};
+
+	template <>
+	struct Reflect<Component::Transform>
+	{
+		static constexpr std::array<FieldInfo, 4> Fields =
+		{
+			BLACKJAWZ_FIELD(Component::Transform, position, ECS::Transform::VT_POSITION),
+			BLACKJAWZ_FIELD(Component::Transform, rotation, ECS::Transform::VT_ROTATION),
+			BLACKJAWZ_FIELD(Component::Transform, scale, ECS::Transform::VT_SCALE),
+			BLACKJAWZ_FIELD(Component::Transform, worldMatrix, ECS::Transform::VT_WORLD_MATRIX)
+		};
+	};
+	static_assert(CoversLayout<Component::Transform>(), "Every Transform member needs a field");
+
+	template <>
+	struct Reflect<Component::Light>
+	{
+		static constexpr std::array<FieldInfo, 12> Fields =
+		{
+			BLACKJAWZ_FIELD(Component::Light, Type, ECS::Light::VT_TYPE),
+			BLACKJAWZ_FIELD(Component::Light, DiffuseLight, ECS::Light::VT_DIFFUSE_LIGHT),
+			BLACKJAWZ_FIELD(Component::Light, AmbientLight, ECS::Light::VT_AMBIENT_LIGHT),
+			BLACKJAWZ_FIELD(Component::Light, SpecularLight, ECS::Light::VT_SPECULAR_LIGHT),
+			BLACKJAWZ_FIELD(Component::Light, SpecularPower, ECS::Light::VT_SPECULAR_POWER),
+			BLACKJAWZ_FIELD(Component::Light, Range, ECS::Light::VT_RANGE),
+			BLACKJAWZ_FIELD(Component::Light, Direction, ECS::Light::VT_DIRECTION),
+			BLACKJAWZ_FIELD(Component::Light, Intensity, ECS::Light::VT_INTENSITY),
+			BLACKJAWZ_FIELD(Component::Light, Attenuation, ECS::Light::VT_ATTENUATION),
+			BLACKJAWZ_FIELD(Component::Light, Padding, 0), // Not saved
+			BLACKJAWZ_FIELD(Component::Light, SpotInnerCone, ECS::Light::VT_SPOT_INNER_CONE),
+			BLACKJAWZ_FIELD(Component::Light, SpotOuterCone, ECS::Light::VT_SPOT_OUTER_CONE)
+		};
+	};
+	static_assert(CoversLayout<Component::Light>(), "Every Light member needs a field");
+
+	// The editor's transform is stored as it is in memory
+	static_assert(SameLayout<Component::Transform, TransformData>(), "Transforms are copied whole");
+}
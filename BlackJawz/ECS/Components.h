@@ -11,6 +11,13 @@ namespace BlackJawz::Component
 
 		UINT vertexBufferStride;
 		UINT vertexBufferOffset;
+
+		// Local space bounds of the vertex positions, for culling and picking. Packed vertices
+		// store positions relative to them and always have them, see Scene/VertexPacking.h
+		bool packedVertices = false;
+		bool hasBounds = false;
+		DirectX::XMFLOAT3 boundsMin = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+		DirectX::XMFLOAT3 boundsMax = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
 	};
 
 	struct Transform
@@ -42,6 +49,27 @@ namespace BlackJawz::Component
 		}
 	};
 
+	// Placement of one instance relative to the entity's transform
+	struct InstanceTransform
+	{
+		DirectX::XMFLOAT3 position = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+		DirectX::XMFLOAT3 rotation = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
+		DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1.0f, 1.0f, 1.0f);
+	};
+
+	// Copies of an appearance drawn with one instanced call. The renderer rebuilds the
+	// instance buffer from the transforms whenever dirty is set.
+	struct Instances
+	{
+		std::vector<InstanceTransform> transforms;
+		UINT paramStride = 0; // Floats per instance in params, carried through saves for systems that use them
+		std::vector<float> params;
+
+		ComPtr<ID3D11Buffer> pInstanceBuffer; // One world matrix per instance
+		UINT bufferCapacity = 0;
+		bool dirty = true;
+	};
+
 	struct Appearance
 	{
 		// Constructor to initialize with Geometry data
@@ -93,6 +121,8 @@ namespace BlackJawz::Component
 		ComPtr<ID3D11ShaderResourceView> GetTextureRoughness() const { return textureDataRoughness; }
 		ComPtr<ID3D11ShaderResourceView> GetTextureAO() const { return textureDataAO; }
 		ComPtr<ID3D11ShaderResourceView> GetTextureDisplacement() const { return textureDataDisplacement; }
+		ComPtr<ID3D11ShaderResourceView> GetTexturePacked() const { return textureDataPacked; }
+		ComPtr<ID3D11ShaderResourceView> GetTextureConeStep() const { return textureDataConeStep; }
 
 		bool HasTextureDiffuse()
 		{
@@ -142,6 +172,22 @@ namespace BlackJawz::Component
 			}
 			return false;
 		}
+		bool HasTexturePacked()
+		{
+			if (textureDataPacked != nullptr)
+			{
+				return true;
+			}
+			return false;
+		}
+		bool HasTextureConeStep()
+		{
+			if (textureDataConeStep != nullptr)
+			{
+				return true;
+			}
+			return false;
+		}
 
 		ComPtr<ID3D11ShaderResourceView> textureDataDiffuse;
 		ComPtr<ID3D11ShaderResourceView> textureDataNormal;
@@ -149,6 +195,17 @@ namespace BlackJawz::Component
 		ComPtr<ID3D11ShaderResourceView> textureDataRoughness;
 		ComPtr<ID3D11ShaderResourceView> textureDataAO;
 		ComPtr<ID3D11ShaderResourceView> textureDataDisplacement;
+		// Cooked scenes pack metal, roughness, AO and displacement into the red, green, blue and alpha
+		// channels of one texture. When set it is bound in place of the four separate maps.
+		ComPtr<ID3D11ShaderResourceView> textureDataPacked;
+		// Relaxed cone step map the cooker builds from the displacement. When set the parallax march
+		// steps through it instead of marching the displacement in fixed layers.
+		ComPtr<ID3D11ShaderResourceView> textureDataConeStep;
+
+		// Shared by copies of the component, the arrays can hold hundreds of thousands of instances
+		std::shared_ptr<Instances> instances;
+
+		bool HasInstances() const { return instances != nullptr; }
 	};
 
 	enum class LightType : int
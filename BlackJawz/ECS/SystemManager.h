@@ -10,6 +10,15 @@ namespace BlackJawz::System
         System() = default;
         virtual ~System() = default; 
 		std::set<BlackJawz::Entity::Entity> entities;
+
+		// Add many entities at once, cheapest when they arrive in ascending order
+		void AddEntities(const std::vector<BlackJawz::Entity::Entity>& newEntities)
+		{
+			for (auto entity : newEntities)
+			{
+				entities.insert(entities.end(), entity);
+			}
+		}
 	};
 
     class SystemManager 
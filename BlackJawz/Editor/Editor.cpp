@@ -1,4 +1,10 @@
 #include "Editor.h"
+#include "SceneConversion.h"
+#include "../Scene/SceneJournal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
 
 extern const std::filesystem::path filePath = std::filesystem::current_path();
 
@@ -17,6 +23,9 @@ BlackJawz::Editor::Editor::Editor() : currentPath(filePath)
 	transformSystem = systemManager.RegisterSystem<BlackJawz::System::TransformSystem>(transformArray);
 	appearanceSystem = systemManager.RegisterSystem<BlackJawz::System::AppearanceSystem>(appearanceArray);
 	lightSystem = systemManager.RegisterSystem<BlackJawz::System::LightSystem>(lightArray, transformArray);
+
+	jobSystem = std::make_unique<BlackJawz::Jobs::JobSystem>();
+	sceneSaveTask = std::make_unique<SceneSaveTask>(*jobSystem);
 }
 
 BlackJawz::Editor::Editor::~Editor()
@@ -26,6 +35,16 @@ BlackJawz::Editor::Editor::~Editor()
 
 void BlackJawz::Editor::Editor::Initialise(Rendering::Render& renderer)
 {
+	resourceBackend = std::make_unique<Rendering::D3D11ResourceBackend>(renderer.GetDevice());
+	assetCache = std::make_unique<Rendering::AssetCache>(renderer.GetDevice(), *jobSystem);
+	assetCache->SetMemoryBudget(static_cast<uint64_t>(textureBudgetMb) * 1024 * 1024);
+	sceneLoader = std::make_unique<Scene::SceneLoader>(*jobSystem, *resourceBackend);
+	sceneLoadTask = std::make_unique<SceneLoadTask>(*sceneLoader,
+		[this](size_t index, Scene::EntityData& data, const Scene::ResourceSlots& slots) { InsertLoadedEntity(index, data, slots); });
+	cellStreamer = std::make_unique<Scene::CellStreamer>(*sceneLoader,
+		[this](const Scene::CellCoord& cell, Scene::LoadedScene& loadedScene) { InsertCell(cell, loadedScene); },
+		[this](const Scene::CellCoord& cell) { return RemoveCell(cell); });
+
 	//LoadScene("Scenes/Default.bin", renderer);
 }
 
@@ -82,6 +101,37 @@ void BlackJawz::Editor::Editor::Render(Rendering::Render& renderer)
 	renderer.SetProjectionMatrix(editorCamera->GetProjectionMatrix());
 	renderer.SetCameraPosition(editorCamera->GetPosition());
 
+	// Advance any in-progress save or load before the menu bar reports on it
+	sceneSaveTask->Update(renderer.GetDevice(), renderer.GetDeviceContext());
+	if (saveInProgress && !sceneSaveTask->IsBusy())
+	{
+		FinishSave();
+	}
+
+	if (sceneLoadTask->Update())
+	{
+		// The components hold their own references now
+		resourceBackend->Clear();
+
+		baseScenePath = sceneLoadTask->GetJournalId() != 0 ? sceneLoadTask->GetFilename() : "";
+		baseJournalId = sceneLoadTask->GetJournalId();
+
+		AdoptSpatialIndex(sceneLoadTask->TakeSpatialIndex(), std::move(loadingEntities));
+		loadingEntities.clear();
+	}
+
+	// Textures finished loading in the background replace their placeholders, a budget's worth per frame
+	SwapTextures(assetCache->Update());
+
+	frameTimes[frameTimeIndex] = io.DeltaTime * 1000.0f;
+	frameTimeIndex = (frameTimeIndex + 1) % frameTimes.size();
+
+	// Paused while a save reads cells from the same file
+	if (cellStreamer->IsOpen() && !saveInProgress)
+	{
+		float position[3] = { cameraPosition.x, cameraPosition.y, cameraPosition.z };
+		cellStreamer->Update(position, io.DeltaTime);
+	}
 
 	// Render editor components
 	MenuBar(renderer);          // Menu at the top
@@ -94,586 +144,820 @@ void BlackJawz::Editor::Editor::Render(Rendering::Render& renderer)
 	renderer.EndFrame();
 }
 
-// Utility function to extract data from a ID3D11Buffer
-std::vector<uint8_t> ExtractBufferData(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11Buffer* buffer)
+void BlackJawz::Editor::Editor::SaveScene(const std::string& filename)
 {
-	// Get original buffer description.
-	D3D11_BUFFER_DESC desc;
-	buffer->GetDesc(&desc);
-
-	// Create a staging buffer description.
-	D3D11_BUFFER_DESC stagingDesc = desc;
-	stagingDesc.Usage = D3D11_USAGE_STAGING;
-	stagingDesc.BindFlags = 0;                // No bind flags for staging
-	stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-
-	// Create the staging buffer.
-	ComPtr<ID3D11Buffer> stagingBuffer;
-	HRESULT hr = device->CreateBuffer(&stagingDesc, nullptr, stagingBuffer.GetAddressOf());
-	if (FAILED(hr))
+	// A streamed scene only has its resident cells in memory, it can only be saved partitioned
+	bool partitioned = worldPartitionSaves || cellStreamer->IsOpen();
+
+	// Small edits go to the journal, the base is rewritten once the journal has grown too large
+	if (!partitioned && journaledSaves && filename == baseScenePath && !Scene::SceneJournal::ShouldCompact(filename))
 	{
-		// Handle error.
-		return {};
+		SaveSceneDelta(filename);
+		return;
 	}
 
-	// Copy the content of the original GPU buffer into the staging buffer.
-	context->CopyResource(stagingBuffer.Get(), buffer);
+	// A new journal id leaves any records from the previous base behind
+	uint64_t journalId = 0;
+	if (journaledSaves && !partitioned)
+	{
+		std::random_device device;
+		journalId = (static_cast<uint64_t>(device()) << 32) | device() | 1;
+	}
 
-	// Map the staging buffer for reading.
-	D3D11_MAPPED_SUBRESOURCE mappedResource;
-	hr = context->Map(stagingBuffer.Get(), 0, D3D11_MAP_READ, 0, &mappedResource);
-	if (FAILED(hr))
+	sceneSaveTask->SetCompressAssets(compressSceneAssets);
+	sceneSaveTask->SetPackVertices(packVerticesOnSave);
+	if (cellStreamer->IsOpen())
 	{
-		// Handle error.
-		return {};
+		const Scene::WorldPartition& partition = cellStreamer->GetPartition();
+		sceneSaveTask->SetWorldPartition(partition.GetCellSize(), &partition, cellStreamer->GetResidentCells());
 	}
+	else
+	{
+		sceneSaveTask->SetWorldPartition(partitioned ? Scene::WorldPartition::DefaultCellSize : 0.0f);
+	}
+
+	if (!sceneSaveTask->Begin(filename, journalId))
+		return;
+
+	// The snapshot has to hold the real textures, not their placeholders
+	SwapTextures(assetCache->Flush());
+
+	// Snapshot the components here, the readback and serialization carry on over the following frames
+	for (auto entity : entities)
+	{
+		auto it = entityNames.find(entity);
+		std::string nameStr = (it != entityNames.end()) ? it->second : "";
 
-	// Copy the data from the mapped staging resource.
-	uint8_t* dataPtr = static_cast<uint8_t*>(mappedResource.pData);
-	std::vector<uint8_t> data(dataPtr, dataPtr + desc.ByteWidth);
+		sceneSaveTask->AddEntity(GetSavedId(entity), nameStr,
+			transformArray.HasData(entity) ? &transformArray.GetData(entity) : nullptr,
+			appearanceArray.HasData(entity) ? &appearanceArray.GetData(entity) : nullptr,
+			lightArray.HasData(entity) ? &lightArray.GetData(entity) : nullptr);
+	}
 
-	context->Unmap(stagingBuffer.Get(), 0);
-	return data;
+	sceneChanges.Clear();
+	saveInProgress = true;
 }
 
-std::vector<uint8_t> ExtractTextureData(ID3D11Device* device, ID3D11DeviceContext* context, ID3D11ShaderResourceView* srv)
+void BlackJawz::Editor::Editor::SaveSceneDelta(const std::string& filename)
 {
-	// Get the resource from the SRV.
-	ComPtr<ID3D11Resource> resource;
-	srv->GetResource(resource.GetAddressOf());
-
-	// Ensure it's a 2D texture.
-	ComPtr<ID3D11Texture2D> texture;
-	HRESULT hr = resource.As(&texture);
-	if (FAILED(hr))
-		return {};
-
-	// Use DirectXTex to capture the texture
-	DirectX::ScratchImage image;
-	hr = DirectX::CaptureTexture(device, context, texture.Get(), image);
-	if (FAILED(hr))
+	if (sceneChanges.Empty())
 	{
-		OutputDebugStringA("Failed to capture texture.\n");
-		return {};
+		OutputDebugStringA(("No changes to save in " + filename + "\n").c_str());
+		return;
 	}
 
-	// Convert the image to a DDS memory buffer
-	DirectX::Blob ddsBlob;
-	hr = DirectX::SaveToDDSMemory(*image.GetImage(0, 0, 0), DirectX::DDS_FLAGS_NONE, ddsBlob);
-	if (FAILED(hr))
+	sceneSaveTask->SetPackVertices(packVerticesOnSave);
+	if (!sceneSaveTask->BeginDelta(filename, baseJournalId, sceneChanges.GetRemoved()))
+		return;
+
+	SwapTextures(assetCache->Flush());
+
+	// Walk the entity list rather than the change set so records keep the hierarchy order
+	const auto& changed = sceneChanges.GetChanged();
+	for (auto entity : entities)
 	{
-		OutputDebugStringA("Failed to save DDS to memory.\n");
-		return {};
+		auto changedIt = changed.find(entity);
+		if (changedIt == changed.end())
+			continue;
+
+		uint32_t flags = changedIt->second;
+
+		auto nameIt = entityNames.find(entity);
+		std::string nameStr = (nameIt != entityNames.end()) ? nameIt->second : "";
+
+		bool hasTransform = (flags & Scene::ChangeTracker::TransformChanged) && transformArray.HasData(entity);
+		bool hasAppearance = (flags & Scene::ChangeTracker::AppearanceChanged) && appearanceArray.HasData(entity);
+		bool hasLight = (flags & Scene::ChangeTracker::LightChanged) && lightArray.HasData(entity);
+
+		sceneSaveTask->AddEntity(GetSavedId(entity), nameStr,
+			hasTransform ? &transformArray.GetData(entity) : nullptr,
+			hasAppearance ? &appearanceArray.GetData(entity) : nullptr,
+			hasLight ? &lightArray.GetData(entity) : nullptr);
 	}
 
-	// Return the DDS data as a vector
-	std::vector<uint8_t> ddsData((uint8_t*)ddsBlob.GetBufferPointer(),
-		(uint8_t*)ddsBlob.GetBufferPointer() + ddsBlob.GetBufferSize());
-	return ddsData;
+	sceneChanges.Clear();
+	saveInProgress = true;
 }
 
-void BlackJawz::Editor::Editor::SaveScene(const std::string& filename, Rendering::Render& renderer)
+void BlackJawz::Editor::Editor::FinishSave()
 {
-	// Create a FlatBufferBuilder with an initial size (in bytes)
-	flatbuffers::FlatBufferBuilder builder(1024);
+	saveInProgress = false;
 
-	// This vector will hold the offsets to each serialized Entity.
-	std::vector<flatbuffers::Offset<ECS::Entity>> entityOffsets;
+	if (sceneSaveTask->GetStage() != SceneSaveTask::Stage::Done)
+	{
+		// The changes in the failed save are no longer tracked, so the next save has to be a full one
+		baseScenePath.clear();
+		return;
+	}
 
-	// Iterate through all entities in the scene.
-	for (auto entity : entities)
+	if (!sceneSaveTask->IsDelta())
 	{
-		// Get the name from the map
-		auto it = entityNames.find(entity);
-		std::string nameStr = (it != entityNames.end()) ? it->second : "";
-		auto nameOffset = builder.CreateString(nameStr);
+		// Partitioned saves have no journal id, the next save has to be a full one as well
+		baseScenePath = journaledSaves && sceneSaveTask->GetJournalId() != 0 ? sceneSaveTask->GetFilename() : "";
+		baseJournalId = sceneSaveTask->GetJournalId();
+	}
 
-		// --- Serialize the Transform component ---
-		flatbuffers::Offset<ECS::Transform> transformOffset;
-		if (transformArray.HasData(entity))
+	// Keep streaming from the file just written, its cells have moved
+	if (cellStreamer->IsOpen())
+	{
+		if (cellStreamer->Reopen(sceneSaveTask->GetFilename()))
 		{
-			auto& transform = transformArray.GetData(entity);
-			// Update the world matrix before serializing.
-			transform.UpdateWorldMatrix();
-
-			// Create vectors for position, rotation, and scale.
-			auto posVec = builder.CreateVector(std::vector<float>{
-				transform.position.x, transform.position.y, transform.position.z});
-			auto rotVec = builder.CreateVector(std::vector<float>{
-				transform.rotation.x, transform.rotation.y, transform.rotation.z});
-			auto scaleVec = builder.CreateVector(std::vector<float>{
-				transform.scale.x, transform.scale.y, transform.scale.z});
-
-			// Serialize the world matrix as a flat array of 16 floats.
-			float* matrixPtr = reinterpret_cast<float*>(&transform.worldMatrix);
-			auto worldMatrixVec = builder.CreateVector(std::vector<float>(
-				matrixPtr, matrixPtr + 16));
-
-			 transformOffset = ECS::CreateTransform(builder,
-				posVec, rotVec, scaleVec, worldMatrixVec);
+			AssignCells();
 		}
-
-		// --- Serialize the Appearance (and its Geometry) component ---
-		flatbuffers::Offset<ECS::Appearance> appearanceOffset;
-		if (appearanceArray.HasData(entity))
+		else
 		{
-			auto& appearanceComp = appearanceArray.GetData(entity);
-			auto geometry = appearanceComp.GetGeometry();
+			OutputDebugStringA(("Failed to reopen " + sceneSaveTask->GetFilename() + " for streaming\n").c_str());
+		}
+	}
+}
 
-			// Extract the vertex and index buffer data
-			auto vertexData = ExtractBufferData(renderer.GetDevice(), renderer.GetDeviceContext(), geometry.pVertexBuffer.Get());
-			auto indexData = ExtractBufferData(renderer.GetDevice(), renderer.GetDeviceContext(), geometry.pIndexBuffer.Get());
+uint32_t BlackJawz::Editor::Editor::GetSavedId(BlackJawz::Entity::Entity entity)
+{
+	// Live entity ids are recycled, so entities get their own id the first time they are saved
+	auto it = savedIds.find(entity);
+	if (it != savedIds.end())
+		return it->second;
+
+	uint32_t id = nextSavedId++;
+	savedIds.emplace(entity, id);
+	return id;
+}
 
-			// Create FlatBuffers vectors for the vertex and index data
-			auto vertexBufferVec = builder.CreateVector(vertexData);
-			auto indexBufferVec = builder.CreateVector(indexData);
+void BlackJawz::Editor::Editor::ClearScene()
+{
+	cellStreamer->Close();
+	cellEntities.clear();
+	pinnedCells.clear();
 
-			flatbuffers::Offset<ECS::Geometry> geometryOffset;
-			if (!vertexData.empty() && !indexData.empty()) 
-			{
-				auto vertexBufferVec = builder.CreateVector(vertexData);
-				auto indexBufferVec = builder.CreateVector(indexData);
-
-				geometryOffset = ECS::CreateGeometry(builder,
-					geometry.IndicesCount,
-					geometry.vertexBufferStride,
-					geometry.vertexBufferOffset,
-					vertexBufferVec,
-					indexBufferVec
-				);
-			}
-			flatbuffers::Offset<flatbuffers::Vector<uint8_t>> textureVecDiffuse;
-			flatbuffers::Offset<flatbuffers::Vector<uint8_t>> textureVecNormal;
-			flatbuffers::Offset<flatbuffers::Vector<uint8_t>> textureVecMetal;
-			flatbuffers::Offset<flatbuffers::Vector<uint8_t>> textureVecRoughness;
-			flatbuffers::Offset<flatbuffers::Vector<uint8_t>> textureVecAO;
-			flatbuffers::Offset<flatbuffers::Vector<uint8_t>> textureVecDisplacement;
-
-			if (appearanceComp.HasTextureDiffuse())
-			{
-				auto textureDataDiffuse = ExtractTextureData(renderer.GetDevice(), renderer.GetDeviceContext(),
-					appearanceComp.GetTextureDiffuse().Get());
-				 textureVecDiffuse = builder.CreateVector(textureDataDiffuse);
-			}
+	for (auto entity : entities)
+	{
+		DestroyEntity(entity);
+	}
+	entities.clear();
+	entityNames.clear();
+	selectedObject = -1;
 
-			if (appearanceComp.HasTextureNormal())
-			{
-				auto textureDataNormal = ExtractTextureData(renderer.GetDevice(), renderer.GetDeviceContext(),
-					appearanceComp.GetTextureNormal().Get());
-				 textureVecNormal = builder.CreateVector(textureDataNormal);
-			}
-	
-			if (appearanceComp.HasTextureMetal())
-			{
-				auto textureDataMetal = ExtractTextureData(renderer.GetDevice(), renderer.GetDeviceContext(),
-					appearanceComp.GetTextureMetal().Get());
-				 textureVecMetal = builder.CreateVector(textureDataMetal);
-			}
+	spatialIndex.Clear();
+	spatialEntities.clear();
+	spatialSlots.clear();
+	spatialIndexStale = true;
+	loadingEntities.clear();
 
-			if (appearanceComp.HasTextureRoughness())
-			{
-				auto textureDataRoughness = ExtractTextureData(renderer.GetDevice(), renderer.GetDeviceContext(),
-					appearanceComp.GetTextureRoughness().Get());
-				 textureVecRoughness = builder.CreateVector(textureDataRoughness);
-			}
+	sceneChanges.Clear();
+	savedIds.clear();
+	nextSavedId = 0;
+	baseScenePath.clear();
 
-			if (appearanceComp.HasTextureAO())
-			{
-				auto textureDataAO = ExtractTextureData(renderer.GetDevice(), renderer.GetDeviceContext(),
-					appearanceComp.GetTextureAO().Get());
-				 textureVecAO = builder.CreateVector(textureDataAO);
-			}
+	assetCache->Trim();
+}
 
-			if (appearanceComp.HasTextureDisplacement())
-			{
+void BlackJawz::Editor::Editor::DestroyEntity(BlackJawz::Entity::Entity entity)
+{
+	transformSystem->RemoveEntity(entity);
+	appearanceSystem->RemoveEntity(entity);
+	lightSystem->RemoveEntity(entity);
 
-				auto textureDataDisplacement = ExtractTextureData(renderer.GetDevice(), renderer.GetDeviceContext(),
-					appearanceComp.GetTextureDisplacement().Get());
-				 textureVecDisplacement = builder.CreateVector(textureDataDisplacement);
-			}
+	if (transformArray.HasData(entity)) transformArray.RemoveData(entity);
+	if (appearanceArray.HasData(entity)) appearanceArray.RemoveData(entity);
+	if (lightArray.HasData(entity)) lightArray.RemoveData(entity);
 
-			auto textureOffset = ECS::CreateTexture(builder, textureVecDiffuse, textureVecNormal, textureVecMetal, 
-				textureVecRoughness, textureVecAO, textureVecDisplacement);
+	entityManager.DestroyEntity(entity);
+	entityManager.SetSignature(entity, std::bitset<32>());
 
-			appearanceOffset = ECS::CreateAppearance(builder, geometryOffset, textureOffset);
-		}
-		// --- Serialize Light Component (if entity has light) ---
-		flatbuffers::Offset<ECS::Light> lightOffset;
-		if (lightArray.HasData(entity))
-		{
-			auto& light = lightArray.GetData(entity);
-
-			auto diffuseVec = builder.CreateVector(std::vector<float>{
-				light.DiffuseLight.x, light.DiffuseLight.y, light.DiffuseLight.z, light.DiffuseLight.w });
-
-			auto ambientVec = builder.CreateVector(std::vector<float>{
-				light.AmbientLight.x, light.AmbientLight.y, light.AmbientLight.z, light.AmbientLight.w });
-
-			auto specularVec = builder.CreateVector(std::vector<float>{
-				light.SpecularLight.x, light.SpecularLight.y, light.SpecularLight.z, light.SpecularLight.w });
-
-			auto attenuationVec = builder.CreateVector(std::vector<float>{
-				light.Attenuation.x, light.Attenuation.y, light.Attenuation.z });
-
-			auto directionVec = builder.CreateVector(std::vector<float>{
-				light.Direction.x, light.Direction.y, light.Direction.z });
-
-			lightOffset = ECS::CreateLight(builder,
-				static_cast<ECS::LightType>(light.Type),
-				diffuseVec,
-				ambientVec,
-				specularVec,
-				light.SpecularPower,
-				light.Range,
-				directionVec,
-				light.Intensity,
-				attenuationVec,
-				light.SpotInnerCone,
-				light.SpotOuterCone);
-		}
+	spatialIndexStale = true;
+}
 
-		// --- Create the Entity ---
-		// Here we assume that CreateEntity takes the following parameters:
-		// (builder, id, name, transform, appearance)
-		// Adjust the parameter order and types according to your generated code.
-		auto entityOffset = ECS::CreateEntity(builder,
-			static_cast<uint32_t>(entity),  // Assuming your entity ID is convertible to uint32_t
-			nameOffset,
-			transformOffset,
-			appearanceOffset,
-			lightOffset);
-
-		// Add the created Entity offset to our vector.
-		entityOffsets.push_back(entityOffset);
-	}
+void BlackJawz::Editor::Editor::RemoveEntities(const std::vector<BlackJawz::Entity::Entity>& removed)
+{
+	if (removed.empty())
+		return;
 
-	// Create a FlatBuffers vector from the vector of Entity offsets.
-	auto entitiesVector = builder.CreateVector(entityOffsets);
+	std::unordered_set<BlackJawz::Entity::Entity> removedSet(removed.begin(), removed.end());
 
-	// Create the final Scene table with the entities vector.
-	auto sceneOffset = ECS::CreateScene(builder, entitiesVector);
+	// Entity ids are about to be recycled, keep the selection by entity rather than by index
+	std::optional<BlackJawz::Entity::Entity> selectedEntity;
+	if (selectedObject >= 0 && selectedObject < static_cast<int>(entities.size()))
+		selectedEntity = entities[selectedObject];
+	selectedObject = -1;
 
-	// Finish the buffer.
-	builder.Finish(sceneOffset);
+	entities.erase(std::remove_if(entities.begin(), entities.end(),
+		[&removedSet](BlackJawz::Entity::Entity entity) { return removedSet.count(entity) > 0; }), entities.end());
 
-	uint8_t* buf = builder.GetBufferPointer();
-	int size = builder.GetSize();
+	for (auto entity : removed)
+	{
+		DestroyEntity(entity);
+		entityNames.erase(entity);
+		savedIds.erase(entity);
+	}
 
-	// Write the serialized buffer to a binary file.
-	std::ofstream outFile(filename, std::ios::binary);
-	if (!outFile)
+	if (selectedEntity && removedSet.count(*selectedEntity) == 0)
 	{
-		// Handle file open error.
+		auto it = std::find(entities.begin(), entities.end(), *selectedEntity);
+		selectedObject = static_cast<int>(it - entities.begin());
+	}
+
+	assetCache->Trim();
+}
+
+void BlackJawz::Editor::Editor::SwapTextures(const std::vector<Rendering::AssetCache::TextureSwap>& swaps)
+{
+	if (swaps.empty())
 		return;
+
+	// Mip streaming can swap many views in one frame
+	std::unordered_map<ID3D11ShaderResourceView*, ID3D11ShaderResourceView*> replacements;
+	for (const Rendering::AssetCache::TextureSwap& swap : swaps)
+	{
+		replacements[swap.placeholder.Get()] = swap.view.Get();
 	}
-	outFile.write(reinterpret_cast<char*>(buf), size);
-	outFile.close();
+
+	for (auto entity : appearanceSystem->GetEntities())
+	{
+		BlackJawz::Component::Appearance& appearance = appearanceArray.GetData(entity);
+		ComPtr<ID3D11ShaderResourceView>* slots[] = { &appearance.textureDataDiffuse, &appearance.textureDataNormal,
+			&appearance.textureDataMetal, &appearance.textureDataRoughness, &appearance.textureDataAO, &appearance.textureDataDisplacement,
+			&appearance.textureDataPacked, &appearance.textureDataConeStep };
+
+		for (ComPtr<ID3D11ShaderResourceView>* slot : slots)
+		{
+			if (!*slot)
+				continue;
+
+			auto it = replacements.find(slot->Get());
+			if (it != replacements.end())
+			{
+				*slot = it->second;
+			}
+		}
+	}
+}
+
+void BlackJawz::Editor::Editor::InsertCell(const Scene::CellCoord& cell, Scene::LoadedScene& loadedScene)
+{
+	size_t firstEntity = entities.size();
+	InsertLoadedScene(loadedScene);
+
+	// Each cell's index only covers the cell, the resident cells are indexed together
+	spatialIndexStale = true;
+
+	// The components hold their own references now
+	resourceBackend->Clear();
+
+	cellEntities[cell].assign(entities.begin() + firstEntity, entities.end());
 }
 
-ComPtr<ID3D11Buffer> BlackJawz::Editor::Editor::CreateBuffer(ID3D11Device* device, const std::vector<uint8_t>& data, UINT stride)
+bool BlackJawz::Editor::Editor::RemoveCell(const Scene::CellCoord& cell)
 {
-	D3D11_BUFFER_DESC bufferDesc = {};
-	bufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	bufferDesc.ByteWidth = static_cast<UINT>(data.size());
-	bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_INDEX_BUFFER;
-	bufferDesc.CPUAccessFlags = 0;
-
-	D3D11_SUBRESOURCE_DATA initData = {};
-	initData.pSysMem = data.data();
-
-	ComPtr<ID3D11Buffer> buffer;
-	HRESULT hr = device->CreateBuffer(&bufferDesc, &initData, buffer.GetAddressOf());
-	if (FAILED(hr))
+	auto it = cellEntities.find(cell);
+	if (it == cellEntities.end())
+		return true;
+
+	// Unsaved edits would be lost, the cell stays until the next save
+	if (pinnedCells.count(cell) > 0)
+		return false;
+
+	const auto& changed = sceneChanges.GetChanged();
+	for (auto entity : it->second)
 	{
-		// Handle buffer creation error
-		return nullptr;
+		if (changed.count(entity) > 0)
+			return false;
 	}
 
-	return buffer;
+	RemoveEntities(it->second);
+	cellEntities.erase(it);
+	return true;
 }
 
-// Function to load texture from DDS data into SRV
-ComPtr<ID3D11ShaderResourceView> BlackJawz::Editor::Editor::LoadTextureFromDDSData(ID3D11Device* device, const std::vector<uint8_t>& textureData)
+void BlackJawz::Editor::Editor::AssignCells()
 {
-	ComPtr<ID3D11Resource> resource;
-	ComPtr<ID3D11ShaderResourceView> srv;
-
-	HRESULT hr = CreateDDSTextureFromMemory(
-		device,
-		textureData.data(),
-		textureData.size(),
-		resource.GetAddressOf(),  // Resource is optional but helps debugging
-		srv.ReleaseAndGetAddressOf()
-	);
+	// Every entity now belongs to the cell it was saved in. Entities saved into a cell that is not
+	// resident, because they were moved or added there, go until that cell streams in.
+	cellEntities.clear();
+	pinnedCells.clear();
 
-	if (FAILED(hr))
+	std::vector<BlackJawz::Entity::Entity> outside;
+	for (auto entity : entities)
 	{
-		char errorMsg[256];
-		snprintf(errorMsg, sizeof(errorMsg), "CreateDDSTextureFromMemory failed! HRESULT: 0x%08X\n", hr);
-		OutputDebugStringA(errorMsg);
-		return nullptr;
+		Scene::CellCoord cell = GetEntityCell(entity);
+		if (cellStreamer->IsResident(cell))
+		{
+			cellEntities[cell].push_back(entity);
+		}
+		else
+		{
+			outside.push_back(entity);
+		}
 	}
 
-	return srv;
+	RemoveEntities(outside);
+}
+
+BlackJawz::Scene::CellCoord BlackJawz::Editor::Editor::GetEntityCell(BlackJawz::Entity::Entity entity)
+{
+	// Same rule as the save, which works on the scene data
+	Scene::EntityData data;
+	if (transformArray.HasData(entity))
+		data.transform = ToTransformData(transformArray.GetData(entity));
+	if (lightArray.HasData(entity))
+		data.light = ToLightData(lightArray.GetData(entity));
+
+	return Scene::WorldPartition::GetEntityCell(data, cellStreamer->GetPartition().GetCellSize());
 }
 
 void BlackJawz::Editor::Editor::LoadScene(const std::string& filename, Rendering::Render& renderer)
 {
-	// Open the binary file
-	std::ifstream inFile(filename, std::ios::binary);
-	if (!inFile)
+	// Both share the loader
+	if (sceneLoadTask->IsBusy() || cellStreamer->IsLoading())
+		return;
+
+	// Partitioned scenes are streamed in around the camera over the following frames
+	if (streamWorldPartition)
+	{
+		Scene::WorldPartition partition;
+		if (partition.Open(filename))
+		{
+			ClearScene();
+			if (cellStreamer->Open(filename))
+			{
+				nextSavedId = partition.GetNextEntityId();
+			}
+			return;
+		}
+	}
+
+	if (incrementalLoading)
+	{
+		if (!std::filesystem::exists(filename))
+		{
+			// Handle file open error
+			return;
+		}
+
+		// Entities are added over the following frames as their resources become ready
+		if (sceneLoadTask->Begin(filename))
+		{
+			ClearScene();
+		}
+		return;
+	}
+
+	// Decoding and resource creation run on the job system and the loader thread
+	Scene::LoadedScene loadedScene;
+	if (!sceneLoader->Load(filename, loadedScene))
 	{
 		// Handle file open error
 		return;
 	}
 
-	// Read the file into a buffer
-	std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(inFile)), std::istreambuf_iterator<char>());
-	inFile.close();
+	auto insertStart = std::chrono::steady_clock::now();
+
+	// Clear the current scene before loading a new one
+	ClearScene();
+	InsertLoadedScene(loadedScene);
+	AdoptSpatialIndex(std::move(loadedScene.spatialIndex), entities);
+
+	baseScenePath = loadedScene.journalId != 0 ? filename : "";
+	baseJournalId = loadedScene.journalId;
+
+	// The components hold their own references now
+	resourceBackend->Clear();
+
+	double insertMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - insertStart).count();
+	const Scene::LoadStats& stats = sceneLoader->GetStats();
+
+	// Assets are decompressed while the entities decode, decompressMs is part of decodeMs
+	double totalMs = stats.readMs + stats.decodeMs + stats.uploadMs + insertMs;
+
+	char message[384];
+	snprintf(message, sizeof(message),
+		"Loaded %zu entities from %s: read %.1f ms, decompress %.1f ms, decode %.1f ms, upload %.1f ms, insert %.1f ms, %.1f MB/s\n",
+		loadedScene.entities.size(), filename.c_str(), stats.readMs, stats.decompressMs, stats.decodeMs, stats.uploadMs, insertMs,
+		totalMs > 0.0 ? stats.fileBytes / (1024.0 * 1024.0) / (totalMs / 1000.0) : 0.0);
+	OutputDebugStringA(message);
 
-	// Get the FlatBuffer scene from the buffer
-	auto scene = ECS::GetScene(buffer.data());
+	if (stats.rawAssetBytes > 0)
+	{
+		snprintf(message, sizeof(message), "Scene assets: %.1f MB stored, %.1f MB raw (%.0f%%), %zu failed to decode\n",
+			stats.assetBytes / (1024.0 * 1024.0), stats.rawAssetBytes / (1024.0 * 1024.0),
+			100.0 * static_cast<double>(stats.assetBytes) / static_cast<double>(stats.rawAssetBytes), stats.failedAssets);
+		OutputDebugStringA(message);
+	}
+}
 
-	if (!scene)
+void BlackJawz::Editor::Editor::ImportMesh(const std::string& filename, Rendering::Render& renderer)
+{
+	Scene::MeshImporter importer(jobSystem.get());
+	Scene::ImportedModel model;
+	Scene::MeshImportStats stats;
+	if (!importer.Import(filename, model, stats))
 	{
-		// Handle invalid scene data
+		OutputDebugStringA(("Failed to import " + filename + ": " + importer.GetLastError() + "\n").c_str());
 		return;
 	}
 
-	// Clear the current scene before loading a new one
-	for (auto entity : entities)
+	static_assert(sizeof(Vertex) == sizeof(Scene::ImportedVertex), "Imported vertices are copied whole");
+
+	std::filesystem::path path(filename);
+	std::filesystem::path directory = path.parent_path();
+	std::string stem = path.stem().string();
+
+	// The maps are expected next to the model, converted to DDS
+	auto getTexture = [&](const Scene::ImportedMaterial* material, Scene::TextureSlot slot, uint32_t placeholderColour)
+		{
+			ComPtr<ID3D11ShaderResourceView> texture;
+			if (material && !material->textures[static_cast<size_t>(slot)].empty())
+			{
+				std::filesystem::path texturePath = directory / material->textures[static_cast<size_t>(slot)];
+				texturePath.replace_extension(".dds");
+				texture = assetCache->GetTexture(texturePath.wstring(), placeholderColour);
+			}
+			return texture;
+		};
+
+	for (size_t i = 0; i < model.meshes.size(); ++i)
 	{
-		transformSystem->RemoveEntity(entity);
-		appearanceSystem->RemoveEntity(entity);
-		lightSystem->RemoveEntity(entity);
+		const Scene::ImportedMesh& mesh = model.meshes[i];
+
+		BlackJawz::Component::Geometry meshGeo;
+		bool created = assetCache->GetMesh(path.wstring() + L"#" + std::to_wstring(i), [&renderer, &mesh](BlackJawz::Component::Geometry& geometry)
+			{
+				std::vector<Vertex> vertices(mesh.vertices.size());
+				memcpy(vertices.data(), mesh.vertices.data(), mesh.vertices.size() * sizeof(Vertex));
+				return renderer.CreateMeshGeometry(vertices, mesh.indices, geometry);
+			}, meshGeo);
+		if (!created)
+		{
+			OutputDebugStringA(("Failed to create mesh " + std::to_string(i) + " of " + filename + "\n").c_str());
+			continue;
+		}
+
+		BlackJawz::Entity::Entity newEntity = entityManager.CreateEntity();
+		entities.push_back(newEntity);
+		entityNames[newEntity] = mesh.name.empty() ? stem + " " + std::to_string(i) : mesh.name;
+
+		BlackJawz::Component::Transform transform;
+		transformArray.InsertData(newEntity, transform);
+
+		const Scene::ImportedMaterial* material = mesh.material >= 0 ? &model.materials[mesh.material] : nullptr;
+		ComPtr<ID3D11ShaderResourceView> texDiffuse = getTexture(material, Scene::TextureSlot::Diffuse, Rendering::AssetCache::PlaceholderGrey);
+		ComPtr<ID3D11ShaderResourceView> texNormal = getTexture(material, Scene::TextureSlot::Normal, Rendering::AssetCache::PlaceholderFlatNormal);
+		ComPtr<ID3D11ShaderResourceView> texMetal = getTexture(material, Scene::TextureSlot::Metal, Rendering::AssetCache::PlaceholderBlack);
+		ComPtr<ID3D11ShaderResourceView> texRough = getTexture(material, Scene::TextureSlot::Roughness, Rendering::AssetCache::PlaceholderGrey);
+		ComPtr<ID3D11ShaderResourceView> texAO = getTexture(material, Scene::TextureSlot::AO, Rendering::AssetCache::PlaceholderWhite);
+		ComPtr<ID3D11ShaderResourceView> texDisplacement = getTexture(material, Scene::TextureSlot::Displacement, Rendering::AssetCache::PlaceholderBlack);
+
+		BlackJawz::Component::Appearance appearance(meshGeo, texDiffuse.Get(), texNormal.Get(), texMetal.Get(),
+			texRough.Get(), texAO.Get(), texDisplacement.Get());
+
+		appearanceArray.InsertData(newEntity, appearance);
+
+		std::bitset<32> signature;
+		signature.set(0);  // component 0 is Transform
+		signature.set(1);  // component 1 is Appearance
+		entityManager.SetSignature(newEntity, signature);
 
-		if (transformArray.HasData(entity)) transformArray.RemoveData(entity);
-		if (appearanceArray.HasData(entity)) appearanceArray.RemoveData(entity);
-	    if (lightArray.HasData(entity)) lightArray.RemoveData(entity);
+		transformSystem->AddEntity(newEntity);
+		systemManager.SetSignature<BlackJawz::System::TransformSystem>(signature);
 
-		entityManager.DestroyEntity(entity);
-		entityManager.SetSignature(entity, std::bitset<32>());
+		appearanceSystem->AddEntity(newEntity);
+		systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
+
+		sceneChanges.MarkChanged(newEntity, Scene::ChangeTracker::AllChanged);
+		spatialIndexStale = true;
 	}
-	entities.clear();
-	entityNames.clear();
 
-	// Load entities from the FlatBuffer
-	auto entitiesVector = scene->entities();
-	if (!entitiesVector) return;
+	char message[384];
+	snprintf(message, sizeof(message),
+		"Imported %zu meshes, %zu triangles from %s: map %.1f ms, parse %.1f ms, build %.1f ms, %.1f MB/s\n",
+		stats.meshCount, stats.triangleCount, filename.c_str(), stats.mapMs, stats.parseMs, stats.buildMs,
+		stats.totalMs > 0.0 ? stats.fileBytes / (1024.0 * 1024.0) / (stats.totalMs / 1000.0) : 0.0);
+	OutputDebugStringA(message);
+}
+
+void BlackJawz::Editor::Editor::InsertLoadedScene(Scene::LoadedScene& loadedScene)
+{
+	size_t count = loadedScene.entities.size();
+
+	// Work out which entities get which components first, so the components can be built in parallel straight into place
+	std::vector<size_t> transformSources, appearanceSources, lightSources;
+	std::vector<BlackJawz::Entity::Entity> transformEntities, appearanceEntities, lightEntities;
 
-	for (const auto* entityData : *entitiesVector)
+	entities.reserve(count);
+	entityNames.reserve(count);
+
+	for (size_t i = 0; i < count; ++i)
 	{
-		if (!entityData) continue;
+		Scene::EntityData& data = loadedScene.entities[i];
 
-		// Create a new entity
 		BlackJawz::Entity::Entity newEntity = entityManager.CreateEntity();
 		entities.push_back(newEntity);
 
-		// Load entity name
-		if (entityData->name())
+		savedIds[newEntity] = data.id;
+		nextSavedId = std::max(nextSavedId, data.id + 1);
+
+		if (!data.name.empty())
 		{
-			entityNames[newEntity] = entityData->name()->str();
+			entityNames[newEntity] = std::move(data.name);
 		}
 
-		// Set the ECS signature
 		std::bitset<32> signature;
-
-		// Load transform component
-		if (entityData->transform())
+		if (data.transform)
+		{
+			transformSources.push_back(i);
+			transformEntities.push_back(newEntity);
+			signature.set(0); // Assume Transform is component 0
+		}
+		if (data.appearance)
 		{
-			auto transformData = entityData->transform();
+			appearanceSources.push_back(i);
+			appearanceEntities.push_back(newEntity);
+			signature.set(1); // Assume Appearance is component 1
+		}
+		if (data.light)
+		{
+			lightSources.push_back(i);
+			lightEntities.push_back(newEntity);
+			signature.set(2); // Assume Light is component 2
+		}
 
-			BlackJawz::Component::Transform transform;
-			if (transformData->position()) {
-				auto pos = transformData->position();
-				transform.position = { pos->Get(0), pos->Get(1), pos->Get(2) };
-			}
-			if (transformData->rotation()) {
-				auto rot = transformData->rotation();
-				transform.rotation = { rot->Get(0), rot->Get(1), rot->Get(2) };
-			}
-			if (transformData->scale()) {
-				auto scale = transformData->scale();
-				transform.scale = { scale->Get(0), scale->Get(1), scale->Get(2) };
-			}
+		entityManager.SetSignature(newEntity, signature);
+	}
 
-			// Calculate the world matrix from position, rotation, and scale
-			DirectX::XMMATRIX worldMatrix = DirectX::XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z)
-				* DirectX::XMMatrixRotationRollPitchYaw(transform.rotation.x, transform.rotation.y, transform.rotation.z)
-				* DirectX::XMMatrixTranslation(transform.position.x, transform.position.y, transform.position.z);
-			
-			// Store the world matrix in the transform component
-			XMStoreFloat4x4(&transform.worldMatrix, worldMatrix);
+	std::vector<BlackJawz::Component::Transform> transforms(transformSources.size());
+	std::vector<BlackJawz::Component::Appearance> appearances(appearanceSources.size());
+	std::vector<BlackJawz::Component::Light> lights(lightSources.size());
 
-			transform.UpdateWorldMatrix();
+	constexpr uint32_t componentsPerJob = 256;
+	Jobs::JobCounter componentCounter;
 
-			transformArray.InsertData(newEntity, transform);
-			signature.set(0); // Assume Transform is component 0
+	jobSystem->Dispatch(componentCounter, static_cast<uint32_t>(transforms.size()), componentsPerJob,
+		[&](uint32_t index)
+		{
+			transforms[index] = FromTransformData(*loadedScene.entities[transformSources[index]].transform);
+		});
 
-			transformSystem->AddEntity(newEntity);
-			systemManager.SetSignature<BlackJawz::System::TransformSystem>(signature);
-		}
+	jobSystem->Dispatch(componentCounter, static_cast<uint32_t>(appearances.size()), componentsPerJob,
+		[&](uint32_t index)
+		{
+			size_t source = appearanceSources[index];
+			appearances[index] = FromAppearanceData(*loadedScene.entities[source].appearance,
+				loadedScene.resourceSlots[source], *resourceBackend);
+		});
 
-		// Load appearance component
-		if (entityData->appearance() && entityData->appearance()->geometry())
+	jobSystem->Dispatch(componentCounter, static_cast<uint32_t>(lights.size()), componentsPerJob,
+		[&](uint32_t index)
 		{
-			auto geometryData = entityData->appearance()->geometry();
-
-			// Create vertex buffer from FlatBuffer data
-			auto vertexData = geometryData->vertex_buffer();
-			std::vector<uint8_t> vertexBufferData(vertexData->begin(), vertexData->end());
-			ComPtr<ID3D11Buffer> vertexBuffer = CreateBuffer(renderer.GetDevice(), vertexBufferData, geometryData->vertex_buffer_stride());
-
-			// Create index buffer from FlatBuffer data
-			auto indexData = geometryData->index_buffer();
-			std::vector<uint8_t> indexBufferData(indexData->begin(), indexData->end());
-			ComPtr<ID3D11Buffer> indexBuffer = CreateBuffer(renderer.GetDevice(), indexBufferData, sizeof(uint32_t)); // Assuming uint32_t indices
-
-			BlackJawz::Component::Geometry geometry;
-			geometry.IndicesCount = geometryData->indices_count();
-			geometry.vertexBufferStride = geometryData->vertex_buffer_stride();
-			geometry.vertexBufferOffset = geometryData->vertex_buffer_offset();
-			geometry.pVertexBuffer = vertexBuffer;
-			geometry.pIndexBuffer = indexBuffer;
-
-			// Loading the texture SRV from the DDS data in the Appearance
-			auto textureData = entityData->appearance()->texture();
-
-			// Convert FlatBuffer vector to a standard vector
-			ComPtr<ID3D11ShaderResourceView> textureSRVDiffuse = nullptr;
-			ComPtr<ID3D11ShaderResourceView> textureSRVNormal = nullptr;
-			ComPtr<ID3D11ShaderResourceView>textureSRVMetal = nullptr;
-			ComPtr<ID3D11ShaderResourceView> textureSRVRoughness = nullptr;
-			ComPtr<ID3D11ShaderResourceView> textureSRVAO = nullptr;
-			ComPtr<ID3D11ShaderResourceView> textureSRVDisplacement = nullptr;
-
-			if (textureData->dds_data_diffuse())
-			{
-				std::vector<uint8_t> textureBufferDataDiffuse(textureData->dds_data_diffuse()->begin(), textureData->dds_data_diffuse()->end());
-				textureSRVDiffuse = LoadTextureFromDDSData(renderer.GetDevice(), textureBufferDataDiffuse);
-			}
+			lights[index] = FromLightData(*loadedScene.entities[lightSources[index]].light);
+		});
+
+	jobSystem->Wait(componentCounter);
+
+	// One bulk insert per component array and system
+	transformArray.InsertBulk(transformEntities, std::move(transforms));
+	appearanceArray.InsertBulk(appearanceEntities, std::move(appearances));
+	lightArray.InsertBulk(lightEntities, std::move(lights));
+
+	transformSystem->AddEntities(transformEntities);
+	appearanceSystem->AddEntities(appearanceEntities);
+	lightSystem->AddEntities(lightEntities);
+
+	if (!transformEntities.empty())
+		systemManager.SetSignature<BlackJawz::System::TransformSystem>(std::bitset<32>().set(0));
+	if (!appearanceEntities.empty())
+		systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(std::bitset<32>().set(1));
+	if (!lightEntities.empty())
+		systemManager.SetSignature<BlackJawz::System::LightSystem>(std::bitset<32>().set(2));
+}
 
-			if (textureData->dds_data_normal())
-			{
-				std::vector<uint8_t> textureBufferDataNormal(textureData->dds_data_normal()->begin(), textureData->dds_data_normal()->end());
-				textureSRVNormal = LoadTextureFromDDSData(renderer.GetDevice(), textureBufferDataNormal);
-			}
+void BlackJawz::Editor::Editor::InsertLoadedEntity(size_t index, Scene::EntityData& data, const Scene::ResourceSlots& slots)
+{
+	BlackJawz::Entity::Entity newEntity = entityManager.CreateEntity();
+	entities.push_back(newEntity);
 
-			if (textureData->dds_data_metal())
-			{
-				std::vector<uint8_t> textureBufferDataMetal(textureData->dds_data_metal()->begin(), textureData->dds_data_metal()->end());
-				textureSRVMetal = LoadTextureFromDDSData(renderer.GetDevice(), textureBufferDataMetal);
-			}
-			
-			if (textureData->dds_data_roughness())
-			{
-				std::vector<uint8_t> textureBufferDataRoughness(textureData->dds_data_roughness()->begin(), textureData->dds_data_roughness()->end());
-				textureSRVRoughness = LoadTextureFromDDSData(renderer.GetDevice(), textureBufferDataRoughness);
-			}
+	if (index >= loadingEntities.size())
+		loadingEntities.resize(index + 1, BlackJawz::Entity::MAX_ENTITIES);
+	loadingEntities[index] = newEntity;
 
-			if (textureData->dds_data_ao())
-			{
-				std::vector<uint8_t> textureBufferDataAO(textureData->dds_data_ao()->begin(), textureData->dds_data_ao()->end());
-				textureSRVAO = LoadTextureFromDDSData(renderer.GetDevice(), textureBufferDataAO);
-			}
+	savedIds[newEntity] = data.id;
+	nextSavedId = std::max(nextSavedId, data.id + 1);
 
-			if (textureData->dds_data_displacement())
-			{
-				std::vector<uint8_t> textureBufferDataDisplacement(textureData->dds_data_displacement()->begin(), textureData->dds_data_displacement()->end());
-				textureSRVDisplacement = LoadTextureFromDDSData(renderer.GetDevice(), textureBufferDataDisplacement);
-			}
-			
-			// Save geometry data and buffers in appearance
-			BlackJawz::Component::Appearance appearance(geometry, textureSRVDiffuse.Get(), textureSRVNormal.Get(),
-				textureSRVMetal.Get(), textureSRVRoughness.Get(), textureSRVAO.Get(), textureSRVDisplacement.Get());
+	if (!data.name.empty())
+	{
+		entityNames[newEntity] = std::move(data.name);
+	}
 
-			appearanceArray.InsertData(newEntity, appearance);
+	std::bitset<32> signature;
 
-			signature.set(1); // Assume Appearance is component 1
-			appearanceSystem->AddEntity(newEntity);
-			systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
-		}
+	if (data.transform)
+	{
+		transformArray.InsertData(newEntity, FromTransformData(*data.transform));
+		signature.set(0); // Assume Transform is component 0
 
-		if (entityData->light())
-		{
-			auto lightData = entityData->light();
+		transformSystem->AddEntity(newEntity);
+		systemManager.SetSignature<BlackJawz::System::TransformSystem>(signature);
+	}
 
-			BlackJawz::Component::Light light;
+	if (data.appearance)
+	{
+		appearanceArray.InsertData(newEntity, FromAppearanceData(*data.appearance, slots, *resourceBackend));
+		signature.set(1); // Assume Appearance is component 1
 
-			if (lightData->type())
-			{
-				auto type = lightData->type();
-				light.Type = static_cast<BlackJawz::Component::LightType>(type);
-			}
-			if (lightData->diffuse_light())
-			{
-				auto diff = lightData->diffuse_light();
-				light.DiffuseLight = { diff->Get(0),diff->Get(1), diff->Get(2), diff->Get(3) };
-			}
-			if (lightData->ambient_light()) 
-			{
-				auto ambient = lightData->ambient_light();
-				light.AmbientLight = { ambient->Get(0), ambient->Get(1), ambient->Get(2), ambient->Get(3) };
-			}
-			if (lightData->specular_light()) 
-			{
-				auto spec = lightData->specular_light();
-				light.SpecularLight = { spec->Get(0), spec->Get(1), spec->Get(2), spec->Get(3) };
-			}
-			if (lightData->specular_power())
-			{
-				auto specPow = lightData->specular_power();
-				light.SpecularPower = specPow;
-			}
+		appearanceSystem->AddEntity(newEntity);
+		systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
+	}
 
-			if (lightData->intensity())
-			{
-				auto intens = lightData->intensity();
-				light.Intensity = intens;
-			}
+	if (data.light)
+	{
+		lightArray.InsertData(newEntity, FromLightData(*data.light));
+		signature.set(2); // Assume Light is component 2
 
-			if (light.Type == BlackJawz::Component::LightType::Point || light.Type == BlackJawz::Component::LightType::Spot) 
-			{
-				if (lightData->range()) 
-				{
-					light.Range = lightData->range();  
-				}
-				if (lightData->attenuation())
-				{
-					auto atten = lightData->attenuation();
-					light.Attenuation = { atten->Get(0), atten->Get(1), atten->Get(2) };
-				}
-			}
+		lightSystem->AddEntity(newEntity);
+		systemManager.SetSignature<BlackJawz::System::LightSystem>(signature);
+	}
 
-			if (light.Type == BlackJawz::Component::LightType::Directional || light.Type == BlackJawz::Component::LightType::Spot) 
-			{
-				if (lightData->direction()) 
-				{
-					auto dir = lightData->direction();
-					light.Direction = { dir->Get(0), dir->Get(1), dir->Get(2) };  
-				}
-			}
+	entityManager.SetSignature(newEntity, signature);
+}
+
+void BlackJawz::Editor::Editor::AdoptSpatialIndex(Scene::SpatialIndex index, std::vector<BlackJawz::Entity::Entity> slotEntities)
+{
+	spatialIndex = std::move(index);
+	spatialEntities = std::move(slotEntities);
+	spatialSlots.clear();
+
+	// Scenes saved without an index, or entities that never made it into the ECS
+	spatialIndexStale = spatialIndex.Empty() || spatialIndex.GetEntityCount() != spatialEntities.size();
+	if (spatialIndexStale)
+		return;
+
+	// A few bytes per entity, the file data it points into would otherwise stay alive with it
+	spatialIndex.MakeOwned();
+
+	spatialSlots.reserve(spatialEntities.size());
+	for (uint32_t slot = 0; slot < spatialEntities.size(); ++slot)
+	{
+		if (spatialEntities[slot] != BlackJawz::Entity::MAX_ENTITIES)
+			spatialSlots.emplace(spatialEntities[slot], slot);
+	}
+}
+
+void BlackJawz::Editor::Editor::RebuildSpatialIndex()
+{
+	spatialEntities.clear();
+	spatialSlots.clear();
+
+	std::vector<Scene::BoundsData> bounds;
+	for (auto entity : appearanceSystem->GetEntities())
+	{
+		if (!transformArray.HasData(entity))
+			continue;
+
+		std::optional<Scene::BoundsData> entityBounds = ToWorldBounds(transformArray.GetData(entity), appearanceArray.GetData(entity));
+		if (!entityBounds)
+			continue;
+
+		spatialSlots.emplace(entity, static_cast<uint32_t>(spatialEntities.size()));
+		spatialEntities.push_back(entity);
+		bounds.push_back(*entityBounds);
+	}
+
+	spatialIndex.Build(std::move(bounds));
+	spatialIndexStale = false;
+}
+
+void BlackJawz::Editor::Editor::UpdateSpatialEntity(BlackJawz::Entity::Entity entity)
+{
+	if (spatialIndexStale)
+		return;
+
+	std::optional<Scene::BoundsData> bounds;
+	if (transformArray.HasData(entity) && appearanceArray.HasData(entity))
+		bounds = ToWorldBounds(transformArray.GetData(entity), appearanceArray.GetData(entity));
+
+	// Moved entities are refit in place, anything the tree cannot take is left to a rebuild
+	auto it = spatialSlots.find(entity);
+	if (!bounds || it == spatialSlots.end() || !spatialIndex.UpdateEntity(it->second, *bounds))
+		spatialIndexStale = true;
+}
+
+void BlackJawz::Editor::Editor::CullEntities(Rendering::Render& renderer)
+{
+	// Entities are still arriving during an incremental load, the file's index is taken once it finishes
+	if (!cullEntities || sceneLoadTask->IsBusy())
+	{
+		visibleEntities.clear();
+		renderer.SetVisibleEntities(nullptr);
+		return;
+	}
+
+	if (spatialIndexStale)
+	{
+		RebuildSpatialIndex();
+	}
+	else
+	{
+		spatialIndex.Refit();
+	}
+
+	// Entities outside the tree have no bounds and are always drawn
+	visibleEntities.assign(BlackJawz::Entity::MAX_ENTITIES, 1);
+	for (uint32_t slot = 0; slot < spatialEntities.size(); ++slot)
+	{
+		if (spatialEntities[slot] < visibleEntities.size() && !Scene::IsEmpty(spatialIndex.GetEntityBounds(slot)))
+			visibleEntities[spatialEntities[slot]] = 0;
+	}
+
+	XMFLOAT4X4 view = editorCamera->GetViewMatrix();
+	XMFLOAT4X4 projection = editorCamera->GetProjectionMatrix();
+	XMFLOAT4X4 viewProjection;
+	XMStoreFloat4x4(&viewProjection, XMMatrixMultiply(XMLoadFloat4x4(&view), XMLoadFloat4x4(&projection)));
+
+	float planes[6][4];
+	Scene::SpatialIndex::GetFrustumPlanes(&viewProjection._11, planes);
+
+	visibleSlots.clear();
+	spatialIndex.QueryFrustum(planes, visibleSlots);
+	for (uint32_t slot : visibleSlots)
+	{
+		visibleEntities[spatialEntities[slot]] = 1;
+	}
+
+	renderer.SetVisibleEntities(&visibleEntities);
+}
 
-			// For spotlights, set the cone angles
-			if (light.Type == BlackJawz::Component::LightType::Spot) 
+void BlackJawz::Editor::Editor::RequestTextureMips(float viewportHeight)
+{
+	// Pixels a unit long object covers at a distance of one
+	XMFLOAT4X4 projection = editorCamera->GetProjectionMatrix();
+	float pixelsPerUnit = projection._22 * viewportHeight * 0.5f;
+	XMVECTOR eye = XMLoadFloat3(&cameraPosition);
+
+	for (auto entity : appearanceSystem->GetEntities())
+	{
+		if (!visibleEntities.empty() && !visibleEntities[entity])
+			continue;
+
+		BlackJawz::Component::Appearance& appearance = appearanceArray.GetData(entity);
+		const BlackJawz::Component::Geometry& geometry = appearance.objectGeometry;
+
+		// Instances are spread over the scene, the closest ones set the size
+		float screenPixels = viewportHeight;
+		if (!appearance.HasInstances() && transformArray.HasData(entity))
+		{
+			const BlackJawz::Component::Transform& transform = transformArray.GetData(entity);
+			XMVECTOR boundsMin = XMLoadFloat3(&geometry.boundsMin);
+			XMVECTOR boundsMax = XMLoadFloat3(&geometry.boundsMax);
+			float radius = geometry.hasBounds ? 0.5f * XMVectorGetX(XMVector3Length(boundsMax - boundsMin)) : 1.0f;
+			radius *= std::max({ std::fabs(transform.scale.x), std::fabs(transform.scale.y), std::fabs(transform.scale.z) });
+
+			XMVECTOR center = XMVector3TransformCoord(geometry.hasBounds ? 0.5f * (boundsMin + boundsMax) : XMVectorZero(),
+				XMLoadFloat4x4(&transform.worldMatrix));
+			float distance = std::max(XMVectorGetX(XMVector3Length(center - eye)) - radius, 0.1f);
+			screenPixels = 2.0f * radius / distance * pixelsPerUnit;
+		}
+
+		ID3D11ShaderResourceView* views[] = { appearance.textureDataDiffuse.Get(), appearance.textureDataNormal.Get(),
+			appearance.textureDataMetal.Get(), appearance.textureDataRoughness.Get(), appearance.textureDataAO.Get(),
+			appearance.textureDataDisplacement.Get(), appearance.textureDataPacked.Get(), appearance.textureDataConeStep.Get() };
+		for (ID3D11ShaderResourceView* view : views)
+		{
+			if (view)
 			{
-				if (lightData->spot_inner_cone()) {
-					light.SpotInnerCone = lightData->spot_inner_cone();
-				}
-				if (lightData->spot_outer_cone()) {
-					light.SpotOuterCone = lightData->spot_outer_cone();
-				}
+				assetCache->RequestTexture(view, screenPixels);
 			}
+		}
+	}
+}
 
-			lightArray.InsertData(newEntity, light);
+void BlackJawz::Editor::Editor::PickEntity(float x, float y)
+{
+	if (sceneLoadTask->IsBusy())
+		return;
 
-			signature.set(2); // Assume Light is component 2
-			lightSystem->AddEntity(newEntity);
-			systemManager.SetSignature<BlackJawz::System::LightSystem>(signature);
-		}
+	if (spatialIndexStale)
+		RebuildSpatialIndex();
 
-		entityManager.SetSignature(newEntity, signature);
+	// The ray from the near plane to the far plane under the cursor
+	XMFLOAT4X4 view = editorCamera->GetViewMatrix();
+	XMFLOAT4X4 projection = editorCamera->GetProjectionMatrix();
+	XMMATRIX inverseViewProjection = XMMatrixInverse(nullptr, XMMatrixMultiply(XMLoadFloat4x4(&view), XMLoadFloat4x4(&projection)));
+
+	XMFLOAT3 nearPoint, farPoint;
+	XMStoreFloat3(&nearPoint, XMVector3TransformCoord(XMVectorSet(x, y, 0.0f, 1.0f), inverseViewProjection));
+	XMStoreFloat3(&farPoint, XMVector3TransformCoord(XMVectorSet(x, y, 1.0f, 1.0f), inverseViewProjection));
+
+	float origin[3] = { nearPoint.x, nearPoint.y, nearPoint.z };
+	float direction[3] = { farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z };
+
+	// Boxes only, the nearest box under the cursor wins. A distance of 1 reaches the far plane.
+	std::optional<Scene::RayHit> hit = spatialIndex.Raycast(origin, direction, 1.0f);
+	if (!hit)
+	{
+		selectedObject = -1;
+		return;
 	}
+
+	auto it = std::find(entities.begin(), entities.end(), spatialEntities[hit->entity]);
+	selectedObject = it != entities.end() ? static_cast<int>(it - entities.begin()) : -1;
 }
 
 void BlackJawz::Editor::Editor::MenuBar(Rendering::Render& renderer)
@@ -715,14 +999,15 @@ void BlackJawz::Editor::Editor::MenuBar(Rendering::Render& renderer)
 
 			}
 
-			if (ImGui::MenuItem("Save Scene.."))
+			// Only one save at a time, the snapshot is still being written out
+			if (ImGui::MenuItem("Save Scene..", nullptr, false, !sceneSaveTask->IsBusy() && !sceneLoadTask->IsBusy()))
 			{
 				openSavePopup = true;
 				strcpy_s(sceneNameBuffer, "ecs"); // Reset to default.
 			}
 
 			// Load Scene submenu
-			if (ImGui::BeginMenu("Load Scene"))
+			if (ImGui::BeginMenu("Load Scene", !sceneLoadTask->IsBusy() && !cellStreamer->IsLoading()))
 			{
 				// Submenu: Load From List
 				if (ImGui::BeginMenu("Load From Files"))
@@ -773,9 +1058,65 @@ void BlackJawz::Editor::Editor::MenuBar(Rendering::Render& renderer)
 		if (ImGui::BeginMenu("Debug"))
 		{
 			ImGui::MenuItem("Demo Window", "", &showImGuiDemo);
+			ImGui::MenuItem("Incremental Scene Loading", "", &incrementalLoading);
+			ImGui::MenuItem("Journaled Scene Saves", "", &journaledSaves);
+			ImGui::MenuItem("Compress Scene Assets", "", &compressSceneAssets);
+			ImGui::MenuItem("Pack Vertices On Save", "", &packVerticesOnSave);
+			ImGui::MenuItem("World Partition Saves", "", &worldPartitionSaves);
+			ImGui::MenuItem("Stream World Partition", "", &streamWorldPartition);
+			ImGui::MenuItem("Frustum Culling", "", &cullEntities);
+
+			ImGui::Separator();
+			const Rendering::AssetCache::Stats& cacheStats = assetCache->GetStats();
+			ImGui::Text("Asset cache: %zu textures (%.1f MB), %zu meshes", cacheStats.textureCount,
+				cacheStats.textureBytes / (1024.0 * 1024.0), cacheStats.meshCount);
+			ImGui::Text("%llu hits, %llu misses, %llu evicted", static_cast<unsigned long long>(cacheStats.hits),
+				static_cast<unsigned long long>(cacheStats.misses), static_cast<unsigned long long>(cacheStats.evictions));
+			ImGui::Text("%zu textures loading, last batch created in %.2f ms", cacheStats.pendingTextures, cacheStats.lastUpdateMs);
+			ImGui::Text("%zu mip streamed, %.1f MB resident of %.1f MB, %llu mip loads", cacheStats.streamedTextures,
+				cacheStats.textureBytes / (1024.0 * 1024.0), cacheStats.fullTextureBytes / (1024.0 * 1024.0),
+				static_cast<unsigned long long>(cacheStats.mipLoads));
+			if (ImGui::SliderInt("Texture budget (MB)", &textureBudgetMb, 16, 2048))
+			{
+				assetCache->SetMemoryBudget(static_cast<uint64_t>(textureBudgetMb) * 1024 * 1024);
+			}
+			ImGui::Text("Last object added in %.2f ms", lastAddObjectMs);
+
+			float worstFrameMs = *std::max_element(frameTimes.begin(), frameTimes.end());
+			char frameOverlay[64];
+			snprintf(frameOverlay, sizeof(frameOverlay), "worst %.1f ms", worstFrameMs);
+			ImGui::PlotLines("Frame time", frameTimes.data(), static_cast<int>(frameTimes.size()),
+				static_cast<int>(frameTimeIndex), frameOverlay, 0.0f, std::max(worstFrameMs, 33.3f), ImVec2(240.0f, 60.0f));
 			ImGui::EndMenu();
 		}
 
+		// Save progress
+		if (sceneSaveTask->GetStage() != SceneSaveTask::Stage::Idle)
+		{
+			ImGui::Separator();
+			ImGui::Text("%s %s", sceneSaveTask->GetStageName(), sceneSaveTask->GetFilename().c_str());
+
+			if (sceneSaveTask->IsBusy())
+			{
+				ImGui::ProgressBar(sceneSaveTask->GetProgress(), ImVec2(150.0f, 0.0f));
+			}
+		}
+
+		// Load progress
+		if (sceneLoadTask->IsBusy())
+		{
+			ImGui::Separator();
+			ImGui::Text("%s %s", sceneLoadTask->GetStageName(), sceneLoadTask->GetFilename().c_str());
+			ImGui::ProgressBar(sceneLoadTask->GetProgress(), ImVec2(150.0f, 0.0f));
+		}
+
+		// Streaming status
+		if (cellStreamer->IsOpen())
+		{
+			ImGui::Separator();
+			ImGui::Text("%zu cells resident%s", cellStreamer->GetResidentCount(), cellStreamer->IsLoading() ? ", streaming" : "");
+		}
+
 		ImGui::EndMainMenuBar();
 	}
 
@@ -797,7 +1138,7 @@ void BlackJawz::Editor::Editor::MenuBar(Rendering::Render& renderer)
 		{
 			// Prepend "Scenes/" to the file name before saving.
 			std::string fullPath = "Scenes/" + std::string(sceneNameBuffer) + ".bin";
-			SaveScene(fullPath, renderer);
+			SaveScene(fullPath);
 			ImGui::CloseCurrentPopup();
 		}
 		ImGui::SameLine();
@@ -937,6 +1278,7 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 			{
 				// When Enter is pressed, update the name and exit renaming mode
 				entityNames[entities[i]] = renameBuffer;
+				sceneChanges.MarkChanged(entities[i], Scene::ChangeTracker::NameChanged);
 				isRenaming = false; // Exit renaming mode
 			}
 
@@ -977,12 +1319,27 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 					// Remove from the entities list first
 					entities.erase(entities.begin() + selectedObject);
 
-					// Destroy the entity in ECS (after removing it from the list)
-					entityManager.DestroyEntity(entity);
+					// Its cell stays resident until the next save, or the deleted entity would stream back in
+					for (auto& [cell, cellList] : cellEntities)
+					{
+						auto cellIt = std::find(cellList.begin(), cellList.end(), entity);
+						if (cellIt != cellList.end())
+						{
+							cellList.erase(cellIt);
+							pinnedCells.insert(cell);
+							break;
+						}
+					}
+
+					// The next save drops it from the scene file
+					auto savedIt = savedIds.find(entity);
+					sceneChanges.MarkRemoved(entity, savedIt != savedIds.end() ? std::optional<uint32_t>(savedIt->second) : std::nullopt);
+					if (savedIt != savedIds.end())
+						savedIds.erase(savedIt);
 
-					transformSystem->RemoveEntity(entity);
-					appearanceSystem->RemoveEntity(entity);
-					lightSystem->RemoveEntity(entity);
+					// Destroy the entity in ECS (after removing it from the list), along with its components
+					DestroyEntity(entity);
+					assetCache->Trim();
 
 					// Reset the selected object index
 					selectedObject = -1;
@@ -1014,6 +1371,10 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 	// Add a right-click context menu for adding new objects
 	if (ImGui::BeginPopup("HierarchyContextMenu"))
 	{
+		// Timed so the cost of adding an object shows in the Debug menu, with and without cached assets
+		auto addStart = std::chrono::steady_clock::now();
+		size_t entityCountBefore = entities.size();
+
 		if (ImGui::MenuItem("Add Cube"))
 		{
 			BlackJawz::Entity::Entity newEntity = entityManager.CreateEntity();
@@ -1024,20 +1385,19 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 			BlackJawz::Component::Transform transform;
 			transformArray.InsertData(newEntity, transform);
 
-			BlackJawz::Component::Geometry cubeGeo = renderer.CreateCubeGeometry();
+			BlackJawz::Component::Geometry cubeGeo;
+			assetCache->GetMesh(L"Primitives\\Cube", [&renderer](BlackJawz::Component::Geometry& geometry)
+				{
+					geometry = renderer.CreateCubeGeometry();
+					return true;
+				}, cubeGeo);
 
-			ComPtr<ID3D11ShaderResourceView> texDiffuse = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texNormal = nullptr;
+			ComPtr<ID3D11ShaderResourceView> texDiffuse = assetCache->GetTexture(L"Textures\\bricks_diffuse.dds");
+			ComPtr<ID3D11ShaderResourceView> texNormal = assetCache->GetTexture(L"Textures\\bricks_normals.dds", Rendering::AssetCache::PlaceholderFlatNormal);
 			ComPtr<ID3D11ShaderResourceView> texMetal = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texRough = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texAO = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texDisplacement = nullptr;
-
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\bricks_diffuse.dds", nullptr, texDiffuse.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\bricks_normals.dds", nullptr, texNormal.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\bricks_roughness.dds", nullptr, texRough.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\bricks_AO.dds", nullptr, texAO.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\bricks_displacement.dds", nullptr, texDisplacement.GetAddressOf());
+			ComPtr<ID3D11ShaderResourceView> texRough = assetCache->GetTexture(L"Textures\\bricks_roughness.dds");
+			ComPtr<ID3D11ShaderResourceView> texAO = assetCache->GetTexture(L"Textures\\bricks_AO.dds", Rendering::AssetCache::PlaceholderWhite);
+			ComPtr<ID3D11ShaderResourceView> texDisplacement = assetCache->GetTexture(L"Textures\\bricks_displacement.dds", Rendering::AssetCache::PlaceholderBlack);
 
 			BlackJawz::Component::Appearance appearance(cubeGeo, texDiffuse.Get(), texNormal.Get(), texMetal.Get(), 
 				texRough.Get(), texAO.Get(), texDisplacement.Get());
@@ -1054,6 +1414,71 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 
 			appearanceSystem->AddEntity(newEntity);
 			systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
+
+			sceneChanges.MarkChanged(newEntity, Scene::ChangeTracker::AllChanged);
+			spatialIndexStale = true;
+		}
+		if (ImGui::MenuItem("Add Instanced Cubes"))
+		{
+			BlackJawz::Entity::Entity newEntity = entityManager.CreateEntity();
+			entities.push_back(newEntity);
+
+			entityNames[newEntity] = "Cube Instances " + std::to_string(entities.size());
+
+			BlackJawz::Component::Transform transform;
+			transformArray.InsertData(newEntity, transform);
+
+			BlackJawz::Component::Geometry cubeGeo;
+			assetCache->GetMesh(L"Primitives\\Cube", [&renderer](BlackJawz::Component::Geometry& geometry)
+				{
+					geometry = renderer.CreateCubeGeometry();
+					return true;
+				}, cubeGeo);
+
+			ComPtr<ID3D11ShaderResourceView> texDiffuse = assetCache->GetTexture(L"Textures\\bricks_diffuse.dds");
+			ComPtr<ID3D11ShaderResourceView> texNormal = assetCache->GetTexture(L"Textures\\bricks_normals.dds", Rendering::AssetCache::PlaceholderFlatNormal);
+			ComPtr<ID3D11ShaderResourceView> texRough = assetCache->GetTexture(L"Textures\\bricks_roughness.dds");
+			ComPtr<ID3D11ShaderResourceView> texAO = assetCache->GetTexture(L"Textures\\bricks_AO.dds", Rendering::AssetCache::PlaceholderWhite);
+
+			BlackJawz::Component::Appearance appearance(cubeGeo, texDiffuse.Get(), texNormal.Get(), nullptr,
+				texRough.Get(), texAO.Get());
+
+			// A grid of cubes with some jitter, all drawn with one call
+			constexpr int GridSize = 32;
+			constexpr float Spacing = 3.0f;
+			std::mt19937 random(static_cast<uint32_t>(newEntity));
+			std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+			std::uniform_real_distribution<float> angle(0.0f, XM_2PI);
+			std::uniform_real_distribution<float> size(0.5f, 1.0f);
+
+			appearance.instances = std::make_shared<BlackJawz::Component::Instances>();
+			appearance.instances->transforms.resize(GridSize * GridSize);
+			for (int z = 0; z < GridSize; ++z)
+			{
+				for (int x = 0; x < GridSize; ++x)
+				{
+					BlackJawz::Component::InstanceTransform& instance = appearance.instances->transforms[z * GridSize + x];
+					float scale = size(random);
+					instance.position = XMFLOAT3((x - GridSize / 2 + jitter(random)) * Spacing, 0.0f, (z - GridSize / 2 + jitter(random)) * Spacing);
+					instance.rotation = XMFLOAT3(0.0f, angle(random), 0.0f);
+					instance.scale = XMFLOAT3(scale, scale, scale);
+				}
+			}
+			appearanceArray.InsertData(newEntity, appearance);
+
+			std::bitset<32> signature;
+			signature.set(0);  // Assume component 0 is Transform
+			signature.set(1);  // Assume component 1 is Appearance
+			entityManager.SetSignature(newEntity, signature);
+
+			transformSystem->AddEntity(newEntity);
+			systemManager.SetSignature<BlackJawz::System::TransformSystem>(signature);
+
+			appearanceSystem->AddEntity(newEntity);
+			systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
+
+			sceneChanges.MarkChanged(newEntity, Scene::ChangeTracker::AllChanged);
+			spatialIndexStale = true;
 		}
 		if (ImGui::MenuItem("Add Sphere"))
 		{
@@ -1065,20 +1490,20 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 			BlackJawz::Component::Transform transform;
 			transformArray.InsertData(newEntity, transform);
 
-			BlackJawz::Component::Geometry sphereGeo = renderer.CreateSphereGeometry();
-
-			ComPtr<ID3D11ShaderResourceView> texDiffuse = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texNormal = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texMetal = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texRough = nullptr;
+			BlackJawz::Component::Geometry sphereGeo;
+			assetCache->GetMesh(L"Primitives\\Sphere", [&renderer](BlackJawz::Component::Geometry& geometry)
+				{
+					geometry = renderer.CreateSphereGeometry();
+					return true;
+				}, sphereGeo);
+
+			ComPtr<ID3D11ShaderResourceView> texDiffuse = assetCache->GetTexture(L"Textures\\metal_diffuse.dds");
+			ComPtr<ID3D11ShaderResourceView> texNormal = assetCache->GetTexture(L"Textures\\metal_normals.dds", Rendering::AssetCache::PlaceholderFlatNormal);
+			ComPtr<ID3D11ShaderResourceView> texMetal = assetCache->GetTexture(L"Textures\\metal_metalness.dds", Rendering::AssetCache::PlaceholderBlack);
+			ComPtr<ID3D11ShaderResourceView> texRough = assetCache->GetTexture(L"Textures\\metal_roughness.dds");
 			ComPtr<ID3D11ShaderResourceView> texAO = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texDisplacement = nullptr;
+			ComPtr<ID3D11ShaderResourceView> texDisplacement = assetCache->GetTexture(L"Textures\\metal_displacement.dds", Rendering::AssetCache::PlaceholderBlack);
 
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\metal_diffuse.dds", nullptr, texDiffuse.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\metal_normals.dds", nullptr, texNormal.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\metal_metalness.dds", nullptr, texMetal.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\metal_roughness.dds", nullptr, texRough.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\metal_displacement.dds", nullptr, texDisplacement.GetAddressOf());
 			
 			BlackJawz::Component::Appearance appearance(sphereGeo, texDiffuse.Get(), texNormal.Get(), texMetal.Get(), 
 				texRough.Get(), texAO.Get(), texDisplacement.Get());
@@ -1095,6 +1520,9 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 			appearanceSystem->AddEntity(newEntity);
 			systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
 
+			sceneChanges.MarkChanged(newEntity, Scene::ChangeTracker::AllChanged);
+			spatialIndexStale = true;
+
 		}
 		if (ImGui::MenuItem("Add Plane"))
 		{
@@ -1106,20 +1534,19 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 			BlackJawz::Component::Transform transform;
 			transformArray.InsertData(newEntity, transform);
 
-			BlackJawz::Component::Geometry planeGeo = renderer.CreatePlaneGeometry();
+			BlackJawz::Component::Geometry planeGeo;
+			assetCache->GetMesh(L"Primitives\\Plane", [&renderer](BlackJawz::Component::Geometry& geometry)
+				{
+					geometry = renderer.CreatePlaneGeometry();
+					return true;
+				}, planeGeo);
 
-			ComPtr<ID3D11ShaderResourceView> texDiffuse = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texNormal = nullptr;
+			ComPtr<ID3D11ShaderResourceView> texDiffuse = assetCache->GetTexture(L"Textures\\pavement_diffuse.dds");
+			ComPtr<ID3D11ShaderResourceView> texNormal = assetCache->GetTexture(L"Textures\\pavement_normals.dds", Rendering::AssetCache::PlaceholderFlatNormal);
 			ComPtr<ID3D11ShaderResourceView> texMetal = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texRough = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texAO = nullptr;
-			ComPtr<ID3D11ShaderResourceView> texDisplacement = nullptr;
-
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\pavement_diffuse.dds", nullptr, texDiffuse.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\pavement_normals.dds", nullptr, texNormal.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\pavement_roughness.dds", nullptr, texRough.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\pavement_AO.dds", nullptr, texAO.GetAddressOf());
-			CreateDDSTextureFromFile(renderer.GetDevice(), L"Textures\\pavement_displacement.dds", nullptr, texDisplacement.GetAddressOf());
+			ComPtr<ID3D11ShaderResourceView> texRough = assetCache->GetTexture(L"Textures\\pavement_roughness.dds");
+			ComPtr<ID3D11ShaderResourceView> texAO = assetCache->GetTexture(L"Textures\\pavement_AO.dds", Rendering::AssetCache::PlaceholderWhite);
+			ComPtr<ID3D11ShaderResourceView> texDisplacement = assetCache->GetTexture(L"Textures\\pavement_displacement.dds", Rendering::AssetCache::PlaceholderBlack);
 
 			BlackJawz::Component::Appearance appearance(planeGeo, texDiffuse.Get(), texNormal.Get(), texMetal.Get(), 
 				texRough.Get(), texAO.Get(), texDisplacement.Get());
@@ -1136,6 +1563,9 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 
 			appearanceSystem->AddEntity(newEntity);
 			systemManager.SetSignature<BlackJawz::System::AppearanceSystem>(signature);
+
+			sceneChanges.MarkChanged(newEntity, Scene::ChangeTracker::AllChanged);
+			spatialIndexStale = true;
 		}
 		if (ImGui::MenuItem("Add Light"))
 		{
@@ -1163,6 +1593,36 @@ void BlackJawz::Editor::Editor::Hierarchy(Rendering::Render& renderer)
 				lightSystem->AddEntity(newEntity);
 			    systemManager.SetSignature<BlackJawz::System::LightSystem>(signature);
 			}
+
+			sceneChanges.MarkChanged(newEntity, Scene::ChangeTracker::AllChanged);
+		}
+		if (ImGui::BeginMenu("Import Mesh"))
+		{
+			try
+			{
+				// OBJ and glTF files in the "Meshes" folder
+				for (const auto& entry : std::filesystem::directory_iterator("Meshes"))
+				{
+					std::string fileName = entry.path().filename().string();
+					if (!Scene::GetMeshFileType(fileName))
+						continue;
+
+					if (ImGui::MenuItem(fileName.c_str()))
+					{
+						ImportMesh("Meshes/" + fileName, renderer);
+					}
+				}
+			}
+			catch (const std::filesystem::filesystem_error& e)
+			{
+				ImGui::MenuItem("Error reading Meshes folder");
+			}
+			ImGui::EndMenu();
+		}
+
+		if (entities.size() != entityCountBefore)
+		{
+			lastAddObjectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - addStart).count();
 		}
 
 		ImGui::EndPopup();
@@ -1206,9 +1666,15 @@ void BlackJawz::Editor::Editor::ObjectProperties()
 		if (transform)
 		{
 			ImGui::SeparatorText("Transform");
-			ImGui::DragFloat3("Position", &transform->position.x, 0.1f);
-			ImGui::DragFloat3("Rotation", &transform->rotation.x, 0.1f);
-			ImGui::DragFloat3("Scale", &transform->scale.x, 0.1f, 0.0f, 100000.0f);
+			bool transformEdited = ImGui::DragFloat3("Position", &transform->position.x, 0.1f);
+			transformEdited |= ImGui::DragFloat3("Rotation", &transform->rotation.x, 0.1f);
+			transformEdited |= ImGui::DragFloat3("Scale", &transform->scale.x, 0.1f, 0.0f, 100000.0f);
+
+			if (transformEdited)
+			{
+				sceneChanges.MarkChanged(entity, Scene::ChangeTracker::TransformChanged);
+				UpdateSpatialEntity(entity);
+			}
 		}
 
 		if (appearance)
@@ -1220,6 +1686,8 @@ void BlackJawz::Editor::Editor::ObjectProperties()
 			ImGui::DragInt("Indices", &indicesCount, 0.1f);
 			ImGui::DragInt("Stride", &stride, 0.1f);
 			ImGui::DragInt("Offset", &offset, 0.1f);
+			if (appearance->HasInstances())
+				ImGui::Text("Instances: %zu", appearance->instances->transforms.size());
 
 			if (appearance->HasTextureDiffuse())
 			{		
@@ -1251,6 +1719,16 @@ void BlackJawz::Editor::Editor::ObjectProperties()
 				ImGui::Text("Displacement Map:");
 				ImGui::Image((ImTextureID)appearance->GetTextureDisplacement().Get(), ImVec2(100, 100));
 			}
+			if (appearance->HasTexturePacked())
+			{
+				ImGui::Text("Packed Map (metal, roughness, AO, displacement):");
+				ImGui::Image((ImTextureID)appearance->GetTexturePacked().Get(), ImVec2(100, 100));
+			}
+			if (appearance->HasTextureConeStep())
+			{
+				ImGui::Text("Cone Step Map (depth, cone ratio):");
+				ImGui::Image((ImTextureID)appearance->GetTextureConeStep().Get(), ImVec2(100, 100));
+			}
 		}
 
 		if (light)
@@ -1261,40 +1739,45 @@ void BlackJawz::Editor::Editor::ObjectProperties()
 			const char* lightTypes[] = { "Point", "Directional", "Spot" };
 			int currentType = static_cast<int>(light->Type);
 
+			bool lightEdited = false;
 			if (ImGui::Combo("Light Type", &currentType, lightTypes, IM_ARRAYSIZE(lightTypes)))
 			{
 				// If the light type changes, reset its properties
 				*light = BlackJawz::Component::Light(static_cast<BlackJawz::Component::LightType>(currentType));
+				lightEdited = true;
 			}
 
 			// Common Light Properties
-			ImGui::DragFloat4("Diffuse Light", &light->DiffuseLight.x, 0.1f);
-			ImGui::DragFloat4("Ambient Light", &light->AmbientLight.x, 0.1f);
-			ImGui::DragFloat4("Specular Light", &light->SpecularLight.x, 0.1f);
-			ImGui::DragFloat("Specular Power", &light->SpecularPower, 0.1f);
-			ImGui::DragFloat("Intensity", &light->Intensity, 0.1f);
+			lightEdited |= ImGui::DragFloat4("Diffuse Light", &light->DiffuseLight.x, 0.1f);
+			lightEdited |= ImGui::DragFloat4("Ambient Light", &light->AmbientLight.x, 0.1f);
+			lightEdited |= ImGui::DragFloat4("Specular Light", &light->SpecularLight.x, 0.1f);
+			lightEdited |= ImGui::DragFloat("Specular Power", &light->SpecularPower, 0.1f);
+			lightEdited |= ImGui::DragFloat("Intensity", &light->Intensity, 0.1f);
 
 			// Show properties only relevant to Point and Spot lights
 			if (light->Type == BlackJawz::Component::LightType::Point ||
 				light->Type == BlackJawz::Component::LightType::Spot)
 			{
-				ImGui::DragFloat("Range", &light->Range, 0.1f);
-				ImGui::DragFloat3("Attenuation", &light->Attenuation.x, 0.1f);
+				lightEdited |= ImGui::DragFloat("Range", &light->Range, 0.1f);
+				lightEdited |= ImGui::DragFloat3("Attenuation", &light->Attenuation.x, 0.1f);
 			}
 
 			// Show properties only relevant to Directional and Spot lights
 			if (light->Type == BlackJawz::Component::LightType::Directional ||
 				light->Type == BlackJawz::Component::LightType::Spot)
 			{
-				ImGui::DragFloat3("Direction", &light->Direction.x, 0.1f);
+				lightEdited |= ImGui::DragFloat3("Direction", &light->Direction.x, 0.1f);
 			}
 
 			// Show spotlight-specific properties
 			if (light->Type == BlackJawz::Component::LightType::Spot)
 			{
-				ImGui::DragFloat("Spotlight Inner Cone", &light->SpotInnerCone, 0.01f, 0.0f, 1.0f);
-				ImGui::DragFloat("Spotlight Outer Cone", &light->SpotOuterCone, 0.01f, 0.0f, 1.0f);
+				lightEdited |= ImGui::DragFloat("Spotlight Inner Cone", &light->SpotInnerCone, 0.01f, 0.0f, 1.0f);
+				lightEdited |= ImGui::DragFloat("Spotlight Outer Cone", &light->SpotOuterCone, 0.01f, 0.0f, 1.0f);
 			}
+
+			if (lightEdited)
+				sceneChanges.MarkChanged(entity, Scene::ChangeTracker::LightChanged);
 		}
 
 		// Add Component Menu
@@ -1309,6 +1792,9 @@ void BlackJawz::Editor::Editor::ObjectProperties()
 				signature.set(0);
 				entityManager.SetSignature(entity, signature);
 				transformSystem->AddEntity(entity);
+
+				sceneChanges.MarkChanged(entity, Scene::ChangeTracker::TransformChanged);
+				spatialIndexStale = true;
 			}
 
 			if (ImGui::MenuItem("Appearance (WIP)") && !appearance)
@@ -1327,6 +1813,8 @@ void BlackJawz::Editor::Editor::ObjectProperties()
 				signature.set(2);
 				entityManager.SetSignature(entity, signature);
 				lightSystem->AddEntity(entity);
+
+				sceneChanges.MarkChanged(entity, Scene::ChangeTracker::LightChanged);
 			}
 
 			ImGui::EndPopup();
@@ -1354,14 +1842,26 @@ void BlackJawz::Editor::Editor::ViewPort(Rendering::Render& renderer)
 		lastViewportSize = viewportSize;
 	}
 
-	// Update matrices
+	// Update matrices, the renderer draws with the ones the entities were culled against
 	editorCamera->UpdateViewMatrix();
 	editorCamera->UpdateProjectionMatrix();
+	renderer.SetViewMatrix(editorCamera->GetViewMatrix());
+	renderer.SetProjectionMatrix(editorCamera->GetProjectionMatrix());
 
+	CullEntities(renderer);
+	RequestTextureMips(viewportSize.y);
 	renderer.RenderToTexture(*transformSystem, *appearanceSystem, *lightSystem);
 
 	ImGui::Image((ImTextureID)renderer.GetShaderResourceView(), viewportSize);
 
+	// Select what is under the cursor
+	if (ImGui::IsItemClicked(ImGuiMouseButton_Left) && viewportSize.x > 0.0f && viewportSize.y > 0.0f)
+	{
+		ImVec2 imageMin = ImGui::GetItemRectMin();
+		ImVec2 mouse = ImGui::GetMousePos();
+		PickEntity(2.0f * (mouse.x - imageMin.x) / viewportSize.x - 1.0f, 1.0f - 2.0f * (mouse.y - imageMin.y) / viewportSize.y);
+	}
+
 	ImGui::End(); // End the ImGui viewport window
 	ImGui::PopStyleVar(); // Pop the style variable
 }
\ No newline at end of file
@@ -9,6 +9,16 @@
 #include "../ECS/ComponentArray.h"
 #include "../ECS/SystemManager.h"
 
+#include "../Util/JobSystem.h"
+#include "../Scene/SceneLoader.h"
+#include "../Scene/CellStreamer.h"
+#include "../Scene/ChangeTracker.h"
+#include "../Scene/MeshImport.h"
+#include "../Rendering/AssetCache.h"
+#include "../Rendering/D3D11ResourceBackend.h"
+#include "SceneSaveTask.h"
+#include "SceneLoadTask.h"
+
 namespace BlackJawz::Editor
 {
 	struct Object
@@ -32,13 +42,50 @@ namespace BlackJawz::Editor
 		void ObjectProperties();
 		void ViewPort(Rendering::Render& renderer);
 
-		void SaveScene(const std::string& filename, Rendering::Render& renderer);
+		void SaveScene(const std::string& filename);
+		void SaveSceneDelta(const std::string& filename);
+		void FinishSave();
+		uint32_t GetSavedId(BlackJawz::Entity::Entity entity);
 
-		ComPtr<ID3D11Buffer> CreateBuffer(ID3D11Device* device, const std::vector<uint8_t>& data, UINT stride);
 		void LoadScene(const std::string& filename, Rendering::Render& renderer);
-		ComPtr<ID3D11ShaderResourceView> LoadTextureFromDDSData(ID3D11Device* device, const std::vector<uint8_t>& textureData);
+		void ClearScene();
+
+		// Adds an entity per mesh in an OBJ or glTF file, material maps are looked for as DDS files
+		void ImportMesh(const std::string& filename, Rendering::Render& renderer);
+		void InsertLoadedScene(Scene::LoadedScene& loadedScene);
+		void InsertLoadedEntity(size_t index, Scene::EntityData& data, const Scene::ResourceSlots& slots);
+
+		// Culling and picking. Loaded scenes bring their index with them, anything that changes which
+		// entities exist rebuilds it from the components on the next frame.
+		void AdoptSpatialIndex(Scene::SpatialIndex index, std::vector<BlackJawz::Entity::Entity> slotEntities);
+		void RebuildSpatialIndex();
+		void UpdateSpatialEntity(BlackJawz::Entity::Entity entity);
+		void CullEntities(Rendering::Render& renderer);
+		void PickEntity(float x, float y); // Normalized device coordinates
+
+		// Asks the asset cache for mip levels by each visible entity's size on screen
+		void RequestTextureMips(float viewportHeight);
+
+		// World partition streaming, cells come and go with the camera
+		void InsertCell(const Scene::CellCoord& cell, Scene::LoadedScene& loadedScene);
+		bool RemoveCell(const Scene::CellCoord& cell);
+		void AssignCells();
+		Scene::CellCoord GetEntityCell(BlackJawz::Entity::Entity entity);
+
+		// Destroys the entities and their components, their ids go back to the entity manager
+		void RemoveEntities(const std::vector<BlackJawz::Entity::Entity>& removed);
+		void DestroyEntity(BlackJawz::Entity::Entity entity);
+
+		// Points the appearances still bound to a streamed texture's placeholder at the texture
+		void SwapTextures(const std::vector<Rendering::AssetCache::TextureSwap>& swaps);
 	private:
 		bool showImGuiDemo = false;
+		bool incrementalLoading = true; // Load scenes over several frames instead of blocking
+		bool journaledSaves = true; // Append changed entities to the scene's journal instead of rewriting it
+		bool compressSceneAssets = true;
+		bool packVerticesOnSave = false; // Quantize meshes to 20 byte vertices, see Scene/VertexPacking.h
+		bool worldPartitionSaves = false; // Bucket entities into grid cells that can be loaded on their own
+		bool streamWorldPartition = true; // Stream partitioned scenes around the camera instead of loading them whole
 		std::vector<Object> objects;
 		std::unique_ptr<BlackJawz::EditorCamera::EditorCamera> editorCamera;
 
@@ -64,5 +111,52 @@ namespace BlackJawz::Editor
 		UINT fileIcon = 0;
 
 		std::filesystem::path currentPath;
+
+		// Declared before the tasks that queue work on it, so it outlives them
+		std::unique_ptr<BlackJawz::Jobs::JobSystem> jobSystem;
+		std::unique_ptr<SceneSaveTask> sceneSaveTask;
+
+		// Textures and meshes of the objects added from the Hierarchy menu, shared between them
+		std::unique_ptr<BlackJawz::Rendering::AssetCache> assetCache;
+		double lastAddObjectMs = 0.0;
+		int textureBudgetMb = 256;
+
+		// Recent frame times for the Debug menu, loads should not show up as spikes
+		std::array<float, 240> frameTimes = {};
+		size_t frameTimeIndex = 0;
+
+		// The loader's upload thread uses the backend, so the backend is declared first
+		std::unique_ptr<BlackJawz::Rendering::D3D11ResourceBackend> resourceBackend;
+		std::unique_ptr<BlackJawz::Scene::SceneLoader> sceneLoader;
+		std::unique_ptr<SceneLoadTask> sceneLoadTask;
+		std::unique_ptr<BlackJawz::Scene::CellStreamer> cellStreamer;
+
+		// Live entities of each resident cell. Cells with deletions that are not saved yet stay resident,
+		// or the deleted entities would stream back in.
+		std::unordered_map<Scene::CellCoord, std::vector<BlackJawz::Entity::Entity>, Scene::CellCoordHash> cellEntities;
+		std::unordered_set<Scene::CellCoord, Scene::CellCoordHash> pinnedCells;
+
+		// Slot i of the spatial index is spatialEntities[i], slots of destroyed entities are never
+		// read because destroying one marks the index stale
+		Scene::SpatialIndex spatialIndex;
+		std::vector<BlackJawz::Entity::Entity> spatialEntities;
+		std::unordered_map<BlackJawz::Entity::Entity, uint32_t> spatialSlots;
+		bool spatialIndexStale = true;
+		bool cullEntities = true;
+		std::vector<uint8_t> visibleEntities; // One flag per entity id, read by the renderer
+		std::vector<uint32_t> visibleSlots;
+
+		// Entities of an incremental load by their position in the file
+		std::vector<BlackJawz::Entity::Entity> loadingEntities;
+
+		// Edits since the last save, and each entity's id in the scene file
+		Scene::ChangeTracker sceneChanges;
+		std::unordered_map<BlackJawz::Entity::Entity, uint32_t> savedIds;
+		uint32_t nextSavedId = 0;
+
+		// The file on disk the tracked changes apply to, empty when the next save has to be a full one
+		std::string baseScenePath;
+		uint64_t baseJournalId = 0;
+		bool saveInProgress = false;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#include "../pch.h"
+#include "../ECS/Components.h"
+#include "../ECS/ComponentReflection.h"
+#include "../Scene/SceneBounds.h"
+#include "../Scene/SceneData.h"
+#include "../Scene/SceneLoader.h"
+#include "../Rendering/D3D11ResourceBackend.h"
+
+// Conversions between the ECS components and the CPU-side scene records.
+namespace BlackJawz::Editor
+{
+	inline Scene::TransformData ToTransformData(const Component::Transform& transform)
+	{
+		Scene::TransformData data;
+		Scene::Reflection::Convert(transform, data);
+		return data;
+	}
+
+	inline Scene::LightData ToLightData(const Component::Light& light)
+	{
+		Scene::LightData data;
+		Scene::Reflection::Convert(light, data);
+		return data;
+	}
+
+	// The stored world matrix is ignored, it is rebuilt from the other fields
+	inline Component::Transform FromTransformData(const Scene::TransformData& data)
+	{
+		Component::Transform transform;
+		Scene::Reflection::Convert(data, transform);
+		transform.UpdateWorldMatrix();
+		return transform;
+	}
+
+	inline Component::Light FromLightData(const Scene::LightData& data)
+	{
+		Component::Light light;
+		Scene::Reflection::Convert(data, light);
+		return light;
+	}
+
+	inline Scene::InstancesData ToInstancesData(const Component::Instances& instances)
+	{
+		static_assert(sizeof(Component::InstanceTransform) == sizeof(Scene::InstanceTransformData), "Instance transforms are copied whole");
+
+		Scene::InstancesData data;
+		data.transforms.resize(instances.transforms.size());
+		memcpy(data.transforms.data(), instances.transforms.data(), instances.transforms.size() * sizeof(Scene::InstanceTransformData));
+		data.paramStride = instances.paramStride;
+		data.params = instances.params;
+		return data;
+	}
+
+	inline std::shared_ptr<Component::Instances> FromInstancesData(const Scene::InstancesData& data)
+	{
+		auto instances = std::make_shared<Component::Instances>();
+		instances->transforms.resize(data.transforms.size());
+		memcpy(instances->transforms.data(), data.transforms.data(), data.transforms.size() * sizeof(Scene::InstanceTransformData));
+		instances->paramStride = data.paramStride;
+		instances->params = data.params;
+		return instances;
+	}
+
+	// The resources must already have been created by the backend
+	inline Component::Appearance FromAppearanceData(const Scene::AppearanceData& data, const Scene::ResourceSlots& slots,
+		const Rendering::D3D11ResourceBackend& backend)
+	{
+		Component::Geometry geometry;
+		geometry.IndicesCount = data.geometry.indicesCount;
+		geometry.vertexBufferStride = data.geometry.vertexBufferStride;
+		geometry.vertexBufferOffset = data.geometry.vertexBufferOffset;
+		geometry.pVertexBuffer = backend.GetBuffer(slots.vertexBuffer);
+		geometry.pIndexBuffer = backend.GetBuffer(slots.indexBuffer);
+
+		if (data.geometry.bounds)
+		{
+			geometry.packedVertices = data.geometry.vertexFormat == Scene::VertexFormat::Packed;
+			geometry.hasBounds = true;
+			memcpy(&geometry.boundsMin, data.geometry.bounds->min, sizeof(geometry.boundsMin));
+			memcpy(&geometry.boundsMax, data.geometry.bounds->max, sizeof(geometry.boundsMax));
+		}
+
+		Component::Appearance appearance(geometry);
+		appearance.textureDataDiffuse = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::Diffuse)]);
+		appearance.textureDataNormal = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::Normal)]);
+		appearance.textureDataMetal = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::Metal)]);
+		appearance.textureDataRoughness = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::Roughness)]);
+		appearance.textureDataAO = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::AO)]);
+		appearance.textureDataDisplacement = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::Displacement)]);
+		appearance.textureDataPacked = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::Packed)]);
+		appearance.textureDataConeStep = backend.GetTexture(slots.textures[static_cast<size_t>(Scene::TextureSlot::ConeStep)]);
+
+		if (data.instances)
+		{
+			appearance.instances = FromInstancesData(*data.instances);
+		}
+		return appearance;
+	}
+
+	// World space box around a placed mesh and its instances, meshes without bounds have none
+	inline std::optional<Scene::BoundsData> ToWorldBounds(const Component::Transform& transform, const Component::Appearance& appearance)
+	{
+		const Component::Geometry& geometry = appearance.objectGeometry;
+		if (!geometry.hasBounds)
+			return std::nullopt;
+
+		Scene::BoundsData localBounds;
+		memcpy(localBounds.min, &geometry.boundsMin, sizeof(localBounds.min));
+		memcpy(localBounds.max, &geometry.boundsMax, sizeof(localBounds.max));
+
+		float worldMatrix[16];
+		Scene::ComposeWorldMatrix(&transform.position.x, &transform.rotation.x, &transform.scale.x, worldMatrix);
+
+		if (!appearance.instances)
+			return Scene::ComputeWorldBounds(localBounds, worldMatrix);
+
+		// Same layout, see ToInstancesData
+		const auto& transforms = appearance.instances->transforms;
+		return Scene::ComputeWorldBounds(localBounds, worldMatrix,
+			reinterpret_cast<const Scene::InstanceTransformData*>(transforms.data()), transforms.size());
+	}
+}
@@ -0,0 +1,155 @@
+#include "SceneLoadTask.h"
+
+#include <algorithm>
+
+BlackJawz::Editor::SceneLoadTask::SceneLoadTask(Scene::SceneLoader& loader, InsertEntityFunc insertEntity)
+	: loader(loader), insertEntity(std::move(insertEntity))
+{
+
+}
+
+BlackJawz::Editor::SceneLoadTask::~SceneLoadTask()
+{
+	// The decode job writes into the scene owned by this task
+	if (busy)
+	{
+		loader.Wait();
+	}
+}
+
+bool BlackJawz::Editor::SceneLoadTask::Begin(const std::string& filename)
+{
+	if (busy)
+		return false;
+
+	this->filename = filename;
+	journalId = 0;
+	spatialIndex.Clear();
+	nextEntity = 0;
+	waitingEntities.clear();
+	insertedCount = 0;
+	frameCount = 0;
+	insertMs = 0.0;
+	firstEntityMs = -1.0;
+	startTime = std::chrono::steady_clock::now();
+
+	busy = loader.Begin(filename, scene);
+	return busy;
+}
+
+bool BlackJawz::Editor::SceneLoadTask::Update(double budgetMs)
+{
+	if (!busy)
+		return false;
+
+	++frameCount;
+
+	Scene::SceneLoader::State state = loader.GetState();
+	if (state == Scene::SceneLoader::State::Failed)
+	{
+		Scene::VerifyResult verifyResult = loader.GetStats().verifyResult;
+		std::string reason = verifyResult != Scene::VerifyResult::Valid ? std::string(": ") + Scene::GetVerifyResultName(verifyResult) : "";
+		OutputDebugStringA(("Failed to load scene " + filename + reason + "\n").c_str());
+		busy = false;
+		scene = Scene::LoadedScene();
+		return false;
+	}
+
+	// Entities in the decoded prefix can be inserted while the rest of the file is still decoding.
+	// The state is read first, once it is Decoded the count covers every entity.
+	size_t decodedCount = loader.GetDecodedCount();
+	if (decodedCount == 0 && state != Scene::SceneLoader::State::Decoded)
+		return false;
+
+	if (firstEntityMs < 0.0 && decodedCount > 0)
+	{
+		firstEntityMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	auto frameStart = std::chrono::steady_clock::now();
+	auto deadline = frameStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double, std::milli>(budgetMs));
+
+	// Entities that were waiting on the loader thread go first
+	size_t stillWaiting = 0;
+	for (size_t i = 0; i < waitingEntities.size(); ++i)
+	{
+		size_t entityIndex = waitingEntities[i];
+		if (std::chrono::steady_clock::now() < deadline && loader.AreResourcesReady(scene.resourceSlots[entityIndex]))
+		{
+			insertEntity(entityIndex, scene.entities[entityIndex], scene.resourceSlots[entityIndex]);
+			++insertedCount;
+		}
+		else
+		{
+			waitingEntities[stillWaiting++] = entityIndex;
+		}
+	}
+	waitingEntities.resize(stillWaiting);
+
+	while (nextEntity < decodedCount && std::chrono::steady_clock::now() < deadline)
+	{
+		if (loader.AreResourcesReady(scene.resourceSlots[nextEntity]))
+		{
+			insertEntity(nextEntity, scene.entities[nextEntity], scene.resourceSlots[nextEntity]);
+			++insertedCount;
+		}
+		else
+		{
+			waitingEntities.push_back(nextEntity);
+		}
+		++nextEntity;
+	}
+
+	insertMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+
+	if (state != Scene::SceneLoader::State::Decoded || nextEntity < decodedCount || !waitingEntities.empty())
+		return false;
+
+	Finish();
+	return true;
+}
+
+void BlackJawz::Editor::SceneLoadTask::Finish()
+{
+	// Every slot is ready by now, this only joins the loader's bookkeeping
+	loader.Wait();
+
+	double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	const Scene::LoadStats& stats = loader.GetStats();
+
+	char message[384];
+	snprintf(message, sizeof(message),
+		"Incrementally loaded %zu entities from %s over %u frames: first entities after %.1f ms, total %.1f ms (read %.1f ms, decompress %.1f ms, decode %.1f ms), %.1f ms inserting on the UI thread, %.1f MB/s\n",
+		insertedCount, filename.c_str(), frameCount, std::max(firstEntityMs, 0.0), totalMs, stats.readMs, stats.decompressMs, stats.decodeMs, insertMs,
+		totalMs > 0.0 ? stats.fileBytes / (1024.0 * 1024.0) / (totalMs / 1000.0) : 0.0);
+	OutputDebugStringA(message);
+
+	journalId = scene.journalId;
+	spatialIndex = std::move(scene.spatialIndex);
+	busy = false;
+	scene = Scene::LoadedScene();
+	waitingEntities.clear();
+	waitingEntities.shrink_to_fit();
+}
+
+const char* BlackJawz::Editor::SceneLoadTask::GetStageName() const
+{
+	if (!busy)
+		return "";
+
+	return loader.GetState() == Scene::SceneLoader::State::Decoded ? "Streaming" : "Decoding";
+}
+
+float BlackJawz::Editor::SceneLoadTask::GetProgress() const
+{
+	if (!busy)
+		return 0.0f;
+
+	// Inserted entities only, they trail the decoded ones
+	size_t entityCount = loader.GetEntityCount();
+	if (loader.GetState() == Scene::SceneLoader::State::Decoded && entityCount == 0)
+		return 1.0f;
+
+	return entityCount > 0 ? static_cast<float>(insertedCount) / static_cast<float>(entityCount) : 0.0f;
+}
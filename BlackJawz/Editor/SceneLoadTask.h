@@ -0,0 +1,63 @@
+#pragma once
+#include "../pch.h"
+#include "../Scene/SceneLoader.h"
+
+#include <chrono>
+#include <functional>
+
+namespace BlackJawz::Editor
+{
+	// Loads a scene over several frames. Decoding and uploads run in the background, and each frame
+	// inserts the decoded entities whose resources are ready until its time budget is spent, so the
+	// scene fills in while the rest of the file is still decoding.
+	class SceneLoadTask
+	{
+	public:
+		// Entities may arrive out of file order, index is the entity's position in the file
+		using InsertEntityFunc = std::function<void(size_t index, Scene::EntityData& data, const Scene::ResourceSlots& slots)>;
+
+		static constexpr double DefaultFrameBudgetMs = 4.0;
+
+		SceneLoadTask(Scene::SceneLoader& loader, InsertEntityFunc insertEntity);
+		~SceneLoadTask();
+
+		bool Begin(const std::string& filename);
+
+		// Called once per frame on the UI thread, returns true on the frame the load completes
+		bool Update(double budgetMs = DefaultFrameBudgetMs);
+
+		bool IsBusy() const { return busy; }
+		const char* GetStageName() const;
+		float GetProgress() const;
+		const std::string& GetFilename() const { return filename; }
+
+		// Journal id of the last finished load, 0 if the file was not saved for journaling
+		uint64_t GetJournalId() const { return journalId; }
+
+		// Spatial index of the last finished load, numbered by the indices entities were inserted with
+		Scene::SpatialIndex TakeSpatialIndex() { return std::move(spatialIndex); }
+
+	private:
+		void Finish();
+
+		Scene::SceneLoader& loader;
+		InsertEntityFunc insertEntity;
+
+		Scene::LoadedScene scene;
+		std::string filename;
+		uint64_t journalId = 0;
+		Scene::SpatialIndex spatialIndex;
+		bool busy = false;
+
+		// Entities are inserted in file order, except those still waiting on resources
+		size_t nextEntity = 0;
+		std::vector<size_t> waitingEntities;
+		size_t insertedCount = 0;
+
+		// Measured so the cost of spreading the load out can be compared with a blocking load
+		std::chrono::steady_clock::time_point startTime;
+		uint32_t frameCount = 0;
+		double insertMs = 0.0;
+		double firstEntityMs = -1.0; // Until the first entities are decoded
+	};
+}
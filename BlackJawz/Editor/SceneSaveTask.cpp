@@ -0,0 +1,742 @@
+#include "SceneSaveTask.h"
+#include "SceneConversion.h"
+#include "../Scene/SceneWriter.h"
+#include "../Scene/SceneJournal.h"
+#include "../Scene/SceneAssets.h"
+#include "../Scene/SceneBounds.h"
+#include "../Scene/SceneReader.h"
+#include "../Scene/SceneVerifier.h"
+#include "../Scene/VertexPacking.h"
+
+#include <map>
+#include <tuple>
+
+BlackJawz::Editor::SceneSaveTask::SceneSaveTask(Jobs::JobSystem& jobSystem) : jobSystem(jobSystem)
+{
+
+}
+
+BlackJawz::Editor::SceneSaveTask::~SceneSaveTask()
+{
+	// The pipeline job references this task, let it finish before tearing down
+	jobSystem.Wait(pipelineCounter);
+}
+
+bool BlackJawz::Editor::SceneSaveTask::Begin(const std::string& filename, uint64_t journalId)
+{
+	if (IsBusy())
+		return false;
+
+	jobSystem.Wait(pipelineCounter);
+
+	this->filename = filename;
+	this->journalId = journalId;
+	deltaSave = false;
+	removedIds.clear();
+	bytesWritten.store(0, std::memory_order_relaxed);
+	entities.clear();
+	appearanceResources.clear();
+	buffers.clear();
+	textures.clear();
+	resourceIndices.clear();
+	nextReadback = 0;
+	readbacksInFlight.clear();
+
+	SetStage(Stage::Readback, 0);
+	return true;
+}
+
+void BlackJawz::Editor::SceneSaveTask::SetWorldPartition(float cellSize, const Scene::WorldPartition* source,
+	const std::vector<Scene::CellCoord>& residentCells)
+{
+	partitionCellSize = cellSize;
+	sourcePartition.reset();
+	this->residentCells.clear();
+
+	if (source && source->IsOpen())
+	{
+		sourcePartition = *source;
+		this->residentCells.insert(residentCells.begin(), residentCells.end());
+	}
+}
+
+bool BlackJawz::Editor::SceneSaveTask::BeginDelta(const std::string& filename, uint64_t baseJournalId, std::vector<uint32_t> removedIds)
+{
+	if (!Begin(filename, baseJournalId))
+		return false;
+
+	deltaSave = true;
+	this->removedIds = std::move(removedIds);
+	return true;
+}
+
+void BlackJawz::Editor::SceneSaveTask::AddEntity(uint32_t id, const std::string& name, const Component::Transform* transform,
+	const Component::Appearance* appearance, const Component::Light* light)
+{
+	Scene::EntityData data;
+	data.id = id;
+	data.name = name;
+
+	if (transform)
+	{
+		// Update the world matrix on a copy so the snapshot never writes back to the ECS
+		Component::Transform transformCopy = *transform;
+		transformCopy.UpdateWorldMatrix();
+		data.transform = ToTransformData(transformCopy);
+	}
+
+	if (appearance)
+	{
+		const Component::Geometry& geometry = appearance->objectGeometry;
+
+		data.appearance.emplace();
+		data.appearance->geometry.indicesCount = geometry.IndicesCount;
+		data.appearance->geometry.vertexBufferStride = geometry.vertexBufferStride;
+		data.appearance->geometry.vertexBufferOffset = geometry.vertexBufferOffset;
+
+		// Packed vertices cannot be decoded without their bounds, other meshes without them are
+		// measured once read back
+		if (geometry.hasBounds || geometry.packedVertices)
+		{
+			Scene::BoundsData& bounds = data.appearance->geometry.bounds.emplace();
+			memcpy(bounds.min, &geometry.boundsMin, sizeof(bounds.min));
+			memcpy(bounds.max, &geometry.boundsMax, sizeof(bounds.max));
+		}
+		if (geometry.packedVertices)
+		{
+			data.appearance->geometry.vertexFormat = Scene::VertexFormat::Packed;
+		}
+
+		if (appearance->instances)
+		{
+			data.appearance->instances = ToInstancesData(*appearance->instances);
+		}
+
+		AppearanceResources resources;
+		resources.entityIndex = entities.size();
+		resources.vertexBuffer = AddBuffer(geometry.pVertexBuffer.Get());
+		resources.indexBuffer = AddBuffer(geometry.pIndexBuffer.Get());
+
+		// Same order as Scene::TextureSlot
+		ID3D11ShaderResourceView* textureViews[Scene::TextureSlotCount] =
+		{
+			appearance->textureDataDiffuse.Get(),
+			appearance->textureDataNormal.Get(),
+			appearance->textureDataMetal.Get(),
+			appearance->textureDataRoughness.Get(),
+			appearance->textureDataAO.Get(),
+			appearance->textureDataDisplacement.Get(),
+			appearance->textureDataPacked.Get(),
+			appearance->textureDataConeStep.Get()
+		};
+
+		for (size_t slot = 0; slot < Scene::TextureSlotCount; ++slot)
+		{
+			resources.textures[slot] = AddTexture(textureViews[slot]);
+		}
+
+		appearanceResources.push_back(resources);
+	}
+
+	if (light)
+	{
+		data.light = ToLightData(*light);
+	}
+
+	entities.push_back(std::move(data));
+}
+
+int BlackJawz::Editor::SceneSaveTask::AddBuffer(ID3D11Buffer* buffer)
+{
+	if (!buffer)
+		return -1;
+
+	// Shared meshes are only read back once
+	auto it = resourceIndices.find(buffer);
+	if (it != resourceIndices.end())
+		return it->second;
+
+	int index = static_cast<int>(buffers.size());
+	buffers.emplace_back();
+	buffers.back().source = buffer;
+
+	resourceIndices.emplace(buffer, index);
+	stageTotal.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+int BlackJawz::Editor::SceneSaveTask::AddTexture(ID3D11ShaderResourceView* srv)
+{
+	if (!srv)
+		return -1;
+
+	ComPtr<ID3D11Resource> resource;
+	srv->GetResource(resource.GetAddressOf());
+
+	auto it = resourceIndices.find(resource.Get());
+	if (it != resourceIndices.end())
+		return it->second;
+
+	ComPtr<ID3D11Texture2D> texture;
+	if (FAILED(resource.As(&texture)))
+		return -1;
+
+	int index = static_cast<int>(textures.size());
+	textures.emplace_back();
+	textures.back().source = texture;
+
+	resourceIndices.emplace(resource.Get(), index);
+	stageTotal.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+void BlackJawz::Editor::SceneSaveTask::Update(ID3D11Device* device, ID3D11DeviceContext* context)
+{
+	if (GetStage() != Stage::Readback)
+		return;
+
+	size_t readbackCount = buffers.size() + textures.size();
+
+	// Collect finished readbacks first so their slots can be refilled this frame
+	for (auto it = readbacksInFlight.begin(); it != readbacksInFlight.end();)
+	{
+		if (CollectReadback(context, *it))
+		{
+			it = readbacksInFlight.erase(it);
+			stageCompleted.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	while (readbacksInFlight.size() < MaxReadbacksInFlight && nextReadback < readbackCount)
+	{
+		if (IssueReadback(device, context, nextReadback))
+		{
+			readbacksInFlight.push_back(nextReadback);
+		}
+		else
+		{
+			stageCompleted.fetch_add(1, std::memory_order_relaxed);
+		}
+		++nextReadback;
+	}
+
+	if (readbacksInFlight.empty() && nextReadback == readbackCount)
+	{
+		// The blobs own the data now, drop the GPU references
+		for (auto& buffer : buffers)
+		{
+			buffer.source.Reset();
+			buffer.staging.Reset();
+		}
+		for (auto& texture : textures)
+		{
+			texture.source.Reset();
+			texture.staging.Reset();
+		}
+		resourceIndices.clear();
+
+		SetStage(Stage::Encoding, textures.size());
+		jobSystem.Execute(pipelineCounter, [this]() { RunPipeline(); });
+	}
+}
+
+bool BlackJawz::Editor::SceneSaveTask::IssueReadback(ID3D11Device* device, ID3D11DeviceContext* context, size_t index)
+{
+	if (index < buffers.size())
+	{
+		BufferReadback& buffer = buffers[index];
+
+		D3D11_BUFFER_DESC stagingDesc;
+		buffer.source->GetDesc(&stagingDesc);
+		stagingDesc.Usage = D3D11_USAGE_STAGING;
+		stagingDesc.BindFlags = 0;
+		stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+		stagingDesc.MiscFlags = 0;
+
+		HRESULT hr = device->CreateBuffer(&stagingDesc, nullptr, buffer.staging.GetAddressOf());
+		if (FAILED(hr))
+		{
+			OutputDebugStringA("Failed to create staging buffer for scene save.\n");
+			return false;
+		}
+
+		context->CopyResource(buffer.staging.Get(), buffer.source.Get());
+		return true;
+	}
+
+	TextureReadback& texture = textures[index - buffers.size()];
+
+	D3D11_TEXTURE2D_DESC stagingDesc;
+	texture.source->GetDesc(&stagingDesc);
+	if (stagingDesc.SampleDesc.Count > 1)
+	{
+		OutputDebugStringA("Skipping multisampled texture in scene save.\n");
+		return false;
+	}
+
+	// Only the top mip of the first slice is saved, copy just that
+	stagingDesc.MipLevels = 1;
+	stagingDesc.ArraySize = 1;
+	stagingDesc.Usage = D3D11_USAGE_STAGING;
+	stagingDesc.BindFlags = 0;
+	stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+	stagingDesc.MiscFlags = 0;
+
+	HRESULT hr = device->CreateTexture2D(&stagingDesc, nullptr, texture.staging.GetAddressOf());
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to create staging texture for scene save.\n");
+		return false;
+	}
+
+	context->CopySubresourceRegion(texture.staging.Get(), 0, 0, 0, 0, texture.source.Get(), 0, nullptr);
+	return true;
+}
+
+bool BlackJawz::Editor::SceneSaveTask::CollectReadback(ID3D11DeviceContext* context, size_t index)
+{
+	ID3D11Resource* staging = index < buffers.size()
+		? static_cast<ID3D11Resource*>(buffers[index].staging.Get())
+		: static_cast<ID3D11Resource*>(textures[index - buffers.size()].staging.Get());
+
+	// Never block the UI thread on the GPU, try again next frame
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT hr = context->Map(staging, 0, D3D11_MAP_READ, D3D11_MAP_FLAG_DO_NOT_WAIT, &mappedResource);
+	if (hr == DXGI_ERROR_WAS_STILL_DRAWING)
+		return false;
+
+	if (FAILED(hr))
+	{
+		// Saved without this resource, same as a failed capture
+		OutputDebugStringA("Failed to map staging resource for scene save.\n");
+		return true;
+	}
+
+	if (index < buffers.size())
+	{
+		BufferReadback& buffer = buffers[index];
+
+		D3D11_BUFFER_DESC desc;
+		buffer.staging->GetDesc(&desc);
+
+		const uint8_t* dataPtr = static_cast<const uint8_t*>(mappedResource.pData);
+		buffer.data = Scene::Blob::FromVector(std::vector<uint8_t>(dataPtr, dataPtr + desc.ByteWidth));
+	}
+	else
+	{
+		TextureReadback& texture = textures[index - buffers.size()];
+
+		D3D11_TEXTURE2D_DESC desc;
+		texture.staging->GetDesc(&desc);
+
+		hr = texture.image.Initialize2D(desc.Format, desc.Width, desc.Height, 1, 1);
+		if (SUCCEEDED(hr))
+		{
+			// Block compressed formats have one scanline per row of blocks
+			const DirectX::Image* image = texture.image.GetImage(0, 0, 0);
+			size_t scanlines = DirectX::ComputeScanlines(desc.Format, desc.Height);
+			size_t rowSize = std::min<size_t>(image->rowPitch, mappedResource.RowPitch);
+
+			const uint8_t* src = static_cast<const uint8_t*>(mappedResource.pData);
+			uint8_t* dest = image->pixels;
+			for (size_t row = 0; row < scanlines; ++row)
+			{
+				memcpy(dest, src, rowSize);
+				src += mappedResource.RowPitch;
+				dest += image->rowPitch;
+			}
+		}
+		else
+		{
+			OutputDebugStringA("Failed to capture texture.\n");
+		}
+	}
+
+	context->Unmap(staging, 0);
+	return true;
+}
+
+void BlackJawz::Editor::SceneSaveTask::RunPipeline()
+{
+	// Encode the captured textures to DDS, one job per unique texture
+	Jobs::JobCounter encodeCounter;
+	jobSystem.Dispatch(encodeCounter, static_cast<uint32_t>(textures.size()), 1, [this](uint32_t index)
+		{
+			TextureReadback& texture = textures[index];
+			if (texture.image.GetImageCount() > 0)
+			{
+				auto ddsBlob = std::make_shared<DirectX::Blob>();
+				HRESULT hr = DirectX::SaveToDDSMemory(*texture.image.GetImage(0, 0, 0), DirectX::DDS_FLAGS_NONE, *ddsBlob);
+				if (SUCCEEDED(hr))
+				{
+					texture.data.data = static_cast<const uint8_t*>(ddsBlob->GetBufferPointer());
+					texture.data.size = ddsBlob->GetBufferSize();
+					texture.data.owner = std::move(ddsBlob);
+				}
+				else
+				{
+					OutputDebugStringA("Failed to save DDS to memory.\n");
+				}
+				texture.image.Release();
+			}
+			stageCompleted.fetch_add(1, std::memory_order_relaxed);
+		});
+	jobSystem.Wait(encodeCounter);
+
+	// Hand the read back data to every entity that references it
+	for (const auto& resources : appearanceResources)
+	{
+		Scene::AppearanceData& appearance = *entities[resources.entityIndex].appearance;
+
+		if (resources.vertexBuffer >= 0)
+			appearance.geometry.vertexBuffer = buffers[resources.vertexBuffer].data;
+		if (resources.indexBuffer >= 0)
+			appearance.geometry.indexBuffer = buffers[resources.indexBuffer].data;
+
+		for (size_t slot = 0; slot < Scene::TextureSlotCount; ++slot)
+		{
+			if (resources.textures[slot] >= 0)
+				appearance.textures[slot] = textures[resources.textures[slot]].data;
+		}
+	}
+	buffers.clear();
+	textures.clear();
+	appearanceResources.clear();
+
+	// Bounds for meshes created without them, the spatial index and culling need every mesh's
+	Scene::ComputeMissingBounds(entities, jobSystem);
+
+	if (packVertices)
+	{
+		PackVertices();
+	}
+
+	bool written = deltaSave ? WriteDelta() : partitionCellSize > 0.0f ? WritePartitionedScene() : WriteScene();
+	entities.clear();
+	removedIds.clear();
+
+	if (written)
+	{
+		char message[256];
+		snprintf(message, sizeof(message), "%s %s: %zu bytes written\n",
+			deltaSave ? "Journaled save of" : "Saved", filename.c_str(), bytesWritten.load(std::memory_order_relaxed));
+		OutputDebugStringA(message);
+	}
+
+	SetStage(written ? Stage::Done : Stage::Failed, 0);
+}
+
+void BlackJawz::Editor::SceneSaveTask::PackVertices()
+{
+	// Entities sharing a mesh share the read back blob, each blob and layout is packed once
+	using GeometryKey = std::tuple<const uint8_t*, uint32_t, uint32_t>;
+	std::map<GeometryKey, size_t> geometryIndices;
+	std::vector<Scene::GeometryData> geometries;
+
+	for (const auto& entity : entities)
+	{
+		if (!entity.appearance || entity.appearance->geometry.vertexFormat != Scene::VertexFormat::Float)
+			continue;
+
+		const Scene::GeometryData& geometry = entity.appearance->geometry;
+		GeometryKey key(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset);
+		if (!geometry.vertexBuffer.Empty() && geometryIndices.emplace(key, geometries.size()).second)
+			geometries.push_back(geometry);
+	}
+
+	std::vector<char> packed(geometries.size(), 0);
+	Jobs::JobCounter packCounter;
+	jobSystem.Dispatch(packCounter, static_cast<uint32_t>(geometries.size()), 1, [&geometries, &packed](uint32_t index)
+		{
+			packed[index] = Scene::PackVertices(geometries[index]) ? 1 : 0;
+		});
+	jobSystem.Wait(packCounter);
+
+	for (auto& entity : entities)
+	{
+		if (!entity.appearance || entity.appearance->geometry.vertexFormat != Scene::VertexFormat::Float)
+			continue;
+
+		Scene::GeometryData& geometry = entity.appearance->geometry;
+		auto it = geometryIndices.find(GeometryKey(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset));
+		if (it == geometryIndices.end() || !packed[it->second])
+			continue;
+
+		const Scene::GeometryData& result = geometries[it->second];
+		geometry.vertexBuffer = result.vertexBuffer;
+		geometry.vertexBufferStride = result.vertexBufferStride;
+		geometry.vertexBufferOffset = result.vertexBufferOffset;
+		geometry.vertexFormat = result.vertexFormat;
+		geometry.bounds = result.bounds;
+	}
+}
+
+bool BlackJawz::Editor::SceneSaveTask::WriteScene()
+{
+	// Every unique mesh and texture goes in the asset section once, identical contents are merged by hash
+	Scene::SceneAssets assets(compressAssets);
+	assets.Collect(entities.data(), entities.size());
+
+	SetStage(Stage::Compressing, assets.GetCount());
+
+	Jobs::JobCounter hashCounter;
+	jobSystem.Dispatch(hashCounter, static_cast<uint32_t>(assets.GetCount()), 1, [&assets](uint32_t index) { assets.Hash(index); });
+	jobSystem.Wait(hashCounter);
+
+	assets.Deduplicate();
+	stageTotal.store(assets.GetCount(), std::memory_order_relaxed);
+
+	Jobs::JobCounter compressCounter;
+	jobSystem.Dispatch(compressCounter, static_cast<uint32_t>(assets.GetCount()), 1, [this, &assets](uint32_t index)
+		{
+			assets.Compress(index);
+			stageCompleted.fetch_add(1, std::memory_order_relaxed);
+		});
+	jobSystem.Wait(compressCounter);
+
+	// Serialize the entities into independent chunks
+	size_t chunkCount = Scene::SceneWriter::GetChunkCount(entities.size());
+	SetStage(Stage::Serializing, chunkCount);
+
+	std::vector<flatbuffers::DetachedBuffer> chunks(chunkCount);
+	Jobs::JobCounter chunkCounter;
+	jobSystem.Dispatch(chunkCounter, static_cast<uint32_t>(chunkCount), 1, [this, &chunks, &assets](uint32_t index)
+		{
+			size_t begin = index * Scene::SceneWriter::EntitiesPerChunk;
+			size_t count = std::min(Scene::SceneWriter::EntitiesPerChunk, entities.size() - begin);
+
+			chunks[index] = Scene::SceneWriter::WriteChunk(entities.data() + begin, count, &assets);
+			stageCompleted.fetch_add(1, std::memory_order_relaxed);
+		});
+	jobSystem.Wait(chunkCounter);
+
+	SetStage(Stage::Writing, 1);
+
+	// Entities are numbered in the order they were added, which is the order they are written
+	Scene::SpatialIndex spatialIndex;
+	spatialIndex.Build(entities, jobSystem);
+
+	flatbuffers::DetachedBuffer scene = Scene::SceneWriter::MergeChunks(chunks, journalId, &assets, &spatialIndex);
+	chunks.clear();
+
+	uint64_t rawBytes = assets.GetRawBytes();
+	uint64_t storedBytes = assets.GetStoredBytes();
+
+	char message[256];
+	snprintf(message, sizeof(message), "Scene assets: %zu unique, %.1f MB raw, %.1f MB stored (%.0f%%)\n",
+		assets.GetCount(), rawBytes / (1024.0 * 1024.0), storedBytes / (1024.0 * 1024.0),
+		rawBytes > 0 ? 100.0 * static_cast<double>(storedBytes) / static_cast<double>(rawBytes) : 100.0);
+	OutputDebugStringA(message);
+
+	if (!Scene::SceneWriter::WriteToFile(filename, scene.data(), scene.size()))
+	{
+		OutputDebugStringA("Failed to write scene file.\n");
+		return false;
+	}
+
+	// The new base already holds everything the old journal recorded
+	Scene::SceneJournal::Discard(filename);
+
+	bytesWritten.store(scene.size(), std::memory_order_release);
+	return true;
+}
+
+bool BlackJawz::Editor::SceneSaveTask::WritePartitionedScene()
+{
+	// Cells are self contained so each can be streamed on its own, payloads are stored inline instead of in a shared asset section
+	struct PendingCell
+	{
+		Scene::CellCoord coord;
+		std::vector<size_t> entities; // Indices into the snapshot
+		const Scene::CellInfo* source = nullptr; // Carried over from the source file
+	};
+
+	std::vector<PendingCell> pending;
+	std::unordered_map<Scene::CellCoord, size_t, Scene::CellCoordHash> pendingIndices;
+
+	uint32_t nextEntityId = sourcePartition ? sourcePartition->GetNextEntityId() : 0;
+	for (const auto& entity : entities)
+	{
+		nextEntityId = std::max(nextEntityId, entity.id + 1);
+	}
+
+	for (auto& [coord, cellEntities] : Scene::WorldPartition::Partition(entities.data(), entities.size(), partitionCellSize))
+	{
+		pendingIndices.emplace(coord, pending.size());
+		pending.push_back({ coord, std::move(cellEntities), nullptr });
+	}
+
+	// Cells that were not resident are not in the snapshot, entities moved into one are merged with it
+	if (sourcePartition)
+	{
+		for (const Scene::CellInfo& cell : sourcePartition->GetCells())
+		{
+			if (residentCells.count(cell.coord) > 0)
+				continue;
+
+			auto it = pendingIndices.find(cell.coord);
+			if (it != pendingIndices.end())
+			{
+				pending[it->second].source = &cell;
+			}
+			else
+			{
+				pending.push_back({ cell.coord, {}, &cell });
+			}
+		}
+	}
+
+	SetStage(Stage::Serializing, pending.size());
+
+	std::vector<Scene::CellData> cells(pending.size());
+	std::atomic<bool> failed{ false };
+
+	Jobs::JobCounter cellCounter;
+	jobSystem.Dispatch(cellCounter, static_cast<uint32_t>(pending.size()), 1, [this, &pending, &cells, &failed](uint32_t index)
+		{
+			const PendingCell& cell = pending[index];
+			Scene::CellData& cellData = cells[index];
+			cellData.coord = cell.coord;
+
+			Scene::Blob sourceData;
+			if (cell.source && !sourcePartition->ReadCell(*cell.source, sourceData))
+			{
+				failed.store(true, std::memory_order_relaxed);
+				return;
+			}
+
+			if (cell.entities.empty())
+			{
+				// Untouched, the bytes are copied as they are
+				cellData.entityCount = cell.source->entityCount;
+				cellData.data = std::move(sourceData);
+			}
+			else
+			{
+				std::vector<Scene::EntityData> cellEntities;
+				if (cell.source)
+				{
+					if (Scene::SceneVerifier::VerifyStructure(sourceData.data, sourceData.size) != Scene::VerifyResult::Valid)
+					{
+						failed.store(true, std::memory_order_relaxed);
+						return;
+					}
+
+					const ECS::Scene* sourceScene = ECS::GetScene(sourceData.data);
+					if (sourceScene->entities())
+					{
+						for (const ECS::Entity* entity : *sourceScene->entities())
+						{
+							Scene::SceneReader::ReadEntity(entity, sourceData, {}, cellEntities.emplace_back());
+						}
+					}
+				}
+
+				// Every snapshot entity is in exactly one cell
+				for (size_t entityIndex : cell.entities)
+				{
+					cellEntities.push_back(std::move(entities[entityIndex]));
+				}
+
+				auto buffer = std::make_shared<flatbuffers::DetachedBuffer>(
+					Scene::SceneWriter::WriteChunk(cellEntities.data(), cellEntities.size()));
+
+				cellData.entityCount = static_cast<uint32_t>(cellEntities.size());
+				cellData.data.data = buffer->data();
+				cellData.data.size = buffer->size();
+				cellData.data.owner = std::move(buffer);
+			}
+
+			stageCompleted.fetch_add(1, std::memory_order_relaxed);
+		});
+	jobSystem.Wait(cellCounter);
+
+	if (failed.load(std::memory_order_relaxed))
+	{
+		OutputDebugStringA("Failed to read a cell from the streamed scene.\n");
+		return false;
+	}
+
+	SetStage(Stage::Writing, 1);
+
+	flatbuffers::DetachedBuffer scene = Scene::SceneWriter::MergeCells(cells, partitionCellSize, nextEntityId);
+	cells.clear();
+
+	if (!Scene::SceneWriter::WriteToFile(filename, scene.data(), scene.size()))
+	{
+		OutputDebugStringA("Failed to write scene file.\n");
+		return false;
+	}
+
+	// Partitioned saves are always full saves
+	Scene::SceneJournal::Discard(filename);
+
+	char message[256];
+	snprintf(message, sizeof(message), "World partition: %zu cells of %.0f units\n", pending.size(), partitionCellSize);
+	OutputDebugStringA(message);
+
+	bytesWritten.store(scene.size(), std::memory_order_release);
+	return true;
+}
+
+bool BlackJawz::Editor::SceneSaveTask::WriteDelta()
+{
+	SetStage(Stage::Serializing, 1);
+	flatbuffers::DetachedBuffer delta = Scene::SceneJournal::WriteDelta(journalId, entities.data(), entities.size(), removedIds);
+
+	SetStage(Stage::Writing, 1);
+	if (!Scene::SceneJournal::Append(filename, delta.data(), delta.size()))
+	{
+		OutputDebugStringA("Failed to append to scene journal.\n");
+		return false;
+	}
+
+	bytesWritten.store(delta.size(), std::memory_order_release);
+	return true;
+}
+
+void BlackJawz::Editor::SceneSaveTask::SetStage(Stage newStage, size_t total)
+{
+	stageCompleted.store(0, std::memory_order_relaxed);
+	stageTotal.store(total, std::memory_order_relaxed);
+	stage.store(newStage, std::memory_order_release);
+}
+
+bool BlackJawz::Editor::SceneSaveTask::IsBusy() const
+{
+	Stage current = GetStage();
+	return current != Stage::Idle && current != Stage::Done && current != Stage::Failed;
+}
+
+const char* BlackJawz::Editor::SceneSaveTask::GetStageName() const
+{
+	switch (GetStage())
+	{
+	case Stage::Readback:    return "Reading back";
+	case Stage::Encoding:    return "Encoding textures";
+	case Stage::Compressing: return "Compressing";
+	case Stage::Serializing: return "Serializing";
+	case Stage::Writing:     return "Writing";
+	case Stage::Done:        return "Saved";
+	case Stage::Failed:      return "Save failed";
+	default:                 return "";
+	}
+}
+
+float BlackJawz::Editor::SceneSaveTask::GetProgress() const
+{
+	Stage current = GetStage();
+	if (current == Stage::Done)
+		return 1.0f;
+
+	size_t total = stageTotal.load(std::memory_order_relaxed);
+	if (total == 0)
+		return 0.0f;
+
+	size_t completed = stageCompleted.load(std::memory_order_relaxed);
+	return static_cast<float>(completed) / static_cast<float>(total);
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "../pch.h"
+#include "../ECS/Components.h"
+#include "../Scene/SceneData.h"
+#include "../Scene/WorldPartition.h"
+#include "../Util/JobSystem.h"
+
+#include <atomic>
+#include <unordered_set>
+
+namespace BlackJawz::Editor
+{
+	// Saves a snapshot of the scene without stalling the editor. The snapshot is taken on the UI thread,
+	// GPU resources are read back a few per frame, and DDS encoding and serialization run on the job system.
+	class SceneSaveTask
+	{
+	public:
+		enum class Stage
+		{
+			Idle,
+			Readback,
+			Encoding,
+			Compressing,
+			Serializing,
+			Writing,
+			Done,
+			Failed
+		};
+
+		explicit SceneSaveTask(Jobs::JobSystem& jobSystem);
+		~SceneSaveTask();
+
+		// Start a new snapshot, returns false while a previous save is still running.
+		// Full saves replace the file and its journal, journalId tags the new base.
+		bool Begin(const std::string& filename, uint64_t journalId = 0);
+
+		// Append the added entities to the file's journal instead, they only need the components that changed
+		bool BeginDelta(const std::string& filename, uint64_t baseJournalId, std::vector<uint32_t> removedIds);
+
+		void AddEntity(uint32_t id, const std::string& name, const Component::Transform* transform,
+			const Component::Appearance* appearance, const Component::Light* light);
+
+		// Called once per frame on the UI thread, issues and collects GPU readbacks
+		void Update(ID3D11Device* device, ID3D11DeviceContext* context);
+
+		bool IsBusy() const;
+		Stage GetStage() const { return stage.load(std::memory_order_acquire); }
+		const char* GetStageName() const;
+		float GetProgress() const;
+		const std::string& GetFilename() const { return filename; }
+		// Applies to the next full save, journal records are always stored uncompressed
+		void SetCompressAssets(bool compress) { compressAssets = compress; }
+		// Applies to every save, meshes that are already packed are written as they are
+		void SetPackVertices(bool pack) { packVertices = pack; }
+
+		// Applies to the next full save, a cell size of 0 writes an unpartitioned scene. When the snapshot only
+		// holds the resident cells of a streamed scene, the other cells are carried over from its file.
+		void SetWorldPartition(float cellSize, const Scene::WorldPartition* source = nullptr,
+			const std::vector<Scene::CellCoord>& residentCells = {});
+
+		bool IsDelta() const { return deltaSave; }
+		uint64_t GetJournalId() const { return journalId; }
+		size_t GetBytesWritten() const { return bytesWritten.load(std::memory_order_acquire); }
+
+	private:
+		// Readbacks kept in flight at once, bounds the staging memory used per frame
+		static constexpr size_t MaxReadbacksInFlight = 8;
+
+		struct BufferReadback
+		{
+			ComPtr<ID3D11Buffer> source;
+			ComPtr<ID3D11Buffer> staging;
+			Scene::Blob data;
+		};
+
+		struct TextureReadback
+		{
+			ComPtr<ID3D11Texture2D> source;
+			ComPtr<ID3D11Texture2D> staging;
+			DirectX::ScratchImage image;
+			Scene::Blob data; // Encoded DDS
+		};
+
+		// Indices into the readback lists for one entity's appearance, -1 when unused
+		struct AppearanceResources
+		{
+			size_t entityIndex = 0;
+			int vertexBuffer = -1;
+			int indexBuffer = -1;
+			std::array<int, Scene::TextureSlotCount> textures;
+		};
+
+		int AddBuffer(ID3D11Buffer* buffer);
+		int AddTexture(ID3D11ShaderResourceView* srv);
+
+		bool IssueReadback(ID3D11Device* device, ID3D11DeviceContext* context, size_t index);
+		// Returns true once the readback has finished, whether or not it succeeded
+		bool CollectReadback(ID3D11DeviceContext* context, size_t index);
+
+		void RunPipeline();
+		void PackVertices();
+		bool WriteScene();
+		bool WritePartitionedScene();
+		bool WriteDelta();
+		void SetStage(Stage newStage, size_t total);
+
+		Jobs::JobSystem& jobSystem;
+		Jobs::JobCounter pipelineCounter;
+
+		std::string filename;
+		uint64_t journalId = 0;
+		bool deltaSave = false;
+		bool compressAssets = true;
+		bool packVertices = false;
+		std::vector<uint32_t> removedIds;
+
+		float partitionCellSize = 0.0f;
+		std::optional<Scene::WorldPartition> sourcePartition;
+		std::unordered_set<Scene::CellCoord, Scene::CellCoordHash> residentCells;
+
+		std::vector<Scene::EntityData> entities;
+		std::vector<AppearanceResources> appearanceResources;
+
+		std::vector<BufferReadback> buffers;
+		std::vector<TextureReadback> textures;
+		std::unordered_map<ID3D11Resource*, int> resourceIndices;
+
+		// Readbacks are numbered buffers first, then textures
+		size_t nextReadback = 0;
+		std::vector<size_t> readbacksInFlight;
+
+		std::atomic<Stage> stage{ Stage::Idle };
+		std::atomic<size_t> stageCompleted{ 0 };
+		std::atomic<size_t> stageTotal{ 0 };
+		std::atomic<size_t> bytesWritten{ 0 };
+	};
+}
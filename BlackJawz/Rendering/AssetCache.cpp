@@ -0,0 +1,524 @@
+#include "AssetCache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cwctype>
+
+namespace
+{
+	// COM has no weak references, an object whose only reference is the cache's own is unused
+	bool OnlyReference(IUnknown* object)
+	{
+		if (!object)
+			return true;
+
+		object->AddRef();
+		return object->Release() == 1;
+	}
+
+	uint64_t GetMipBytes(const DirectX::TexMetadata& metadata, size_t mip)
+	{
+		size_t rowPitch = 0;
+		size_t slicePitch = 0;
+		HRESULT hr = DirectX::ComputePitch(metadata.format, std::max<size_t>(metadata.width >> mip, 1),
+			std::max<size_t>(metadata.height >> mip, 1), rowPitch, slicePitch);
+		return SUCCEEDED(hr) ? slicePitch : 0;
+	}
+
+	// 0 when the file is not a DDS, the DX10 header follows the basic one when the FourCC says so
+	uint64_t ReadHeaderSize(std::ifstream& file)
+	{
+		uint8_t header[128];
+		if (!file.read(reinterpret_cast<char*>(header), sizeof(header)))
+			return 0;
+
+		uint32_t magic = 0;
+		uint32_t fourCC = 0;
+		memcpy(&magic, header, sizeof(magic));
+		memcpy(&fourCC, header + 84, sizeof(fourCC));
+		if (magic != 0x20534444) // "DDS "
+			return 0;
+
+		return fourCC == 0x30315844 ? 148 : 128; // "DX10"
+	}
+}
+
+BlackJawz::Rendering::AssetCache::AssetCache(ID3D11Device* device, Jobs::JobSystem& jobSystem) : pDevice(device), jobSystem(jobSystem)
+{
+
+}
+
+BlackJawz::Rendering::AssetCache::~AssetCache()
+{
+	// The queued jobs hold their own PendingTexture, but not the counter
+	jobSystem.Wait(loadCounter);
+}
+
+std::wstring BlackJawz::Rendering::AssetCache::GetKey(const std::wstring& path)
+{
+	std::wstring key = std::filesystem::path(path).lexically_normal().wstring();
+	for (wchar_t& c : key)
+	{
+		c = static_cast<wchar_t>(std::towlower(c));
+	}
+	return key;
+}
+
+ComPtr<ID3D11ShaderResourceView> BlackJawz::Rendering::AssetCache::GetTexture(const std::wstring& path, uint32_t placeholderColour)
+{
+	std::wstring key = GetKey(path);
+
+	auto it = textures.find(key);
+	if (it != textures.end())
+	{
+		++stats.hits;
+		return it->second.view;
+	}
+
+	++stats.misses;
+
+	TextureEntry entry;
+	entry.view = CreatePlaceholder(placeholderColour);
+	if (!entry.view)
+		return nullptr;
+
+	entry.path = path;
+
+	auto inserted = textures.emplace(std::move(key), std::move(entry)).first;
+	viewEntries.emplace(inserted->second.view.Get(), &inserted->second);
+	QueueLoad(inserted->first, inserted->second, 0);
+
+	stats.textureCount = textures.size();
+	stats.pendingTextures = pendingTextures.size();
+	return inserted->second.view;
+}
+
+void BlackJawz::Rendering::AssetCache::RequestTexture(ID3D11ShaderResourceView* view, float screenPixels)
+{
+	auto it = viewEntries.find(view);
+	if (it != viewEntries.end())
+	{
+		it->second->screenPixels = std::max(it->second->screenPixels, screenPixels);
+	}
+}
+
+uint64_t BlackJawz::Rendering::AssetCache::MipLayout::GetBytes(uint32_t topMip) const
+{
+	uint64_t bytes = 0;
+	for (size_t mip = topMip; mip < metadata.mipLevels; ++mip)
+	{
+		bytes += GetMipBytes(metadata, mip);
+	}
+	return bytes;
+}
+
+void BlackJawz::Rendering::AssetCache::LoadTexture(PendingTexture& pending, bool readLayout)
+{
+	MipLayout& layout = pending.layout;
+	const DirectX::TexMetadata& metadata = layout.metadata;
+
+	if (readLayout)
+	{
+		HRESULT hr = DirectX::GetMetadataFromDDSFile(pending.path.c_str(), DirectX::DDS_FLAGS_NONE, layout.metadata);
+		if (FAILED(hr))
+		{
+			pending.result = hr;
+			return;
+		}
+
+		if (metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE2D && metadata.arraySize == 1 && !metadata.IsCubemap() &&
+			metadata.mipLevels > 1)
+		{
+			// Formats the loader converts are not stored as they are created, those load whole
+			std::ifstream file(pending.path, std::ios::binary);
+			layout.dataOffset = ReadHeaderSize(file);
+
+			std::error_code error;
+			uintmax_t fileSize = std::filesystem::file_size(pending.path, error);
+			layout.streamable = layout.dataOffset != 0 && !error && layout.dataOffset + layout.GetBytes(0) == fileSize;
+		}
+
+		while (layout.tailMip + 1 < metadata.mipLevels && (std::max(metadata.width, metadata.height) >> layout.tailMip) > MipTailSize)
+		{
+			++layout.tailMip;
+		}
+		pending.topMip = layout.streamable ? layout.tailMip : 0;
+	}
+
+	if (!layout.streamable)
+	{
+		pending.result = DirectX::LoadFromDDSFile(pending.path.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, pending.image);
+		return;
+	}
+
+	HRESULT hr = pending.image.Initialize2D(metadata.format, std::max<size_t>(metadata.width >> pending.topMip, 1),
+		std::max<size_t>(metadata.height >> pending.topMip, 1), 1, metadata.mipLevels - pending.topMip);
+	if (FAILED(hr))
+	{
+		pending.result = hr;
+		return;
+	}
+
+	// Levels are stored finest first, so the top level and every coarser one are a single read
+	std::ifstream file(pending.path, std::ios::binary);
+	file.seekg(static_cast<std::streamoff>(layout.dataOffset + layout.GetBytes(0) - layout.GetBytes(pending.topMip)));
+	if (!file.read(reinterpret_cast<char*>(pending.image.GetPixels()), static_cast<std::streamsize>(pending.image.GetPixelsSize())))
+	{
+		pending.result = HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+		return;
+	}
+
+	pending.result = S_OK;
+}
+
+void BlackJawz::Rendering::AssetCache::QueueLoad(const std::wstring& key, TextureEntry& entry, uint32_t topMip)
+{
+	// Reading and parsing the file is most of the cost, neither needs the device
+	bool readLayout = entry.bytes == 0;
+	entry.pending = std::make_shared<PendingTexture>();
+	entry.pending->path = entry.path;
+	entry.pending->layout = entry.layout;
+	entry.pending->topMip = topMip;
+
+	jobSystem.Execute(loadCounter, [pending = entry.pending, readLayout]()
+		{
+			LoadTexture(*pending, readLayout);
+			pending->done.store(true, std::memory_order_release);
+		});
+
+	pendingTextures.emplace_back(key, entry.pending);
+}
+
+void BlackJawz::Rendering::AssetCache::SetView(TextureEntry& entry, ComPtr<ID3D11ShaderResourceView> view)
+{
+	viewEntries.erase(entry.view.Get());
+	entry.view = std::move(view);
+	if (entry.view)
+	{
+		viewEntries.emplace(entry.view.Get(), &entry);
+	}
+}
+
+ComPtr<ID3D11ShaderResourceView> BlackJawz::Rendering::AssetCache::CreatePlaceholder(uint32_t colour)
+{
+	// Each entry gets its own texture, the placeholder's address is what identifies it in the components
+	D3D11_TEXTURE2D_DESC textureDesc = {};
+	textureDesc.Width = 1;
+	textureDesc.Height = 1;
+	textureDesc.MipLevels = 1;
+	textureDesc.ArraySize = 1;
+	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.Usage = D3D11_USAGE_IMMUTABLE;
+	textureDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = &colour;
+	initData.SysMemPitch = sizeof(colour);
+
+	ComPtr<ID3D11Texture2D> texture;
+	HRESULT hr = pDevice->CreateTexture2D(&textureDesc, &initData, texture.GetAddressOf());
+	if (FAILED(hr))
+	{
+		char errorMsg[256];
+		snprintf(errorMsg, sizeof(errorMsg), "Failed to create placeholder texture! HRESULT: 0x%08X\n", hr);
+		OutputDebugStringA(errorMsg);
+		return nullptr;
+	}
+
+	ComPtr<ID3D11ShaderResourceView> view;
+	hr = pDevice->CreateShaderResourceView(texture.Get(), nullptr, view.GetAddressOf());
+	if (FAILED(hr))
+	{
+		char errorMsg[256];
+		snprintf(errorMsg, sizeof(errorMsg), "Failed to create placeholder view! HRESULT: 0x%08X\n", hr);
+		OutputDebugStringA(errorMsg);
+		return nullptr;
+	}
+
+	return view;
+}
+
+void BlackJawz::Rendering::AssetCache::CreateLoaded(uint64_t byteBudget)
+{
+	uint64_t createdBytes = 0;
+	size_t kept = 0;
+	for (size_t i = 0; i < pendingTextures.size(); ++i)
+	{
+		auto& [key, pending] = pendingTextures[i];
+
+		// Loads finish out of order, later ones are still created once an earlier one is ready
+		bool overBudget = createdBytes >= byteBudget && createdBytes > 0;
+		if (overBudget || !pending->done.load(std::memory_order_acquire))
+		{
+			if (kept != i)
+			{
+				pendingTextures[kept] = std::move(pendingTextures[i]);
+			}
+			++kept;
+			continue;
+		}
+
+		// Trim may have dropped the entry, or a newer lookup replaced it after a failure
+		auto it = textures.find(key);
+		if (it == textures.end() || it->second.pending != pending)
+			continue;
+
+		TextureEntry& entry = it->second;
+		bool firstLoad = entry.bytes == 0;
+		entry.pending.reset();
+
+		ComPtr<ID3D11ShaderResourceView> view;
+		HRESULT hr = pending->result;
+		if (SUCCEEDED(hr))
+		{
+			hr = DirectX::CreateShaderResourceView(pDevice.Get(), pending->image.GetImages(), pending->image.GetImageCount(),
+				pending->image.GetMetadata(), view.GetAddressOf());
+		}
+
+		if (FAILED(hr))
+		{
+			char errorMsg[512];
+			snprintf(errorMsg, sizeof(errorMsg), "Failed to load texture %ls! HRESULT: 0x%08X\n", pending->path.c_str(), hr);
+			OutputDebugStringA(errorMsg);
+
+			if (firstLoad)
+			{
+				swaps.push_back({ entry.view, nullptr });
+				viewEntries.erase(entry.view.Get());
+				textures.erase(it);
+			}
+			else
+			{
+				// The file changed under the resident levels, they stay as they are
+				entry.layout.streamable = false;
+				entry.fullBytes = entry.bytes;
+			}
+			continue;
+		}
+
+		uint64_t bytes = pending->image.GetPixelsSize();
+		if (firstLoad)
+		{
+			entry.layout = pending->layout;
+			entry.fullBytes = entry.layout.streamable ? entry.layout.GetBytes(0) : bytes;
+			stats.fullTextureBytes += entry.fullBytes;
+		}
+
+		createdBytes += bytes;
+		stats.textureBytes = stats.textureBytes + bytes - entry.bytes;
+		entry.bytes = bytes;
+		entry.topMip = pending->topMip;
+
+		// A view replaced earlier in the batch is not in any component yet, the earlier swap skips it
+		for (TextureSwap& swap : swaps)
+		{
+			if (swap.view == entry.view)
+			{
+				swap.view = view;
+			}
+		}
+		swaps.push_back({ entry.view, view });
+		SetView(entry, std::move(view));
+	}
+	pendingTextures.resize(kept);
+}
+
+void BlackJawz::Rendering::AssetCache::StreamMips()
+{
+	std::vector<std::pair<const std::wstring*, TextureEntry*>> streamed;
+	uint64_t residentBytes = 0;
+
+	// Tails always stay, as do textures that cannot stream
+	for (auto& [key, entry] : textures)
+	{
+		if (entry.bytes == 0)
+			continue;
+
+		if (!entry.layout.streamable)
+		{
+			residentBytes += entry.bytes;
+			continue;
+		}
+
+		residentBytes += entry.layout.GetBytes(entry.layout.tailMip);
+		streamed.emplace_back(&key, &entry);
+	}
+
+	// The largest on screen get their levels first
+	std::sort(streamed.begin(), streamed.end(), [](const auto& a, const auto& b) { return a.second->screenPixels > b.second->screenPixels; });
+
+	for (auto& [key, entry] : streamed)
+	{
+		const MipLayout& layout = entry->layout;
+		uint64_t tailBytes = layout.GetBytes(layout.tailMip);
+
+		// The level with about one texel per pixel, UVs are taken to span the object once
+		uint32_t wantedMip = layout.tailMip;
+		if (entry->screenPixels > 0.0f)
+		{
+			float size = static_cast<float>(std::max(layout.metadata.width, layout.metadata.height));
+			float level = std::floor(std::log2(size / std::max(entry->screenPixels, 1.0f)));
+			wantedMip = static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(layout.tailMip)));
+		}
+
+		// As fine as the budget allows
+		entry->targetMip = layout.tailMip;
+		for (uint32_t mip = wantedMip; mip < layout.tailMip; ++mip)
+		{
+			if (residentBytes + layout.GetBytes(mip) - tailBytes <= memoryBudget)
+			{
+				entry->targetMip = mip;
+				break;
+			}
+		}
+		residentBytes += layout.GetBytes(entry->targetMip) - tailBytes;
+	}
+
+	// Finer levels already resident stay while there is room, so looking away and back does not reload them
+	for (auto& [key, entry] : streamed)
+	{
+		if (entry->topMip >= entry->targetMip)
+			continue;
+
+		uint64_t extraBytes = entry->layout.GetBytes(entry->topMip) - entry->layout.GetBytes(entry->targetMip);
+		if (residentBytes + extraBytes <= memoryBudget)
+		{
+			entry->targetMip = entry->topMip;
+			residentBytes += extraBytes;
+		}
+	}
+
+	// One change in flight per texture, the next is planned once it lands
+	for (auto& [key, entry] : streamed)
+	{
+		if (entry->targetMip != entry->topMip && !entry->pending)
+		{
+			QueueLoad(*key, *entry, entry->targetMip);
+			++stats.mipLoads;
+		}
+		entry->screenPixels = 0.0f;
+	}
+
+	stats.streamedTextures = streamed.size();
+}
+
+const std::vector<BlackJawz::Rendering::AssetCache::TextureSwap>& BlackJawz::Rendering::AssetCache::Update(uint64_t byteBudget)
+{
+	auto start = std::chrono::steady_clock::now();
+	swaps.clear();
+
+	CreateLoaded(byteBudget);
+	if (!swaps.empty())
+	{
+		stats.lastUpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	StreamMips();
+
+	stats.textureCount = textures.size();
+	stats.pendingTextures = pendingTextures.size();
+	return swaps;
+}
+
+const std::vector<BlackJawz::Rendering::AssetCache::TextureSwap>& BlackJawz::Rendering::AssetCache::Flush()
+{
+	swaps.clear();
+	jobSystem.Wait(loadCounter);
+	CreateLoaded(UINT64_MAX);
+
+	// Saves read the textures back, levels dropped to fit the budget would be lost
+	for (auto& [key, entry] : textures)
+	{
+		if (entry.layout.streamable && entry.topMip != 0)
+		{
+			QueueLoad(key, entry, 0);
+			++stats.mipLoads;
+		}
+	}
+	jobSystem.Wait(loadCounter);
+	CreateLoaded(UINT64_MAX);
+
+	stats.textureCount = textures.size();
+	stats.pendingTextures = pendingTextures.size();
+	return swaps;
+}
+
+bool BlackJawz::Rendering::AssetCache::GetMesh(const std::wstring& path, const MeshLoader& loader, Component::Geometry& geometry)
+{
+	std::wstring key = GetKey(path);
+
+	auto it = meshes.find(key);
+	if (it != meshes.end())
+	{
+		++stats.hits;
+		geometry = it->second;
+		return true;
+	}
+
+	++stats.misses;
+
+	Component::Geometry loaded = {};
+	if (!loader(loaded))
+		return false;
+
+	geometry = loaded;
+	meshes.emplace(std::move(key), std::move(loaded));
+	stats.meshCount = meshes.size();
+	return true;
+}
+
+size_t BlackJawz::Rendering::AssetCache::Trim()
+{
+	size_t evicted = 0;
+
+	for (auto it = textures.begin(); it != textures.end();)
+	{
+		if (OnlyReference(it->second.view.Get()))
+		{
+			stats.textureBytes -= it->second.bytes;
+			stats.fullTextureBytes -= it->second.fullBytes;
+			viewEntries.erase(it->second.view.Get());
+			it = textures.erase(it);
+			++evicted;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	for (auto it = meshes.begin(); it != meshes.end();)
+	{
+		if (OnlyReference(it->second.pVertexBuffer.Get()) && OnlyReference(it->second.pIndexBuffer.Get()))
+		{
+			it = meshes.erase(it);
+			++evicted;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	stats.textureCount = textures.size();
+	stats.meshCount = meshes.size();
+	stats.evictions += evicted;
+	return evicted;
+}
+
+void BlackJawz::Rendering::AssetCache::Clear()
+{
+	textures.clear();
+	viewEntries.clear();
+	pendingTextures.clear();
+	swaps.clear();
+	meshes.clear();
+	stats.textureCount = 0;
+	stats.meshCount = 0;
+	stats.pendingTextures = 0;
+	stats.textureBytes = 0;
+	stats.fullTextureBytes = 0;
+	stats.streamedTextures = 0;
+}
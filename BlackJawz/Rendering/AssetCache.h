@@ -0,0 +1,157 @@
+#pragma once
+#include "../pch.h"
+#include "../ECS/Components.h"
+#include "../Util/JobSystem.h"
+
+#include <functional>
+
+namespace BlackJawz::Rendering
+{
+	// Shares textures and meshes between the entities made from the same file. Each path is loaded once
+	// and every lookup hands out the same resource. Components keep what they use alive through their
+	// ComPtrs, and Trim releases the entries no component holds any more.
+	//
+	// Textures stream in: the first lookup of a path returns a 1x1 placeholder straight away and the file
+	// is read and parsed on the job system. Update creates the finished textures on the UI thread, a few
+	// per frame, and reports each view it replaced with the view that replaces it.
+	//
+	// Mipmapped 2D textures stream by mip level as well. Only the mip tail is loaded at first, finer
+	// levels follow the screen sizes passed to RequestTexture, and levels no entity needs are dropped
+	// again to keep the textures within the memory budget.
+	class AssetCache
+	{
+	public:
+		struct Stats
+		{
+			size_t textureCount = 0;
+			size_t meshCount = 0;
+			size_t pendingTextures = 0; // Loads in flight, first loads are still bound to their placeholder
+			size_t streamedTextures = 0; // Textures resident at some of their mip levels
+			uint64_t textureBytes = 0; // Pixel data of the resident mip levels, close to what they take on the GPU
+			uint64_t fullTextureBytes = 0; // The same textures with every mip level resident
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+			uint64_t evictions = 0;
+			uint64_t mipLoads = 0; // Mip level changes, finer or coarser
+			double lastUpdateMs = 0.0; // Time the last Update spent creating textures
+		};
+
+		// Placeholder colours, RGBA8 with red in the low byte
+		static constexpr uint32_t PlaceholderGrey = 0xFF808080;
+		static constexpr uint32_t PlaceholderBlack = 0xFF000000;
+		static constexpr uint32_t PlaceholderWhite = 0xFFFFFFFF;
+		static constexpr uint32_t PlaceholderFlatNormal = 0xFFFF8080;
+
+		// Texture bytes Update creates in one frame, at least one texture is always created
+		static constexpr uint64_t DefaultUploadBudget = 16ull * 1024 * 1024;
+		static constexpr uint64_t DefaultMemoryBudget = 256ull * 1024 * 1024;
+
+		// Mip levels this size and smaller are always resident
+		static constexpr uint32_t MipTailSize = 64;
+
+		struct TextureSwap
+		{
+			ComPtr<ID3D11ShaderResourceView> placeholder; // The view being replaced
+			ComPtr<ID3D11ShaderResourceView> view; // Null when the file failed to load
+		};
+
+		// The job system has to outlive the cache, the destructor waits for the loads it queued
+		AssetCache(ID3D11Device* device, Jobs::JobSystem& jobSystem);
+		~AssetCache();
+
+		AssetCache(const AssetCache&) = delete;
+		AssetCache& operator=(const AssetCache&) = delete;
+
+		// Null when the placeholder cannot be created. Failed loads are not cached, so a fixed file
+		// loads on the next lookup.
+		ComPtr<ID3D11ShaderResourceView> GetTexture(const std::wstring& path, uint32_t placeholderColour = PlaceholderGrey);
+
+		// The loader builds the mesh the first time its path is asked for
+		using MeshLoader = std::function<bool(Component::Geometry& geometry)>;
+		bool GetMesh(const std::wstring& path, const MeshLoader& loader, Component::Geometry& geometry);
+
+		// Reports a visible use of a texture covering screenPixels across. Views the cache did not hand
+		// out are ignored. The largest request of each texture since the last Update sets its priority.
+		void RequestTexture(ID3D11ShaderResourceView* view, float screenPixels);
+
+		// Budget for the resident mip levels. Textures that cannot stream count in full, so it can be exceeded.
+		void SetMemoryBudget(uint64_t bytes) { memoryBudget = bytes; }
+		uint64_t GetMemoryBudget() const { return memoryBudget; }
+
+		// Creates loaded textures until the upload budget is spent, then queues the mip level changes
+		// the last requests call for. The swaps stay valid until the next call.
+		const std::vector<TextureSwap>& Update(uint64_t byteBudget = DefaultUploadBudget);
+
+		// Waits for every queued load and brings every texture to full resolution, a save must capture
+		// neither placeholders nor levels dropped to fit the budget. Update drops them again afterwards.
+		const std::vector<TextureSwap>& Flush();
+
+		// Releases the assets only the cache still references, returns how many
+		size_t Trim();
+		void Clear();
+
+		const Stats& GetStats() const { return stats; }
+
+	private:
+		// Windows paths are case insensitive, "Textures\\bricks_AO.dds" is bricks_ao.dds
+		static std::wstring GetKey(const std::wstring& path);
+
+		ComPtr<ID3D11ShaderResourceView> CreatePlaceholder(uint32_t colour);
+
+		// Where the mip levels of a DDS file are, when they can be read on their own
+		struct MipLayout
+		{
+			DirectX::TexMetadata metadata = {};
+			uint64_t dataOffset = 0; // Past the header
+			uint32_t tailMip = 0; // Finest level of the tail
+			bool streamable = false;
+
+			uint64_t GetBytes(uint32_t topMip) const; // Levels topMip and coarser
+		};
+
+		// Filled in by a worker, read by Update once done is set
+		struct PendingTexture
+		{
+			std::wstring path;
+			MipLayout layout; // Read by the first load
+			uint32_t topMip = 0; // Finest level of the image
+			DirectX::ScratchImage image;
+			HRESULT result = E_PENDING;
+			std::atomic<bool> done{ false };
+		};
+
+		static void LoadTexture(PendingTexture& pending, bool readLayout);
+
+		struct TextureEntry
+		{
+			ComPtr<ID3D11ShaderResourceView> view; // The placeholder until the texture is created
+			std::wstring path;
+			uint64_t bytes = 0; // 0 until the first load lands
+			uint64_t fullBytes = 0;
+			std::shared_ptr<PendingTexture> pending; // A load in flight
+
+			MipLayout layout;
+			uint32_t topMip = 0;
+			uint32_t targetMip = 0;
+			float screenPixels = 0.0f; // Largest request since the last Update
+		};
+
+		void QueueLoad(const std::wstring& key, TextureEntry& entry, uint32_t topMip);
+		void SetView(TextureEntry& entry, ComPtr<ID3D11ShaderResourceView> view);
+		void CreateLoaded(uint64_t byteBudget);
+		void StreamMips();
+
+		ComPtr<ID3D11Device> pDevice;
+		Jobs::JobSystem& jobSystem;
+		Jobs::JobCounter loadCounter;
+
+		std::unordered_map<std::wstring, TextureEntry> textures;
+		std::unordered_map<ID3D11ShaderResourceView*, TextureEntry*> viewEntries; // Map nodes do not move
+		std::vector<std::pair<std::wstring, std::shared_ptr<PendingTexture>>> pendingTextures; // In request order
+		std::vector<TextureSwap> swaps;
+		uint64_t memoryBudget = DefaultMemoryBudget;
+
+		std::unordered_map<std::wstring, Component::Geometry> meshes;
+		Stats stats;
+	};
+}
@@ -0,0 +1,92 @@
+#include "D3D11ResourceBackend.h"
+
+BlackJawz::Rendering::D3D11ResourceBackend::D3D11ResourceBackend(ID3D11Device* device) : pDevice(device)
+{
+
+}
+
+void BlackJawz::Rendering::D3D11ResourceBackend::Reserve(size_t bufferSlots, size_t textureSlots)
+{
+	buffers.clear();
+	textures.clear();
+	buffers.resize(bufferSlots);
+	textures.resize(textureSlots);
+}
+
+bool BlackJawz::Rendering::D3D11ResourceBackend::Prepare(Scene::UploadRequest& request)
+{
+	if (request.kind != Scene::ResourceKind::Texture)
+		return true;
+
+	// Parse the DDS on the worker so the loader thread only has to create the texture
+	auto image = std::make_shared<DirectX::ScratchImage>();
+	HRESULT hr = DirectX::LoadFromDDSMemory(request.data.data, request.data.size, DirectX::DDS_FLAGS_NONE, nullptr, *image);
+	if (FAILED(hr))
+	{
+		char errorMsg[256];
+		snprintf(errorMsg, sizeof(errorMsg), "LoadFromDDSMemory failed! HRESULT: 0x%08X\n", hr);
+		OutputDebugStringA(errorMsg);
+		return false;
+	}
+
+	request.prepared = std::move(image);
+	return true;
+}
+
+bool BlackJawz::Rendering::D3D11ResourceBackend::Create(Scene::UploadRequest& request)
+{
+	if (request.kind == Scene::ResourceKind::Buffer)
+	{
+		D3D11_BUFFER_DESC bufferDesc = {};
+		bufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		bufferDesc.ByteWidth = static_cast<UINT>(request.data.size);
+		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER | D3D11_BIND_INDEX_BUFFER;
+		bufferDesc.CPUAccessFlags = 0;
+
+		D3D11_SUBRESOURCE_DATA initData = {};
+		initData.pSysMem = request.data.data;
+
+		HRESULT hr = pDevice->CreateBuffer(&bufferDesc, &initData, buffers[request.slot].ReleaseAndGetAddressOf());
+		return SUCCEEDED(hr);
+	}
+
+	auto image = std::static_pointer_cast<DirectX::ScratchImage>(request.prepared);
+	if (!image)
+		return false;
+
+	HRESULT hr = DirectX::CreateShaderResourceView(pDevice.Get(), image->GetImages(), image->GetImageCount(),
+		image->GetMetadata(), textures[request.slot].ReleaseAndGetAddressOf());
+	if (FAILED(hr))
+	{
+		char errorMsg[256];
+		snprintf(errorMsg, sizeof(errorMsg), "CreateShaderResourceView failed! HRESULT: 0x%08X\n", hr);
+		OutputDebugStringA(errorMsg);
+		return false;
+	}
+
+	return true;
+}
+
+ComPtr<ID3D11Buffer> BlackJawz::Rendering::D3D11ResourceBackend::GetBuffer(int32_t slot) const
+{
+	if (slot < 0 || static_cast<size_t>(slot) >= buffers.size())
+		return nullptr;
+
+	return buffers[slot];
+}
+
+ComPtr<ID3D11ShaderResourceView> BlackJawz::Rendering::D3D11ResourceBackend::GetTexture(int32_t slot) const
+{
+	if (slot < 0 || static_cast<size_t>(slot) >= textures.size())
+		return nullptr;
+
+	return textures[slot];
+}
+
+void BlackJawz::Rendering::D3D11ResourceBackend::Clear()
+{
+	buffers.clear();
+	buffers.shrink_to_fit();
+	textures.clear();
+	textures.shrink_to_fit();
+}
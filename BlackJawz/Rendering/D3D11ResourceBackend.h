@@ -0,0 +1,29 @@
+#pragma once
+#include "../pch.h"
+#include "../Scene/UploadQueue.h"
+
+namespace BlackJawz::Rendering
+{
+	// Creates scene buffers and textures on the device from the loader thread, D3D11 devices are free-threaded
+	class D3D11ResourceBackend : public Scene::ResourceBackend
+	{
+	public:
+		explicit D3D11ResourceBackend(ID3D11Device* device);
+
+		void Reserve(size_t bufferSlots, size_t textureSlots) override;
+		bool Prepare(Scene::UploadRequest& request) override;
+		bool Create(Scene::UploadRequest& request) override;
+
+		ComPtr<ID3D11Buffer> GetBuffer(int32_t slot) const;
+		ComPtr<ID3D11ShaderResourceView> GetTexture(int32_t slot) const;
+
+		// Drop the references from the last load once they are owned by the components
+		void Clear();
+
+	private:
+		ComPtr<ID3D11Device> pDevice;
+
+		std::vector<ComPtr<ID3D11Buffer>> buffers;
+		std::vector<ComPtr<ID3D11ShaderResourceView>> textures;
+	};
+}
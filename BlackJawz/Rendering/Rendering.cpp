@@ -1,5 +1,29 @@
 #include "Rendering.h"
 
+#include <algorithm>
+
+namespace
+{
+	// Local bounds for the built in and imported meshes, so they can be culled and picked
+	void SetBounds(BlackJawz::Component::Geometry& geometry, const std::vector<Vertex>& vertices)
+	{
+		if (vertices.empty())
+			return;
+
+		geometry.hasBounds = true;
+		geometry.boundsMin = geometry.boundsMax = vertices[0].Position;
+		for (const Vertex& vertex : vertices)
+		{
+			geometry.boundsMin.x = std::min(geometry.boundsMin.x, vertex.Position.x);
+			geometry.boundsMin.y = std::min(geometry.boundsMin.y, vertex.Position.y);
+			geometry.boundsMin.z = std::min(geometry.boundsMin.z, vertex.Position.z);
+			geometry.boundsMax.x = std::max(geometry.boundsMax.x, vertex.Position.x);
+			geometry.boundsMax.y = std::max(geometry.boundsMax.y, vertex.Position.y);
+			geometry.boundsMax.z = std::max(geometry.boundsMax.z, vertex.Position.z);
+		}
+	}
+}
+
 BlackJawz::Rendering::Render::Render()
 {
 	_driverType = D3D_DRIVER_TYPE_NULL;
@@ -764,6 +788,53 @@ HRESULT BlackJawz::Rendering::Render::InitGBufferShadersAndInputLayout()
 		return hr;
 	}
 
+	// Permutation for cooked materials with packed channels
+	Microsoft::WRL::ComPtr<ID3DBlob> packedPsBlob;
+	hr = CompileShaderFromFile(L"../BlackJawz/Rendering/Shaders/GBufferPixelShader.hlsl", "PSPacked", "ps_5_0", &packedPsBlob);
+	if (FAILED(hr))
+	{
+		OutputDebugString(L"Failed to compile pixel shader PSPacked.\n");
+		return hr;
+	}
+
+	hr = pID3D11Device.Get()->CreatePixelShader(packedPsBlob->GetBufferPointer(), packedPsBlob->GetBufferSize(), nullptr, pGBufferPackedPixelShader.GetAddressOf());
+	if (FAILED(hr))
+	{
+		OutputDebugString(L"Failed to create pixel shader PSPacked.\n");
+		return hr;
+	}
+
+	// Permutations for cooked materials with cone step maps, with and without packed channels
+	Microsoft::WRL::ComPtr<ID3DBlob> conePsBlob;
+	hr = CompileShaderFromFile(L"../BlackJawz/Rendering/Shaders/GBufferPixelShader.hlsl", "PSConeStep", "ps_5_0", &conePsBlob);
+	if (FAILED(hr))
+	{
+		OutputDebugString(L"Failed to compile pixel shader PSConeStep.\n");
+		return hr;
+	}
+
+	hr = pID3D11Device.Get()->CreatePixelShader(conePsBlob->GetBufferPointer(), conePsBlob->GetBufferSize(), nullptr, pGBufferConeStepPixelShader.GetAddressOf());
+	if (FAILED(hr))
+	{
+		OutputDebugString(L"Failed to create pixel shader PSConeStep.\n");
+		return hr;
+	}
+
+	Microsoft::WRL::ComPtr<ID3DBlob> packedConePsBlob;
+	hr = CompileShaderFromFile(L"../BlackJawz/Rendering/Shaders/GBufferPixelShader.hlsl", "PSPackedConeStep", "ps_5_0", &packedConePsBlob);
+	if (FAILED(hr))
+	{
+		OutputDebugString(L"Failed to compile pixel shader PSPackedConeStep.\n");
+		return hr;
+	}
+
+	hr = pID3D11Device.Get()->CreatePixelShader(packedConePsBlob->GetBufferPointer(), packedConePsBlob->GetBufferSize(), nullptr, pGBufferPackedConeStepPixelShader.GetAddressOf());
+	if (FAILED(hr))
+	{
+		OutputDebugString(L"Failed to create pixel shader PSPackedConeStep.\n");
+		return hr;
+	}
+
 	// Define the input layout
 	D3D11_INPUT_ELEMENT_DESC layoutDesc[] =
 	{
@@ -781,6 +852,75 @@ HRESULT BlackJawz::Rendering::Render::InitGBufferShadersAndInputLayout()
 		return hr;
 	}
 
+	// Packed vertices, same outputs from a 20 byte vertex. Matches Scene::PackedVertex.
+	D3D11_INPUT_ELEMENT_DESC packedLayoutDesc[] =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TANGENT", 0, DXGI_FORMAT_R16G16_SNORM, 0, 12, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0 },
+	};
+
+	hr = CreateGBufferVertexShader("VSPacked", packedLayoutDesc, ARRAYSIZE(packedLayoutDesc),
+		pGBufferPackedVertexShader.GetAddressOf(), pGBufferPackedInputLayout.GetAddressOf());
+	if (FAILED(hr))
+		return hr;
+
+	// Instanced variants read one world matrix per instance from a second vertex buffer
+	D3D11_INPUT_ELEMENT_DESC instanceElements[] =
+	{
+		{ "INSTANCEWORLD", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCEWORLD", 1, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCEWORLD", 2, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 32, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+		{ "INSTANCEWORLD", 3, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 48, D3D11_INPUT_PER_INSTANCE_DATA, 1 },
+	};
+
+	D3D11_INPUT_ELEMENT_DESC instancedLayoutDesc[ARRAYSIZE(layoutDesc) + ARRAYSIZE(instanceElements)];
+	std::copy(std::begin(layoutDesc), std::end(layoutDesc), instancedLayoutDesc);
+	std::copy(std::begin(instanceElements), std::end(instanceElements), instancedLayoutDesc + ARRAYSIZE(layoutDesc));
+
+	hr = CreateGBufferVertexShader("VSInstanced", instancedLayoutDesc, ARRAYSIZE(instancedLayoutDesc),
+		pGBufferInstancedVertexShader.GetAddressOf(), pGBufferInstancedInputLayout.GetAddressOf());
+	if (FAILED(hr))
+		return hr;
+
+	D3D11_INPUT_ELEMENT_DESC packedInstancedLayoutDesc[ARRAYSIZE(packedLayoutDesc) + ARRAYSIZE(instanceElements)];
+	std::copy(std::begin(packedLayoutDesc), std::end(packedLayoutDesc), packedInstancedLayoutDesc);
+	std::copy(std::begin(instanceElements), std::end(instanceElements), packedInstancedLayoutDesc + ARRAYSIZE(packedLayoutDesc));
+
+	hr = CreateGBufferVertexShader("VSPackedInstanced", packedInstancedLayoutDesc, ARRAYSIZE(packedInstancedLayoutDesc),
+		pGBufferPackedInstancedVertexShader.GetAddressOf(), pGBufferPackedInstancedInputLayout.GetAddressOf());
+	if (FAILED(hr))
+		return hr;
+
+	return hr;
+}
+
+HRESULT BlackJawz::Rendering::Render::CreateGBufferVertexShader(const char* entryPoint, const D3D11_INPUT_ELEMENT_DESC* layoutDesc,
+	UINT elementCount, ID3D11VertexShader** vertexShader, ID3D11InputLayout** inputLayout)
+{
+	Microsoft::WRL::ComPtr<ID3DBlob> vsBlob;
+	HRESULT hr = CompileShaderFromFile(L"../BlackJawz/Rendering/Shaders/GBufferVertexShader.hlsl", entryPoint, "vs_5_0", &vsBlob);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA((std::string("Failed to compile vertex shader ") + entryPoint + ".\n").c_str());
+		return hr;
+	}
+
+	hr = pID3D11Device.Get()->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, vertexShader);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA((std::string("Failed to create vertex shader ") + entryPoint + ".\n").c_str());
+		return hr;
+	}
+
+	hr = pID3D11Device.Get()->CreateInputLayout(layoutDesc, elementCount, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), inputLayout);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA((std::string("Failed to create input layout for ") + entryPoint + ".\n").c_str());
+		return hr;
+	}
+
 	return hr;
 }
 
@@ -1299,6 +1439,21 @@ HRESULT BlackJawz::Rendering::Render::InitConstantBuffer()
 		return hr;
 	}
 
+	D3D11_BUFFER_DESC bufferDescPacked = {};
+	bufferDescPacked.Usage = D3D11_USAGE_DEFAULT;
+	bufferDescPacked.ByteWidth = sizeof(PackedVertexBuffer);
+	bufferDescPacked.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	bufferDescPacked.CPUAccessFlags = 0;
+	bufferDescPacked.MiscFlags = 0;
+	bufferDescPacked.StructureByteStride = 0;
+
+	hr = pID3D11Device.Get()->CreateBuffer(&bufferDescPacked, nullptr, pPackedVertexBuffer.GetAddressOf());
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to create constant buffer.\n");
+		return hr;
+	}
+
 	return hr;
 }
 
@@ -1907,6 +2062,9 @@ BlackJawz::Component::Geometry BlackJawz::Rendering::Render::CreateCubeGeometry(
 	cubeGeometry.IndicesCount = 36;
 	cubeGeometry.vertexBufferOffset = 0;
 	cubeGeometry.vertexBufferStride = sizeof(Vertex);
+	cubeGeometry.hasBounds = true;
+	cubeGeometry.boundsMin = XMFLOAT3(-1.0f, -1.0f, -1.0f);
+	cubeGeometry.boundsMax = XMFLOAT3(1.0f, 1.0f, 1.0f);
 	return cubeGeometry;
 }
 
@@ -1918,6 +2076,7 @@ BlackJawz::Component::Geometry BlackJawz::Rendering::Render::CreateSphereGeometr
 	sphereGeometry.IndicesCount = sphereIndices.size();
 	sphereGeometry.vertexBufferOffset = 0;
 	sphereGeometry.vertexBufferStride = sizeof(Vertex);
+	SetBounds(sphereGeometry, sphereVertices);
 	return sphereGeometry;
 }
 
@@ -1929,9 +2088,44 @@ BlackJawz::Component::Geometry BlackJawz::Rendering::Render::CreatePlaneGeometry
 	planeGeometry.IndicesCount = gridIndices.size();
 	planeGeometry.vertexBufferOffset = 0;
 	planeGeometry.vertexBufferStride = sizeof(Vertex);
+	SetBounds(planeGeometry, gridVertices);
 	return planeGeometry;
 }
 
+bool BlackJawz::Rendering::Render::CreateMeshGeometry(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+	BlackJawz::Component::Geometry& geometry)
+{
+	if (vertices.empty() || indices.empty())
+		return false;
+
+	D3D11_BUFFER_DESC bd = {};
+	bd.Usage = D3D11_USAGE_DEFAULT;
+	bd.ByteWidth = static_cast<UINT>(sizeof(Vertex) * vertices.size());
+	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bd.CPUAccessFlags = 0;
+
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = vertices.data();
+	ComPtr<ID3D11Buffer> vertexBuffer;
+	if (FAILED(pID3D11Device->CreateBuffer(&bd, &initData, vertexBuffer.GetAddressOf())))
+		return false;
+
+	bd.ByteWidth = static_cast<UINT>(sizeof(uint32_t) * indices.size());
+	bd.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	initData.pSysMem = indices.data();
+	ComPtr<ID3D11Buffer> indexBuffer;
+	if (FAILED(pID3D11Device->CreateBuffer(&bd, &initData, indexBuffer.GetAddressOf())))
+		return false;
+
+	geometry.pVertexBuffer = vertexBuffer;
+	geometry.pIndexBuffer = indexBuffer;
+	geometry.IndicesCount = static_cast<UINT>(indices.size());
+	geometry.vertexBufferOffset = 0;
+	geometry.vertexBufferStride = sizeof(Vertex);
+	SetBounds(geometry, vertices);
+	return true;
+}
+
 void BlackJawz::Rendering::Render::RenderToTexture(BlackJawz::System::TransformSystem& transformSystem,
 	BlackJawz::System::AppearanceSystem& appearanceSystem, BlackJawz::System::LightSystem& lightSystem)
 {
@@ -1991,8 +2185,8 @@ void BlackJawz::Rendering::Render::EndGBufferPass()
 	pImmediateContext.Get()->OMSetRenderTargets(4, nullRTV, nullptr);
 
 	// Unbind shader resource views
-	ID3D11ShaderResourceView* nullSRVs[6] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
-	pImmediateContext.Get()->PSSetShaderResources(0, 6, nullSRVs);
+	ID3D11ShaderResourceView* nullSRVs[8] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+	pImmediateContext.Get()->PSSetShaderResources(0, 8, nullSRVs);
 }
 
 //void BlackJawz::Rendering::Render::Draw(BlackJawz::System::TransformSystem& transformSystem,
@@ -2158,6 +2352,10 @@ void BlackJawz::Rendering::Render::GBufferPass(BlackJawz::System::TransformSyste
 
 	pImmediateContext.Get()->VSSetShader(pGBufferVertexShader.Get(), nullptr, 0);
 	pImmediateContext.Get()->VSSetConstantBuffers(0, 1, pTransformBuffer.GetAddressOf());
+	pImmediateContext.Get()->VSSetConstantBuffers(1, 1, pPackedVertexBuffer.GetAddressOf());
+	bool packedBound = false;
+	bool instancedBound = false;
+	ID3D11PixelShader* pixelShaderBound = pGBufferPixelShader.Get();
 
 	pImmediateContext.Get()->PSSetShader(pGBufferPixelShader.Get(), nullptr, 0);
 	pImmediateContext.Get()->PSSetConstantBuffers(0, 1, pLightsBuffer.GetAddressOf());
@@ -2167,6 +2365,10 @@ void BlackJawz::Rendering::Render::GBufferPass(BlackJawz::System::TransformSyste
 	// Iterate over entities in the Appearance System (Geometry Pass)
 	for (auto entity : appearanceSystem.GetEntities())
 	{
+		// Culled by the caller, entities added since the list was made are drawn
+		if (visibleEntities && entity < visibleEntities->size() && !(*visibleEntities)[entity])
+			continue;
+
 		auto& appearance = appearanceSystem.GetAppearance(entity);
 		BlackJawz::Component::Geometry geo = appearance.GetGeometry();
 		ComPtr<ID3D11ShaderResourceView> entityTextureDiffuse = appearance.GetTextureDiffuse();
@@ -2175,6 +2377,8 @@ void BlackJawz::Rendering::Render::GBufferPass(BlackJawz::System::TransformSyste
 		ComPtr<ID3D11ShaderResourceView> entityTextureRoughness = appearance.GetTextureRoughness();
 		ComPtr<ID3D11ShaderResourceView> entityTextureAO = appearance.GetTextureAO();
 		ComPtr<ID3D11ShaderResourceView> entityTextureDisplacement = appearance.GetTextureDisplacement();
+		ComPtr<ID3D11ShaderResourceView> entityTexturePacked = appearance.GetTexturePacked();
+		ComPtr<ID3D11ShaderResourceView> entityTextureConeStep = appearance.GetTextureConeStep();
 
 		// --- Update Transform for this entity ---
 		if (transformSystem.HasComponent(entity))
@@ -2186,6 +2390,40 @@ void BlackJawz::Rendering::Render::GBufferPass(BlackJawz::System::TransformSyste
 		// Upload per-object constant buffer (transform)
 		pImmediateContext.Get()->UpdateSubresource(pTransformBuffer.Get(), 0, nullptr, &cb, 0, 0);
 
+		// Instanced appearances draw every copy in one call, an empty instance set draws nothing
+		bool instanced = appearance.HasInstances();
+		if (instanced && !UpdateInstanceBuffer(*appearance.instances))
+			continue;
+
+		// Switch shaders only when the vertex format changes, cooked scenes group entities by mesh
+		if (geo.packedVertices != packedBound || instanced != instancedBound)
+		{
+			packedBound = geo.packedVertices;
+			instancedBound = instanced;
+
+			ID3D11InputLayout* inputLayouts[2][2] =
+			{
+				{ pGBufferInputLayout.Get(), pGBufferInstancedInputLayout.Get() },
+				{ pGBufferPackedInputLayout.Get(), pGBufferPackedInstancedInputLayout.Get() }
+			};
+			ID3D11VertexShader* vertexShaders[2][2] =
+			{
+				{ pGBufferVertexShader.Get(), pGBufferInstancedVertexShader.Get() },
+				{ pGBufferPackedVertexShader.Get(), pGBufferPackedInstancedVertexShader.Get() }
+			};
+
+			pImmediateContext.Get()->IASetInputLayout(inputLayouts[packedBound][instancedBound]);
+			pImmediateContext.Get()->VSSetShader(vertexShaders[packedBound][instancedBound], nullptr, 0);
+		}
+
+		if (geo.packedVertices)
+		{
+			PackedVertexBuffer packedCb = {};
+			packedCb.PositionMin = geo.boundsMin;
+			packedCb.PositionExtent = XMFLOAT3(geo.boundsMax.x - geo.boundsMin.x, geo.boundsMax.y - geo.boundsMin.y, geo.boundsMax.z - geo.boundsMin.z);
+			pImmediateContext.Get()->UpdateSubresource(pPackedVertexBuffer.Get(), 0, nullptr, &packedCb, 0, 0);
+		}
+
 		// Bind Vertex and Index Buffers
 		pImmediateContext.Get()->IASetVertexBuffers(0, 1, geo.pVertexBuffer.GetAddressOf(), &geo.vertexBufferStride, &geo.vertexBufferOffset);
 		pImmediateContext.Get()->IASetIndexBuffer(geo.pIndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
@@ -2196,25 +2434,114 @@ void BlackJawz::Rendering::Render::GBufferPass(BlackJawz::System::TransformSyste
 		if (appearance.HasTextureNormal())
 			pImmediateContext.Get()->PSSetShaderResources(1, 1, entityTextureNormal.GetAddressOf());
 
-		if (appearance.HasTextureMetal())
-			pImmediateContext.Get()->PSSetShaderResources(2, 1, entityTextureMetal.GetAddressOf());
+		// Packed materials bind one texture in place of four and cone step maps replace the layer march,
+		// each combination has its own shader
+		bool packedTextures = appearance.HasTexturePacked();
+		bool coneStep = appearance.HasTextureConeStep();
+		ID3D11PixelShader* pixelShader = coneStep ?
+			(packedTextures ? pGBufferPackedConeStepPixelShader.Get() : pGBufferConeStepPixelShader.Get()) :
+			(packedTextures ? pGBufferPackedPixelShader.Get() : pGBufferPixelShader.Get());
+		if (pixelShader != pixelShaderBound)
+		{
+			pixelShaderBound = pixelShader;
+			pImmediateContext.Get()->PSSetShader(pixelShaderBound, nullptr, 0);
+		}
+
+		if (coneStep)
+			pImmediateContext.Get()->PSSetShaderResources(7, 1, entityTextureConeStep.GetAddressOf());
+
+		if (packedTextures)
+		{
+			pImmediateContext.Get()->PSSetShaderResources(6, 1, entityTexturePacked.GetAddressOf());
+		}
+		else
+		{
+			if (appearance.HasTextureMetal())
+				pImmediateContext.Get()->PSSetShaderResources(2, 1, entityTextureMetal.GetAddressOf());
 
-		if (appearance.HasTextureRoughness())
-			pImmediateContext.Get()->PSSetShaderResources(3, 1, entityTextureRoughness.GetAddressOf());
+			if (appearance.HasTextureRoughness())
+				pImmediateContext.Get()->PSSetShaderResources(3, 1, entityTextureRoughness.GetAddressOf());
 
-		if (appearance.HasTextureAO())
-			pImmediateContext.Get()->PSSetShaderResources(4, 1, entityTextureAO.GetAddressOf());
+			if (appearance.HasTextureAO())
+				pImmediateContext.Get()->PSSetShaderResources(4, 1, entityTextureAO.GetAddressOf());
 
-		if (appearance.HasTextureDisplacement())
-			pImmediateContext.Get()->PSSetShaderResources(5, 1, entityTextureDisplacement.GetAddressOf());
+			if (appearance.HasTextureDisplacement())
+				pImmediateContext.Get()->PSSetShaderResources(5, 1, entityTextureDisplacement.GetAddressOf());
+		}
 
 		// Draw the entity (G-Buffer pass)
-		pImmediateContext.Get()->DrawIndexed(geo.IndicesCount, 0, 0);
+		if (instanced)
+		{
+			UINT instanceStride = sizeof(XMFLOAT4X4);
+			UINT instanceOffset = 0;
+			pImmediateContext.Get()->IASetVertexBuffers(1, 1, appearance.instances->pInstanceBuffer.GetAddressOf(), &instanceStride, &instanceOffset);
+			pImmediateContext.Get()->DrawIndexedInstanced(geo.IndicesCount, static_cast<UINT>(appearance.instances->transforms.size()), 0, 0, 0);
+		}
+		else
+		{
+			pImmediateContext.Get()->DrawIndexed(geo.IndicesCount, 0, 0);
+		}
 	}
 
 	EndGBufferPass();
 }
 
+bool BlackJawz::Rendering::Render::UpdateInstanceBuffer(BlackJawz::Component::Instances& instances)
+{
+	if (instances.transforms.empty())
+		return false;
+
+	if (!instances.dirty && instances.pInstanceBuffer)
+		return true;
+
+	UINT count = static_cast<UINT>(instances.transforms.size());
+
+	// Grown with headroom so adding a few instances does not recreate the buffer every time
+	if (!instances.pInstanceBuffer || instances.bufferCapacity < count)
+	{
+		UINT capacity = std::max(count, instances.bufferCapacity + instances.bufferCapacity / 2);
+
+		D3D11_BUFFER_DESC bufferDesc = {};
+		bufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		bufferDesc.ByteWidth = capacity * sizeof(XMFLOAT4X4);
+		bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		bufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+		instances.pInstanceBuffer.Reset();
+		HRESULT hr = pID3D11Device.Get()->CreateBuffer(&bufferDesc, nullptr, instances.pInstanceBuffer.GetAddressOf());
+		if (FAILED(hr))
+		{
+			OutputDebugStringA("Failed to create instance buffer.\n");
+			instances.bufferCapacity = 0;
+			return false;
+		}
+		instances.bufferCapacity = capacity;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT hr = pImmediateContext.Get()->Map(instances.pInstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource);
+	if (FAILED(hr))
+	{
+		OutputDebugStringA("Failed to map instance buffer.\n");
+		return false;
+	}
+
+	// Same order as Component::Transform::UpdateWorldMatrix, not transposed since the rows arrive as vertex data
+	XMFLOAT4X4* matrices = static_cast<XMFLOAT4X4*>(mappedResource.pData);
+	for (UINT i = 0; i < count; ++i)
+	{
+		const BlackJawz::Component::InstanceTransform& transform = instances.transforms[i];
+		XMMATRIX world = XMMatrixScaling(transform.scale.x, transform.scale.y, transform.scale.z) *
+			XMMatrixRotationX(transform.rotation.x) * XMMatrixRotationY(transform.rotation.y) * XMMatrixRotationZ(transform.rotation.z) *
+			XMMatrixTranslation(transform.position.x, transform.position.y, transform.position.z);
+		XMStoreFloat4x4(&matrices[i], world);
+	}
+
+	pImmediateContext.Get()->Unmap(instances.pInstanceBuffer.Get(), 0);
+	instances.dirty = false;
+	return true;
+}
+
 void BlackJawz::Rendering::Render::PreComputeBRDFLUT()
 {
 	D3D11_VIEWPORT viewport = {};
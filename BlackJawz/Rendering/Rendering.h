@@ -60,6 +60,15 @@ struct TransformBuffer
 	XMMATRIX Projection;	
 };
 
+// Decodes the positions of packed vertices, see Scene/VertexPacking.h
+struct PackedVertexBuffer
+{
+	XMFLOAT3 PositionMin;
+	float Padding01;
+	XMFLOAT3 PositionExtent;
+	float Padding02;
+};
+
 struct LightsBuffer
 {
 	LightProperties lights[MAX_LIGHTS];
@@ -108,6 +117,10 @@ namespace BlackJawz::Rendering
 		void SetProjectionMatrix(XMFLOAT4X4 projMatrix) { projectionMatrix = projMatrix; }
 		void SetCameraPosition(XMFLOAT3 cameraPos) { cameraPosition = cameraPos; }
 
+		// One flag per entity id, the geometry pass skips entities whose flag is 0. Pass nullptr to
+		// draw everything, the list has to outlive the next draw.
+		void SetVisibleEntities(const std::vector<uint8_t>* visible) { visibleEntities = visible; }
+
 		ID3D11DeviceContext* GetDeviceContext() { return pImmediateContext.Get(); }
 		ID3D11Device* GetDevice() { return pID3D11Device.Get(); }
 
@@ -115,6 +128,10 @@ namespace BlackJawz::Rendering
 		BlackJawz::Component::Geometry CreateSphereGeometry();
 		BlackJawz::Component::Geometry CreatePlaneGeometry();
 
+		// Uploads an imported mesh, a 32 bit indexed triangle list. False when a buffer cannot be created.
+		bool CreateMeshGeometry(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+			BlackJawz::Component::Geometry& geometry);
+
 		void CleanUp();
 
 	private:
@@ -132,6 +149,9 @@ namespace BlackJawz::Rendering
 		HRESULT InitViewPort();
 		HRESULT InitShadersAndInputLayout();
 		HRESULT InitGBufferShadersAndInputLayout();
+		// One variant of GBufferVertexShader.hlsl with the input layout it reads
+		HRESULT CreateGBufferVertexShader(const char* entryPoint, const D3D11_INPUT_ELEMENT_DESC* layoutDesc, UINT elementCount,
+			ID3D11VertexShader** vertexShader, ID3D11InputLayout** inputLayout);
 		HRESULT InitBRDFLUTShadersAndInputLayout();
 		HRESULT InitIrradianceShadersAndInputLayout();
 		HRESULT InitRadianceShadersAndInputLayout();
@@ -157,6 +177,8 @@ namespace BlackJawz::Rendering
 		void GBufferPass(BlackJawz::System::TransformSystem& transformSystem,
 			BlackJawz::System::AppearanceSystem& appearanceSystem, BlackJawz::System::LightSystem& lightSystem);
 		void EndGBufferPass();
+		// Rebuilds the instance buffer when the instances changed, false when there is nothing to draw
+		bool UpdateInstanceBuffer(BlackJawz::Component::Instances& instances);
 		void PreComputeBRDFLUT();
 		void PreComputeRadiance();
 		void PreComputeIrradiance();
@@ -226,12 +248,15 @@ namespace BlackJawz::Rendering
 		ComPtr<ID3D11Buffer> pTransformBuffer;
 		ComPtr<ID3D11Buffer> pLightsBuffer;
 		ComPtr<ID3D11Buffer> pPostProcessingBuffer;
+		ComPtr<ID3D11Buffer> pPackedVertexBuffer;
 
 		// Camera
 		XMFLOAT4X4 viewMatrix = XMFLOAT4X4();
 		XMFLOAT4X4 projectionMatrix = XMFLOAT4X4();
 		XMFLOAT3 cameraPosition = XMFLOAT3();
 
+		const std::vector<uint8_t>* visibleEntities = nullptr;
+
 		ID3D11ShaderResourceView* textureRV;
 
 		// Deferred Rendering
@@ -242,7 +267,16 @@ namespace BlackJawz::Rendering
 		// GBuffer 
 		ComPtr<ID3D11VertexShader> pGBufferVertexShader;
 		ComPtr<ID3D11PixelShader> pGBufferPixelShader;
+		ComPtr<ID3D11PixelShader> pGBufferPackedPixelShader; // Reads metal, roughness, AO and displacement from one texture
+		ComPtr<ID3D11PixelShader> pGBufferConeStepPixelShader; // Steps the parallax ray through a cone step map
+		ComPtr<ID3D11PixelShader> pGBufferPackedConeStepPixelShader;
 		ComPtr<ID3D11InputLayout> pGBufferInputLayout;
+		ComPtr<ID3D11VertexShader> pGBufferPackedVertexShader;
+		ComPtr<ID3D11InputLayout> pGBufferPackedInputLayout;
+		ComPtr<ID3D11VertexShader> pGBufferInstancedVertexShader;
+		ComPtr<ID3D11InputLayout> pGBufferInstancedInputLayout;
+		ComPtr<ID3D11VertexShader> pGBufferPackedInstancedVertexShader;
+		ComPtr<ID3D11InputLayout> pGBufferPackedInstancedInputLayout;
 
 		// Lighting
 		ComPtr<ID3D11VertexShader> pDeferredLightingVertexShader;
@@ -14,6 +14,8 @@ Texture2D MetalTexture : register(t2);
 Texture2D RoughnessTexture : register(t3);
 Texture2D AOTexture : register(t4);
 Texture2D DisplacementTexture : register(t5);
+Texture2D PackedTexture : register(t6); // Metal (R), Roughness (G), AO (B), Displacement (A)
+Texture2D ConeStepTexture : register(t7); // Depth (R), square root of the cone ratio (G)
 
 SamplerState samLinear : register(s0);
 
@@ -61,8 +63,27 @@ struct GBufferOutput
 static const float minLayers = 8.0f;
 static const float maxLayers = 64.0f;
 static const float heightScale = 0.02f; 
+static const int coneSteps = 12;
+static const float coneStepConverged = 0.5f / 255.0f; // Half a step of an 8 bit map
 
-float2 ParallaxOcclusionMapping(float2 texCoords, float3 viewDirTangent)
+// PS reads the separate maps and PSPacked the packed texture of cooked materials, the ConeStep entry
+// points march through the cone step map. They pass literals, so each keeps only its own samples.
+float SampleHeight(float2 texCoords, bool packed)
+{
+    if (packed)
+        return PackedTexture.Sample(samLinear, texCoords).a;
+    return DisplacementTexture.Sample(samLinear, texCoords).r;
+}
+
+float3 SampleMetalRoughAO(float2 texCoords, bool packed)
+{
+    if (packed)
+        return PackedTexture.Sample(samLinear, texCoords).rgb;
+    return float3(MetalTexture.Sample(samLinear, texCoords).r, RoughnessTexture.Sample(samLinear, texCoords).r,
+        AOTexture.Sample(samLinear, texCoords).r);
+}
+
+float2 ParallaxOcclusionMapping(float2 texCoords, float3 viewDirTangent, bool packed)
 {
     float numLayers = lerp(maxLayers, minLayers, abs(dot(float3(0, 0, 1), viewDirTangent)));
     float layerDepth = 1.0 / numLayers;
@@ -71,7 +92,7 @@ float2 ParallaxOcclusionMapping(float2 texCoords, float3 viewDirTangent)
     float2 deltaTexCoords = viewDirTangent.xy * heightScale / viewDirTangent.z / numLayers;
     
     float2 currentTexCoords = texCoords;
-    float currentHeight = DisplacementTexture.Sample(samLinear, currentTexCoords).r;
+    float currentHeight = SampleHeight(currentTexCoords, packed);
     
     float2 prevTexCoords = currentTexCoords;
     float prevLayerDepth = 0.0;
@@ -88,7 +109,7 @@ float2 ParallaxOcclusionMapping(float2 texCoords, float3 viewDirTangent)
         prevLayerDepth = currentLayerDepth;
         currentTexCoords -= deltaTexCoords;
         currentLayerDepth += layerDepth;
-        currentHeight = DisplacementTexture.Sample(samLinear, currentTexCoords).r;
+        currentHeight = SampleHeight(currentTexCoords, packed);
         if (currentLayerDepth > currentHeight)
             break;
     }
@@ -101,7 +122,7 @@ float2 ParallaxOcclusionMapping(float2 texCoords, float3 viewDirTangent)
     for (int j = 0; j < numRefinementSteps; j++)
     {
         float2 midTexCoords = (refinedTexCoords + prevTexCoords) * 0.5;
-        float midHeight = DisplacementTexture.Sample(samLinear, midTexCoords).r;
+        float midHeight = SampleHeight(midTexCoords, packed);
         float midLayerDepth = (refinedLayerDepth + prevLayerDepth) * 0.5;
         if (midLayerDepth > midHeight)
         {
@@ -118,13 +139,66 @@ float2 ParallaxOcclusionMapping(float2 texCoords, float3 viewDirTangent)
     return refinedTexCoords;
 }
 
-float ParallaxSelfShadow(float2 texCoords, float3 lightDirTangent)
+// Relaxed cone stepping. Each texel of the map holds the depth and the widest cone standing on the
+// surface there that no ray crosses the surface twice inside. The ray steps to where it leaves the
+// cone under it, so it either closes in on the surface from above or lands at most one crossing past
+// it, and then the binary search between the last point above and the first below finds the crossing.
+float2 ConeStepMapping(float2 texCoords, float3 viewDirTangent)
+{
+    // Texture coordinates the ray moves across per unit of depth, the same ray the layer march takes
+    float3 rayDir = float3(-viewDirTangent.xy * heightScale / viewDirTangent.z, 1.0);
+    float rayRatio = length(rayDir.xy);
+
+    float3 position = float3(texCoords, 0.0);
+    float3 prevPosition = position;
+    bool crossed = false;
+
+    // The map has a single level, cone ratios averaged into coarser levels would no longer be conservative
+    [unroll(coneSteps)]
+    for (int i = 0; i < coneSteps; ++i)
+    {
+        float2 cone = ConeStepTexture.SampleLevel(samLinear, position.xy, 0).rg;
+        float depthBelow = cone.r - position.z;
+        crossed = depthBelow <= 0.0;
+        if (depthBelow < coneStepConverged)
+            break;
+
+        float coneRatio = cone.g * cone.g;
+        prevPosition = position;
+        position += rayDir * (coneRatio * depthBelow / (rayRatio + coneRatio));
+    }
+
+    // A ray that closed in from above is already on the surface
+    if (crossed)
+    {
+        const int numRefinementSteps = 5;
+
+        [unroll(5)]
+        for (int j = 0; j < numRefinementSteps; j++)
+        {
+            float3 midPosition = (prevPosition + position) * 0.5;
+            float midDepth = ConeStepTexture.SampleLevel(samLinear, midPosition.xy, 0).r;
+            if (midPosition.z > midDepth)
+            {
+                position = midPosition;
+            }
+            else
+            {
+                prevPosition = midPosition;
+            }
+        }
+    }
+
+    return position.xy;
+}
+
+float ParallaxSelfShadow(float2 texCoords, float3 lightDirTangent, bool packed)
 {
     const int numShadowSamples = 128;
     float shadow = 1.0; 
     float totalOcclusion = 0.0; 
 
-    float height = DisplacementTexture.Sample(samLinear, texCoords).r;
+    float height = SampleHeight(texCoords, packed);
     float2 deltaTexCoords = lightDirTangent.xy * heightScale / lightDirTangent.z / numShadowSamples;
     float stepHeight = height / numShadowSamples;
 
@@ -137,7 +211,7 @@ float ParallaxSelfShadow(float2 texCoords, float3 lightDirTangent)
         sampleCoords -= deltaTexCoords;
         currentDepth += stepHeight;
 
-        float sampleHeight = DisplacementTexture.Sample(samLinear, sampleCoords).r;
+        float sampleHeight = SampleHeight(sampleCoords, packed);
 
         if (sampleHeight > currentDepth) // Occlusion detected
         {
@@ -149,14 +223,18 @@ float ParallaxSelfShadow(float2 texCoords, float3 lightDirTangent)
     return shadow * 0.5 + 0.5; // Keep minimum light (prevents total blackness)
 }
 
-GBufferOutput PS(PSInput input)
+GBufferOutput ShadeGBuffer(PSInput input, bool packed, bool coneStep)
 {
     GBufferOutput output;
 
     float3 V = normalize(CameraPosition - input.WorldPos);
     float3 viewDirTangent = normalize(mul(V, input.TBN_MATRIX));
 
-    float2 newTexCoords = ParallaxOcclusionMapping(input.TexC, viewDirTangent);
+    float2 newTexCoords;
+    if (coneStep)
+        newTexCoords = ConeStepMapping(input.TexC, viewDirTangent);
+    else
+        newTexCoords = ParallaxOcclusionMapping(input.TexC, viewDirTangent, packed);
     
     float totalShadowFactor = 0.0f;
     
@@ -165,26 +243,45 @@ GBufferOutput PS(PSInput input)
         float3 L = normalize(lights[i].LightPosition.xyz - input.WorldPos);
         float3 lightDirTangent = normalize(mul(L, input.TBN_MATRIX));
         
-        totalShadowFactor += ParallaxSelfShadow(newTexCoords, lightDirTangent);
+        totalShadowFactor += ParallaxSelfShadow(newTexCoords, lightDirTangent, packed);
     }
         
     float shadowFactor = totalShadowFactor / numLights;
     shadowFactor = lerp(0.2f, 1.0f, shadowFactor);
     
     float3 albedo = DiffuseTexture.Sample(samLinear, newTexCoords).rgb;
-    float ao = AOTexture.Sample(samLinear, newTexCoords).r;
-    output.Albedo = float4(albedo * shadowFactor, ao);
+    float3 metalRoughAO = SampleMetalRoughAO(newTexCoords, packed);
+    output.Albedo = float4(albedo * shadowFactor, metalRoughAO.b);
     
-    float3 sampledNormal = NormalTexture.Sample(samLinear, newTexCoords).xyz * 2.0f - 1.0f;
+    // BC5 normal maps only store x and y, z is rebuilt for them and for RGB maps alike
+    float2 normalXY = NormalTexture.Sample(samLinear, newTexCoords).xy * 2.0f - 1.0f;
+    float3 sampledNormal = float3(normalXY, sqrt(saturate(1.0f - dot(normalXY, normalXY))));
     float3 worldNormal = normalize(mul(sampledNormal, input.TBN_MATRIX));
     output.Normal = float4(worldNormal, 1.0f);
     
-    float metallic = MetalTexture.Sample(samLinear, newTexCoords).r;
-    float roughness = RoughnessTexture.Sample(samLinear, newTexCoords).r;
-
-    output.MetalRoughAO = float3(metallic, roughness, ao);
+    output.MetalRoughAO = metalRoughAO;
     
     output.Position = float4(input.WorldPos, 1.0f);
     
     return output;
 }
+
+GBufferOutput PS(PSInput input)
+{
+    return ShadeGBuffer(input, false, false);
+}
+
+GBufferOutput PSPacked(PSInput input)
+{
+    return ShadeGBuffer(input, true, false);
+}
+
+GBufferOutput PSConeStep(PSInput input)
+{
+    return ShadeGBuffer(input, false, true);
+}
+
+GBufferOutput PSPackedConeStep(PSInput input)
+{
+    return ShadeGBuffer(input, true, true);
+}
@@ -25,11 +25,47 @@ struct VSOutput
     float3x3 TBN_MATRIX : TBN_MATRIX; // Tangent-to-world matrix
 };
 
-VSOutput VS(VSInput input)
+// Positions of packed vertices are relative to the mesh bounds
+cbuffer PackedVertexBuffer : register(b1)
+{
+    float3 PositionMin;
+    float Padding01;
+    float3 PositionExtent;
+    float Padding02;
+};
+
+// Input from a packed vertex buffer, see Scene/VertexPacking.h
+struct VSPackedInput
+{
+    float4 Position : POSITION; // R16G16B16A16_UNORM
+    float2 Normal : NORMAL; // R16G16_SNORM octahedral
+    float2 Tangent : TANGENT; // R16G16_SNORM octahedral
+    float2 TexC : TEXCOORD0; // R16G16_FLOAT
+};
+
+// Same as DecodeOctahedral in Scene/VertexPacking.cpp
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 v = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = saturate(-v.z);
+    v.xy += (v.xy >= 0.0f) ? -t : t; // Component-wise in shader model 5
+    return normalize(v);
+}
+
+// Per instance world matrix rows, placed relative to the entity's World
+struct InstanceInput
+{
+    float4 World0 : INSTANCEWORLD0;
+    float4 World1 : INSTANCEWORLD1;
+    float4 World2 : INSTANCEWORLD2;
+    float4 World3 : INSTANCEWORLD3;
+};
+
+VSOutput TransformVertex(float3 position, float3 normal, float2 texC, float3 tangent, float4x4 world)
 {
     VSOutput output;
 
-    float4 worldPos = mul(float4(input.Position, 1.0f), World);
+    float4 worldPos = mul(float4(position, 1.0f), world);
     output.WorldPos = worldPos.xyz;
 
     // Transform to clip space
@@ -37,13 +73,13 @@ VSOutput VS(VSInput input)
     output.Position = mul(output.Position, Projection);
 
     // Transform normal to world space 
-    output.Normal = normalize(mul(input.Normal, (float3x3) World));
+    output.Normal = normalize(mul(normal, (float3x3) world));
     
     // Transform Tangent to world space 
-    output.Tangent = mul(input.Tangent.xyz, (float3x3) World);
+    output.Tangent = mul(tangent.xyz, (float3x3) world);
     
-    float3 N = normalize(mul(input.Normal, (float3x3) World));
-    float3 T = normalize(mul(input.Tangent, (float3x3) World));
+    float3 N = normalize(mul(normal, (float3x3) world));
+    float3 T = normalize(mul(tangent, (float3x3) world));
     float3 B = cross(T, N);
     
     float3x3 TBN_MATRIX = float3x3(T, B, N);
@@ -51,7 +87,35 @@ VSOutput VS(VSInput input)
     output.TBN_MATRIX = TBN_MATRIX;
 
     // Pass UV coordinates
-    output.TexC = input.TexC;
+    output.TexC = texC;
 
     return output;
-}
\ No newline at end of file
+}
+
+VSOutput VS(VSInput input)
+{
+    return TransformVertex(input.Position, input.Normal, input.TexC, input.Tangent, World);
+}
+
+VSOutput VSPacked(VSPackedInput input)
+{
+    float3 position = PositionMin + input.Position.xyz * PositionExtent;
+    return TransformVertex(position, DecodeOctahedral(input.Normal), input.TexC, DecodeOctahedral(input.Tangent), World);
+}
+
+float4x4 InstanceWorld(InstanceInput instance)
+{
+    float4x4 instanceWorld = float4x4(instance.World0, instance.World1, instance.World2, instance.World3);
+    return mul(instanceWorld, World);
+}
+
+VSOutput VSInstanced(VSInput input, InstanceInput instance)
+{
+    return TransformVertex(input.Position, input.Normal, input.TexC, input.Tangent, InstanceWorld(instance));
+}
+
+VSOutput VSPackedInstanced(VSPackedInput input, InstanceInput instance)
+{
+    float3 position = PositionMin + input.Position.xyz * PositionExtent;
+    return TransformVertex(position, DecodeOctahedral(input.Normal), input.TexC, DecodeOctahedral(input.Tangent), InstanceWorld(instance));
+}
@@ -0,0 +1,222 @@
+#include "CellStreamer.h"
+
+#include <algorithm>
+
+BlackJawz::Scene::CellStreamer::CellStreamer(SceneLoader& loader, InsertCellFunc insertCell, RemoveCellFunc removeCell)
+	: loader(loader), insertCell(std::move(insertCell)), removeCell(std::move(removeCell))
+{
+
+}
+
+BlackJawz::Scene::CellStreamer::~CellStreamer()
+{
+	// The decode job writes into the scene owned by this streamer
+	CancelLoad();
+}
+
+bool BlackJawz::Scene::CellStreamer::Open(const std::string& filename)
+{
+	Close();
+	return partition.Open(filename);
+}
+
+void BlackJawz::Scene::CellStreamer::Close()
+{
+	CancelLoad();
+	partition.Close();
+	resident.clear();
+	failed.clear();
+
+	hasLastPosition = false;
+	velocity[0] = velocity[1] = 0.0f;
+}
+
+bool BlackJawz::Scene::CellStreamer::Reopen(const std::string& filename)
+{
+	// Offsets into the old file are meaningless now
+	CancelLoad();
+
+	WorldPartition rewritten;
+	if (!rewritten.Open(filename))
+		return false;
+
+	partition = std::move(rewritten);
+	failed.clear();
+	return true;
+}
+
+void BlackJawz::Scene::CellStreamer::Update(const float cameraPosition[3], float deltaSeconds)
+{
+	if (!IsOpen())
+		return;
+
+	float x = cameraPosition[0];
+	float z = cameraPosition[2];
+
+	if (hasLastPosition && deltaSeconds > 0.0f)
+	{
+		velocity[0] += ((x - lastPosition[0]) / deltaSeconds - velocity[0]) * VelocitySmoothing;
+		velocity[1] += ((z - lastPosition[1]) / deltaSeconds - velocity[1]) * VelocitySmoothing;
+	}
+	lastPosition[0] = x;
+	lastPosition[1] = z;
+	hasLastPosition = true;
+
+	float predictedX = x + velocity[0] * settings.prefetchSeconds;
+	float predictedZ = z + velocity[1] * settings.prefetchSeconds;
+
+	if (loadingCell)
+	{
+		FinishLoad();
+	}
+
+	UnloadCells(x, z, predictedX, predictedZ);
+
+	if (!loadingCell)
+	{
+		LoadNextCell(x, z, predictedX, predictedZ);
+	}
+}
+
+void BlackJawz::Scene::CellStreamer::FinishLoad()
+{
+	SceneLoader::State state = loader.GetState();
+	if (state == SceneLoader::State::Failed)
+	{
+		failed.insert(*loadingCell);
+		loadingCell.reset();
+		loadingScene = LoadedScene();
+		return;
+	}
+
+	if (state != SceneLoader::State::Decoded)
+		return;
+
+	// The whole cell goes in at once, so it is never half resident
+	for (const ResourceSlots& slots : loadingScene.resourceSlots)
+	{
+		if (!loader.AreResourcesReady(slots))
+			return;
+	}
+
+	loader.Wait();
+	insertCell(*loadingCell, loadingScene);
+	resident.insert(*loadingCell);
+
+	loadingCell.reset();
+	loadingScene = LoadedScene();
+}
+
+void BlackJawz::Scene::CellStreamer::CancelLoad()
+{
+	if (!loadingCell)
+		return;
+
+	loader.Wait();
+	loadingCell.reset();
+	loadingScene = LoadedScene();
+}
+
+void BlackJawz::Scene::CellStreamer::UnloadCells(float x, float z, float predictedX, float predictedZ)
+{
+	float cellSize = partition.GetCellSize();
+
+	std::vector<std::pair<float, CellCoord>> candidates;
+	candidates.reserve(resident.size());
+	for (const CellCoord& cell : resident)
+	{
+		if (cell == AlwaysLoadedCell)
+			continue;
+
+		float distance = std::min(WorldPartition::DistanceToCell(cell, x, z, cellSize),
+			WorldPartition::DistanceToCell(cell, predictedX, predictedZ, cellSize));
+		candidates.emplace_back(distance, cell);
+	}
+
+	// Furthest first, so going over the limit drops the cells least likely to be needed
+	std::sort(candidates.begin(), candidates.end(),
+		[](const auto& a, const auto& b) { return a.first > b.first; });
+
+	size_t residentCount = resident.size();
+	for (const auto& [distance, cell] : candidates)
+	{
+		if (distance <= settings.unloadRadius && residentCount <= settings.maxResidentCells)
+			break;
+
+		if (removeCell(cell))
+		{
+			resident.erase(cell);
+			--residentCount;
+		}
+	}
+}
+
+void BlackJawz::Scene::CellStreamer::LoadNextCell(float x, float z, float predictedX, float predictedZ)
+{
+	std::optional<CellCoord> best;
+	float bestPriority = 0.0f;
+
+	auto consider = [&](const CellCoord& cell)
+		{
+			if (resident.count(cell) > 0 || failed.count(cell) > 0 || !partition.FindCell(cell))
+				return;
+
+			std::optional<float> priority = GetLoadPriority(cell, x, z, predictedX, predictedZ);
+			if (priority && (!best || *priority < bestPriority))
+			{
+				best = cell;
+				bestPriority = *priority;
+			}
+		};
+
+	consider(AlwaysLoadedCell);
+
+	// Only the cells overlapping a square around each point can be in range
+	float cellSize = partition.GetCellSize();
+	const float centers[2][2] = { { x, z }, { predictedX, predictedZ } };
+	for (const auto& center : centers)
+	{
+		CellCoord minCell = WorldPartition::GetCell(center[0] - settings.loadRadius, center[1] - settings.loadRadius, cellSize);
+		CellCoord maxCell = WorldPartition::GetCell(center[0] + settings.loadRadius, center[1] + settings.loadRadius, cellSize);
+
+		for (int64_t cellX = minCell.x; cellX <= maxCell.x; ++cellX)
+		{
+			for (int64_t cellZ = minCell.z; cellZ <= maxCell.z; ++cellZ)
+			{
+				consider(CellCoord{ static_cast<int32_t>(cellX), static_cast<int32_t>(cellZ) });
+			}
+		}
+	}
+
+	if (!best)
+		return;
+
+	// At the limit only the always loaded cell still goes in
+	if (resident.size() >= settings.maxResidentCells && *best != AlwaysLoadedCell)
+		return;
+
+	const CellInfo* info = partition.FindCell(*best);
+	if (loader.BeginRange(partition.GetFilename(), info->offset, info->size, loadingScene))
+	{
+		loadingCell = best;
+	}
+}
+
+std::optional<float> BlackJawz::Scene::CellStreamer::GetLoadPriority(const CellCoord& cell, float x, float z,
+	float predictedX, float predictedZ) const
+{
+	if (cell == AlwaysLoadedCell)
+		return -1.0f;
+
+	float cellSize = partition.GetCellSize();
+
+	float distance = WorldPartition::DistanceToCell(cell, x, z, cellSize);
+	if (distance <= settings.loadRadius)
+		return distance;
+
+	float predictedDistance = WorldPartition::DistanceToCell(cell, predictedX, predictedZ, cellSize);
+	if (predictedDistance <= settings.loadRadius)
+		return settings.loadRadius + predictedDistance;
+
+	return std::nullopt;
+}
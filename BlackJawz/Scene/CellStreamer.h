@@ -0,0 +1,82 @@
+#pragma once
+#include "SceneLoader.h"
+#include "WorldPartition.h"
+
+#include <functional>
+#include <optional>
+#include <unordered_set>
+
+namespace BlackJawz::Scene
+{
+	struct StreamingSettings
+	{
+		float loadRadius = 96.0f; // Cells closer than this to the camera are loaded
+		float unloadRadius = 160.0f; // and stay until they are further than this, so a camera on a cell border does not thrash
+		float prefetchSeconds = 1.5f; // Cells around where the camera will be this far ahead are loaded too
+		size_t maxResidentCells = 64; // Hard limit on memory use whatever the size of the world, the furthest cells go first
+	};
+
+	// Streams the cells of a world partitioned scene in and out around the camera. One cell is read and
+	// decoded at a time through the scene loader, nearest first, and handed to the owner once its
+	// resources have been created. Only cells near the camera are ever looked at, so the cost per
+	// frame does not grow with the size of the world.
+	class CellStreamer
+	{
+	public:
+		// The owner takes the entities, giving them live ids
+		using InsertCellFunc = std::function<void(const CellCoord& cell, LoadedScene& scene)>;
+		// The owner destroys the cell's entities, or returns false to keep it resident
+		using RemoveCellFunc = std::function<bool(const CellCoord& cell)>;
+
+		CellStreamer(SceneLoader& loader, InsertCellFunc insertCell, RemoveCellFunc removeCell);
+		~CellStreamer();
+
+		// Fails for scenes without a partition. Cells of a previous scene are forgotten, not removed.
+		bool Open(const std::string& filename);
+		void Close();
+
+		// Switch to a rewritten copy of the scene, resident cells stay resident
+		bool Reopen(const std::string& filename);
+
+		// Called once per frame with the camera position
+		void Update(const float cameraPosition[3], float deltaSeconds);
+
+		bool IsOpen() const { return partition.IsOpen(); }
+		bool IsLoading() const { return loadingCell.has_value(); }
+		bool IsResident(const CellCoord& cell) const { return resident.count(cell) > 0; }
+		size_t GetResidentCount() const { return resident.size(); }
+		std::vector<CellCoord> GetResidentCells() const { return std::vector<CellCoord>(resident.begin(), resident.end()); }
+
+		const WorldPartition& GetPartition() const { return partition; }
+		StreamingSettings& GetSettings() { return settings; }
+
+	private:
+		// How strongly each frame's movement pulls the velocity estimate
+		static constexpr float VelocitySmoothing = 0.2f;
+
+		void FinishLoad();
+		void CancelLoad();
+		void UnloadCells(float x, float z, float predictedX, float predictedZ);
+		void LoadNextCell(float x, float z, float predictedX, float predictedZ);
+
+		// Lower is sooner, cells around the camera go before those around where it is heading
+		std::optional<float> GetLoadPriority(const CellCoord& cell, float x, float z, float predictedX, float predictedZ) const;
+
+		SceneLoader& loader;
+		InsertCellFunc insertCell;
+		RemoveCellFunc removeCell;
+
+		WorldPartition partition;
+		StreamingSettings settings;
+
+		std::unordered_set<CellCoord, CellCoordHash> resident;
+		std::unordered_set<CellCoord, CellCoordHash> failed; // Not retried until the scene is reopened
+
+		std::optional<CellCoord> loadingCell;
+		LoadedScene loadingScene;
+
+		bool hasLastPosition = false;
+		float lastPosition[2] = {};
+		float velocity[2] = {};
+	};
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace BlackJawz::Scene
+{
+	// Records which entities were edited since the last save, so a journaled save only
+	// writes what changed. Entities are the editor's live ids, removals are persistent ids.
+	class ChangeTracker
+	{
+	public:
+		enum ChangeFlags : uint32_t
+		{
+			TransformChanged = 1 << 0,
+			AppearanceChanged = 1 << 1,
+			LightChanged = 1 << 2,
+			NameChanged = 1 << 3,
+			AllChanged = TransformChanged | AppearanceChanged | LightChanged | NameChanged
+		};
+
+		void MarkChanged(uint32_t entity, uint32_t flags)
+		{
+			changed[entity] |= flags;
+		}
+
+		// savedId is the entity's id in the file, empty if it was never saved
+		void MarkRemoved(uint32_t entity, std::optional<uint32_t> savedId)
+		{
+			changed.erase(entity);
+			if (savedId)
+			{
+				removed.push_back(*savedId);
+			}
+		}
+
+		bool Empty() const { return changed.empty() && removed.empty(); }
+
+		void Clear()
+		{
+			changed.clear();
+			removed.clear();
+		}
+
+		const std::unordered_map<uint32_t, uint32_t>& GetChanged() const { return changed; }
+		const std::vector<uint32_t>& GetRemoved() const { return removed; }
+
+	private:
+		std::unordered_map<uint32_t, uint32_t> changed; // Entity to ChangeFlags
+		std::vector<uint32_t> removed;
+	};
+}
@@ -0,0 +1,2136 @@
+#include "MeshImport.h"
+#include "SceneBounds.h"
+#include "SceneReader.h"
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <string_view>
+
+namespace
+{
+	static_assert(sizeof(BlackJawz::Scene::ImportedVertex) == BlackJawz::Scene::FloatVertexStride,
+		"ImportedVertex must match the editor's Vertex");
+
+	// Vertices converted per job
+	constexpr size_t VertexGrain = 64 * 1024;
+
+	double ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// Runs job(begin, end) over [0, count) in ranges of grain, as jobs when there is a job system. Safe
+	// to nest, Wait runs queued jobs.
+	void ParallelFor(BlackJawz::Jobs::JobSystem* jobSystem, size_t count, size_t grain, const std::function<void(size_t, size_t)>& job)
+	{
+		size_t rangeCount = (count + grain - 1) / grain;
+		if (!jobSystem || rangeCount <= 1)
+		{
+			for (size_t begin = 0; begin < count; begin += grain)
+			{
+				job(begin, std::min(count, begin + grain));
+			}
+			return;
+		}
+
+		BlackJawz::Jobs::JobCounter counter;
+		jobSystem->Dispatch(counter, static_cast<uint32_t>(rangeCount), 1, [&](uint32_t range)
+			{
+				size_t begin = static_cast<size_t>(range) * grain;
+				job(begin, std::min(count, begin + grain));
+			});
+		jobSystem->Wait(counter);
+	}
+
+	void Cross(const float a[3], const float b[3], float result[3])
+	{
+		result[0] = a[1] * b[2] - a[2] * b[1];
+		result[1] = a[2] * b[0] - a[0] * b[2];
+		result[2] = a[0] * b[1] - a[1] * b[0];
+	}
+
+	float Dot(const float a[3], const float b[3])
+	{
+		return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+	}
+
+	bool Normalize(float vector[3])
+	{
+		float length = std::sqrt(Dot(vector, vector));
+		if (!(length > 0.0f))
+			return false;
+
+		vector[0] /= length;
+		vector[1] /= length;
+		vector[2] /= length;
+		return true;
+	}
+
+	// (b - a) x (c - a), outward for counter clockwise triangles in a right handed space
+	void FaceNormal(const float a[3], const float b[3], const float c[3], float normal[3])
+	{
+		float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		Cross(ab, ac, normal);
+	}
+
+	// Per vertex tangents from the texture coordinates, after Lengyel, "Computing Tangent Space Basis
+	// Vectors for an Arbitrary Mesh". Triangles are worked out in parallel and summed per vertex, then
+	// made perpendicular to the normals.
+	void ComputeTangents(BlackJawz::Scene::ImportedMesh& mesh, BlackJawz::Jobs::JobSystem* jobSystem)
+	{
+		size_t triangleCount = mesh.indices.size() / 3;
+		std::vector<float> triangleTangents(triangleCount * 3);
+		ParallelFor(jobSystem, triangleCount, VertexGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t triangle = begin; triangle < end; ++triangle)
+				{
+					const BlackJawz::Scene::ImportedVertex& v0 = mesh.vertices[mesh.indices[triangle * 3]];
+					const BlackJawz::Scene::ImportedVertex& v1 = mesh.vertices[mesh.indices[triangle * 3 + 1]];
+					const BlackJawz::Scene::ImportedVertex& v2 = mesh.vertices[mesh.indices[triangle * 3 + 2]];
+
+					float du1 = v1.texC[0] - v0.texC[0];
+					float dv1 = v1.texC[1] - v0.texC[1];
+					float du2 = v2.texC[0] - v0.texC[0];
+					float dv2 = v2.texC[1] - v0.texC[1];
+					float area = du1 * dv2 - du2 * dv1;
+
+					float* tangent = &triangleTangents[triangle * 3];
+					if (area == 0.0f)
+					{
+						tangent[0] = tangent[1] = tangent[2] = 0.0f;
+						continue;
+					}
+
+					float scale = 1.0f / area;
+					for (size_t axis = 0; axis < 3; ++axis)
+					{
+						float e1 = v1.position[axis] - v0.position[axis];
+						float e2 = v2.position[axis] - v0.position[axis];
+						tangent[axis] = (e1 * dv2 - e2 * dv1) * scale;
+					}
+				}
+			});
+
+		// Scattered to shared vertices, cheap next to the rest so it stays serial
+		std::vector<float> sums(mesh.vertices.size() * 3, 0.0f);
+		for (size_t corner = 0; corner < mesh.indices.size(); ++corner)
+		{
+			const float* tangent = &triangleTangents[(corner / 3) * 3];
+			float* sum = &sums[static_cast<size_t>(mesh.indices[corner]) * 3];
+			sum[0] += tangent[0];
+			sum[1] += tangent[1];
+			sum[2] += tangent[2];
+		}
+
+		ParallelFor(jobSystem, mesh.vertices.size(), VertexGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					BlackJawz::Scene::ImportedVertex& vertex = mesh.vertices[i];
+					const float* sum = &sums[i * 3];
+					float along = Dot(vertex.normal, sum);
+					float tangent[3] = { sum[0] - vertex.normal[0] * along, sum[1] - vertex.normal[1] * along, sum[2] - vertex.normal[2] * along };
+
+					// No texture coordinates to follow, any direction across the normal will do
+					if (!Normalize(tangent))
+					{
+						float axis[3] = { 0.0f, 0.0f, 0.0f };
+						axis[std::fabs(vertex.normal[0]) < 0.9f ? 0 : 1] = 1.0f;
+						Cross(vertex.normal, axis, tangent);
+						if (!Normalize(tangent))
+						{
+							tangent[0] = 1.0f;
+							tangent[1] = tangent[2] = 0.0f;
+						}
+					}
+					memcpy(vertex.tangent, tangent, sizeof(vertex.tangent));
+				}
+			});
+	}
+
+	BlackJawz::Scene::BoundsData MeasureBounds(const std::vector<BlackJawz::Scene::ImportedVertex>& vertices)
+	{
+		BlackJawz::Scene::BoundsData bounds = BlackJawz::Scene::EmptyBounds();
+		if (vertices.empty())
+			return bounds;
+
+		memcpy(bounds.min, vertices[0].position, sizeof(bounds.min));
+		memcpy(bounds.max, vertices[0].position, sizeof(bounds.max));
+		for (const BlackJawz::Scene::ImportedVertex& vertex : vertices)
+		{
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				bounds.min[axis] = std::min(bounds.min[axis], vertex.position[axis]);
+				bounds.max[axis] = std::max(bounds.max[axis], vertex.position[axis]);
+			}
+		}
+		return bounds;
+	}
+
+	std::string GetBaseDirectory(const std::string& filename)
+	{
+		return std::filesystem::path(filename).parent_path().string();
+	}
+
+	std::string JoinPath(const std::string& directory, const std::string& file)
+	{
+		return directory.empty() ? file : (std::filesystem::path(directory) / file).string();
+	}
+
+	// ---- Text ----
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	const char* SkipSpaces(const char* p, const char* end)
+	{
+		while (p < end && IsSpace(*p))
+		{
+			++p;
+		}
+		return p;
+	}
+
+	const char* SkipToken(const char* p, const char* end)
+	{
+		while (p < end && !IsSpace(*p))
+		{
+			++p;
+		}
+		return p;
+	}
+
+	// The rest of the line without the spaces around it
+	std::string_view RestOfLine(const char* p, const char* end)
+	{
+		p = SkipSpaces(p, end);
+		while (end > p && IsSpace(end[-1]))
+		{
+			--end;
+		}
+		return std::string_view(p, end - p);
+	}
+
+	bool ParseFloat(const char*& p, const char* end, float& value)
+	{
+		p = SkipSpaces(p, end);
+
+		// from_chars takes no leading plus, some writers emit one
+		if (p < end && *p == '+')
+			++p;
+
+		auto result = std::from_chars(p, end, value);
+		if (result.ec == std::errc::result_out_of_range)
+		{
+			// Denormals, nothing a mesh can tell apart from zero
+			value = 0.0f;
+		}
+		else if (result.ec != std::errc())
+		{
+			return false;
+		}
+		p = result.ptr;
+		return true;
+	}
+
+	// ---- OBJ ----
+
+	struct VertexKey
+	{
+		int32_t position;
+		int32_t texC; // -1 when missing
+		int32_t normal;
+
+		bool operator==(const VertexKey& other) const = default;
+	};
+
+	// Open addressing map from vertex keys to their place in a list of unique keys, in first seen order
+	class VertexTable
+	{
+	public:
+		explicit VertexTable(size_t capacity)
+		{
+			size_t size = 16;
+			while (size < capacity * 2)
+			{
+				size *= 2;
+			}
+			slots.assign(size, Empty);
+			mask = size - 1;
+		}
+
+		uint32_t Insert(const VertexKey& key, std::vector<VertexKey>& keys)
+		{
+			uint64_t hash = static_cast<uint32_t>(key.position) * 0x9E3779B97F4A7C15ull;
+			hash ^= static_cast<uint32_t>(key.texC) * 0xC2B2AE3D27D4EB4Full;
+			hash ^= static_cast<uint32_t>(key.normal) * 0x165667B19E3779F9ull;
+			hash ^= hash >> 29;
+
+			for (size_t slot = hash & mask;; slot = (slot + 1) & mask)
+			{
+				uint32_t index = slots[slot];
+				if (index == Empty)
+				{
+					index = static_cast<uint32_t>(keys.size());
+					slots[slot] = index;
+					keys.push_back(key);
+					return index;
+				}
+				if (keys[index] == key)
+					return index;
+			}
+		}
+
+	private:
+		static constexpr uint32_t Empty = 0xFFFFFFFF;
+		std::vector<uint32_t> slots;
+		size_t mask = 0;
+	};
+
+	struct ObjCorner
+	{
+		int32_t index[3]; // Position, texture coordinate and normal, 0 based
+		uint8_t present = 0; // Bit per index the face gave
+		uint8_t relative = 0; // Bit per index counted back from the end of its chunk's list
+	};
+
+	// An o, g or usemtl line, the chunk's triangles from firstTriangle on belong to it
+	struct ObjGroupChange
+	{
+		size_t firstTriangle = 0;
+		bool material = false; // usemtl, else an object name
+		std::string name;
+	};
+
+	// A run of whole lines, parsed on its own
+	struct ObjChunk
+	{
+		const char* begin = nullptr;
+		const char* end = nullptr;
+
+		std::vector<float> positions; // xyz
+		std::vector<float> texCs; // uv
+		std::vector<float> normals; // xyz
+		std::vector<ObjCorner> corners; // Three per triangle, faces are fanned
+		std::vector<ObjGroupChange> changes;
+		std::vector<std::string> materialLibraries;
+		bool missingNormals = false;
+
+		std::string error;
+		size_t errorOffset = 0; // Into the file
+	};
+
+	// "p", "p/t", "p//n" or "p/t/n", negative indices count back from the last one given
+	bool ParseCorner(const char*& p, const char* end, const int32_t counts[3], ObjCorner& corner)
+	{
+		for (int32_t k = 0; k < 3; ++k)
+		{
+			if (k > 0)
+			{
+				if (p >= end || *p != '/')
+					break;
+				++p;
+
+				// An empty texture coordinate in "p//n"
+				if (k == 1 && p < end && *p == '/')
+					continue;
+			}
+
+			int32_t value = 0;
+			auto result = std::from_chars(p, end, value);
+			if (result.ec != std::errc() || value == 0)
+				return false;
+			p = result.ptr;
+
+			if (value > 0)
+			{
+				corner.index[k] = value - 1;
+			}
+			else
+			{
+				corner.index[k] = counts[k] + value;
+				corner.relative |= 1 << k;
+			}
+			corner.present |= 1 << k;
+		}
+		return (corner.present & 1) != 0 && (p >= end || IsSpace(*p));
+	}
+
+	void ParseObjChunk(ObjChunk& chunk, const char* fileBegin)
+	{
+		std::vector<ObjCorner> face;
+		const char* p = chunk.begin;
+		while (p < chunk.end)
+		{
+			const char* lineEnd = static_cast<const char*>(memchr(p, '\n', chunk.end - p));
+			if (!lineEnd)
+			{
+				lineEnd = chunk.end;
+			}
+			const char* line = p;
+			p = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+
+			const char* cursor = SkipSpaces(line, lineEnd);
+			const char* keywordEnd = SkipToken(cursor, lineEnd);
+			std::string_view keyword(cursor, keywordEnd - cursor);
+			cursor = keywordEnd;
+
+			bool valid = true;
+			if (keyword == "v" || keyword == "vn")
+			{
+				// Positions may carry w or a colour after xyz, both ignored
+				std::vector<float>& values = keyword == "v" ? chunk.positions : chunk.normals;
+				float xyz[3];
+				valid = ParseFloat(cursor, lineEnd, xyz[0]) && ParseFloat(cursor, lineEnd, xyz[1]) && ParseFloat(cursor, lineEnd, xyz[2]);
+				values.insert(values.end(), xyz, xyz + 3);
+			}
+			else if (keyword == "vt")
+			{
+				float uv[2] = { 0.0f, 0.0f };
+				valid = ParseFloat(cursor, lineEnd, uv[0]);
+				if (valid && SkipSpaces(cursor, lineEnd) < lineEnd)
+				{
+					valid = ParseFloat(cursor, lineEnd, uv[1]);
+				}
+				chunk.texCs.insert(chunk.texCs.end(), uv, uv + 2);
+			}
+			else if (keyword == "f")
+			{
+				int32_t counts[3] =
+				{
+					static_cast<int32_t>(chunk.positions.size() / 3),
+					static_cast<int32_t>(chunk.texCs.size() / 2),
+					static_cast<int32_t>(chunk.normals.size() / 3)
+				};
+
+				face.clear();
+				for (cursor = SkipSpaces(cursor, lineEnd); valid && cursor < lineEnd; cursor = SkipSpaces(cursor, lineEnd))
+				{
+					ObjCorner corner;
+					valid = ParseCorner(cursor, lineEnd, counts, corner);
+					face.push_back(corner);
+				}
+
+				// Fanned from the first corner. Faces of fewer than three corners draw nothing.
+				for (size_t i = 2; valid && i < face.size(); ++i)
+				{
+					chunk.corners.push_back(face[0]);
+					chunk.corners.push_back(face[i - 1]);
+					chunk.corners.push_back(face[i]);
+					chunk.missingNormals |= !(face[0].present & face[i - 1].present & face[i].present & 4);
+				}
+			}
+			else if (keyword == "o" || keyword == "g" || keyword == "usemtl")
+			{
+				ObjGroupChange change;
+				change.firstTriangle = chunk.corners.size() / 3;
+				change.material = keyword == "usemtl";
+				change.name = RestOfLine(cursor, lineEnd);
+				chunk.changes.push_back(std::move(change));
+			}
+			else if (keyword == "mtllib")
+			{
+				chunk.materialLibraries.emplace_back(RestOfLine(cursor, lineEnd));
+			}
+
+			if (!valid)
+			{
+				chunk.error = "Cannot parse \"" + std::string(RestOfLine(line, lineEnd).substr(0, 64)) + "\"";
+				chunk.errorOffset = line - fileBegin;
+				return;
+			}
+		}
+	}
+
+	// Map paths are the last word of the line, after any options
+	std::string GetMapPath(const char* p, const char* end)
+	{
+		std::string_view line = RestOfLine(p, end);
+		size_t start = line.find_last_of(" \t");
+		return std::string(start == std::string_view::npos ? line : line.substr(start + 1));
+	}
+
+	void ParseMaterialLibrary(const BlackJawz::Scene::Blob& data, std::vector<BlackJawz::Scene::ImportedMaterial>& materials)
+	{
+		using BlackJawz::Scene::TextureSlot;
+
+		BlackJawz::Scene::ImportedMaterial* material = nullptr;
+		bool hasRoughness = false;
+		float specularExponent = -1.0f;
+
+		// Blinn-Phong materials, roughness from the specular exponent
+		auto finish = [&]()
+			{
+				if (material && !hasRoughness && specularExponent >= 0.0f)
+				{
+					material->roughness = std::sqrt(2.0f / (specularExponent + 2.0f));
+				}
+			};
+
+		const char* p = reinterpret_cast<const char*>(data.data);
+		const char* end = p + data.size;
+		while (p < end)
+		{
+			const char* lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+			if (!lineEnd)
+			{
+				lineEnd = end;
+			}
+			const char* cursor = SkipSpaces(p, lineEnd);
+			p = lineEnd < end ? lineEnd + 1 : end;
+
+			const char* keywordEnd = SkipToken(cursor, lineEnd);
+			std::string_view keyword(cursor, keywordEnd - cursor);
+			cursor = keywordEnd;
+
+			if (keyword == "newmtl")
+			{
+				finish();
+				materials.emplace_back();
+				material = &materials.back();
+				material->name = RestOfLine(cursor, lineEnd);
+				hasRoughness = false;
+				specularExponent = -1.0f;
+				continue;
+			}
+			if (!material)
+				continue;
+
+			float value = 0.0f;
+			if (keyword == "Kd")
+			{
+				for (size_t i = 0; i < 3 && ParseFloat(cursor, lineEnd, value); ++i)
+				{
+					material->baseColour[i] = value;
+				}
+			}
+			else if (keyword == "d" && ParseFloat(cursor, lineEnd, value))
+			{
+				material->baseColour[3] = value;
+			}
+			else if (keyword == "Tr" && ParseFloat(cursor, lineEnd, value))
+			{
+				material->baseColour[3] = 1.0f - value;
+			}
+			else if (keyword == "Pm" && ParseFloat(cursor, lineEnd, value))
+			{
+				material->metallic = value;
+			}
+			else if (keyword == "Pr" && ParseFloat(cursor, lineEnd, value))
+			{
+				material->roughness = value;
+				hasRoughness = true;
+			}
+			else if (keyword == "Ns" && ParseFloat(cursor, lineEnd, value))
+			{
+				specularExponent = value;
+			}
+			else if (keyword == "map_Kd")
+			{
+				material->textures[static_cast<size_t>(TextureSlot::Diffuse)] = GetMapPath(cursor, lineEnd);
+			}
+			else if (keyword == "map_Bump" || keyword == "map_bump" || keyword == "bump" || keyword == "norm")
+			{
+				material->textures[static_cast<size_t>(TextureSlot::Normal)] = GetMapPath(cursor, lineEnd);
+			}
+			else if (keyword == "map_Pm")
+			{
+				material->textures[static_cast<size_t>(TextureSlot::Metal)] = GetMapPath(cursor, lineEnd);
+			}
+			else if (keyword == "map_Pr")
+			{
+				material->textures[static_cast<size_t>(TextureSlot::Roughness)] = GetMapPath(cursor, lineEnd);
+			}
+			else if (keyword == "map_ao")
+			{
+				material->textures[static_cast<size_t>(TextureSlot::AO)] = GetMapPath(cursor, lineEnd);
+			}
+			else if (keyword == "disp")
+			{
+				material->textures[static_cast<size_t>(TextureSlot::Displacement)] = GetMapPath(cursor, lineEnd);
+			}
+		}
+		finish();
+	}
+
+	// Triangles [firstTriangle, firstTriangle + triangleCount) of one chunk, all in one mesh
+	struct ObjPiece
+	{
+		size_t chunk = 0;
+		size_t firstTriangle = 0;
+		size_t triangleCount = 0;
+		size_t mesh = 0;
+
+		// Welded within the piece, the mesh welds the pieces together
+		std::vector<VertexKey> keys;
+		std::vector<uint32_t> indices;
+	};
+
+	// ---- JSON ----
+
+	struct JsonValue
+	{
+		enum class Type : uint8_t
+		{
+			Null,
+			Bool,
+			Number,
+			String,
+			Array,
+			Object
+		};
+
+		Type type = Type::Null;
+		bool boolean = false;
+		double number = 0.0;
+		std::string string;
+		std::vector<JsonValue> elements; // Array elements, or object values
+		std::vector<std::string> keys; // Object keys, parallel to elements
+
+		const JsonValue* Find(std::string_view key) const
+		{
+			if (type != Type::Object)
+				return nullptr;
+
+			for (size_t i = 0; i < keys.size(); ++i)
+			{
+				if (keys[i] == key)
+					return &elements[i];
+			}
+			return nullptr;
+		}
+
+		// Elements of an array member, empty when it is missing or not an array
+		const std::vector<JsonValue>& GetArray(std::string_view key) const
+		{
+			static const std::vector<JsonValue> none;
+			const JsonValue* value = Find(key);
+			return value && value->type == Type::Array ? value->elements : none;
+		}
+
+		double GetNumber(std::string_view key, double fallback) const
+		{
+			const JsonValue* value = Find(key);
+			return value && value->type == Type::Number ? value->number : fallback;
+		}
+
+		// Whole numbers that can index or size something, fallback for anything else
+		int64_t GetIndex(std::string_view key, int64_t fallback) const
+		{
+			double value = GetNumber(key, -1.0);
+			return value >= 0.0 && value < 9.0e15 && value == std::floor(value) ? static_cast<int64_t>(value) : fallback;
+		}
+
+		std::string GetString(std::string_view key) const
+		{
+			const JsonValue* value = Find(key);
+			return value && value->type == Type::String ? value->string : std::string();
+		}
+	};
+
+	class JsonParser
+	{
+	public:
+		JsonParser(const char* begin, const char* end) : p(begin), end(end) {}
+
+		// The whole text is one value, with only whitespace after it
+		bool Parse(JsonValue& value)
+		{
+			if (!ParseValue(value, 0))
+				return false;
+
+			SkipWhitespace();
+			return p == end;
+		}
+
+		size_t GetOffset(const char* begin) const { return p - begin; }
+
+	private:
+		// Deeper than any glTF file, keeps malformed files from exhausting the stack
+		static constexpr int32_t MaxDepth = 128;
+
+		void SkipWhitespace()
+		{
+			while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+			{
+				++p;
+			}
+		}
+
+		bool Expect(const char* literal)
+		{
+			size_t length = strlen(literal);
+			if (static_cast<size_t>(end - p) < length || memcmp(p, literal, length) != 0)
+				return false;
+			p += length;
+			return true;
+		}
+
+		bool ParseValue(JsonValue& value, int32_t depth)
+		{
+			SkipWhitespace();
+			if (p >= end || depth > MaxDepth)
+				return false;
+
+			switch (*p)
+			{
+			case '{':
+				return ParseObject(value, depth);
+			case '[':
+				return ParseArray(value, depth);
+			case '"':
+				value.type = JsonValue::Type::String;
+				return ParseString(value.string);
+			case 't':
+				value.type = JsonValue::Type::Bool;
+				value.boolean = true;
+				return Expect("true");
+			case 'f':
+				value.type = JsonValue::Type::Bool;
+				return Expect("false");
+			case 'n':
+				return Expect("null");
+			default:
+			{
+				value.type = JsonValue::Type::Number;
+				auto result = std::from_chars(p, end, value.number);
+				if (result.ec != std::errc())
+					return false;
+				p = result.ptr;
+				return true;
+			}
+			}
+		}
+
+		bool ParseObject(JsonValue& value, int32_t depth)
+		{
+			value.type = JsonValue::Type::Object;
+			++p;
+			SkipWhitespace();
+			if (p < end && *p == '}')
+			{
+				++p;
+				return true;
+			}
+
+			while (true)
+			{
+				SkipWhitespace();
+				std::string key;
+				if (p >= end || *p != '"' || !ParseString(key))
+					return false;
+
+				SkipWhitespace();
+				if (p >= end || *p != ':')
+					return false;
+				++p;
+
+				value.keys.push_back(std::move(key));
+				value.elements.emplace_back();
+				if (!ParseValue(value.elements.back(), depth + 1))
+					return false;
+
+				SkipWhitespace();
+				if (p >= end)
+					return false;
+				if (*p++ == '}')
+					return true;
+				if (p[-1] != ',')
+					return false;
+			}
+		}
+
+		bool ParseArray(JsonValue& value, int32_t depth)
+		{
+			value.type = JsonValue::Type::Array;
+			++p;
+			SkipWhitespace();
+			if (p < end && *p == ']')
+			{
+				++p;
+				return true;
+			}
+
+			while (true)
+			{
+				value.elements.emplace_back();
+				if (!ParseValue(value.elements.back(), depth + 1))
+					return false;
+
+				SkipWhitespace();
+				if (p >= end)
+					return false;
+				if (*p++ == ']')
+					return true;
+				if (p[-1] != ',')
+					return false;
+			}
+		}
+
+		bool ParseHex(uint32_t& codePoint)
+		{
+			if (end - p < 4)
+				return false;
+
+			auto result = std::from_chars(p, p + 4, codePoint, 16);
+			if (result.ec != std::errc() || result.ptr != p + 4)
+				return false;
+			p += 4;
+			return true;
+		}
+
+		static void AppendUtf8(uint32_t codePoint, std::string& text)
+		{
+			if (codePoint < 0x80)
+			{
+				text += static_cast<char>(codePoint);
+			}
+			else if (codePoint < 0x800)
+			{
+				text += static_cast<char>(0xC0 | (codePoint >> 6));
+				text += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				text += static_cast<char>(0xE0 | (codePoint >> 12));
+				text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				text += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				text += static_cast<char>(0xF0 | (codePoint >> 18));
+				text += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				text += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				text += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+		}
+
+		bool ParseString(std::string& text)
+		{
+			++p;
+			while (p < end)
+			{
+				// Runs without escapes are copied whole
+				const char* run = p;
+				while (p < end && *p != '"' && *p != '\\')
+				{
+					++p;
+				}
+				text.append(run, p - run);
+				if (p >= end)
+					return false;
+				if (*p++ == '"')
+					return true;
+
+				if (p >= end)
+					return false;
+				char escape = *p++;
+				switch (escape)
+				{
+				case '"': text += '"'; break;
+				case '\\': text += '\\'; break;
+				case '/': text += '/'; break;
+				case 'b': text += '\b'; break;
+				case 'f': text += '\f'; break;
+				case 'n': text += '\n'; break;
+				case 'r': text += '\r'; break;
+				case 't': text += '\t'; break;
+				case 'u':
+				{
+					uint32_t codePoint = 0;
+					if (!ParseHex(codePoint))
+						return false;
+
+					// A surrogate pair for code points past the first plane
+					uint32_t low = 0;
+					if (codePoint >= 0xD800 && codePoint < 0xDC00 && end - p >= 2 && p[0] == '\\' && p[1] == 'u')
+					{
+						p += 2;
+						if (!ParseHex(low) || low < 0xDC00 || low >= 0xE000)
+							return false;
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+					}
+					AppendUtf8(codePoint, text);
+					break;
+				}
+				default:
+					return false;
+				}
+			}
+			return false;
+		}
+
+		const char* p;
+		const char* end;
+	};
+
+	// ---- glTF ----
+
+	// Column major, like glTF
+	using Matrix = std::array<float, 16>;
+
+	constexpr Matrix IdentityMatrix = { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+
+	Matrix Multiply(const Matrix& a, const Matrix& b)
+	{
+		Matrix result = {};
+		for (size_t column = 0; column < 4; ++column)
+		{
+			for (size_t row = 0; row < 4; ++row)
+			{
+				float sum = 0.0f;
+				for (size_t k = 0; k < 4; ++k)
+				{
+					sum += a[k * 4 + row] * b[column * 4 + k];
+				}
+				result[column * 4 + row] = sum;
+			}
+		}
+		return result;
+	}
+
+	// Translation, rotation and scale of a node, or its matrix
+	Matrix GetNodeMatrix(const JsonValue& node)
+	{
+		const std::vector<JsonValue>& elements = node.GetArray("matrix");
+		if (elements.size() == 16)
+		{
+			Matrix matrix;
+			for (size_t i = 0; i < 16; ++i)
+			{
+				matrix[i] = static_cast<float>(elements[i].number);
+			}
+			return matrix;
+		}
+
+		auto read = [&](std::string_view key, std::initializer_list<float> fallback)
+			{
+				std::array<float, 4> values = {};
+				std::copy(fallback.begin(), fallback.end(), values.begin());
+				const std::vector<JsonValue>& array = node.GetArray(key);
+				if (array.size() == fallback.size())
+				{
+					for (size_t i = 0; i < array.size(); ++i)
+					{
+						values[i] = static_cast<float>(array[i].number);
+					}
+				}
+				return values;
+			};
+		std::array<float, 4> t = read("translation", { 0.0f, 0.0f, 0.0f });
+		std::array<float, 4> r = read("rotation", { 0.0f, 0.0f, 0.0f, 1.0f });
+		std::array<float, 4> s = read("scale", { 1.0f, 1.0f, 1.0f });
+
+		float x = r[0], y = r[1], z = r[2], w = r[3];
+		return
+		{
+			(1.0f - 2.0f * (y * y + z * z)) * s[0], 2.0f * (x * y + z * w) * s[0], 2.0f * (x * z - y * w) * s[0], 0.0f,
+			2.0f * (x * y - z * w) * s[1], (1.0f - 2.0f * (x * x + z * z)) * s[1], 2.0f * (y * z + x * w) * s[1], 0.0f,
+			2.0f * (x * z + y * w) * s[2], 2.0f * (y * z - x * w) * s[2], (1.0f - 2.0f * (x * x + y * y)) * s[2], 0.0f,
+			t[0], t[1], t[2], 1.0f
+		};
+	}
+
+	struct MeshInstance
+	{
+		size_t mesh = 0;
+		Matrix world = IdentityMatrix;
+	};
+
+	void VisitNode(const std::vector<JsonValue>& nodes, int64_t node, const Matrix& parent, int32_t depth, std::vector<MeshInstance>& instances)
+	{
+		// Nodes form a forest, a cycle is a malformed file and is cut off
+		if (node < 0 || node >= static_cast<int64_t>(nodes.size()) || depth > 64)
+			return;
+
+		Matrix world = Multiply(parent, GetNodeMatrix(nodes[node]));
+		int64_t mesh = nodes[node].GetIndex("mesh", -1);
+		if (mesh >= 0)
+		{
+			instances.push_back({ static_cast<size_t>(mesh), world });
+		}
+
+		for (const JsonValue& child : nodes[node].GetArray("children"))
+		{
+			VisitNode(nodes, child.type == JsonValue::Type::Number ? static_cast<int64_t>(child.number) : -1, world, depth + 1, instances);
+		}
+	}
+
+	// Accessor component types
+	constexpr uint32_t ComponentByte = 5120;
+	constexpr uint32_t ComponentUnsignedByte = 5121;
+	constexpr uint32_t ComponentShort = 5122;
+	constexpr uint32_t ComponentUnsignedShort = 5123;
+	constexpr uint32_t ComponentUnsignedInt = 5125;
+	constexpr uint32_t ComponentFloat = 5126;
+
+	// Buffer view strides are multiples of 4 up to this
+	constexpr int64_t MaxByteStride = 252;
+
+	uint32_t GetComponentSize(uint32_t componentType)
+	{
+		switch (componentType)
+		{
+		case ComponentByte:
+		case ComponentUnsignedByte:
+			return 1;
+		case ComponentShort:
+		case ComponentUnsignedShort:
+			return 2;
+		case ComponentUnsignedInt:
+		case ComponentFloat:
+			return 4;
+		default:
+			return 0;
+		}
+	}
+
+	uint32_t GetComponentCount(const std::string& type)
+	{
+		if (type == "SCALAR") return 1;
+		if (type == "VEC2") return 2;
+		if (type == "VEC3") return 3;
+		if (type == "VEC4" || type == "MAT2") return 4;
+		if (type == "MAT3") return 9;
+		if (type == "MAT4") return 16;
+		return 0;
+	}
+
+	// A typed view of a buffer, checked to lie within it
+	struct Accessor
+	{
+		const uint8_t* data = nullptr; // Null for accessors without a buffer view, which read as zeros
+		size_t count = 0;
+		size_t stride = 0;
+		uint32_t componentType = 0;
+		uint32_t components = 0;
+		bool normalized = false;
+
+		// Normalized integers map to [0, 1] or [-1, 1]
+		float Read(size_t element, uint32_t component) const
+		{
+			if (!data)
+				return 0.0f;
+
+			const uint8_t* source = data + element * stride + component * GetComponentSize(componentType);
+			switch (componentType)
+			{
+			case ComponentFloat:
+			{
+				float value;
+				memcpy(&value, source, sizeof(value));
+				return value;
+			}
+			case ComponentUnsignedByte:
+				return normalized ? *source / 255.0f : *source;
+			case ComponentByte:
+			{
+				int8_t value = static_cast<int8_t>(*source);
+				return normalized ? std::max(value / 127.0f, -1.0f) : value;
+			}
+			case ComponentUnsignedShort:
+			{
+				uint16_t value;
+				memcpy(&value, source, sizeof(value));
+				return normalized ? value / 65535.0f : value;
+			}
+			case ComponentShort:
+			{
+				int16_t value;
+				memcpy(&value, source, sizeof(value));
+				return normalized ? std::max(value / 32767.0f, -1.0f) : value;
+			}
+			case ComponentUnsignedInt:
+			{
+				uint32_t value;
+				memcpy(&value, source, sizeof(value));
+				return static_cast<float>(value);
+			}
+			default:
+				return 0.0f;
+			}
+		}
+
+		uint32_t ReadIndex(size_t element) const
+		{
+			if (!data)
+				return 0;
+
+			const uint8_t* source = data + element * stride;
+			switch (componentType)
+			{
+			case ComponentUnsignedByte:
+				return *source;
+			case ComponentUnsignedShort:
+			{
+				uint16_t value;
+				memcpy(&value, source, sizeof(value));
+				return value;
+			}
+			case ComponentUnsignedInt:
+			{
+				uint32_t value;
+				memcpy(&value, source, sizeof(value));
+				return value;
+			}
+			default:
+				return 0;
+			}
+		}
+	};
+
+	struct GltfFile
+	{
+		const JsonValue* root = nullptr;
+		std::vector<BlackJawz::Scene::Blob> buffers;
+	};
+
+	bool GetAccessor(const GltfFile& file, int64_t index, Accessor& accessor, std::string& error)
+	{
+		const std::vector<JsonValue>& accessors = file.root->GetArray("accessors");
+		if (index < 0 || index >= static_cast<int64_t>(accessors.size()))
+		{
+			error = "Accessor " + std::to_string(index) + " does not exist";
+			return false;
+		}
+
+		const JsonValue& json = accessors[index];
+		if (json.Find("sparse"))
+		{
+			error = "Sparse accessors are not supported";
+			return false;
+		}
+
+		accessor.componentType = static_cast<uint32_t>(json.GetIndex("componentType", 0));
+		accessor.components = GetComponentCount(json.GetString("type"));
+		accessor.count = static_cast<size_t>(json.GetIndex("count", 0));
+		const JsonValue* normalized = json.Find("normalized");
+		accessor.normalized = normalized && normalized->boolean;
+
+		uint32_t componentSize = GetComponentSize(accessor.componentType);
+		size_t elementSize = static_cast<size_t>(componentSize) * accessor.components;
+		if (elementSize == 0)
+		{
+			error = "Accessor " + std::to_string(index) + " has an unknown type";
+			return false;
+		}
+		accessor.stride = elementSize;
+
+		int64_t viewIndex = json.GetIndex("bufferView", -1);
+		if (viewIndex < 0)
+			return true;
+
+		const std::vector<JsonValue>& views = file.root->GetArray("bufferViews");
+		int64_t bufferIndex = viewIndex < static_cast<int64_t>(views.size()) ? views[viewIndex].GetIndex("buffer", -1) : -1;
+		if (bufferIndex < 0 || bufferIndex >= static_cast<int64_t>(file.buffers.size()))
+		{
+			error = "Accessor " + std::to_string(index) + " has no buffer";
+			return false;
+		}
+
+		const JsonValue& view = views[viewIndex];
+		const BlackJawz::Scene::Blob& buffer = file.buffers[bufferIndex];
+		uint64_t viewOffset = static_cast<uint64_t>(view.GetIndex("byteOffset", 0));
+		uint64_t viewLength = static_cast<uint64_t>(view.GetIndex("byteLength", 0));
+		uint64_t offset = static_cast<uint64_t>(json.GetIndex("byteOffset", 0));
+		if (view.Find("byteStride"))
+		{
+			int64_t stride = view.GetIndex("byteStride", -1);
+			if (stride < static_cast<int64_t>(elementSize) || stride > MaxByteStride || stride % 4 != 0)
+			{
+				error = "Accessor " + std::to_string(index) + " has an invalid byte stride";
+				return false;
+			}
+			accessor.stride = static_cast<size_t>(stride);
+		}
+
+		// The last element has to end within the view, and the view within the buffer. Divided rather than
+		// multiplied, so a large count cannot wrap around.
+		bool fits = viewOffset <= buffer.size && viewLength <= buffer.size - viewOffset;
+		if (fits && accessor.count > 0)
+		{
+			fits = offset <= viewLength && elementSize <= viewLength - offset &&
+				static_cast<uint64_t>(accessor.count - 1) <= (viewLength - offset - elementSize) / accessor.stride;
+		}
+		if (!fits)
+		{
+			error = "Accessor " + std::to_string(index) + " reaches past its buffer";
+			return false;
+		}
+
+		accessor.data = buffer.data + viewOffset + offset;
+		return true;
+	}
+
+	std::string DecodeUri(const std::string& uri)
+	{
+		std::string path;
+		for (size_t i = 0; i < uri.size(); ++i)
+		{
+			uint32_t value = 0;
+			if (uri[i] == '%' && i + 2 < uri.size() && std::from_chars(uri.data() + i + 1, uri.data() + i + 3, value, 16).ptr == uri.data() + i + 3)
+			{
+				path += static_cast<char>(value);
+				i += 2;
+			}
+			else
+			{
+				path += uri[i];
+			}
+		}
+		return path;
+	}
+
+	// Digit values by character, -1 for characters that are not digits
+	struct Base64Table
+	{
+		int8_t values[256];
+
+		constexpr Base64Table() : values()
+		{
+			const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			for (int32_t i = 0; i < 256; ++i)
+			{
+				values[i] = -1;
+			}
+			for (int32_t i = 0; i < 64; ++i)
+			{
+				values[static_cast<uint8_t>(digits[i])] = static_cast<int8_t>(i);
+			}
+		}
+	};
+	constexpr Base64Table Base64Digits;
+
+	// Groups of four digits decode to three bytes independently, so ranges of groups decode as jobs
+	bool DecodeBase64(std::string_view text, std::vector<uint8_t>& bytes, BlackJawz::Jobs::JobSystem* jobSystem)
+	{
+		if (text.size() % 4 != 0)
+			return false;
+
+		size_t padding = 0;
+		while (padding < 2 && padding < text.size() && text[text.size() - 1 - padding] == '=')
+		{
+			++padding;
+		}
+
+		size_t groupCount = text.size() / 4;
+		bytes.resize(groupCount * 3);
+		std::atomic<bool> valid = true;
+		ParallelFor(jobSystem, groupCount, 256 * 1024, [&](size_t begin, size_t end)
+			{
+				for (size_t group = begin; group < end; ++group)
+				{
+					const char* digits = text.data() + group * 4;
+					bool last = group + 1 == groupCount;
+					int32_t values[4];
+					for (size_t i = 0; i < 4; ++i)
+					{
+						values[i] = last && i >= 4 - padding ? 0 : Base64Digits.values[static_cast<uint8_t>(digits[i])];
+					}
+					if ((values[0] | values[1] | values[2] | values[3]) < 0)
+					{
+						valid = false;
+						return;
+					}
+
+					uint32_t bits = (values[0] << 18) | (values[1] << 12) | (values[2] << 6) | values[3];
+					bytes[group * 3] = static_cast<uint8_t>(bits >> 16);
+					bytes[group * 3 + 1] = static_cast<uint8_t>(bits >> 8);
+					bytes[group * 3 + 2] = static_cast<uint8_t>(bits);
+				}
+			});
+		bytes.resize(bytes.size() - padding);
+		return valid;
+	}
+
+	std::string GetImagePath(const JsonValue& root, const JsonValue* textureInfo)
+	{
+		int64_t texture = textureInfo ? textureInfo->GetIndex("index", -1) : -1;
+		const std::vector<JsonValue>& textures = root.GetArray("textures");
+		if (texture < 0 || texture >= static_cast<int64_t>(textures.size()))
+			return std::string();
+
+		int64_t image = textures[texture].GetIndex("source", -1);
+		const std::vector<JsonValue>& images = root.GetArray("images");
+		if (image < 0 || image >= static_cast<int64_t>(images.size()))
+			return std::string();
+
+		// Embedded images have no path
+		std::string uri = images[image].GetString("uri");
+		return uri.rfind("data:", 0) == 0 ? std::string() : DecodeUri(uri);
+	}
+
+	BlackJawz::Scene::ImportedMaterial ReadGltfMaterial(const JsonValue& root, const JsonValue& json)
+	{
+		using BlackJawz::Scene::TextureSlot;
+
+		BlackJawz::Scene::ImportedMaterial material;
+		material.name = json.GetString("name");
+		material.metallic = 1.0f;
+
+		if (const JsonValue* pbr = json.Find("pbrMetallicRoughness"))
+		{
+			const std::vector<JsonValue>& colour = pbr->GetArray("baseColorFactor");
+			for (size_t i = 0; i < 4 && colour.size() == 4; ++i)
+			{
+				material.baseColour[i] = static_cast<float>(colour[i].number);
+			}
+			material.metallic = static_cast<float>(pbr->GetNumber("metallicFactor", 1.0));
+			material.roughness = static_cast<float>(pbr->GetNumber("roughnessFactor", 1.0));
+			material.textures[static_cast<size_t>(TextureSlot::Diffuse)] = GetImagePath(root, pbr->Find("baseColorTexture"));
+			material.metalRoughnessTexture = GetImagePath(root, pbr->Find("metallicRoughnessTexture"));
+		}
+		material.textures[static_cast<size_t>(TextureSlot::Normal)] = GetImagePath(root, json.Find("normalTexture"));
+		material.textures[static_cast<size_t>(TextureSlot::AO)] = GetImagePath(root, json.Find("occlusionTexture"));
+		return material;
+	}
+
+	// One primitive of one mesh instance, converted as a job
+	struct GltfPrimitive
+	{
+		const JsonValue* json = nullptr;
+		Matrix world = IdentityMatrix;
+		std::string name;
+		BlackJawz::Scene::ImportedMesh mesh;
+		bool skipped = false; // Points or lines
+		std::string error;
+	};
+
+	bool ConvertPrimitive(const GltfFile& file, GltfPrimitive& primitive, BlackJawz::Jobs::JobSystem* jobSystem)
+	{
+		const JsonValue& json = *primitive.json;
+		int64_t mode = json.GetIndex("mode", 4);
+		if (mode < 4 || mode > 6)
+		{
+			primitive.skipped = true;
+			return true;
+		}
+
+		const JsonValue* attributes = json.Find("attributes");
+		int64_t positionIndex = attributes ? attributes->GetIndex("POSITION", -1) : -1;
+		if (positionIndex < 0)
+		{
+			primitive.skipped = true;
+			return true;
+		}
+
+		Accessor positions, normals, texCs, tangents, indexAccessor;
+		if (!GetAccessor(file, positionIndex, positions, primitive.error))
+			return false;
+
+		bool hasNormals = attributes->GetIndex("NORMAL", -1) >= 0;
+		bool hasTexCs = attributes->GetIndex("TEXCOORD_0", -1) >= 0;
+		bool hasTangents = hasNormals && attributes->GetIndex("TANGENT", -1) >= 0;
+		if ((hasNormals && !GetAccessor(file, attributes->GetIndex("NORMAL", -1), normals, primitive.error)) ||
+			(hasTexCs && !GetAccessor(file, attributes->GetIndex("TEXCOORD_0", -1), texCs, primitive.error)) ||
+			(hasTangents && !GetAccessor(file, attributes->GetIndex("TANGENT", -1), tangents, primitive.error)))
+			return false;
+
+		size_t vertexCount = positions.count;
+		if (positions.components != 3 || (hasNormals && (normals.components != 3 || normals.count < vertexCount)) ||
+			(hasTexCs && (texCs.components != 2 || texCs.count < vertexCount)) ||
+			(hasTangents && (tangents.components != 4 || tangents.count < vertexCount)))
+		{
+			primitive.error = "Mesh attributes do not match the vertex count or their types";
+			return false;
+		}
+
+		// The index list, or every vertex in order
+		int64_t indicesIndex = json.GetIndex("indices", -1);
+		if (indicesIndex >= 0 && !GetAccessor(file, indicesIndex, indexAccessor, primitive.error))
+			return false;
+		size_t listCount = indicesIndex >= 0 ? indexAccessor.count : vertexCount;
+		if (indicesIndex >= 0 && (indexAccessor.components != 1 || indexAccessor.componentType == ComponentFloat))
+		{
+			primitive.error = "Mesh indices are not integers";
+			return false;
+		}
+
+		std::vector<uint32_t> list(listCount);
+		std::atomic<bool> indicesValid = true;
+		ParallelFor(jobSystem, listCount, VertexGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					list[i] = indicesIndex >= 0 ? indexAccessor.ReadIndex(i) : static_cast<uint32_t>(i);
+					if (list[i] >= vertexCount)
+					{
+						indicesValid = false;
+					}
+				}
+			});
+		if (!indicesValid)
+		{
+			primitive.error = "Mesh indices reach past its vertices";
+			return false;
+		}
+
+		// Strips and fans become lists, counter clockwise like the rest of glTF
+		std::vector<uint32_t> triangles;
+		if (mode == 4)
+		{
+			list.resize(list.size() / 3 * 3);
+			triangles = std::move(list);
+		}
+		else
+		{
+			for (size_t i = 2; i < list.size(); ++i)
+			{
+				if (mode == 5)
+				{
+					bool odd = (i & 1) != 0;
+					triangles.insert(triangles.end(), { list[i - 2], list[odd ? i : i - 1], list[odd ? i - 1 : i] });
+				}
+				else
+				{
+					triangles.insert(triangles.end(), { list[0], list[i - 1], list[i] });
+				}
+			}
+		}
+		if (triangles.empty())
+		{
+			primitive.skipped = true;
+			return true;
+		}
+
+		// Without normals every triangle is flat shaded, so each corner gets its own vertex
+		std::vector<uint32_t> sourceVertices;
+		if (!hasNormals)
+		{
+			sourceVertices = std::move(triangles);
+			triangles = std::vector<uint32_t>(sourceVertices.size());
+			for (size_t i = 0; i < triangles.size(); ++i)
+			{
+				triangles[i] = static_cast<uint32_t>(i);
+			}
+			vertexCount = sourceVertices.size();
+		}
+
+		// Normals go through the inverse transpose, the cofactors up to the sign of the determinant.
+		// Mirroring transforms turn the winding over.
+		const Matrix& m = primitive.world;
+		const float* axes[3] = { &m[0], &m[4], &m[8] };
+		float cofactors[3][3];
+		Cross(axes[1], axes[2], cofactors[0]);
+		Cross(axes[2], axes[0], cofactors[1]);
+		Cross(axes[0], axes[1], cofactors[2]);
+		float determinant = Dot(axes[0], cofactors[0]);
+		float normalSign = determinant < 0.0f ? -1.0f : 1.0f;
+
+		BlackJawz::Scene::ImportedMesh& mesh = primitive.mesh;
+		mesh.vertices.resize(vertexCount);
+		ParallelFor(jobSystem, vertexCount, VertexGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					size_t source = sourceVertices.empty() ? i : sourceVertices[i];
+					BlackJawz::Scene::ImportedVertex& vertex = mesh.vertices[i];
+
+					float position[3] = { positions.Read(source, 0), positions.Read(source, 1), positions.Read(source, 2) };
+					for (size_t row = 0; row < 3; ++row)
+					{
+						vertex.position[row] = m[row] * position[0] + m[4 + row] * position[1] + m[8 + row] * position[2] + m[12 + row];
+					}
+
+					float normal[3] = { normals.Read(source, 0), normals.Read(source, 1), normals.Read(source, 2) };
+					float tangent[3] = { tangents.Read(source, 0), tangents.Read(source, 1), tangents.Read(source, 2) };
+					for (size_t row = 0; row < 3; ++row)
+					{
+						vertex.normal[row] = (cofactors[0][row] * normal[0] + cofactors[1][row] * normal[1] + cofactors[2][row] * normal[2]) * normalSign;
+						vertex.tangent[row] = m[row] * tangent[0] + m[4 + row] * tangent[1] + m[8 + row] * tangent[2];
+					}
+					Normalize(vertex.normal);
+					Normalize(vertex.tangent);
+
+					vertex.texC[0] = texCs.Read(source, 0);
+					vertex.texC[1] = texCs.Read(source, 1);
+				}
+			});
+
+		size_t triangleCount = triangles.size() / 3;
+		if (determinant < 0.0f)
+		{
+			for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+			{
+				std::swap(triangles[triangle * 3 + 1], triangles[triangle * 3 + 2]);
+			}
+		}
+
+		if (!hasNormals)
+		{
+			ParallelFor(jobSystem, triangleCount, VertexGrain, [&](size_t begin, size_t end)
+				{
+					for (size_t triangle = begin; triangle < end; ++triangle)
+					{
+						BlackJawz::Scene::ImportedVertex* corners[3];
+						for (size_t corner = 0; corner < 3; ++corner)
+						{
+							corners[corner] = &mesh.vertices[triangles[triangle * 3 + corner]];
+						}
+
+						float normal[3];
+						FaceNormal(corners[0]->position, corners[1]->position, corners[2]->position, normal);
+						Normalize(normal);
+						for (BlackJawz::Scene::ImportedVertex* corner : corners)
+						{
+							memcpy(corner->normal, normal, sizeof(normal));
+						}
+					}
+				});
+		}
+
+		// Into the editor's left handed space
+		ParallelFor(jobSystem, vertexCount, VertexGrain, [&](size_t begin, size_t end)
+			{
+				for (size_t i = begin; i < end; ++i)
+				{
+					mesh.vertices[i].position[2] = -mesh.vertices[i].position[2];
+					mesh.vertices[i].normal[2] = -mesh.vertices[i].normal[2];
+					mesh.vertices[i].tangent[2] = -mesh.vertices[i].tangent[2];
+				}
+			});
+
+		mesh.indices.resize(triangles.size());
+		for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+		{
+			mesh.indices[triangle * 3] = triangles[triangle * 3];
+			mesh.indices[triangle * 3 + 1] = triangles[triangle * 3 + 2];
+			mesh.indices[triangle * 3 + 2] = triangles[triangle * 3 + 1];
+		}
+
+		if (!hasTangents)
+		{
+			ComputeTangents(mesh, jobSystem);
+		}
+
+		mesh.name = primitive.name;
+		mesh.material = static_cast<int32_t>(json.GetIndex("material", -1));
+		if (mesh.material >= static_cast<int32_t>(file.root->GetArray("materials").size()))
+		{
+			mesh.material = -1;
+		}
+		mesh.bounds = MeasureBounds(mesh.vertices);
+		return true;
+	}
+}
+
+std::optional<BlackJawz::Scene::MeshFileType> BlackJawz::Scene::GetMeshFileType(const std::string& filename)
+{
+	std::string extension = std::filesystem::path(filename).extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+	if (extension == ".obj")
+		return MeshFileType::Obj;
+	if (extension == ".gltf")
+		return MeshFileType::Gltf;
+	if (extension == ".glb")
+		return MeshFileType::Glb;
+	return std::nullopt;
+}
+
+BlackJawz::Scene::MeshImporter::MeshImporter(Jobs::JobSystem* jobSystem, size_t chunkBytes)
+	: jobSystem(jobSystem), chunkBytes(std::max<size_t>(chunkBytes, 1))
+{
+}
+
+bool BlackJawz::Scene::MeshImporter::Import(const std::string& filename, ImportedModel& model, MeshImportStats& stats)
+{
+	auto start = std::chrono::steady_clock::now();
+	stats = MeshImportStats();
+
+	std::optional<MeshFileType> type = GetMeshFileType(filename);
+	if (!type)
+	{
+		lastError = filename + " is not an OBJ or glTF file";
+		return false;
+	}
+
+	Blob data;
+	if (!SceneReader::MapFile(filename, data))
+	{
+		lastError = "Cannot read " + filename;
+		return false;
+	}
+	double mapMs = ElapsedMs(start);
+
+	if (!ImportMemory(data, *type, GetBaseDirectory(filename), model, stats))
+		return false;
+
+	stats.mapMs += mapMs;
+	stats.totalMs = ElapsedMs(start);
+	return true;
+}
+
+bool BlackJawz::Scene::MeshImporter::ImportMemory(const Blob& data, MeshFileType type, const std::string& baseDirectory,
+	ImportedModel& model, MeshImportStats& stats)
+{
+	auto start = std::chrono::steady_clock::now();
+	model = ImportedModel();
+	stats = MeshImportStats();
+	stats.fileBytes = data.size;
+	lastError.clear();
+
+	bool imported = false;
+	switch (type)
+	{
+	case MeshFileType::Obj:
+		imported = ImportObj(data, baseDirectory, model, stats);
+		break;
+	case MeshFileType::Gltf:
+		imported = ImportGltf(data, Blob(), baseDirectory, model, stats);
+		break;
+	case MeshFileType::Glb:
+		imported = ImportGlb(data, baseDirectory, model, stats);
+		break;
+	}
+	if (!imported)
+	{
+		model = ImportedModel();
+		return false;
+	}
+
+	if (model.meshes.empty())
+	{
+		lastError = "The file has no triangles";
+		return false;
+	}
+
+	stats.meshCount = model.meshes.size();
+	for (const ImportedMesh& mesh : model.meshes)
+	{
+		stats.vertexCount += mesh.vertices.size();
+		stats.triangleCount += mesh.indices.size() / 3;
+	}
+	stats.totalMs = ElapsedMs(start);
+	return true;
+}
+
+bool BlackJawz::Scene::MeshImporter::ImportObj(const Blob& data, const std::string& baseDirectory, ImportedModel& model, MeshImportStats& stats)
+{
+	auto parseStart = std::chrono::steady_clock::now();
+
+	// Chunks end at line breaks, so every line is parsed whole by one job
+	const char* text = reinterpret_cast<const char*>(data.data);
+	const char* textEnd = text + data.size;
+	std::vector<ObjChunk> chunks;
+	for (const char* begin = text; begin < textEnd;)
+	{
+		const char* end = static_cast<size_t>(textEnd - begin) > chunkBytes ? begin + chunkBytes : textEnd;
+		if (end < textEnd)
+		{
+			const char* lineEnd = static_cast<const char*>(memchr(end, '\n', textEnd - end));
+			end = lineEnd ? lineEnd + 1 : textEnd;
+		}
+		chunks.emplace_back();
+		chunks.back().begin = begin;
+		chunks.back().end = end;
+		begin = end;
+	}
+	stats.chunks = chunks.size();
+
+	ParallelFor(jobSystem, chunks.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				ParseObjChunk(chunks[i], text);
+			}
+		});
+
+	// Lists are numbered across the whole file, each chunk's start in them
+	int32_t totals[3] = { 0, 0, 0 };
+	std::vector<std::array<int32_t, 3>> bases(chunks.size());
+	std::vector<size_t> triangleBases(chunks.size());
+	size_t triangleTotal = 0;
+	bool missingNormals = false;
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		if (!chunks[i].error.empty())
+		{
+			lastError = chunks[i].error + " at byte " + std::to_string(chunks[i].errorOffset);
+			return false;
+		}
+
+		size_t counts[3] = { chunks[i].positions.size() / 3, chunks[i].texCs.size() / 2, chunks[i].normals.size() / 3 };
+		for (size_t k = 0; k < 3; ++k)
+		{
+			bases[i][k] = totals[k];
+			if (counts[k] > static_cast<size_t>(INT32_MAX - totals[k]))
+			{
+				lastError = "Too many vertices";
+				return false;
+			}
+			totals[k] += static_cast<int32_t>(counts[k]);
+		}
+		triangleBases[i] = triangleTotal;
+		triangleTotal += chunks[i].corners.size() / 3;
+		missingNormals |= chunks[i].missingNormals;
+	}
+
+	// Generated normals go after the file's, one per position
+	size_t generatedNormalBase = static_cast<size_t>(totals[2]);
+	std::vector<float> positions(static_cast<size_t>(totals[0]) * 3);
+	std::vector<float> texCs(static_cast<size_t>(totals[1]) * 2);
+	std::vector<float> normals((generatedNormalBase + (missingNormals ? totals[0] : 0)) * 3, 0.0f);
+
+	std::vector<VertexKey> cornerKeys(triangleTotal * 3);
+	std::atomic<bool> indicesValid = true;
+	ParallelFor(jobSystem, chunks.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				ObjChunk& chunk = chunks[i];
+				std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + static_cast<size_t>(bases[i][0]) * 3);
+				std::copy(chunk.texCs.begin(), chunk.texCs.end(), texCs.begin() + static_cast<size_t>(bases[i][1]) * 2);
+				std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + static_cast<size_t>(bases[i][2]) * 3);
+
+				VertexKey* keys = cornerKeys.data() + triangleBases[i] * 3;
+				for (size_t c = 0; c < chunk.corners.size(); ++c)
+				{
+					const ObjCorner& corner = chunk.corners[c];
+					int32_t resolved[3] = { -1, -1, -1 };
+					for (size_t k = 0; k < 3; ++k)
+					{
+						if (!(corner.present & (1 << k)))
+							continue;
+
+						int64_t index = static_cast<int64_t>(corner.index[k]) + ((corner.relative & (1 << k)) ? bases[i][k] : 0);
+						if (index < 0 || index >= totals[k])
+						{
+							indicesValid = false;
+							continue;
+						}
+						resolved[k] = static_cast<int32_t>(index);
+					}
+
+					// Faces without normals take the smoothed normal of the position
+					if (resolved[2] < 0 && resolved[0] >= 0)
+					{
+						resolved[2] = static_cast<int32_t>(generatedNormalBase) + resolved[0];
+					}
+					keys[c] = { resolved[0], resolved[1], resolved[2] };
+				}
+
+				// Freed early, the welded meshes take their place
+				chunk.positions = std::vector<float>();
+				chunk.texCs = std::vector<float>();
+				chunk.normals = std::vector<float>();
+				chunk.corners = std::vector<ObjCorner>();
+			}
+		});
+	if (!indicesValid)
+	{
+		lastError = "A face refers to a vertex that does not exist";
+		return false;
+	}
+	stats.parseMs = ElapsedMs(parseStart);
+
+	auto buildStart = std::chrono::steady_clock::now();
+	if (missingNormals)
+	{
+		// Summed over the faces without normals at the position, area weighted by the unnormalized cross product
+		float* generated = normals.data() + generatedNormalBase * 3;
+		for (size_t triangle = 0; triangle < triangleTotal; ++triangle)
+		{
+			const VertexKey* keys = &cornerKeys[triangle * 3];
+			if (std::max({ keys[0].normal, keys[1].normal, keys[2].normal }) < static_cast<int32_t>(generatedNormalBase))
+				continue;
+
+			float normal[3];
+			FaceNormal(&positions[static_cast<size_t>(keys[0].position) * 3], &positions[static_cast<size_t>(keys[1].position) * 3],
+				&positions[static_cast<size_t>(keys[2].position) * 3], normal);
+			for (size_t corner = 0; corner < 3; ++corner)
+			{
+				float* sum = generated + static_cast<size_t>(keys[corner].position) * 3;
+				sum[0] += normal[0];
+				sum[1] += normal[1];
+				sum[2] += normal[2];
+			}
+		}
+	}
+
+	// Material libraries are small, read in order so the first definition of a name wins
+	std::map<std::string, int32_t> materialIndices;
+	std::vector<std::string> libraries;
+	for (const ObjChunk& chunk : chunks)
+	{
+		libraries.insert(libraries.end(), chunk.materialLibraries.begin(), chunk.materialLibraries.end());
+	}
+	for (const std::string& library : libraries)
+	{
+		Blob libraryData;
+		if (!SceneReader::MapFile(JoinPath(baseDirectory, library), libraryData))
+			continue;
+
+		std::vector<ImportedMaterial> materials;
+		ParseMaterialLibrary(libraryData, materials);
+		for (ImportedMaterial& material : materials)
+		{
+			if (materialIndices.emplace(material.name, static_cast<int32_t>(model.materials.size())).second)
+			{
+				model.materials.push_back(std::move(material));
+			}
+		}
+	}
+
+	// One mesh per object and material, made of pieces that each lie in one chunk
+	std::map<std::pair<std::string, std::string>, size_t> meshIndices;
+	std::vector<ObjPiece> pieces;
+	std::string objectName;
+	std::string materialName;
+	auto addPiece = [&](size_t chunk, size_t first, size_t last)
+		{
+			if (last <= first)
+				return;
+
+			auto [mesh, added] = meshIndices.emplace(std::make_pair(objectName, materialName), model.meshes.size());
+			if (added)
+			{
+				model.meshes.emplace_back();
+				model.meshes.back().name = objectName.empty() ? materialName : objectName;
+				if (!materialName.empty())
+				{
+					auto [material, newMaterial] = materialIndices.emplace(materialName, static_cast<int32_t>(model.materials.size()));
+					if (newMaterial)
+					{
+						model.materials.emplace_back();
+						model.materials.back().name = materialName;
+					}
+					model.meshes.back().material = material->second;
+				}
+			}
+
+			ObjPiece piece;
+			piece.chunk = chunk;
+			piece.firstTriangle = triangleBases[chunk] + first;
+			piece.triangleCount = last - first;
+			piece.mesh = mesh->second;
+			pieces.push_back(std::move(piece));
+		};
+	for (size_t i = 0; i < chunks.size(); ++i)
+	{
+		size_t chunkTriangles = (i + 1 < chunks.size() ? triangleBases[i + 1] : triangleTotal) - triangleBases[i];
+		size_t first = 0;
+		for (const ObjGroupChange& change : chunks[i].changes)
+		{
+			addPiece(i, first, change.firstTriangle);
+			first = change.firstTriangle;
+			(change.material ? materialName : objectName) = change.name;
+		}
+		addPiece(i, first, chunkTriangles);
+	}
+
+	// Welded within each piece in parallel, which leaves the meshes only the pieces' vertices to weld
+	ParallelFor(jobSystem, pieces.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				ObjPiece& piece = pieces[i];
+				size_t cornerCount = piece.triangleCount * 3;
+				VertexTable table(cornerCount);
+				piece.indices.resize(cornerCount);
+				const VertexKey* keys = &cornerKeys[piece.firstTriangle * 3];
+				for (size_t corner = 0; corner < cornerCount; ++corner)
+				{
+					piece.indices[corner] = table.Insert(keys[corner], piece.keys);
+				}
+			}
+		});
+	cornerKeys = std::vector<VertexKey>();
+
+	std::vector<std::vector<size_t>> meshPieces(model.meshes.size());
+	for (size_t i = 0; i < pieces.size(); ++i)
+	{
+		meshPieces[pieces[i].mesh].push_back(i);
+	}
+
+	ParallelFor(jobSystem, model.meshes.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t meshIndex = begin; meshIndex < end; ++meshIndex)
+			{
+				ImportedMesh& mesh = model.meshes[meshIndex];
+				size_t keyCount = 0;
+				size_t cornerCount = 0;
+				for (size_t i : meshPieces[meshIndex])
+				{
+					keyCount += pieces[i].keys.size();
+					cornerCount += pieces[i].indices.size();
+				}
+
+				VertexTable table(keyCount);
+				std::vector<VertexKey> keys;
+				keys.reserve(keyCount);
+				mesh.indices.resize(cornerCount);
+				uint32_t* out = mesh.indices.data();
+				std::vector<uint32_t> remap;
+				for (size_t i : meshPieces[meshIndex])
+				{
+					ObjPiece& piece = pieces[i];
+					remap.resize(piece.keys.size());
+					for (size_t key = 0; key < piece.keys.size(); ++key)
+					{
+						remap[key] = table.Insert(piece.keys[key], keys);
+					}
+
+					// Winding reversed along with Z
+					for (size_t corner = 0; corner < piece.indices.size(); corner += 3)
+					{
+						*out++ = remap[piece.indices[corner]];
+						*out++ = remap[piece.indices[corner + 2]];
+						*out++ = remap[piece.indices[corner + 1]];
+					}
+					piece.keys = std::vector<VertexKey>();
+					piece.indices = std::vector<uint32_t>();
+				}
+
+				mesh.vertices.resize(keys.size());
+				ParallelFor(jobSystem, keys.size(), VertexGrain, [&](size_t first, size_t last)
+					{
+						for (size_t i = first; i < last; ++i)
+						{
+							const VertexKey& key = keys[i];
+							ImportedVertex& vertex = mesh.vertices[i];
+							const float* position = &positions[static_cast<size_t>(key.position) * 3];
+							const float* normal = &normals[static_cast<size_t>(key.normal) * 3];
+
+							vertex.position[0] = position[0];
+							vertex.position[1] = position[1];
+							vertex.position[2] = -position[2];
+							vertex.normal[0] = normal[0];
+							vertex.normal[1] = normal[1];
+							vertex.normal[2] = -normal[2];
+							Normalize(vertex.normal);
+
+							vertex.texC[0] = key.texC >= 0 ? texCs[static_cast<size_t>(key.texC) * 2] : 0.0f;
+							vertex.texC[1] = key.texC >= 0 ? 1.0f - texCs[static_cast<size_t>(key.texC) * 2 + 1] : 0.0f;
+						}
+					});
+
+				ComputeTangents(mesh, jobSystem);
+				mesh.bounds = MeasureBounds(mesh.vertices);
+			}
+		});
+
+	stats.buildMs = ElapsedMs(buildStart);
+	return true;
+}
+
+bool BlackJawz::Scene::MeshImporter::ImportGlb(const Blob& data, const std::string& baseDirectory, ImportedModel& model, MeshImportStats& stats)
+{
+	constexpr uint32_t Magic = 0x46546C67; // "glTF"
+	constexpr uint32_t JsonChunk = 0x4E4F534A;
+	constexpr uint32_t BinaryChunk = 0x004E4942;
+
+	uint32_t header[3] = {};
+	if (data.size >= sizeof(header))
+	{
+		memcpy(header, data.data, sizeof(header));
+	}
+	if (header[0] != Magic || header[1] != 2 || header[2] > data.size)
+	{
+		lastError = "Not a glTF 2.0 binary file";
+		return false;
+	}
+
+	// The JSON chunk comes first, the binary chunk is optional
+	Blob json;
+	Blob binary;
+	for (uint64_t offset = sizeof(header); offset + 8 <= header[2];)
+	{
+		uint32_t chunk[2];
+		memcpy(chunk, data.data + offset, sizeof(chunk));
+		offset += sizeof(chunk);
+		if (chunk[0] > header[2] - offset)
+		{
+			lastError = "A glTF chunk reaches past the end of the file";
+			return false;
+		}
+
+		if (chunk[1] == JsonChunk && json.Empty())
+		{
+			json = data.Slice(data.data + offset, chunk[0]);
+		}
+		else if (chunk[1] == BinaryChunk && binary.Empty())
+		{
+			binary = data.Slice(data.data + offset, chunk[0]);
+		}
+		offset += (static_cast<uint64_t>(chunk[0]) + 3) & ~3ull;
+	}
+
+	if (json.Empty())
+	{
+		lastError = "The glTF binary file has no JSON";
+		return false;
+	}
+	return ImportGltf(json, binary, baseDirectory, model, stats);
+}
+
+bool BlackJawz::Scene::MeshImporter::ImportGltf(const Blob& json, const Blob& binaryChunk, const std::string& baseDirectory,
+	ImportedModel& model, MeshImportStats& stats)
+{
+	auto parseStart = std::chrono::steady_clock::now();
+
+	JsonValue root;
+	const char* text = reinterpret_cast<const char*>(json.data);
+	JsonParser parser(text, text + json.size);
+	if (!parser.Parse(root) || root.type != JsonValue::Type::Object)
+	{
+		lastError = "Bad JSON at byte " + std::to_string(parser.GetOffset(text));
+		return false;
+	}
+
+	const JsonValue* asset = root.Find("asset");
+	if (!asset || asset->GetString("version").rfind("2", 0) != 0)
+	{
+		lastError = "Not a glTF 2.0 file";
+		return false;
+	}
+
+	GltfFile file;
+	file.root = &root;
+	const std::vector<JsonValue>& buffers = root.GetArray("buffers");
+	for (size_t i = 0; i < buffers.size(); ++i)
+	{
+		std::string uri = buffers[i].GetString("uri");
+		uint64_t length = static_cast<uint64_t>(buffers[i].GetIndex("byteLength", 0));
+
+		Blob buffer;
+		if (uri.empty())
+		{
+			// Only the first buffer can be a .glb's binary chunk
+			buffer = i == 0 ? binaryChunk : Blob();
+		}
+		else if (uri.rfind("data:", 0) == 0)
+		{
+			size_t comma = uri.find(',');
+			std::vector<uint8_t> bytes;
+			if (comma == std::string::npos || uri.find(";base64") > comma ||
+				!DecodeBase64(std::string_view(uri).substr(comma + 1), bytes, jobSystem))
+			{
+				lastError = "Buffer " + std::to_string(i) + " is not valid base64";
+				return false;
+			}
+			buffer = Blob::FromVector(std::move(bytes));
+		}
+		else
+		{
+			std::string path = JoinPath(baseDirectory, DecodeUri(uri));
+			if (!SceneReader::MapFile(path, buffer))
+			{
+				lastError = "Cannot read " + path;
+				return false;
+			}
+			stats.fileBytes += buffer.size;
+		}
+
+		if (buffer.size < length)
+		{
+			lastError = "Buffer " + std::to_string(i) + " is shorter than its byteLength";
+			return false;
+		}
+		file.buffers.push_back(buffer);
+	}
+
+	for (const JsonValue& material : root.GetArray("materials"))
+	{
+		model.materials.push_back(ReadGltfMaterial(root, material));
+	}
+
+	// The default scene's nodes, each mesh once as it is when there are no scenes
+	std::vector<MeshInstance> instances;
+	const std::vector<JsonValue>& scenes = root.GetArray("scenes");
+	const std::vector<JsonValue>& meshes = root.GetArray("meshes");
+	if (scenes.empty())
+	{
+		for (size_t i = 0; i < meshes.size(); ++i)
+		{
+			instances.push_back({ i, IdentityMatrix });
+		}
+	}
+	else
+	{
+		int64_t scene = root.GetIndex("scene", 0);
+		const std::vector<JsonValue>& nodes = root.GetArray("nodes");
+		for (const JsonValue& node : scene < static_cast<int64_t>(scenes.size()) ? scenes[scene].GetArray("nodes") : scenes[0].GetArray("nodes"))
+		{
+			VisitNode(nodes, node.type == JsonValue::Type::Number ? static_cast<int64_t>(node.number) : -1, IdentityMatrix, 0, instances);
+		}
+	}
+
+	std::vector<GltfPrimitive> primitives;
+	for (const MeshInstance& instance : instances)
+	{
+		if (instance.mesh >= meshes.size())
+			continue;
+
+		const JsonValue& mesh = meshes[instance.mesh];
+		const std::vector<JsonValue>& meshPrimitives = mesh.GetArray("primitives");
+		for (size_t i = 0; i < meshPrimitives.size(); ++i)
+		{
+			GltfPrimitive primitive;
+			primitive.json = &meshPrimitives[i];
+			primitive.world = instance.world;
+			primitive.name = mesh.GetString("name");
+			if (meshPrimitives.size() > 1)
+			{
+				primitive.name += (primitive.name.empty() ? "" : " ") + std::to_string(i);
+			}
+			primitives.push_back(std::move(primitive));
+		}
+	}
+	stats.chunks = primitives.size();
+	stats.parseMs = ElapsedMs(parseStart);
+
+	// Every primitive is a job, large ones split their vertices into further jobs
+	auto buildStart = std::chrono::steady_clock::now();
+	ParallelFor(jobSystem, primitives.size(), 1, [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				ConvertPrimitive(file, primitives[i], jobSystem);
+			}
+		});
+
+	for (GltfPrimitive& primitive : primitives)
+	{
+		if (!primitive.error.empty())
+		{
+			lastError = primitive.error;
+			return false;
+		}
+
+		if (primitive.skipped)
+		{
+			++stats.skippedPrimitives;
+			continue;
+		}
+		model.meshes.push_back(std::move(primitive.mesh));
+	}
+	stats.buildMs = ElapsedMs(buildStart);
+	return true;
+}
+
+BlackJawz::Scene::GeometryData BlackJawz::Scene::ToGeometryData(const ImportedMesh& mesh)
+{
+	const uint8_t* vertices = reinterpret_cast<const uint8_t*>(mesh.vertices.data());
+	const uint8_t* indices = reinterpret_cast<const uint8_t*>(mesh.indices.data());
+
+	GeometryData geometry;
+	geometry.indicesCount = static_cast<uint32_t>(mesh.indices.size());
+	geometry.vertexBufferStride = FloatVertexStride;
+	geometry.vertexBufferOffset = 0;
+	geometry.vertexBuffer = Blob::FromVector(std::vector<uint8_t>(vertices, vertices + mesh.vertices.size() * sizeof(ImportedVertex)));
+	geometry.indexBuffer = Blob::FromVector(std::vector<uint8_t>(indices, indices + mesh.indices.size() * sizeof(uint32_t)));
+	geometry.vertexFormat = VertexFormat::Float;
+	geometry.bounds = mesh.bounds;
+	return geometry;
+}
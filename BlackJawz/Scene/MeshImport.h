@@ -0,0 +1,110 @@
+#pragma once
+#include "SceneData.h"
+#include "../Util/JobSystem.h"
+
+// Imports meshes from Wavefront OBJ and glTF 2.0 files, JSON .gltf with its buffers or binary .glb,
+// into the editor's vertex layout. Files are mapped rather than read. OBJ text is cut into chunks
+// at line breaks that are tokenized and parsed on the job system, glTF primitives are converted
+// as jobs. Free of D3D so the tools can import and benchmark headless.
+namespace BlackJawz::Scene
+{
+	// The editor's Vertex, FloatVertexStride bytes, see Scene/VertexPacking.h
+	struct ImportedVertex
+	{
+		float position[3];
+		float normal[3];
+		float texC[2];
+		float tangent[3];
+	};
+
+	struct ImportedMaterial
+	{
+		std::string name;
+		float baseColour[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float metallic = 0.0f;
+		float roughness = 1.0f;
+
+		// Texture paths relative to the imported file, empty for slots the material has no map for.
+		// Embedded glTF images have no path.
+		std::array<std::string, TextureSlotCount> textures;
+
+		// glTF's combined map, roughness in green and metal in blue. The editor reads metal and
+		// roughness from red, so it is kept apart for the cooker to repack.
+		std::string metalRoughnessTexture;
+	};
+
+	struct ImportedMesh
+	{
+		std::string name;
+		std::vector<ImportedVertex> vertices;
+		std::vector<uint32_t> indices; // Triangle list, clockwise front faces like the built in meshes
+		int32_t material = -1; // Into ImportedModel::materials, -1 without one
+		BoundsData bounds;
+	};
+
+	// Both formats are right handed with Y up. Z is flipped and the winding reversed to match the
+	// editor, and OBJ texture coordinates are flipped to a top left origin like glTF's.
+	struct ImportedModel
+	{
+		std::vector<ImportedMesh> meshes;
+		std::vector<ImportedMaterial> materials;
+	};
+
+	enum class MeshFileType
+	{
+		Obj, // Meshes by object and material, materials from its .mtl libraries
+		Gltf, // JSON, buffers in files next to it or embedded as base64
+		Glb // Binary container, JSON and the first buffer in one file
+	};
+
+	// By extension, case insensitive
+	std::optional<MeshFileType> GetMeshFileType(const std::string& filename);
+
+	struct MeshImportStats
+	{
+		uint64_t fileBytes = 0; // The model and its glTF buffers, material libraries are not counted
+		size_t chunks = 0; // OBJ text chunks or glTF primitives, converted as separate jobs
+		size_t meshCount = 0;
+		size_t vertexCount = 0;
+		size_t triangleCount = 0;
+		size_t skippedPrimitives = 0; // glTF points and lines
+
+		double mapMs = 0.0;
+		double parseMs = 0.0; // Tokenizing and converting to floats and indices
+		double buildMs = 0.0; // Vertex welding, normals and tangents
+		double totalMs = 0.0;
+	};
+
+	class MeshImporter
+	{
+	public:
+		// OBJ text is cut into chunks of about this many bytes
+		static constexpr size_t DefaultChunkBytes = 1024 * 1024;
+
+		// Without a job system everything runs on the calling thread. The chunks are the same either
+		// way, so the result does not depend on the worker count.
+		explicit MeshImporter(Jobs::JobSystem* jobSystem = nullptr, size_t chunkBytes = DefaultChunkBytes);
+
+		bool Import(const std::string& filename, ImportedModel& model, MeshImportStats& stats);
+
+		// The same from bytes already in memory. Material libraries and glTF buffers are looked up
+		// relative to baseDirectory.
+		bool ImportMemory(const Blob& data, MeshFileType type, const std::string& baseDirectory,
+			ImportedModel& model, MeshImportStats& stats);
+
+		const std::string& GetLastError() const { return lastError; }
+
+	private:
+		bool ImportObj(const Blob& data, const std::string& baseDirectory, ImportedModel& model, MeshImportStats& stats);
+		bool ImportGltf(const Blob& json, const Blob& binaryChunk, const std::string& baseDirectory,
+			ImportedModel& model, MeshImportStats& stats);
+		bool ImportGlb(const Blob& data, const std::string& baseDirectory, ImportedModel& model, MeshImportStats& stats);
+
+		Jobs::JobSystem* jobSystem;
+		size_t chunkBytes;
+		std::string lastError;
+	};
+
+	// A Float geometry holding a copy of the mesh, with its bounds, for the scene writer and PackVertices
+	GeometryData ToGeometryData(const ImportedMesh& mesh);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "UploadQueue.h"
+
+namespace BlackJawz::Scene
+{
+	// Backend for the command line tools, which have no GPU. By default it turns down every
+	// request so a load only decodes, with acceptUploads the requests run through the upload
+	// queue and are counted, to measure the queue itself.
+	class NullResourceBackend : public ResourceBackend
+	{
+	public:
+		explicit NullResourceBackend(bool acceptUploads = false) : acceptUploads(acceptUploads) {}
+
+		void Reserve(size_t, size_t) override {}
+		bool Prepare(UploadRequest&) override { return acceptUploads; }
+
+		bool Create(UploadRequest& request) override
+		{
+			createdCount.fetch_add(1, std::memory_order_relaxed);
+			createdBytes.fetch_add(request.data.size, std::memory_order_relaxed);
+			return true;
+		}
+
+		size_t GetCreatedCount() const { return createdCount.load(std::memory_order_relaxed); }
+		uint64_t GetCreatedBytes() const { return createdBytes.load(std::memory_order_relaxed); }
+
+	private:
+		bool acceptUploads;
+		std::atomic<size_t> createdCount{ 0 };
+		std::atomic<uint64_t> createdBytes{ 0 };
+	};
+}
@@ -0,0 +1,246 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+
+// Compile-time field lists for plain component records. Each field names the slot of the
+// FlatBuffers table it is stored in, and reading, writing and converting between records
+// are driven by the lists, so a new field only has to be described once per struct.
+namespace BlackJawz::Scene::Reflection
+{
+	// How a field is stored, every element is 32 bits in memory
+	enum class FieldKind : uint8_t
+	{
+		Float, // float
+		Byte, // int or int based enum, stored as a byte enum in the file
+		FloatVector // float array or vector type, stored as [float]
+	};
+
+	struct FieldInfo
+	{
+		const char* name;
+		FieldKind kind;
+		uint32_t count; // Elements, 1 for scalars
+		size_t offset;
+		size_t size;
+		flatbuffers::voffset_t slot; // Table vtable offset, 0 for fields that are not stored
+	};
+
+	// Floats in a field type, vector types from outside Scene/ add their own specialization
+	template <typename T> struct FloatCount : std::integral_constant<uint32_t, 0> {};
+	template <> struct FloatCount<float> : std::integral_constant<uint32_t, 1> {};
+	template <size_t N> struct FloatCount<float[N]> : std::integral_constant<uint32_t, static_cast<uint32_t>(N)> {};
+
+	// Specialized for each record with a static constexpr std::array<FieldInfo, N> Fields in declaration
+	// order, and for records stored in files a Table type
+	template <typename T> struct Reflect;
+
+	template <typename T>
+	constexpr FieldInfo MakeField(const char* name, size_t offset, flatbuffers::voffset_t slot)
+	{
+		if constexpr (std::is_same_v<T, float>)
+		{
+			return { name, FieldKind::Float, 1, offset, sizeof(T), slot };
+		}
+		else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+		{
+			static_assert(sizeof(T) == sizeof(int32_t), "Integer fields must be 32 bits");
+			return { name, FieldKind::Byte, 1, offset, sizeof(T), slot };
+		}
+		else
+		{
+			static_assert(FloatCount<T>::value > 0 && sizeof(T) == FloatCount<T>::value * sizeof(float), "Unsupported field type");
+			return { name, FieldKind::FloatVector, FloatCount<T>::value, offset, sizeof(T), slot };
+		}
+	}
+
+	// True when the fields tile the whole struct in order, so a member left out of the list fails the static_assert
+	template <typename T>
+	constexpr bool CoversLayout()
+	{
+		size_t end = 0;
+		for (const FieldInfo& field : Reflect<T>::Fields)
+		{
+			if (field.offset != end)
+				return false;
+			end += field.size;
+		}
+		return end == sizeof(T);
+	}
+
+	// Index of the field in From stored in the same slot as each stored field of To, -1 for unstored fields
+	template <typename From, typename To>
+	constexpr std::array<int, Reflect<To>::Fields.size()> MatchFields()
+	{
+		std::array<int, Reflect<To>::Fields.size()> matches = {};
+		for (size_t i = 0; i < matches.size(); ++i)
+		{
+			matches[i] = -1;
+			if (Reflect<To>::Fields[i].slot == 0)
+				continue;
+
+			for (size_t j = 0; j < Reflect<From>::Fields.size(); ++j)
+			{
+				if (Reflect<From>::Fields[j].slot == Reflect<To>::Fields[i].slot)
+					matches[i] = static_cast<int>(j);
+			}
+		}
+		return matches;
+	}
+
+	// Every stored field of To has a counterpart of the same kind and size in From
+	template <typename From, typename To>
+	constexpr bool CanConvert()
+	{
+		constexpr auto matches = MatchFields<From, To>();
+		for (size_t i = 0; i < matches.size(); ++i)
+		{
+			const FieldInfo& to = Reflect<To>::Fields[i];
+			if (to.slot == 0)
+				continue;
+			if (matches[i] < 0)
+				return false;
+
+			const FieldInfo& from = Reflect<From>::Fields[matches[i]];
+			if (from.kind != to.kind || from.size != to.size)
+				return false;
+		}
+		return true;
+	}
+
+	// Same fields at the same offsets, the whole record can be copied at once
+	template <typename From, typename To>
+	constexpr bool SameLayout()
+	{
+		if (sizeof(From) != sizeof(To) || Reflect<From>::Fields.size() != Reflect<To>::Fields.size())
+			return false;
+
+		for (size_t i = 0; i < Reflect<To>::Fields.size(); ++i)
+		{
+			const FieldInfo& from = Reflect<From>::Fields[i];
+			const FieldInfo& to = Reflect<To>::Fields[i];
+			if (from.kind != to.kind || from.offset != to.offset || from.size != to.size || from.slot != to.slot)
+				return false;
+		}
+		return true;
+	}
+
+	// Copies every stored field between two descriptions of the same table, fields that are not stored are left as they are
+	template <typename From, typename To>
+	void Convert(const From& from, To& to)
+	{
+		static_assert(std::is_trivially_copyable_v<From> && std::is_trivially_copyable_v<To>, "Records are copied as bytes");
+		static_assert(CanConvert<From, To>(), "Every stored field needs a matching field");
+
+		if constexpr (SameLayout<From, To>())
+		{
+			memcpy(&to, &from, sizeof(To));
+		}
+		else
+		{
+			constexpr auto matches = MatchFields<From, To>();
+			const uint8_t* source = reinterpret_cast<const uint8_t*>(&from);
+			uint8_t* destination = reinterpret_cast<uint8_t*>(&to);
+			for (size_t i = 0; i < matches.size(); ++i)
+			{
+				if (matches[i] < 0)
+					continue;
+
+				const FieldInfo& field = Reflect<To>::Fields[i];
+				memcpy(destination + field.offset, source + Reflect<From>::Fields[matches[i]].offset, field.size);
+			}
+		}
+	}
+
+	template <typename T>
+	flatbuffers::Offset<typename Reflect<T>::Table> WriteTable(flatbuffers::FlatBufferBuilder& builder, const T& data)
+	{
+		constexpr auto& fields = Reflect<T>::Fields;
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&data);
+
+		// Vectors have to be finished before the table is started
+		std::array<flatbuffers::Offset<flatbuffers::Vector<float>>, fields.size()> vectors;
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			if (fields[i].slot != 0 && fields[i].kind == FieldKind::FloatVector)
+				vectors[i] = builder.CreateVector(reinterpret_cast<const float*>(bytes + fields[i].offset), fields[i].count);
+		}
+
+		// 32 bit fields first and bytes last, the same order flatc uses to avoid padding
+		flatbuffers::uoffset_t start = builder.StartTable();
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			if (fields[i].slot == 0)
+				continue;
+
+			if (fields[i].kind == FieldKind::FloatVector)
+			{
+				builder.AddOffset(fields[i].slot, vectors[i]);
+			}
+			else if (fields[i].kind == FieldKind::Float)
+			{
+				float value;
+				memcpy(&value, bytes + fields[i].offset, sizeof(value));
+				builder.AddElement<float>(fields[i].slot, value, 0.0f);
+			}
+		}
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			if (fields[i].slot != 0 && fields[i].kind == FieldKind::Byte)
+			{
+				int32_t value;
+				memcpy(&value, bytes + fields[i].offset, sizeof(value));
+				builder.AddElement<int8_t>(fields[i].slot, static_cast<int8_t>(value), 0);
+			}
+		}
+		return flatbuffers::Offset<typename Reflect<T>::Table>(builder.EndTable(start));
+	}
+
+	// Missing scalars read as the schema default of 0, vectors too short for their field are skipped
+	template <typename T>
+	void ReadTable(const typename Reflect<T>::Table* table, T& data)
+	{
+		// Generated tables inherit privately from flatbuffers::Table
+		const flatbuffers::Table* fieldTable = reinterpret_cast<const flatbuffers::Table*>(table);
+		uint8_t* bytes = reinterpret_cast<uint8_t*>(&data);
+
+		for (const FieldInfo& field : Reflect<T>::Fields)
+		{
+			if (field.slot == 0)
+				continue;
+
+			switch (field.kind)
+			{
+			case FieldKind::Float:
+			{
+				float value = fieldTable->GetField<float>(field.slot, 0.0f);
+				memcpy(bytes + field.offset, &value, sizeof(value));
+				break;
+			}
+			case FieldKind::Byte:
+			{
+				int32_t value = fieldTable->GetField<int8_t>(field.slot, 0);
+				memcpy(bytes + field.offset, &value, sizeof(value));
+				break;
+			}
+			case FieldKind::FloatVector:
+			{
+				auto vector = fieldTable->GetPointer<const flatbuffers::Vector<float>*>(field.slot);
+				if (vector && vector->size() >= field.count)
+					memcpy(bytes + field.offset, vector->data(), field.size);
+				break;
+			}
+			}
+		}
+	}
+}
+
+// Describes one member of a reflected struct, used inside a Reflect specialization's Fields list
+#define BLACKJAWZ_FIELD(Type, member, slot) \
+	::BlackJawz::Scene::Reflection::MakeField<decltype(Type::member)>(#member, offsetof(Type, member), slot)
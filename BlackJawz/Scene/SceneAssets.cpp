@@ -0,0 +1,225 @@
+#include "SceneAssets.h"
+#include "SceneWriter.h"
+#include "../Util/LZ.h"
+
+#include <algorithm>
+#include <cstring>
+
+BlackJawz::Scene::SceneAssets::SceneAssets(bool compress) : compress(compress)
+{
+
+}
+
+void BlackJawz::Scene::SceneAssets::Add(const Blob& blob)
+{
+	if (blob.Empty() || indices.count(blob.data))
+		return;
+
+	indices.emplace(blob.data, static_cast<int32_t>(assets.size()));
+
+	Asset asset;
+	asset.raw = blob;
+	asset.stored = blob;
+	assets.push_back(std::move(asset));
+}
+
+void BlackJawz::Scene::SceneAssets::Collect(const EntityData* entities, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!entities[i].appearance)
+			continue;
+
+		const AppearanceData& appearance = *entities[i].appearance;
+		Add(appearance.geometry.vertexBuffer);
+		Add(appearance.geometry.indexBuffer);
+
+		for (const Blob& texture : appearance.textures)
+		{
+			Add(texture);
+		}
+	}
+}
+
+void BlackJawz::Scene::SceneAssets::Hash(size_t index)
+{
+	Asset& asset = assets[index];
+	asset.hash = HashBytes(asset.raw.data, asset.raw.size);
+}
+
+void BlackJawz::Scene::SceneAssets::Deduplicate()
+{
+	std::vector<int32_t> remap(assets.size());
+	std::unordered_multimap<uint64_t, int32_t> byHash;
+	std::vector<Asset> unique;
+	unique.reserve(assets.size());
+
+	for (size_t i = 0; i < assets.size(); ++i)
+	{
+		const Blob& raw = assets[i].raw;
+
+		int32_t match = -1;
+		auto range = byHash.equal_range(assets[i].hash);
+		for (auto it = range.first; it != range.second && match < 0; ++it)
+		{
+			const Blob& other = unique[it->second].raw;
+			if (other.size == raw.size && memcmp(other.data, raw.data, raw.size) == 0)
+				match = it->second;
+		}
+
+		if (match < 0)
+		{
+			match = static_cast<int32_t>(unique.size());
+			byHash.emplace(assets[i].hash, match);
+			unique.push_back(std::move(assets[i]));
+		}
+
+		remap[i] = match;
+	}
+
+	for (auto& entry : indices)
+	{
+		entry.second = remap[entry.second];
+	}
+	assets = std::move(unique);
+}
+
+void BlackJawz::Scene::SceneAssets::Compress(size_t index)
+{
+	Asset& asset = assets[index];
+	if (!compress || asset.raw.size < MinCompressSize)
+		return;
+
+	size_t maxSize = static_cast<size_t>(static_cast<double>(asset.raw.size) * (1.0 - MinSaving));
+
+	if (asset.raw.size > SampleSize * 4)
+	{
+		std::vector<uint8_t> sample(LZ::CompressBound(SampleSize));
+		size_t sampleSize = LZ::Compress(asset.raw.data, SampleSize, sample.data(), sample.size());
+		if (sampleSize == 0 || sampleSize > static_cast<size_t>(static_cast<double>(SampleSize) * (1.0 - MinSaving)))
+			return;
+	}
+
+	// Stops as soon as the output passes maxSize, which also rules out payloads that did not shrink enough
+	std::vector<uint8_t> compressed(maxSize);
+	size_t compressedSize = LZ::Compress(asset.raw.data, asset.raw.size, compressed.data(), compressed.size());
+	if (compressedSize == 0)
+		return;
+
+	compressed.resize(compressedSize);
+	asset.stored = Blob::FromVector(std::move(compressed));
+	asset.codec = ECS::AssetCodec_LZ;
+}
+
+uint64_t BlackJawz::Scene::SceneAssets::GetRawBytes() const
+{
+	uint64_t total = 0;
+	for (const auto& asset : assets)
+	{
+		total += asset.raw.size;
+	}
+	return total;
+}
+
+uint64_t BlackJawz::Scene::SceneAssets::GetStoredBytes() const
+{
+	uint64_t total = 0;
+	for (const auto& asset : assets)
+	{
+		total += asset.stored.size;
+	}
+	return total;
+}
+
+int32_t BlackJawz::Scene::SceneAssets::GetIndex(const Blob& blob) const
+{
+	if (blob.Empty())
+		return -1;
+
+	auto it = indices.find(blob.data);
+	return it != indices.end() ? it->second : -1;
+}
+
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>> BlackJawz::Scene::SceneAssets::Write(
+	flatbuffers::FlatBufferBuilder& builder) const
+{
+	std::vector<flatbuffers::Offset<ECS::Asset>> assetOffsets;
+	assetOffsets.reserve(assets.size());
+
+	for (const auto& asset : assets)
+	{
+		auto dataVec = builder.CreateVector(asset.stored.data, asset.stored.size);
+		assetOffsets.push_back(ECS::CreateAsset(builder, asset.codec, asset.raw.size, asset.hash, dataVec));
+	}
+
+	return builder.CreateVector(assetOffsets);
+}
+
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>> BlackJawz::Scene::SceneAssets::WriteTrailing(
+	flatbuffers::FlatBufferBuilder& builder, const std::vector<uint64_t>& distances) const
+{
+	std::vector<flatbuffers::Offset<ECS::Asset>> assetOffsets;
+	assetOffsets.reserve(assets.size());
+
+	for (size_t i = 0; i < assets.size(); ++i)
+	{
+		const Asset& asset = assets[i];
+
+		ECS::AssetBuilder assetBuilder(builder);
+		assetBuilder.add_hash(asset.hash);
+		assetBuilder.add_raw_size(asset.raw.size);
+		SceneWriter::AddTrailingVector(builder, ECS::Asset::VT_DATA, distances[i]);
+		assetBuilder.add_codec(asset.codec);
+		assetOffsets.push_back(assetBuilder.Finish());
+	}
+
+	return builder.CreateVector(assetOffsets);
+}
+
+uint64_t BlackJawz::Scene::SceneAssets::HashBytes(const uint8_t* data, size_t size)
+{
+	// FNV-1a
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+bool BlackJawz::Scene::SceneAssets::Decode(const ECS::Asset* asset, const Blob& fileData, Blob& decoded)
+{
+	decoded = Blob();
+	if (!asset || !asset->data())
+		return false;
+
+	const flatbuffers::Vector<uint8_t>* data = asset->data();
+
+	switch (asset->codec())
+	{
+	case ECS::AssetCodec_None:
+		if (data->size() != asset->raw_size())
+			return false;
+		decoded = fileData.Slice(data->data(), data->size());
+		return true;
+
+	case ECS::AssetCodec_LZ:
+	{
+		// No sequence expands to more than 255 bytes per input byte, anything larger is corrupt
+		if (asset->raw_size() > static_cast<uint64_t>(data->size()) * 255)
+			return false;
+
+		// Decompressed straight into the storage the upload reads from
+		std::vector<uint8_t> bytes(static_cast<size_t>(asset->raw_size()));
+		if (!LZ::Decompress(data->data(), data->size(), bytes.data(), bytes.size()))
+			return false;
+
+		decoded = Blob::FromVector(std::move(bytes));
+		return true;
+	}
+
+	default:
+		return false;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "SceneData.h"
+
+#include <unordered_map>
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "../ecs_generated.h"
+
+namespace BlackJawz::Scene
+{
+	// The asset section of a scene file. Gathers the unique mesh and texture payloads the entities
+	// reference, so each is stored once per file, and compresses those that are worth it.
+	class SceneAssets
+	{
+	public:
+		// Smaller payloads are always stored raw
+		static constexpr size_t MinCompressSize = 4 * 1024;
+
+		// A payload is only stored compressed if that saves at least this fraction of it
+		static constexpr double MinSaving = 0.1;
+
+		// Large payloads are tried on a sample first, so incompressible textures are not compressed in full
+		static constexpr size_t SampleSize = 64 * 1024;
+
+		explicit SceneAssets(bool compress = true);
+
+		// Add every payload the entities reference, blobs shared between entities are added once
+		void Collect(const EntityData* entities, size_t count);
+
+		// Hash and Compress may run in parallel for different indices. Deduplicate merges payloads
+		// with identical contents, it must run after hashing and before compressing.
+		void Hash(size_t index);
+		void Deduplicate();
+		void Compress(size_t index);
+
+		size_t GetCount() const { return assets.size(); }
+		uint64_t GetRawBytes() const;
+		uint64_t GetStoredBytes() const;
+
+		// Index of a collected blob in the asset section, -1 for an empty blob
+		int32_t GetIndex(const Blob& blob) const;
+
+		flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>> Write(flatbuffers::FlatBufferBuilder& builder) const;
+
+		// The same tables for payloads written behind the finished buffer, asset i's distances[i] bytes past its end
+		flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>> WriteTrailing(flatbuffers::FlatBufferBuilder& builder,
+			const std::vector<uint64_t>& distances) const;
+
+		// What goes in the file for an asset
+		const Blob& GetStored(size_t index) const { return assets[index].stored; }
+
+		static uint64_t HashBytes(const uint8_t* data, size_t size);
+
+		// Raw assets are a view into the file data, compressed ones are decompressed into their own storage
+		static bool Decode(const ECS::Asset* asset, const Blob& fileData, Blob& decoded);
+
+	private:
+		struct Asset
+		{
+			Blob raw;
+			Blob stored; // What goes in the file, the raw bytes unless compressed
+			ECS::AssetCodec codec = ECS::AssetCodec_None;
+			uint64_t hash = 0;
+		};
+
+		void Add(const Blob& blob);
+
+		bool compress;
+		std::vector<Asset> assets;
+		std::unordered_map<const uint8_t*, int32_t> indices;
+	};
+}
@@ -0,0 +1,208 @@
+#include "SceneBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+std::optional<BlackJawz::Scene::BoundsData> BlackJawz::Scene::ComputeBounds(const GeometryData& geometry)
+{
+	if (geometry.vertexFormat != VertexFormat::Float)
+		return geometry.bounds;
+
+	const Blob& vertices = geometry.vertexBuffer;
+	size_t stride = geometry.vertexBufferStride;
+	size_t offset = geometry.vertexBufferOffset;
+
+	if (stride < sizeof(float) * 3 || offset >= vertices.size || vertices.size - offset < stride)
+		return std::nullopt;
+
+	size_t vertexCount = (vertices.size - offset) / stride;
+
+	BoundsData bounds;
+	memcpy(bounds.min, vertices.data + offset, sizeof(bounds.min));
+	memcpy(bounds.max, bounds.min, sizeof(bounds.max));
+
+	for (size_t i = 1; i < vertexCount; ++i)
+	{
+		float position[3];
+		memcpy(position, vertices.data + offset + i * stride, sizeof(position));
+
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			bounds.min[axis] = std::min(bounds.min[axis], position[axis]);
+			bounds.max[axis] = std::max(bounds.max[axis], position[axis]);
+		}
+	}
+
+	return bounds;
+}
+
+size_t BlackJawz::Scene::ComputeMissingBounds(std::vector<EntityData>& entities, Jobs::JobSystem& jobSystem)
+{
+	// Bounds depend on the vertex data and its layout
+	using GeometryKey = std::tuple<const uint8_t*, uint32_t, uint32_t>;
+	std::map<GeometryKey, size_t> geometryIndices;
+	std::vector<const GeometryData*> geometries;
+
+	for (const auto& entity : entities)
+	{
+		if (!entity.appearance || entity.appearance->geometry.bounds)
+			continue;
+
+		const GeometryData& geometry = entity.appearance->geometry;
+		GeometryKey key(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset);
+		if (!geometry.vertexBuffer.Empty() && geometryIndices.emplace(key, geometries.size()).second)
+			geometries.push_back(&geometry);
+	}
+
+	std::vector<std::optional<BoundsData>> bounds(geometries.size());
+	Jobs::JobCounter boundsCounter;
+	jobSystem.Dispatch(boundsCounter, static_cast<uint32_t>(geometries.size()), 1, [&geometries, &bounds](uint32_t index)
+		{
+			bounds[index] = ComputeBounds(*geometries[index]);
+		});
+	jobSystem.Wait(boundsCounter);
+
+	for (auto& entity : entities)
+	{
+		if (!entity.appearance || entity.appearance->geometry.bounds)
+			continue;
+
+		GeometryData& geometry = entity.appearance->geometry;
+		auto it = geometryIndices.find(GeometryKey(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset));
+		if (it != geometryIndices.end())
+			geometry.bounds = bounds[it->second];
+	}
+
+	return geometries.size();
+}
+
+namespace
+{
+	// Both matrices are affine, the last column is left as it is
+	void MultiplyAffine(const float a[16], const float b[16], float result[16])
+	{
+		for (size_t row = 0; row < 4; ++row)
+		{
+			for (size_t column = 0; column < 3; ++column)
+			{
+				result[row * 4 + column] = a[row * 4] * b[column] + a[row * 4 + 1] * b[4 + column] + a[row * 4 + 2] * b[8 + column] +
+					(row == 3 ? b[12 + column] : 0.0f);
+			}
+			result[row * 4 + 3] = row == 3 ? 1.0f : 0.0f;
+		}
+	}
+}
+
+void BlackJawz::Scene::ComposeWorldMatrix(const float position[3], const float rotation[3], const float scale[3], float matrix[16])
+{
+	float cx = cosf(rotation[0]), sx = sinf(rotation[0]);
+	float cy = cosf(rotation[1]), sy = sinf(rotation[1]);
+	float cz = cosf(rotation[2]), sz = sinf(rotation[2]);
+
+	// Rows of Rx * Ry * Rz
+	const float rotationRows[3][3] =
+	{
+		{ cy * cz, cy * sz, -sy },
+		{ sx * sy * cz - cx * sz, sx * sy * sz + cx * cz, sx * cy },
+		{ cx * sy * cz + sx * sz, cx * sy * sz - sx * cz, cx * cy }
+	};
+
+	for (size_t row = 0; row < 3; ++row)
+	{
+		for (size_t column = 0; column < 3; ++column)
+		{
+			matrix[row * 4 + column] = scale[row] * rotationRows[row][column];
+		}
+		matrix[row * 4 + 3] = 0.0f;
+	}
+
+	matrix[12] = position[0];
+	matrix[13] = position[1];
+	matrix[14] = position[2];
+	matrix[15] = 1.0f;
+}
+
+BlackJawz::Scene::BoundsData BlackJawz::Scene::TransformBounds(const BoundsData& bounds, const float matrix[16])
+{
+	float center[3], extent[3];
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		center[axis] = (bounds.min[axis] + bounds.max[axis]) * 0.5f;
+		extent[axis] = (bounds.max[axis] - bounds.min[axis]) * 0.5f;
+	}
+
+	BoundsData result;
+	for (size_t column = 0; column < 3; ++column)
+	{
+		float newCenter = matrix[12 + column];
+		float newExtent = 0.0f;
+		for (size_t row = 0; row < 3; ++row)
+		{
+			newCenter += center[row] * matrix[row * 4 + column];
+			newExtent += extent[row] * fabsf(matrix[row * 4 + column]);
+		}
+
+		result.min[column] = newCenter - newExtent;
+		result.max[column] = newCenter + newExtent;
+	}
+	return result;
+}
+
+BlackJawz::Scene::BoundsData BlackJawz::Scene::ComputeWorldBounds(const BoundsData& localBounds, const float worldMatrix[16],
+	const InstanceTransformData* instances, size_t instanceCount)
+{
+	if (!instances)
+		return TransformBounds(localBounds, worldMatrix);
+
+	// Instances are placed relative to the entity, the same product the instanced vertex shaders use
+	BoundsData bounds = EmptyBounds();
+	for (size_t i = 0; i < instanceCount; ++i)
+	{
+		float instanceMatrix[16], matrix[16];
+		ComposeWorldMatrix(instances[i].position, instances[i].rotation, instances[i].scale, instanceMatrix);
+		MultiplyAffine(instanceMatrix, worldMatrix, matrix);
+		Merge(bounds, TransformBounds(localBounds, matrix));
+	}
+	return bounds;
+}
+
+std::optional<BlackJawz::Scene::BoundsData> BlackJawz::Scene::ComputeWorldBounds(const EntityData& entity)
+{
+	if (!entity.transform || !entity.appearance)
+		return std::nullopt;
+
+	const GeometryData& geometry = entity.appearance->geometry;
+	// Cooked scenes carry the bounds of every mesh
+	std::optional<BoundsData> localBounds = geometry.bounds ? geometry.bounds : ComputeBounds(geometry);
+	if (!localBounds)
+		return std::nullopt;
+
+	const TransformData& transform = *entity.transform;
+	float worldMatrix[16];
+	ComposeWorldMatrix(transform.position, transform.rotation, transform.scale, worldMatrix);
+
+	const std::optional<InstancesData>& instances = entity.appearance->instances;
+	return instances ? ComputeWorldBounds(*localBounds, worldMatrix, instances->transforms.data(), instances->transforms.size())
+		: ComputeWorldBounds(*localBounds, worldMatrix);
+}
+
+void BlackJawz::Scene::Merge(BoundsData& bounds, const BoundsData& other)
+{
+	if (IsEmpty(other))
+		return;
+
+	if (IsEmpty(bounds))
+	{
+		bounds = other;
+		return;
+	}
+
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		bounds.min[axis] = std::min(bounds.min[axis], other.min[axis]);
+		bounds.max[axis] = std::max(bounds.max[axis], other.max[axis]);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "SceneData.h"
+#include "../Util/JobSystem.h"
+
+namespace BlackJawz::Scene
+{
+	// Local space box around a geometry's vertex positions, which are the first three floats of
+	// every vertex. Empty if the vertex buffer is missing or too small for its stride. Packed
+	// geometry already carries its bounds, they are needed to decode it.
+	std::optional<BoundsData> ComputeBounds(const GeometryData& geometry);
+
+	// Measures every mesh that has no bounds and stores them in every entity using it, each unique
+	// vertex buffer and layout once on the job system. Returns how many meshes were measured.
+	size_t ComputeMissingBounds(std::vector<EntityData>& entities, Jobs::JobSystem& jobSystem);
+
+	// Matches Component::Transform::UpdateWorldMatrix, scale then rotation about X, Y and Z, then
+	// translation, for row vectors
+	void ComposeWorldMatrix(const float position[3], const float rotation[3], const float scale[3], float matrix[16]);
+
+	// The box around a transformed box
+	BoundsData TransformBounds(const BoundsData& bounds, const float matrix[16]);
+
+	// World space box around local bounds placed by a world matrix, and around every instance of
+	// them when there are instances
+	BoundsData ComputeWorldBounds(const BoundsData& localBounds, const float worldMatrix[16],
+		const InstanceTransformData* instances = nullptr, size_t instanceCount = 0);
+
+	// Entities without a transform or an appearance, or whose geometry bounds cannot be worked
+	// out, have none. The stored world matrix is ignored, as it is on load.
+	std::optional<BoundsData> ComputeWorldBounds(const EntityData& entity);
+
+	// Boxes with min above max hold nothing, so they can stand in for entities without bounds
+	inline BoundsData EmptyBounds()
+	{
+		BoundsData bounds;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			bounds.min[axis] = 1.0f;
+			bounds.max[axis] = -1.0f;
+		}
+		return bounds;
+	}
+
+	inline bool IsEmpty(const BoundsData& bounds)
+	{
+		// Written so NaN bounds count as empty too
+		return !(bounds.min[0] <= bounds.max[0] && bounds.min[1] <= bounds.max[1] && bounds.min[2] <= bounds.max[2]);
+	}
+
+	void Merge(BoundsData& bounds, const BoundsData& other);
+}
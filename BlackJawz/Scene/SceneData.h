@@ -0,0 +1,149 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// CPU-side copy of a scene, decoupled from the ECS and D3D11 so it can be
+// serialized on worker threads and by the command line tools.
+namespace BlackJawz::Scene
+{
+	// Immutable bytes that keep their backing storage alive, entities sharing
+	// a mesh or texture share the same Blob
+	struct Blob
+	{
+		std::shared_ptr<const void> owner;
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+
+		bool Empty() const { return size == 0; }
+
+		// A view into this blob's bytes that keeps the same storage alive
+		Blob Slice(const uint8_t* sliceData, size_t sliceSize) const
+		{
+			Blob blob;
+			blob.owner = owner;
+			blob.data = sliceData;
+			blob.size = sliceSize;
+			return blob;
+		}
+
+		static Blob FromVector(std::vector<uint8_t>&& bytes)
+		{
+			auto storage = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+
+			Blob blob;
+			blob.data = storage->data();
+			blob.size = storage->size();
+			blob.owner = std::move(storage);
+			return blob;
+		}
+	};
+
+	struct TransformData
+	{
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		float rotation[3] = { 0.0f, 0.0f, 0.0f };
+		float scale[3] = { 1.0f, 1.0f, 1.0f };
+		float worldMatrix[16] =
+		{
+			1.0f, 0.0f, 0.0f, 0.0f,
+			0.0f, 1.0f, 0.0f, 0.0f,
+			0.0f, 0.0f, 1.0f, 0.0f,
+			0.0f, 0.0f, 0.0f, 1.0f
+		};
+	};
+
+	// Axis aligned box, in the local space of the geometry
+	struct BoundsData
+	{
+		float min[3] = { 0.0f, 0.0f, 0.0f };
+		float max[3] = { 0.0f, 0.0f, 0.0f };
+	};
+
+	// Matches ECS::VertexFormat, see Scene/VertexPacking.h
+	enum class VertexFormat : uint32_t
+	{
+		Float = 0,
+		Packed
+	};
+
+	struct GeometryData
+	{
+		uint32_t indicesCount = 0;
+		uint32_t vertexBufferStride = 0;
+		uint32_t vertexBufferOffset = 0;
+		Blob vertexBuffer;
+		Blob indexBuffer;
+		VertexFormat vertexFormat = VertexFormat::Float;
+
+		std::optional<BoundsData> bounds; // Required by packed vertices
+	};
+
+	enum class TextureSlot : uint32_t
+	{
+		Diffuse = 0,
+		Normal,
+		Metal,
+		Roughness,
+		AO,
+		Displacement,
+		Packed, // Metal, roughness, AO and displacement in red, green, blue and alpha, replaces those slots
+		ConeStep, // Depth in red and cone ratio in green, made by the cooker from the displacement
+		Count
+	};
+
+	constexpr size_t TextureSlotCount = static_cast<size_t>(TextureSlot::Count);
+
+	// Same layout as ECS::InstanceTransform, so instance arrays are copied to and from files whole
+	struct InstanceTransformData
+	{
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		float rotation[3] = { 0.0f, 0.0f, 0.0f };
+		float scale[3] = { 1.0f, 1.0f, 1.0f };
+	};
+
+	struct InstancesData
+	{
+		std::vector<InstanceTransformData> transforms; // Relative to the entity's transform
+		uint32_t paramStride = 0; // Floats per instance in params
+		std::vector<float> params;
+	};
+
+	struct AppearanceData
+	{
+		GeometryData geometry;
+		std::array<Blob, TextureSlotCount> textures; // DDS files, indexed by TextureSlot
+		std::optional<InstancesData> instances; // Drawn once per instance instead of once
+	};
+
+	struct LightData
+	{
+		int type = 0; // Matches Component::LightType and ECS::LightType
+
+		float diffuseLight[4] = {};
+		float ambientLight[4] = {};
+		float specularLight[4] = {};
+		float specularPower = 0.0f;
+
+		float range = 0.0f;
+		float direction[3] = {};
+		float intensity = 0.0f;
+		float attenuation[3] = {};
+
+		float spotInnerCone = 0.0f;
+		float spotOuterCone = 0.0f;
+	};
+
+	struct EntityData
+	{
+		uint32_t id = 0;
+		std::string name;
+
+		std::optional<TransformData> transform;
+		std::optional<AppearanceData> appearance;
+		std::optional<LightData> light;
+	};
+}
@@ -0,0 +1,128 @@
+#include "SceneJournal.h"
+#include "SceneReader.h"
+#include "SceneWriter.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace
+{
+	// Calls func for each record in file order and returns the size of the records read. A torn or
+	// invalid record ends the log, nothing after it is ever read.
+	template <typename Func>
+	size_t ReadRecords(const BlackJawz::Scene::Blob& journalData, Func&& func)
+	{
+		size_t offset = 0;
+		while (journalData.size - offset >= sizeof(flatbuffers::uoffset_t))
+		{
+			const uint8_t* record = journalData.data + offset;
+			size_t recordSize = flatbuffers::GetPrefixedSize(record) + sizeof(flatbuffers::uoffset_t);
+			if (recordSize > journalData.size - offset)
+				break;
+
+			flatbuffers::Verifier verifier(record, recordSize);
+			if (!verifier.VerifySizePrefixedBuffer<ECS::SceneDelta>(nullptr))
+				break;
+
+			func(record, recordSize);
+			offset += recordSize;
+		}
+		return offset;
+	}
+}
+
+flatbuffers::DetachedBuffer BlackJawz::Scene::SceneJournal::WriteDelta(uint64_t baseJournalId, const EntityData* entities,
+	size_t count, const std::vector<uint32_t>& removed)
+{
+	flatbuffers::FlatBufferBuilder builder(1024);
+	SceneWriter::BlobOffsets writtenBlobs;
+
+	std::vector<flatbuffers::Offset<ECS::Entity>> entityOffsets;
+	entityOffsets.reserve(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		entityOffsets.push_back(SceneWriter::WriteEntity(builder, entities[i], writtenBlobs));
+	}
+
+	auto entitiesVector = builder.CreateVector(entityOffsets);
+	auto removedVector = builder.CreateVector(removed);
+	builder.FinishSizePrefixed(ECS::CreateSceneDelta(builder, baseJournalId, entitiesVector, removedVector));
+
+	return builder.Release();
+}
+
+bool BlackJawz::Scene::SceneJournal::Append(const std::string& sceneFile, const uint8_t* data, size_t size)
+{
+	std::string journalPath = GetJournalPath(sceneFile);
+
+	// A save interrupted mid record leaves a tail that ends the log, anything appended after it
+	// would never be read. Cut the journal back to its last whole record first.
+	uint64_t validSize = 0;
+	uint64_t journalSize = 0;
+	{
+		Blob journalData;
+		if (SceneReader::ReadFile(journalPath, journalData))
+		{
+			validSize = ReadRecords(journalData, [](const uint8_t*, size_t) {});
+			journalSize = journalData.size;
+		}
+	}
+
+	if (validSize < journalSize)
+	{
+		std::error_code error;
+		std::filesystem::resize_file(journalPath, validSize, error);
+		if (error)
+			return false;
+	}
+
+	std::ofstream outFile(journalPath, std::ios::binary | std::ios::app);
+	if (!outFile)
+		return false;
+
+	outFile.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+	outFile.flush();
+	return static_cast<bool>(outFile);
+}
+
+void BlackJawz::Scene::SceneJournal::Discard(const std::string& sceneFile)
+{
+	std::error_code error;
+	std::filesystem::remove(GetJournalPath(sceneFile), error);
+}
+
+bool BlackJawz::Scene::SceneJournal::ShouldCompact(const std::string& sceneFile)
+{
+	std::error_code error;
+	uintmax_t baseSize = std::filesystem::file_size(sceneFile, error);
+	if (error)
+		return true;
+
+	uintmax_t journalSize = std::filesystem::file_size(GetJournalPath(sceneFile), error);
+	if (error)
+		return false; // No journal yet
+
+	return static_cast<double>(journalSize) > static_cast<double>(baseSize) * CompactionRatio;
+}
+
+bool BlackJawz::Scene::SceneJournal::ReadDeltas(const std::string& sceneFile, uint64_t baseJournalId, std::vector<Blob>& records)
+{
+	records.clear();
+
+	Blob journalData;
+	if (!SceneReader::ReadFile(GetJournalPath(sceneFile), journalData))
+		return false;
+
+	ReadRecords(journalData, [&](const uint8_t* record, size_t recordSize)
+		{
+			// Records from an older base are left behind by a compaction that did not get to remove them
+			const ECS::SceneDelta* delta = flatbuffers::GetSizePrefixedRoot<ECS::SceneDelta>(record);
+			if (delta->base_journal_id() == baseJournalId)
+			{
+				records.push_back(journalData.Slice(record + sizeof(flatbuffers::uoffset_t), recordSize - sizeof(flatbuffers::uoffset_t)));
+			}
+		});
+
+	return true;
+}
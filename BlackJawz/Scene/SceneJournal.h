@@ -0,0 +1,34 @@
+#pragma once
+#include "SceneData.h"
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "../ecs_generated.h"
+
+namespace BlackJawz::Scene
+{
+	// Append-only log of SceneDelta records stored next to a scene file. Each record
+	// is size prefixed and tagged with the journal id of the base it applies to.
+	class SceneJournal
+	{
+	public:
+		// Compact into a new base once the journal grows past this fraction of the base file
+		static constexpr double CompactionRatio = 0.25;
+
+		static std::string GetJournalPath(const std::string& sceneFile) { return sceneFile + ".journal"; }
+
+		static flatbuffers::DetachedBuffer WriteDelta(uint64_t baseJournalId, const EntityData* entities, size_t count,
+			const std::vector<uint32_t>& removed);
+
+		// Cuts off a torn record left by an interrupted save before appending
+		static bool Append(const std::string& sceneFile, const uint8_t* data, size_t size);
+		static void Discard(const std::string& sceneFile);
+
+		static bool ShouldCompact(const std::string& sceneFile);
+
+		// Records that apply to the base, in save order. A torn record at the end, left by an
+		// interrupted save, ends the log.
+		static bool ReadDeltas(const std::string& sceneFile, uint64_t baseJournalId, std::vector<Blob>& records);
+	};
+}
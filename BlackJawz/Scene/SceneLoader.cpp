@@ -0,0 +1,509 @@
+#include "SceneLoader.h"
+#include "SceneBounds.h"
+#include "SceneJournal.h"
+#include "SceneAssets.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+	double ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+BlackJawz::Scene::SceneLoader::SceneLoader(Jobs::JobSystem& jobSystem, ResourceBackend& backend)
+	: jobSystem(jobSystem), uploadQueue(backend)
+{
+
+}
+
+BlackJawz::Scene::SceneLoader::~SceneLoader()
+{
+	// The decode job references this loader
+	jobSystem.Wait(loadCounter);
+}
+
+bool BlackJawz::Scene::SceneLoader::Load(const std::string& filename, LoadedScene& scene)
+{
+	if (!Begin(filename, scene))
+		return false;
+
+	Wait();
+	return GetState() == State::Decoded;
+}
+
+bool BlackJawz::Scene::SceneLoader::Begin(const std::string& filename, LoadedScene& scene)
+{
+	return BeginRange(filename, 0, 0, scene);
+}
+
+bool BlackJawz::Scene::SceneLoader::BeginRange(const std::string& filename, uint64_t offset, uint64_t size, LoadedScene& scene)
+{
+	if (!Reset(scene))
+		return false;
+
+	jobSystem.Execute(loadCounter, [this, filename, offset, size, &scene]() { Decode(filename, offset, size, scene); });
+	return true;
+}
+
+bool BlackJawz::Scene::SceneLoader::BeginMemory(Blob fileData, LoadedScene& scene)
+{
+	if (!Reset(scene))
+		return false;
+
+	scene.fileData = std::move(fileData);
+	jobSystem.Execute(loadCounter, [this, &scene]() { Decode(std::string(), 0, 0, scene); });
+	return true;
+}
+
+bool BlackJawz::Scene::SceneLoader::Reset(LoadedScene& scene)
+{
+	if (GetState() == State::Decoding)
+		return false;
+
+	// Finish the previous load's uploads before its slots are reused
+	jobSystem.Wait(loadCounter);
+	uploadQueue.Finish();
+
+	stats = LoadStats();
+	scene = LoadedScene();
+	entityCount.store(0, std::memory_order_relaxed);
+	decodedCount.store(0, std::memory_order_relaxed);
+	invalidComponents.store(0, std::memory_order_relaxed);
+	state.store(State::Decoding, std::memory_order_release);
+	return true;
+}
+
+void BlackJawz::Scene::SceneLoader::Wait()
+{
+	jobSystem.Wait(loadCounter);
+
+	auto start = std::chrono::steady_clock::now();
+	uploadQueue.Finish();
+	stats.uploadMs = ElapsedMs(start);
+}
+
+void BlackJawz::Scene::SceneLoader::Decode(const std::string& filename, uint64_t offset, uint64_t size, LoadedScene& scene)
+{
+	auto start = std::chrono::steady_clock::now();
+
+	// Without a filename the data is already in memory
+	if (!filename.empty())
+	{
+		bool read = size > 0 ? SceneReader::ReadFileRange(filename, offset, size, scene.fileData) : SceneReader::ReadFile(filename, scene.fileData);
+		if (!read)
+		{
+			state.store(State::Failed, std::memory_order_release);
+			return;
+		}
+	}
+
+	stats.readMs = ElapsedMs(start);
+	stats.fileBytes = scene.fileData.size;
+
+	if (verifyFiles)
+	{
+		start = std::chrono::steady_clock::now();
+		stats.verifyResult = SceneVerifier::VerifyStructure(scene.fileData.data, scene.fileData.size);
+		stats.verifyMs = ElapsedMs(start);
+
+		if (stats.verifyResult != VerifyResult::Valid)
+		{
+			state.store(State::Failed, std::memory_order_release);
+			return;
+		}
+	}
+
+	const ECS::Scene* fileScene = ECS::GetScene(scene.fileData.data);
+
+	start = std::chrono::steady_clock::now();
+	PrepareAssets(fileScene, scene);
+
+	// A missing journal is the normal case right after a full save
+	scene.journalId = size > 0 || filename.empty() ? 0 : fileScene->journal_id();
+	if (scene.journalId != 0)
+	{
+		SceneJournal::ReadDeltas(filename, scene.journalId, scene.journalRecords);
+	}
+
+	size_t count = 0;
+	std::vector<SceneReader::EntityRange> ranges = SceneReader::GetEntityRanges(fileScene, count);
+
+	nextBufferSlot.store(0, std::memory_order_relaxed);
+	nextTextureSlot.store(0, std::memory_order_relaxed);
+
+	bool indexRead = false;
+	if (!scene.journalRecords.empty())
+	{
+		size_t baseCount = count;
+		for (const Blob& record : scene.journalRecords)
+		{
+			SceneReader::AddDeltaRanges(record, ranges, count);
+		}
+
+		DecodeJournaled(ranges, baseCount, count, scene);
+	}
+	else
+	{
+		// The file's index is read first. Rebuilding it fills in missing mesh bounds, which must not
+		// happen under entities already handed out, so those are held back until it is built.
+		if (buildSpatialIndex)
+		{
+			auto indexStart = std::chrono::steady_clock::now();
+			indexRead = scene.spatialIndex.Read(fileScene->spatial_index(), count, scene.fileData);
+			stats.spatialIndexMs = ElapsedMs(indexStart);
+		}
+		bool handOutRanges = indexRead || !buildSpatialIndex;
+
+		scene.entities.resize(count);
+		scene.resourceSlots.resize(count);
+
+		// Upper bound, every entity owning its own geometry and textures
+		uploadQueue.GetBackend().Reserve(count * 2, count * TextureSlotCount);
+		uploadQueue.ResetSlots(count * 2, count * TextureSlotCount);
+
+		rangesDone.assign(ranges.size(), 0);
+		nextPendingRange = 0;
+		entityCount.store(count, std::memory_order_release);
+
+		Jobs::JobCounter decodeCounter;
+		jobSystem.Dispatch(decodeCounter, static_cast<uint32_t>(ranges.size()), 1, [this, &ranges, &scene, handOutRanges](uint32_t index)
+			{
+				LoadRange(ranges[index], scene);
+				if (handOutRanges)
+				{
+					CompleteRange(ranges, index);
+				}
+			});
+		jobSystem.Wait(decodeCounter);
+	}
+
+	for (auto& slots : sharedSlots)
+	{
+		slots.clear();
+	}
+
+	scene.bufferCount = nextBufferSlot.load(std::memory_order_relaxed);
+	scene.textureCount = nextTextureSlot.load(std::memory_order_relaxed);
+	stats.invalidComponents = invalidComponents.load(std::memory_order_relaxed);
+	stats.failedAssets = failedAssets.load(std::memory_order_relaxed);
+	stats.decompressMs = decompressNs.load(std::memory_order_relaxed) / 1e6;
+
+	stats.decodeMs = ElapsedMs(start) - stats.spatialIndexMs;
+
+	if (buildSpatialIndex && !indexRead)
+	{
+		start = std::chrono::steady_clock::now();
+		LoadSpatialIndex(fileScene, scene);
+		stats.spatialIndexMs += ElapsedMs(start);
+	}
+
+	decodedCount.store(scene.entities.size(), std::memory_order_release);
+	state.store(State::Decoded, std::memory_order_release);
+}
+
+void BlackJawz::Scene::SceneLoader::CompleteRange(const std::vector<SceneReader::EntityRange>& ranges, uint32_t index)
+{
+	std::lock_guard<std::mutex> lock(rangeMutex);
+	rangesDone[index] = 1;
+
+	size_t decoded = decodedCount.load(std::memory_order_relaxed);
+	while (nextPendingRange < ranges.size() && rangesDone[nextPendingRange])
+	{
+		decoded += ranges[nextPendingRange++].count;
+	}
+	decodedCount.store(decoded, std::memory_order_release);
+}
+
+void BlackJawz::Scene::SceneLoader::LoadSpatialIndex(const ECS::Scene* fileScene, LoadedScene& scene)
+{
+	// Journal records move, add and remove entities after the index was written
+	if (scene.journalRecords.empty() && scene.spatialIndex.Read(fileScene->spatial_index(), scene.entities.size(), scene.fileData))
+		return;
+
+	ComputeMissingBounds(scene.entities, jobSystem);
+	scene.spatialIndex.Build(scene.entities, jobSystem);
+	stats.spatialIndexRebuilt = true;
+}
+
+void BlackJawz::Scene::SceneLoader::PrepareAssets(const ECS::Scene* fileScene, LoadedScene& scene)
+{
+	fileAssets = fileScene->assets();
+	failedAssets.store(0, std::memory_order_relaxed);
+	decompressNs.store(0, std::memory_order_relaxed);
+
+	size_t assetCount = fileAssets ? fileAssets->size() : 0;
+	scene.assets.resize(assetCount);
+	assetsDecoded = std::make_unique<std::once_flag[]>(assetCount);
+
+	for (size_t i = 0; i < assetCount; ++i)
+	{
+		const ECS::Asset* asset = fileAssets->Get(static_cast<uint32_t>(i));
+		stats.assetBytes += asset->data() ? asset->data()->size() : 0;
+		stats.rawAssetBytes += asset->raw_size();
+	}
+}
+
+void BlackJawz::Scene::SceneLoader::DecodeAsset(int32_t index, LoadedScene& scene)
+{
+	if (index < 0 || static_cast<size_t>(index) >= scene.assets.size())
+		return;
+
+	// Every entity referencing an asset shares the decoded blob, ranges reaching it while another
+	// is decoding it wait for that one instead of decompressing it again
+	std::call_once(assetsDecoded[index], [this, index, &scene]()
+		{
+			auto start = std::chrono::steady_clock::now();
+			if (!SceneAssets::Decode(fileAssets->Get(static_cast<uint32_t>(index)), scene.fileData, scene.assets[index]))
+			{
+				failedAssets.fetch_add(1, std::memory_order_relaxed);
+			}
+			decompressNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(),
+				std::memory_order_relaxed);
+		});
+}
+
+bool BlackJawz::Scene::SceneLoader::AreResourcesReady(const ResourceSlots& slots) const
+{
+	auto isReady = [this](ResourceKind kind, int32_t slot)
+		{
+			return slot < 0 || uploadQueue.IsSlotReady(kind, static_cast<uint32_t>(slot));
+		};
+
+	if (!isReady(ResourceKind::Buffer, slots.vertexBuffer) || !isReady(ResourceKind::Buffer, slots.indexBuffer))
+		return false;
+
+	for (int32_t textureSlot : slots.textures)
+	{
+		if (!isReady(ResourceKind::Texture, textureSlot))
+			return false;
+	}
+
+	return true;
+}
+
+void BlackJawz::Scene::SceneLoader::DecodeJournaled(const std::vector<SceneReader::EntityRange>& ranges, size_t baseCount,
+	size_t count, LoadedScene& scene)
+{
+	scene.entities.resize(count);
+	entityCount.store(count, std::memory_order_release);
+
+	Jobs::JobCounter decodeCounter;
+	jobSystem.Dispatch(decodeCounter, static_cast<uint32_t>(ranges.size()), 1, [this, &ranges, &scene](uint32_t index)
+		{
+			DecodeRange(ranges[index], scene);
+		});
+	jobSystem.Wait(decodeCounter);
+
+	ReplayJournal(baseCount, scene);
+
+	size_t liveCount = scene.entities.size();
+	scene.resourceSlots.resize(liveCount);
+
+	uploadQueue.GetBackend().Reserve(liveCount * 2, liveCount * TextureSlotCount);
+	uploadQueue.ResetSlots(liveCount * 2, liveCount * TextureSlotCount);
+	entityCount.store(liveCount, std::memory_order_release);
+
+	uint32_t rangeCount = static_cast<uint32_t>((liveCount + SceneReader::EntitiesPerRange - 1) / SceneReader::EntitiesPerRange);
+
+	Jobs::JobCounter uploadCounter;
+	jobSystem.Dispatch(uploadCounter, rangeCount, 1, [this, liveCount, &scene](uint32_t index)
+		{
+			size_t begin = static_cast<size_t>(index) * SceneReader::EntitiesPerRange;
+			QueueUploads(begin, std::min<size_t>(SceneReader::EntitiesPerRange, liveCount - begin), scene);
+		});
+	jobSystem.Wait(uploadCounter);
+}
+
+void BlackJawz::Scene::SceneLoader::ReplayJournal(size_t baseCount, LoadedScene& scene)
+{
+	std::vector<EntityData>& entities = scene.entities;
+
+	std::vector<bool> live(entities.size(), false);
+	std::unordered_map<uint32_t, size_t> liveIndices;
+	liveIndices.reserve(entities.size());
+
+	for (size_t i = 0; i < baseCount; ++i)
+	{
+		live[i] = true;
+		liveIndices[entities[i].id] = i;
+	}
+
+	// Delta entities follow the base in record order, see Decode
+	size_t next = baseCount;
+	for (const Blob& record : scene.journalRecords)
+	{
+		const ECS::SceneDelta* delta = flatbuffers::GetRoot<ECS::SceneDelta>(record.data);
+
+		if (delta->removed())
+		{
+			for (uint32_t id : *delta->removed())
+			{
+				auto it = liveIndices.find(id);
+				if (it != liveIndices.end())
+				{
+					live[it->second] = false;
+					liveIndices.erase(it);
+				}
+			}
+		}
+
+		uint32_t deltaCount = delta->entities() ? delta->entities()->size() : 0;
+		for (uint32_t i = 0; i < deltaCount; ++i, ++next)
+		{
+			EntityData& update = entities[next];
+
+			auto it = liveIndices.find(update.id);
+			if (it == liveIndices.end())
+			{
+				// Added since the base was written
+				live[next] = true;
+				liveIndices.emplace(update.id, next);
+				continue;
+			}
+
+			// Records only carry the components that changed. The name is set whenever the record has one,
+			// an empty name included.
+			EntityData& target = entities[it->second];
+			if (delta->entities()->Get(i)->name())
+				target.name = std::move(update.name);
+			if (update.transform)
+				target.transform = std::move(update.transform);
+			if (update.appearance)
+				target.appearance = std::move(update.appearance);
+			if (update.light)
+				target.light = std::move(update.light);
+		}
+	}
+
+	// Keep file order, entities added by the journal come last
+	size_t liveCount = 0;
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		if (!live[i])
+			continue;
+
+		if (i != liveCount)
+			entities[liveCount] = std::move(entities[i]);
+		++liveCount;
+	}
+	entities.resize(liveCount);
+}
+
+void BlackJawz::Scene::SceneLoader::LoadRange(const SceneReader::EntityRange& range, LoadedScene& scene)
+{
+	DecodeRange(range, scene);
+	QueueUploads(range.firstEntity, range.count, scene);
+}
+
+void BlackJawz::Scene::SceneLoader::DecodeRange(const SceneReader::EntityRange& range, LoadedScene& scene)
+{
+	const Blob& fileData = range.recordData ? *range.recordData : scene.fileData;
+
+	for (uint32_t i = 0; i < range.count; ++i)
+	{
+		const ECS::Entity* entity = range.entities->Get(range.begin + i);
+		if (entity)
+		{
+			SceneReader::ForEachAssetIndex(entity, [this, &scene](int32_t asset) { DecodeAsset(asset, scene); });
+			SceneReader::ReadEntity(entity, fileData, scene.assets, scene.entities[range.firstEntity + i]);
+		}
+	}
+}
+
+void BlackJawz::Scene::SceneLoader::QueueUploads(size_t firstEntity, size_t count, LoadedScene& scene)
+{
+	SlotMaps slotMaps;
+	std::vector<UploadRequest> batch;
+	batch.reserve(UploadQueue::BatchSize);
+	SceneVerifier verifier;
+
+	for (size_t entityIndex = firstEntity; entityIndex < firstEntity + count; ++entityIndex)
+	{
+		EntityData& data = scene.entities[entityIndex];
+
+		// Components that fail are dropped, the rest of the entity still loads
+		if (verifyFiles)
+		{
+			for (VerifyResult result = verifier.VerifyEntity(data); result != VerifyResult::Valid; result = verifier.VerifyEntity(data))
+			{
+				if (result == VerifyResult::BadLight)
+					data.light.reset();
+				else
+					data.appearance.reset();
+				invalidComponents.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+
+		if (!data.appearance)
+			continue;
+
+		const GeometryData& geometry = data.appearance->geometry;
+		ResourceSlots& resourceSlots = scene.resourceSlots[entityIndex];
+
+		resourceSlots.vertexBuffer = QueueUpload(ResourceKind::Buffer, geometry.vertexBuffer, geometry.vertexBufferStride, slotMaps, batch);
+		resourceSlots.indexBuffer = QueueUpload(ResourceKind::Buffer, geometry.indexBuffer, sizeof(uint32_t), slotMaps, batch);
+
+		for (size_t slot = 0; slot < TextureSlotCount; ++slot)
+		{
+			resourceSlots.textures[slot] = QueueUpload(ResourceKind::Texture, data.appearance->textures[slot], 0, slotMaps, batch);
+		}
+
+		if (batch.size() >= UploadQueue::BatchSize)
+		{
+			uploadQueue.Submit(std::move(batch));
+			batch = std::vector<UploadRequest>();
+			batch.reserve(UploadQueue::BatchSize);
+		}
+	}
+
+	uploadQueue.Submit(std::move(batch));
+}
+
+int32_t BlackJawz::Scene::SceneLoader::QueueUpload(ResourceKind kind, const Blob& blob, uint32_t stride,
+	SlotMaps& slotMaps, std::vector<UploadRequest>& batch)
+{
+	if (blob.Empty())
+		return -1;
+
+	auto& slots = slotMaps[static_cast<size_t>(kind)];
+	auto it = slots.find(blob.data);
+	if (it != slots.end())
+		return it->second;
+
+	SharedSlot* sharedSlot = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(sharedSlotMutex);
+		std::unique_ptr<SharedSlot>& entry = sharedSlots[static_cast<size_t>(kind)][blob.data];
+		if (!entry)
+		{
+			entry = std::make_unique<SharedSlot>();
+		}
+		sharedSlot = entry.get();
+	}
+
+	// Other ranges reaching the blob meanwhile wait for this slot rather than preparing it again.
+	// Failed requests are remembered too, so a bad texture is only parsed once.
+	std::call_once(sharedSlot->queued, [&]()
+		{
+			UploadRequest request;
+			request.kind = kind;
+			request.stride = stride;
+			request.data = blob;
+
+			if (!uploadQueue.GetBackend().Prepare(request))
+				return;
+
+			std::atomic<uint32_t>& nextSlot = kind == ResourceKind::Texture ? nextTextureSlot : nextBufferSlot;
+			sharedSlot->slot = static_cast<int32_t>(nextSlot.fetch_add(1, std::memory_order_relaxed));
+
+			request.slot = static_cast<uint32_t>(sharedSlot->slot);
+			batch.push_back(std::move(request));
+		});
+
+	slots.emplace(blob.data, sharedSlot->slot);
+	return sharedSlot->slot;
+}
@@ -0,0 +1,184 @@
+#pragma once
+#include "SceneData.h"
+#include "SceneReader.h"
+#include "SceneVerifier.h"
+#include "SpatialIndex.h"
+#include "UploadQueue.h"
+#include "../Util/JobSystem.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace BlackJawz::Scene
+{
+	// Backend slots used by one entity, -1 when the entity has no such resource
+	struct ResourceSlots
+	{
+		int32_t vertexBuffer = -1;
+		int32_t indexBuffer = -1;
+		std::array<int32_t, TextureSlotCount> textures;
+
+		ResourceSlots() { textures.fill(-1); }
+	};
+
+	struct LoadedScene
+	{
+		Blob fileData; // Keeps the blobs referenced by entities alive
+		std::vector<Blob> journalRecords; // Same for entities replayed from the journal
+		std::vector<Blob> assets; // Decoded asset section, indexed like ECS::Scene::assets, empty for assets no entity uses
+		uint64_t journalId = 0; // Journal id of the base file, 0 when it was not saved for journaling
+
+		std::vector<EntityData> entities;
+		std::vector<ResourceSlots> resourceSlots; // Parallel to entities
+
+		size_t bufferCount = 0;
+		size_t textureCount = 0;
+
+		// Over the entities in the order above, read from the file or rebuilt when it has none
+		SpatialIndex spatialIndex;
+	};
+
+	// Timings of the last load, in milliseconds
+	struct LoadStats
+	{
+		double readMs = 0.0;
+		double decompressMs = 0.0; // Decoding assets, summed over the workers and part of decodeMs
+		double decodeMs = 0.0;
+		double uploadMs = 0.0; // Time spent waiting on the loader thread after decoding finished
+
+		uint64_t fileBytes = 0;
+		uint64_t assetBytes = 0; // Asset section as stored in the file
+		uint64_t rawAssetBytes = 0; // And once decompressed
+		size_t failedAssets = 0;
+
+		double verifyMs = 0.0; // Structure only, entities are checked as they are decoded
+		VerifyResult verifyResult = VerifyResult::Valid; // Why the file was rejected
+		size_t invalidComponents = 0; // Dropped for failing verification
+
+		double spatialIndexMs = 0.0;
+		bool spatialIndexRebuilt = false; // The file had no usable index, or a journal applied on top of it
+	};
+
+	// Decodes a scene file on the job system and streams its resources through the upload queue
+	class SceneLoader
+	{
+	public:
+		enum class State
+		{
+			Idle,
+			Decoding,
+			Decoded, // Every entity is decoded, resources may still be uploading
+			Failed
+		};
+
+		SceneLoader(Jobs::JobSystem& jobSystem, ResourceBackend& backend);
+		~SceneLoader();
+
+		// Blocks until the scene is decoded and every resource has been created
+		bool Load(const std::string& filename, LoadedScene& scene);
+
+		// Start reading and decoding in the background, the scene must outlive the load.
+		// Returns false while a previous load is still decoding.
+		bool Begin(const std::string& filename, LoadedScene& scene);
+
+		// Same for size bytes of the file holding a standalone Scene, such as one cell of a world partitioned
+		// scene. Journals only apply to whole files.
+		bool BeginRange(const std::string& filename, uint64_t offset, uint64_t size, LoadedScene& scene);
+
+		// Same for a scene already in memory, such as one from an archive. Journals are not applied.
+		bool BeginMemory(Blob fileData, LoadedScene& scene);
+
+		// Block until decoding and all uploads have finished
+		void Wait();
+
+		// Files are verified before they are read unless this is turned off, for trusted files such as
+		// the cooker's output in a shipped build. Applies to the next load.
+		void SetVerifyFiles(bool verify) { verifyFiles = verify; }
+
+		// Scenes get a spatial index unless this is turned off, for tools that change the entities
+		// before using it. Applies to the next load.
+		void SetBuildSpatialIndex(bool build) { buildSpatialIndex = build; }
+
+		State GetState() const { return state.load(std::memory_order_acquire); }
+		size_t GetEntityCount() const { return entityCount.load(std::memory_order_acquire); }
+
+		// Entities are decoded in file order as far as this count, with their uploads queued, and can be
+		// read while later ones are still decoding. Journaled files and files whose spatial index is
+		// rebuilt change their entities after decoding, their count jumps to the total at the end.
+		size_t GetDecodedCount() const { return decodedCount.load(std::memory_order_acquire); }
+
+		// True once every resource the entity uses has been through the loader thread
+		bool AreResourcesReady(const ResourceSlots& slots) const;
+
+		const LoadStats& GetStats() const { return stats; }
+		UploadQueue& GetUploadQueue() { return uploadQueue; }
+
+	private:
+		// Waits for the previous load, false while it is still decoding
+		bool Reset(LoadedScene& scene);
+
+		// A size of 0 reads the whole file, an empty filename decodes scene.fileData as it is
+		void Decode(const std::string& filename, uint64_t offset, uint64_t size, LoadedScene& scene);
+
+		// Assets are decoded by the first range that references them, so the first entities do not wait
+		// on the whole asset section and assets no entity uses are never decompressed
+		void PrepareAssets(const ECS::Scene* fileScene, LoadedScene& scene);
+		void DecodeAsset(int32_t index, LoadedScene& scene);
+
+		// Slots one range has already looked up, per ResourceKind, so it only goes to the shared table once per blob
+		using SlotMaps = std::array<std::unordered_map<const uint8_t*, int32_t>, 2>;
+
+		// Slot of a blob for the whole load, queued by the first range to reach it
+		struct SharedSlot
+		{
+			std::once_flag queued;
+			int32_t slot = -1;
+		};
+
+		// Decode one range and queue uploads for the blobs it references
+		void LoadRange(const SceneReader::EntityRange& range, LoadedScene& scene);
+		void DecodeRange(const SceneReader::EntityRange& range, LoadedScene& scene);
+		void QueueUploads(size_t firstEntity, size_t count, LoadedScene& scene);
+
+		// Ranges finish out of order, the decoded count only moves past ranges with every earlier one done
+		void CompleteRange(const std::vector<SceneReader::EntityRange>& ranges, uint32_t index);
+
+		// Decode the base and its journal records, then fold the records into the base entities
+		// before anything is uploaded, so replaced meshes and textures are never created
+		void DecodeJournaled(const std::vector<SceneReader::EntityRange>& ranges, size_t baseCount, size_t count, LoadedScene& scene);
+		static void ReplayJournal(size_t baseCount, LoadedScene& scene);
+		void LoadSpatialIndex(const ECS::Scene* fileScene, LoadedScene& scene);
+		int32_t QueueUpload(ResourceKind kind, const Blob& blob, uint32_t stride,
+			SlotMaps& slotMaps, std::vector<UploadRequest>& batch);
+
+		Jobs::JobSystem& jobSystem;
+		Jobs::JobCounter loadCounter;
+		UploadQueue uploadQueue;
+
+		std::atomic<State> state{ State::Idle };
+		std::atomic<size_t> entityCount{ 0 };
+		std::atomic<size_t> decodedCount{ 0 };
+
+		std::mutex rangeMutex;
+		std::vector<uint8_t> rangesDone;
+		size_t nextPendingRange = 0;
+
+		bool verifyFiles = true;
+		bool buildSpatialIndex = true;
+		std::atomic<size_t> invalidComponents{ 0 };
+
+		const flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>* fileAssets = nullptr;
+		std::unique_ptr<std::once_flag[]> assetsDecoded;
+		std::atomic<size_t> failedAssets{ 0 };
+		std::atomic<int64_t> decompressNs{ 0 };
+
+		std::atomic<uint32_t> nextBufferSlot{ 0 };
+		std::atomic<uint32_t> nextTextureSlot{ 0 };
+
+		// Shared meshes and textures are decoded and created once per load, however many ranges use them
+		std::mutex sharedSlotMutex;
+		std::array<std::unordered_map<const uint8_t*, std::unique_ptr<SharedSlot>>, 2> sharedSlots;
+
+		LoadStats stats;
+	};
+}
@@ -0,0 +1,260 @@
+#include "SceneReader.h"
+#include "SceneReflection.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool BlackJawz::Scene::SceneReader::ReadFile(const std::string& filename, Blob& fileData)
+{
+	std::ifstream inFile(filename, std::ios::binary | std::ios::ate);
+	if (!inFile)
+		return false;
+
+	std::streamsize size = inFile.tellg();
+	if (size <= 0)
+		return false;
+
+	std::vector<uint8_t> buffer(static_cast<size_t>(size));
+	inFile.seekg(0, std::ios::beg);
+	if (!inFile.read(reinterpret_cast<char*>(buffer.data()), size))
+		return false;
+
+	fileData = Blob::FromVector(std::move(buffer));
+	return true;
+}
+
+bool BlackJawz::Scene::SceneReader::ReadFileRange(const std::string& filename, uint64_t offset, uint64_t size, Blob& data)
+{
+	std::ifstream inFile(filename, std::ios::binary);
+	if (!inFile || size == 0)
+		return false;
+
+	std::vector<uint8_t> buffer(static_cast<size_t>(size));
+	inFile.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	if (!inFile.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(size)))
+		return false;
+
+	data = Blob::FromVector(std::move(buffer));
+	return true;
+}
+
+bool BlackJawz::Scene::SceneReader::MapFile(const std::string& filename, Blob& fileData)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize = {};
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	// The view keeps the mapping and the file open once the handles are closed
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+	if (!mapping)
+		return false;
+
+	void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+	if (!view)
+		return false;
+
+	fileData.owner = std::shared_ptr<const void>(view, [](const void* address) { UnmapViewOfFile(address); });
+	fileData.data = static_cast<const uint8_t*>(view);
+	fileData.size = static_cast<size_t>(fileSize.QuadPart);
+	return true;
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat status = {};
+	if (fstat(file, &status) != 0 || status.st_size <= 0)
+	{
+		close(file);
+		return false;
+	}
+
+	size_t size = static_cast<size_t>(status.st_size);
+	void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (view == MAP_FAILED)
+		return false;
+
+	// Entities are walked front to back, read ahead of them
+	madvise(view, size, MADV_SEQUENTIAL);
+
+	fileData.owner = std::shared_ptr<const void>(view, [size](const void* address) { munmap(const_cast<void*>(address), size); });
+	fileData.data = static_cast<const uint8_t*>(view);
+	fileData.size = size;
+	return true;
+#endif
+}
+
+void BlackJawz::Scene::SceneReader::AddRanges(const EntityVector* entities, uint32_t rangeSize,
+	std::vector<EntityRange>& ranges, size_t& entityCount)
+{
+	uint32_t total = entities->size();
+	for (uint32_t begin = 0; begin < total; begin += rangeSize)
+	{
+		EntityRange range;
+		range.entities = entities;
+		range.begin = begin;
+		range.count = std::min(rangeSize, total - begin);
+		range.firstEntity = entityCount;
+
+		ranges.push_back(range);
+		entityCount += range.count;
+	}
+}
+
+std::vector<BlackJawz::Scene::SceneReader::EntityRange> BlackJawz::Scene::SceneReader::GetEntityRanges(const ECS::Scene* scene,
+	size_t& entityCount)
+{
+	std::vector<EntityRange> ranges;
+	entityCount = 0;
+
+	if (!scene)
+		return ranges;
+
+	if (scene->entities())
+	{
+		AddRanges(scene->entities(), EntitiesPerRange, ranges, entityCount);
+	}
+
+	if (scene->chunks())
+	{
+		for (const auto* chunk : *scene->chunks())
+		{
+			auto chunkScene = chunk ? chunk->data_nested_root() : nullptr;
+			if (chunkScene && chunkScene->entities() && chunkScene->entities()->size() > 0)
+			{
+				AddRanges(chunkScene->entities(), chunkScene->entities()->size(), ranges, entityCount);
+			}
+		}
+	}
+
+	return ranges;
+}
+
+void BlackJawz::Scene::SceneReader::AddDeltaRanges(const Blob& recordData, std::vector<EntityRange>& ranges, size_t& entityCount)
+{
+	const ECS::SceneDelta* delta = flatbuffers::GetRoot<ECS::SceneDelta>(recordData.data);
+	if (!delta->entities() || delta->entities()->size() == 0)
+		return;
+
+	size_t firstRange = ranges.size();
+	AddRanges(delta->entities(), delta->entities()->size(), ranges, entityCount);
+
+	for (size_t i = firstRange; i < ranges.size(); ++i)
+	{
+		ranges[i].recordData = &recordData;
+	}
+}
+
+BlackJawz::Scene::Blob BlackJawz::Scene::SceneReader::ReadBlob(const flatbuffers::Vector<uint8_t>* vector, int32_t assetIndex,
+	const Blob& fileData, const std::vector<Blob>& assets)
+{
+	if (assetIndex >= 0)
+		return static_cast<size_t>(assetIndex) < assets.size() ? assets[assetIndex] : Blob();
+
+	if (!vector || vector->size() == 0)
+		return Blob();
+
+	return fileData.Slice(vector->data(), vector->size());
+}
+
+void BlackJawz::Scene::SceneReader::ReadEntity(const ECS::Entity* entity, const Blob& fileData, const std::vector<Blob>& assets,
+	EntityData& data)
+{
+	data.id = entity->id();
+	if (entity->name())
+	{
+		data.name = entity->name()->str();
+	}
+
+	// --- Transform ---
+	if (auto transform = entity->transform())
+	{
+		Reflection::ReadTable(transform, data.transform.emplace());
+	}
+
+	// --- Appearance, only meaningful with geometry ---
+	auto appearance = entity->appearance();
+	if (appearance && appearance->geometry())
+	{
+		auto geometry = appearance->geometry();
+
+		AppearanceData& appearanceData = data.appearance.emplace();
+		appearanceData.geometry.indicesCount = geometry->indices_count();
+		appearanceData.geometry.vertexBufferStride = geometry->vertex_buffer_stride();
+		appearanceData.geometry.vertexBufferOffset = geometry->vertex_buffer_offset();
+		appearanceData.geometry.vertexBuffer = ReadBlob(geometry->vertex_buffer(), geometry->vertex_buffer_asset(), fileData, assets);
+		appearanceData.geometry.indexBuffer = ReadBlob(geometry->index_buffer(), geometry->index_buffer_asset(), fileData, assets);
+		appearanceData.geometry.vertexFormat = static_cast<VertexFormat>(geometry->vertex_format());
+
+		if (geometry->bounds_min() && geometry->bounds_min()->size() >= 3 && geometry->bounds_max() && geometry->bounds_max()->size() >= 3)
+		{
+			BoundsData& bounds = appearanceData.geometry.bounds.emplace();
+			memcpy(bounds.min, geometry->bounds_min()->data(), sizeof(bounds.min));
+			memcpy(bounds.max, geometry->bounds_max()->data(), sizeof(bounds.max));
+		}
+
+		if (auto texture = appearance->texture())
+		{
+			appearanceData.textures[static_cast<size_t>(TextureSlot::Diffuse)] = ReadBlob(texture->dds_data_diffuse(), texture->dds_asset_diffuse(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::Normal)] = ReadBlob(texture->dds_data_normal(), texture->dds_asset_normal(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::Metal)] = ReadBlob(texture->dds_data_metal(), texture->dds_asset_metal(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::Roughness)] = ReadBlob(texture->dds_data_roughness(), texture->dds_asset_roughness(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::AO)] = ReadBlob(texture->dds_data_ao(), texture->dds_asset_ao(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::Displacement)] = ReadBlob(texture->dds_data_displacement(), texture->dds_asset_displacement(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::Packed)] = ReadBlob(texture->dds_data_packed(), texture->dds_asset_packed(), fileData, assets);
+			appearanceData.textures[static_cast<size_t>(TextureSlot::ConeStep)] = ReadBlob(texture->dds_data_cone_step(), texture->dds_asset_cone_step(), fileData, assets);
+		}
+
+		if (auto instances = appearance->instances())
+		{
+			static_assert(sizeof(ECS::InstanceTransform) == sizeof(InstanceTransformData), "Instance transforms are copied whole");
+
+			InstancesData& instancesData = appearanceData.instances.emplace();
+			if (auto transforms = instances->transforms())
+			{
+				instancesData.transforms.resize(transforms->size());
+				memcpy(instancesData.transforms.data(), transforms->Data(), transforms->size() * sizeof(InstanceTransformData));
+			}
+
+			// Params that do not cover every instance are dropped rather than read past
+			auto params = instances->params();
+			if (params && instances->param_stride() > 0 &&
+				params->size() == static_cast<uint64_t>(instances->param_stride()) * instancesData.transforms.size())
+			{
+				instancesData.paramStride = instances->param_stride();
+				instancesData.params.assign(params->begin(), params->end());
+			}
+		}
+	}
+
+	// --- Light ---
+	if (auto light = entity->light())
+	{
+		Reflection::ReadTable(light, data.light.emplace());
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "SceneData.h"
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "../ecs_generated.h"
+
+namespace BlackJawz::Scene
+{
+	class SceneReader
+	{
+	public:
+		using EntityVector = flatbuffers::Vector<flatbuffers::Offset<ECS::Entity>>;
+
+		// A run of entities decoded by one job. Chunked scenes get one range per chunk
+		// so blobs shared inside a chunk are always seen by the same job.
+		struct EntityRange
+		{
+			const EntityVector* entities = nullptr;
+			uint32_t begin = 0;
+			uint32_t count = 0;
+			size_t firstEntity = 0; // Index of the first entity across the whole scene
+			const Blob* recordData = nullptr; // Journal record holding the entities, null for the scene file
+		};
+
+		// Entities per range for scenes saved before chunking
+		static constexpr uint32_t EntitiesPerRange = 256;
+
+		static bool ReadFile(const std::string& filename, Blob& fileData);
+		// Read size bytes starting at offset, fails if the file is too short
+		static bool ReadFileRange(const std::string& filename, uint64_t offset, uint64_t size, Blob& data);
+
+		// Maps the file read only instead of reading it, so pages are only read in when touched and
+		// files larger than memory can be walked. The mapping lasts as long as the blob's owner.
+		static bool MapFile(const std::string& filename, Blob& fileData);
+
+		// Split a scene into ranges, handles both the flat and the chunked layout
+		static std::vector<EntityRange> GetEntityRanges(const ECS::Scene* scene, size_t& entityCount);
+
+		// Append one range over a journal record's entities, the record must outlive the ranges
+		static void AddDeltaRanges(const Blob& recordData, std::vector<EntityRange>& ranges, size_t& entityCount);
+
+		// Decode one entity, inline blobs point straight into the file data and the rest
+		// come from the scene's decoded asset section
+		static void ReadEntity(const ECS::Entity* entity, const Blob& fileData, const std::vector<Blob>& assets, EntityData& data);
+
+		// Asset section indices an entity's payloads are stored at, the same fields ReadEntity reads.
+		// Payloads stored inline report -1.
+		template <typename Func>
+		static void ForEachAssetIndex(const ECS::Entity* entity, Func&& func)
+		{
+			auto appearance = entity->appearance();
+			if (!appearance || !appearance->geometry())
+				return;
+
+			func(appearance->geometry()->vertex_buffer_asset());
+			func(appearance->geometry()->index_buffer_asset());
+
+			if (auto texture = appearance->texture())
+			{
+				func(texture->dds_asset_diffuse());
+				func(texture->dds_asset_normal());
+				func(texture->dds_asset_metal());
+				func(texture->dds_asset_roughness());
+				func(texture->dds_asset_ao());
+				func(texture->dds_asset_displacement());
+				func(texture->dds_asset_packed());
+				func(texture->dds_asset_cone_step());
+			}
+		}
+
+	private:
+		static void AddRanges(const EntityVector* entities, uint32_t rangeSize, std::vector<EntityRange>& ranges, size_t& entityCount);
+		static Blob ReadBlob(const flatbuffers::Vector<uint8_t>* vector, int32_t assetIndex, const Blob& fileData,
+			const std::vector<Blob>& assets);
+	};
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "Reflection.h"
+#include "SceneData.h"
+#include "../ecs_generated.h"
+
+// Field lists of the scene records, in the same order as their members in SceneData.h
+namespace BlackJawz::Scene::Reflection
+{
+	template <>
+	struct Reflect<TransformData>
+	{
+		using Table = ECS::Transform;
+
+		static constexpr std::array<FieldInfo, 4> Fields =
+		{
+			BLACKJAWZ_FIELD(TransformData, position, ECS::Transform::VT_POSITION),
+			BLACKJAWZ_FIELD(TransformData, rotation, ECS::Transform::VT_ROTATION),
+			BLACKJAWZ_FIELD(TransformData, scale, ECS::Transform::VT_SCALE),
+			BLACKJAWZ_FIELD(TransformData, worldMatrix, ECS::Transform::VT_WORLD_MATRIX)
+		};
+	};
+	static_assert(CoversLayout<TransformData>(), "Every TransformData member needs a field");
+
+	template <>
+	struct Reflect<LightData>
+	{
+		using Table = ECS::Light;
+
+		static constexpr std::array<FieldInfo, 11> Fields =
+		{
+			BLACKJAWZ_FIELD(LightData, type, ECS::Light::VT_TYPE),
+			BLACKJAWZ_FIELD(LightData, diffuseLight, ECS::Light::VT_DIFFUSE_LIGHT),
+			BLACKJAWZ_FIELD(LightData, ambientLight, ECS::Light::VT_AMBIENT_LIGHT),
+			BLACKJAWZ_FIELD(LightData, specularLight, ECS::Light::VT_SPECULAR_LIGHT),
+			BLACKJAWZ_FIELD(LightData, specularPower, ECS::Light::VT_SPECULAR_POWER),
+			BLACKJAWZ_FIELD(LightData, range, ECS::Light::VT_RANGE),
+			BLACKJAWZ_FIELD(LightData, direction, ECS::Light::VT_DIRECTION),
+			BLACKJAWZ_FIELD(LightData, intensity, ECS::Light::VT_INTENSITY),
+			BLACKJAWZ_FIELD(LightData, attenuation, ECS::Light::VT_ATTENUATION),
+			BLACKJAWZ_FIELD(LightData, spotInnerCone, ECS::Light::VT_SPOT_INNER_CONE),
+			BLACKJAWZ_FIELD(LightData, spotOuterCone, ECS::Light::VT_SPOT_OUTER_CONE)
+		};
+	};
+	static_assert(CoversLayout<LightData>(), "Every LightData member needs a field");
+}
@@ -0,0 +1,154 @@
+#include "SceneVerifier.h"
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cstring>
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "../ecs_generated.h"
+
+namespace
+{
+	uint32_t Read32(const uint8_t* data)
+	{
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	// D3D11's largest 2D texture
+	constexpr uint32_t MaxTextureDimension = 16384;
+}
+
+const char* BlackJawz::Scene::GetVerifyResultName(VerifyResult result)
+{
+	switch (result)
+	{
+	case VerifyResult::Valid: return "Valid";
+	case VerifyResult::BadStructure: return "Bad structure";
+	case VerifyResult::BadVertexFormat: return "Bad vertex format";
+	case VerifyResult::VertexBufferTooSmall: return "Vertex buffer too small";
+	case VerifyResult::BadIndexBuffer: return "Bad index buffer";
+	case VerifyResult::IndexOutOfRange: return "Index out of range";
+	case VerifyResult::BadTexture: return "Bad texture";
+	case VerifyResult::BadLight: return "Bad light";
+	}
+	return "Unknown";
+}
+
+BlackJawz::Scene::VerifyResult BlackJawz::Scene::SceneVerifier::VerifyStructure(const uint8_t* data, size_t size)
+{
+	if (!data || size < sizeof(flatbuffers::uoffset_t) || size >= FLATBUFFERS_MAX_BUFFER_SIZE)
+		return VerifyResult::BadStructure;
+
+	// Every table takes at least 4 bytes, the default limit would reject large unchunked scenes
+	flatbuffers::Verifier::Options options;
+	options.max_tables = static_cast<flatbuffers::uoffset_t>(std::max<size_t>(options.max_tables, size / 4));
+
+	flatbuffers::Verifier verifier(data, size, options);
+	return ECS::VerifySceneBuffer(verifier) ? VerifyResult::Valid : VerifyResult::BadStructure;
+}
+
+BlackJawz::Scene::VerifyResult BlackJawz::Scene::SceneVerifier::VerifyEntity(const EntityData& entity)
+{
+	if (entity.light && (entity.light->type < ECS::LightType_MIN || entity.light->type > ECS::LightType_MAX))
+		return VerifyResult::BadLight;
+
+	if (!entity.appearance)
+		return VerifyResult::Valid;
+
+	const GeometryData& geometry = entity.appearance->geometry;
+	CheckedGeometry key;
+	key.vertexData = geometry.vertexBuffer.data;
+	key.vertexSize = geometry.vertexBuffer.size;
+	key.vertexBufferStride = geometry.vertexBufferStride;
+	key.vertexBufferOffset = geometry.vertexBufferOffset;
+	key.indicesCount = geometry.indicesCount;
+	key.vertexFormat = geometry.vertexFormat;
+	key.hasBounds = geometry.bounds.has_value();
+
+	auto it = checkedGeometry.find(geometry.indexBuffer.data);
+	if (it == checkedGeometry.end() || it->second.vertexData != key.vertexData || it->second.vertexSize != key.vertexSize ||
+		it->second.vertexBufferStride != key.vertexBufferStride || it->second.vertexBufferOffset != key.vertexBufferOffset ||
+		it->second.indicesCount != key.indicesCount || it->second.vertexFormat != key.vertexFormat || it->second.hasBounds != key.hasBounds)
+	{
+		key.result = VerifyGeometry(geometry);
+		it = checkedGeometry.insert_or_assign(geometry.indexBuffer.data, key).first;
+	}
+
+	if (it->second.result != VerifyResult::Valid)
+		return it->second.result;
+
+	for (const Blob& texture : entity.appearance->textures)
+	{
+		if (!texture.Empty() && !IsValidDDSHeader(texture))
+			return VerifyResult::BadTexture;
+	}
+
+	return VerifyResult::Valid;
+}
+
+BlackJawz::Scene::VerifyResult BlackJawz::Scene::SceneVerifier::VerifyGeometry(const GeometryData& geometry)
+{
+	uint32_t expectedStride = 0;
+	if (geometry.vertexFormat == VertexFormat::Float)
+		expectedStride = FloatVertexStride;
+	else if (geometry.vertexFormat == VertexFormat::Packed && geometry.bounds)
+		expectedStride = sizeof(PackedVertex);
+
+	if (expectedStride == 0 || geometry.vertexBufferStride != expectedStride)
+		return VerifyResult::BadVertexFormat;
+
+	if (geometry.vertexBufferOffset > geometry.vertexBuffer.size)
+		return VerifyResult::VertexBufferTooSmall;
+
+	size_t vertexCount = (geometry.vertexBuffer.size - geometry.vertexBufferOffset) / geometry.vertexBufferStride;
+
+	if (geometry.indexBuffer.size % sizeof(uint32_t) != 0 ||
+		static_cast<uint64_t>(geometry.indicesCount) * sizeof(uint32_t) > geometry.indexBuffer.size)
+	{
+		return VerifyResult::BadIndexBuffer;
+	}
+
+	if (geometry.indicesCount == 0)
+		return VerifyResult::Valid;
+
+	if (vertexCount == 0)
+		return VerifyResult::VertexBufferTooSmall;
+
+	// Blobs in the file are not necessarily 4 byte aligned
+	uint32_t maxIndex = 0;
+	const uint8_t* indices = geometry.indexBuffer.data;
+	for (uint32_t i = 0; i < geometry.indicesCount; ++i)
+	{
+		maxIndex = std::max(maxIndex, Read32(indices + i * sizeof(uint32_t)));
+	}
+
+	return maxIndex < vertexCount ? VerifyResult::Valid : VerifyResult::IndexOutOfRange;
+}
+
+bool BlackJawz::Scene::SceneVerifier::IsValidDDSHeader(const Blob& blob)
+{
+	// "DDS ", then the 124 byte header with its 32 byte pixel format at offset 76
+	const size_t headerSize = 4 + 124;
+	if (blob.size < headerSize)
+		return false;
+
+	const uint8_t* data = blob.data;
+	if (Read32(data) != 0x20534444 || Read32(data + 4) != 124 || Read32(data + 76) != 32)
+		return false;
+
+	uint32_t height = Read32(data + 12);
+	uint32_t width = Read32(data + 16);
+	if (width == 0 || height == 0 || width > MaxTextureDimension || height > MaxTextureDimension)
+		return false;
+
+	// A "DX10" four character code adds a 20 byte header
+	const uint32_t fourCCFlag = 0x4;
+	if ((Read32(data + 80) & fourCCFlag) && Read32(data + 84) == 0x30315844 && blob.size < headerSize + 20)
+		return false;
+
+	return true;
+}
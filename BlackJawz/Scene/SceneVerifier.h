@@ -0,0 +1,55 @@
+#pragma once
+#include "SceneData.h"
+
+#include <unordered_map>
+
+namespace BlackJawz::Scene
+{
+	enum class VerifyResult : uint32_t
+	{
+		Valid = 0,
+		BadStructure, // Failed the FlatBuffers verifier, nothing in the file can be read safely
+		BadVertexFormat, // Stride does not match the vertex format, or packed vertices without bounds
+		VertexBufferTooSmall,
+		BadIndexBuffer, // Not whole indices, or fewer than indices_count of them
+		IndexOutOfRange,
+		BadTexture, // Not a DDS file
+		BadLight
+	};
+
+	const char* GetVerifyResultName(VerifyResult result);
+
+	// Checks scene files before they are read. VerifyStructure runs the FlatBuffers verifier over the
+	// whole buffer, nested chunks included, and must pass before anything else touches the bytes.
+	// VerifyEntity then checks a decoded entity for what the schema cannot express: strides, index
+	// ranges and DDS headers.
+	class SceneVerifier
+	{
+	public:
+		static VerifyResult VerifyStructure(const uint8_t* data, size_t size);
+
+		// Geometry is remembered by its index buffer, so entities sharing a mesh only scan it once.
+		// Not thread safe, use one verifier per job.
+		VerifyResult VerifyEntity(const EntityData& entity);
+
+		static VerifyResult VerifyGeometry(const GeometryData& geometry);
+
+		// Magic, header sizes and dimensions only, the resource backend parses the rest
+		static bool IsValidDDSHeader(const Blob& blob);
+
+	private:
+		struct CheckedGeometry
+		{
+			const uint8_t* vertexData = nullptr;
+			size_t vertexSize = 0;
+			uint32_t vertexBufferStride = 0;
+			uint32_t vertexBufferOffset = 0;
+			uint32_t indicesCount = 0;
+			VertexFormat vertexFormat = VertexFormat::Float;
+			bool hasBounds = false;
+			VerifyResult result = VerifyResult::Valid;
+		};
+
+		std::unordered_map<const uint8_t*, CheckedGeometry> checkedGeometry;
+	};
+}
@@ -0,0 +1,382 @@
+#include "SceneWriter.h"
+#include "SceneReflection.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+flatbuffers::Offset<flatbuffers::Vector<uint8_t>> BlackJawz::Scene::SceneWriter::WriteBlob(flatbuffers::FlatBufferBuilder& builder,
+	const Blob& blob, BlobOffsets& writtenBlobs, const SceneAssets* assets)
+{
+	if (blob.Empty() || assets)
+		return 0;
+
+	auto it = writtenBlobs.find(blob.data);
+	if (it != writtenBlobs.end())
+		return it->second;
+
+	auto offset = builder.CreateVector(blob.data, blob.size);
+	writtenBlobs.emplace(blob.data, offset);
+	return offset;
+}
+
+flatbuffers::Offset<ECS::Entity> BlackJawz::Scene::SceneWriter::WriteEntity(flatbuffers::FlatBufferBuilder& builder,
+	const EntityData& entity, BlobOffsets& writtenBlobs, const SceneAssets* assets)
+{
+	auto nameOffset = builder.CreateString(entity.name);
+
+	// --- Transform ---
+	flatbuffers::Offset<ECS::Transform> transformOffset;
+	if (entity.transform)
+	{
+		transformOffset = Reflection::WriteTable(builder, *entity.transform);
+	}
+
+	// --- Appearance (Geometry + Textures) ---
+	flatbuffers::Offset<ECS::Appearance> appearanceOffset;
+	if (entity.appearance)
+	{
+		const AppearanceData& appearance = *entity.appearance;
+		const GeometryData& geometry = appearance.geometry;
+
+		flatbuffers::Offset<ECS::Geometry> geometryOffset;
+		if (!geometry.vertexBuffer.Empty() && !geometry.indexBuffer.Empty())
+		{
+			auto vertexBufferVec = WriteBlob(builder, geometry.vertexBuffer, writtenBlobs, assets);
+			auto indexBufferVec = WriteBlob(builder, geometry.indexBuffer, writtenBlobs, assets);
+
+			flatbuffers::Offset<flatbuffers::Vector<float>> boundsMinVec, boundsMaxVec;
+			if (geometry.bounds)
+			{
+				boundsMinVec = builder.CreateVector(geometry.bounds->min, 3);
+				boundsMaxVec = builder.CreateVector(geometry.bounds->max, 3);
+			}
+
+			geometryOffset = ECS::CreateGeometry(builder,
+				geometry.indicesCount,
+				geometry.vertexBufferStride,
+				geometry.vertexBufferOffset,
+				vertexBufferVec,
+				indexBufferVec,
+				assets ? assets->GetIndex(geometry.vertexBuffer) : -1,
+				assets ? assets->GetIndex(geometry.indexBuffer) : -1,
+				boundsMinVec,
+				boundsMaxVec,
+				static_cast<ECS::VertexFormat>(geometry.vertexFormat));
+		}
+
+		std::array<flatbuffers::Offset<flatbuffers::Vector<uint8_t>>, TextureSlotCount> textureVecs;
+		std::array<int32_t, TextureSlotCount> textureAssets;
+		for (size_t slot = 0; slot < TextureSlotCount; ++slot)
+		{
+			textureVecs[slot] = WriteBlob(builder, appearance.textures[slot], writtenBlobs, assets);
+			textureAssets[slot] = assets ? assets->GetIndex(appearance.textures[slot]) : -1;
+		}
+
+		auto textureOffset = ECS::CreateTexture(builder,
+			textureVecs[static_cast<size_t>(TextureSlot::Diffuse)],
+			textureVecs[static_cast<size_t>(TextureSlot::Normal)],
+			textureVecs[static_cast<size_t>(TextureSlot::Metal)],
+			textureVecs[static_cast<size_t>(TextureSlot::Roughness)],
+			textureVecs[static_cast<size_t>(TextureSlot::AO)],
+			textureVecs[static_cast<size_t>(TextureSlot::Displacement)],
+			textureAssets[static_cast<size_t>(TextureSlot::Diffuse)],
+			textureAssets[static_cast<size_t>(TextureSlot::Normal)],
+			textureAssets[static_cast<size_t>(TextureSlot::Metal)],
+			textureAssets[static_cast<size_t>(TextureSlot::Roughness)],
+			textureAssets[static_cast<size_t>(TextureSlot::AO)],
+			textureAssets[static_cast<size_t>(TextureSlot::Displacement)],
+			textureVecs[static_cast<size_t>(TextureSlot::Packed)],
+			textureAssets[static_cast<size_t>(TextureSlot::Packed)],
+			textureVecs[static_cast<size_t>(TextureSlot::ConeStep)],
+			textureAssets[static_cast<size_t>(TextureSlot::ConeStep)]);
+
+		flatbuffers::Offset<ECS::Instances> instancesOffset;
+		if (appearance.instances)
+		{
+			const InstancesData& instances = *appearance.instances;
+			auto transformsVec = builder.CreateVectorOfStructs(
+				reinterpret_cast<const ECS::InstanceTransform*>(instances.transforms.data()), instances.transforms.size());
+
+			flatbuffers::Offset<flatbuffers::Vector<float>> paramsVec;
+			if (instances.paramStride > 0 && instances.params.size() == instances.paramStride * instances.transforms.size())
+				paramsVec = builder.CreateVector(instances.params);
+
+			instancesOffset = ECS::CreateInstances(builder, transformsVec, paramsVec.IsNull() ? 0 : instances.paramStride, paramsVec);
+		}
+
+		appearanceOffset = ECS::CreateAppearance(builder, geometryOffset, textureOffset, instancesOffset);
+	}
+
+	// --- Light ---
+	flatbuffers::Offset<ECS::Light> lightOffset;
+	if (entity.light)
+	{
+		lightOffset = Reflection::WriteTable(builder, *entity.light);
+	}
+
+	return ECS::CreateEntity(builder, entity.id, nameOffset, transformOffset, appearanceOffset, lightOffset);
+}
+
+flatbuffers::DetachedBuffer BlackJawz::Scene::SceneWriter::WriteChunk(const EntityData* entities, size_t count, const SceneAssets* assets)
+{
+	flatbuffers::FlatBufferBuilder builder(64 * 1024);
+	BlobOffsets writtenBlobs;
+
+	std::vector<flatbuffers::Offset<ECS::Entity>> entityOffsets;
+	entityOffsets.reserve(count);
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		entityOffsets.push_back(WriteEntity(builder, entities[i], writtenBlobs, assets));
+	}
+
+	auto entitiesVector = builder.CreateVector(entityOffsets);
+	builder.Finish(ECS::CreateScene(builder, entitiesVector));
+
+	return builder.Release();
+}
+
+flatbuffers::DetachedBuffer BlackJawz::Scene::SceneWriter::MergeChunks(const std::vector<flatbuffers::DetachedBuffer>& chunks, uint64_t journalId,
+	const SceneAssets* assets, const SpatialIndex* spatialIndex)
+{
+	size_t totalSize = assets ? static_cast<size_t>(assets->GetStoredBytes()) : 0;
+	for (const auto& chunk : chunks)
+	{
+		totalSize += chunk.size();
+	}
+
+	flatbuffers::FlatBufferBuilder builder(totalSize + 1024);
+
+	std::vector<flatbuffers::Offset<ECS::SceneChunk>> chunkOffsets;
+	chunkOffsets.reserve(chunks.size());
+
+	for (const auto& chunk : chunks)
+	{
+		// Nested buffers may hold 8 byte scalars, keep them aligned inside the parent
+		builder.ForceVectorAlignment(chunk.size(), sizeof(uint8_t), 8);
+		auto dataVec = builder.CreateVector(chunk.data(), chunk.size());
+		chunkOffsets.push_back(ECS::CreateSceneChunk(builder, dataVec));
+	}
+
+	auto chunksVector = builder.CreateVector(chunkOffsets);
+	flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>> assetsVector;
+	if (assets)
+	{
+		assetsVector = assets->Write(builder);
+	}
+	flatbuffers::Offset<ECS::SpatialIndex> spatialIndexOffset;
+	if (spatialIndex && !spatialIndex->Empty())
+	{
+		spatialIndexOffset = spatialIndex->Write(builder);
+	}
+	builder.Finish(ECS::CreateScene(builder, 0, chunksVector, journalId, assetsVector, 0, spatialIndexOffset));
+
+	return builder.Release();
+}
+
+flatbuffers::DetachedBuffer BlackJawz::Scene::SceneWriter::MergeCells(const std::vector<CellData>& cells, float cellSize,
+	uint32_t nextEntityId)
+{
+	size_t totalSize = 0;
+	for (const auto& cell : cells)
+	{
+		totalSize += cell.data.size;
+	}
+
+	flatbuffers::FlatBufferBuilder builder(totalSize + cells.size() * 64 + 1024);
+
+	// The builder grows towards the front, so whatever is created first ends up at the end of the file
+	std::vector<flatbuffers::Offset<flatbuffers::Vector<uint8_t>>> dataVecs;
+	dataVecs.reserve(cells.size());
+	for (const auto& cell : cells)
+	{
+		builder.ForceVectorAlignment(cell.data.size, sizeof(uint8_t), 8);
+		dataVecs.push_back(builder.CreateVector(cell.data.data, cell.data.size));
+	}
+	uint64_t dataSectionSize = builder.GetSize();
+
+	std::vector<flatbuffers::Offset<ECS::SceneChunk>> chunkOffsets;
+	chunkOffsets.reserve(cells.size());
+	for (const auto& dataVec : dataVecs)
+	{
+		chunkOffsets.push_back(ECS::CreateSceneChunk(builder, dataVec));
+	}
+	auto chunksVector = builder.CreateVector(chunkOffsets);
+
+	std::vector<flatbuffers::Offset<ECS::SceneCell>> cellOffsets;
+	cellOffsets.reserve(cells.size());
+	for (size_t i = 0; i < cells.size(); ++i)
+	{
+		const CellData& cell = cells[i];
+		bool alwaysLoaded = cell.coord == AlwaysLoadedCell;
+
+		// An offset's value is its distance from the end of the buffer
+		cellOffsets.push_back(ECS::CreateSceneCell(builder,
+			alwaysLoaded ? 0 : cell.coord.x,
+			alwaysLoaded ? 0 : cell.coord.z,
+			alwaysLoaded,
+			static_cast<uint32_t>(i),
+			cell.entityCount,
+			dataVecs[i].o,
+			cell.data.size));
+	}
+	auto cellsVector = builder.CreateVector(cellOffsets);
+
+	// Created last so it sits next to the root, inside the first read of the header
+	auto partition = ECS::CreateWorldPartition(builder, cellSize, dataSectionSize, nextEntityId, cellsVector);
+	builder.Finish(ECS::CreateScene(builder, 0, chunksVector, 0, 0, partition));
+
+	return builder.Release();
+}
+
+bool BlackJawz::Scene::SceneWriter::WriteToFile(const std::string& filename, const uint8_t* data, size_t size)
+{
+	// Write to a temporary file first so a failed save never truncates the previous scene
+	std::string tempFilename = filename + ".tmp";
+	{
+		std::ofstream outFile(tempFilename, std::ios::binary | std::ios::trunc);
+		if (!outFile)
+			return false;
+
+		outFile.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+		if (!outFile)
+			return false;
+	}
+
+	std::error_code error;
+	std::filesystem::rename(tempFilename, filename, error);
+	return !error;
+}
+
+void BlackJawz::Scene::SceneWriter::AddTrailingVector(flatbuffers::FlatBufferBuilder& builder, flatbuffers::voffset_t field,
+	uint64_t distance)
+{
+	// What AddOffset stores, measured to a point past the end of the buffer instead of one inside it
+	builder.Align(sizeof(flatbuffers::uoffset_t));
+	uint64_t offset = builder.GetSize() + sizeof(flatbuffers::uoffset_t) + distance;
+	builder.AddElement<flatbuffers::uoffset_t>(field, static_cast<flatbuffers::uoffset_t>(offset), 0);
+}
+
+BlackJawz::Scene::SceneFileWriter::SceneFileWriter(size_t chunkCount, const SceneAssets* assets, const SpatialIndex* spatialIndex,
+	uint64_t journalId) : assets(assets), spatialIndex(spatialIndex), journalId(journalId),
+	assetPositions(assets ? assets->GetCount() : 0), chunkPositions(chunkCount), pendingChunks(chunkCount), chunksReady(chunkCount, 0)
+{
+
+}
+
+bool BlackJawz::Scene::SceneFileWriter::Open(const std::string& name)
+{
+	filename = name;
+
+	// Write to a temporary file first so a failed save never truncates the previous scene
+	file.open(filename + ".tmp", std::ios::binary | std::ios::trunc);
+	if (!file)
+		return false;
+
+	// Every position is still zero here, the real header comes out the same size
+	headerSize = BuildHeader().size();
+	std::vector<char> zeros(static_cast<size_t>(headerSize), 0);
+	file.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+	fileSize = headerSize;
+
+	for (size_t i = 0; i < assetPositions.size(); ++i)
+	{
+		const Blob& stored = assets->GetStored(i);
+		if (!WriteVector(stored.data, stored.size, assetPositions[i]))
+			return false;
+	}
+	return static_cast<bool>(file);
+}
+
+void BlackJawz::Scene::SceneFileWriter::AddChunk(size_t index, flatbuffers::DetachedBuffer chunk)
+{
+	std::lock_guard<std::mutex> lock(chunkMutex);
+	pendingChunks[index] = std::move(chunk);
+	chunksReady[index] = 1;
+
+	// Chunks go in in order, so the file is the same however the jobs were scheduled
+	while (nextChunk < chunksReady.size() && chunksReady[nextChunk])
+	{
+		flatbuffers::DetachedBuffer& next = pendingChunks[nextChunk];
+		if (!WriteVector(next.data(), next.size(), chunkPositions[nextChunk]))
+		{
+			failed = true;
+		}
+		next = flatbuffers::DetachedBuffer();
+		++nextChunk;
+	}
+}
+
+bool BlackJawz::Scene::SceneFileWriter::Finish()
+{
+	if (failed || !file || nextChunk != chunkPositions.size() || fileSize > FLATBUFFERS_MAX_BUFFER_SIZE)
+		return false;
+
+	flatbuffers::DetachedBuffer header = BuildHeader();
+	if (header.size() != headerSize)
+		return false;
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+	file.close();
+	if (!file)
+		return false;
+
+	std::error_code error;
+	std::filesystem::rename(filename + ".tmp", filename, error);
+	return !error;
+}
+
+flatbuffers::DetachedBuffer BlackJawz::Scene::SceneFileWriter::BuildHeader() const
+{
+	flatbuffers::FlatBufferBuilder builder(chunkPositions.size() * 16 + assetPositions.size() * 48 + 1024);
+
+	// Positions of vectors that have not been written yet are zero, the header only needs its size then
+	auto distance = [this](uint64_t position) { return position ? position - headerSize : 0; };
+
+	std::vector<flatbuffers::Offset<ECS::SceneChunk>> chunkOffsets;
+	chunkOffsets.reserve(chunkPositions.size());
+	for (uint64_t position : chunkPositions)
+	{
+		ECS::SceneChunkBuilder chunkBuilder(builder);
+		SceneWriter::AddTrailingVector(builder, ECS::SceneChunk::VT_DATA, distance(position));
+		chunkOffsets.push_back(chunkBuilder.Finish());
+	}
+
+	auto chunksVector = builder.CreateVector(chunkOffsets);
+	flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<ECS::Asset>>> assetsVector;
+	if (assets)
+	{
+		std::vector<uint64_t> distances(assetPositions.size());
+		std::transform(assetPositions.begin(), assetPositions.end(), distances.begin(), distance);
+		assetsVector = assets->WriteTrailing(builder, distances);
+	}
+	flatbuffers::Offset<ECS::SpatialIndex> spatialIndexOffset;
+	if (spatialIndex && !spatialIndex->Empty())
+	{
+		spatialIndexOffset = spatialIndex->Write(builder);
+	}
+	builder.Finish(ECS::CreateScene(builder, 0, chunksVector, journalId, assetsVector, 0, spatialIndexOffset));
+
+	return builder.Release();
+}
+
+bool BlackJawz::Scene::SceneFileWriter::WriteVector(const uint8_t* data, size_t size, uint64_t& position)
+{
+	static const char zeros[8] = {};
+
+	// The length sits 4 bytes in front of the 8 byte aligned data, the same as ForceVectorAlignment gives
+	uint64_t padding = (12 - fileSize % 8) % 8;
+	file.write(zeros, static_cast<std::streamsize>(padding));
+	position = fileSize + padding;
+
+	flatbuffers::uoffset_t length = flatbuffers::EndianScalar(static_cast<flatbuffers::uoffset_t>(size));
+	file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+	if (size)
+	{
+		file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+	}
+	fileSize = position + sizeof(length) + size;
+	return static_cast<bool>(file);
+}
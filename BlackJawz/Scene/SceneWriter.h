@@ -0,0 +1,100 @@
+#pragma once
+#include "SceneData.h"
+#include "SceneAssets.h"
+#include "SpatialIndex.h"
+#include "WorldPartition.h"
+
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "../ecs_generated.h"
+
+namespace BlackJawz::Scene
+{
+	class SceneWriter
+	{
+	public:
+		// Entities per chunk, small enough to spread a scene across every worker
+		static constexpr size_t EntitiesPerChunk = 256;
+
+		static size_t GetChunkCount(size_t entityCount) { return (entityCount + EntitiesPerChunk - 1) / EntitiesPerChunk; }
+
+		// Serialize a range of entities into its own builder, safe to call from any thread. With an
+		// asset section the entities reference its payloads by index instead of storing them inline.
+		static flatbuffers::DetachedBuffer WriteChunk(const EntityData* entities, size_t count, const SceneAssets* assets = nullptr);
+
+		// Wrap the finished chunks, the asset section and the spatial index into the top level Scene, journalId ties later
+		// journal records to this file. The index must number the entities in chunk order.
+		static flatbuffers::DetachedBuffer MergeChunks(const std::vector<flatbuffers::DetachedBuffer>& chunks, uint64_t journalId = 0,
+			const SceneAssets* assets = nullptr, const SpatialIndex* spatialIndex = nullptr);
+
+		// Wrap finished cells into a world partitioned Scene. Every cell's data goes at the end of the
+		// file ahead of the tables, so the cell index can be read without the data behind it.
+		static flatbuffers::DetachedBuffer MergeCells(const std::vector<CellData>& cells, float cellSize, uint32_t nextEntityId);
+
+		static bool WriteToFile(const std::string& filename, const uint8_t* data, size_t size);
+
+		// Point a table field at a vector that is written behind the finished buffer, distance bytes past its end
+		static void AddTrailingVector(flatbuffers::FlatBufferBuilder& builder, flatbuffers::voffset_t field, uint64_t distance);
+
+		// Blobs already written to the current builder, so shared meshes and textures are stored once per chunk
+		using BlobOffsets = std::unordered_map<const uint8_t*, flatbuffers::Offset<flatbuffers::Vector<uint8_t>>>;
+
+		// Only the components present in the entity are written
+		static flatbuffers::Offset<ECS::Entity> WriteEntity(flatbuffers::FlatBufferBuilder& builder,
+			const EntityData& entity, BlobOffsets& writtenBlobs, const SceneAssets* assets = nullptr);
+
+	private:
+		// Inline only when there is no asset section
+		static flatbuffers::Offset<flatbuffers::Vector<uint8_t>> WriteBlob(flatbuffers::FlatBufferBuilder& builder,
+			const Blob& blob, BlobOffsets& writtenBlobs, const SceneAssets* assets);
+	};
+
+	// Writes a scene to disk as its chunks are produced, instead of merging them into one buffer first. The asset
+	// and chunk data follow a header of known size, which is written last once every chunk's place is known.
+	class SceneFileWriter
+	{
+	public:
+		// The index must number the entities in chunk order
+		SceneFileWriter(size_t chunkCount, const SceneAssets* assets = nullptr, const SpatialIndex* spatialIndex = nullptr,
+			uint64_t journalId = 0);
+
+		// Keeps room for the header and writes the asset section
+		bool Open(const std::string& filename);
+
+		// Safe to call from any thread in any order, a chunk is written as soon as every chunk in front of it is
+		void AddChunk(size_t index, flatbuffers::DetachedBuffer chunk);
+
+		// Writes the header in front of the data and replaces the previous file
+		bool Finish();
+
+	private:
+		// The same size whatever the positions, only the offsets in it change
+		flatbuffers::DetachedBuffer BuildHeader() const;
+
+		// Vector positions are file offsets of the length in front of the data, which is 8 byte aligned
+		bool WriteVector(const uint8_t* data, size_t size, uint64_t& position);
+
+		const SceneAssets* assets;
+		const SpatialIndex* spatialIndex;
+		uint64_t journalId;
+
+		std::string filename;
+		std::ofstream file;
+		uint64_t fileSize = 0;
+		uint64_t headerSize = 0;
+		bool failed = false;
+
+		std::vector<uint64_t> assetPositions;
+		std::vector<uint64_t> chunkPositions;
+
+		std::mutex chunkMutex;
+		std::vector<flatbuffers::DetachedBuffer> pendingChunks;
+		std::vector<uint8_t> chunksReady;
+		size_t nextChunk = 0;
+	};
+}
@@ -0,0 +1,478 @@
+#include "SpatialIndex.h"
+#include "SceneBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static_assert(sizeof(BlackJawz::Scene::BoundsData) == sizeof(ECS::Bounds), "Entity bounds are used in place in the file");
+static_assert(sizeof(BlackJawz::Scene::BvhNodeData) == sizeof(ECS::BvhNode), "Nodes are used in place in the file");
+
+namespace
+{
+	using BlackJawz::Scene::BoundsData;
+
+	enum class PlaneTest
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	PlaneTest TestPlanes(const BoundsData& bounds, const float planes[6][4])
+	{
+		PlaneTest result = PlaneTest::Inside;
+		for (size_t plane = 0; plane < 6; ++plane)
+		{
+			const float* p = planes[plane];
+
+			// The corners furthest along and furthest against the plane normal
+			float furthest = p[3], nearest = p[3];
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				furthest += p[axis] * (p[axis] >= 0.0f ? bounds.max[axis] : bounds.min[axis]);
+				nearest += p[axis] * (p[axis] >= 0.0f ? bounds.min[axis] : bounds.max[axis]);
+			}
+
+			if (furthest < 0.0f)
+				return PlaneTest::Outside;
+			if (nearest < 0.0f)
+				result = PlaneTest::Intersecting;
+		}
+		return result;
+	}
+
+	// Distance along the ray to where it enters the box, clamped to 0 when it starts inside
+	bool IntersectRay(const BoundsData& bounds, const float origin[3], const float inverseDirection[3], float maxDistance, float& distance)
+	{
+		float enter = 0.0f, exit = maxDistance;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			float t0 = (bounds.min[axis] - origin[axis]) * inverseDirection[axis];
+			float t1 = (bounds.max[axis] - origin[axis]) * inverseDirection[axis];
+			if (t0 > t1)
+				std::swap(t0, t1);
+
+			// Written so a NaN from a ray along a box face does not reject the box
+			enter = t0 > enter ? t0 : enter;
+			exit = t1 < exit ? t1 : exit;
+		}
+
+		distance = enter;
+		return enter <= exit;
+	}
+}
+
+BlackJawz::Scene::SpatialIndex::SpatialIndex(SpatialIndex&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+BlackJawz::Scene::SpatialIndex& BlackJawz::Scene::SpatialIndex::operator=(SpatialIndex&& other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	// Moving a vector keeps its storage, so the views stay valid
+	entityBounds = other.entityBounds;
+	nodes = other.nodes;
+	items = other.items;
+	entityCount = other.entityCount;
+	nodeCount = other.nodeCount;
+	itemCount = other.itemCount;
+	ownedBounds = std::move(other.ownedBounds);
+	ownedNodes = std::move(other.ownedNodes);
+	ownedItems = std::move(other.ownedItems);
+	fileData = std::move(other.fileData);
+	refitPending = other.refitPending;
+
+	other.Clear();
+	return *this;
+}
+
+void BlackJawz::Scene::SpatialIndex::Clear()
+{
+	entityBounds = nullptr;
+	nodes = nullptr;
+	items = nullptr;
+	entityCount = 0;
+	nodeCount = 0;
+	itemCount = 0;
+	ownedBounds.clear();
+	ownedNodes.clear();
+	ownedItems.clear();
+	fileData = Blob();
+	refitPending = false;
+}
+
+void BlackJawz::Scene::SpatialIndex::Build(std::vector<BoundsData> bounds)
+{
+	Clear();
+
+	std::vector<uint32_t> buildItems;
+	std::vector<BoundsData> centroids(bounds.size());
+	for (uint32_t i = 0; i < bounds.size(); ++i)
+	{
+		if (IsEmpty(bounds[i]))
+			continue;
+
+		buildItems.push_back(i);
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			centroids[i].min[axis] = centroids[i].max[axis] = (bounds[i].min[axis] + bounds[i].max[axis]) * 0.5f;
+		}
+	}
+
+	ownedBounds = std::move(bounds);
+	entityBounds = ownedBounds.data();
+	entityCount = ownedBounds.size();
+
+	if (!buildItems.empty())
+	{
+		// A balanced tree with leaves of up to MaxLeafSize has fewer than 2n / MaxLeafSize + 1 nodes
+		ownedNodes.reserve(2 * buildItems.size() / MaxLeafSize + 1);
+		BuildNode(buildItems, centroids, 0, static_cast<uint32_t>(buildItems.size()));
+	}
+
+	ownedItems = std::move(buildItems);
+	nodes = ownedNodes.data();
+	nodeCount = ownedNodes.size();
+	items = ownedItems.data();
+	itemCount = ownedItems.size();
+}
+
+void BlackJawz::Scene::SpatialIndex::Build(const std::vector<EntityData>& entities, Jobs::JobSystem& jobSystem)
+{
+	std::vector<BoundsData> bounds(entities.size());
+
+	constexpr uint32_t entitiesPerJob = 256;
+	Jobs::JobCounter boundsCounter;
+	jobSystem.Dispatch(boundsCounter, static_cast<uint32_t>(entities.size()), entitiesPerJob, [&entities, &bounds](uint32_t index)
+		{
+			bounds[index] = ComputeWorldBounds(entities[index]).value_or(EmptyBounds());
+		});
+	jobSystem.Wait(boundsCounter);
+
+	Build(std::move(bounds));
+}
+
+uint32_t BlackJawz::Scene::SpatialIndex::BuildNode(std::vector<uint32_t>& buildItems, const std::vector<BoundsData>& centroids,
+	uint32_t begin, uint32_t end)
+{
+	uint32_t nodeIndex = static_cast<uint32_t>(ownedNodes.size());
+	ownedNodes.emplace_back();
+
+	BoundsData bounds = EmptyBounds();
+	BoundsData centroidBounds = EmptyBounds();
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		Merge(bounds, ownedBounds[buildItems[i]]);
+		Merge(centroidBounds, centroids[buildItems[i]]);
+	}
+
+	if (end - begin <= MaxLeafSize)
+	{
+		ownedNodes[nodeIndex] = { bounds, begin, end - begin };
+		return nodeIndex;
+	}
+
+	// Halve along the longest axis of the centres, which keeps the tree balanced however the entities are spread
+	size_t axis = 0;
+	for (size_t i = 1; i < 3; ++i)
+	{
+		if (centroidBounds.max[i] - centroidBounds.min[i] > centroidBounds.max[axis] - centroidBounds.min[axis])
+			axis = i;
+	}
+
+	uint32_t middle = begin + (end - begin) / 2;
+	std::nth_element(buildItems.begin() + begin, buildItems.begin() + middle, buildItems.begin() + end,
+		[&centroids, axis](uint32_t a, uint32_t b) { return centroids[a].min[axis] < centroids[b].min[axis]; });
+
+	BuildNode(buildItems, centroids, begin, middle);
+	uint32_t second = BuildNode(buildItems, centroids, middle, end);
+
+	// The vector may have grown, so the node is written once its children are
+	ownedNodes[nodeIndex] = { bounds, second, 0 };
+	return nodeIndex;
+}
+
+bool BlackJawz::Scene::SpatialIndex::Read(const ECS::SpatialIndex* index, size_t expectedEntityCount, const Blob& data)
+{
+	Clear();
+
+	if (!index || !index->entity_bounds() || index->entity_bounds()->size() != expectedEntityCount)
+		return false;
+
+	auto fileBounds = index->entity_bounds();
+	auto fileNodes = index->nodes();
+	auto fileItems = index->items();
+
+	entityBounds = reinterpret_cast<const BoundsData*>(fileBounds->Data());
+	entityCount = fileBounds->size();
+	nodes = fileNodes ? reinterpret_cast<const BvhNodeData*>(fileNodes->Data()) : nullptr;
+	nodeCount = fileNodes ? fileNodes->size() : 0;
+	items = fileItems ? fileItems->data() : nullptr;
+	itemCount = fileItems ? fileItems->size() : 0;
+	fileData = data;
+
+	// FlatBuffers aligns vectors within the buffer, only a buffer that is itself misaligned needs a copy
+	auto aligned = [](const void* pointer) { return reinterpret_cast<uintptr_t>(pointer) % alignof(uint32_t) == 0; };
+	if (!aligned(entityBounds) || !aligned(nodes) || !aligned(items))
+	{
+		MakeOwned();
+	}
+
+	if (!Validate())
+	{
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+bool BlackJawz::Scene::SpatialIndex::Validate() const
+{
+	if (nodeCount == 0)
+		return itemCount == 0;
+
+	for (size_t i = 0; i < itemCount; ++i)
+	{
+		if (items[i] >= entityCount)
+			return false;
+	}
+
+	// Children always come after their parent. A tree walk that needs more steps than there are
+	// nodes has shared subtrees, which could make every query take exponential time.
+	struct Entry
+	{
+		uint32_t node;
+		uint32_t depth;
+	};
+
+	Entry stack[MaxDepth + 2];
+	size_t stackSize = 0;
+	size_t visited = 0;
+	stack[stackSize++] = { 0, 1 };
+
+	while (stackSize > 0)
+	{
+		Entry entry = stack[--stackSize];
+		if (++visited > nodeCount || entry.depth > MaxDepth)
+			return false;
+
+		const BvhNodeData& node = nodes[entry.node];
+		if (node.count > 0)
+		{
+			if (node.first > itemCount || node.count > itemCount - node.first)
+				return false;
+			continue;
+		}
+
+		if (entry.node + 1 >= nodeCount || node.first <= entry.node + 1 || node.first >= nodeCount)
+			return false;
+
+		stack[stackSize++] = { node.first, entry.depth + 1 };
+		stack[stackSize++] = { entry.node + 1, entry.depth + 1 };
+	}
+
+	return true;
+}
+
+void BlackJawz::Scene::SpatialIndex::MakeOwned()
+{
+	if (fileData.Empty())
+		return;
+
+	ownedBounds.resize(entityCount);
+	memcpy(ownedBounds.data(), entityBounds, entityCount * sizeof(BoundsData));
+	ownedNodes.resize(nodeCount);
+	memcpy(ownedNodes.data(), nodes, nodeCount * sizeof(BvhNodeData));
+	ownedItems.resize(itemCount);
+	memcpy(ownedItems.data(), items, itemCount * sizeof(uint32_t));
+
+	entityBounds = ownedBounds.data();
+	nodes = ownedNodes.data();
+	items = ownedItems.data();
+	fileData = Blob();
+}
+
+flatbuffers::Offset<ECS::SpatialIndex> BlackJawz::Scene::SpatialIndex::Write(flatbuffers::FlatBufferBuilder& builder) const
+{
+	auto boundsVec = builder.CreateVectorOfStructs(reinterpret_cast<const ECS::Bounds*>(entityBounds), entityCount);
+	auto nodesVec = builder.CreateVectorOfStructs(reinterpret_cast<const ECS::BvhNode*>(nodes), nodeCount);
+	auto itemsVec = builder.CreateVector(items, itemCount);
+	return ECS::CreateSpatialIndex(builder, boundsVec, nodesVec, itemsVec);
+}
+
+bool BlackJawz::Scene::SpatialIndex::UpdateEntity(uint32_t entity, const BoundsData& bounds)
+{
+	if (entity >= entityCount || IsEmpty(entityBounds[entity]) || IsEmpty(bounds))
+		return false;
+
+	MakeOwned();
+	ownedBounds[entity] = bounds;
+	refitPending = true;
+	return true;
+}
+
+void BlackJawz::Scene::SpatialIndex::Refit()
+{
+	if (!refitPending)
+		return;
+
+	// Children come after their parents, so walking backwards finishes every child first
+	for (size_t i = nodeCount; i-- > 0;)
+	{
+		BvhNodeData& node = ownedNodes[i];
+		BoundsData bounds = EmptyBounds();
+		if (node.count > 0)
+		{
+			for (uint32_t item = node.first; item < node.first + node.count; ++item)
+			{
+				Merge(bounds, ownedBounds[ownedItems[item]]);
+			}
+		}
+		else
+		{
+			bounds = ownedNodes[i + 1].bounds;
+			Merge(bounds, ownedNodes[node.first].bounds);
+		}
+		node.bounds = bounds;
+	}
+
+	refitPending = false;
+}
+
+void BlackJawz::Scene::SpatialIndex::QueryFrustum(const float planes[6][4], std::vector<uint32_t>& result) const
+{
+	if (nodeCount == 0)
+		return;
+
+	// Subtrees wholly inside the frustum are taken without testing anything below them
+	struct Entry
+	{
+		uint32_t node;
+		bool inside;
+	};
+
+	Entry stack[MaxDepth + 2];
+	size_t stackSize = 0;
+	stack[stackSize++] = { 0, false };
+
+	while (stackSize > 0)
+	{
+		Entry entry = stack[--stackSize];
+		const BvhNodeData& node = nodes[entry.node];
+
+		bool inside = entry.inside;
+		if (!inside)
+		{
+			PlaneTest test = TestPlanes(node.bounds, planes);
+			if (test == PlaneTest::Outside)
+				continue;
+			inside = test == PlaneTest::Inside;
+		}
+
+		if (node.count == 0)
+		{
+			stack[stackSize++] = { node.first, inside };
+			stack[stackSize++] = { entry.node + 1, inside };
+			continue;
+		}
+
+		for (uint32_t item = node.first; item < node.first + node.count; ++item)
+		{
+			if (inside || TestPlanes(entityBounds[items[item]], planes) != PlaneTest::Outside)
+				result.push_back(items[item]);
+		}
+	}
+}
+
+std::optional<BlackJawz::Scene::RayHit> BlackJawz::Scene::SpatialIndex::Raycast(const float origin[3], const float direction[3],
+	float maxDistance) const
+{
+	if (nodeCount == 0)
+		return std::nullopt;
+
+	float inverseDirection[3];
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		inverseDirection[axis] = 1.0f / direction[axis];
+	}
+
+	std::optional<RayHit> hit;
+	float nearest = maxDistance;
+
+	uint32_t stack[MaxDepth + 2];
+	size_t stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BvhNodeData& node = nodes[stack[--stackSize]];
+
+		float distance;
+		if (!IntersectRay(node.bounds, origin, inverseDirection, nearest, distance))
+			continue;
+
+		if (node.count == 0)
+		{
+			// Nearer child on top, so the nearest hit is found early and prunes the rest
+			uint32_t first = static_cast<uint32_t>(&node - nodes) + 1;
+			uint32_t second = node.first;
+			float firstDistance = 0.0f, secondDistance = 0.0f;
+			bool firstHit = IntersectRay(nodes[first].bounds, origin, inverseDirection, nearest, firstDistance);
+			bool secondHit = IntersectRay(nodes[second].bounds, origin, inverseDirection, nearest, secondDistance);
+
+			if (firstHit && secondHit && secondDistance < firstDistance)
+			{
+				std::swap(first, second);
+			}
+
+			if (secondHit)
+				stack[stackSize++] = second;
+			if (firstHit)
+				stack[stackSize++] = first;
+			continue;
+		}
+
+		for (uint32_t item = node.first; item < node.first + node.count; ++item)
+		{
+			if (IntersectRay(entityBounds[items[item]], origin, inverseDirection, nearest, distance) && (!hit || distance < nearest))
+			{
+				hit = RayHit{ items[item], distance };
+				nearest = distance;
+			}
+		}
+	}
+
+	return hit;
+}
+
+void BlackJawz::Scene::SpatialIndex::GetFrustumPlanes(const float viewProjection[16], float planes[6][4])
+{
+	// Clip space is p * M, so each plane combines columns of the matrix
+	auto column = [viewProjection](size_t index, size_t row) { return viewProjection[row * 4 + index]; };
+
+	for (size_t row = 0; row < 4; ++row)
+	{
+		planes[0][row] = column(3, row) + column(0, row); // Left
+		planes[1][row] = column(3, row) - column(0, row); // Right
+		planes[2][row] = column(3, row) + column(1, row); // Bottom
+		planes[3][row] = column(3, row) - column(1, row); // Top
+		planes[4][row] = column(2, row); // Near
+		planes[5][row] = column(3, row) - column(2, row); // Far
+	}
+
+	for (size_t plane = 0; plane < 6; ++plane)
+	{
+		float length = sqrtf(planes[plane][0] * planes[plane][0] + planes[plane][1] * planes[plane][1] + planes[plane][2] * planes[plane][2]);
+		if (length > 0.0f)
+		{
+			for (size_t i = 0; i < 4; ++i)
+			{
+				planes[plane][i] /= length;
+			}
+		}
+	}
+}
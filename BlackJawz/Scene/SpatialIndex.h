@@ -0,0 +1,106 @@
+#pragma once
+#include "SceneData.h"
+#include "../Util/JobSystem.h"
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "../ecs_generated.h"
+
+namespace BlackJawz::Scene
+{
+	// Same layout as ECS::BvhNode, so nodes read from a file are used where they are
+	struct BvhNodeData
+	{
+		BoundsData bounds;
+		uint32_t first = 0; // First item of a leaf, second child of an interior node
+		uint32_t count = 0; // Items in a leaf, 0 for interior nodes
+	};
+
+	struct RayHit
+	{
+		uint32_t entity = 0;
+		float distance = 0.0f; // To where the ray enters the entity's box, in lengths of the direction
+	};
+
+	// Bounding volume hierarchy over the world space boxes of a scene's entities, for culling and
+	// picking. Entities are numbered as in the scene it was built from. Saved scenes carry one, and
+	// a loaded index points straight into the file data instead of copying or rebuilding it.
+	class SpatialIndex
+	{
+	public:
+		static constexpr uint32_t MaxLeafSize = 4;
+
+		// Built trees are balanced and never come close, deeper ones are rejected when read
+		static constexpr uint32_t MaxDepth = 64;
+
+		SpatialIndex() = default;
+		SpatialIndex(SpatialIndex&& other) noexcept;
+		SpatialIndex& operator=(SpatialIndex&& other) noexcept;
+
+		// Entities with empty bounds are left out of the tree
+		void Build(std::vector<BoundsData> entityBounds);
+
+		// World space bounds of every entity on the job system, then the tree over them. Meshes
+		// without bounds are measured for every entity using them, see ComputeMissingBounds.
+		void Build(const std::vector<EntityData>& entities, Jobs::JobSystem& jobSystem);
+
+		// Fails when the index does not cover entityCount entities or its tree is malformed, the
+		// caller rebuilds it then. The file data is kept alive for as long as the index uses it.
+		bool Read(const ECS::SpatialIndex* index, size_t entityCount, const Blob& fileData);
+
+		flatbuffers::Offset<ECS::SpatialIndex> Write(flatbuffers::FlatBufferBuilder& builder) const;
+
+		void Clear();
+
+		// For entities that moved or changed shape. Returns false when the entity is not in the tree,
+		// entities built without bounds are not, and the index has to be rebuilt to take it.
+		bool UpdateEntity(uint32_t entity, const BoundsData& bounds);
+
+		// Grows or shrinks the nodes to fit their entities after updates, the tree keeps its shape
+		void Refit();
+
+		// Entities whose boxes are inside or cross every plane, appended to result
+		void QueryFrustum(const float planes[6][4], std::vector<uint32_t>& result) const;
+
+		// The nearest entity box the ray enters within maxDistance, or the box the ray starts in
+		std::optional<RayHit> Raycast(const float origin[3], const float direction[3], float maxDistance) const;
+
+		// Planes {a, b, c, d} with ax + by + cz + d >= 0 on the inside, from a row vector view
+		// projection matrix with D3D's 0 to 1 depth range
+		static void GetFrustumPlanes(const float viewProjection[16], float planes[6][4]);
+
+		bool Empty() const { return entityCount == 0; }
+		size_t GetEntityCount() const { return entityCount; }
+		size_t GetNodeCount() const { return nodeCount; }
+		const BoundsData& GetEntityBounds(uint32_t entity) const { return entityBounds[entity]; }
+
+		// True when the arrays are still those of the file it was read from
+		bool IsFromFile() const { return !fileData.Empty(); }
+
+		// Copies the arrays out of the file, so an index kept after loading does not keep the whole
+		// file alive. Updates do this first.
+		void MakeOwned();
+
+	private:
+		uint32_t BuildNode(std::vector<uint32_t>& buildItems, const std::vector<BoundsData>& centroids, uint32_t begin, uint32_t end);
+
+		// Checks the tree can be walked without leaving the arrays or visiting a node twice
+		bool Validate() const;
+
+		// Views into the owned arrays, or into the file data
+		const BoundsData* entityBounds = nullptr;
+		const BvhNodeData* nodes = nullptr;
+		const uint32_t* items = nullptr;
+		size_t entityCount = 0;
+		size_t nodeCount = 0;
+		size_t itemCount = 0;
+
+		std::vector<BoundsData> ownedBounds;
+		std::vector<BvhNodeData> ownedNodes;
+		std::vector<uint32_t> ownedItems;
+		Blob fileData;
+
+		bool refitPending = false;
+	};
+}
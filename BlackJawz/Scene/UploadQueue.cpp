@@ -0,0 +1,99 @@
+#include "UploadQueue.h"
+
+BlackJawz::Scene::UploadQueue::UploadQueue(ResourceBackend& backend) : backend(backend)
+{
+	loaderThread = std::thread([this]() { LoaderLoop(); });
+}
+
+BlackJawz::Scene::UploadQueue::~UploadQueue()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+	loaderThread.join();
+}
+
+void BlackJawz::Scene::UploadQueue::ResetSlots(size_t bufferSlots, size_t textureSlots)
+{
+	Finish();
+
+	// Value initialized, every slot starts out not ready
+	slotCounts = { bufferSlots, textureSlots };
+	for (size_t kind = 0; kind < slotReady.size(); ++kind)
+	{
+		slotReady[kind] = std::make_unique<std::atomic<bool>[]>(slotCounts[kind]);
+	}
+}
+
+bool BlackJawz::Scene::UploadQueue::IsSlotReady(ResourceKind kind, uint32_t slot) const
+{
+	size_t index = static_cast<size_t>(kind);
+	if (slot >= slotCounts[index])
+		return false;
+
+	return slotReady[index][slot].load(std::memory_order_acquire);
+}
+
+void BlackJawz::Scene::UploadQueue::Submit(std::vector<UploadRequest>&& batch)
+{
+	if (batch.empty())
+		return;
+
+	submittedCount.fetch_add(batch.size(), std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		batches.push_back(std::move(batch));
+	}
+	wakeCondition.notify_one();
+}
+
+void BlackJawz::Scene::UploadQueue::Finish()
+{
+	std::unique_lock<std::mutex> lock(queueMutex);
+	idleCondition.wait(lock, [this]() { return batches.empty() && !loaderBusy; });
+}
+
+void BlackJawz::Scene::UploadQueue::LoaderLoop()
+{
+	while (true)
+	{
+		std::vector<UploadRequest> batch;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			loaderBusy = false;
+			if (batches.empty())
+			{
+				idleCondition.notify_all();
+			}
+
+			wakeCondition.wait(lock, [this]() { return stopping || !batches.empty(); });
+
+			if (batches.empty())
+				return; // Stopping and nothing left to create
+
+			batch = std::move(batches.front());
+			batches.pop_front();
+			loaderBusy = true;
+		}
+
+		for (auto& request : batch)
+		{
+			if (!backend.Create(request))
+			{
+				failedCount.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			// Drop the prepared data as soon as the resource exists
+			request.prepared.reset();
+
+			size_t kind = static_cast<size_t>(request.kind);
+			if (request.slot < slotCounts[kind])
+			{
+				slotReady[kind][request.slot].store(true, std::memory_order_release);
+			}
+			completedCount.fetch_add(1, std::memory_order_release);
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "SceneData.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace BlackJawz::Scene
+{
+	enum class ResourceKind : uint32_t
+	{
+		Buffer = 0,
+		Texture
+	};
+
+	struct UploadRequest
+	{
+		ResourceKind kind = ResourceKind::Buffer;
+		uint32_t slot = 0; // Index into the backend's buffers or textures
+		uint32_t stride = 0;
+		Blob data;
+
+		// Whatever Prepare produced on the worker thread, consumed by Create
+		std::shared_ptr<void> prepared;
+	};
+
+	// Turns scene blobs into GPU resources. The editor uses D3D11, the command line tools use a null backend.
+	class ResourceBackend
+	{
+	public:
+		virtual ~ResourceBackend() = default;
+
+		// Size the result storage, called before any request for a load is made
+		virtual void Reserve(size_t bufferSlots, size_t textureSlots) = 0;
+
+		// CPU-only work such as parsing texture headers, runs on the worker threads
+		virtual bool Prepare(UploadRequest&) { return true; }
+
+		// Create the resource into its slot, runs on the loader thread
+		virtual bool Create(UploadRequest& request) = 0;
+	};
+
+	// Batches of upload requests drained in order by a single loader thread, so the
+	// workers never wait on the device and resource creation overlaps decoding
+	class UploadQueue
+	{
+	public:
+		// Requests a worker collects before handing them over
+		static constexpr size_t BatchSize = 64;
+
+		explicit UploadQueue(ResourceBackend& backend);
+		~UploadQueue();
+
+		UploadQueue(const UploadQueue&) = delete;
+		UploadQueue& operator=(const UploadQueue&) = delete;
+
+		// Size the per slot ready flags for a new load, call before submitting its requests
+		void ResetSlots(size_t bufferSlots, size_t textureSlots);
+
+		// Thread safe
+		void Submit(std::vector<UploadRequest>&& batch);
+
+		// Block until every submitted request has been created
+		void Finish();
+
+		// True once the loader thread has processed the slot, whether or not creation succeeded
+		bool IsSlotReady(ResourceKind kind, uint32_t slot) const;
+
+		ResourceBackend& GetBackend() { return backend; }
+		size_t GetSubmittedCount() const { return submittedCount.load(std::memory_order_acquire); }
+		size_t GetCompletedCount() const { return completedCount.load(std::memory_order_acquire); }
+		size_t GetFailedCount() const { return failedCount.load(std::memory_order_acquire); }
+
+	private:
+		void LoaderLoop();
+
+		ResourceBackend& backend;
+
+		std::thread loaderThread;
+		std::mutex queueMutex;
+		std::condition_variable wakeCondition;
+		std::condition_variable idleCondition;
+		std::deque<std::vector<UploadRequest>> batches;
+		bool loaderBusy = false;
+		bool stopping = false;
+
+		std::array<std::unique_ptr<std::atomic<bool>[]>, 2> slotReady;
+		std::array<size_t, 2> slotCounts = { 0, 0 };
+
+		std::atomic<size_t> submittedCount{ 0 };
+		std::atomic<size_t> completedCount{ 0 };
+		std::atomic<size_t> failedCount{ 0 };
+	};
+}
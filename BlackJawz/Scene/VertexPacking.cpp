@@ -0,0 +1,378 @@
+#include "VertexPacking.h"
+#include "SceneBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	constexpr float RadiansToDegrees = 57.29577951f;
+
+	// Largest finite half float
+	constexpr float MaxHalf = 65504.0f;
+
+	// Float vertex field offsets
+	constexpr size_t PositionOffset = 0;
+	constexpr size_t NormalOffset = 12;
+	constexpr size_t TexCOffset = 24;
+	constexpr size_t TangentOffset = 32;
+
+	struct FloatVertex
+	{
+		float position[3];
+		float normal[3];
+		float texC[2];
+		float tangent[3];
+	};
+
+	FloatVertex ReadFloatVertex(const uint8_t* data)
+	{
+		FloatVertex vertex;
+		memcpy(vertex.position, data + PositionOffset, sizeof(vertex.position));
+		memcpy(vertex.normal, data + NormalOffset, sizeof(vertex.normal));
+		memcpy(vertex.texC, data + TexCOffset, sizeof(vertex.texC));
+		memcpy(vertex.tangent, data + TangentOffset, sizeof(vertex.tangent));
+		return vertex;
+	}
+
+	void WriteFloatVertex(const FloatVertex& vertex, uint8_t* data)
+	{
+		memcpy(data + PositionOffset, vertex.position, sizeof(vertex.position));
+		memcpy(data + NormalOffset, vertex.normal, sizeof(vertex.normal));
+		memcpy(data + TexCOffset, vertex.texC, sizeof(vertex.texC));
+		memcpy(data + TangentOffset, vertex.tangent, sizeof(vertex.tangent));
+	}
+
+	int16_t ToSnorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	float FromSnorm16(int16_t value)
+	{
+		return std::max(static_cast<float>(value) / 32767.0f, -1.0f);
+	}
+
+	// Fails for zero and non-finite vectors. Scaled by the largest component first, so very long and
+	// very short vectors neither overflow nor underflow.
+	bool Normalize(float vector[3])
+	{
+		float largest = std::max({ std::abs(vector[0]), std::abs(vector[1]), std::abs(vector[2]) });
+		if (!(largest > 0.0f) || !std::isfinite(largest) || std::isnan(vector[0] + vector[1] + vector[2]))
+			return false;
+
+		float scaled[3] = { vector[0] / largest, vector[1] / largest, vector[2] / largest };
+		float length = std::sqrt(scaled[0] * scaled[0] + scaled[1] * scaled[1] + scaled[2] * scaled[2]);
+
+		vector[0] = scaled[0] / length;
+		vector[1] = scaled[1] / length;
+		vector[2] = scaled[2] / length;
+		return true;
+	}
+
+	// Degrees between two vectors, normalizing the first
+	float AngleDegrees(const float a[3], const float b[3])
+	{
+		float normalized[3] = { a[0], a[1], a[2] };
+		if (!Normalize(normalized))
+			return 0.0f;
+
+		// acos of the dot product cannot resolve angles this small in single precision
+		float cross[3] =
+		{
+			normalized[1] * b[2] - normalized[2] * b[1],
+			normalized[2] * b[0] - normalized[0] * b[2],
+			normalized[0] * b[1] - normalized[1] * b[0]
+		};
+		float sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+		float dot = normalized[0] * b[0] + normalized[1] * b[1] + normalized[2] * b[2];
+		return std::atan2(sine, dot) * RadiansToDegrees;
+	}
+
+	uint16_t QuantizePosition(float value, float min, float extent)
+	{
+		if (!(extent > 0.0f))
+			return 0;
+
+		return static_cast<uint16_t>(std::lround(std::clamp((value - min) / extent, 0.0f, 1.0f) * 65535.0f));
+	}
+}
+
+uint16_t BlackJawz::Scene::FloatToHalf(float value)
+{
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	uint32_t exponent = (bits >> 23) & 0xFFu;
+	uint32_t mantissa = bits & 0x7FFFFFu;
+
+	// Infinity and NaN, NaN keeps a mantissa bit
+	if (exponent == 0xFFu)
+		return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+	int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+	if (halfExponent >= 31)
+		return static_cast<uint16_t>(sign | 0x7C00u);
+
+	if (halfExponent <= 0)
+	{
+		// Subnormal or zero, shift the implicit bit in and round to nearest even
+		if (halfExponent < -10)
+			return static_cast<uint16_t>(sign);
+
+		mantissa |= 0x800000u;
+		uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+		uint32_t halfMantissa = mantissa >> shift;
+		uint32_t remainder = mantissa & ((1u << shift) - 1u);
+		uint32_t halfway = 1u << (shift - 1u);
+		if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u)))
+			++halfMantissa;
+		return static_cast<uint16_t>(sign | halfMantissa);
+	}
+
+	// Rounding may carry into the exponent, which is still the right result
+	uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+	uint32_t remainder = mantissa & 0x1FFFu;
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)))
+		++half;
+	return static_cast<uint16_t>(half);
+}
+
+float BlackJawz::Scene::HalfToFloat(uint16_t value)
+{
+	uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+	uint32_t exponent = (value >> 10) & 0x1Fu;
+	uint32_t mantissa = value & 0x3FFu;
+
+	uint32_t bits;
+	if (exponent == 0x1Fu)
+	{
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	}
+	else if (exponent != 0)
+	{
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	else if (mantissa == 0)
+	{
+		bits = sign;
+	}
+	else
+	{
+		// Subnormal, normalize it
+		int32_t shift = 0;
+		while ((mantissa & 0x400u) == 0)
+		{
+			mantissa <<= 1;
+			++shift;
+		}
+		bits = sign | (static_cast<uint32_t>(127 - 15 + 1 - shift) << 23) | ((mantissa & 0x3FFu) << 13);
+	}
+
+	float result;
+	memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void BlackJawz::Scene::EncodeOctahedral(const float vector[3], int16_t encoded[2])
+{
+	float normalized[3] = { vector[0], vector[1], vector[2] };
+	if (!Normalize(normalized))
+	{
+		normalized[0] = 0.0f;
+		normalized[1] = 0.0f;
+		normalized[2] = 1.0f;
+	}
+
+	// Project onto the octahedron, then fold the lower half over the diagonals
+	float l1 = std::abs(normalized[0]) + std::abs(normalized[1]) + std::abs(normalized[2]);
+	float u = normalized[0] / l1;
+	float v = normalized[1] / l1;
+	if (normalized[2] < 0.0f)
+	{
+		float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+		float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+		u = foldedU;
+		v = foldedV;
+	}
+
+	// Rounding each axis on its own is not always closest, try both neighbours on each axis
+	float scaledU = std::clamp(u, -1.0f, 1.0f) * 32767.0f;
+	float scaledV = std::clamp(v, -1.0f, 1.0f) * 32767.0f;
+
+	float bestDot = -2.0f;
+	for (float candidateU : { std::floor(scaledU), std::ceil(scaledU) })
+	{
+		for (float candidateV : { std::floor(scaledV), std::ceil(scaledV) })
+		{
+			int16_t candidate[2] = { ToSnorm16(candidateU / 32767.0f), ToSnorm16(candidateV / 32767.0f) };
+
+			float decoded[3];
+			DecodeOctahedral(candidate, decoded);
+
+			float dot = decoded[0] * normalized[0] + decoded[1] * normalized[1] + decoded[2] * normalized[2];
+			if (dot > bestDot)
+			{
+				bestDot = dot;
+				encoded[0] = candidate[0];
+				encoded[1] = candidate[1];
+			}
+		}
+	}
+}
+
+void BlackJawz::Scene::DecodeOctahedral(const int16_t encoded[2], float vector[3])
+{
+	// Same as DecodeOctahedral in GBufferVertexShader.hlsl
+	float x = FromSnorm16(encoded[0]);
+	float y = FromSnorm16(encoded[1]);
+	float z = 1.0f - std::abs(x) - std::abs(y);
+
+	float t = std::max(-z, 0.0f);
+	x += x >= 0.0f ? -t : t;
+	y += y >= 0.0f ? -t : t;
+
+	vector[0] = x;
+	vector[1] = y;
+	vector[2] = z;
+	Normalize(vector);
+}
+
+bool BlackJawz::Scene::PackVertices(GeometryData& geometry)
+{
+	const Blob& vertices = geometry.vertexBuffer;
+	size_t offset = geometry.vertexBufferOffset;
+
+	if (geometry.vertexFormat != VertexFormat::Float || geometry.vertexBufferStride != FloatVertexStride ||
+		offset >= vertices.size || vertices.size - offset < FloatVertexStride)
+		return false;
+
+	// Stored bounds may be stale, positions outside them would be clamped
+	std::optional<BoundsData> bounds = ComputeBounds(geometry);
+	if (!bounds)
+		return false;
+
+	float extent[3];
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		extent[axis] = bounds->max[axis] - bounds->min[axis];
+	}
+
+	size_t vertexCount = (vertices.size - offset) / FloatVertexStride;
+
+	// Half floats would turn these into infinities
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		FloatVertex source = ReadFloatVertex(vertices.data + offset + i * FloatVertexStride);
+		if (!(std::abs(source.texC[0]) <= MaxHalf) || !(std::abs(source.texC[1]) <= MaxHalf))
+			return false;
+	}
+
+	std::vector<uint8_t> packed(vertexCount * sizeof(PackedVertex));
+
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		FloatVertex source = ReadFloatVertex(vertices.data + offset + i * FloatVertexStride);
+
+		PackedVertex vertex;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			vertex.position[axis] = QuantizePosition(source.position[axis], bounds->min[axis], extent[axis]);
+		}
+		vertex.position[3] = 0;
+
+		EncodeOctahedral(source.normal, vertex.normal);
+		EncodeOctahedral(source.tangent, vertex.tangent);
+		vertex.texC[0] = FloatToHalf(source.texC[0]);
+		vertex.texC[1] = FloatToHalf(source.texC[1]);
+
+		memcpy(packed.data() + i * sizeof(PackedVertex), &vertex, sizeof(vertex));
+	}
+
+	geometry.vertexBuffer = Blob::FromVector(std::move(packed));
+	geometry.vertexBufferStride = sizeof(PackedVertex);
+	geometry.vertexBufferOffset = 0;
+	geometry.vertexFormat = VertexFormat::Packed;
+	geometry.bounds = bounds;
+	return true;
+}
+
+bool BlackJawz::Scene::UnpackVertices(GeometryData& geometry)
+{
+	const Blob& vertices = geometry.vertexBuffer;
+	size_t offset = geometry.vertexBufferOffset;
+
+	if (geometry.vertexFormat != VertexFormat::Packed || geometry.vertexBufferStride != sizeof(PackedVertex) ||
+		!geometry.bounds || offset > vertices.size)
+		return false;
+
+	const BoundsData& bounds = *geometry.bounds;
+	size_t vertexCount = (vertices.size - offset) / sizeof(PackedVertex);
+	std::vector<uint8_t> unpacked(vertexCount * FloatVertexStride);
+
+	for (size_t i = 0; i < vertexCount; ++i)
+	{
+		PackedVertex source;
+		memcpy(&source, vertices.data + offset + i * sizeof(PackedVertex), sizeof(source));
+
+		FloatVertex vertex;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			vertex.position[axis] = bounds.min[axis] + (bounds.max[axis] - bounds.min[axis]) * (source.position[axis] / 65535.0f);
+		}
+
+		DecodeOctahedral(source.normal, vertex.normal);
+		DecodeOctahedral(source.tangent, vertex.tangent);
+		vertex.texC[0] = HalfToFloat(source.texC[0]);
+		vertex.texC[1] = HalfToFloat(source.texC[1]);
+
+		WriteFloatVertex(vertex, unpacked.data() + i * FloatVertexStride);
+	}
+
+	geometry.vertexBuffer = Blob::FromVector(std::move(unpacked));
+	geometry.vertexBufferStride = FloatVertexStride;
+	geometry.vertexBufferOffset = 0;
+	geometry.vertexFormat = VertexFormat::Float;
+	return true;
+}
+
+BlackJawz::Scene::PackingError BlackJawz::Scene::MeasurePackingError(const GeometryData& original, const GeometryData& packed)
+{
+	PackingError error;
+
+	GeometryData unpacked = packed;
+	if (original.vertexFormat != VertexFormat::Float || original.vertexBufferStride != FloatVertexStride || !UnpackVertices(unpacked))
+		return error;
+
+	size_t originalCount = (original.vertexBuffer.size - original.vertexBufferOffset) / FloatVertexStride;
+	error.vertexCount = std::min(originalCount, unpacked.vertexBuffer.size / FloatVertexStride);
+
+	for (size_t axis = 0; axis < 3; ++axis)
+	{
+		float extent = packed.bounds->max[axis] - packed.bounds->min[axis];
+		error.positionBound = std::max(error.positionBound, extent / 65535.0f * 0.5f);
+	}
+
+	for (size_t i = 0; i < error.vertexCount; ++i)
+	{
+		FloatVertex expected = ReadFloatVertex(original.vertexBuffer.data + original.vertexBufferOffset + i * FloatVertexStride);
+		FloatVertex actual = ReadFloatVertex(unpacked.vertexBuffer.data + i * FloatVertexStride);
+
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			error.position = std::max(error.position, std::abs(expected.position[axis] - actual.position[axis]));
+		}
+		for (size_t axis = 0; axis < 2; ++axis)
+		{
+			error.texC = std::max(error.texC, std::abs(expected.texC[axis] - actual.texC[axis]));
+		}
+
+		// Vectors that were zero have no direction to lose
+		error.normalDegrees = std::max(error.normalDegrees, AngleDegrees(expected.normal, actual.normal));
+		error.tangentDegrees = std::max(error.tangentDegrees, AngleDegrees(expected.tangent, actual.tangent));
+	}
+
+	return error;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "SceneData.h"
+
+namespace BlackJawz::Scene
+{
+	// Layout of the editor's Vertex: position, normal, UV and tangent as 32 bit floats
+	constexpr uint32_t FloatVertexStride = 44;
+
+	// Layout of VertexFormat::Packed, read by the GBuffer pass's packed input layout
+	struct PackedVertex
+	{
+		uint16_t position[4]; // R16G16B16A16_UNORM within the geometry's bounds, w unused
+		int16_t normal[2]; // R16G16_SNORM octahedral
+		int16_t tangent[2]; // R16G16_SNORM octahedral
+		uint16_t texC[2]; // R16G16_FLOAT
+	};
+	static_assert(sizeof(PackedVertex) == 20, "PackedVertex must match the packed input layout");
+
+	// Largest differences between a packed geometry and the float one it was packed from
+	struct PackingError
+	{
+		float position = 0.0f; // In the geometry's local units
+		float positionBound = 0.0f; // Half a quantization step along the longest axis, position never exceeds it
+		float normalDegrees = 0.0f;
+		float tangentDegrees = 0.0f;
+		float texC = 0.0f;
+		size_t vertexCount = 0;
+	};
+
+	uint16_t FloatToHalf(float value);
+	float HalfToFloat(uint16_t value);
+
+	// Unit vector to and from two 16 bit snorm values, zero vectors encode as +Z
+	void EncodeOctahedral(const float vector[3], int16_t encoded[2]);
+	void DecodeOctahedral(const int16_t encoded[2], float vector[3]);
+
+	// Converts a Float geometry to Packed, replacing its bounds with ones computed from the vertices.
+	// Fails, leaving the geometry as it was, for other strides, a vertex buffer too small for one vertex,
+	// or texture coordinates a half float cannot hold.
+	bool PackVertices(GeometryData& geometry);
+
+	// And back, for tools that read vertex positions
+	bool UnpackVertices(GeometryData& geometry);
+
+	// Compares every vertex of a packed geometry against the Float geometry it was packed from
+	PackingError MeasurePackingError(const GeometryData& original, const GeometryData& packed);
+}
@@ -0,0 +1,162 @@
+#include "WorldPartition.h"
+#include "SceneReader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace
+{
+	int32_t ToCellIndex(float position, float cellSize)
+	{
+		double index = std::floor(static_cast<double>(position) / cellSize);
+		if (!(index == index))
+			return 0;
+
+		return static_cast<int32_t>(std::clamp(index, static_cast<double>(INT32_MIN + 1), static_cast<double>(INT32_MAX)));
+	}
+
+	// Only the root and the partition table are checked, the probe usually ends before the cells
+	const ECS::WorldPartition* FindPartition(const BlackJawz::Scene::Blob& header)
+	{
+		if (header.size < sizeof(flatbuffers::uoffset_t))
+			return nullptr;
+
+		flatbuffers::Verifier verifier(header.data, header.size);
+		const flatbuffers::Table* root = flatbuffers::GetRoot<flatbuffers::Table>(header.data);
+		if (!root->VerifyTableStart(verifier) || !root->VerifyOffset(verifier, ECS::Scene::VT_PARTITION))
+			return nullptr;
+
+		const flatbuffers::Table* partition = root->GetPointer<const flatbuffers::Table*>(ECS::Scene::VT_PARTITION);
+		if (!partition || !partition->VerifyTableStart(verifier) ||
+			!partition->VerifyField<uint64_t>(verifier, ECS::WorldPartition::VT_DATA_SECTION_SIZE, 8))
+			return nullptr;
+
+		return reinterpret_cast<const ECS::WorldPartition*>(partition);
+	}
+}
+
+BlackJawz::Scene::CellCoord BlackJawz::Scene::WorldPartition::GetCell(float x, float z, float cellSize)
+{
+	return CellCoord{ ToCellIndex(x, cellSize), ToCellIndex(z, cellSize) };
+}
+
+BlackJawz::Scene::CellCoord BlackJawz::Scene::WorldPartition::GetEntityCell(const EntityData& entity, float cellSize)
+{
+	if (!entity.transform)
+		return AlwaysLoadedCell;
+
+	if (entity.light && entity.light->type == static_cast<int>(ECS::LightType_Directional))
+		return AlwaysLoadedCell;
+
+	return GetCell(entity.transform->position[0], entity.transform->position[2], cellSize);
+}
+
+std::unordered_map<BlackJawz::Scene::CellCoord, std::vector<size_t>, BlackJawz::Scene::CellCoordHash>
+BlackJawz::Scene::WorldPartition::Partition(const EntityData* entities, size_t count, float cellSize)
+{
+	std::unordered_map<CellCoord, std::vector<size_t>, CellCoordHash> cells;
+	for (size_t i = 0; i < count; ++i)
+	{
+		cells[GetEntityCell(entities[i], cellSize)].push_back(i);
+	}
+	return cells;
+}
+
+float BlackJawz::Scene::WorldPartition::DistanceToCell(const CellCoord& cell, float x, float z, float cellSize)
+{
+	if (cell == AlwaysLoadedCell)
+		return 0.0f;
+
+	float minX = cell.x * cellSize;
+	float minZ = cell.z * cellSize;
+
+	float dx = std::max({ minX - x, 0.0f, x - (minX + cellSize) });
+	float dz = std::max({ minZ - z, 0.0f, z - (minZ + cellSize) });
+	return std::sqrt(dx * dx + dz * dz);
+}
+
+bool BlackJawz::Scene::WorldPartition::Open(const std::string& filename)
+{
+	Close();
+
+	std::error_code error;
+	uint64_t fileSize = std::filesystem::file_size(filename, error);
+	if (error || fileSize < sizeof(flatbuffers::uoffset_t))
+		return false;
+
+	Blob header;
+	if (!SceneReader::ReadFileRange(filename, 0, std::min(fileSize, HeaderProbeSize), header))
+		return false;
+
+	const ECS::WorldPartition* partition = FindPartition(header);
+	if (!partition || partition->data_section_size() >= fileSize || partition->cell_size() <= 0.0f)
+		return false;
+
+	// Everything in front of the cell data
+	uint64_t headerBytes = fileSize - partition->data_section_size();
+	if (headerBytes > header.size)
+	{
+		if (!SceneReader::ReadFileRange(filename, 0, headerBytes, header))
+			return false;
+
+		partition = FindPartition(header);
+		if (!partition)
+			return false;
+	}
+
+	flatbuffers::Verifier verifier(header.data, header.size);
+	if (!partition->Verify(verifier) || !partition->cells())
+		return false;
+
+	cells.reserve(partition->cells()->size());
+	for (const ECS::SceneCell* cell : *partition->cells())
+	{
+		// The data follows the vector's length, and has to lie inside the data section
+		uint64_t endOffset = cell->data_end_offset();
+		if (endOffset > partition->data_section_size() || endOffset < sizeof(flatbuffers::uoffset_t) ||
+			cell->data_size() > endOffset - sizeof(flatbuffers::uoffset_t))
+		{
+			Close();
+			return false;
+		}
+
+		CellInfo info;
+		info.coord = cell->always_loaded() ? AlwaysLoadedCell : CellCoord{ cell->x(), cell->z() };
+		info.entityCount = cell->entity_count();
+		info.offset = fileSize - endOffset + sizeof(flatbuffers::uoffset_t);
+		info.size = cell->data_size();
+
+		if (info.size > 0 && cellIndices.emplace(info.coord, cells.size()).second)
+		{
+			cells.push_back(info);
+		}
+	}
+
+	this->filename = filename;
+	cellSize = partition->cell_size();
+	nextEntityId = partition->next_entity_id();
+	headerSize = headerBytes;
+	return true;
+}
+
+void BlackJawz::Scene::WorldPartition::Close()
+{
+	filename.clear();
+	cells.clear();
+	cellIndices.clear();
+	cellSize = DefaultCellSize;
+	nextEntityId = 0;
+	headerSize = 0;
+}
+
+bool BlackJawz::Scene::WorldPartition::ReadCell(const CellInfo& cell, Blob& data) const
+{
+	return SceneReader::ReadFileRange(filename, cell.offset, cell.size, data);
+}
+
+const BlackJawz::Scene::CellInfo* BlackJawz::Scene::WorldPartition::FindCell(const CellCoord& coord) const
+{
+	auto it = cellIndices.find(coord);
+	return it != cellIndices.end() ? &cells[it->second] : nullptr;
+}
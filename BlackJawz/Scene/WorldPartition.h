@@ -0,0 +1,92 @@
+#pragma once
+#include "SceneData.h"
+
+#include <climits>
+#include <unordered_map>
+
+namespace BlackJawz::Scene
+{
+	// Grid cell on the XZ plane
+	struct CellCoord
+	{
+		int32_t x = 0;
+		int32_t z = 0;
+
+		bool operator==(const CellCoord& other) const { return x == other.x && z == other.z; }
+		bool operator!=(const CellCoord& other) const { return !(*this == other); }
+	};
+
+	struct CellCoordHash
+	{
+		size_t operator()(const CellCoord& cell) const
+		{
+			return std::hash<uint64_t>()((static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) << 32) | static_cast<uint32_t>(cell.z));
+		}
+	};
+
+	// Entities without a position, and directional lights that light every cell, are kept in this
+	// cell. No position maps to it, and it is resident whenever the scene is.
+	constexpr CellCoord AlwaysLoadedCell{ INT32_MIN, INT32_MIN };
+
+	// One cell as written to a scene file
+	struct CellData
+	{
+		CellCoord coord;
+		uint32_t entityCount = 0;
+		Blob data; // A standalone Scene buffer holding the cell's entities, payloads inline
+	};
+
+	// Where a cell's data sits in the file
+	struct CellInfo
+	{
+		CellCoord coord;
+		uint32_t entityCount = 0;
+		uint64_t offset = 0;
+		uint64_t size = 0;
+	};
+
+	// The cell index of a world partitioned scene, read from the header without touching the cell data
+	class WorldPartition
+	{
+	public:
+		static constexpr float DefaultCellSize = 64.0f;
+
+		// Clamped so no position lands in AlwaysLoadedCell
+		static CellCoord GetCell(float x, float z, float cellSize);
+		static CellCoord GetEntityCell(const EntityData& entity, float cellSize);
+
+		// Bucket entities by cell, returns the indices of each cell's entities
+		static std::unordered_map<CellCoord, std::vector<size_t>, CellCoordHash> Partition(const EntityData* entities,
+			size_t count, float cellSize);
+
+		// Distance on the XZ plane from a point to the nearest edge of a cell, 0 inside it
+		static float DistanceToCell(const CellCoord& cell, float x, float z, float cellSize);
+
+		// Fails for scenes saved without a partition
+		bool Open(const std::string& filename);
+		void Close();
+		bool IsOpen() const { return !filename.empty(); }
+
+		// The cell's standalone Scene buffer
+		bool ReadCell(const CellInfo& cell, Blob& data) const;
+
+		const CellInfo* FindCell(const CellCoord& coord) const;
+
+		const std::string& GetFilename() const { return filename; }
+		const std::vector<CellInfo>& GetCells() const { return cells; }
+		float GetCellSize() const { return cellSize; }
+		uint32_t GetNextEntityId() const { return nextEntityId; }
+		uint64_t GetHeaderSize() const { return headerSize; }
+
+	private:
+		// Enough to reach the partition table, which is written just ahead of the root
+		static constexpr uint64_t HeaderProbeSize = 64 * 1024;
+
+		std::string filename;
+		std::vector<CellInfo> cells;
+		std::unordered_map<CellCoord, size_t, CellCoordHash> cellIndices;
+		float cellSize = DefaultCellSize;
+		uint32_t nextEntityId = 0;
+		uint64_t headerSize = 0;
+	};
+}
@@ -0,0 +1,124 @@
+#include "JobSystem.h"
+
+BlackJawz::Jobs::JobSystem::JobSystem(uint32_t workerCount)
+{
+	if (workerCount == 0)
+	{
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	workers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back([this]() { WorkerLoop(); });
+	}
+}
+
+BlackJawz::Jobs::JobSystem::~JobSystem()
+{
+	// Workers drain whatever is still queued before they exit
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void BlackJawz::Jobs::JobSystem::Execute(JobCounter& counter, std::function<void()> job)
+{
+	counter.pending.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		jobQueue.emplace_back([&counter, job = std::move(job)]()
+			{
+				job();
+				counter.pending.fetch_sub(1, std::memory_order_acq_rel);
+			});
+	}
+	wakeCondition.notify_one();
+}
+
+void BlackJawz::Jobs::JobSystem::Dispatch(JobCounter& counter, uint32_t jobCount, uint32_t groupSize, std::function<void(uint32_t)> job)
+{
+	if (jobCount == 0)
+		return;
+
+	groupSize = groupSize > 0 ? groupSize : 1;
+	uint32_t groupCount = (jobCount + groupSize - 1) / groupSize;
+
+	// Every group shares the one copy of the job
+	auto sharedJob = std::make_shared<std::function<void(uint32_t)>>(std::move(job));
+
+	counter.pending.fetch_add(groupCount, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		for (uint32_t group = 0; group < groupCount; ++group)
+		{
+			uint32_t begin = group * groupSize;
+			uint32_t end = (begin + groupSize < jobCount) ? begin + groupSize : jobCount;
+
+			jobQueue.emplace_back([&counter, sharedJob, begin, end]()
+				{
+					for (uint32_t index = begin; index < end; ++index)
+					{
+						(*sharedJob)(index);
+					}
+					counter.pending.fetch_sub(1, std::memory_order_acq_rel);
+				});
+		}
+	}
+	wakeCondition.notify_all();
+}
+
+void BlackJawz::Jobs::JobSystem::Wait(JobCounter& counter)
+{
+	while (!counter.IsDone())
+	{
+		if (!RunNextJob())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool BlackJawz::Jobs::JobSystem::RunNextJob()
+{
+	std::function<void()> job;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		if (jobQueue.empty())
+			return false;
+
+		job = std::move(jobQueue.front());
+		jobQueue.pop_front();
+	}
+
+	job();
+	return true;
+}
+
+void BlackJawz::Jobs::JobSystem::WorkerLoop()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			wakeCondition.wait(lock, [this]() { return stopping || !jobQueue.empty(); });
+
+			if (jobQueue.empty())
+				return; // Stopping and nothing left to run
+
+			job = std::move(jobQueue.front());
+			jobQueue.pop_front();
+		}
+
+		job();
+	}
+}
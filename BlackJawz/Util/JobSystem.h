@@ -0,0 +1,57 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Kept free of Windows/D3D headers so the scene tools can share it.
+namespace BlackJawz::Jobs
+{
+	// Tracks a group of jobs, it reaches zero once every job in the group has run
+	class JobCounter
+	{
+	public:
+		bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+		uint32_t GetPending() const { return pending.load(std::memory_order_acquire); }
+
+	private:
+		friend class JobSystem;
+		std::atomic<uint32_t> pending{ 0 };
+	};
+
+	class JobSystem
+	{
+	public:
+		// workerCount of 0 uses one worker per hardware thread, minus the calling thread
+		explicit JobSystem(uint32_t workerCount = 0);
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// Queue a single job
+		void Execute(JobCounter& counter, std::function<void()> job);
+
+		// Run job(index) for every index in [0, jobCount), batched into groups of groupSize
+		void Dispatch(JobCounter& counter, uint32_t jobCount, uint32_t groupSize, std::function<void(uint32_t)> job);
+
+		// Block until the counter is done, running queued jobs on this thread in the meantime
+		void Wait(JobCounter& counter);
+
+		uint32_t GetWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+	private:
+		bool RunNextJob();
+		void WorkerLoop();
+
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()>> jobQueue;
+		std::mutex queueMutex;
+		std::condition_variable wakeCondition;
+		bool stopping = false;
+	};
+}
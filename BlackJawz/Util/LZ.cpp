@@ -0,0 +1,232 @@
+#include "LZ.h"
+
+#include <cstring>
+#include <memory>
+
+// Each sequence is a token byte holding the literal length in the high nibble and the match
+// length minus MinMatch in the low nibble, either of which continues in extra bytes of 255 when
+// the nibble is saturated. The literals follow, then a 16 bit little endian match offset. The
+// last sequence is literals only and ends the block.
+namespace
+{
+	constexpr size_t MinMatch = 4;
+	constexpr size_t MaxOffset = 65535;
+	constexpr uint32_t HashBits = 16;
+
+	uint32_t Read32(const uint8_t* ptr)
+	{
+		uint32_t value;
+		memcpy(&value, ptr, sizeof(value));
+		return value;
+	}
+
+	uint64_t Read64(const uint8_t* ptr)
+	{
+		uint64_t value;
+		memcpy(&value, ptr, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	// Length continuation bytes after a saturated nibble
+	bool WriteLength(size_t length, uint8_t*& op, const uint8_t* opEnd)
+	{
+		while (length >= 255)
+		{
+			if (op >= opEnd)
+				return false;
+			*op++ = 255;
+			length -= 255;
+		}
+
+		if (op >= opEnd)
+			return false;
+		*op++ = static_cast<uint8_t>(length);
+		return true;
+	}
+
+	bool ReadLength(size_t& length, const uint8_t*& ip, const uint8_t* ipEnd)
+	{
+		uint8_t value;
+		do
+		{
+			if (ip >= ipEnd)
+				return false;
+			value = *ip++;
+			length += value;
+		} while (value == 255);
+
+		return true;
+	}
+
+	bool WriteSequence(const uint8_t* literals, size_t literalLength, size_t matchLength, size_t offset,
+		uint8_t*& op, const uint8_t* opEnd)
+	{
+		if (op >= opEnd)
+			return false;
+
+		uint8_t* token = op++;
+		*token = static_cast<uint8_t>((literalLength >= 15 ? 15 : literalLength) << 4);
+		if (literalLength >= 15 && !WriteLength(literalLength - 15, op, opEnd))
+			return false;
+
+		if (static_cast<size_t>(opEnd - op) < literalLength)
+			return false;
+		if (literalLength > 0)
+			memcpy(op, literals, literalLength);
+		op += literalLength;
+
+		// Literals only, this is the last sequence
+		if (matchLength == 0)
+			return true;
+
+		if (opEnd - op < 2)
+			return false;
+		*op++ = static_cast<uint8_t>(offset & 0xFF);
+		*op++ = static_cast<uint8_t>(offset >> 8);
+
+		size_t matchCode = matchLength - MinMatch;
+		*token |= static_cast<uint8_t>(matchCode >= 15 ? 15 : matchCode);
+		if (matchCode >= 15 && !WriteLength(matchCode - 15, op, opEnd))
+			return false;
+
+		return true;
+	}
+}
+
+size_t BlackJawz::LZ::CompressBound(size_t srcSize)
+{
+	return srcSize + srcSize / 255 + 16;
+}
+
+size_t BlackJawz::LZ::Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity)
+{
+	// Positions are stored in 32 bits
+	if (srcSize > UINT32_MAX)
+		return 0;
+
+	auto table = std::make_unique<uint32_t[]>(size_t(1) << HashBits);
+
+	const uint8_t* ip = src;
+	const uint8_t* anchor = src; // Start of the pending literals
+	const uint8_t* ipEnd = src + srcSize;
+	uint8_t* op = dst;
+	const uint8_t* opEnd = dst + dstCapacity;
+
+	// Skip ahead faster through data that is not matching, already compressed textures mostly
+	size_t misses = 0;
+
+	while (ipEnd - ip >= static_cast<ptrdiff_t>(MinMatch))
+	{
+		uint32_t sequence = Read32(ip);
+		uint32_t& entry = table[Hash(sequence)];
+		const uint8_t* candidate = src + entry;
+		entry = static_cast<uint32_t>(ip - src);
+
+		if (candidate >= ip || static_cast<size_t>(ip - candidate) > MaxOffset || Read32(candidate) != sequence)
+		{
+			size_t step = 1 + (misses++ >> 6);
+			ip += step < static_cast<size_t>(ipEnd - ip) ? step : static_cast<size_t>(ipEnd - ip);
+			continue;
+		}
+		misses = 0;
+
+		// Compare eight bytes at a time, then finish byte by byte
+		size_t matchLength = MinMatch;
+		while (ipEnd - (ip + matchLength) >= 8 && Read64(candidate + matchLength) == Read64(ip + matchLength))
+		{
+			matchLength += 8;
+		}
+		while (ip + matchLength < ipEnd && candidate[matchLength] == ip[matchLength])
+		{
+			++matchLength;
+		}
+
+		if (!WriteSequence(anchor, static_cast<size_t>(ip - anchor), matchLength, static_cast<size_t>(ip - candidate), op, opEnd))
+			return 0;
+
+		ip += matchLength;
+		anchor = ip;
+	}
+
+	if (!WriteSequence(anchor, static_cast<size_t>(ipEnd - anchor), 0, 0, op, opEnd))
+		return 0;
+
+	return static_cast<size_t>(op - dst);
+}
+
+bool BlackJawz::LZ::Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize)
+{
+	const uint8_t* ip = src;
+	const uint8_t* ipEnd = src + srcSize;
+	uint8_t* op = dst;
+	uint8_t* opEnd = dst + dstSize;
+
+	while (ip < ipEnd)
+	{
+		uint8_t token = *ip++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(literalLength, ip, ipEnd))
+			return false;
+
+		if (static_cast<size_t>(ipEnd - ip) < literalLength || static_cast<size_t>(opEnd - op) < literalLength)
+			return false;
+		if (literalLength > 0)
+			memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		if (ip == ipEnd)
+			break;
+
+		if (ipEnd - ip < 2)
+			return false;
+		size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+		ip += 2;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !ReadLength(matchLength, ip, ipEnd))
+			return false;
+		matchLength += MinMatch;
+
+		if (offset == 0 || offset > static_cast<size_t>(op - dst) || static_cast<size_t>(opEnd - op) < matchLength)
+			return false;
+
+		const uint8_t* match = op - offset;
+		if (offset >= matchLength)
+		{
+			memcpy(op, match, matchLength);
+			op += matchLength;
+		}
+		else if (offset >= 8)
+		{
+			// Overlapping, but each eight byte step only reads bytes that are already written
+			uint8_t* matchEnd = op + matchLength;
+			while (matchEnd - op >= 8)
+			{
+				memcpy(op, match, 8);
+				op += 8;
+				match += 8;
+			}
+			while (op < matchEnd)
+			{
+				*op++ = *match++;
+			}
+		}
+		else
+		{
+			// Short offsets repeat the last few bytes
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return op == opEnd;
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Small LZ77 block codec in the style of LZ4, used for scene asset payloads. Favours
+// decompression speed over ratio and has no dependencies, so the scene tools share it.
+namespace BlackJawz::LZ
+{
+	// Worst case compressed size, for incompressible input
+	size_t CompressBound(size_t srcSize);
+
+	// Returns the compressed size, or 0 if the output did not fit in dstCapacity
+	size_t Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity);
+
+	// dstSize must be the exact decompressed size. Returns false on malformed input
+	// instead of reading or writing out of bounds.
+	bool Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+}
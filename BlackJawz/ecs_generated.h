@@ -24,6 +24,15 @@ struct GeometryBuilder;
 struct Texture;
 struct TextureBuilder;
 
+struct Vec3;
+
+struct Bounds;
+
+struct InstanceTransform;
+
+struct Instances;
+struct InstancesBuilder;
+
 struct Appearance;
 struct AppearanceBuilder;
 
@@ -33,9 +42,59 @@ struct LightBuilder;
 struct Entity;
 struct EntityBuilder;
 
+struct SceneChunk;
+struct SceneChunkBuilder;
+
+struct Asset;
+struct AssetBuilder;
+
+struct SceneCell;
+struct SceneCellBuilder;
+
+struct WorldPartition;
+struct WorldPartitionBuilder;
+
+struct BvhNode;
+
+struct SpatialIndex;
+struct SpatialIndexBuilder;
+
 struct Scene;
 struct SceneBuilder;
 
+struct SceneDelta;
+struct SceneDeltaBuilder;
+
+enum VertexFormat : uint8_t {
+  VertexFormat_Float = 0,
+  VertexFormat_Packed = 1,
+  VertexFormat_MIN = VertexFormat_Float,
+  VertexFormat_MAX = VertexFormat_Packed
+};
+
+inline const VertexFormat (&EnumValuesVertexFormat())[2] {
+  static const VertexFormat values[] = {
+    VertexFormat_Float,
+    VertexFormat_Packed
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesVertexFormat() {
+  static const char * const names[3] = {
+    "Float",
+    "Packed",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameVertexFormat(VertexFormat e) {
+  if (::flatbuffers::IsOutRange(e, VertexFormat_Float, VertexFormat_Packed)) return "";
+  const size_t index = static_cast<size_t>(e);
+  return EnumNamesVertexFormat()[index];
+}
+
 enum LightType : int8_t {
   LightType_Point = 0,
   LightType_Directional = 1,
@@ -69,6 +128,146 @@ inline const char *EnumNameLightType(LightType e) {
   return EnumNamesLightType()[index];
 }
 
+enum AssetCodec : uint8_t {
+  AssetCodec_None = 0,
+  AssetCodec_LZ = 1,
+  AssetCodec_MIN = AssetCodec_None,
+  AssetCodec_MAX = AssetCodec_LZ
+};
+
+inline const AssetCodec (&EnumValuesAssetCodec())[2] {
+  static const AssetCodec values[] = {
+    AssetCodec_None,
+    AssetCodec_LZ
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesAssetCodec() {
+  static const char * const names[3] = {
+    "None",
+    "LZ",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameAssetCodec(AssetCodec e) {
+  if (::flatbuffers::IsOutRange(e, AssetCodec_None, AssetCodec_LZ)) return "";
+  const size_t index = static_cast<size_t>(e);
+  return EnumNamesAssetCodec()[index];
+}
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(4) Vec3 FLATBUFFERS_FINAL_CLASS {
+ private:
+  float x_;
+  float y_;
+  float z_;
+
+ public:
+  Vec3()
+      : x_(0),
+        y_(0),
+        z_(0) {
+  }
+  Vec3(float _x, float _y, float _z)
+      : x_(::flatbuffers::EndianScalar(_x)),
+        y_(::flatbuffers::EndianScalar(_y)),
+        z_(::flatbuffers::EndianScalar(_z)) {
+  }
+  float x() const {
+    return ::flatbuffers::EndianScalar(x_);
+  }
+  float y() const {
+    return ::flatbuffers::EndianScalar(y_);
+  }
+  float z() const {
+    return ::flatbuffers::EndianScalar(z_);
+  }
+};
+FLATBUFFERS_STRUCT_END(Vec3, 12);
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(4) Bounds FLATBUFFERS_FINAL_CLASS {
+ private:
+  ECS::Vec3 min_;
+  ECS::Vec3 max_;
+
+ public:
+  Bounds()
+      : min_(),
+        max_() {
+  }
+  Bounds(const ECS::Vec3 &_min, const ECS::Vec3 &_max)
+      : min_(_min),
+        max_(_max) {
+  }
+  const ECS::Vec3 &min() const {
+    return min_;
+  }
+  const ECS::Vec3 &max() const {
+    return max_;
+  }
+};
+FLATBUFFERS_STRUCT_END(Bounds, 24);
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(4) InstanceTransform FLATBUFFERS_FINAL_CLASS {
+ private:
+  ECS::Vec3 position_;
+  ECS::Vec3 rotation_;
+  ECS::Vec3 scale_;
+
+ public:
+  InstanceTransform()
+      : position_(),
+        rotation_(),
+        scale_() {
+  }
+  InstanceTransform(const ECS::Vec3 &_position, const ECS::Vec3 &_rotation, const ECS::Vec3 &_scale)
+      : position_(_position),
+        rotation_(_rotation),
+        scale_(_scale) {
+  }
+  const ECS::Vec3 &position() const {
+    return position_;
+  }
+  const ECS::Vec3 &rotation() const {
+    return rotation_;
+  }
+  const ECS::Vec3 &scale() const {
+    return scale_;
+  }
+};
+FLATBUFFERS_STRUCT_END(InstanceTransform, 36);
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(4) BvhNode FLATBUFFERS_FINAL_CLASS {
+ private:
+  ECS::Bounds bounds_;
+  uint32_t first_;
+  uint32_t count_;
+
+ public:
+  BvhNode()
+      : bounds_(),
+        first_(0),
+        count_(0) {
+  }
+  BvhNode(const ECS::Bounds &_bounds, uint32_t _first, uint32_t _count)
+      : bounds_(_bounds),
+        first_(::flatbuffers::EndianScalar(_first)),
+        count_(::flatbuffers::EndianScalar(_count)) {
+  }
+  const ECS::Bounds &bounds() const {
+    return bounds_;
+  }
+  uint32_t first() const {
+    return ::flatbuffers::EndianScalar(first_);
+  }
+  uint32_t count() const {
+    return ::flatbuffers::EndianScalar(count_);
+  }
+};
+FLATBUFFERS_STRUCT_END(BvhNode, 32);
+
 struct Transform FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   typedef TransformBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
@@ -169,7 +368,12 @@ struct Geometry FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
     VT_VERTEX_BUFFER_STRIDE = 6,
     VT_VERTEX_BUFFER_OFFSET = 8,
     VT_VERTEX_BUFFER = 10,
-    VT_INDEX_BUFFER = 12
+    VT_INDEX_BUFFER = 12,
+    VT_VERTEX_BUFFER_ASSET = 14,
+    VT_INDEX_BUFFER_ASSET = 16,
+    VT_BOUNDS_MIN = 18,
+    VT_BOUNDS_MAX = 20,
+    VT_VERTEX_FORMAT = 22
   };
   uint32_t indices_count() const {
     return GetField<uint32_t>(VT_INDICES_COUNT, 0);
@@ -186,6 +390,21 @@ struct Geometry FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   const ::flatbuffers::Vector<uint8_t> *index_buffer() const {
     return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_INDEX_BUFFER);
   }
+  int32_t vertex_buffer_asset() const {
+    return GetField<int32_t>(VT_VERTEX_BUFFER_ASSET, -1);
+  }
+  int32_t index_buffer_asset() const {
+    return GetField<int32_t>(VT_INDEX_BUFFER_ASSET, -1);
+  }
+  const ::flatbuffers::Vector<float> *bounds_min() const {
+    return GetPointer<const ::flatbuffers::Vector<float> *>(VT_BOUNDS_MIN);
+  }
+  const ::flatbuffers::Vector<float> *bounds_max() const {
+    return GetPointer<const ::flatbuffers::Vector<float> *>(VT_BOUNDS_MAX);
+  }
+  ECS::VertexFormat vertex_format() const {
+    return static_cast<ECS::VertexFormat>(GetField<uint8_t>(VT_VERTEX_FORMAT, 0));
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint32_t>(verifier, VT_INDICES_COUNT, 4) &&
@@ -195,6 +414,13 @@ struct Geometry FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
            verifier.VerifyVector(vertex_buffer()) &&
            VerifyOffset(verifier, VT_INDEX_BUFFER) &&
            verifier.VerifyVector(index_buffer()) &&
+           VerifyField<int32_t>(verifier, VT_VERTEX_BUFFER_ASSET, 4) &&
+           VerifyField<int32_t>(verifier, VT_INDEX_BUFFER_ASSET, 4) &&
+           VerifyOffset(verifier, VT_BOUNDS_MIN) &&
+           verifier.VerifyVector(bounds_min()) &&
+           VerifyOffset(verifier, VT_BOUNDS_MAX) &&
+           verifier.VerifyVector(bounds_max()) &&
+           VerifyField<uint8_t>(verifier, VT_VERTEX_FORMAT, 1) &&
            verifier.EndTable();
   }
 };
@@ -218,6 +444,21 @@ struct GeometryBuilder {
   void add_index_buffer(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> index_buffer) {
     fbb_.AddOffset(Geometry::VT_INDEX_BUFFER, index_buffer);
   }
+  void add_vertex_buffer_asset(int32_t vertex_buffer_asset) {
+    fbb_.AddElement<int32_t>(Geometry::VT_VERTEX_BUFFER_ASSET, vertex_buffer_asset, -1);
+  }
+  void add_index_buffer_asset(int32_t index_buffer_asset) {
+    fbb_.AddElement<int32_t>(Geometry::VT_INDEX_BUFFER_ASSET, index_buffer_asset, -1);
+  }
+  void add_bounds_min(::flatbuffers::Offset<::flatbuffers::Vector<float>> bounds_min) {
+    fbb_.AddOffset(Geometry::VT_BOUNDS_MIN, bounds_min);
+  }
+  void add_bounds_max(::flatbuffers::Offset<::flatbuffers::Vector<float>> bounds_max) {
+    fbb_.AddOffset(Geometry::VT_BOUNDS_MAX, bounds_max);
+  }
+  void add_vertex_format(ECS::VertexFormat vertex_format) {
+    fbb_.AddElement<uint8_t>(Geometry::VT_VERTEX_FORMAT, static_cast<uint8_t>(vertex_format), 0);
+  }
   explicit GeometryBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -235,13 +476,23 @@ inline ::flatbuffers::Offset<Geometry> CreateGeometry(
     uint32_t vertex_buffer_stride = 0,
     uint32_t vertex_buffer_offset = 0,
     ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> vertex_buffer = 0,
-    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> index_buffer = 0) {
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> index_buffer = 0,
+    int32_t vertex_buffer_asset = -1,
+    int32_t index_buffer_asset = -1,
+    ::flatbuffers::Offset<::flatbuffers::Vector<float>> bounds_min = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<float>> bounds_max = 0,
+    ECS::VertexFormat vertex_format = ECS::VertexFormat_Float) {
   GeometryBuilder builder_(_fbb);
+  builder_.add_bounds_max(bounds_max);
+  builder_.add_bounds_min(bounds_min);
+  builder_.add_index_buffer_asset(index_buffer_asset);
+  builder_.add_vertex_buffer_asset(vertex_buffer_asset);
   builder_.add_index_buffer(index_buffer);
   builder_.add_vertex_buffer(vertex_buffer);
   builder_.add_vertex_buffer_offset(vertex_buffer_offset);
   builder_.add_vertex_buffer_stride(vertex_buffer_stride);
   builder_.add_indices_count(indices_count);
+  builder_.add_vertex_format(vertex_format);
   return builder_.Finish();
 }
 
@@ -251,16 +502,28 @@ inline ::flatbuffers::Offset<Geometry> CreateGeometryDirect(
     uint32_t vertex_buffer_stride = 0,
     uint32_t vertex_buffer_offset = 0,
     const std::vector<uint8_t> *vertex_buffer = nullptr,
-    const std::vector<uint8_t> *index_buffer = nullptr) {
+    const std::vector<uint8_t> *index_buffer = nullptr,
+    int32_t vertex_buffer_asset = -1,
+    int32_t index_buffer_asset = -1,
+    const std::vector<float> *bounds_min = nullptr,
+    const std::vector<float> *bounds_max = nullptr,
+    ECS::VertexFormat vertex_format = ECS::VertexFormat_Float) {
   auto vertex_buffer__ = vertex_buffer ? _fbb.CreateVector<uint8_t>(*vertex_buffer) : 0;
   auto index_buffer__ = index_buffer ? _fbb.CreateVector<uint8_t>(*index_buffer) : 0;
+  auto bounds_min__ = bounds_min ? _fbb.CreateVector<float>(*bounds_min) : 0;
+  auto bounds_max__ = bounds_max ? _fbb.CreateVector<float>(*bounds_max) : 0;
   return ECS::CreateGeometry(
       _fbb,
       indices_count,
       vertex_buffer_stride,
       vertex_buffer_offset,
       vertex_buffer__,
-      index_buffer__);
+      index_buffer__,
+      vertex_buffer_asset,
+      index_buffer_asset,
+      bounds_min__,
+      bounds_max__,
+      vertex_format);
 }
 
 struct Texture FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
@@ -271,7 +534,17 @@ struct Texture FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
     VT_DDS_DATA_METAL = 8,
     VT_DDS_DATA_ROUGHNESS = 10,
     VT_DDS_DATA_AO = 12,
-    VT_DDS_DATA_DISPLACEMENT = 14
+    VT_DDS_DATA_DISPLACEMENT = 14,
+    VT_DDS_ASSET_DIFFUSE = 16,
+    VT_DDS_ASSET_NORMAL = 18,
+    VT_DDS_ASSET_METAL = 20,
+    VT_DDS_ASSET_ROUGHNESS = 22,
+    VT_DDS_ASSET_AO = 24,
+    VT_DDS_ASSET_DISPLACEMENT = 26,
+    VT_DDS_DATA_PACKED = 28,
+    VT_DDS_ASSET_PACKED = 30,
+    VT_DDS_DATA_CONE_STEP = 32,
+    VT_DDS_ASSET_CONE_STEP = 34
   };
   const ::flatbuffers::Vector<uint8_t> *dds_data_diffuse() const {
     return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_DDS_DATA_DIFFUSE);
@@ -291,6 +564,36 @@ struct Texture FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   const ::flatbuffers::Vector<uint8_t> *dds_data_displacement() const {
     return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_DDS_DATA_DISPLACEMENT);
   }
+  int32_t dds_asset_diffuse() const {
+    return GetField<int32_t>(VT_DDS_ASSET_DIFFUSE, -1);
+  }
+  int32_t dds_asset_normal() const {
+    return GetField<int32_t>(VT_DDS_ASSET_NORMAL, -1);
+  }
+  int32_t dds_asset_metal() const {
+    return GetField<int32_t>(VT_DDS_ASSET_METAL, -1);
+  }
+  int32_t dds_asset_roughness() const {
+    return GetField<int32_t>(VT_DDS_ASSET_ROUGHNESS, -1);
+  }
+  int32_t dds_asset_ao() const {
+    return GetField<int32_t>(VT_DDS_ASSET_AO, -1);
+  }
+  int32_t dds_asset_displacement() const {
+    return GetField<int32_t>(VT_DDS_ASSET_DISPLACEMENT, -1);
+  }
+  const ::flatbuffers::Vector<uint8_t> *dds_data_packed() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_DDS_DATA_PACKED);
+  }
+  int32_t dds_asset_packed() const {
+    return GetField<int32_t>(VT_DDS_ASSET_PACKED, -1);
+  }
+  const ::flatbuffers::Vector<uint8_t> *dds_data_cone_step() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_DDS_DATA_CONE_STEP);
+  }
+  int32_t dds_asset_cone_step() const {
+    return GetField<int32_t>(VT_DDS_ASSET_CONE_STEP, -1);
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_DDS_DATA_DIFFUSE) &&
@@ -305,6 +608,18 @@ struct Texture FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
            verifier.VerifyVector(dds_data_ao()) &&
            VerifyOffset(verifier, VT_DDS_DATA_DISPLACEMENT) &&
            verifier.VerifyVector(dds_data_displacement()) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_DIFFUSE, 4) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_NORMAL, 4) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_METAL, 4) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_ROUGHNESS, 4) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_AO, 4) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_DISPLACEMENT, 4) &&
+           VerifyOffset(verifier, VT_DDS_DATA_PACKED) &&
+           verifier.VerifyVector(dds_data_packed()) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_PACKED, 4) &&
+           VerifyOffset(verifier, VT_DDS_DATA_CONE_STEP) &&
+           verifier.VerifyVector(dds_data_cone_step()) &&
+           VerifyField<int32_t>(verifier, VT_DDS_ASSET_CONE_STEP, 4) &&
            verifier.EndTable();
   }
 };
@@ -331,6 +646,36 @@ struct TextureBuilder {
   void add_dds_data_displacement(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_displacement) {
     fbb_.AddOffset(Texture::VT_DDS_DATA_DISPLACEMENT, dds_data_displacement);
   }
+  void add_dds_asset_diffuse(int32_t dds_asset_diffuse) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_DIFFUSE, dds_asset_diffuse, -1);
+  }
+  void add_dds_asset_normal(int32_t dds_asset_normal) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_NORMAL, dds_asset_normal, -1);
+  }
+  void add_dds_asset_metal(int32_t dds_asset_metal) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_METAL, dds_asset_metal, -1);
+  }
+  void add_dds_asset_roughness(int32_t dds_asset_roughness) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_ROUGHNESS, dds_asset_roughness, -1);
+  }
+  void add_dds_asset_ao(int32_t dds_asset_ao) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_AO, dds_asset_ao, -1);
+  }
+  void add_dds_asset_displacement(int32_t dds_asset_displacement) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_DISPLACEMENT, dds_asset_displacement, -1);
+  }
+  void add_dds_data_packed(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_packed) {
+    fbb_.AddOffset(Texture::VT_DDS_DATA_PACKED, dds_data_packed);
+  }
+  void add_dds_asset_packed(int32_t dds_asset_packed) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_PACKED, dds_asset_packed, -1);
+  }
+  void add_dds_data_cone_step(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_cone_step) {
+    fbb_.AddOffset(Texture::VT_DDS_DATA_CONE_STEP, dds_data_cone_step);
+  }
+  void add_dds_asset_cone_step(int32_t dds_asset_cone_step) {
+    fbb_.AddElement<int32_t>(Texture::VT_DDS_ASSET_CONE_STEP, dds_asset_cone_step, -1);
+  }
   explicit TextureBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -349,8 +694,28 @@ inline ::flatbuffers::Offset<Texture> CreateTexture(
     ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_metal = 0,
     ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_roughness = 0,
     ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_ao = 0,
-    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_displacement = 0) {
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_displacement = 0,
+    int32_t dds_asset_diffuse = -1,
+    int32_t dds_asset_normal = -1,
+    int32_t dds_asset_metal = -1,
+    int32_t dds_asset_roughness = -1,
+    int32_t dds_asset_ao = -1,
+    int32_t dds_asset_displacement = -1,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_packed = 0,
+    int32_t dds_asset_packed = -1,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> dds_data_cone_step = 0,
+    int32_t dds_asset_cone_step = -1) {
   TextureBuilder builder_(_fbb);
+  builder_.add_dds_asset_cone_step(dds_asset_cone_step);
+  builder_.add_dds_data_cone_step(dds_data_cone_step);
+  builder_.add_dds_asset_packed(dds_asset_packed);
+  builder_.add_dds_data_packed(dds_data_packed);
+  builder_.add_dds_asset_displacement(dds_asset_displacement);
+  builder_.add_dds_asset_ao(dds_asset_ao);
+  builder_.add_dds_asset_roughness(dds_asset_roughness);
+  builder_.add_dds_asset_metal(dds_asset_metal);
+  builder_.add_dds_asset_normal(dds_asset_normal);
+  builder_.add_dds_asset_diffuse(dds_asset_diffuse);
   builder_.add_dds_data_displacement(dds_data_displacement);
   builder_.add_dds_data_ao(dds_data_ao);
   builder_.add_dds_data_roughness(dds_data_roughness);
@@ -367,13 +732,25 @@ inline ::flatbuffers::Offset<Texture> CreateTextureDirect(
     const std::vector<uint8_t> *dds_data_metal = nullptr,
     const std::vector<uint8_t> *dds_data_roughness = nullptr,
     const std::vector<uint8_t> *dds_data_ao = nullptr,
-    const std::vector<uint8_t> *dds_data_displacement = nullptr) {
+    const std::vector<uint8_t> *dds_data_displacement = nullptr,
+    int32_t dds_asset_diffuse = -1,
+    int32_t dds_asset_normal = -1,
+    int32_t dds_asset_metal = -1,
+    int32_t dds_asset_roughness = -1,
+    int32_t dds_asset_ao = -1,
+    int32_t dds_asset_displacement = -1,
+    const std::vector<uint8_t> *dds_data_packed = nullptr,
+    int32_t dds_asset_packed = -1,
+    const std::vector<uint8_t> *dds_data_cone_step = nullptr,
+    int32_t dds_asset_cone_step = -1) {
   auto dds_data_diffuse__ = dds_data_diffuse ? _fbb.CreateVector<uint8_t>(*dds_data_diffuse) : 0;
   auto dds_data_normal__ = dds_data_normal ? _fbb.CreateVector<uint8_t>(*dds_data_normal) : 0;
   auto dds_data_metal__ = dds_data_metal ? _fbb.CreateVector<uint8_t>(*dds_data_metal) : 0;
   auto dds_data_roughness__ = dds_data_roughness ? _fbb.CreateVector<uint8_t>(*dds_data_roughness) : 0;
   auto dds_data_ao__ = dds_data_ao ? _fbb.CreateVector<uint8_t>(*dds_data_ao) : 0;
   auto dds_data_displacement__ = dds_data_displacement ? _fbb.CreateVector<uint8_t>(*dds_data_displacement) : 0;
+  auto dds_data_packed__ = dds_data_packed ? _fbb.CreateVector<uint8_t>(*dds_data_packed) : 0;
+  auto dds_data_cone_step__ = dds_data_cone_step ? _fbb.CreateVector<uint8_t>(*dds_data_cone_step) : 0;
   return ECS::CreateTexture(
       _fbb,
       dds_data_diffuse__,
@@ -381,14 +758,102 @@ inline ::flatbuffers::Offset<Texture> CreateTextureDirect(
       dds_data_metal__,
       dds_data_roughness__,
       dds_data_ao__,
-      dds_data_displacement__);
+      dds_data_displacement__,
+      dds_asset_diffuse,
+      dds_asset_normal,
+      dds_asset_metal,
+      dds_asset_roughness,
+      dds_asset_ao,
+      dds_asset_displacement,
+      dds_data_packed__,
+      dds_asset_packed,
+      dds_data_cone_step__,
+      dds_asset_cone_step);
+}
+
+struct Instances FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef InstancesBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_TRANSFORMS = 4,
+    VT_PARAM_STRIDE = 6,
+    VT_PARAMS = 8
+  };
+  const ::flatbuffers::Vector<const ECS::InstanceTransform *> *transforms() const {
+    return GetPointer<const ::flatbuffers::Vector<const ECS::InstanceTransform *> *>(VT_TRANSFORMS);
+  }
+  uint32_t param_stride() const {
+    return GetField<uint32_t>(VT_PARAM_STRIDE, 0);
+  }
+  const ::flatbuffers::Vector<float> *params() const {
+    return GetPointer<const ::flatbuffers::Vector<float> *>(VT_PARAMS);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_TRANSFORMS) &&
+           verifier.VerifyVector(transforms()) &&
+           VerifyField<uint32_t>(verifier, VT_PARAM_STRIDE, 4) &&
+           VerifyOffset(verifier, VT_PARAMS) &&
+           verifier.VerifyVector(params()) &&
+           verifier.EndTable();
+  }
+};
+
+struct InstancesBuilder {
+  typedef Instances Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_transforms(::flatbuffers::Offset<::flatbuffers::Vector<const ECS::InstanceTransform *>> transforms) {
+    fbb_.AddOffset(Instances::VT_TRANSFORMS, transforms);
+  }
+  void add_param_stride(uint32_t param_stride) {
+    fbb_.AddElement<uint32_t>(Instances::VT_PARAM_STRIDE, param_stride, 0);
+  }
+  void add_params(::flatbuffers::Offset<::flatbuffers::Vector<float>> params) {
+    fbb_.AddOffset(Instances::VT_PARAMS, params);
+  }
+  explicit InstancesBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<Instances> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<Instances>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<Instances> CreateInstances(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ::flatbuffers::Offset<::flatbuffers::Vector<const ECS::InstanceTransform *>> transforms = 0,
+    uint32_t param_stride = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<float>> params = 0) {
+  InstancesBuilder builder_(_fbb);
+  builder_.add_params(params);
+  builder_.add_param_stride(param_stride);
+  builder_.add_transforms(transforms);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<Instances> CreateInstancesDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<ECS::InstanceTransform> *transforms = nullptr,
+    uint32_t param_stride = 0,
+    const std::vector<float> *params = nullptr) {
+  auto transforms__ = transforms ? _fbb.CreateVectorOfStructs<ECS::InstanceTransform>(*transforms) : 0;
+  auto params__ = params ? _fbb.CreateVector<float>(*params) : 0;
+  return ECS::CreateInstances(
+      _fbb,
+      transforms__,
+      param_stride,
+      params__);
 }
 
 struct Appearance FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   typedef AppearanceBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_GEOMETRY = 4,
-    VT_TEXTURE = 6
+    VT_TEXTURE = 6,
+    VT_INSTANCES = 8
   };
   const ECS::Geometry *geometry() const {
     return GetPointer<const ECS::Geometry *>(VT_GEOMETRY);
@@ -396,12 +861,17 @@ struct Appearance FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   const ECS::Texture *texture() const {
     return GetPointer<const ECS::Texture *>(VT_TEXTURE);
   }
+  const ECS::Instances *instances() const {
+    return GetPointer<const ECS::Instances *>(VT_INSTANCES);
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_GEOMETRY) &&
            verifier.VerifyTable(geometry()) &&
            VerifyOffset(verifier, VT_TEXTURE) &&
            verifier.VerifyTable(texture()) &&
+           VerifyOffset(verifier, VT_INSTANCES) &&
+           verifier.VerifyTable(instances()) &&
            verifier.EndTable();
   }
 };
@@ -416,6 +886,9 @@ struct AppearanceBuilder {
   void add_texture(::flatbuffers::Offset<ECS::Texture> texture) {
     fbb_.AddOffset(Appearance::VT_TEXTURE, texture);
   }
+  void add_instances(::flatbuffers::Offset<ECS::Instances> instances) {
+    fbb_.AddOffset(Appearance::VT_INSTANCES, instances);
+  }
   explicit AppearanceBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -430,8 +903,10 @@ struct AppearanceBuilder {
 inline ::flatbuffers::Offset<Appearance> CreateAppearance(
     ::flatbuffers::FlatBufferBuilder &_fbb,
     ::flatbuffers::Offset<ECS::Geometry> geometry = 0,
-    ::flatbuffers::Offset<ECS::Texture> texture = 0) {
+    ::flatbuffers::Offset<ECS::Texture> texture = 0,
+    ::flatbuffers::Offset<ECS::Instances> instances = 0) {
   AppearanceBuilder builder_(_fbb);
+  builder_.add_instances(instances);
   builder_.add_texture(texture);
   builder_.add_geometry(geometry);
   return builder_.Finish();
@@ -718,19 +1193,462 @@ inline ::flatbuffers::Offset<Entity> CreateEntityDirect(
       light);
 }
 
+struct SceneChunk FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef SceneChunkBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_DATA = 4
+  };
+  const ::flatbuffers::Vector<uint8_t> *data() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_DATA);
+  }
+  const ECS::Scene *data_nested_root() const {
+    const auto _f = data();
+    return _f ? ::flatbuffers::GetRoot<ECS::Scene>(_f->Data())
+              : nullptr;
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_DATA) &&
+           verifier.VerifyVector(data()) &&
+           verifier.VerifyNestedFlatBuffer<ECS::Scene>(data(), nullptr) &&
+           verifier.EndTable();
+  }
+};
+
+struct SceneChunkBuilder {
+  typedef SceneChunk Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_data(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> data) {
+    fbb_.AddOffset(SceneChunk::VT_DATA, data);
+  }
+  explicit SceneChunkBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<SceneChunk> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<SceneChunk>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<SceneChunk> CreateSceneChunk(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> data = 0) {
+  SceneChunkBuilder builder_(_fbb);
+  builder_.add_data(data);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<SceneChunk> CreateSceneChunkDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<uint8_t> *data = nullptr) {
+  auto data__ = data ? _fbb.CreateVector<uint8_t>(*data) : 0;
+  return ECS::CreateSceneChunk(
+      _fbb,
+      data__);
+}
+
+struct Asset FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef AssetBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_CODEC = 4,
+    VT_RAW_SIZE = 6,
+    VT_HASH = 8,
+    VT_DATA = 10
+  };
+  ECS::AssetCodec codec() const {
+    return static_cast<ECS::AssetCodec>(GetField<uint8_t>(VT_CODEC, 0));
+  }
+  uint64_t raw_size() const {
+    return GetField<uint64_t>(VT_RAW_SIZE, 0);
+  }
+  uint64_t hash() const {
+    return GetField<uint64_t>(VT_HASH, 0);
+  }
+  const ::flatbuffers::Vector<uint8_t> *data() const {
+    return GetPointer<const ::flatbuffers::Vector<uint8_t> *>(VT_DATA);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint8_t>(verifier, VT_CODEC, 1) &&
+           VerifyField<uint64_t>(verifier, VT_RAW_SIZE, 8) &&
+           VerifyField<uint64_t>(verifier, VT_HASH, 8) &&
+           VerifyOffset(verifier, VT_DATA) &&
+           verifier.VerifyVector(data()) &&
+           verifier.EndTable();
+  }
+};
+
+struct AssetBuilder {
+  typedef Asset Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_codec(ECS::AssetCodec codec) {
+    fbb_.AddElement<uint8_t>(Asset::VT_CODEC, static_cast<uint8_t>(codec), 0);
+  }
+  void add_raw_size(uint64_t raw_size) {
+    fbb_.AddElement<uint64_t>(Asset::VT_RAW_SIZE, raw_size, 0);
+  }
+  void add_hash(uint64_t hash) {
+    fbb_.AddElement<uint64_t>(Asset::VT_HASH, hash, 0);
+  }
+  void add_data(::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> data) {
+    fbb_.AddOffset(Asset::VT_DATA, data);
+  }
+  explicit AssetBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<Asset> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<Asset>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<Asset> CreateAsset(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ECS::AssetCodec codec = ECS::AssetCodec_None,
+    uint64_t raw_size = 0,
+    uint64_t hash = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint8_t>> data = 0) {
+  AssetBuilder builder_(_fbb);
+  builder_.add_hash(hash);
+  builder_.add_raw_size(raw_size);
+  builder_.add_data(data);
+  builder_.add_codec(codec);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<Asset> CreateAssetDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ECS::AssetCodec codec = ECS::AssetCodec_None,
+    uint64_t raw_size = 0,
+    uint64_t hash = 0,
+    const std::vector<uint8_t> *data = nullptr) {
+  auto data__ = data ? _fbb.CreateVector<uint8_t>(*data) : 0;
+  return ECS::CreateAsset(
+      _fbb,
+      codec,
+      raw_size,
+      hash,
+      data__);
+}
+
+struct SceneCell FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef SceneCellBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_X = 4,
+    VT_Z = 6,
+    VT_ALWAYS_LOADED = 8,
+    VT_CHUNK = 10,
+    VT_ENTITY_COUNT = 12,
+    VT_DATA_END_OFFSET = 14,
+    VT_DATA_SIZE = 16
+  };
+  int32_t x() const {
+    return GetField<int32_t>(VT_X, 0);
+  }
+  int32_t z() const {
+    return GetField<int32_t>(VT_Z, 0);
+  }
+  bool always_loaded() const {
+    return GetField<uint8_t>(VT_ALWAYS_LOADED, 0) != 0;
+  }
+  uint32_t chunk() const {
+    return GetField<uint32_t>(VT_CHUNK, 0);
+  }
+  uint32_t entity_count() const {
+    return GetField<uint32_t>(VT_ENTITY_COUNT, 0);
+  }
+  uint64_t data_end_offset() const {
+    return GetField<uint64_t>(VT_DATA_END_OFFSET, 0);
+  }
+  uint64_t data_size() const {
+    return GetField<uint64_t>(VT_DATA_SIZE, 0);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<int32_t>(verifier, VT_X, 4) &&
+           VerifyField<int32_t>(verifier, VT_Z, 4) &&
+           VerifyField<uint8_t>(verifier, VT_ALWAYS_LOADED, 1) &&
+           VerifyField<uint32_t>(verifier, VT_CHUNK, 4) &&
+           VerifyField<uint32_t>(verifier, VT_ENTITY_COUNT, 4) &&
+           VerifyField<uint64_t>(verifier, VT_DATA_END_OFFSET, 8) &&
+           VerifyField<uint64_t>(verifier, VT_DATA_SIZE, 8) &&
+           verifier.EndTable();
+  }
+};
+
+struct SceneCellBuilder {
+  typedef SceneCell Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_x(int32_t x) {
+    fbb_.AddElement<int32_t>(SceneCell::VT_X, x, 0);
+  }
+  void add_z(int32_t z) {
+    fbb_.AddElement<int32_t>(SceneCell::VT_Z, z, 0);
+  }
+  void add_always_loaded(bool always_loaded) {
+    fbb_.AddElement<uint8_t>(SceneCell::VT_ALWAYS_LOADED, static_cast<uint8_t>(always_loaded), 0);
+  }
+  void add_chunk(uint32_t chunk) {
+    fbb_.AddElement<uint32_t>(SceneCell::VT_CHUNK, chunk, 0);
+  }
+  void add_entity_count(uint32_t entity_count) {
+    fbb_.AddElement<uint32_t>(SceneCell::VT_ENTITY_COUNT, entity_count, 0);
+  }
+  void add_data_end_offset(uint64_t data_end_offset) {
+    fbb_.AddElement<uint64_t>(SceneCell::VT_DATA_END_OFFSET, data_end_offset, 0);
+  }
+  void add_data_size(uint64_t data_size) {
+    fbb_.AddElement<uint64_t>(SceneCell::VT_DATA_SIZE, data_size, 0);
+  }
+  explicit SceneCellBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<SceneCell> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<SceneCell>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<SceneCell> CreateSceneCell(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    int32_t x = 0,
+    int32_t z = 0,
+    bool always_loaded = false,
+    uint32_t chunk = 0,
+    uint32_t entity_count = 0,
+    uint64_t data_end_offset = 0,
+    uint64_t data_size = 0) {
+  SceneCellBuilder builder_(_fbb);
+  builder_.add_data_size(data_size);
+  builder_.add_data_end_offset(data_end_offset);
+  builder_.add_entity_count(entity_count);
+  builder_.add_chunk(chunk);
+  builder_.add_z(z);
+  builder_.add_x(x);
+  builder_.add_always_loaded(always_loaded);
+  return builder_.Finish();
+}
+
+struct WorldPartition FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef WorldPartitionBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_CELL_SIZE = 4,
+    VT_DATA_SECTION_SIZE = 6,
+    VT_NEXT_ENTITY_ID = 8,
+    VT_CELLS = 10
+  };
+  float cell_size() const {
+    return GetField<float>(VT_CELL_SIZE, 0.0f);
+  }
+  uint64_t data_section_size() const {
+    return GetField<uint64_t>(VT_DATA_SECTION_SIZE, 0);
+  }
+  uint32_t next_entity_id() const {
+    return GetField<uint32_t>(VT_NEXT_ENTITY_ID, 0);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneCell>> *cells() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneCell>> *>(VT_CELLS);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<float>(verifier, VT_CELL_SIZE, 4) &&
+           VerifyField<uint64_t>(verifier, VT_DATA_SECTION_SIZE, 8) &&
+           VerifyField<uint32_t>(verifier, VT_NEXT_ENTITY_ID, 4) &&
+           VerifyOffset(verifier, VT_CELLS) &&
+           verifier.VerifyVector(cells()) &&
+           verifier.VerifyVectorOfTables(cells()) &&
+           verifier.EndTable();
+  }
+};
+
+struct WorldPartitionBuilder {
+  typedef WorldPartition Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_cell_size(float cell_size) {
+    fbb_.AddElement<float>(WorldPartition::VT_CELL_SIZE, cell_size, 0.0f);
+  }
+  void add_data_section_size(uint64_t data_section_size) {
+    fbb_.AddElement<uint64_t>(WorldPartition::VT_DATA_SECTION_SIZE, data_section_size, 0);
+  }
+  void add_next_entity_id(uint32_t next_entity_id) {
+    fbb_.AddElement<uint32_t>(WorldPartition::VT_NEXT_ENTITY_ID, next_entity_id, 0);
+  }
+  void add_cells(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneCell>>> cells) {
+    fbb_.AddOffset(WorldPartition::VT_CELLS, cells);
+  }
+  explicit WorldPartitionBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<WorldPartition> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<WorldPartition>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<WorldPartition> CreateWorldPartition(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    float cell_size = 0.0f,
+    uint64_t data_section_size = 0,
+    uint32_t next_entity_id = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneCell>>> cells = 0) {
+  WorldPartitionBuilder builder_(_fbb);
+  builder_.add_data_section_size(data_section_size);
+  builder_.add_cells(cells);
+  builder_.add_next_entity_id(next_entity_id);
+  builder_.add_cell_size(cell_size);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<WorldPartition> CreateWorldPartitionDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    float cell_size = 0.0f,
+    uint64_t data_section_size = 0,
+    uint32_t next_entity_id = 0,
+    const std::vector<::flatbuffers::Offset<ECS::SceneCell>> *cells = nullptr) {
+  auto cells__ = cells ? _fbb.CreateVector<::flatbuffers::Offset<ECS::SceneCell>>(*cells) : 0;
+  return ECS::CreateWorldPartition(
+      _fbb,
+      cell_size,
+      data_section_size,
+      next_entity_id,
+      cells__);
+}
+
+struct SpatialIndex FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef SpatialIndexBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_ENTITY_BOUNDS = 4,
+    VT_NODES = 6,
+    VT_ITEMS = 8
+  };
+  const ::flatbuffers::Vector<const ECS::Bounds *> *entity_bounds() const {
+    return GetPointer<const ::flatbuffers::Vector<const ECS::Bounds *> *>(VT_ENTITY_BOUNDS);
+  }
+  const ::flatbuffers::Vector<const ECS::BvhNode *> *nodes() const {
+    return GetPointer<const ::flatbuffers::Vector<const ECS::BvhNode *> *>(VT_NODES);
+  }
+  const ::flatbuffers::Vector<uint32_t> *items() const {
+    return GetPointer<const ::flatbuffers::Vector<uint32_t> *>(VT_ITEMS);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_ENTITY_BOUNDS) &&
+           verifier.VerifyVector(entity_bounds()) &&
+           VerifyOffset(verifier, VT_NODES) &&
+           verifier.VerifyVector(nodes()) &&
+           VerifyOffset(verifier, VT_ITEMS) &&
+           verifier.VerifyVector(items()) &&
+           verifier.EndTable();
+  }
+};
+
+struct SpatialIndexBuilder {
+  typedef SpatialIndex Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_entity_bounds(::flatbuffers::Offset<::flatbuffers::Vector<const ECS::Bounds *>> entity_bounds) {
+    fbb_.AddOffset(SpatialIndex::VT_ENTITY_BOUNDS, entity_bounds);
+  }
+  void add_nodes(::flatbuffers::Offset<::flatbuffers::Vector<const ECS::BvhNode *>> nodes) {
+    fbb_.AddOffset(SpatialIndex::VT_NODES, nodes);
+  }
+  void add_items(::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> items) {
+    fbb_.AddOffset(SpatialIndex::VT_ITEMS, items);
+  }
+  explicit SpatialIndexBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<SpatialIndex> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<SpatialIndex>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<SpatialIndex> CreateSpatialIndex(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    ::flatbuffers::Offset<::flatbuffers::Vector<const ECS::Bounds *>> entity_bounds = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<const ECS::BvhNode *>> nodes = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> items = 0) {
+  SpatialIndexBuilder builder_(_fbb);
+  builder_.add_items(items);
+  builder_.add_nodes(nodes);
+  builder_.add_entity_bounds(entity_bounds);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<SpatialIndex> CreateSpatialIndexDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<ECS::Bounds> *entity_bounds = nullptr,
+    const std::vector<ECS::BvhNode> *nodes = nullptr,
+    const std::vector<uint32_t> *items = nullptr) {
+  auto entity_bounds__ = entity_bounds ? _fbb.CreateVectorOfStructs<ECS::Bounds>(*entity_bounds) : 0;
+  auto nodes__ = nodes ? _fbb.CreateVectorOfStructs<ECS::BvhNode>(*nodes) : 0;
+  auto items__ = items ? _fbb.CreateVector<uint32_t>(*items) : 0;
+  return ECS::CreateSpatialIndex(
+      _fbb,
+      entity_bounds__,
+      nodes__,
+      items__);
+}
+
 struct Scene FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
   typedef SceneBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
-    VT_ENTITIES = 4
+    VT_ENTITIES = 4,
+    VT_CHUNKS = 6,
+    VT_JOURNAL_ID = 8,
+    VT_ASSETS = 10,
+    VT_PARTITION = 12,
+    VT_SPATIAL_INDEX = 14
   };
   const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>> *entities() const {
     return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>> *>(VT_ENTITIES);
   }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneChunk>> *chunks() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneChunk>> *>(VT_CHUNKS);
+  }
+  uint64_t journal_id() const {
+    return GetField<uint64_t>(VT_JOURNAL_ID, 0);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::Asset>> *assets() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::Asset>> *>(VT_ASSETS);
+  }
+  const ECS::WorldPartition *partition() const {
+    return GetPointer<const ECS::WorldPartition *>(VT_PARTITION);
+  }
+  const ECS::SpatialIndex *spatial_index() const {
+    return GetPointer<const ECS::SpatialIndex *>(VT_SPATIAL_INDEX);
+  }
   bool Verify(::flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_ENTITIES) &&
            verifier.VerifyVector(entities()) &&
            verifier.VerifyVectorOfTables(entities()) &&
+           VerifyOffset(verifier, VT_CHUNKS) &&
+           verifier.VerifyVector(chunks()) &&
+           verifier.VerifyVectorOfTables(chunks()) &&
+           VerifyField<uint64_t>(verifier, VT_JOURNAL_ID, 8) &&
+           VerifyOffset(verifier, VT_ASSETS) &&
+           verifier.VerifyVector(assets()) &&
+           verifier.VerifyVectorOfTables(assets()) &&
+           VerifyOffset(verifier, VT_PARTITION) &&
+           verifier.VerifyTable(partition()) &&
+           VerifyOffset(verifier, VT_SPATIAL_INDEX) &&
+           verifier.VerifyTable(spatial_index()) &&
            verifier.EndTable();
   }
 };
@@ -742,6 +1660,21 @@ struct SceneBuilder {
   void add_entities(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>>> entities) {
     fbb_.AddOffset(Scene::VT_ENTITIES, entities);
   }
+  void add_chunks(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneChunk>>> chunks) {
+    fbb_.AddOffset(Scene::VT_CHUNKS, chunks);
+  }
+  void add_journal_id(uint64_t journal_id) {
+    fbb_.AddElement<uint64_t>(Scene::VT_JOURNAL_ID, journal_id, 0);
+  }
+  void add_assets(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Asset>>> assets) {
+    fbb_.AddOffset(Scene::VT_ASSETS, assets);
+  }
+  void add_partition(::flatbuffers::Offset<ECS::WorldPartition> partition) {
+    fbb_.AddOffset(Scene::VT_PARTITION, partition);
+  }
+  void add_spatial_index(::flatbuffers::Offset<ECS::SpatialIndex> spatial_index) {
+    fbb_.AddOffset(Scene::VT_SPATIAL_INDEX, spatial_index);
+  }
   explicit SceneBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -755,19 +1688,119 @@ struct SceneBuilder {
 
 inline ::flatbuffers::Offset<Scene> CreateScene(
     ::flatbuffers::FlatBufferBuilder &_fbb,
-    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>>> entities = 0) {
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>>> entities = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::SceneChunk>>> chunks = 0,
+    uint64_t journal_id = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Asset>>> assets = 0,
+    ::flatbuffers::Offset<ECS::WorldPartition> partition = 0,
+    ::flatbuffers::Offset<ECS::SpatialIndex> spatial_index = 0) {
   SceneBuilder builder_(_fbb);
+  builder_.add_journal_id(journal_id);
+  builder_.add_spatial_index(spatial_index);
+  builder_.add_partition(partition);
+  builder_.add_assets(assets);
+  builder_.add_chunks(chunks);
   builder_.add_entities(entities);
   return builder_.Finish();
 }
 
 inline ::flatbuffers::Offset<Scene> CreateSceneDirect(
     ::flatbuffers::FlatBufferBuilder &_fbb,
-    const std::vector<::flatbuffers::Offset<ECS::Entity>> *entities = nullptr) {
+    const std::vector<::flatbuffers::Offset<ECS::Entity>> *entities = nullptr,
+    const std::vector<::flatbuffers::Offset<ECS::SceneChunk>> *chunks = nullptr,
+    uint64_t journal_id = 0,
+    const std::vector<::flatbuffers::Offset<ECS::Asset>> *assets = nullptr,
+    ::flatbuffers::Offset<ECS::WorldPartition> partition = 0,
+    ::flatbuffers::Offset<ECS::SpatialIndex> spatial_index = 0) {
   auto entities__ = entities ? _fbb.CreateVector<::flatbuffers::Offset<ECS::Entity>>(*entities) : 0;
+  auto chunks__ = chunks ? _fbb.CreateVector<::flatbuffers::Offset<ECS::SceneChunk>>(*chunks) : 0;
+  auto assets__ = assets ? _fbb.CreateVector<::flatbuffers::Offset<ECS::Asset>>(*assets) : 0;
   return ECS::CreateScene(
       _fbb,
-      entities__);
+      entities__,
+      chunks__,
+      journal_id,
+      assets__,
+      partition,
+      spatial_index);
+}
+
+struct SceneDelta FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef SceneDeltaBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_BASE_JOURNAL_ID = 4,
+    VT_ENTITIES = 6,
+    VT_REMOVED = 8
+  };
+  uint64_t base_journal_id() const {
+    return GetField<uint64_t>(VT_BASE_JOURNAL_ID, 0);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>> *entities() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>> *>(VT_ENTITIES);
+  }
+  const ::flatbuffers::Vector<uint32_t> *removed() const {
+    return GetPointer<const ::flatbuffers::Vector<uint32_t> *>(VT_REMOVED);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint64_t>(verifier, VT_BASE_JOURNAL_ID, 8) &&
+           VerifyOffset(verifier, VT_ENTITIES) &&
+           verifier.VerifyVector(entities()) &&
+           verifier.VerifyVectorOfTables(entities()) &&
+           VerifyOffset(verifier, VT_REMOVED) &&
+           verifier.VerifyVector(removed()) &&
+           verifier.EndTable();
+  }
+};
+
+struct SceneDeltaBuilder {
+  typedef SceneDelta Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_base_journal_id(uint64_t base_journal_id) {
+    fbb_.AddElement<uint64_t>(SceneDelta::VT_BASE_JOURNAL_ID, base_journal_id, 0);
+  }
+  void add_entities(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>>> entities) {
+    fbb_.AddOffset(SceneDelta::VT_ENTITIES, entities);
+  }
+  void add_removed(::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> removed) {
+    fbb_.AddOffset(SceneDelta::VT_REMOVED, removed);
+  }
+  explicit SceneDeltaBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<SceneDelta> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<SceneDelta>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<SceneDelta> CreateSceneDelta(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    uint64_t base_journal_id = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<ECS::Entity>>> entities = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint32_t>> removed = 0) {
+  SceneDeltaBuilder builder_(_fbb);
+  builder_.add_base_journal_id(base_journal_id);
+  builder_.add_removed(removed);
+  builder_.add_entities(entities);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<SceneDelta> CreateSceneDeltaDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    uint64_t base_journal_id = 0,
+    const std::vector<::flatbuffers::Offset<ECS::Entity>> *entities = nullptr,
+    const std::vector<uint32_t> *removed = nullptr) {
+  auto entities__ = entities ? _fbb.CreateVector<::flatbuffers::Offset<ECS::Entity>>(*entities) : 0;
+  auto removed__ = removed ? _fbb.CreateVector<uint32_t>(*removed) : 0;
+  return ECS::CreateSceneDelta(
+      _fbb,
+      base_journal_id,
+      entities__,
+      removed__);
 }
 
 inline const ECS::Scene *GetScene(const void *buf) {
@@ -49,6 +49,9 @@ struct IWICMetadataQueryReader;
 
 #define DIRECTX_TEX_VERSION 206
 
+// GenerateMipMaps, GenerateMipMaps3D and Resize take a TaskExecutor, as does ConvertOptions
+#define DIRECTX_TEX_TASK_EXECUTOR 1
+
 #ifdef DIRECTX_TEX_EXPORT
 #define DIRECTX_TEX_API __declspec(dllexport)
 #elif DIRECTX_TEX_IMPORT
@@ -732,6 +735,15 @@ namespace DirectX
     constexpr uint32_t TEX_FILTER_MODE_MASK = 0xF00000;
     constexpr uint32_t TEX_FILTER_SRGB_MASK = 0xF000000;
 
+    using TaskExecutor = std::function<void __cdecl(size_t count, const std::function<void __cdecl(size_t index)>& task)>;
+        // Runs task(0) through task(count - 1) and returns once every call has returned. The calls are
+        // independent and may run concurrently on any thread, so a job system or thread pool fits.
+        //
+        // The overloads taking an executor split the custom point, box, linear and cubic filters into strips
+        // of rows (and volume slices) run as separate tasks. Their results match the serial overloads exactly.
+        // The triangle filter and the WIC paths still run on the calling thread, pass TEX_FILTER_FORCE_NON_WIC
+        // to keep 8-bit formats on the custom filters. An empty executor is the same as the serial overload.
+
     DIRECTX_TEX_API HRESULT __cdecl Resize(
         _In_ const Image& srcImage, _In_ size_t width, _In_ size_t height,
         _In_ TEX_FILTER_FLAGS filter,
@@ -739,6 +751,14 @@ namespace DirectX
     DIRECTX_TEX_API HRESULT __cdecl Resize(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ size_t width, _In_ size_t height, _In_ TEX_FILTER_FLAGS filter, _Out_ ScratchImage& result) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl Resize(
+        _In_ const Image& srcImage, _In_ size_t width, _In_ size_t height,
+        _In_ TEX_FILTER_FLAGS filter, _In_ const TaskExecutor& executor,
+        _Out_ ScratchImage& image) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl Resize(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ size_t width, _In_ size_t height, _In_ TEX_FILTER_FLAGS filter, _In_ const TaskExecutor& executor,
+        _Out_ ScratchImage& result) noexcept;
         // Resize the image to width x height. Defaults to Fant filtering.
         // Note for a complex resize, the result will always have mipLevels == 1
 
@@ -749,6 +769,8 @@ namespace DirectX
     {
         TEX_FILTER_FLAGS filter;
         float            threshold;
+        TaskExecutor     executor;
+            // Optional, converts strips of rows as separate tasks unless dithering, reporting progress or using WIC
     };
 
     DIRECTX_TEX_API HRESULT __cdecl Convert(
@@ -780,6 +802,12 @@ namespace DirectX
     DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _Inout_ ScratchImage& mipChain);
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps(
+        _In_ const Image& baseImage, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _In_ const TaskExecutor& executor,
+        _Inout_ ScratchImage& mipChain, _In_ bool allow1D = false) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _In_ const TaskExecutor& executor, _Inout_ ScratchImage& mipChain);
         // levels of '0' indicates a full mipchain, otherwise is generates that number of total levels (including the source base image)
         // Defaults to Fant filtering which is equivalent to a box filter
 
@@ -789,6 +817,12 @@ namespace DirectX
     DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps3D(
         _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
         _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _Out_ ScratchImage& mipChain);
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps3D(
+        _In_reads_(depth) const Image* baseImages, _In_ size_t depth, _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels,
+        _In_ const TaskExecutor& executor, _Out_ ScratchImage& mipChain) noexcept;
+    DIRECTX_TEX_API HRESULT __cdecl GenerateMipMaps3D(
+        _In_reads_(nimages) const Image* srcImages, _In_ size_t nimages, _In_ const TexMetadata& metadata,
+        _In_ TEX_FILTER_FLAGS filter, _In_ size_t levels, _In_ const TaskExecutor& executor, _Out_ ScratchImage& mipChain);
         // levels of '0' indicates a full mipchain, otherwise is generates that number of total levels (including the source base image)
         // Defaults to Fant filtering which is equivalent to a box filter
 
@@ -4805,6 +4805,7 @@ namespace
         _In_ const Image& destImage,
         _In_ float threshold,
         size_t z,
+        const TaskExecutor& executor,
         const std::function<bool __cdecl(size_t, size_t)>& statusCallback) noexcept
     {
         assert(srcImage.width == destImage.width);
@@ -4817,6 +4818,29 @@ namespace
 
         size_t width = srcImage.width;
 
+        if (executor && !statusCallback && !(filter & (TEX_FILTER_DITHER | TEX_FILTER_DITHER_DIFFUSION)))
+        {
+            // Without dithering rows are independent, each strip converts through its own scanline
+            return ExecuteRowStrips(executor, width, srcImage.height, [&](size_t y0, size_t y1) noexcept -> HRESULT
+                {
+                    auto scanline = make_AlignedArrayXMVECTOR(width);
+                    if (!scanline)
+                        return E_OUTOFMEMORY;
+
+                    for (size_t h = y0; h < y1; ++h)
+                    {
+                        if (!LoadScanline(scanline.get(), width, pSrc + h * srcImage.rowPitch, srcImage.rowPitch, srcImage.format))
+                            return E_FAIL;
+
+                        ConvertScanline(scanline.get(), width, destImage.format, srcImage.format, filter);
+
+                        if (!StoreScanline(pDest + h * destImage.rowPitch, destImage.rowPitch, destImage.format, scanline.get(), width, threshold))
+                            return E_FAIL;
+                    }
+                    return S_OK;
+                });
+        }
+
         if (filter & TEX_FILTER_DITHER_DIFFUSION)
         {
             // Error diffusion dithering (aka Floyd-Steinberg dithering)
@@ -5150,7 +5174,7 @@ HRESULT DirectX::ConvertEx(
     }
     else
     {
-        hr = ConvertCustom(srcImage, options.filter, *rimage, options.threshold, 0, statusCallback);
+        hr = ConvertCustom(srcImage, options.filter, *rimage, options.threshold, 0, options.executor, statusCallback);
     }
 
     if (FAILED(hr))
@@ -5292,7 +5316,7 @@ HRESULT DirectX::ConvertEx(
             }
             else
             {
-                hr = ConvertCustom(src, options.filter, dst, options.threshold, 0, nullptr);
+                hr = ConvertCustom(src, options.filter, dst, options.threshold, 0, options.executor, nullptr);
             }
 
             if (FAILED(hr))
@@ -5354,7 +5378,7 @@ HRESULT DirectX::ConvertEx(
                     }
                     else
                     {
-                        hr = ConvertCustom(src, options.filter, dst, options.threshold, slice, nullptr);
+                        hr = ConvertCustom(src, options.filter, dst, options.threshold, slice, options.executor, nullptr);
                     }
 
                     if (FAILED(hr))
@@ -904,34 +904,80 @@ namespace
     }
 
     //--- 2D Point Filter ---
-    HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item) noexcept
+    // Filters src into the next mip level dest, each strip of destination rows on its own
+    HRESULT Generate2DMipLevelPointFilter(const Image& src, const Image& dest, const TaskExecutor& executor) noexcept
     {
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
+        const size_t width = src.width;
+        const size_t height = src.height;
 
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+        const size_t rowPitch = src.rowPitch;
 
-        assert(levels > 1);
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+        const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+        const size_t xinc = (width << 16) / nwidth;
+        const size_t yinc = (height << 16) / nheight;
 
-        // Allocate temporary space (2 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        return ExecuteRowStrips(executor, nwidth, nheight, [&](size_t y0, size_t y1) -> HRESULT
+            {
+                // Allocate temporary space (2 scanlines)
+                auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
+                if (!scanline)
+                    return E_OUTOFMEMORY;
+
+                XMVECTOR* target = scanline.get();
 
-        XMVECTOR* target = scanline.get();
+                XMVECTOR* row = target + width;
+
+            #ifdef _DEBUG
+                memset(row, 0xCD, sizeof(XMVECTOR)*width);
+            #endif
+
+                const uint8_t* pSrc = src.pixels;
+                uint8_t* pDest = dest.pixels + dest.rowPitch * y0;
+
+                size_t lasty = size_t(-1);
+
+                size_t sy = yinc * y0;
+                for (size_t y = y0; y < y1; ++y)
+                {
+                    if ((lasty ^ sy) >> 16)
+                    {
+                        if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src.format))
+                            return E_FAIL;
+                        lasty = sy;
+                    }
 
-        XMVECTOR* row = target + width;
+                    size_t sx = 0;
+                    for (size_t x = 0; x < nwidth; ++x)
+                    {
+                        target[x] = row[sx >> 16];
+                        sx += xinc;
+                    }
+
+                    if (!StoreScanline(pDest, dest.rowPitch, dest.format, target, nwidth))
+                        return E_FAIL;
+                    pDest += dest.rowPitch;
+
+                    sy += yinc;
+                }
+
+                return S_OK;
+            });
+    }
+
+    HRESULT Generate2DMipsPointFilter(size_t levels, const ScratchImage& mipChain, size_t item, const TaskExecutor& executor) noexcept
+    {
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
+
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+
+        assert(levels > 1);
 
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
-        #ifdef _DEBUG
-            memset(row, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
-
             // 2D point filter
             const Image* src = mipChain.GetImage(level - 1, item, 0);
             const Image* dest = mipChain.GetImage(level, item, 0);
@@ -939,59 +985,78 @@ namespace
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+            const HRESULT hr = Generate2DMipLevelPointFilter(*src, *dest, executor);
+            if (FAILED(hr))
+                return hr;
+        }
 
-            const size_t rowPitch = src->rowPitch;
+        return S_OK;
+    }
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-            const size_t xinc = (width << 16) / nwidth;
-            const size_t yinc = (height << 16) / nheight;
+    //--- 2D Box Filter ---
+    HRESULT Generate2DMipLevelBoxFilter(const Image& src, const Image& dest, TEX_FILTER_FLAGS filter, const TaskExecutor& executor) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        const size_t width = src.width;
+        const size_t height = src.height;
 
-            size_t lasty = size_t(-1);
+        const size_t rowPitch = src.rowPitch;
 
-            size_t sy = 0;
-            for (size_t y = 0; y < nheight; ++y)
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+        const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+        return ExecuteRowStrips(executor, nwidth, nheight, [&](size_t y0, size_t y1) -> HRESULT
             {
-                if ((lasty ^ sy) >> 16)
-                {
-                    if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                        return E_FAIL;
-                    lasty = sy;
-                }
+                // Allocate temporary space (3 scanlines)
+                auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+                if (!scanline)
+                    return E_OUTOFMEMORY;
+
+                XMVECTOR* target = scanline.get();
+
+                XMVECTOR* urow0 = target + width;
+                XMVECTOR* urow1 = (height > 1) ? target + width * 2 : urow0;
+
+                const XMVECTOR* urow2 = (width > 1) ? urow0 + 1 : urow0;
+                const XMVECTOR* urow3 = (width > 1) ? urow1 + 1 : urow1;
+
+                // Two source rows per destination row
+                const uint8_t* pSrc = src.pixels + rowPitch * ((urow0 != urow1) ? y0 * 2 : y0);
+                uint8_t* pDest = dest.pixels + dest.rowPitch * y0;
 
-                size_t sx = 0;
-                for (size_t x = 0; x < nwidth; ++x)
+                for (size_t y = y0; y < y1; ++y)
                 {
-                    target[x] = row[sx >> 16];
-                    sx += xinc;
-                }
+                    if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src.format, filter))
+                        return E_FAIL;
+                    pSrc += rowPitch;
 
-                if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
+                    if (urow0 != urow1)
+                    {
+                        if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src.format, filter))
+                            return E_FAIL;
+                        pSrc += rowPitch;
+                    }
 
-                sy += yinc;
-            }
+                    for (size_t x = 0; x < nwidth; ++x)
+                    {
+                        const size_t x2 = x << 1;
 
-            if (height > 1)
-                height >>= 1;
+                        AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
+                    }
 
-            if (width > 1)
-                width >>= 1;
-        }
+                    if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                        return E_FAIL;
+                    pDest += dest.rowPitch;
+                }
 
-        return S_OK;
+                return S_OK;
+            });
     }
 
-
-    //--- 2D Box Filter ---
-    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    HRESULT Generate2DMipsBoxFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item, const TaskExecutor& executor) noexcept
     {
-        using namespace DirectX::Filters;
-
         if (!mipChain.GetImages())
             return E_INVALIDARG;
 
@@ -999,39 +1064,15 @@ namespace
 
         assert(levels > 1);
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+        const size_t width = mipChain.GetMetadata().width;
+        const size_t height = mipChain.GetMetadata().height;
 
         if (!ispow2(width) || !ispow2(height))
             return E_FAIL;
 
-        // Allocate temporary space (3 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
-            if (height <= 1)
-            {
-                urow1 = urow0;
-            }
-
-            if (width <= 1)
-            {
-                urow2 = urow0;
-                urow3 = urow1;
-            }
-
             // 2D box filter
             const Image* src = mipChain.GetImage(level - 1, item, 0);
             const Image* dest = mipChain.GetImage(level, item, 0);
@@ -1039,52 +1080,100 @@ namespace
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+            const HRESULT hr = Generate2DMipLevelBoxFilter(*src, *dest, filter, executor);
+            if (FAILED(hr))
+                return hr;
+        }
 
-            const size_t rowPitch = src->rowPitch;
+        return S_OK;
+    }
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-            for (size_t y = 0; y < nheight; ++y)
+    //--- 2D Linear Filter ---
+    // The X and Y filters are built by the caller and shared by every strip
+    HRESULT Generate2DMipLevelLinearFilter(const Image& src, const Image& dest, TEX_FILTER_FLAGS filter,
+        const DirectX::Filters::LinearFilter* lfX, const DirectX::Filters::LinearFilter* lfY, const TaskExecutor& executor) noexcept
+    {
+        using namespace DirectX::Filters;
+
+        const size_t width = src.width;
+        const size_t height = src.height;
+
+        const size_t rowPitch = src.rowPitch;
+
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+        const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+        return ExecuteRowStrips(executor, nwidth, nheight, [&](size_t y0, size_t y1) -> HRESULT
             {
-                if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                    return E_FAIL;
-                pSrc += rowPitch;
+                // Allocate temporary space (3 scanlines)
+                auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
+                if (!scanline)
+                    return E_OUTOFMEMORY;
 
-                if (urow0 != urow1)
-                {
-                    if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
-                        return E_FAIL;
-                    pSrc += rowPitch;
-                }
+                XMVECTOR* target = scanline.get();
+
+                XMVECTOR* row0 = target + width;
+                XMVECTOR* row1 = target + width * 2;
+
+            #ifdef _DEBUG
+                memset(row0, 0xCD, sizeof(XMVECTOR)*width);
+                memset(row1, 0xDD, sizeof(XMVECTOR)*width);
+            #endif
 
-                for (size_t x = 0; x < nwidth; ++x)
+                const uint8_t* pSrc = src.pixels;
+                uint8_t* pDest = dest.pixels + dest.rowPitch * y0;
+
+                size_t u0 = size_t(-1);
+                size_t u1 = size_t(-1);
+
+                for (size_t y = y0; y < y1; ++y)
                 {
-                    const size_t x2 = x << 1;
+                    auto const& toY = lfY[y];
 
-                    AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
-                }
+                    if (toY.u0 != u0)
+                    {
+                        if (toY.u0 != u1)
+                        {
+                            u0 = toY.u0;
 
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
-            }
+                            if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src.format, filter))
+                                return E_FAIL;
+                        }
+                        else
+                        {
+                            u0 = u1;
+                            u1 = size_t(-1);
 
-            if (height > 1)
-                height >>= 1;
+                            std::swap(row0, row1);
+                        }
+                    }
 
-            if (width > 1)
-                width >>= 1;
-        }
+                    if (toY.u1 != u1)
+                    {
+                        u1 = toY.u1;
 
-        return S_OK;
-    }
+                        if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src.format, filter))
+                            return E_FAIL;
+                    }
 
+                    for (size_t x = 0; x < nwidth; ++x)
+                    {
+                        auto const& toX = lfX[x];
 
-    //--- 2D Linear Filter ---
-    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+                        BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
+                    }
+
+                    if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                        return E_FAIL;
+                    pDest += dest.rowPitch;
+                }
+
+                return S_OK;
+            });
+    }
+
+    HRESULT Generate2DMipsLinearFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item, const TaskExecutor& executor) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -1098,11 +1187,7 @@ namespace
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
-        // Allocate temporary space (3 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 3);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
+        // Allocate X and Y filters
         std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height]);
         if (!lf)
             return E_OUTOFMEMORY;
@@ -1110,11 +1195,6 @@ namespace
         LinearFilter* lfX = lf.get();
         LinearFilter* lfY = lf.get() + width;
 
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* row0 = target + width;
-        XMVECTOR* row1 = target + width * 2;
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
@@ -1125,66 +1205,15 @@ namespace
             if (!src || !dest)
                 return E_POINTER;
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
-
-            const size_t rowPitch = src->rowPitch;
-
             const size_t nwidth = (width > 1) ? (width >> 1) : 1;
             CreateLinearFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, lfX);
 
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
             CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
 
-        #ifdef _DEBUG
-            memset(row0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(row1, 0xDD, sizeof(XMVECTOR)*width);
-        #endif
-
-            size_t u0 = size_t(-1);
-            size_t u1 = size_t(-1);
-
-            for (size_t y = 0; y < nheight; ++y)
-            {
-                auto const& toY = lfY[y];
-
-                if (toY.u0 != u0)
-                {
-                    if (toY.u0 != u1)
-                    {
-                        u0 = toY.u0;
-
-                        if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
-                    else
-                    {
-                        u0 = u1;
-                        u1 = size_t(-1);
-
-                        std::swap(row0, row1);
-                    }
-                }
-
-                if (toY.u1 != u1)
-                {
-                    u1 = toY.u1;
-
-                    if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                        return E_FAIL;
-                }
-
-                for (size_t x = 0; x < nwidth; ++x)
-                {
-                    auto const& toX = lfX[x];
-
-                    BILINEAR_INTERPOLATE(target[x], toX, toY, row0, row1)
-                }
-
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
-            }
+            const HRESULT hr = Generate2DMipLevelLinearFilter(*src, *dest, filter, lfX, lfY, executor);
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -1201,181 +1230,204 @@ namespace
 #pragma clang diagnostic ignored "-Wextra-semi-stmt"
 #endif
 
-    HRESULT Generate2DMipsCubicFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item) noexcept
+    // The X and Y filters are built by the caller and shared by every strip
+    HRESULT Generate2DMipLevelCubicFilter(const Image& src, const Image& dest, TEX_FILTER_FLAGS filter,
+        const DirectX::Filters::CubicFilter* cfX, const DirectX::Filters::CubicFilter* cfY, const TaskExecutor& executor) noexcept
     {
         using namespace DirectX::Filters;
 
-        if (!mipChain.GetImages())
-            return E_INVALIDARG;
-
-        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
+        const size_t width = src.width;
+        const size_t height = src.height;
 
-        assert(levels > 1);
+        const size_t rowPitch = src.rowPitch;
 
-        size_t width = mipChain.GetMetadata().width;
-        size_t height = mipChain.GetMetadata().height;
+        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+        const size_t nheight = (height > 1) ? (height >> 1) : 1;
 
-        // Allocate temporary space (5 scanlines, plus X and Y filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
+        return ExecuteRowStrips(executor, nwidth, nheight, [&](size_t y0, size_t y1) -> HRESULT
+            {
+                // Allocate temporary space (5 scanlines)
+                auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
+                if (!scanline)
+                    return E_OUTOFMEMORY;
 
-        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[width + height]);
-        if (!cf)
-            return E_OUTOFMEMORY;
+                XMVECTOR* target = scanline.get();
 
-        CubicFilter* cfX = cf.get();
-        CubicFilter* cfY = cf.get() + width;
+                XMVECTOR* row0 = target + width;
+                XMVECTOR* row1 = target + width * 2;
+                XMVECTOR* row2 = target + width * 3;
+                XMVECTOR* row3 = target + width * 4;
 
-        XMVECTOR* target = scanline.get();
+            #ifdef _DEBUG
+                memset(row0, 0xCD, sizeof(XMVECTOR)*width);
+                memset(row1, 0xDD, sizeof(XMVECTOR)*width);
+                memset(row2, 0xED, sizeof(XMVECTOR)*width);
+                memset(row3, 0xFD, sizeof(XMVECTOR)*width);
+            #endif
 
-        XMVECTOR* row0 = target + width;
-        XMVECTOR* row1 = target + width * 2;
-        XMVECTOR* row2 = target + width * 3;
-        XMVECTOR* row3 = target + width * 4;
+                const uint8_t* pSrc = src.pixels;
+                uint8_t* pDest = dest.pixels + dest.rowPitch * y0;
 
-        // Resize base image to each target mip level
-        for (size_t level = 1; level < levels; ++level)
-        {
-            // 2D cubic filter
-            const Image* src = mipChain.GetImage(level - 1, item, 0);
-            const Image* dest = mipChain.GetImage(level, item, 0);
+                size_t u0 = size_t(-1);
+                size_t u1 = size_t(-1);
+                size_t u2 = size_t(-1);
+                size_t u3 = size_t(-1);
 
-            if (!src || !dest)
-                return E_POINTER;
+                for (size_t y = y0; y < y1; ++y)
+                {
+                    auto const& toY = cfY[y];
 
-            const uint8_t* pSrc = src->pixels;
-            uint8_t* pDest = dest->pixels;
+                    // Scanline 1
+                    if (toY.u0 != u0)
+                    {
+                        if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
+                        {
+                            u0 = toY.u0;
 
-            const size_t rowPitch = src->rowPitch;
+                            if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src.format, filter))
+                                return E_FAIL;
+                        }
+                        else if (toY.u0 == u1)
+                        {
+                            u0 = u1;
+                            u1 = size_t(-1);
 
-            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-            CreateCubicFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
+                            std::swap(row0, row1);
+                        }
+                        else if (toY.u0 == u2)
+                        {
+                            u0 = u2;
+                            u2 = size_t(-1);
 
-            const size_t nheight = (height > 1) ? (height >> 1) : 1;
-            CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+                            std::swap(row0, row2);
+                        }
+                        else if (toY.u0 == u3)
+                        {
+                            u0 = u3;
+                            u3 = size_t(-1);
 
-        #ifdef _DEBUG
-            memset(row0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(row1, 0xDD, sizeof(XMVECTOR)*width);
-            memset(row2, 0xED, sizeof(XMVECTOR)*width);
-            memset(row3, 0xFD, sizeof(XMVECTOR)*width);
-        #endif
+                            std::swap(row0, row3);
+                        }
+                    }
 
-            size_t u0 = size_t(-1);
-            size_t u1 = size_t(-1);
-            size_t u2 = size_t(-1);
-            size_t u3 = size_t(-1);
+                    // Scanline 2
+                    if (toY.u1 != u1)
+                    {
+                        if (toY.u1 != u2 && toY.u1 != u3)
+                        {
+                            u1 = toY.u1;
 
-            for (size_t y = 0; y < nheight; ++y)
-            {
-                auto const& toY = cfY[y];
+                            if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src.format, filter))
+                                return E_FAIL;
+                        }
+                        else if (toY.u1 == u2)
+                        {
+                            u1 = u2;
+                            u2 = size_t(-1);
 
-                // Scanline 1
-                if (toY.u0 != u0)
-                {
-                    if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
-                    {
-                        u0 = toY.u0;
+                            std::swap(row1, row2);
+                        }
+                        else if (toY.u1 == u3)
+                        {
+                            u1 = u3;
+                            u3 = size_t(-1);
 
-                        if (!LoadScanlineLinear(row0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                            return E_FAIL;
+                            std::swap(row1, row3);
+                        }
                     }
-                    else if (toY.u0 == u1)
-                    {
-                        u0 = u1;
-                        u1 = size_t(-1);
 
-                        std::swap(row0, row1);
-                    }
-                    else if (toY.u0 == u2)
+                    // Scanline 3
+                    if (toY.u2 != u2)
                     {
-                        u0 = u2;
-                        u2 = size_t(-1);
+                        if (toY.u2 != u3)
+                        {
+                            u2 = toY.u2;
 
-                        std::swap(row0, row2);
-                    }
-                    else if (toY.u0 == u3)
-                    {
-                        u0 = u3;
-                        u3 = size_t(-1);
+                            if (!LoadScanlineLinear(row2, width, pSrc + (rowPitch * u2), rowPitch, src.format, filter))
+                                return E_FAIL;
+                        }
+                        else
+                        {
+                            u2 = u3;
+                            u3 = size_t(-1);
 
-                        std::swap(row0, row3);
+                            std::swap(row2, row3);
+                        }
                     }
-                }
 
-                // Scanline 2
-                if (toY.u1 != u1)
-                {
-                    if (toY.u1 != u2 && toY.u1 != u3)
+                    // Scanline 4
+                    if (toY.u3 != u3)
                     {
-                        u1 = toY.u1;
+                        u3 = toY.u3;
 
-                        if (!LoadScanlineLinear(row1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
+                        if (!LoadScanlineLinear(row3, width, pSrc + (rowPitch * u3), rowPitch, src.format, filter))
                             return E_FAIL;
                     }
-                    else if (toY.u1 == u2)
+
+                    for (size_t x = 0; x < nwidth; ++x)
                     {
-                        u1 = u2;
-                        u2 = size_t(-1);
+                        auto const& toX = cfX[x];
+
+                        XMVECTOR C0, C1, C2, C3;
+
+                        CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3]);
+                        CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3]);
+                        CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3]);
+                        CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3]);
 
-                        std::swap(row1, row2);
+                        CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
                     }
-                    else if (toY.u1 == u3)
-                    {
-                        u1 = u3;
-                        u3 = size_t(-1);
 
-                        std::swap(row1, row3);
-                    }
+                    if (!StoreScanlineLinear(pDest, dest.rowPitch, dest.format, target, nwidth, filter))
+                        return E_FAIL;
+                    pDest += dest.rowPitch;
                 }
 
-                // Scanline 3
-                if (toY.u2 != u2)
-                {
-                    if (toY.u2 != u3)
-                    {
-                        u2 = toY.u2;
+                return S_OK;
+            });
+    }
 
-                        if (!LoadScanlineLinear(row2, width, pSrc + (rowPitch * u2), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
-                    else
-                    {
-                        u2 = u3;
-                        u3 = size_t(-1);
+    HRESULT Generate2DMipsCubicFilter(size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, size_t item, const TaskExecutor& executor) noexcept
+    {
+        using namespace DirectX::Filters;
 
-                        std::swap(row2, row3);
-                    }
-                }
+        if (!mipChain.GetImages())
+            return E_INVALIDARG;
 
-                // Scanline 4
-                if (toY.u3 != u3)
-                {
-                    u3 = toY.u3;
+        // This assumes that the base image is already placed into the mipChain at the top level... (see _Setup2DMips)
 
-                    if (!LoadScanlineLinear(row3, width, pSrc + (rowPitch * u3), rowPitch, src->format, filter))
-                        return E_FAIL;
-                }
+        assert(levels > 1);
 
-                for (size_t x = 0; x < nwidth; ++x)
-                {
-                    auto const& toX = cfX[x];
+        size_t width = mipChain.GetMetadata().width;
+        size_t height = mipChain.GetMetadata().height;
 
-                    XMVECTOR C0, C1, C2, C3;
+        // Allocate X and Y filters
+        std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[width + height]);
+        if (!cf)
+            return E_OUTOFMEMORY;
 
-                    CUBIC_INTERPOLATE(C0, toX.x, row0[toX.u0], row0[toX.u1], row0[toX.u2], row0[toX.u3]);
-                    CUBIC_INTERPOLATE(C1, toX.x, row1[toX.u0], row1[toX.u1], row1[toX.u2], row1[toX.u3]);
-                    CUBIC_INTERPOLATE(C2, toX.x, row2[toX.u0], row2[toX.u1], row2[toX.u2], row2[toX.u3]);
-                    CUBIC_INTERPOLATE(C3, toX.x, row3[toX.u0], row3[toX.u1], row3[toX.u2], row3[toX.u3]);
+        CubicFilter* cfX = cf.get();
+        CubicFilter* cfY = cf.get() + width;
 
-                    CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
-                }
+        // Resize base image to each target mip level
+        for (size_t level = 1; level < levels; ++level)
+        {
+            // 2D cubic filter
+            const Image* src = mipChain.GetImage(level - 1, item, 0);
+            const Image* dest = mipChain.GetImage(level, item, 0);
 
-                if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                    return E_FAIL;
-                pDest += dest->rowPitch;
-            }
+            if (!src || !dest)
+                return E_POINTER;
+
+            const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+            CreateCubicFilter(width, nwidth, (filter & TEX_FILTER_WRAP_U) != 0, (filter & TEX_FILTER_MIRROR_U) != 0, cfX);
+
+            const size_t nheight = (height > 1) ? (height >> 1) : 1;
+            CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
+
+            const HRESULT hr = Generate2DMipLevelCubicFilter(*src, *dest, filter, cfX, cfY, executor);
+            if (FAILED(hr))
+                return hr;
 
             if (height > 1)
                 height >>= 1;
@@ -1663,7 +1715,7 @@ namespace
 
 
     //--- 3D Point Filter ---
-    HRESULT Generate3DMipsPointFilter(size_t depth, size_t levels, const ScratchImage& mipChain) noexcept
+    HRESULT Generate3DMipsPointFilter(size_t depth, size_t levels, const ScratchImage& mipChain, const TaskExecutor& executor) noexcept
     {
         if (!depth || !mipChain.GetImages())
             return E_INVALIDARG;
@@ -1678,21 +1730,10 @@ namespace
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
-        // Allocate temporary space (2 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* row = target + width;
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
-        #ifdef _DEBUG
-            memset(row, 0xCD, sizeof(XMVECTOR)*width);
-        #endif
+            HRESULT hr;
 
             if (depth > 1)
             {
@@ -1701,54 +1742,69 @@ namespace
 
                 const size_t zinc = (depth << 16) / ndepth;
 
-                size_t sz = 0;
-                for (size_t slice = 0; slice < ndepth; ++slice)
-                {
-                    const Image* src = mipChain.GetImage(level - 1, 0, (sz >> 16));
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
+                // Each destination slice is filtered on its own
+                hr = ExecuteTasks(executor, ndepth, [&](size_t slice) -> HRESULT
+                    {
+                        const size_t sz = zinc * slice;
 
-                    if (!src || !dest)
-                        return E_POINTER;
+                        const Image* src = mipChain.GetImage(level - 1, 0, (sz >> 16));
+                        const Image* dest = mipChain.GetImage(level, 0, slice);
 
-                    const uint8_t* pSrc = src->pixels;
-                    uint8_t* pDest = dest->pixels;
+                        if (!src || !dest)
+                            return E_POINTER;
 
-                    const size_t rowPitch = src->rowPitch;
+                        // Allocate temporary space (2 scanlines)
+                        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 2);
+                        if (!scanline)
+                            return E_OUTOFMEMORY;
 
-                    const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                    const size_t nheight = (height > 1) ? (height >> 1) : 1;
+                        XMVECTOR* target = scanline.get();
 
-                    const size_t xinc = (width << 16) / nwidth;
-                    const size_t yinc = (height << 16) / nheight;
+                        XMVECTOR* row = target + width;
 
-                    size_t lasty = size_t(-1);
+                    #ifdef _DEBUG
+                        memset(row, 0xCD, sizeof(XMVECTOR)*width);
+                    #endif
 
-                    size_t sy = 0;
-                    for (size_t y = 0; y < nheight; ++y)
-                    {
-                        if ((lasty ^ sy) >> 16)
-                        {
-                            if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                                return E_FAIL;
-                            lasty = sy;
-                        }
+                        const uint8_t* pSrc = src->pixels;
+                        uint8_t* pDest = dest->pixels;
+
+                        const size_t rowPitch = src->rowPitch;
+
+                        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+                        const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+                        const size_t xinc = (width << 16) / nwidth;
+                        const size_t yinc = (height << 16) / nheight;
+
+                        size_t lasty = size_t(-1);
 
-                        size_t sx = 0;
-                        for (size_t x = 0; x < nwidth; ++x)
+                        size_t sy = 0;
+                        for (size_t y = 0; y < nheight; ++y)
                         {
-                            target[x] = row[sx >> 16];
-                            sx += xinc;
-                        }
+                            if ((lasty ^ sy) >> 16)
+                            {
+                                if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
+                                    return E_FAIL;
+                                lasty = sy;
+                            }
 
-                        if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
+                            size_t sx = 0;
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                target[x] = row[sx >> 16];
+                                sx += xinc;
+                            }
 
-                        sy += yinc;
-                    }
+                            if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
 
-                    sz += zinc;
-                }
+                            sy += yinc;
+                        }
+
+                        return S_OK;
+                    });
             }
             else
             {
@@ -1759,44 +1815,12 @@ namespace
                 if (!src || !dest)
                     return E_POINTER;
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
-
-                const size_t rowPitch = src->rowPitch;
-
-                const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                const size_t nheight = (height > 1) ? (height >> 1) : 1;
-
-                const size_t xinc = (width << 16) / nwidth;
-                const size_t yinc = (height << 16) / nheight;
-
-                size_t lasty = size_t(-1);
-
-                size_t sy = 0;
-                for (size_t y = 0; y < nheight; ++y)
-                {
-                    if ((lasty ^ sy) >> 16)
-                    {
-                        if (!LoadScanline(row, width, pSrc + (rowPitch * (sy >> 16)), rowPitch, src->format))
-                            return E_FAIL;
-                        lasty = sy;
-                    }
-
-                    size_t sx = 0;
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        target[x] = row[sx >> 16];
-                        sx += xinc;
-                    }
-
-                    if (!StoreScanline(pDest, dest->rowPitch, dest->format, target, nwidth))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-
-                    sy += yinc;
-                }
+                hr = Generate2DMipLevelPointFilter(*src, *dest, executor);
             }
 
+            if (FAILED(hr))
+                return hr;
+
             if (height > 1)
                 height >>= 1;
 
@@ -1812,7 +1836,7 @@ namespace
 
 
     //--- 3D Box Filter ---
-    HRESULT Generate3DMipsBoxFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    HRESULT Generate3DMipsBoxFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, const TaskExecutor& executor) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -1832,104 +1856,95 @@ namespace
         if (!ispow2(width) || !ispow2(height) || !ispow2(depth))
             return E_FAIL;
 
-        // Allocate temporary space (5 scanlines)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-        XMVECTOR* vrow0 = target + width * 3;
-        XMVECTOR* vrow1 = target + width * 4;
-
-        const XMVECTOR* urow2 = urow0 + 1;
-        const XMVECTOR* urow3 = urow1 + 1;
-        const XMVECTOR* vrow2 = vrow0 + 1;
-        const XMVECTOR* vrow3 = vrow1 + 1;
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
-            if (height <= 1)
-            {
-                urow1 = urow0;
-                vrow1 = vrow0;
-            }
-
-            if (width <= 1)
-            {
-                urow2 = urow0;
-                urow3 = urow1;
-                vrow2 = vrow0;
-                vrow3 = vrow1;
-            }
+            HRESULT hr;
 
             if (depth > 1)
             {
                 // 3D box filter
                 const size_t ndepth = depth >> 1;
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
-                {
-                    const size_t slicea = std::min<size_t>(slice * 2, depth - 1);
-                    const size_t sliceb = std::min<size_t>(slicea + 1, depth - 1);
+                // Each destination slice is filtered on its own
+                hr = ExecuteTasks(executor, ndepth, [&](size_t slice) -> HRESULT
+                    {
+                        const size_t slicea = std::min<size_t>(slice * 2, depth - 1);
+                        const size_t sliceb = std::min<size_t>(slicea + 1, depth - 1);
 
-                    const Image* srca = mipChain.GetImage(level - 1, 0, slicea);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, sliceb);
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
+                        const Image* srca = mipChain.GetImage(level - 1, 0, slicea);
+                        const Image* srcb = mipChain.GetImage(level - 1, 0, sliceb);
+                        const Image* dest = mipChain.GetImage(level, 0, slice);
 
-                    if (!srca || !srcb || !dest)
-                        return E_POINTER;
+                        if (!srca || !srcb || !dest)
+                            return E_POINTER;
 
-                    const uint8_t* pSrc1 = srca->pixels;
-                    const uint8_t* pSrc2 = srcb->pixels;
-                    uint8_t* pDest = dest->pixels;
+                        // Allocate temporary space (5 scanlines)
+                        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
+                        if (!scanline)
+                            return E_OUTOFMEMORY;
 
-                    const size_t aRowPitch = srca->rowPitch;
-                    const size_t bRowPitch = srcb->rowPitch;
+                        XMVECTOR* target = scanline.get();
 
-                    const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                    const size_t nheight = (height > 1) ? (height >> 1) : 1;
+                        XMVECTOR* urow0 = target + width;
+                        XMVECTOR* urow1 = (height > 1) ? target + width * 2 : urow0;
+                        XMVECTOR* vrow0 = target + width * 3;
+                        XMVECTOR* vrow1 = (height > 1) ? target + width * 4 : vrow0;
 
-                    for (size_t y = 0; y < nheight; ++y)
-                    {
-                        if (!LoadScanlineLinear(urow0, width, pSrc1, aRowPitch, srca->format, filter))
-                            return E_FAIL;
-                        pSrc1 += aRowPitch;
+                        const XMVECTOR* urow2 = (width > 1) ? urow0 + 1 : urow0;
+                        const XMVECTOR* urow3 = (width > 1) ? urow1 + 1 : urow1;
+                        const XMVECTOR* vrow2 = (width > 1) ? vrow0 + 1 : vrow0;
+                        const XMVECTOR* vrow3 = (width > 1) ? vrow1 + 1 : vrow1;
+
+                        const uint8_t* pSrc1 = srca->pixels;
+                        const uint8_t* pSrc2 = srcb->pixels;
+                        uint8_t* pDest = dest->pixels;
+
+                        const size_t aRowPitch = srca->rowPitch;
+                        const size_t bRowPitch = srcb->rowPitch;
 
-                        if (urow0 != urow1)
+                        const size_t nwidth = (width > 1) ? (width >> 1) : 1;
+                        const size_t nheight = (height > 1) ? (height >> 1) : 1;
+
+                        for (size_t y = 0; y < nheight; ++y)
                         {
-                            if (!LoadScanlineLinear(urow1, width, pSrc1, aRowPitch, srca->format, filter))
+                            if (!LoadScanlineLinear(urow0, width, pSrc1, aRowPitch, srca->format, filter))
                                 return E_FAIL;
                             pSrc1 += aRowPitch;
-                        }
 
-                        if (!LoadScanlineLinear(vrow0, width, pSrc2, bRowPitch, srcb->format, filter))
-                            return E_FAIL;
-                        pSrc2 += bRowPitch;
+                            if (urow0 != urow1)
+                            {
+                                if (!LoadScanlineLinear(urow1, width, pSrc1, aRowPitch, srca->format, filter))
+                                    return E_FAIL;
+                                pSrc1 += aRowPitch;
+                            }
 
-                        if (vrow0 != vrow1)
-                        {
-                            if (!LoadScanlineLinear(vrow1, width, pSrc2, bRowPitch, srcb->format, filter))
+                            if (!LoadScanlineLinear(vrow0, width, pSrc2, bRowPitch, srcb->format, filter))
                                 return E_FAIL;
                             pSrc2 += bRowPitch;
-                        }
 
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            const size_t x2 = x << 1;
+                            if (vrow0 != vrow1)
+                            {
+                                if (!LoadScanlineLinear(vrow1, width, pSrc2, bRowPitch, srcb->format, filter))
+                                    return E_FAIL;
+                                pSrc2 += bRowPitch;
+                            }
+
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                const size_t x2 = x << 1;
 
-                            AVERAGE8(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2],
-                                vrow0[x2], vrow1[x2], vrow2[x2], vrow3[x2])
+                                AVERAGE8(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2],
+                                    vrow0[x2], vrow1[x2], vrow2[x2], vrow3[x2])
+                            }
+
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
                         }
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-                    }
-                }
+                        return S_OK;
+                    });
             }
             else
             {
@@ -1940,40 +1955,12 @@ namespace
                 if (!src || !dest)
                     return E_POINTER;
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
-
-                const size_t rowPitch = src->rowPitch;
-
-                const size_t nwidth = (width > 1) ? (width >> 1) : 1;
-                const size_t nheight = (height > 1) ? (height >> 1) : 1;
-
-                for (size_t y = 0; y < nheight; ++y)
-                {
-                    if (!LoadScanlineLinear(urow0, width, pSrc, rowPitch, src->format, filter))
-                        return E_FAIL;
-                    pSrc += rowPitch;
-
-                    if (urow0 != urow1)
-                    {
-                        if (!LoadScanlineLinear(urow1, width, pSrc, rowPitch, src->format, filter))
-                            return E_FAIL;
-                        pSrc += rowPitch;
-                    }
-
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        const size_t x2 = x << 1;
-
-                        AVERAGE4(target[x], urow0[x2], urow1[x2], urow2[x2], urow3[x2])
-                    }
-
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-                }
+                hr = Generate2DMipLevelBoxFilter(*src, *dest, filter, executor);
             }
 
+            if (FAILED(hr))
+                return hr;
+
             if (height > 1)
                 height >>= 1;
 
@@ -1989,7 +1976,7 @@ namespace
 
 
     //--- 3D Linear Filter ---
-    HRESULT Generate3DMipsLinearFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    HRESULT Generate3DMipsLinearFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, const TaskExecutor& executor) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -2006,11 +1993,7 @@ namespace
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
-        // Allocate temporary space (5 scanlines, plus X/Y/Z filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
+        // Allocate X/Y/Z filters
         std::unique_ptr<LinearFilter[]> lf(new (std::nothrow) LinearFilter[width + height + depth]);
         if (!lf)
             return E_OUTOFMEMORY;
@@ -2019,13 +2002,6 @@ namespace
         LinearFilter* lfY = lf.get() + width;
         LinearFilter* lfZ = lf.get() + width + height;
 
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow0 = target + width;
-        XMVECTOR* urow1 = target + width * 2;
-        XMVECTOR* vrow0 = target + width * 3;
-        XMVECTOR* vrow1 = target + width * 4;
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
@@ -2035,12 +2011,7 @@ namespace
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
             CreateLinearFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, lfY);
 
-        #ifdef _DEBUG
-            memset(urow0, 0xCD, sizeof(XMVECTOR)*width);
-            memset(urow1, 0xDD, sizeof(XMVECTOR)*width);
-            memset(vrow0, 0xED, sizeof(XMVECTOR)*width);
-            memset(vrow1, 0xFD, sizeof(XMVECTOR)*width);
-        #endif
+            HRESULT hr;
 
             if (depth > 1)
             {
@@ -2048,130 +2019,107 @@ namespace
                 const size_t ndepth = depth >> 1;
                 CreateLinearFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, lfZ);
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
-                {
-                    auto const& toZ = lfZ[slice];
-
-                    const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
-                    if (!srca || !srcb)
-                        return E_POINTER;
-
-                    size_t u0 = size_t(-1);
-                    size_t u1 = size_t(-1);
-
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
-                    if (!dest)
-                        return E_POINTER;
-
-                    uint8_t* pDest = dest->pixels;
-
-                    for (size_t y = 0; y < nheight; ++y)
+                // Each destination slice is filtered on its own
+                hr = ExecuteTasks(executor, ndepth, [&](size_t slice) -> HRESULT
                     {
-                        auto const& toY = lfY[y];
-
-                        if (toY.u0 != u0)
-                        {
-                            if (toY.u0 != u1)
-                            {
-                                u0 = toY.u0;
+                        auto const& toZ = lfZ[slice];
 
-                                if (!LoadScanlineLinear(urow0, width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
-                                    || !LoadScanlineLinear(vrow0, width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter))
-                                    return E_FAIL;
-                            }
-                            else
-                            {
-                                u0 = u1;
-                                u1 = size_t(-1);
-
-                                std::swap(urow0, urow1);
-                                std::swap(vrow0, vrow1);
-                            }
-                        }
+                        const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
+                        const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
+                        if (!srca || !srcb)
+                            return E_POINTER;
 
-                        if (toY.u1 != u1)
-                        {
-                            u1 = toY.u1;
+                        const Image* dest = mipChain.GetImage(level, 0, slice);
+                        if (!dest)
+                            return E_POINTER;
 
-                            if (!LoadScanlineLinear(urow1, width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
-                                || !LoadScanlineLinear(vrow1, width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter))
-                                return E_FAIL;
-                        }
+                        // Allocate temporary space (5 scanlines)
+                        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 5);
+                        if (!scanline)
+                            return E_OUTOFMEMORY;
 
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            auto const& toX = lfX[x];
+                        XMVECTOR* target = scanline.get();
 
-                            TRILINEAR_INTERPOLATE(target[x], toX, toY, toZ, urow0, urow1, vrow0, vrow1)
-                        }
+                        XMVECTOR* urow0 = target + width;
+                        XMVECTOR* urow1 = target + width * 2;
+                        XMVECTOR* vrow0 = target + width * 3;
+                        XMVECTOR* vrow1 = target + width * 4;
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-                    }
-                }
-            }
-            else
-            {
-                // 2D linear filter
-                const Image* src = mipChain.GetImage(level - 1, 0, 0);
-                const Image* dest = mipChain.GetImage(level, 0, 0);
+                    #ifdef _DEBUG
+                        memset(urow0, 0xCD, sizeof(XMVECTOR)*width);
+                        memset(urow1, 0xDD, sizeof(XMVECTOR)*width);
+                        memset(vrow0, 0xED, sizeof(XMVECTOR)*width);
+                        memset(vrow1, 0xFD, sizeof(XMVECTOR)*width);
+                    #endif
 
-                if (!src || !dest)
-                    return E_POINTER;
+                        size_t u0 = size_t(-1);
+                        size_t u1 = size_t(-1);
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
+                        uint8_t* pDest = dest->pixels;
 
-                const size_t rowPitch = src->rowPitch;
+                        for (size_t y = 0; y < nheight; ++y)
+                        {
+                            auto const& toY = lfY[y];
 
-                size_t u0 = size_t(-1);
-                size_t u1 = size_t(-1);
+                            if (toY.u0 != u0)
+                            {
+                                if (toY.u0 != u1)
+                                {
+                                    u0 = toY.u0;
 
-                for (size_t y = 0; y < nheight; ++y)
-                {
-                    auto const& toY = lfY[y];
+                                    if (!LoadScanlineLinear(urow0, width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
+                                        || !LoadScanlineLinear(vrow0, width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter))
+                                        return E_FAIL;
+                                }
+                                else
+                                {
+                                    u0 = u1;
+                                    u1 = size_t(-1);
 
-                    if (toY.u0 != u0)
-                    {
-                        if (toY.u0 != u1)
-                        {
-                            u0 = toY.u0;
+                                    std::swap(urow0, urow1);
+                                    std::swap(vrow0, vrow1);
+                                }
+                            }
 
-                            if (!LoadScanlineLinear(urow0, width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                                return E_FAIL;
-                        }
-                        else
-                        {
-                            u0 = u1;
-                            u1 = size_t(-1);
+                            if (toY.u1 != u1)
+                            {
+                                u1 = toY.u1;
 
-                            std::swap(urow0, urow1);
-                        }
-                    }
+                                if (!LoadScanlineLinear(urow1, width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
+                                    || !LoadScanlineLinear(vrow1, width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter))
+                                    return E_FAIL;
+                            }
 
-                    if (toY.u1 != u1)
-                    {
-                        u1 = toY.u1;
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                auto const& toX = lfX[x];
 
-                        if (!LoadScanlineLinear(urow1, width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
+                                TRILINEAR_INTERPOLATE(target[x], toX, toY, toZ, urow0, urow1, vrow0, vrow1)
+                            }
 
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        auto const& toX = lfX[x];
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
+                        }
 
-                        BILINEAR_INTERPOLATE(target[x], toX, toY, urow0, urow1)
-                    }
+                        return S_OK;
+                    });
+            }
+            else
+            {
+                // 2D linear filter
+                const Image* src = mipChain.GetImage(level - 1, 0, 0);
+                const Image* dest = mipChain.GetImage(level, 0, 0);
 
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-                }
+                if (!src || !dest)
+                    return E_POINTER;
+
+                hr = Generate2DMipLevelLinearFilter(*src, *dest, filter, lfX, lfY, executor);
             }
 
+            if (FAILED(hr))
+                return hr;
+
             if (height > 1)
                 height >>= 1;
 
@@ -2187,7 +2135,7 @@ namespace
 
 
     //--- 3D Cubic Filter ---
-    HRESULT Generate3DMipsCubicFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain) noexcept
+    HRESULT Generate3DMipsCubicFilter(size_t depth, size_t levels, TEX_FILTER_FLAGS filter, const ScratchImage& mipChain, const TaskExecutor& executor) noexcept
     {
         using namespace DirectX::Filters;
 
@@ -2204,11 +2152,7 @@ namespace
         size_t width = mipChain.GetMetadata().width;
         size_t height = mipChain.GetMetadata().height;
 
-        // Allocate temporary space (17 scanlines, plus X/Y/Z filters)
-        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 17);
-        if (!scanline)
-            return E_OUTOFMEMORY;
-
+        // Allocate X/Y/Z filters
         std::unique_ptr<CubicFilter[]> cf(new (std::nothrow) CubicFilter[width + height + depth]);
         if (!cf)
             return E_OUTOFMEMORY;
@@ -2217,22 +2161,6 @@ namespace
         CubicFilter* cfY = cf.get() + width;
         CubicFilter* cfZ = cf.get() + width + height;
 
-        XMVECTOR* target = scanline.get();
-
-        XMVECTOR* urow[4];
-        XMVECTOR* vrow[4];
-        XMVECTOR* srow[4];
-        XMVECTOR* trow[4];
-
-        XMVECTOR *ptr = scanline.get() + width;
-        for (size_t j = 0; j < 4; ++j)
-        {
-            urow[j] = ptr;  ptr += width;
-            vrow[j] = ptr;  ptr += width;
-            srow[j] = ptr;  ptr += width;
-            trow[j] = ptr;  ptr += width;
-        }
-
         // Resize base image to each target mip level
         for (size_t level = 1; level < levels; ++level)
         {
@@ -2242,15 +2170,7 @@ namespace
             const size_t nheight = (height > 1) ? (height >> 1) : 1;
             CreateCubicFilter(height, nheight, (filter & TEX_FILTER_WRAP_V) != 0, (filter & TEX_FILTER_MIRROR_V) != 0, cfY);
 
-        #ifdef _DEBUG
-            for (size_t j = 0; j < 4; ++j)
-            {
-                memset(urow[j], 0xCD, sizeof(XMVECTOR)*width);
-                memset(vrow[j], 0xDD, sizeof(XMVECTOR)*width);
-                memset(srow[j], 0xED, sizeof(XMVECTOR)*width);
-                memset(trow[j], 0xFD, sizeof(XMVECTOR)*width);
-            }
-        #endif
+            HRESULT hr;
 
             if (depth > 1)
             {
@@ -2258,174 +2178,208 @@ namespace
                 const size_t ndepth = depth >> 1;
                 CreateCubicFilter(depth, ndepth, (filter & TEX_FILTER_WRAP_W) != 0, (filter & TEX_FILTER_MIRROR_W) != 0, cfZ);
 
-                for (size_t slice = 0; slice < ndepth; ++slice)
-                {
-                    auto const& toZ = cfZ[slice];
+                // Each destination slice is filtered on its own
+                hr = ExecuteTasks(executor, ndepth, [&](size_t slice) -> HRESULT
+                    {
+                        auto const& toZ = cfZ[slice];
 
-                    const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
-                    const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
-                    const Image* srcc = mipChain.GetImage(level - 1, 0, toZ.u2);
-                    const Image* srcd = mipChain.GetImage(level - 1, 0, toZ.u3);
-                    if (!srca || !srcb || !srcc || !srcd)
-                        return E_POINTER;
+                        const Image* srca = mipChain.GetImage(level - 1, 0, toZ.u0);
+                        const Image* srcb = mipChain.GetImage(level - 1, 0, toZ.u1);
+                        const Image* srcc = mipChain.GetImage(level - 1, 0, toZ.u2);
+                        const Image* srcd = mipChain.GetImage(level - 1, 0, toZ.u3);
+                        if (!srca || !srcb || !srcc || !srcd)
+                            return E_POINTER;
 
-                    size_t u0 = size_t(-1);
-                    size_t u1 = size_t(-1);
-                    size_t u2 = size_t(-1);
-                    size_t u3 = size_t(-1);
+                        const Image* dest = mipChain.GetImage(level, 0, slice);
+                        if (!dest)
+                            return E_POINTER;
 
-                    const Image* dest = mipChain.GetImage(level, 0, slice);
-                    if (!dest)
-                        return E_POINTER;
+                        // Allocate temporary space (17 scanlines)
+                        auto scanline = make_AlignedArrayXMVECTOR(uint64_t(width) * 17);
+                        if (!scanline)
+                            return E_OUTOFMEMORY;
 
-                    uint8_t* pDest = dest->pixels;
+                        XMVECTOR* target = scanline.get();
 
-                    for (size_t y = 0; y < nheight; ++y)
-                    {
-                        auto const& toY = cfY[y];
+                        XMVECTOR* urow[4];
+                        XMVECTOR* vrow[4];
+                        XMVECTOR* srow[4];
+                        XMVECTOR* trow[4];
 
-                        // Scanline 1
-                        if (toY.u0 != u0)
+                        XMVECTOR *ptr = scanline.get() + width;
+                        for (size_t j = 0; j < 4; ++j)
                         {
-                            if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
-                            {
-                                u0 = toY.u0;
-
-                                if (!LoadScanlineLinear(urow[0], width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
-                                    || !LoadScanlineLinear(urow[1], width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter)
-                                    || !LoadScanlineLinear(urow[2], width, srcc->pixels + (srcc->rowPitch * u0), srcc->rowPitch, srcc->format, filter)
-                                    || !LoadScanlineLinear(urow[3], width, srcd->pixels + (srcd->rowPitch * u0), srcd->rowPitch, srcd->format, filter))
-                                    return E_FAIL;
-                            }
-                            else if (toY.u0 == u1)
-                            {
-                                u0 = u1;
-                                u1 = size_t(-1);
+                            urow[j] = ptr;  ptr += width;
+                            vrow[j] = ptr;  ptr += width;
+                            srow[j] = ptr;  ptr += width;
+                            trow[j] = ptr;  ptr += width;
+                        }
 
-                                std::swap(urow[0], vrow[0]);
-                                std::swap(urow[1], vrow[1]);
-                                std::swap(urow[2], vrow[2]);
-                                std::swap(urow[3], vrow[3]);
-                            }
-                            else if (toY.u0 == u2)
-                            {
-                                u0 = u2;
-                                u2 = size_t(-1);
+                    #ifdef _DEBUG
+                        for (size_t j = 0; j < 4; ++j)
+                        {
+                            memset(urow[j], 0xCD, sizeof(XMVECTOR)*width);
+                            memset(vrow[j], 0xDD, sizeof(XMVECTOR)*width);
+                            memset(srow[j], 0xED, sizeof(XMVECTOR)*width);
+                            memset(trow[j], 0xFD, sizeof(XMVECTOR)*width);
+                        }
+                    #endif
 
-                                std::swap(urow[0], srow[0]);
-                                std::swap(urow[1], srow[1]);
-                                std::swap(urow[2], srow[2]);
-                                std::swap(urow[3], srow[3]);
-                            }
-                            else if (toY.u0 == u3)
-                            {
-                                u0 = u3;
-                                u3 = size_t(-1);
+                        size_t u0 = size_t(-1);
+                        size_t u1 = size_t(-1);
+                        size_t u2 = size_t(-1);
+                        size_t u3 = size_t(-1);
 
-                                std::swap(urow[0], trow[0]);
-                                std::swap(urow[1], trow[1]);
-                                std::swap(urow[2], trow[2]);
-                                std::swap(urow[3], trow[3]);
-                            }
-                        }
+                        uint8_t* pDest = dest->pixels;
 
-                        // Scanline 2
-                        if (toY.u1 != u1)
+                        for (size_t y = 0; y < nheight; ++y)
                         {
-                            if (toY.u1 != u2 && toY.u1 != u3)
-                            {
-                                u1 = toY.u1;
+                            auto const& toY = cfY[y];
 
-                                if (!LoadScanlineLinear(vrow[0], width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
-                                    || !LoadScanlineLinear(vrow[1], width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter)
-                                    || !LoadScanlineLinear(vrow[2], width, srcc->pixels + (srcc->rowPitch * u1), srcc->rowPitch, srcc->format, filter)
-                                    || !LoadScanlineLinear(vrow[3], width, srcd->pixels + (srcd->rowPitch * u1), srcd->rowPitch, srcd->format, filter))
-                                    return E_FAIL;
-                            }
-                            else if (toY.u1 == u2)
+                            // Scanline 1
+                            if (toY.u0 != u0)
                             {
-                                u1 = u2;
-                                u2 = size_t(-1);
+                                if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
+                                {
+                                    u0 = toY.u0;
+
+                                    if (!LoadScanlineLinear(urow[0], width, srca->pixels + (srca->rowPitch * u0), srca->rowPitch, srca->format, filter)
+                                        || !LoadScanlineLinear(urow[1], width, srcb->pixels + (srcb->rowPitch * u0), srcb->rowPitch, srcb->format, filter)
+                                        || !LoadScanlineLinear(urow[2], width, srcc->pixels + (srcc->rowPitch * u0), srcc->rowPitch, srcc->format, filter)
+                                        || !LoadScanlineLinear(urow[3], width, srcd->pixels + (srcd->rowPitch * u0), srcd->rowPitch, srcd->format, filter))
+                                        return E_FAIL;
+                                }
+                                else if (toY.u0 == u1)
+                                {
+                                    u0 = u1;
+                                    u1 = size_t(-1);
+
+                                    std::swap(urow[0], vrow[0]);
+                                    std::swap(urow[1], vrow[1]);
+                                    std::swap(urow[2], vrow[2]);
+                                    std::swap(urow[3], vrow[3]);
+                                }
+                                else if (toY.u0 == u2)
+                                {
+                                    u0 = u2;
+                                    u2 = size_t(-1);
+
+                                    std::swap(urow[0], srow[0]);
+                                    std::swap(urow[1], srow[1]);
+                                    std::swap(urow[2], srow[2]);
+                                    std::swap(urow[3], srow[3]);
+                                }
+                                else if (toY.u0 == u3)
+                                {
+                                    u0 = u3;
+                                    u3 = size_t(-1);
 
-                                std::swap(vrow[0], srow[0]);
-                                std::swap(vrow[1], srow[1]);
-                                std::swap(vrow[2], srow[2]);
-                                std::swap(vrow[3], srow[3]);
+                                    std::swap(urow[0], trow[0]);
+                                    std::swap(urow[1], trow[1]);
+                                    std::swap(urow[2], trow[2]);
+                                    std::swap(urow[3], trow[3]);
+                                }
                             }
-                            else if (toY.u1 == u3)
+
+                            // Scanline 2
+                            if (toY.u1 != u1)
                             {
-                                u1 = u3;
-                                u3 = size_t(-1);
+                                if (toY.u1 != u2 && toY.u1 != u3)
+                                {
+                                    u1 = toY.u1;
+
+                                    if (!LoadScanlineLinear(vrow[0], width, srca->pixels + (srca->rowPitch * u1), srca->rowPitch, srca->format, filter)
+                                        || !LoadScanlineLinear(vrow[1], width, srcb->pixels + (srcb->rowPitch * u1), srcb->rowPitch, srcb->format, filter)
+                                        || !LoadScanlineLinear(vrow[2], width, srcc->pixels + (srcc->rowPitch * u1), srcc->rowPitch, srcc->format, filter)
+                                        || !LoadScanlineLinear(vrow[3], width, srcd->pixels + (srcd->rowPitch * u1), srcd->rowPitch, srcd->format, filter))
+                                        return E_FAIL;
+                                }
+                                else if (toY.u1 == u2)
+                                {
+                                    u1 = u2;
+                                    u2 = size_t(-1);
+
+                                    std::swap(vrow[0], srow[0]);
+                                    std::swap(vrow[1], srow[1]);
+                                    std::swap(vrow[2], srow[2]);
+                                    std::swap(vrow[3], srow[3]);
+                                }
+                                else if (toY.u1 == u3)
+                                {
+                                    u1 = u3;
+                                    u3 = size_t(-1);
 
-                                std::swap(vrow[0], trow[0]);
-                                std::swap(vrow[1], trow[1]);
-                                std::swap(vrow[2], trow[2]);
-                                std::swap(vrow[3], trow[3]);
+                                    std::swap(vrow[0], trow[0]);
+                                    std::swap(vrow[1], trow[1]);
+                                    std::swap(vrow[2], trow[2]);
+                                    std::swap(vrow[3], trow[3]);
+                                }
                             }
-                        }
 
-                        // Scanline 3
-                        if (toY.u2 != u2)
-                        {
-                            if (toY.u2 != u3)
+                            // Scanline 3
+                            if (toY.u2 != u2)
                             {
-                                u2 = toY.u2;
+                                if (toY.u2 != u3)
+                                {
+                                    u2 = toY.u2;
 
-                                if (!LoadScanlineLinear(srow[0], width, srca->pixels + (srca->rowPitch * u2), srca->rowPitch, srca->format, filter)
-                                    || !LoadScanlineLinear(srow[1], width, srcb->pixels + (srcb->rowPitch * u2), srcb->rowPitch, srcb->format, filter)
-                                    || !LoadScanlineLinear(srow[2], width, srcc->pixels + (srcc->rowPitch * u2), srcc->rowPitch, srcc->format, filter)
-                                    || !LoadScanlineLinear(srow[3], width, srcd->pixels + (srcd->rowPitch * u2), srcd->rowPitch, srcd->format, filter))
-                                    return E_FAIL;
+                                    if (!LoadScanlineLinear(srow[0], width, srca->pixels + (srca->rowPitch * u2), srca->rowPitch, srca->format, filter)
+                                        || !LoadScanlineLinear(srow[1], width, srcb->pixels + (srcb->rowPitch * u2), srcb->rowPitch, srcb->format, filter)
+                                        || !LoadScanlineLinear(srow[2], width, srcc->pixels + (srcc->rowPitch * u2), srcc->rowPitch, srcc->format, filter)
+                                        || !LoadScanlineLinear(srow[3], width, srcd->pixels + (srcd->rowPitch * u2), srcd->rowPitch, srcd->format, filter))
+                                        return E_FAIL;
+                                }
+                                else
+                                {
+                                    u2 = u3;
+                                    u3 = size_t(-1);
+
+                                    std::swap(srow[0], trow[0]);
+                                    std::swap(srow[1], trow[1]);
+                                    std::swap(srow[2], trow[2]);
+                                    std::swap(srow[3], trow[3]);
+                                }
                             }
-                            else
+
+                            // Scanline 4
+                            if (toY.u3 != u3)
                             {
-                                u2 = u3;
-                                u3 = size_t(-1);
+                                u3 = toY.u3;
 
-                                std::swap(srow[0], trow[0]);
-                                std::swap(srow[1], trow[1]);
-                                std::swap(srow[2], trow[2]);
-                                std::swap(srow[3], trow[3]);
+                                if (!LoadScanlineLinear(trow[0], width, srca->pixels + (srca->rowPitch * u3), srca->rowPitch, srca->format, filter)
+                                    || !LoadScanlineLinear(trow[1], width, srcb->pixels + (srcb->rowPitch * u3), srcb->rowPitch, srcb->format, filter)
+                                    || !LoadScanlineLinear(trow[2], width, srcc->pixels + (srcc->rowPitch * u3), srcc->rowPitch, srcc->format, filter)
+                                    || !LoadScanlineLinear(trow[3], width, srcd->pixels + (srcd->rowPitch * u3), srcd->rowPitch, srcd->format, filter))
+                                    return E_FAIL;
                             }
-                        }
-
-                        // Scanline 4
-                        if (toY.u3 != u3)
-                        {
-                            u3 = toY.u3;
 
-                            if (!LoadScanlineLinear(trow[0], width, srca->pixels + (srca->rowPitch * u3), srca->rowPitch, srca->format, filter)
-                                || !LoadScanlineLinear(trow[1], width, srcb->pixels + (srcb->rowPitch * u3), srcb->rowPitch, srcb->format, filter)
-                                || !LoadScanlineLinear(trow[2], width, srcc->pixels + (srcc->rowPitch * u3), srcc->rowPitch, srcc->format, filter)
-                                || !LoadScanlineLinear(trow[3], width, srcd->pixels + (srcd->rowPitch * u3), srcd->rowPitch, srcd->format, filter))
-                                return E_FAIL;
-                        }
+                            for (size_t x = 0; x < nwidth; ++x)
+                            {
+                                auto const& toX = cfX[x];
 
-                        for (size_t x = 0; x < nwidth; ++x)
-                        {
-                            auto const& toX = cfX[x];
+                                XMVECTOR D[4];
 
-                            XMVECTOR D[4];
+                                for (size_t j = 0; j < 4; ++j)
+                                {
+                                    XMVECTOR C0, C1, C2, C3;
+                                    CUBIC_INTERPOLATE(C0, toX.x, urow[j][toX.u0], urow[j][toX.u1], urow[j][toX.u2], urow[j][toX.u3]);
+                                    CUBIC_INTERPOLATE(C1, toX.x, vrow[j][toX.u0], vrow[j][toX.u1], vrow[j][toX.u2], vrow[j][toX.u3]);
+                                    CUBIC_INTERPOLATE(C2, toX.x, srow[j][toX.u0], srow[j][toX.u1], srow[j][toX.u2], srow[j][toX.u3]);
+                                    CUBIC_INTERPOLATE(C3, toX.x, trow[j][toX.u0], trow[j][toX.u1], trow[j][toX.u2], trow[j][toX.u3]);
 
-                            for (size_t j = 0; j < 4; ++j)
-                            {
-                                XMVECTOR C0, C1, C2, C3;
-                                CUBIC_INTERPOLATE(C0, toX.x, urow[j][toX.u0], urow[j][toX.u1], urow[j][toX.u2], urow[j][toX.u3]);
-                                CUBIC_INTERPOLATE(C1, toX.x, vrow[j][toX.u0], vrow[j][toX.u1], vrow[j][toX.u2], vrow[j][toX.u3]);
-                                CUBIC_INTERPOLATE(C2, toX.x, srow[j][toX.u0], srow[j][toX.u1], srow[j][toX.u2], srow[j][toX.u3]);
-                                CUBIC_INTERPOLATE(C3, toX.x, trow[j][toX.u0], trow[j][toX.u1], trow[j][toX.u2], trow[j][toX.u3]);
+                                    CUBIC_INTERPOLATE(D[j], toY.x, C0, C1, C2, C3);
+                                }
 
-                                CUBIC_INTERPOLATE(D[j], toY.x, C0, C1, C2, C3);
+                                CUBIC_INTERPOLATE(target[x], toZ.x, D[0], D[1], D[2], D[3]);
                             }
 
-                            CUBIC_INTERPOLATE(target[x], toZ.x, D[0], D[1], D[2], D[3]);
+                            if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
+                                return E_FAIL;
+                            pDest += dest->rowPitch;
                         }
 
-                        if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                            return E_FAIL;
-                        pDest += dest->rowPitch;
-                    }
-                }
+                        return S_OK;
+                    });
             }
             else
             {
@@ -2436,126 +2390,12 @@ namespace
                 if (!src || !dest)
                     return E_POINTER;
 
-                const uint8_t* pSrc = src->pixels;
-                uint8_t* pDest = dest->pixels;
-
-                const size_t rowPitch = src->rowPitch;
-
-                size_t u0 = size_t(-1);
-                size_t u1 = size_t(-1);
-                size_t u2 = size_t(-1);
-                size_t u3 = size_t(-1);
-
-                for (size_t y = 0; y < nheight; ++y)
-                {
-                    auto const& toY = cfY[y];
-
-                    // Scanline 1
-                    if (toY.u0 != u0)
-                    {
-                        if (toY.u0 != u1 && toY.u0 != u2 && toY.u0 != u3)
-                        {
-                            u0 = toY.u0;
-
-                            if (!LoadScanlineLinear(urow[0], width, pSrc + (rowPitch * u0), rowPitch, src->format, filter))
-                                return E_FAIL;
-                        }
-                        else if (toY.u0 == u1)
-                        {
-                            u0 = u1;
-                            u1 = size_t(-1);
-
-                            std::swap(urow[0], vrow[0]);
-                        }
-                        else if (toY.u0 == u2)
-                        {
-                            u0 = u2;
-                            u2 = size_t(-1);
-
-                            std::swap(urow[0], srow[0]);
-                        }
-                        else if (toY.u0 == u3)
-                        {
-                            u0 = u3;
-                            u3 = size_t(-1);
-
-                            std::swap(urow[0], trow[0]);
-                        }
-                    }
-
-                    // Scanline 2
-                    if (toY.u1 != u1)
-                    {
-                        if (toY.u1 != u2 && toY.u1 != u3)
-                        {
-                            u1 = toY.u1;
-
-                            if (!LoadScanlineLinear(vrow[0], width, pSrc + (rowPitch * u1), rowPitch, src->format, filter))
-                                return E_FAIL;
-                        }
-                        else if (toY.u1 == u2)
-                        {
-                            u1 = u2;
-                            u2 = size_t(-1);
-
-                            std::swap(vrow[0], srow[0]);
-                        }
-                        else if (toY.u1 == u3)
-                        {
-                            u1 = u3;
-                            u3 = size_t(-1);
-
-                            std::swap(vrow[0], trow[0]);
-                        }
-                    }
-
-                    // Scanline 3
-                    if (toY.u2 != u2)
-                    {
-                        if (toY.u2 != u3)
-                        {
-                            u2 = toY.u2;
-
-                            if (!LoadScanlineLinear(srow[0], width, pSrc + (rowPitch * u2), rowPitch, src->format, filter))
-                                return E_FAIL;
-                        }
-                        else
-                        {
-                            u2 = u3;
-                            u3 = size_t(-1);
-
-                            std::swap(srow[0], trow[0]);
-                        }
-                    }
-
-                    // Scanline 4
-                    if (toY.u3 != u3)
-                    {
-                        u3 = toY.u3;
-
-                        if (!LoadScanlineLinear(trow[0], width, pSrc + (rowPitch * u3), rowPitch, src->format, filter))
-                            return E_FAIL;
-                    }
-
-                    for (size_t x = 0; x < nwidth; ++x)
-                    {
-                        auto const& toX = cfX[x];
-
-                        XMVECTOR C0, C1, C2, C3;
-                        CUBIC_INTERPOLATE(C0, toX.x, urow[0][toX.u0], urow[0][toX.u1], urow[0][toX.u2], urow[0][toX.u3]);
-                        CUBIC_INTERPOLATE(C1, toX.x, vrow[0][toX.u0], vrow[0][toX.u1], vrow[0][toX.u2], vrow[0][toX.u3]);
-                        CUBIC_INTERPOLATE(C2, toX.x, srow[0][toX.u0], srow[0][toX.u1], srow[0][toX.u2], srow[0][toX.u3]);
-                        CUBIC_INTERPOLATE(C3, toX.x, trow[0][toX.u0], trow[0][toX.u1], trow[0][toX.u2], trow[0][toX.u3]);
-
-                        CUBIC_INTERPOLATE(target[x], toY.x, C0, C1, C2, C3);
-                    }
-
-                    if (!StoreScanlineLinear(pDest, dest->rowPitch, dest->format, target, nwidth, filter))
-                        return E_FAIL;
-                    pDest += dest->rowPitch;
-                }
+                hr = Generate2DMipLevelCubicFilter(*src, *dest, filter, cfX, cfY, executor);
             }
 
+            if (FAILED(hr))
+                return hr;
+
             if (height > 1)
                 height >>= 1;
 
@@ -2831,6 +2671,18 @@ HRESULT DirectX::GenerateMipMaps(
     size_t levels,
     ScratchImage& mipChain,
     bool allow1D) noexcept
+{
+    return GenerateMipMaps(baseImage, filter, levels, TaskExecutor(), mipChain, allow1D);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps(
+    const Image& baseImage,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    const TaskExecutor& executor,
+    ScratchImage& mipChain,
+    bool allow1D) noexcept
 {
     if (!IsValid(baseImage.format))
         return E_INVALIDARG;
@@ -2965,7 +2817,7 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsBoxFilter(levels, filter, mipChain, 0);
+            hr = Generate2DMipsBoxFilter(levels, filter, mipChain, 0, executor);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -2975,7 +2827,7 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsPointFilter(levels, mipChain, 0);
+            hr = Generate2DMipsPointFilter(levels, mipChain, 0, executor);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -2985,7 +2837,7 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsLinearFilter(levels, filter, mipChain, 0);
+            hr = Generate2DMipsLinearFilter(levels, filter, mipChain, 0, executor);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -2995,7 +2847,7 @@ HRESULT DirectX::GenerateMipMaps(
             if (FAILED(hr))
                 return hr;
 
-            hr = Generate2DMipsCubicFilter(levels, filter, mipChain, 0);
+            hr = Generate2DMipsCubicFilter(levels, filter, mipChain, 0, executor);
             if (FAILED(hr))
                 mipChain.Release();
             return hr;
@@ -3024,6 +2876,19 @@ HRESULT DirectX::GenerateMipMaps(
     TEX_FILTER_FLAGS filter,
     size_t levels,
     ScratchImage& mipChain)
+{
+    return GenerateMipMaps(srcImages, nimages, metadata, filter, levels, TaskExecutor(), mipChain);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    const TaskExecutor& executor,
+    ScratchImage& mipChain)
 {
     if (!srcImages || !nimages || !IsValid(metadata.format))
         return E_INVALIDARG;
@@ -3182,7 +3047,7 @@ HRESULT DirectX::GenerateMipMaps(
 
             for (size_t item = 0; item < metadata.arraySize; ++item)
             {
-                hr = Generate2DMipsBoxFilter(levels, filter, mipChain, item);
+                hr = Generate2DMipsBoxFilter(levels, filter, mipChain, item, executor);
                 if (FAILED(hr))
                     mipChain.Release();
             }
@@ -3195,7 +3060,7 @@ HRESULT DirectX::GenerateMipMaps(
 
             for (size_t item = 0; item < metadata.arraySize; ++item)
             {
-                hr = Generate2DMipsPointFilter(levels, mipChain, item);
+                hr = Generate2DMipsPointFilter(levels, mipChain, item, executor);
                 if (FAILED(hr))
                     mipChain.Release();
             }
@@ -3208,7 +3073,7 @@ HRESULT DirectX::GenerateMipMaps(
 
             for (size_t item = 0; item < metadata.arraySize; ++item)
             {
-                hr = Generate2DMipsLinearFilter(levels, filter, mipChain, item);
+                hr = Generate2DMipsLinearFilter(levels, filter, mipChain, item, executor);
                 if (FAILED(hr))
                     mipChain.Release();
             }
@@ -3221,7 +3086,7 @@ HRESULT DirectX::GenerateMipMaps(
 
             for (size_t item = 0; item < metadata.arraySize; ++item)
             {
-                hr = Generate2DMipsCubicFilter(levels, filter, mipChain, item);
+                hr = Generate2DMipsCubicFilter(levels, filter, mipChain, item, executor);
                 if (FAILED(hr))
                     mipChain.Release();
             }
@@ -3257,6 +3122,18 @@ HRESULT DirectX::GenerateMipMaps3D(
     TEX_FILTER_FLAGS filter,
     size_t levels,
     ScratchImage& mipChain) noexcept
+{
+    return GenerateMipMaps3D(baseImages, depth, filter, levels, TaskExecutor(), mipChain);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps3D(
+    const Image* baseImages,
+    size_t depth,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    const TaskExecutor& executor,
+    ScratchImage& mipChain) noexcept
 {
     if (!baseImages || !depth)
         return E_INVALIDARG;
@@ -3310,7 +3187,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsBoxFilter(depth, levels, filter, mipChain);
+        hr = Generate3DMipsBoxFilter(depth, levels, filter, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3320,7 +3197,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsPointFilter(depth, levels, mipChain);
+        hr = Generate3DMipsPointFilter(depth, levels, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3330,7 +3207,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsLinearFilter(depth, levels, filter, mipChain);
+        hr = Generate3DMipsLinearFilter(depth, levels, filter, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3340,7 +3217,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsCubicFilter(depth, levels, filter, mipChain);
+        hr = Generate3DMipsCubicFilter(depth, levels, filter, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3368,6 +3245,19 @@ HRESULT DirectX::GenerateMipMaps3D(
     TEX_FILTER_FLAGS filter,
     size_t levels,
     ScratchImage& mipChain)
+{
+    return GenerateMipMaps3D(srcImages, nimages, metadata, filter, levels, TaskExecutor(), mipChain);
+}
+
+_Use_decl_annotations_
+HRESULT DirectX::GenerateMipMaps3D(
+    const Image* srcImages,
+    size_t nimages,
+    const TexMetadata& metadata,
+    TEX_FILTER_FLAGS filter,
+    size_t levels,
+    const TaskExecutor& executor,
+    ScratchImage& mipChain)
 {
     if (!srcImages || !nimages || !IsValid(metadata.format))
         return E_INVALIDARG;
@@ -3429,7 +3319,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsBoxFilter(metadata.depth, levels, filter, mipChain);
+        hr = Generate3DMipsBoxFilter(metadata.depth, levels, filter, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3439,7 +3329,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsPointFilter(metadata.depth, levels, mipChain);
+        hr = Generate3DMipsPointFilter(metadata.depth, levels, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3449,7 +3339,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsLinearFilter(metadata.depth, levels, filter, mipChain);
+        hr = Generate3DMipsLinearFilter(metadata.depth, levels, filter, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -3459,7 +3349,7 @@ HRESULT DirectX::GenerateMipMaps3D(
         if (FAILED(hr))
             return hr;
 
-        hr = Generate3DMipsCubicFilter(metadata.depth, levels, filter, mipChain);
+        hr = Generate3DMipsCubicFilter(metadata.depth, levels, filter, mipChain, executor);
         if (FAILED(hr))
             mipChain.Release();
         return hr;
@@ -141,6 +141,7 @@
 #endif
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
 #include <cstdlib>
@@ -445,6 +446,68 @@ namespace DirectX
         bool __cdecl CalculateMipLevels3D(_In_ size_t width, _In_ size_t height, _In_ size_t depth,
             _Inout_ size_t& mipLevels) noexcept;
 
+        //---------------------------------------------------------------------------------
+        // TaskExecutor helpers
+        constexpr size_t TASK_STRIP_PIXELS = 65536;
+
+        // Runs task(index) for each index below count, through the executor when there is one and more than one task.
+        // Each task returns an HRESULT, the first failure is returned and the tasks not yet started are skipped.
+        template<typename Task>
+        HRESULT ExecuteTasks(const TaskExecutor& executor, size_t count, Task&& task) noexcept
+        {
+            if (!executor || count <= 1)
+            {
+                for (size_t index = 0; index < count; ++index)
+                {
+                    const HRESULT hr = task(index);
+                    if (FAILED(hr))
+                        return hr;
+                }
+                return S_OK;
+            }
+
+            std::atomic<HRESULT> result(S_OK);
+            try
+            {
+                executor(count, [&](size_t index)
+                    {
+                        if (FAILED(result.load(std::memory_order_relaxed)))
+                            return;
+
+                        const HRESULT hr = task(index);
+                        if (FAILED(hr))
+                        {
+                            HRESULT expected = S_OK;
+                            result.compare_exchange_strong(expected, hr);
+                        }
+                    });
+            }
+            catch (...)
+            {
+                return E_FAIL;
+            }
+
+            return result.load();
+        }
+
+        // Splits height rows into strips of about TASK_STRIP_PIXELS pixels and runs task(y0, y1) on each,
+        // where y1 is one past the strip's last row.
+        template<typename RowTask>
+        HRESULT ExecuteRowStrips(const TaskExecutor& executor, size_t width, size_t height, RowTask&& task) noexcept
+        {
+            if (!executor)
+                return task(size_t(0), height);
+
+            const size_t stripRows = std::max<size_t>(1, TASK_STRIP_PIXELS / std::max<size_t>(1, width));
+            const size_t strips = (height + stripRows - 1) / stripRows;
+
+            return ExecuteTasks(executor, strips, [&](size_t strip) -> HRESULT
+                {
+                    const size_t y0 = strip * stripRows;
+                    return task(y0, std::min(height, y0 + stripRows));
+                });
+        }
+
     #ifdef _WIN32
         HRESULT __cdecl ResizeSeparateColorAndAlpha(_In_ IWICImagingFactory* pWIC,
             _In_ bool iswic2,
@@ -0,0 +1,211 @@
+#include "AssetDatabase/AssetDatabase.h"
+#include "SceneCooker/SceneCooker.h"
+#include "SceneCooker/TextureProcessing.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneReader.h"
+#include "Scene/SceneWriter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+	// Bump whenever a cooker's output changes for the same source and settings
+	constexpr uint32_t CookerVersion = 2;
+
+	void PrintUsage()
+	{
+		printf("Usage: AssetBuilder [options] <source directory> <output directory>\n");
+		printf("Options:\n");
+		printf("  --database FILE  Asset database, defaults to AssetDatabase.db in the output directory\n");
+		printf("  --threads N      Worker threads, defaults to one per hardware thread\n");
+		printf("  --list           Print every tracked asset after the build\n");
+		printf("  --no-compress    Store every scene asset raw\n");
+		printf("  --no-reorder     Keep the editor's entity order in scenes\n");
+		printf("  --no-bounds      Do not precompute mesh bounds\n");
+		printf("  --no-mips        Do not generate texture mips\n");
+		printf("  --pack-vertices  Quantize scene vertices to 20 bytes\n");
+		printf("  --no-spatial-index  Leave scene bounds and BVHs for the loader to build\n");
+	}
+
+	uint64_t HashSettings(std::initializer_list<uint32_t> values)
+	{
+		std::vector<uint32_t> settings = { CookerVersion };
+		settings.insert(settings.end(), values);
+		return BlackJawz::Scene::SceneAssets::HashBytes(reinterpret_cast<const uint8_t*>(settings.data()), settings.size() * sizeof(uint32_t));
+	}
+
+	bool CookTexture(BlackJawz::Tools::CookJob& job, bool generateMips)
+	{
+		BlackJawz::Scene::Blob source;
+		if (!BlackJawz::Scene::SceneReader::ReadFile(job.sourcePath, source))
+			return false;
+
+		BlackJawz::Scene::Blob cooked = generateMips ? BlackJawz::Tools::GenerateTextureMips(source) : BlackJawz::Scene::Blob();
+		const BlackJawz::Scene::Blob& output = cooked.Empty() ? source : cooked;
+		return BlackJawz::Scene::SceneWriter::WriteToFile(job.outputPath, output.data, output.size);
+	}
+
+	bool CookScene(BlackJawz::Tools::CookJob& job, const BlackJawz::Tools::AssetDatabase& database, const std::string& outputRoot,
+		BlackJawz::Jobs::JobSystem& jobSystem, const BlackJawz::Tools::CookOptions& options)
+	{
+		// Embedded textures that match a tracked texture are swapped for its cooked output. Matches from
+		// the last cook are kept by their embedded hash, so the scene follows the texture through edits.
+		auto resolveTexture = [&](uint64_t hash) -> BlackJawz::Scene::Blob
+			{
+				const BlackJawz::Tools::AssetRecord* texture = nullptr;
+				for (const auto& dependency : job.record->dependencies)
+				{
+					if (dependency.embeddedHash == hash)
+						texture = database.Find(dependency.guid);
+				}
+				if (!texture)
+					texture = database.FindBySourceHash(AssetDB::AssetType_Texture, hash);
+
+				BlackJawz::Scene::Blob cooked;
+				if (!texture || texture->cookedHash == 0 ||
+					!BlackJawz::Scene::SceneReader::ReadFile((std::filesystem::path(outputRoot) / texture->path).string(), cooked))
+					return BlackJawz::Scene::Blob();
+
+				bool known = std::any_of(job.dependencies.begin(), job.dependencies.end(),
+					[&](const BlackJawz::Tools::AssetDependency& dependency) { return dependency.guid == texture->guid && dependency.embeddedHash == hash; });
+				if (!known)
+					job.dependencies.push_back({ texture->guid, hash, texture->cookedHash });
+				return cooked;
+			};
+
+		// One cooker per job, scenes cook in parallel and each cooker loads one scene at a time
+		BlackJawz::Tools::SceneCooker cooker(jobSystem, options);
+		cooker.SetTextureResolver(resolveTexture);
+
+		BlackJawz::Tools::CookStats stats;
+		if (!cooker.Cook(job.sourcePath, job.outputPath, stats))
+		{
+			fprintf(stderr, "%s\n", cooker.GetLastError().c_str());
+			return false;
+		}
+
+		job.contentHashes = std::move(stats.textureHashes);
+		return true;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BlackJawz::Tools::CookOptions options;
+	uint32_t threadCount = 0;
+	std::string databasePath;
+	bool listAssets = false;
+	std::vector<std::string> directories;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "--database") == 0 && i + 1 < argc)
+		{
+			databasePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--list") == 0)
+		{
+			listAssets = true;
+		}
+		else if (strcmp(argv[i], "--no-compress") == 0)
+		{
+			options.compressAssets = false;
+		}
+		else if (strcmp(argv[i], "--no-reorder") == 0)
+		{
+			options.reorderEntities = false;
+		}
+		else if (strcmp(argv[i], "--no-bounds") == 0)
+		{
+			options.computeBounds = false;
+		}
+		else if (strcmp(argv[i], "--no-mips") == 0)
+		{
+			options.generateMips = false;
+		}
+		else if (strcmp(argv[i], "--pack-vertices") == 0)
+		{
+			options.packVertices = true;
+		}
+		else if (strcmp(argv[i], "--no-spatial-index") == 0)
+		{
+			options.buildSpatialIndex = false;
+		}
+		else if (argv[i][0] == '-')
+		{
+			PrintUsage();
+			return 2;
+		}
+		else
+		{
+			directories.push_back(argv[i]);
+		}
+	}
+
+	if (directories.size() != 2)
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	const std::string& sourceRoot = directories[0];
+	const std::string& outputRoot = directories[1];
+	if (databasePath.empty())
+	{
+		databasePath = (std::filesystem::path(outputRoot) / "AssetDatabase.db").string();
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(outputRoot, error);
+
+	BlackJawz::Tools::AssetDatabase database;
+	if (!database.Load(databasePath))
+	{
+		fprintf(stderr, "Asset database %s is unreadable, rebuilding it\n", databasePath.c_str());
+	}
+
+	// The calling thread helps while waiting, so it counts as a worker
+	BlackJawz::Jobs::JobSystem jobSystem(threadCount > 1 ? threadCount - 1 : threadCount);
+
+	bool generateMips = options.generateMips && BlackJawz::Tools::HasTextureProcessing();
+	database.SetCooker(AssetDB::AssetType_Texture, HashSettings({ generateMips }),
+		[generateMips](BlackJawz::Tools::CookJob& job) { return CookTexture(job, generateMips); });
+
+	database.SetCooker(AssetDB::AssetType_Scene,
+		HashSettings({ options.compressAssets, options.reorderEntities, options.computeBounds, generateMips, options.packVertices, options.buildSpatialIndex }),
+		[&](BlackJawz::Tools::CookJob& job) { return CookScene(job, database, outputRoot, jobSystem, options); });
+
+	BlackJawz::Tools::ScanStats scanStats = database.Scan(sourceRoot, jobSystem);
+	printf("Scanned %zu sources in %.1f ms: %zu hashed, %zu added, %zu changed, %zu renamed, %zu removed\n",
+		scanStats.fileCount, scanStats.ms, scanStats.hashedCount, scanStats.addedCount, scanStats.changedCount,
+		scanStats.renamedCount, scanStats.removedCount);
+
+	BlackJawz::Tools::BuildStats buildStats = database.Build(outputRoot, jobSystem);
+	printf("Built in %.1f ms: %zu cooked, %zu up to date, %zu failed, %zu stale outputs removed\n",
+		buildStats.ms, buildStats.cookedCount, buildStats.upToDateCount, buildStats.failedCount, buildStats.removedOutputs);
+
+	if (listAssets)
+	{
+		for (const auto& record : database.GetRecords())
+		{
+			printf("%s %-7s %s (%zu dependencies)\n", record.guid.ToString().c_str(), AssetDB::EnumNameAssetType(record.type),
+				record.path.c_str(), record.dependencies.size());
+		}
+	}
+
+	if (!database.Save(databasePath))
+	{
+		fprintf(stderr, "Failed to write %s\n", databasePath.c_str());
+		return 1;
+	}
+
+	return buildStats.failedCount > 0 ? 1 : 0;
+}
@@ -0,0 +1,592 @@
+#include "AssetDatabase.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneJournal.h"
+#include "Scene/SceneReader.h"
+#include "Scene/SceneWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace
+{
+	double ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	struct SourceFile
+	{
+		std::string path;
+		BlackJawz::Tools::AssetType type = AssetDB::AssetType_Texture;
+		uint64_t size = 0;
+		int64_t time = 0;
+		uint64_t hash = 0;
+		bool hashed = false;
+	};
+
+	// Scenes are stored with their journal, so both count towards the source
+	bool StatSource(const std::filesystem::path& path, BlackJawz::Tools::AssetType type, uint64_t& size, int64_t& time)
+	{
+		std::error_code error;
+		size = std::filesystem::file_size(path, error);
+		if (error)
+			return false;
+		time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+		if (error)
+			return false;
+
+		if (type == AssetDB::AssetType_Scene)
+		{
+			std::filesystem::path journal = BlackJawz::Scene::SceneJournal::GetJournalPath(path.string());
+			uint64_t journalSize = std::filesystem::file_size(journal, error);
+			if (!error)
+			{
+				size += journalSize;
+				time = std::max(time, static_cast<int64_t>(std::filesystem::last_write_time(journal, error).time_since_epoch().count()));
+			}
+		}
+		return true;
+	}
+
+	bool HashSource(const std::filesystem::path& path, BlackJawz::Tools::AssetType type, uint64_t& hash)
+	{
+		BlackJawz::Scene::Blob data;
+		if (!BlackJawz::Scene::SceneReader::ReadFile(path.string(), data))
+			return false;
+
+		hash = BlackJawz::Scene::SceneAssets::HashBytes(data.data, data.size);
+
+		BlackJawz::Scene::Blob journal;
+		if (type == AssetDB::AssetType_Scene && BlackJawz::Scene::SceneReader::ReadFile(BlackJawz::Scene::SceneJournal::GetJournalPath(path.string()), journal))
+		{
+			hash ^= BlackJawz::Scene::SceneAssets::HashBytes(journal.data, journal.size) * 0x9E3779B97F4A7C15ull;
+		}
+		return true;
+	}
+}
+
+std::string BlackJawz::Tools::AssetGuid::ToString() const
+{
+	char text[40];
+	snprintf(text, sizeof(text), "%08x-%04x-%04x-%04x-%012llx",
+		static_cast<uint32_t>(high >> 32), static_cast<uint32_t>((high >> 16) & 0xFFFF), static_cast<uint32_t>(high & 0xFFFF),
+		static_cast<uint32_t>(low >> 48), static_cast<unsigned long long>(low & 0xFFFFFFFFFFFFull));
+	return text;
+}
+
+BlackJawz::Tools::AssetGuid BlackJawz::Tools::AssetGuid::Generate()
+{
+	std::random_device device;
+	AssetGuid guid;
+	guid.high = (static_cast<uint64_t>(device()) << 32) | device();
+	guid.low = (static_cast<uint64_t>(device()) << 32) | device();
+	return guid;
+}
+
+bool BlackJawz::Tools::AssetDatabase::GetAssetType(const std::filesystem::path& path, AssetType& type)
+{
+	std::string extension = path.extension().string();
+	std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+	if (extension == ".dds")
+	{
+		type = AssetDB::AssetType_Texture;
+		return true;
+	}
+	if (extension == ".bin")
+	{
+		type = AssetDB::AssetType_Scene;
+		return true;
+	}
+	return false;
+}
+
+bool BlackJawz::Tools::AssetDatabase::Load(const std::string& filename)
+{
+	records.clear();
+	staleOutputs.clear();
+
+	Scene::Blob fileData;
+	if (!std::filesystem::exists(filename))
+	{
+		RebuildIndices();
+		return true;
+	}
+	if (!Scene::SceneReader::ReadFile(filename, fileData))
+		return false;
+
+	flatbuffers::Verifier verifier(fileData.data, fileData.size);
+	if (!AssetDB::VerifyDatabaseBuffer(verifier))
+		return false;
+
+	const AssetDB::Database* database = AssetDB::GetDatabase(fileData.data);
+	bool sameVersion = database->version() == Version;
+
+	if (database->records())
+	{
+		records.reserve(database->records()->size());
+		for (const AssetDB::Record* fileRecord : *database->records())
+		{
+			if (!fileRecord->guid() || !fileRecord->path())
+				continue;
+
+			AssetRecord& record = records.emplace_back();
+			record.guid = { fileRecord->guid()->high(), fileRecord->guid()->low() };
+			record.path = fileRecord->path()->str();
+			record.type = fileRecord->type();
+			record.fileSize = fileRecord->file_size();
+			record.fileTime = fileRecord->file_time();
+			record.sourceHash = fileRecord->source_hash();
+
+			if (!sameVersion)
+				continue;
+
+			record.cookedSourceHash = fileRecord->cooked_source_hash();
+			record.cookedSettingsHash = fileRecord->cooked_settings_hash();
+			record.cookedHash = fileRecord->cooked_hash();
+			record.cookedSize = fileRecord->cooked_size();
+
+			if (fileRecord->content_hashes())
+			{
+				record.contentHashes.assign(fileRecord->content_hashes()->begin(), fileRecord->content_hashes()->end());
+			}
+			if (fileRecord->dependencies())
+			{
+				for (const AssetDB::Dependency* fileDependency : *fileRecord->dependencies())
+				{
+					AssetDependency& dependency = record.dependencies.emplace_back();
+					dependency.guid = { fileDependency->guid().high(), fileDependency->guid().low() };
+					dependency.embeddedHash = fileDependency->embedded_hash();
+					dependency.cookedHash = fileDependency->cooked_hash();
+				}
+			}
+		}
+	}
+
+	RebuildIndices();
+	return true;
+}
+
+bool BlackJawz::Tools::AssetDatabase::Save(const std::string& filename) const
+{
+	flatbuffers::FlatBufferBuilder builder(64 * 1024);
+
+	std::vector<flatbuffers::Offset<AssetDB::Record>> recordOffsets;
+	recordOffsets.reserve(records.size());
+
+	for (const AssetRecord& record : records)
+	{
+		AssetDB::Guid guid(record.guid.high, record.guid.low);
+		auto pathOffset = builder.CreateString(record.path);
+		auto contentHashesOffset = builder.CreateVector(record.contentHashes);
+
+		std::vector<AssetDB::Dependency> dependencies;
+		dependencies.reserve(record.dependencies.size());
+		for (const AssetDependency& dependency : record.dependencies)
+		{
+			dependencies.emplace_back(AssetDB::Guid(dependency.guid.high, dependency.guid.low), dependency.embeddedHash, dependency.cookedHash);
+		}
+		auto dependenciesOffset = builder.CreateVectorOfStructs(dependencies);
+
+		recordOffsets.push_back(AssetDB::CreateRecord(builder,
+			&guid,
+			pathOffset,
+			record.type,
+			record.fileSize,
+			record.fileTime,
+			record.sourceHash,
+			record.cookedSourceHash,
+			record.cookedSettingsHash,
+			record.cookedHash,
+			record.cookedSize,
+			contentHashesOffset,
+			dependenciesOffset));
+	}
+
+	auto recordsVector = builder.CreateVector(recordOffsets);
+	builder.Finish(AssetDB::CreateDatabase(builder, Version, recordsVector));
+
+	return Scene::SceneWriter::WriteToFile(filename, builder.GetBufferPointer(), builder.GetSize());
+}
+
+BlackJawz::Tools::ScanStats BlackJawz::Tools::AssetDatabase::Scan(const std::string& sourceRoot, Jobs::JobSystem& jobSystem)
+{
+	auto start = std::chrono::steady_clock::now();
+	ScanStats stats;
+	this->sourceRoot = sourceRoot;
+
+	std::vector<SourceFile> files;
+	std::error_code error;
+	for (auto it = std::filesystem::recursive_directory_iterator(sourceRoot, error); !error && it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+	{
+		AssetType type;
+		if (!it->is_regular_file() || !GetAssetType(it->path(), type))
+			continue;
+
+		SourceFile& file = files.emplace_back();
+		file.path = std::filesystem::relative(it->path(), sourceRoot).generic_string();
+		file.type = type;
+		if (!StatSource(it->path(), type, file.size, file.time))
+		{
+			files.pop_back();
+		}
+	}
+	stats.fileCount = files.size();
+
+	std::unordered_map<std::string, size_t> pathIndices;
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		pathIndices.emplace(records[i].path, i);
+	}
+
+	// Unchanged size and write time means unchanged contents, everything else is hashed
+	std::vector<size_t> toHash;
+	std::vector<bool> seen(records.size(), false);
+	std::vector<size_t> fileRecords(files.size(), SIZE_MAX);
+	for (size_t i = 0; i < files.size(); ++i)
+	{
+		auto it = pathIndices.find(files[i].path);
+		if (it != pathIndices.end() && records[it->second].type == files[i].type)
+		{
+			fileRecords[i] = it->second;
+			seen[it->second] = true;
+
+			const AssetRecord& record = records[it->second];
+			if (record.fileSize == files[i].size && record.fileTime == files[i].time)
+				continue;
+		}
+		toHash.push_back(i);
+	}
+
+	Jobs::JobCounter hashCounter;
+	jobSystem.Dispatch(hashCounter, static_cast<uint32_t>(toHash.size()), 1, [&](uint32_t index)
+		{
+			SourceFile& file = files[toHash[index]];
+			file.hashed = HashSource(std::filesystem::path(sourceRoot) / file.path, file.type, file.hash);
+		});
+	jobSystem.Wait(hashCounter);
+	stats.hashedCount = toHash.size();
+
+	// Sources that vanished, a new file with the same contents is taken to be one of them renamed
+	std::unordered_multimap<uint64_t, size_t> removedByHash;
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		if (!seen[i])
+			removedByHash.emplace(records[i].sourceHash, i);
+	}
+
+	std::vector<AssetRecord> added;
+	for (size_t index : toHash)
+	{
+		const SourceFile& file = files[index];
+		if (!file.hashed)
+			continue;
+
+		if (fileRecords[index] != SIZE_MAX)
+		{
+			AssetRecord& record = records[fileRecords[index]];
+			if (record.sourceHash != file.hash)
+				++stats.changedCount;
+
+			record.fileSize = file.size;
+			record.fileTime = file.time;
+			record.sourceHash = file.hash;
+			continue;
+		}
+
+		auto renamed = removedByHash.end();
+		auto range = removedByHash.equal_range(file.hash);
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (records[it->second].type == file.type)
+			{
+				renamed = it;
+				break;
+			}
+		}
+
+		if (renamed != removedByHash.end())
+		{
+			// Keeps the GUID and cook state, the output is cooked again under the new path
+			AssetRecord& record = records[renamed->second];
+			staleOutputs.push_back(record.path);
+			record.path = file.path;
+			record.fileSize = file.size;
+			record.fileTime = file.time;
+			seen[renamed->second] = true;
+			removedByHash.erase(renamed);
+			++stats.renamedCount;
+			continue;
+		}
+
+		AssetRecord& record = added.emplace_back();
+		record.guid = AssetGuid::Generate();
+		record.path = file.path;
+		record.type = file.type;
+		record.fileSize = file.size;
+		record.fileTime = file.time;
+		record.sourceHash = file.hash;
+		++stats.addedCount;
+	}
+
+	size_t kept = 0;
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		if (!seen[i])
+		{
+			staleOutputs.push_back(records[i].path);
+			++stats.removedCount;
+			continue;
+		}
+		if (kept != i)
+			records[kept] = std::move(records[i]);
+		++kept;
+	}
+	records.resize(kept);
+
+	for (auto& record : added)
+	{
+		records.push_back(std::move(record));
+	}
+
+	// Sorted so the saved database only changes where the sources did
+	std::sort(records.begin(), records.end(), [](const AssetRecord& a, const AssetRecord& b) { return a.path < b.path; });
+	RebuildIndices();
+
+	stats.ms = ElapsedMs(start);
+	return stats;
+}
+
+void BlackJawz::Tools::AssetDatabase::SetCooker(AssetType type, uint64_t settingsHash, CookFunc cook)
+{
+	Cooker& cooker = cookers[static_cast<size_t>(type)];
+	cooker.settingsHash = settingsHash;
+	cooker.cook = std::move(cook);
+}
+
+const BlackJawz::Tools::AssetRecord* BlackJawz::Tools::AssetDatabase::Find(const AssetGuid& guid) const
+{
+	auto it = guidIndices.find(guid);
+	return it != guidIndices.end() ? &records[it->second] : nullptr;
+}
+
+const BlackJawz::Tools::AssetRecord* BlackJawz::Tools::AssetDatabase::FindBySourceHash(AssetType type, uint64_t sourceHash) const
+{
+	auto it = sourceHashIndices.find(sourceHash);
+	if (it == sourceHashIndices.end())
+		return nullptr;
+
+	for (size_t index : it->second)
+	{
+		if (records[index].type == type)
+			return &records[index];
+	}
+	return nullptr;
+}
+
+void BlackJawz::Tools::AssetDatabase::RebuildIndices()
+{
+	guidIndices.clear();
+	sourceHashIndices.clear();
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		guidIndices.emplace(records[i].guid, i);
+		sourceHashIndices[records[i].sourceHash].push_back(i);
+	}
+}
+
+bool BlackJawz::Tools::AssetDatabase::IsDirty(const AssetRecord& record, const std::string& outputRoot) const
+{
+	const Cooker& cooker = cookers[static_cast<size_t>(record.type)];
+
+	if (record.cookedHash == 0 || record.cookedSourceHash != record.sourceHash || record.cookedSettingsHash != cooker.settingsHash)
+		return true;
+
+	// Outputs deleted or edited by hand are cooked again
+	std::error_code error;
+	uint64_t outputSize = std::filesystem::file_size(std::filesystem::path(outputRoot) / record.path, error);
+	if (error || outputSize != record.cookedSize)
+		return true;
+
+	for (const AssetDependency& dependency : record.dependencies)
+	{
+		const AssetRecord* dependencyRecord = Find(dependency.guid);
+		if (!dependencyRecord || dependencyRecord->cookedHash != dependency.cookedHash)
+			return true;
+	}
+
+	// A texture added since the last cook may now match one the scene embeds
+	for (uint64_t contentHash : record.contentHashes)
+	{
+		const AssetRecord* match = FindBySourceHash(AssetDB::AssetType_Texture, contentHash);
+		if (!match)
+			continue;
+
+		bool known = std::any_of(record.dependencies.begin(), record.dependencies.end(),
+			[match](const AssetDependency& dependency) { return dependency.guid == match->guid; });
+		if (!known)
+			return true;
+	}
+
+	return false;
+}
+
+std::vector<size_t> BlackJawz::Tools::AssetDatabase::GetWaitList(const AssetRecord& record) const
+{
+	std::vector<size_t> waitList;
+	if (record.type != AssetDB::AssetType_Scene)
+		return waitList;
+
+	// Which textures a scene embeds is only known once it has been cooked, until then it waits on all of them
+	bool cookedBefore = record.cookedHash != 0;
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		const AssetRecord& other = records[i];
+		if (other.type != AssetDB::AssetType_Texture)
+			continue;
+
+		bool embedded = std::find(record.contentHashes.begin(), record.contentHashes.end(), other.sourceHash) != record.contentHashes.end();
+		bool dependency = std::any_of(record.dependencies.begin(), record.dependencies.end(),
+			[&other](const AssetDependency& dependency) { return dependency.guid == other.guid; });
+
+		if (!cookedBefore || embedded || dependency)
+			waitList.push_back(i);
+	}
+	return waitList;
+}
+
+bool BlackJawz::Tools::AssetDatabase::CookRecord(AssetRecord& record, const std::string& outputRoot)
+{
+	const Cooker& cooker = cookers[static_cast<size_t>(record.type)];
+
+	CookJob job;
+	job.record = &record;
+	job.sourcePath = (std::filesystem::path(sourceRoot) / record.path).string();
+	job.outputPath = (std::filesystem::path(outputRoot) / record.path).string();
+
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(job.outputPath).parent_path(), error);
+
+	Scene::Blob output;
+	if (!cooker.cook(job) || !Scene::SceneReader::ReadFile(job.outputPath, output))
+	{
+		// Tried again by the next build
+		record.cookedHash = 0;
+		return false;
+	}
+
+	record.cookedSourceHash = record.sourceHash;
+	record.cookedSettingsHash = cooker.settingsHash;
+	record.cookedHash = std::max<uint64_t>(Scene::SceneAssets::HashBytes(output.data, output.size), 1);
+	record.cookedSize = output.size;
+	record.contentHashes = std::move(job.contentHashes);
+	record.dependencies = std::move(job.dependencies);
+	return true;
+}
+
+BlackJawz::Tools::BuildStats BlackJawz::Tools::AssetDatabase::Build(const std::string& outputRoot, Jobs::JobSystem& jobSystem)
+{
+	auto start = std::chrono::steady_clock::now();
+	BuildStats stats;
+
+	for (const std::string& path : staleOutputs)
+	{
+		std::error_code error;
+		if (std::filesystem::remove(std::filesystem::path(outputRoot) / path, error))
+			++stats.removedOutputs;
+	}
+	staleOutputs.clear();
+
+	size_t count = records.size();
+	std::vector<std::vector<size_t>> waitLists(count);
+	std::vector<bool> dirty(count, false);
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!cookers[static_cast<size_t>(records[i].type)].cook)
+			continue;
+
+		waitLists[i] = GetWaitList(records[i]);
+		dirty[i] = IsDirty(records[i], outputRoot);
+	}
+
+	// Anything waiting on a dirty asset may take a different output from it
+	for (bool changed = true; changed;)
+	{
+		changed = false;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (dirty[i] || !cookers[static_cast<size_t>(records[i].type)].cook)
+				continue;
+
+			if (std::any_of(waitLists[i].begin(), waitLists[i].end(), [&dirty](size_t other) { return dirty[other]; }))
+			{
+				dirty[i] = true;
+				changed = true;
+			}
+		}
+	}
+
+	// Each dirty asset counts the dirty assets it waits on and is queued once the count reaches zero
+	auto pending = std::make_unique<std::atomic<uint32_t>[]>(count);
+	std::vector<std::vector<size_t>> dependents(count);
+	std::vector<size_t> ready;
+	size_t dirtyCount = 0;
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!dirty[i])
+		{
+			if (cookers[static_cast<size_t>(records[i].type)].cook)
+				++stats.upToDateCount;
+			continue;
+		}
+
+		++dirtyCount;
+		uint32_t waitCount = 0;
+		for (size_t other : waitLists[i])
+		{
+			if (dirty[other])
+			{
+				dependents[other].push_back(i);
+				++waitCount;
+			}
+		}
+
+		pending[i].store(waitCount, std::memory_order_relaxed);
+		if (waitCount == 0)
+			ready.push_back(i);
+	}
+
+	std::atomic<size_t> cookedCount{ 0 };
+	std::atomic<size_t> failedCount{ 0 };
+	Jobs::JobCounter buildCounter;
+
+	std::function<void(size_t)> cookJob = [&](size_t index)
+		{
+			if (CookRecord(records[index], outputRoot))
+				cookedCount.fetch_add(1, std::memory_order_relaxed);
+			else
+				failedCount.fetch_add(1, std::memory_order_relaxed);
+
+			// Dependents are queued before this job finishes, so the counter cannot reach zero early
+			for (size_t dependent : dependents[index])
+			{
+				if (pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+					jobSystem.Execute(buildCounter, [&cookJob, dependent]() { cookJob(dependent); });
+			}
+		};
+
+	for (size_t index : ready)
+	{
+		jobSystem.Execute(buildCounter, [&cookJob, index]() { cookJob(index); });
+	}
+	jobSystem.Wait(buildCounter);
+
+	stats.cookedCount = cookedCount.load();
+	// Anything that never ran was stuck in a dependency cycle
+	stats.failedCount = failedCount.load() + (dirtyCount - stats.cookedCount - failedCount.load());
+
+	RebuildIndices();
+	stats.ms = ElapsedMs(start);
+	return stats;
+}
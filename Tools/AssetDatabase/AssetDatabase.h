@@ -0,0 +1,154 @@
+#pragma once
+#include "Util/JobSystem.h"
+
+#include <array>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <flatbuffers/flatbuffers.h>
+#include "AssetDatabase_generated.h"
+
+namespace BlackJawz::Tools
+{
+	// Stable identity of a source file, kept across content changes and renames
+	struct AssetGuid
+	{
+		uint64_t high = 0;
+		uint64_t low = 0;
+
+		bool IsValid() const { return high != 0 || low != 0; }
+		bool operator==(const AssetGuid& other) const { return high == other.high && low == other.low; }
+
+		std::string ToString() const;
+		static AssetGuid Generate();
+	};
+
+	struct AssetGuidHash
+	{
+		size_t operator()(const AssetGuid& guid) const { return static_cast<size_t>(guid.high ^ (guid.low * 0x9E3779B97F4A7C15ull)); }
+	};
+
+	using AssetType = AssetDB::AssetType;
+
+	// Another asset whose cooked output went into this one, see AssetDB::Dependency
+	struct AssetDependency
+	{
+		AssetGuid guid;
+		uint64_t embeddedHash = 0;
+		uint64_t cookedHash = 0;
+	};
+
+	struct AssetRecord
+	{
+		AssetGuid guid;
+		std::string path; // Relative to the source root, '/' separated
+		AssetType type = AssetDB::AssetType_Texture;
+
+		// Scenes include their journal in the size, write time and hash
+		uint64_t fileSize = 0;
+		int64_t fileTime = 0;
+		uint64_t sourceHash = 0;
+
+		// State of the last successful cook, cookedHash is 0 when it has never succeeded
+		uint64_t cookedSourceHash = 0;
+		uint64_t cookedSettingsHash = 0;
+		uint64_t cookedHash = 0;
+		uint64_t cookedSize = 0;
+
+		std::vector<uint64_t> contentHashes;
+		std::vector<AssetDependency> dependencies;
+	};
+
+	// Handed to a cook function, which writes outputPath and reports what it found in the source
+	struct CookJob
+	{
+		const AssetRecord* record = nullptr;
+		std::string sourcePath;
+		std::string outputPath;
+
+		std::vector<uint64_t> contentHashes;
+		std::vector<AssetDependency> dependencies;
+	};
+
+	struct ScanStats
+	{
+		size_t fileCount = 0;
+		size_t hashedCount = 0; // Files whose size or write time changed
+		size_t addedCount = 0;
+		size_t changedCount = 0;
+		size_t renamedCount = 0;
+		size_t removedCount = 0;
+		double ms = 0.0;
+	};
+
+	struct BuildStats
+	{
+		size_t upToDateCount = 0;
+		size_t cookedCount = 0;
+		size_t failedCount = 0;
+		size_t removedOutputs = 0;
+		double ms = 0.0;
+	};
+
+	// Tracks the source assets under one root and what was cooked from them, so a build only
+	// recooks assets whose source, import settings or dependencies changed since the last one.
+	class AssetDatabase
+	{
+	public:
+		// Databases from another version keep their GUIDs but recook everything
+		static constexpr uint32_t Version = 1;
+
+		using CookFunc = std::function<bool(CookJob& job)>;
+
+		// A missing file leaves the database empty, only an unreadable one fails
+		bool Load(const std::string& filename);
+		bool Save(const std::string& filename) const;
+
+		// Pick up added, changed, renamed and removed sources. Only files whose size or write
+		// time changed are hashed, on the job system.
+		ScanStats Scan(const std::string& sourceRoot, Jobs::JobSystem& jobSystem);
+
+		// settingsHash covers the import settings, changing it recooks every asset of the type.
+		// Types without a cooker are tracked but never cooked.
+		void SetCooker(AssetType type, uint64_t settingsHash, CookFunc cook);
+
+		// Recook what changed into outputRoot, which mirrors the source layout. Assets cook in
+		// parallel, each one after the dependencies it waits on.
+		BuildStats Build(const std::string& outputRoot, Jobs::JobSystem& jobSystem);
+
+		const AssetRecord* Find(const AssetGuid& guid) const;
+		const AssetRecord* FindBySourceHash(AssetType type, uint64_t sourceHash) const;
+		const std::vector<AssetRecord>& GetRecords() const { return records; }
+
+		// Type of a source file by its extension, false for files the database does not track
+		static bool GetAssetType(const std::filesystem::path& path, AssetType& type);
+
+	private:
+		struct Cooker
+		{
+			uint64_t settingsHash = 0;
+			CookFunc cook;
+		};
+
+		bool IsDirty(const AssetRecord& record, const std::string& outputRoot) const;
+
+		// Records this one has to cook after, dirty or not
+		std::vector<size_t> GetWaitList(const AssetRecord& record) const;
+
+		bool CookRecord(AssetRecord& record, const std::string& outputRoot);
+		void RebuildIndices();
+
+		std::vector<AssetRecord> records;
+		std::array<Cooker, AssetDB::AssetType_MAX + 1> cookers;
+		std::string sourceRoot;
+
+		// Outputs left behind by removed or renamed sources, deleted by the next build
+		std::vector<std::string> staleOutputs;
+
+		std::unordered_map<AssetGuid, size_t, AssetGuidHash> guidIndices;
+		std::unordered_map<uint64_t, std::vector<size_t>> sourceHashIndices;
+	};
+}
@@ -0,0 +1,393 @@
+// automatically generated by the FlatBuffers compiler, do not modify
+
+
+#ifndef FLATBUFFERS_GENERATED_ASSETDATABASE_ASSETDB_H_
+#define FLATBUFFERS_GENERATED_ASSETDATABASE_ASSETDB_H_
+
+#include "flatbuffers/flatbuffers.h"
+
+// Ensure the included flatbuffers.h is the same version as when this file was
+// generated, otherwise it may not be compatible.
+static_assert(FLATBUFFERS_VERSION_MAJOR == 24 &&
+              FLATBUFFERS_VERSION_MINOR == 12 &&
+              FLATBUFFERS_VERSION_REVISION == 23,
+             "Non-compatible flatbuffers version included");
+
+namespace AssetDB {
+
+struct Guid;
+
+struct Dependency;
+
+struct Record;
+struct RecordBuilder;
+
+struct Database;
+struct DatabaseBuilder;
+
+enum AssetType : uint8_t {
+  AssetType_Texture = 0,
+  AssetType_Scene = 1,
+  AssetType_MIN = AssetType_Texture,
+  AssetType_MAX = AssetType_Scene
+};
+
+inline const AssetType (&EnumValuesAssetType())[2] {
+  static const AssetType values[] = {
+    AssetType_Texture,
+    AssetType_Scene
+  };
+  return values;
+}
+
+inline const char * const *EnumNamesAssetType() {
+  static const char * const names[3] = {
+    "Texture",
+    "Scene",
+    nullptr
+  };
+  return names;
+}
+
+inline const char *EnumNameAssetType(AssetType e) {
+  if (::flatbuffers::IsOutRange(e, AssetType_Texture, AssetType_Scene)) return "";
+  const size_t index = static_cast<size_t>(e);
+  return EnumNamesAssetType()[index];
+}
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) Guid FLATBUFFERS_FINAL_CLASS {
+ private:
+  uint64_t high_;
+  uint64_t low_;
+
+ public:
+  Guid()
+      : high_(0),
+        low_(0) {
+  }
+  Guid(uint64_t _high, uint64_t _low)
+      : high_(::flatbuffers::EndianScalar(_high)),
+        low_(::flatbuffers::EndianScalar(_low)) {
+  }
+  uint64_t high() const {
+    return ::flatbuffers::EndianScalar(high_);
+  }
+  uint64_t low() const {
+    return ::flatbuffers::EndianScalar(low_);
+  }
+};
+FLATBUFFERS_STRUCT_END(Guid, 16);
+
+FLATBUFFERS_MANUALLY_ALIGNED_STRUCT(8) Dependency FLATBUFFERS_FINAL_CLASS {
+ private:
+  AssetDB::Guid guid_;
+  uint64_t embedded_hash_;
+  uint64_t cooked_hash_;
+
+ public:
+  Dependency()
+      : guid_(),
+        embedded_hash_(0),
+        cooked_hash_(0) {
+  }
+  Dependency(const AssetDB::Guid &_guid, uint64_t _embedded_hash, uint64_t _cooked_hash)
+      : guid_(_guid),
+        embedded_hash_(::flatbuffers::EndianScalar(_embedded_hash)),
+        cooked_hash_(::flatbuffers::EndianScalar(_cooked_hash)) {
+  }
+  const AssetDB::Guid &guid() const {
+    return guid_;
+  }
+  uint64_t embedded_hash() const {
+    return ::flatbuffers::EndianScalar(embedded_hash_);
+  }
+  uint64_t cooked_hash() const {
+    return ::flatbuffers::EndianScalar(cooked_hash_);
+  }
+};
+FLATBUFFERS_STRUCT_END(Dependency, 32);
+
+struct Record FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef RecordBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_GUID = 4,
+    VT_PATH = 6,
+    VT_TYPE = 8,
+    VT_FILE_SIZE = 10,
+    VT_FILE_TIME = 12,
+    VT_SOURCE_HASH = 14,
+    VT_COOKED_SOURCE_HASH = 16,
+    VT_COOKED_SETTINGS_HASH = 18,
+    VT_COOKED_HASH = 20,
+    VT_COOKED_SIZE = 22,
+    VT_CONTENT_HASHES = 24,
+    VT_DEPENDENCIES = 26
+  };
+  const AssetDB::Guid *guid() const {
+    return GetStruct<const AssetDB::Guid *>(VT_GUID);
+  }
+  const ::flatbuffers::String *path() const {
+    return GetPointer<const ::flatbuffers::String *>(VT_PATH);
+  }
+  AssetDB::AssetType type() const {
+    return static_cast<AssetDB::AssetType>(GetField<uint8_t>(VT_TYPE, 0));
+  }
+  uint64_t file_size() const {
+    return GetField<uint64_t>(VT_FILE_SIZE, 0);
+  }
+  int64_t file_time() const {
+    return GetField<int64_t>(VT_FILE_TIME, 0);
+  }
+  uint64_t source_hash() const {
+    return GetField<uint64_t>(VT_SOURCE_HASH, 0);
+  }
+  uint64_t cooked_source_hash() const {
+    return GetField<uint64_t>(VT_COOKED_SOURCE_HASH, 0);
+  }
+  uint64_t cooked_settings_hash() const {
+    return GetField<uint64_t>(VT_COOKED_SETTINGS_HASH, 0);
+  }
+  uint64_t cooked_hash() const {
+    return GetField<uint64_t>(VT_COOKED_HASH, 0);
+  }
+  uint64_t cooked_size() const {
+    return GetField<uint64_t>(VT_COOKED_SIZE, 0);
+  }
+  const ::flatbuffers::Vector<uint64_t> *content_hashes() const {
+    return GetPointer<const ::flatbuffers::Vector<uint64_t> *>(VT_CONTENT_HASHES);
+  }
+  const ::flatbuffers::Vector<const AssetDB::Dependency *> *dependencies() const {
+    return GetPointer<const ::flatbuffers::Vector<const AssetDB::Dependency *> *>(VT_DEPENDENCIES);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<AssetDB::Guid>(verifier, VT_GUID, 8) &&
+           VerifyOffset(verifier, VT_PATH) &&
+           verifier.VerifyString(path()) &&
+           VerifyField<uint8_t>(verifier, VT_TYPE, 1) &&
+           VerifyField<uint64_t>(verifier, VT_FILE_SIZE, 8) &&
+           VerifyField<int64_t>(verifier, VT_FILE_TIME, 8) &&
+           VerifyField<uint64_t>(verifier, VT_SOURCE_HASH, 8) &&
+           VerifyField<uint64_t>(verifier, VT_COOKED_SOURCE_HASH, 8) &&
+           VerifyField<uint64_t>(verifier, VT_COOKED_SETTINGS_HASH, 8) &&
+           VerifyField<uint64_t>(verifier, VT_COOKED_HASH, 8) &&
+           VerifyField<uint64_t>(verifier, VT_COOKED_SIZE, 8) &&
+           VerifyOffset(verifier, VT_CONTENT_HASHES) &&
+           verifier.VerifyVector(content_hashes()) &&
+           VerifyOffset(verifier, VT_DEPENDENCIES) &&
+           verifier.VerifyVector(dependencies()) &&
+           verifier.EndTable();
+  }
+};
+
+struct RecordBuilder {
+  typedef Record Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_guid(const AssetDB::Guid *guid) {
+    fbb_.AddStruct(Record::VT_GUID, guid);
+  }
+  void add_path(::flatbuffers::Offset<::flatbuffers::String> path) {
+    fbb_.AddOffset(Record::VT_PATH, path);
+  }
+  void add_type(AssetDB::AssetType type) {
+    fbb_.AddElement<uint8_t>(Record::VT_TYPE, static_cast<uint8_t>(type), 0);
+  }
+  void add_file_size(uint64_t file_size) {
+    fbb_.AddElement<uint64_t>(Record::VT_FILE_SIZE, file_size, 0);
+  }
+  void add_file_time(int64_t file_time) {
+    fbb_.AddElement<int64_t>(Record::VT_FILE_TIME, file_time, 0);
+  }
+  void add_source_hash(uint64_t source_hash) {
+    fbb_.AddElement<uint64_t>(Record::VT_SOURCE_HASH, source_hash, 0);
+  }
+  void add_cooked_source_hash(uint64_t cooked_source_hash) {
+    fbb_.AddElement<uint64_t>(Record::VT_COOKED_SOURCE_HASH, cooked_source_hash, 0);
+  }
+  void add_cooked_settings_hash(uint64_t cooked_settings_hash) {
+    fbb_.AddElement<uint64_t>(Record::VT_COOKED_SETTINGS_HASH, cooked_settings_hash, 0);
+  }
+  void add_cooked_hash(uint64_t cooked_hash) {
+    fbb_.AddElement<uint64_t>(Record::VT_COOKED_HASH, cooked_hash, 0);
+  }
+  void add_cooked_size(uint64_t cooked_size) {
+    fbb_.AddElement<uint64_t>(Record::VT_COOKED_SIZE, cooked_size, 0);
+  }
+  void add_content_hashes(::flatbuffers::Offset<::flatbuffers::Vector<uint64_t>> content_hashes) {
+    fbb_.AddOffset(Record::VT_CONTENT_HASHES, content_hashes);
+  }
+  void add_dependencies(::flatbuffers::Offset<::flatbuffers::Vector<const AssetDB::Dependency *>> dependencies) {
+    fbb_.AddOffset(Record::VT_DEPENDENCIES, dependencies);
+  }
+  explicit RecordBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<Record> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<Record>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<Record> CreateRecord(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const AssetDB::Guid *guid = nullptr,
+    ::flatbuffers::Offset<::flatbuffers::String> path = 0,
+    AssetDB::AssetType type = AssetDB::AssetType_Texture,
+    uint64_t file_size = 0,
+    int64_t file_time = 0,
+    uint64_t source_hash = 0,
+    uint64_t cooked_source_hash = 0,
+    uint64_t cooked_settings_hash = 0,
+    uint64_t cooked_hash = 0,
+    uint64_t cooked_size = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<uint64_t>> content_hashes = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<const AssetDB::Dependency *>> dependencies = 0) {
+  RecordBuilder builder_(_fbb);
+  builder_.add_cooked_size(cooked_size);
+  builder_.add_cooked_hash(cooked_hash);
+  builder_.add_cooked_settings_hash(cooked_settings_hash);
+  builder_.add_cooked_source_hash(cooked_source_hash);
+  builder_.add_source_hash(source_hash);
+  builder_.add_file_time(file_time);
+  builder_.add_file_size(file_size);
+  builder_.add_guid(guid);
+  builder_.add_dependencies(dependencies);
+  builder_.add_content_hashes(content_hashes);
+  builder_.add_path(path);
+  builder_.add_type(type);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<Record> CreateRecordDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    const AssetDB::Guid *guid = nullptr,
+    const char *path = nullptr,
+    AssetDB::AssetType type = AssetDB::AssetType_Texture,
+    uint64_t file_size = 0,
+    int64_t file_time = 0,
+    uint64_t source_hash = 0,
+    uint64_t cooked_source_hash = 0,
+    uint64_t cooked_settings_hash = 0,
+    uint64_t cooked_hash = 0,
+    uint64_t cooked_size = 0,
+    const std::vector<uint64_t> *content_hashes = nullptr,
+    const std::vector<AssetDB::Dependency> *dependencies = nullptr) {
+  auto path__ = path ? _fbb.CreateString(path) : 0;
+  auto content_hashes__ = content_hashes ? _fbb.CreateVector<uint64_t>(*content_hashes) : 0;
+  auto dependencies__ = dependencies ? _fbb.CreateVectorOfStructs<AssetDB::Dependency>(*dependencies) : 0;
+  return AssetDB::CreateRecord(
+      _fbb,
+      guid,
+      path__,
+      type,
+      file_size,
+      file_time,
+      source_hash,
+      cooked_source_hash,
+      cooked_settings_hash,
+      cooked_hash,
+      cooked_size,
+      content_hashes__,
+      dependencies__);
+}
+
+struct Database FLATBUFFERS_FINAL_CLASS : private ::flatbuffers::Table {
+  typedef DatabaseBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_VERSION = 4,
+    VT_RECORDS = 6
+  };
+  uint32_t version() const {
+    return GetField<uint32_t>(VT_VERSION, 0);
+  }
+  const ::flatbuffers::Vector<::flatbuffers::Offset<AssetDB::Record>> *records() const {
+    return GetPointer<const ::flatbuffers::Vector<::flatbuffers::Offset<AssetDB::Record>> *>(VT_RECORDS);
+  }
+  bool Verify(::flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyField<uint32_t>(verifier, VT_VERSION, 4) &&
+           VerifyOffset(verifier, VT_RECORDS) &&
+           verifier.VerifyVector(records()) &&
+           verifier.VerifyVectorOfTables(records()) &&
+           verifier.EndTable();
+  }
+};
+
+struct DatabaseBuilder {
+  typedef Database Table;
+  ::flatbuffers::FlatBufferBuilder &fbb_;
+  ::flatbuffers::uoffset_t start_;
+  void add_version(uint32_t version) {
+    fbb_.AddElement<uint32_t>(Database::VT_VERSION, version, 0);
+  }
+  void add_records(::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<AssetDB::Record>>> records) {
+    fbb_.AddOffset(Database::VT_RECORDS, records);
+  }
+  explicit DatabaseBuilder(::flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  ::flatbuffers::Offset<Database> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = ::flatbuffers::Offset<Database>(end);
+    return o;
+  }
+};
+
+inline ::flatbuffers::Offset<Database> CreateDatabase(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t version = 0,
+    ::flatbuffers::Offset<::flatbuffers::Vector<::flatbuffers::Offset<AssetDB::Record>>> records = 0) {
+  DatabaseBuilder builder_(_fbb);
+  builder_.add_records(records);
+  builder_.add_version(version);
+  return builder_.Finish();
+}
+
+inline ::flatbuffers::Offset<Database> CreateDatabaseDirect(
+    ::flatbuffers::FlatBufferBuilder &_fbb,
+    uint32_t version = 0,
+    const std::vector<::flatbuffers::Offset<AssetDB::Record>> *records = nullptr) {
+  auto records__ = records ? _fbb.CreateVector<::flatbuffers::Offset<AssetDB::Record>>(*records) : 0;
+  return AssetDB::CreateDatabase(
+      _fbb,
+      version,
+      records__);
+}
+
+inline const AssetDB::Database *GetDatabase(const void *buf) {
+  return ::flatbuffers::GetRoot<AssetDB::Database>(buf);
+}
+
+inline const AssetDB::Database *GetSizePrefixedDatabase(const void *buf) {
+  return ::flatbuffers::GetSizePrefixedRoot<AssetDB::Database>(buf);
+}
+
+inline bool VerifyDatabaseBuffer(
+    ::flatbuffers::Verifier &verifier) {
+  return verifier.VerifyBuffer<AssetDB::Database>(nullptr);
+}
+
+inline bool VerifySizePrefixedDatabaseBuffer(
+    ::flatbuffers::Verifier &verifier) {
+  return verifier.VerifySizePrefixedBuffer<AssetDB::Database>(nullptr);
+}
+
+inline void FinishDatabaseBuffer(
+    ::flatbuffers::FlatBufferBuilder &fbb,
+    ::flatbuffers::Offset<AssetDB::Database> root) {
+  fbb.Finish(root);
+}
+
+inline void FinishSizePrefixedDatabaseBuffer(
+    ::flatbuffers::FlatBufferBuilder &fbb,
+    ::flatbuffers::Offset<AssetDB::Database> root) {
+  fbb.FinishSizePrefixed(root);
+}
+
+}  // namespace AssetDB
+
+#endif  // FLATBUFFERS_GENERATED_ASSETDATABASE_ASSETDB_H_
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace BlackJawz::Tools
+{
+	// Just enough JSON for the benchmark results, keys are written as given and must not need escaping
+	class JsonWriter
+	{
+	public:
+		void BeginObject(const char* key = nullptr) { Begin(key, '{'); }
+		void EndObject() { End('}'); }
+		void BeginArray(const char* key = nullptr) { Begin(key, '['); }
+		void EndArray() { End(']'); }
+
+		void Value(const char* key, double value)
+		{
+			char number[32];
+			snprintf(number, sizeof(number), "%.6g", value);
+			Raw(key, number);
+		}
+
+		void Value(const char* key, uint64_t value) { Raw(key, std::to_string(value)); }
+		void Value(const char* key, bool value) { Raw(key, value ? "true" : "false"); }
+
+		void Value(const char* key, const std::string& value)
+		{
+			std::string quoted = "\"";
+			for (char c : value)
+			{
+				if (c == '"' || c == '\\')
+					quoted += '\\';
+				quoted += c;
+			}
+			Raw(key, quoted + "\"");
+		}
+
+		const std::string& GetText() const { return text; }
+
+	private:
+		void Prefix(const char* key)
+		{
+			if (!firstInScope.empty())
+			{
+				if (!firstInScope.back())
+					text += ',';
+				firstInScope.back() = false;
+				text += '\n';
+				text.append(firstInScope.size() * 2, ' ');
+			}
+
+			if (key)
+			{
+				text += '"';
+				text += key;
+				text += "\": ";
+			}
+		}
+
+		void Raw(const char* key, const std::string& value)
+		{
+			Prefix(key);
+			text += value;
+		}
+
+		void Begin(const char* key, char bracket)
+		{
+			Prefix(key);
+			text += bracket;
+			firstInScope.push_back(true);
+		}
+
+		void End(char bracket)
+		{
+			bool empty = firstInScope.back();
+			firstInScope.pop_back();
+			if (!empty)
+			{
+				text += '\n';
+				text.append(firstInScope.size() * 2, ' ');
+			}
+			text += bracket;
+		}
+
+		std::string text;
+		std::vector<bool> firstInScope;
+	};
+}
@@ -0,0 +1,599 @@
+#include "SceneGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	// Matches the editor's Vertex in Rendering.h
+	struct Vertex
+	{
+		float position[3];
+		float normal[3];
+		float texC[2];
+		float tangent[3];
+	};
+
+	class Random
+	{
+	public:
+		explicit Random(uint32_t seed) : state(seed * 2654435761u + 1) {}
+
+		uint32_t Next()
+		{
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		}
+
+		float Range(float min, float max) { return min + (max - min) * (Next() & 0xFFFFFF) / static_cast<float>(0xFFFFFF); }
+
+	private:
+		uint32_t state;
+	};
+
+	template <typename T>
+	BlackJawz::Scene::Blob ToBlob(const std::vector<T>& values)
+	{
+		const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+		return BlackJawz::Scene::Blob::FromVector(std::vector<uint8_t>(bytes, bytes + values.size() * sizeof(T)));
+	}
+
+	struct Mesh
+	{
+		BlackJawz::Scene::Blob vertices;
+		BlackJawz::Scene::Blob indices;
+		uint32_t indexCount = 0;
+	};
+
+	Mesh MakeMesh(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+	{
+		Mesh mesh;
+		mesh.vertices = ToBlob(vertices);
+		mesh.indices = ToBlob(indices);
+		mesh.indexCount = static_cast<uint32_t>(indices.size());
+		return mesh;
+	}
+
+	Mesh MakeCube()
+	{
+		// One quad per face, so every face gets its own normal and texture coordinates
+		const float normals[6][3] = { { 0, 0, -1 }, { 0, 0, 1 }, { -1, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 } };
+		const float tangents[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 0, -1 }, { 0, 0, 1 }, { 1, 0, 0 }, { 1, 0, 0 } };
+
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		for (int face = 0; face < 6; ++face)
+		{
+			const float* n = normals[face];
+			const float* t = tangents[face];
+			float b[3] = { n[1] * t[2] - n[2] * t[1], n[2] * t[0] - n[0] * t[2], n[0] * t[1] - n[1] * t[0] };
+
+			uint32_t first = static_cast<uint32_t>(vertices.size());
+			for (int corner = 0; corner < 4; ++corner)
+			{
+				float u = (corner == 1 || corner == 2) ? 1.0f : 0.0f;
+				float v = (corner >= 2) ? 1.0f : 0.0f;
+
+				Vertex vertex = {};
+				for (int axis = 0; axis < 3; ++axis)
+				{
+					vertex.position[axis] = n[axis] + (u * 2.0f - 1.0f) * t[axis] + (1.0f - v * 2.0f) * b[axis];
+					vertex.normal[axis] = n[axis];
+					vertex.tangent[axis] = t[axis];
+				}
+				vertex.texC[0] = u;
+				vertex.texC[1] = v;
+				vertices.push_back(vertex);
+			}
+
+			uint32_t quad[6] = { 0, 1, 2, 0, 2, 3 };
+			for (uint32_t index : quad)
+			{
+				indices.push_back(first + index);
+			}
+		}
+		return MakeMesh(vertices, indices);
+	}
+
+	Mesh MakeSphere()
+	{
+		// Same layout as the editor's sphere
+		const int subdivisions = 32;
+		const float pi = 3.14159265f;
+
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		for (int i = 0; i < subdivisions; ++i)
+		{
+			float phi = pi * i / (subdivisions - 1);
+			for (int j = 0; j < subdivisions; ++j)
+			{
+				float theta = 2.0f * pi * j / (subdivisions - 1);
+
+				Vertex vertex = {};
+				vertex.position[0] = sinf(phi) * cosf(theta);
+				vertex.position[1] = cosf(phi);
+				vertex.position[2] = sinf(phi) * sinf(theta);
+				memcpy(vertex.normal, vertex.position, sizeof(vertex.normal));
+				vertex.texC[0] = static_cast<float>(j) / (subdivisions - 1);
+				vertex.texC[1] = static_cast<float>(i) / (subdivisions - 1);
+				vertex.tangent[0] = -sinf(theta);
+				vertex.tangent[2] = cosf(theta);
+				vertices.push_back(vertex);
+			}
+		}
+
+		for (int i = 0; i < subdivisions - 1; ++i)
+		{
+			for (int j = 0; j < subdivisions - 1; ++j)
+			{
+				uint32_t v0 = i * subdivisions + j;
+				uint32_t v2 = v0 + subdivisions;
+				uint32_t quad[6] = { v0, v0 + 1, v2, v0 + 1, v2 + 1, v2 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+		return MakeMesh(vertices, indices);
+	}
+
+	Mesh MakePlane()
+	{
+		// A 10x10 grid with unshared vertices, like the editor's plane
+		const uint32_t size = 10;
+		const float width = 10.0f;
+		const float step = width / (size - 1);
+
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		for (uint32_t i = 0; i < size - 1; ++i)
+		{
+			for (uint32_t j = 0; j < size - 1; ++j)
+			{
+				float corners[4][2] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+				int order[6] = { 0, 1, 2, 2, 1, 3 };
+				for (int corner : order)
+				{
+					Vertex vertex = {};
+					vertex.position[0] = -width * 0.5f + (j + corners[corner][0]) * step;
+					vertex.position[2] = width * 0.5f - (i + corners[corner][1]) * step;
+					vertex.normal[1] = 1.0f;
+					vertex.texC[0] = corners[corner][0];
+					vertex.texC[1] = corners[corner][1];
+					vertex.tangent[0] = 1.0f;
+
+					indices.push_back(static_cast<uint32_t>(vertices.size()));
+					vertices.push_back(vertex);
+				}
+			}
+		}
+		return MakeMesh(vertices, indices);
+	}
+
+	// Uncompressed 32 bit RGBA DDS with a single mip, the pixels come from shade(x, y, pixel)
+	template <typename ShadeFunc>
+	BlackJawz::Scene::Blob MakeTexture(uint32_t size, ShadeFunc shade)
+	{
+		const uint32_t headerSize = 128;
+		std::vector<uint8_t> bytes(headerSize + size_t(size) * size * 4, 0);
+
+		auto write32 = [&bytes](size_t offset, uint32_t value) { memcpy(bytes.data() + offset, &value, sizeof(value)); };
+		write32(0, 0x20534444); // "DDS "
+		write32(4, 124);
+		write32(8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x8); // Caps, height, width, pixel format, pitch
+		write32(12, size);
+		write32(16, size);
+		write32(20, size * 4);
+		write32(76, 32); // Pixel format size
+		write32(80, 0x40 | 0x1); // RGB with alpha
+		write32(88, 32);
+		write32(92, 0x000000FF);
+		write32(96, 0x0000FF00);
+		write32(100, 0x00FF0000);
+		write32(104, 0xFF000000);
+		write32(108, 0x1000); // Texture
+
+		uint8_t* pixels = bytes.data() + headerSize;
+		for (uint32_t y = 0; y < size; ++y)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				shade(x, y, pixels + (size_t(y) * size + x) * 4);
+			}
+		}
+		return BlackJawz::Scene::Blob::FromVector(std::move(bytes));
+	}
+
+	// Diffuse, normal, roughness, AO and displacement, the slots the editor fills for a new shape
+	std::array<BlackJawz::Scene::Blob, BlackJawz::Scene::TextureSlotCount> MakeTextureSet(uint32_t size, Random& random)
+	{
+		using BlackJawz::Scene::TextureSlot;
+
+		uint8_t tint[3] = { static_cast<uint8_t>(random.Next()), static_cast<uint8_t>(random.Next()), static_cast<uint8_t>(random.Next()) };
+		uint32_t tileSize = 8u << (random.Next() % 4);
+
+		auto noise = [&random](uint8_t amount) { return static_cast<uint8_t>(random.Next() % (amount + 1)); };
+
+		std::array<BlackJawz::Scene::Blob, BlackJawz::Scene::TextureSlotCount> textures;
+		textures[static_cast<size_t>(TextureSlot::Diffuse)] = MakeTexture(size, [&](uint32_t x, uint32_t y, uint8_t* pixel)
+			{
+				bool checker = ((x / tileSize) + (y / tileSize)) % 2 == 0;
+				for (int channel = 0; channel < 3; ++channel)
+				{
+					pixel[channel] = static_cast<uint8_t>((checker ? tint[channel] : tint[channel] / 2) + noise(15));
+				}
+				pixel[3] = 255;
+			});
+		textures[static_cast<size_t>(TextureSlot::Normal)] = MakeTexture(size, [&](uint32_t, uint32_t, uint8_t* pixel)
+			{
+				pixel[0] = static_cast<uint8_t>(120 + noise(15));
+				pixel[1] = static_cast<uint8_t>(120 + noise(15));
+				pixel[2] = 255;
+				pixel[3] = 255;
+			});
+		textures[static_cast<size_t>(TextureSlot::Roughness)] = MakeTexture(size, [&](uint32_t x, uint32_t, uint8_t* pixel)
+			{
+				uint8_t value = static_cast<uint8_t>(x * 255 / size);
+				pixel[0] = pixel[1] = pixel[2] = value;
+				pixel[3] = 255;
+			});
+		textures[static_cast<size_t>(TextureSlot::AO)] = MakeTexture(size, [&](uint32_t x, uint32_t y, uint8_t* pixel)
+			{
+				bool edge = x % tileSize == 0 || y % tileSize == 0;
+				pixel[0] = pixel[1] = pixel[2] = edge ? 96 : 255;
+				pixel[3] = 255;
+			});
+		textures[static_cast<size_t>(TextureSlot::Displacement)] = MakeTexture(size, [&](uint32_t, uint32_t, uint8_t* pixel)
+			{
+				uint8_t value = static_cast<uint8_t>(128 + noise(63));
+				pixel[0] = pixel[1] = pixel[2] = value;
+				pixel[3] = 255;
+			});
+		return textures;
+	}
+
+	// Rolling hills over the grid, x and z in quads
+	Vertex MakeTerrainVertex(uint32_t x, uint32_t z, uint32_t gridSize)
+	{
+		float fx = static_cast<float>(x);
+		float fz = static_cast<float>(z);
+		float slopeX = 0.1f * cosf(fx * 0.05f) * cosf(fz * 0.07f);
+		float slopeZ = -0.14f * sinf(fx * 0.05f) * sinf(fz * 0.07f);
+		float normalLength = sqrtf(slopeX * slopeX + 1.0f + slopeZ * slopeZ);
+		float tangentLength = sqrtf(1.0f + slopeX * slopeX);
+
+		Vertex vertex = {};
+		vertex.position[0] = fx;
+		vertex.position[1] = 2.0f * sinf(fx * 0.05f) * cosf(fz * 0.07f);
+		vertex.position[2] = fz;
+		vertex.normal[0] = -slopeX / normalLength;
+		vertex.normal[1] = 1.0f / normalLength;
+		vertex.normal[2] = -slopeZ / normalLength;
+		vertex.texC[0] = fx / gridSize;
+		vertex.texC[1] = fz / gridSize;
+		vertex.tangent[0] = 1.0f / tangentLength;
+		vertex.tangent[1] = slopeX / tangentLength;
+		return vertex;
+	}
+
+	// Quad rows [first, last) of band
+	void GetBandRows(uint32_t gridSize, uint32_t bandCount, uint32_t band, uint32_t& first, uint32_t& last)
+	{
+		first = static_cast<uint32_t>(static_cast<uint64_t>(gridSize) * band / bandCount);
+		last = static_cast<uint32_t>(static_cast<uint64_t>(gridSize) * (band + 1) / bandCount);
+	}
+
+	void AppendFormat(std::string& text, const char* format, ...)
+	{
+		char line[256];
+		va_list arguments;
+		va_start(arguments, format);
+		int length = vsnprintf(line, sizeof(line), format, arguments);
+		va_end(arguments);
+		text.append(line, std::min<size_t>(std::max(length, 0), sizeof(line) - 1));
+	}
+
+	// Every band has its own vertices, the rows on either side of it. Returns the JSON without its
+	// buffers, the buffer holds positions, normals, texture coordinates and indices of each band in turn.
+	std::string MakeGltfJson(uint32_t gridSize, uint32_t bandCount, std::vector<uint8_t>& buffer)
+	{
+		auto append = [&](const void* data, size_t size)
+			{
+				const uint8_t* bytes = static_cast<const uint8_t*>(data);
+				buffer.insert(buffer.end(), bytes, bytes + size);
+			};
+
+		std::string meshes;
+		std::string nodes;
+		std::string sceneNodes;
+		std::string materials;
+		std::string views;
+		std::string accessors;
+		for (uint32_t band = 0; band < bandCount; ++band)
+		{
+			uint32_t firstRow = 0;
+			uint32_t lastRow = 0;
+			GetBandRows(gridSize, bandCount, band, firstRow, lastRow);
+
+			std::vector<Vertex> vertices;
+			for (uint32_t z = firstRow; z <= lastRow; ++z)
+			{
+				for (uint32_t x = 0; x <= gridSize; ++x)
+				{
+					// Relative to the band, its node moves it into place
+					vertices.push_back(MakeTerrainVertex(x, z, gridSize));
+					vertices.back().position[2] -= static_cast<float>(firstRow);
+				}
+			}
+
+			// Counter clockwise from above
+			std::vector<uint32_t> indices;
+			uint32_t rowLength = gridSize + 1;
+			for (uint32_t z = 0; z < lastRow - firstRow; ++z)
+			{
+				for (uint32_t x = 0; x < gridSize; ++x)
+				{
+					uint32_t v0 = z * rowLength + x;
+					uint32_t v1 = v0 + rowLength;
+					uint32_t quad[6] = { v0, v1, v1 + 1, v0, v1 + 1, v0 + 1 };
+					indices.insert(indices.end(), quad, quad + 6);
+				}
+			}
+
+			float minimum[3] = { 0.0f, 0.0f, 0.0f };
+			float maximum[3] = { 0.0f, 0.0f, 0.0f };
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				minimum[axis] = maximum[axis] = vertices[0].position[axis];
+				for (const Vertex& vertex : vertices)
+				{
+					minimum[axis] = std::min(minimum[axis], vertex.position[axis]);
+					maximum[axis] = std::max(maximum[axis], vertex.position[axis]);
+				}
+			}
+
+			uint32_t view = band * 4;
+			const char* separator = band == 0 ? "" : ",";
+			size_t offsets[4];
+			offsets[0] = buffer.size();
+			for (const Vertex& vertex : vertices)
+			{
+				append(vertex.position, sizeof(vertex.position));
+			}
+			offsets[1] = buffer.size();
+			for (const Vertex& vertex : vertices)
+			{
+				append(vertex.normal, sizeof(vertex.normal));
+			}
+			offsets[2] = buffer.size();
+			for (const Vertex& vertex : vertices)
+			{
+				append(vertex.texC, sizeof(vertex.texC));
+			}
+			offsets[3] = buffer.size();
+			append(indices.data(), indices.size() * sizeof(uint32_t));
+
+			for (size_t i = 0; i < 4; ++i)
+			{
+				size_t end = i < 3 ? offsets[i + 1] : buffer.size();
+				AppendFormat(views, "%s{\"buffer\":0,\"byteOffset\":%zu,\"byteLength\":%zu}", band == 0 && i == 0 ? "" : ",", offsets[i], end - offsets[i]);
+			}
+			AppendFormat(accessors, "%s{\"bufferView\":%u,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\",\"min\":[%g,%g,%g],\"max\":[%g,%g,%g]}",
+				separator, view, vertices.size(), minimum[0], minimum[1], minimum[2], maximum[0], maximum[1], maximum[2]);
+			AppendFormat(accessors, ",{\"bufferView\":%u,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC3\"}", view + 1, vertices.size());
+			AppendFormat(accessors, ",{\"bufferView\":%u,\"componentType\":5126,\"count\":%zu,\"type\":\"VEC2\"}", view + 2, vertices.size());
+			AppendFormat(accessors, ",{\"bufferView\":%u,\"componentType\":5125,\"count\":%zu,\"type\":\"SCALAR\"}", view + 3, indices.size());
+			AppendFormat(meshes, "%s{\"name\":\"Band %u\",\"primitives\":[{\"attributes\":{\"POSITION\":%u,\"NORMAL\":%u,\"TEXCOORD_0\":%u},\"indices\":%u,\"material\":%u}]}",
+				separator, band, view, view + 1, view + 2, view + 3, band);
+			AppendFormat(nodes, "%s{\"mesh\":%u,\"translation\":[0,0,%u]}", separator, band, firstRow);
+			AppendFormat(sceneNodes, "%s%u", separator, band);
+			AppendFormat(materials, "%s{\"name\":\"Band %u\",\"pbrMetallicRoughness\":{\"metallicFactor\":0,\"roughnessFactor\":0.8}}", separator, band);
+		}
+
+		return "{\"asset\":{\"version\":\"2.0\",\"generator\":\"SceneBenchmark\"},\"scene\":0,\"scenes\":[{\"nodes\":[" + sceneNodes + "]}]," +
+			"\"nodes\":[" + nodes + "],\"meshes\":[" + meshes + "],\"materials\":[" + materials + "]," +
+			"\"bufferViews\":[" + views + "],\"accessors\":[" + accessors + "],";
+	}
+}
+
+std::vector<BlackJawz::Scene::EntityData> BlackJawz::Tools::GenerateScene(const GeneratorOptions& options)
+{
+	Random random(options.seed);
+
+	const Mesh meshes[] = { MakeCube(), MakeSphere(), MakePlane() };
+	const char* meshNames[] = { "Cube", "Sphere", "Plane" };
+
+	std::vector<std::array<Scene::Blob, Scene::TextureSlotCount>> textureSets;
+	for (size_t i = 0; i < std::max<size_t>(options.textureSetCount, 1); ++i)
+	{
+		textureSets.push_back(MakeTextureSet(options.textureSize, random));
+	}
+
+	// Spread over a square sized for roughly one entity per 4x4 units
+	float extent = 2.0f * sqrtf(static_cast<float>(options.entityCount));
+
+	std::vector<Scene::EntityData> entities(options.entityCount);
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		Scene::EntityData& entity = entities[i];
+		entity.id = static_cast<uint32_t>(i);
+
+		Scene::TransformData& transform = entity.transform.emplace();
+		transform.position[0] = random.Range(-extent, extent);
+		transform.position[1] = random.Range(0.0f, 10.0f);
+		transform.position[2] = random.Range(-extent, extent);
+		transform.rotation[1] = random.Range(0.0f, 6.28318f);
+		transform.worldMatrix[12] = transform.position[0];
+		transform.worldMatrix[13] = transform.position[1];
+		transform.worldMatrix[14] = transform.position[2];
+
+		if (random.Range(0.0f, 1.0f) < options.lightFraction)
+		{
+			entity.name = "Light " + std::to_string(i);
+
+			Scene::LightData& light = entity.light.emplace();
+			light.type = 0; // Point
+			light.diffuseLight[0] = random.Range(0.2f, 1.0f);
+			light.diffuseLight[1] = random.Range(0.2f, 1.0f);
+			light.diffuseLight[2] = random.Range(0.2f, 1.0f);
+			light.diffuseLight[3] = 1.0f;
+			light.range = random.Range(5.0f, 50.0f);
+			light.intensity = 1.0f;
+			light.attenuation[0] = 1.0f;
+			continue;
+		}
+
+		size_t meshIndex = random.Next() % 3;
+		const Mesh& mesh = meshes[meshIndex];
+		entity.name = std::string(meshNames[meshIndex]) + " " + std::to_string(i);
+
+		Scene::AppearanceData& appearance = entity.appearance.emplace();
+		appearance.geometry.indicesCount = mesh.indexCount;
+		appearance.geometry.vertexBufferStride = sizeof(Vertex);
+		appearance.geometry.vertexBufferOffset = 0;
+		appearance.geometry.vertexBuffer = mesh.vertices;
+		appearance.geometry.indexBuffer = mesh.indices;
+
+		const auto& textures = textureSets[random.Next() % textureSets.size()];
+		for (size_t slot = 0; slot < Scene::TextureSlotCount; ++slot)
+		{
+			appearance.textures[slot] = textures[slot];
+		}
+
+		if (options.instancesPerEntity > 0)
+		{
+			// Foliage-like spread, each instance gets the same 4x4 units an entity would
+			float radius = 2.0f * sqrtf(static_cast<float>(options.instancesPerEntity));
+
+			Scene::InstancesData& instances = appearance.instances.emplace();
+			instances.transforms.resize(options.instancesPerEntity);
+			for (auto& instance : instances.transforms)
+			{
+				float scale = random.Range(0.5f, 1.5f);
+				instance.position[0] = random.Range(-radius, radius);
+				instance.position[2] = random.Range(-radius, radius);
+				instance.rotation[1] = random.Range(0.0f, 6.28318f);
+				instance.scale[0] = instance.scale[1] = instance.scale[2] = scale;
+			}
+
+			instances.paramStride = options.instanceParamStride;
+			instances.params.resize(options.instancesPerEntity * options.instanceParamStride);
+			for (float& param : instances.params)
+			{
+				param = random.Range(0.0f, 1.0f);
+			}
+		}
+	}
+
+	return entities;
+}
+
+std::string BlackJawz::Tools::GenerateObjModel(uint32_t gridSize, uint32_t bandCount)
+{
+	bandCount = std::clamp(bandCount, 1u, std::max(gridSize, 1u));
+
+	std::string text;
+	AppendFormat(text, "# Terrain of %u by %u quads\n", gridSize, gridSize);
+	for (uint32_t z = 0; z <= gridSize; ++z)
+	{
+		for (uint32_t x = 0; x <= gridSize; ++x)
+		{
+			Vertex vertex = MakeTerrainVertex(x, z, gridSize);
+			AppendFormat(text, "v %.6f %.6f %.6f\n", vertex.position[0], vertex.position[1], vertex.position[2]);
+		}
+	}
+	for (uint32_t z = 0; z <= gridSize; ++z)
+	{
+		for (uint32_t x = 0; x <= gridSize; ++x)
+		{
+			// OBJ puts v = 0 at the bottom of the texture
+			Vertex vertex = MakeTerrainVertex(x, z, gridSize);
+			AppendFormat(text, "vt %.6f %.6f\n", vertex.texC[0], 1.0f - vertex.texC[1]);
+		}
+	}
+	for (uint32_t z = 0; z <= gridSize; ++z)
+	{
+		for (uint32_t x = 0; x <= gridSize; ++x)
+		{
+			Vertex vertex = MakeTerrainVertex(x, z, gridSize);
+			AppendFormat(text, "vn %.6f %.6f %.6f\n", vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+		}
+	}
+
+	// Quads counter clockwise from above
+	uint32_t rowLength = gridSize + 1;
+	for (uint32_t band = 0; band < bandCount; ++band)
+	{
+		uint32_t firstRow = 0;
+		uint32_t lastRow = 0;
+		GetBandRows(gridSize, bandCount, band, firstRow, lastRow);
+		AppendFormat(text, "o Band %u\nusemtl Band %u\n", band, band);
+		for (uint32_t z = firstRow; z < lastRow; ++z)
+		{
+			for (uint32_t x = 0; x < gridSize; ++x)
+			{
+				uint32_t v0 = z * rowLength + x + 1;
+				uint32_t v1 = v0 + rowLength;
+				AppendFormat(text, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", v0, v0, v0, v1, v1, v1, v1 + 1, v1 + 1, v1 + 1, v0 + 1, v0 + 1, v0 + 1);
+			}
+		}
+	}
+	return text;
+}
+
+std::vector<uint8_t> BlackJawz::Tools::GenerateGlbModel(uint32_t gridSize, uint32_t bandCount)
+{
+	bandCount = std::clamp(bandCount, 1u, std::max(gridSize, 1u));
+
+	std::vector<uint8_t> buffer;
+	std::string json = MakeGltfJson(gridSize, bandCount, buffer);
+	json += "\"buffers\":[{\"byteLength\":" + std::to_string(buffer.size()) + "}]}";
+
+	// Chunks are padded to four bytes, JSON with spaces and the buffer with zeros
+	json.resize((json.size() + 3) & ~size_t(3), ' ');
+	buffer.resize((buffer.size() + 3) & ~size_t(3), 0);
+
+	uint32_t header[5] =
+	{
+		0x46546C67, 2, static_cast<uint32_t>(12 + 8 + json.size() + 8 + buffer.size()),
+		static_cast<uint32_t>(json.size()), 0x4E4F534A
+	};
+	uint32_t binaryHeader[2] = { static_cast<uint32_t>(buffer.size()), 0x004E4942 };
+
+	std::vector<uint8_t> file(sizeof(header) + json.size() + sizeof(binaryHeader) + buffer.size());
+	uint8_t* out = file.data();
+	memcpy(out, header, sizeof(header));
+	memcpy(out += sizeof(header), json.data(), json.size());
+	memcpy(out += json.size(), binaryHeader, sizeof(binaryHeader));
+	memcpy(out + sizeof(binaryHeader), buffer.data(), buffer.size());
+	return file;
+}
+
+std::string BlackJawz::Tools::GenerateGltfModel(uint32_t gridSize, uint32_t bandCount)
+{
+	bandCount = std::clamp(bandCount, 1u, std::max(gridSize, 1u));
+
+	std::vector<uint8_t> buffer;
+	std::string json = MakeGltfJson(gridSize, bandCount, buffer);
+	json += "\"buffers\":[{\"byteLength\":" + std::to_string(buffer.size()) + ",\"uri\":\"data:application/octet-stream;base64,";
+
+	const char* digits = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+	json.reserve(json.size() + buffer.size() / 3 * 4 + 16);
+	for (size_t i = 0; i < buffer.size(); i += 3)
+	{
+		size_t remaining = std::min<size_t>(buffer.size() - i, 3);
+		uint32_t bits = buffer[i] << 16;
+		bits |= remaining > 1 ? buffer[i + 1] << 8 : 0;
+		bits |= remaining > 2 ? buffer[i + 2] : 0;
+		json += digits[(bits >> 18) & 63];
+		json += digits[(bits >> 12) & 63];
+		json += remaining > 1 ? digits[(bits >> 6) & 63] : '=';
+		json += remaining > 2 ? digits[bits & 63] : '=';
+	}
+	json += "\"}]}";
+	return json;
+}
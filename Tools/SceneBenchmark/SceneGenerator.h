@@ -0,0 +1,36 @@
+#pragma once
+#include "Scene/SceneData.h"
+
+namespace BlackJawz::Tools
+{
+	struct GeneratorOptions
+	{
+		size_t entityCount = 1000;
+
+		// Unique texture sets, meshes pick one at random so fewer sets means more sharing
+		size_t textureSetCount = 8;
+		uint32_t textureSize = 256;
+
+		float lightFraction = 0.05f; // The rest is split between cubes, spheres and planes
+
+		// When set, every mesh entity is an instance set of this many copies scattered around it
+		size_t instancesPerEntity = 0;
+		uint32_t instanceParamStride = 0; // Random floats per instance
+		uint32_t seed = 1;
+	};
+
+	// Builds a scene like one made in the editor: cubes, spheres and planes sharing the
+	// editor's three meshes, textured with generated RGBA8 DDS textures, plus point lights.
+	// The same options always produce the same scene.
+	std::vector<Scene::EntityData> GenerateScene(const GeneratorOptions& options);
+
+	// Rolling terrain of gridSize by gridSize quads, cut into bands of rows that are separate objects
+	// with their own material, as model files for the mesh importer. Positions, normals and texture
+	// coordinates are written with six decimals like common exporters.
+	std::string GenerateObjModel(uint32_t gridSize, uint32_t bandCount);
+
+	// The same terrain as glTF, one mesh per band. Binary with the buffer in the file, or JSON with
+	// it embedded as base64.
+	std::vector<uint8_t> GenerateGlbModel(uint32_t gridSize, uint32_t bandCount);
+	std::string GenerateGltfModel(uint32_t gridSize, uint32_t bandCount);
+}
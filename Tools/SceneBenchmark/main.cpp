@@ -0,0 +1,1734 @@
+#include "JsonWriter.h"
+#include "SceneGenerator.h"
+#include "SceneCooker/ConeStepMap.h"
+#include "SceneCooker/TextureProcessing.h"
+#include "Scene/MeshImport.h"
+#include "Scene/NullResourceBackend.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneBounds.h"
+#include "Scene/SceneLoader.h"
+#include "Scene/SceneReader.h"
+#include "Scene/SceneWriter.h"
+#include "Scene/VertexPacking.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	struct BenchmarkOptions
+	{
+		std::vector<size_t> entityCounts = { 1000, 10000, 50000 };
+		std::vector<size_t> textureSetCounts = { 4, 64 };
+		std::vector<uint32_t> threadCounts;
+		uint32_t textureSize = 256;
+		uint32_t iterations = 3;
+		size_t instanceCount = 100000;
+		size_t compressTextureSets = 4; // Needs DirectXTex
+		uint32_t loadTextureSize = 4096; // Needs DirectXTex
+		uint32_t coneMapSize = 256;
+		uint32_t meshGridSize = 512;
+		uint32_t meshBands = 16;
+		BlackJawz::Tools::CompressionPreset compressionPreset = BlackJawz::Tools::CompressionPreset::Fast;
+		std::string directory;
+		std::string output;
+	};
+
+	double ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	double Median(std::vector<double> values)
+	{
+		if (values.empty())
+			return 0.0;
+
+		std::sort(values.begin(), values.end());
+		size_t middle = values.size() / 2;
+		return values.size() % 2 ? values[middle] : (values[middle - 1] + values[middle]) * 0.5;
+	}
+
+	// Peak resident memory since the last reset, 0 where the platform cannot report it
+	void ResetPeakMemory()
+	{
+#ifdef __linux__
+		std::ofstream clearRefs("/proc/self/clear_refs");
+		clearRefs << "5";
+#endif
+	}
+
+	uint64_t GetPeakMemory()
+	{
+#ifdef __linux__
+		std::ifstream status("/proc/self/status");
+		std::string line;
+		while (std::getline(status, line))
+		{
+			if (line.rfind("VmHWM:", 0) == 0)
+				return strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+		}
+#endif
+		return 0;
+	}
+
+	// Best effort, a cold load still hits the drive cache if the kernel keeps the pages
+	bool DropFileCache(const std::string& filename)
+	{
+#ifdef __linux__
+		int file = open(filename.c_str(), O_RDONLY);
+		if (file < 0)
+			return false;
+
+		fdatasync(file);
+		bool dropped = posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED) == 0;
+		close(file);
+		return dropped;
+#else
+		return false;
+#endif
+	}
+
+	// The same pipeline as the editor's SceneSaveTask
+	uint64_t SaveScene(const std::vector<BlackJawz::Scene::EntityData>& entities, const std::string& filename, bool compress,
+		BlackJawz::Jobs::JobSystem& jobSystem, uint64_t& rawAssetBytes, uint64_t& storedAssetBytes)
+	{
+		using namespace BlackJawz;
+
+		Scene::SceneAssets assets(compress);
+		assets.Collect(entities.data(), entities.size());
+
+		Jobs::JobCounter hashCounter;
+		jobSystem.Dispatch(hashCounter, static_cast<uint32_t>(assets.GetCount()), 1, [&assets](uint32_t index) { assets.Hash(index); });
+		jobSystem.Wait(hashCounter);
+
+		assets.Deduplicate();
+
+		Jobs::JobCounter compressCounter;
+		jobSystem.Dispatch(compressCounter, static_cast<uint32_t>(assets.GetCount()), 1, [&assets](uint32_t index) { assets.Compress(index); });
+		jobSystem.Wait(compressCounter);
+
+		size_t chunkCount = Scene::SceneWriter::GetChunkCount(entities.size());
+		std::vector<flatbuffers::DetachedBuffer> chunks(chunkCount);
+
+		Jobs::JobCounter chunkCounter;
+		jobSystem.Dispatch(chunkCounter, static_cast<uint32_t>(chunkCount), 1, [&](uint32_t index)
+			{
+				size_t begin = index * Scene::SceneWriter::EntitiesPerChunk;
+				size_t count = std::min(Scene::SceneWriter::EntitiesPerChunk, entities.size() - begin);
+
+				chunks[index] = Scene::SceneWriter::WriteChunk(entities.data() + begin, count, &assets);
+			});
+		jobSystem.Wait(chunkCounter);
+
+		Scene::SpatialIndex spatialIndex;
+		spatialIndex.Build(entities, jobSystem);
+
+		flatbuffers::DetachedBuffer scene = Scene::SceneWriter::MergeChunks(chunks, 0, &assets, &spatialIndex);
+		chunks.clear();
+
+		rawAssetBytes = assets.GetRawBytes();
+		storedAssetBytes = assets.GetStoredBytes();
+
+		if (!Scene::SceneWriter::WriteToFile(filename, scene.data(), scene.size()))
+			return 0;
+
+		return scene.size();
+	}
+
+	// Decode every entity on one thread from a file already in memory, no uploads
+	size_t ParseScene(const BlackJawz::Scene::Blob& fileData)
+	{
+		using namespace BlackJawz;
+
+		const ECS::Scene* fileScene = ECS::GetScene(fileData.data);
+
+		std::vector<Scene::Blob> assets;
+		if (fileScene->assets())
+		{
+			assets.resize(fileScene->assets()->size());
+			for (uint32_t i = 0; i < fileScene->assets()->size(); ++i)
+			{
+				Scene::SceneAssets::Decode(fileScene->assets()->Get(i), fileData, assets[i]);
+			}
+		}
+
+		size_t count = 0;
+		std::vector<Scene::SceneReader::EntityRange> ranges = Scene::SceneReader::GetEntityRanges(fileScene, count);
+
+		std::vector<Scene::EntityData> entities(count);
+		for (const auto& range : ranges)
+		{
+			for (uint32_t i = 0; i < range.count; ++i)
+			{
+				Scene::SceneReader::ReadEntity(range.entities->Get(range.begin + i), fileData, assets, entities[range.firstEntity + i]);
+			}
+		}
+		return entities.size();
+	}
+
+	struct LoadResult
+	{
+		bool loaded = false;
+		double ms = 0.0;
+		BlackJawz::Scene::LoadStats stats;
+		size_t createdCount = 0;
+	};
+
+	// Full load through the upload queue, the null backend accepts and counts every upload
+	LoadResult LoadScene(const std::string& filename, BlackJawz::Jobs::JobSystem& jobSystem, bool verify = true)
+	{
+		BlackJawz::Scene::NullResourceBackend backend(true);
+		BlackJawz::Scene::SceneLoader loader(jobSystem, backend);
+		loader.SetVerifyFiles(verify);
+
+		LoadResult result;
+		BlackJawz::Scene::LoadedScene scene;
+
+		auto start = std::chrono::steady_clock::now();
+		result.loaded = loader.Load(filename, scene);
+		result.ms = ElapsedMs(start);
+
+		result.stats = loader.GetStats();
+		result.createdCount = backend.GetCreatedCount();
+		return result;
+	}
+
+	struct IncrementalLoadResult
+	{
+		bool loaded = false;
+		double ms = 0.0;
+		double firstEntityMs = 0.0; // Until the first entities were inserted
+		uint32_t frames = 0;
+	};
+
+	// The editor's SceneLoadTask without the ECS: a 60 Hz frame loop that inserts decoded entities
+	// whose resources are ready, for up to 4 ms a frame, while the rest of the file decodes
+	IncrementalLoadResult LoadSceneIncrementally(const std::string& filename, BlackJawz::Jobs::JobSystem& jobSystem)
+	{
+		using namespace BlackJawz;
+
+		constexpr auto FramePeriod = std::chrono::microseconds(16667);
+		constexpr auto FrameBudget = std::chrono::microseconds(4000);
+
+		Scene::NullResourceBackend backend(true);
+		Scene::SceneLoader loader(jobSystem, backend);
+		Scene::LoadedScene scene;
+
+		IncrementalLoadResult result;
+		auto start = std::chrono::steady_clock::now();
+		if (!loader.Begin(filename, scene))
+			return result;
+
+		// Stands in for the components the editor creates
+		std::vector<std::string> names;
+		size_t nextEntity = 0;
+		std::vector<size_t> waitingEntities;
+		bool inserted = false;
+
+		for (auto frameStart = start;; frameStart += FramePeriod)
+		{
+			++result.frames;
+
+			Scene::SceneLoader::State state = loader.GetState();
+			if (state == Scene::SceneLoader::State::Failed)
+			{
+				loader.Wait();
+				return result;
+			}
+
+			size_t decodedCount = loader.GetDecodedCount();
+			auto deadline = std::chrono::steady_clock::now() + FrameBudget;
+			size_t insertedBefore = names.size();
+
+			size_t stillWaiting = 0;
+			for (size_t entityIndex : waitingEntities)
+			{
+				if (std::chrono::steady_clock::now() < deadline && loader.AreResourcesReady(scene.resourceSlots[entityIndex]))
+					names.push_back(std::move(scene.entities[entityIndex].name));
+				else
+					waitingEntities[stillWaiting++] = entityIndex;
+			}
+			waitingEntities.resize(stillWaiting);
+
+			while (nextEntity < decodedCount && std::chrono::steady_clock::now() < deadline)
+			{
+				if (loader.AreResourcesReady(scene.resourceSlots[nextEntity]))
+					names.push_back(std::move(scene.entities[nextEntity].name));
+				else
+					waitingEntities.push_back(nextEntity);
+				++nextEntity;
+			}
+
+			if (!inserted && names.size() > insertedBefore)
+			{
+				inserted = true;
+				result.firstEntityMs = ElapsedMs(start);
+			}
+
+			if (state == Scene::SceneLoader::State::Decoded && nextEntity == decodedCount && waitingEntities.empty())
+				break;
+
+			std::this_thread::sleep_until(frameStart + FramePeriod);
+		}
+
+		loader.Wait();
+		result.ms = ElapsedMs(start);
+		result.loaded = true;
+		return result;
+	}
+
+	void WriteLoadStats(BlackJawz::Tools::JsonWriter& json, const BlackJawz::Scene::LoadStats& stats)
+	{
+		json.BeginObject("phases");
+		json.Value("readMs", stats.readMs);
+		json.Value("verifyMs", stats.verifyMs);
+		json.Value("decompressMs", stats.decompressMs);
+		json.Value("decodeMs", stats.decodeMs);
+		json.Value("uploadMs", stats.uploadMs);
+		json.Value("spatialIndexMs", stats.spatialIndexMs);
+		json.EndObject();
+		json.Value("spatialIndexRebuilt", stats.spatialIndexRebuilt);
+	}
+
+	// Round trip tolerances for packed vertices. The octahedral encoding's worst case over five million
+	// random directions measures 0.0074 degrees.
+	constexpr float PackedAngleToleranceDegrees = 0.01f;
+
+	// Quantizing within the bounds is off by at most half a step, decoding adds a few roundings of the
+	// largest coordinate
+	float GetPositionTolerance(const BlackJawz::Scene::BoundsData& bounds, float positionBound)
+	{
+		float largest = 0.0f;
+		for (size_t axis = 0; axis < 3; ++axis)
+		{
+			largest = std::max({ largest, std::abs(bounds.min[axis]), std::abs(bounds.max[axis]) });
+		}
+		return positionBound + largest * 4.0f * std::numeric_limits<float>::epsilon();
+	}
+
+	bool IsPackingErrorWithin(const BlackJawz::Scene::PackingError& error, float positionTolerance)
+	{
+		return error.position <= positionTolerance && error.normalDegrees <= PackedAngleToleranceDegrees &&
+			error.tangentDegrees <= PackedAngleToleranceDegrees;
+	}
+
+	// Packs every unique mesh, then saves a packed copy of the scene to compare its size. Fails when
+	// a mesh does not round trip within the tolerances.
+	bool MeasureVertexPacking(const std::vector<BlackJawz::Scene::EntityData>& entities, const std::string& filename,
+		BlackJawz::Jobs::JobSystem& jobSystem, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		std::unordered_map<const uint8_t*, Scene::GeometryData> packed;
+		Scene::PackingError error;
+		uint64_t unpackedBytes = 0, packedBytes = 0;
+		size_t failedMeshes = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for (const auto& entity : entities)
+		{
+			if (!entity.appearance || packed.count(entity.appearance->geometry.vertexBuffer.data) > 0)
+				continue;
+
+			const Scene::GeometryData& geometry = entity.appearance->geometry;
+			Scene::GeometryData result = geometry;
+			if (!Scene::PackVertices(result))
+				continue;
+
+			Scene::PackingError geometryError = Scene::MeasurePackingError(geometry, result);
+			if (!IsPackingErrorWithin(geometryError, GetPositionTolerance(*result.bounds, geometryError.positionBound)))
+			{
+				++failedMeshes;
+			}
+
+			error.position = std::max(error.position, geometryError.position);
+			error.positionBound = std::max(error.positionBound, geometryError.positionBound);
+			error.normalDegrees = std::max(error.normalDegrees, geometryError.normalDegrees);
+			error.tangentDegrees = std::max(error.tangentDegrees, geometryError.tangentDegrees);
+			error.texC = std::max(error.texC, geometryError.texC);
+			error.vertexCount += geometryError.vertexCount;
+
+			unpackedBytes += geometry.vertexBuffer.size - geometry.vertexBufferOffset;
+			packedBytes += result.vertexBuffer.size;
+			packed.emplace(geometry.vertexBuffer.data, std::move(result));
+		}
+		double packMs = ElapsedMs(start);
+
+		if (failedMeshes > 0)
+		{
+			fprintf(stderr, "%zu meshes did not round trip through vertex packing\n", failedMeshes);
+		}
+
+		std::vector<Scene::EntityData> packedEntities = entities;
+		for (auto& entity : packedEntities)
+		{
+			if (!entity.appearance)
+				continue;
+
+			auto it = packed.find(entity.appearance->geometry.vertexBuffer.data);
+			if (it == packed.end())
+				continue;
+
+			Scene::GeometryData& geometry = entity.appearance->geometry;
+			geometry.vertexBuffer = it->second.vertexBuffer;
+			geometry.vertexBufferStride = it->second.vertexBufferStride;
+			geometry.vertexBufferOffset = it->second.vertexBufferOffset;
+			geometry.vertexFormat = it->second.vertexFormat;
+			geometry.bounds = it->second.bounds;
+		}
+
+		uint64_t rawAssetBytes = 0, storedAssetBytes = 0;
+		uint64_t floatFileBytes = SaveScene(entities, filename, false, jobSystem, rawAssetBytes, storedAssetBytes);
+		uint64_t packedFileBytes = SaveScene(packedEntities, filename, false, jobSystem, rawAssetBytes, storedAssetBytes);
+		std::filesystem::remove(filename);
+
+		json.BeginObject("vertexPacking");
+		json.Value("meshes", static_cast<uint64_t>(packed.size()));
+		json.Value("failedMeshes", static_cast<uint64_t>(failedMeshes));
+		json.Value("vertices", static_cast<uint64_t>(error.vertexCount));
+		json.Value("packMs", packMs);
+		json.Value("floatVertexBytes", unpackedBytes);
+		json.Value("packedVertexBytes", packedBytes);
+		json.Value("floatFileBytes", floatFileBytes);
+		json.Value("packedFileBytes", packedFileBytes);
+
+		json.BeginObject("maxError");
+		json.Value("position", static_cast<double>(error.position));
+		json.Value("positionBound", static_cast<double>(error.positionBound));
+		json.Value("normalDegrees", static_cast<double>(error.normalDegrees));
+		json.Value("tangentDegrees", static_cast<double>(error.tangentDegrees));
+		json.Value("texC", static_cast<double>(error.texC));
+		json.EndObject();
+		json.EndObject();
+		return failedMeshes == 0;
+	}
+
+	// Position, normal, texture coordinates and tangent, the layout of a Float vertex
+	using FloatVertexValues = std::array<float, 11>;
+	static_assert(sizeof(FloatVertexValues) == BlackJawz::Scene::FloatVertexStride, "FloatVertexValues must match Float vertices");
+
+	BlackJawz::Scene::GeometryData MakeFloatGeometry(const std::vector<FloatVertexValues>& vertices)
+	{
+		std::vector<uint8_t> bytes(vertices.size() * sizeof(FloatVertexValues));
+		memcpy(bytes.data(), vertices.data(), bytes.size());
+
+		BlackJawz::Scene::GeometryData geometry;
+		geometry.vertexBufferStride = BlackJawz::Scene::FloatVertexStride;
+		geometry.vertexBuffer = BlackJawz::Scene::Blob::FromVector(std::move(bytes));
+		return geometry;
+	}
+
+	// Degrees between the direction a vector was packed from and the unit vector it decoded to, in
+	// double precision and scaled first so no length overflows. Vectors without a direction must
+	// decode to +Z.
+	double GetDirectionErrorDegrees(const float expected[3], const float decoded[3])
+	{
+		double largest = std::max({ std::abs(static_cast<double>(expected[0])), std::abs(static_cast<double>(expected[1])),
+			std::abs(static_cast<double>(expected[2])) });
+
+		double direction[3] = { 0.0, 0.0, 1.0 };
+		if (largest > 0.0 && std::isfinite(largest) && !std::isnan(expected[0] + expected[1] + expected[2]))
+		{
+			for (size_t axis = 0; axis < 3; ++axis)
+			{
+				direction[axis] = expected[axis] / largest;
+			}
+		}
+
+		double length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+		double decodedLength = std::sqrt(static_cast<double>(decoded[0]) * decoded[0] + static_cast<double>(decoded[1]) * decoded[1] +
+			static_cast<double>(decoded[2]) * decoded[2]);
+		if (!(std::abs(decodedLength - 1.0) <= 1.0e-5))
+			return 180.0;
+
+		double cross[3] =
+		{
+			direction[1] * decoded[2] - direction[2] * decoded[1],
+			direction[2] * decoded[0] - direction[0] * decoded[2],
+			direction[0] * decoded[1] - direction[1] * decoded[0]
+		};
+		double sine = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]) / length;
+		double cosine = (direction[0] * decoded[0] + direction[1] * decoded[1] + direction[2] * decoded[2]) / length;
+		return std::atan2(sine, cosine) * 57.29577951308232;
+	}
+
+	// Packs and unpacks the vertices, returns how many came back further off than the tolerances.
+	// Texture coordinates must keep a half float's precision.
+	size_t CountPackingFailures(const char* name, const std::vector<FloatVertexValues>& vertices)
+	{
+		using namespace BlackJawz;
+
+		Scene::GeometryData original = MakeFloatGeometry(vertices);
+		Scene::GeometryData packed = original;
+		bool roundTripped = Scene::PackVertices(packed);
+
+		Scene::GeometryData unpacked = packed;
+		roundTripped = roundTripped && Scene::UnpackVertices(unpacked) && unpacked.vertexBuffer.size == original.vertexBuffer.size;
+		if (!roundTripped)
+		{
+			fprintf(stderr, "Vertex packing %s: did not round trip\n", name);
+			return vertices.size();
+		}
+
+		Scene::PackingError error = Scene::MeasurePackingError(original, packed);
+		bool within = IsPackingErrorWithin(error, GetPositionTolerance(*packed.bounds, error.positionBound));
+
+		size_t failures = 0;
+		for (size_t i = 0; i < vertices.size(); ++i)
+		{
+			FloatVertexValues decoded;
+			memcpy(decoded.data(), unpacked.vertexBuffer.data + i * sizeof(decoded), sizeof(decoded));
+
+			bool vertexWithin = within;
+			for (size_t axis = 6; axis < 8; ++axis)
+			{
+				float tolerance = std::abs(vertices[i][axis]) * std::ldexp(1.0f, -11) + std::ldexp(1.0f, -25);
+				vertexWithin = vertexWithin && std::abs(decoded[axis] - vertices[i][axis]) <= tolerance;
+			}
+			for (size_t first : { 3, 8 })
+			{
+				vertexWithin = vertexWithin && GetDirectionErrorDegrees(&vertices[i][first], &decoded[first]) <= PackedAngleToleranceDegrees;
+			}
+
+			if (!vertexWithin)
+			{
+				fprintf(stderr, "Vertex packing %s: vertex %zu is off, position %g (bound %g), normal %g, tangent %g degrees\n",
+					name, i, error.position, error.positionBound, error.normalDegrees, error.tangentDegrees);
+				++failures;
+			}
+		}
+		return failures;
+	}
+
+	// Round trips vertices at the edges of the packed format, and checks that texture coordinates a
+	// half float cannot hold leave the geometry unpacked
+	bool CheckVertexPacking(BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		constexpr float Infinity = std::numeric_limits<float>::infinity();
+		constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+
+		struct PackingCase
+		{
+			const char* name;
+			std::vector<FloatVertexValues> vertices;
+		};
+
+		std::vector<PackingCase> cases =
+		{
+			{ "flat", {
+				{ -5.0f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+				{ 5.0f, 0.0f, -5.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+				{ -5.0f, 0.0f, 5.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f },
+				{ 1.25f, 0.0f, 3.7f, 0.0f, 1.0f, 0.0f, 0.6f, 0.13f, 1.0f, 0.0f, 0.0f } } },
+			{ "point", {
+				{ 3.0f, -2.0f, 7.0f, 0.0f, 0.0f, 1.0f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f },
+				{ 3.0f, -2.0f, 7.0f, 0.0f, 0.0f, -1.0f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f } } },
+			{ "axis normals", {
+				{ 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f },
+				{ -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0f },
+				{ 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+				{ 0.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f },
+				{ 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f },
+				{ 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, -1.0f, 0.0f },
+				{ 0.5f, 0.5f, 0.5f, 0.70710678f, 0.0f, -0.70710678f, 0.0f, 0.0f, 0.0f, 0.70710678f, 0.70710678f } } },
+			{ "degenerate normals", {
+				{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+				{ 1.0f, 1.0f, 1.0f, 1.0e-20f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0e-20f, 0.0f },
+				{ 2.0f, 2.0f, 2.0f, 1.0e30f, 1.0e30f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, -1.0e30f },
+				{ 2.5f, 2.5f, 2.5f, 0.0f, -1.0e-30f, 1.0e-30f, 0.0f, 0.0f, 3.0e38f, 3.0e38f, 3.0e38f },
+				{ 3.0f, 3.0f, 3.0f, 250.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 3.0e-3f, 4.0e-3f },
+				{ 4.0f, 4.0f, 4.0f, NaN, 0.0f, 0.0f, 0.0f, 0.0f, Infinity, 0.0f, 0.0f } } },
+			{ "texture coordinate range", {
+				{ 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 65504.0f, -65504.0f, 1.0f, 0.0f, 0.0f },
+				{ 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1000.37f, -0.5f, 1.0f, 0.0f, 0.0f },
+				{ 2.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0e-6f, -3.0e-8f, 1.0f, 0.0f, 0.0f },
+				{ 3.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, -0.0f, 0.33333334f, 1.0f, 0.0f, 0.0f } } },
+			{ "far from the origin", {
+				{ 10000.0f, -20000.0f, 5000.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+				{ 10000.001f, -19999.5f, 5000.25f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f } } }
+		};
+
+		size_t vertexCount = 0;
+		size_t failures = 0;
+		for (const PackingCase& packingCase : cases)
+		{
+			vertexCount += packingCase.vertices.size();
+			failures += CountPackingFailures(packingCase.name, packingCase.vertices);
+		}
+
+		// Out of the half float range, packing must refuse rather than store infinities
+		size_t refusedCount = 0;
+		for (float texC : { 65520.0f, -70000.0f, Infinity, NaN })
+		{
+			Scene::GeometryData geometry = MakeFloatGeometry({ { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.5f, texC, 1.0f, 0.0f, 0.0f } });
+			const uint8_t* vertices = geometry.vertexBuffer.data;
+			if (Scene::PackVertices(geometry) || geometry.vertexFormat != Scene::VertexFormat::Float || geometry.vertexBuffer.data != vertices)
+			{
+				fprintf(stderr, "Vertex packing: texture coordinate %g was packed\n", texC);
+				++failures;
+			}
+			++refusedCount;
+		}
+
+		json.BeginObject("vertexPackingChecks");
+		json.Value("cases", static_cast<uint64_t>(cases.size() + refusedCount));
+		json.Value("vertices", static_cast<uint64_t>(vertexCount));
+		json.Value("angleToleranceDegrees", static_cast<double>(PackedAngleToleranceDegrees));
+		json.Value("failures", static_cast<uint64_t>(failures));
+		json.EndObject();
+		return failures == 0;
+	}
+
+	// DirectXTex's task executor overloads must give exactly the bytes of its serial ones
+	bool CheckTaskExecutor(BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		Jobs::JobSystem jobSystem;
+		std::vector<Tools::TaskExecutorCheck> checks = Tools::CheckTaskExecutor(jobSystem);
+
+		size_t failures = 0;
+		json.BeginObject("taskExecutorChecks");
+		json.BeginArray("operations");
+		for (const Tools::TaskExecutorCheck& check : checks)
+		{
+			if (!check.succeeded || check.mismatchedBytes > 0)
+			{
+				fprintf(stderr, "Task executor: %s %s\n", check.name.c_str(),
+					check.succeeded ? "differs from the serial result" : "failed");
+				++failures;
+			}
+
+			json.BeginObject();
+			json.Value("name", check.name);
+			json.Value("bytes", check.bytes);
+			json.Value("mismatchedBytes", check.mismatchedBytes);
+			json.Value("serialMs", check.serialMs);
+			json.Value("executorMs", check.executorMs);
+			json.EndObject();
+		}
+		json.EndArray();
+		json.Value("failures", static_cast<uint64_t>(failures));
+		json.EndObject();
+		return !checks.empty() && failures == 0;
+	}
+
+	bool RunCase(const BenchmarkOptions& options, size_t entityCount, size_t textureSetCount, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		BlackJawz::Tools::GeneratorOptions generatorOptions;
+		generatorOptions.entityCount = entityCount;
+		generatorOptions.textureSetCount = textureSetCount;
+		generatorOptions.textureSize = options.textureSize;
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<Scene::EntityData> entities = BlackJawz::Tools::GenerateScene(generatorOptions);
+		double generateMs = ElapsedMs(start);
+
+		fprintf(stderr, "%zu entities, %zu texture sets\n", entityCount, textureSetCount);
+
+		json.BeginObject();
+		json.Value("entities", static_cast<uint64_t>(entityCount));
+		json.Value("textureSets", static_cast<uint64_t>(textureSetCount));
+		json.Value("generateMs", generateMs);
+
+		Jobs::JobSystem jobSystem;
+		std::string compressedFile;
+
+		// Saves store every mesh's bounds, as the editor's do
+		Scene::ComputeMissingBounds(entities, jobSystem);
+
+		// What loading a file without an index spends building one
+		std::vector<double> indexBuildMs;
+		size_t indexNodeCount = 0;
+		for (uint32_t i = 0; i < options.iterations; ++i)
+		{
+			Scene::SpatialIndex spatialIndex;
+			start = std::chrono::steady_clock::now();
+			spatialIndex.Build(entities, jobSystem);
+			indexBuildMs.push_back(ElapsedMs(start));
+			indexNodeCount = spatialIndex.GetNodeCount();
+		}
+		json.BeginObject("spatialIndex");
+		json.Value("nodes", static_cast<uint64_t>(indexNodeCount));
+		json.Value("buildMs", Median(indexBuildMs));
+		json.EndObject();
+
+		json.BeginArray("variants");
+		for (bool compress : { false, true })
+		{
+			std::string filename = (std::filesystem::path(options.directory) /
+				("bench_" + std::to_string(entityCount) + "_" + std::to_string(textureSetCount) + (compress ? "_lz" : "") + ".bin")).string();
+
+			// Save
+			std::vector<double> saveMs;
+			uint64_t fileBytes = 0, rawAssetBytes = 0, storedAssetBytes = 0;
+			ResetPeakMemory();
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				start = std::chrono::steady_clock::now();
+				fileBytes = SaveScene(entities, filename, compress, jobSystem, rawAssetBytes, storedAssetBytes);
+				saveMs.push_back(ElapsedMs(start));
+				if (fileBytes == 0)
+				{
+					fprintf(stderr, "Failed to write %s\n", filename.c_str());
+					return false;
+				}
+			}
+			uint64_t savePeakMemory = GetPeakMemory();
+
+			// Cold load first, then warm loads with the file in the page cache
+			bool cacheDropped = DropFileCache(filename);
+			ResetPeakMemory();
+			LoadResult coldLoad = LoadScene(filename, jobSystem);
+			uint64_t loadPeakMemory = GetPeakMemory();
+
+			std::vector<double> warmMs;
+			LoadResult warmLoad;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				warmLoad = LoadScene(filename, jobSystem);
+				warmMs.push_back(warmLoad.ms);
+			}
+
+			// What verification costs, for deciding whether trusted files should skip it
+			std::vector<double> unverifiedMs;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				unverifiedMs.push_back(LoadScene(filename, jobSystem, false).ms);
+			}
+
+			// The same file through the editor's frame loop, entities are inserted as their ranges decode
+			std::vector<double> incrementalMs, firstEntityMs;
+			IncrementalLoadResult incrementalLoad;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				incrementalLoad = LoadSceneIncrementally(filename, jobSystem);
+				incrementalMs.push_back(incrementalLoad.ms);
+				firstEntityMs.push_back(incrementalLoad.firstEntityMs);
+			}
+
+			if (!coldLoad.loaded || !warmLoad.loaded || !incrementalLoad.loaded)
+			{
+				fprintf(stderr, "Failed to load %s\n", filename.c_str());
+				return false;
+			}
+
+			Scene::Blob fileData;
+			Scene::SceneReader::ReadFile(filename, fileData);
+			std::vector<double> parseMs;
+			size_t parsedCount = 0;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				start = std::chrono::steady_clock::now();
+				parsedCount = ParseScene(fileData);
+				parseMs.push_back(ElapsedMs(start));
+			}
+
+			json.BeginObject();
+			json.Value("compressed", compress);
+			json.Value("fileBytes", fileBytes);
+			json.Value("rawAssetBytes", rawAssetBytes);
+			json.Value("storedAssetBytes", storedAssetBytes);
+
+			json.BeginObject("save");
+			json.Value("medianMs", Median(saveMs));
+			json.Value("minMs", *std::min_element(saveMs.begin(), saveMs.end()));
+			json.Value("peakMemoryBytes", savePeakMemory);
+			json.EndObject();
+
+			json.BeginObject("coldLoad");
+			json.Value("cacheDropped", cacheDropped);
+			json.Value("ms", coldLoad.ms);
+			json.Value("peakMemoryBytes", loadPeakMemory);
+			WriteLoadStats(json, coldLoad.stats);
+			json.EndObject();
+
+			json.BeginObject("warmLoad");
+			json.Value("medianMs", Median(warmMs));
+			json.Value("minMs", *std::min_element(warmMs.begin(), warmMs.end()));
+			json.Value("mbPerSecond", Median(warmMs) > 0.0 ? fileBytes / (1024.0 * 1024.0) / (Median(warmMs) / 1000.0) : 0.0);
+			json.Value("uploads", static_cast<uint64_t>(warmLoad.createdCount));
+			WriteLoadStats(json, warmLoad.stats);
+			json.EndObject();
+
+			json.BeginObject("incrementalLoad");
+			json.Value("medianMs", Median(incrementalMs));
+			json.Value("blockingMedianMs", Median(warmMs));
+			json.Value("firstEntityMs", Median(firstEntityMs));
+			json.Value("frames", static_cast<uint64_t>(incrementalLoad.frames));
+			json.EndObject();
+
+			json.BeginObject("unverifiedLoad");
+			json.Value("medianMs", Median(unverifiedMs));
+			json.Value("verifyOverhead", Median(unverifiedMs) > 0.0 ? Median(warmMs) / Median(unverifiedMs) - 1.0 : 0.0);
+			json.EndObject();
+
+			json.BeginObject("parse");
+			json.Value("medianMs", Median(parseMs));
+			json.Value("entities", static_cast<uint64_t>(parsedCount));
+			json.EndObject();
+
+			json.EndObject();
+
+			if (compress)
+				compressedFile = filename;
+			else
+				std::filesystem::remove(filename);
+		}
+		json.EndArray();
+
+		// How the warm load of the compressed file scales with workers
+		json.BeginArray("loadScaling");
+		for (uint32_t threadCount : options.threadCounts)
+		{
+			// The loading thread helps while it waits, so it counts as one of the threads
+			Jobs::JobSystem scalingJobSystem(threadCount > 1 ? threadCount - 1 : 1);
+
+			std::vector<double> loadMs;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				loadMs.push_back(LoadScene(compressedFile, scalingJobSystem).ms);
+			}
+
+			json.BeginObject();
+			json.Value("threads", static_cast<uint64_t>(threadCount));
+			json.Value("medianMs", Median(loadMs));
+			json.EndObject();
+		}
+		json.EndArray();
+
+		std::filesystem::remove(compressedFile);
+
+		bool packingPassed = MeasureVertexPacking(entities, (std::filesystem::path(options.directory) /
+			("bench_" + std::to_string(entityCount) + "_" + std::to_string(textureSetCount) + "_packed.bin")).string(), jobSystem, json);
+
+		json.EndObject();
+		return packingPassed;
+	}
+
+	struct InstancingVariant
+	{
+		double saveMs = 0.0;
+		double loadMs = 0.0;
+		uint64_t fileBytes = 0;
+	};
+
+	bool MeasureInstancingVariant(const std::vector<BlackJawz::Scene::EntityData>& entities, const std::string& filename,
+		uint32_t iterations, BlackJawz::Jobs::JobSystem& jobSystem, InstancingVariant& result)
+	{
+		std::vector<double> saveMs, loadMs;
+		uint64_t rawAssetBytes = 0, storedAssetBytes = 0;
+		for (uint32_t i = 0; i < iterations; ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+			result.fileBytes = SaveScene(entities, filename, true, jobSystem, rawAssetBytes, storedAssetBytes);
+			saveMs.push_back(ElapsedMs(start));
+			if (result.fileBytes == 0)
+			{
+				fprintf(stderr, "Failed to write %s\n", filename.c_str());
+				return false;
+			}
+		}
+
+		for (uint32_t i = 0; i < iterations; ++i)
+		{
+			LoadResult load = LoadScene(filename, jobSystem);
+			if (!load.loaded)
+			{
+				fprintf(stderr, "Failed to load %s\n", filename.c_str());
+				return false;
+			}
+			loadMs.push_back(load.ms);
+		}
+
+		std::filesystem::remove(filename);
+		result.saveMs = Median(saveMs);
+		result.loadMs = Median(loadMs);
+		return true;
+	}
+
+	// The same number of cubes stored once as one entity each and once as instance sets
+	bool MeasureInstancing(const BenchmarkOptions& options, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		const size_t instancesPerEntity = 1000;
+
+		Tools::GeneratorOptions generatorOptions;
+		generatorOptions.entityCount = options.instanceCount;
+		generatorOptions.textureSetCount = 1;
+		generatorOptions.textureSize = options.textureSize;
+		generatorOptions.lightFraction = 0.0f;
+		std::vector<Scene::EntityData> entities = Tools::GenerateScene(generatorOptions);
+
+		generatorOptions.entityCount = (options.instanceCount + instancesPerEntity - 1) / instancesPerEntity;
+		generatorOptions.instancesPerEntity = instancesPerEntity;
+		std::vector<Scene::EntityData> instanced = Tools::GenerateScene(generatorOptions);
+
+		fprintf(stderr, "%zu instances\n", options.instanceCount);
+
+		Jobs::JobSystem jobSystem;
+		InstancingVariant perEntity, perInstance;
+		if (!MeasureInstancingVariant(entities, (std::filesystem::path(options.directory) / "bench_entities.bin").string(),
+				options.iterations, jobSystem, perEntity) ||
+			!MeasureInstancingVariant(instanced, (std::filesystem::path(options.directory) / "bench_instances.bin").string(),
+				options.iterations, jobSystem, perInstance))
+		{
+			return false;
+		}
+
+		json.BeginObject("instancing");
+		json.Value("objects", static_cast<uint64_t>(options.instanceCount));
+		json.Value("instancesPerEntity", static_cast<uint64_t>(instancesPerEntity));
+		for (const auto& variant : { std::make_pair("entities", perEntity), std::make_pair("instances", perInstance) })
+		{
+			json.BeginObject(variant.first);
+			json.Value("saveMs", variant.second.saveMs);
+			json.Value("loadMs", variant.second.loadMs);
+			json.Value("fileBytes", variant.second.fileBytes);
+			json.EndObject();
+		}
+		json.Value("saveRatio", perEntity.saveMs > 0.0 ? perInstance.saveMs / perEntity.saveMs : 0.0);
+		json.Value("loadRatio", perEntity.loadMs > 0.0 ? perInstance.loadMs / perEntity.loadMs : 0.0);
+		json.EndObject();
+		return true;
+	}
+
+	// Block compression of generated texture sets through DirectXTex's serial compressor and through
+	// the job system at each thread count, the textures get their mips first like in the cooker
+	bool MeasureTextureCompression(const BenchmarkOptions& options, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		Tools::GeneratorOptions generatorOptions;
+		generatorOptions.entityCount = options.compressTextureSets * 4;
+		generatorOptions.textureSetCount = options.compressTextureSets;
+		generatorOptions.textureSize = options.textureSize;
+		generatorOptions.lightFraction = 0.0f;
+		std::vector<Scene::EntityData> entities = Tools::GenerateScene(generatorOptions);
+
+		std::vector<Scene::Blob> textures;
+		std::vector<Tools::TextureRole> roles;
+		std::unordered_map<const uint8_t*, size_t> indices;
+		for (const Scene::EntityData& entity : entities)
+		{
+			if (!entity.appearance)
+				continue;
+
+			for (size_t slot = 0; slot < Scene::TextureSlotCount; ++slot)
+			{
+				const Scene::Blob& texture = entity.appearance->textures[slot];
+				if (texture.Empty() || !indices.emplace(texture.data, textures.size()).second)
+					continue;
+
+				Scene::Blob withMips = Tools::GenerateTextureMips(texture);
+				textures.push_back(withMips.Empty() ? texture : withMips);
+				roles.push_back(Tools::GetTextureRole(static_cast<Scene::TextureSlot>(slot)));
+			}
+		}
+
+		fprintf(stderr, "%zu textures block compressed\n", textures.size());
+
+		std::vector<double> serialMs;
+		Tools::TextureCompressStats serialStats;
+		for (uint32_t i = 0; i < options.iterations; ++i)
+		{
+			auto start = std::chrono::steady_clock::now();
+			Tools::CompressTexturesSerial(textures, roles, options.compressionPreset, serialStats);
+			serialMs.push_back(ElapsedMs(start));
+		}
+
+		json.BeginObject("textureCompression");
+		json.Value("preset", std::string(options.compressionPreset == Tools::CompressionPreset::Quality ? "quality" : "fast"));
+		json.Value("textures", static_cast<uint64_t>(textures.size()));
+		json.Value("inputBytes", serialStats.inputBytes);
+		json.Value("outputBytes", serialStats.outputBytes);
+		json.Value("serialMs", Median(serialMs));
+
+		json.BeginArray("threads");
+		for (uint32_t threads : options.threadCounts)
+		{
+			// The calling thread helps while waiting, so it counts as a worker
+			Jobs::JobSystem jobSystem(threads > 1 ? threads - 1 : 1);
+
+			std::vector<double> parallelMs;
+			Tools::TextureCompressStats stats;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				auto start = std::chrono::steady_clock::now();
+				Tools::CompressTextures(textures, roles, options.compressionPreset, jobSystem, stats);
+				parallelMs.push_back(ElapsedMs(start));
+			}
+
+			double ms = Median(parallelMs);
+			json.BeginObject();
+			json.Value("threads", static_cast<uint64_t>(threads));
+			json.Value("blockJobs", static_cast<uint64_t>(stats.blockJobs));
+			json.Value("ms", ms);
+			json.Value("speedup", ms > 0.0 ? Median(serialMs) / ms : 0.0);
+			json.EndObject();
+		}
+		json.EndArray();
+		json.EndObject();
+		return serialStats.texturesCompressed == textures.size();
+	}
+
+	// Cold and warm loads of one large texture saved as DDS, HDR and TGA, through DirectXTex's file loaders
+	bool MeasureTextureLoads(const BenchmarkOptions& options, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		Tools::GeneratorOptions generatorOptions;
+		generatorOptions.entityCount = 1;
+		generatorOptions.textureSetCount = 1;
+		generatorOptions.textureSize = options.loadTextureSize;
+		generatorOptions.lightFraction = 0.0f;
+		std::vector<Scene::EntityData> entities = Tools::GenerateScene(generatorOptions);
+		if (entities.empty() || !entities[0].appearance)
+			return false;
+
+		const Scene::Blob& texture = entities[0].appearance->textures[0];
+
+		struct FileType
+		{
+			Tools::TextureFileType type;
+			const char* name;
+		};
+		const FileType fileTypes[] =
+		{
+			{ Tools::TextureFileType::DDS, "dds" },
+			{ Tools::TextureFileType::HDR, "hdr" },
+			{ Tools::TextureFileType::TGA, "tga" }
+		};
+
+		bool succeeded = true;
+		json.BeginObject("textureLoads");
+		json.Value("textureSize", static_cast<uint64_t>(options.loadTextureSize));
+		json.BeginArray("files");
+		for (const FileType& fileType : fileTypes)
+		{
+			std::string filename = (std::filesystem::path(options.directory) / (std::string("TextureLoad.") + fileType.name)).string();
+			if (!Tools::SaveTextureFile(texture, fileType.type, filename))
+			{
+				fprintf(stderr, "Failed to write %s\n", filename.c_str());
+				succeeded = false;
+				continue;
+			}
+
+			std::error_code error;
+			json.BeginObject();
+			json.Value("type", std::string(fileType.name));
+			json.Value("fileBytes", static_cast<uint64_t>(std::filesystem::file_size(filename, error)));
+
+			std::vector<double> coldMs;
+			std::vector<double> warmMs;
+			uint64_t decodedBytes = 0;
+			bool dropped = true;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				dropped = DropFileCache(filename) && dropped;
+				auto start = std::chrono::steady_clock::now();
+				decodedBytes = Tools::LoadTextureFile(filename, fileType.type);
+				coldMs.push_back(ElapsedMs(start));
+			}
+
+			// The last cold load left the file in the page cache
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				auto start = std::chrono::steady_clock::now();
+				decodedBytes = Tools::LoadTextureFile(filename, fileType.type);
+				warmMs.push_back(ElapsedMs(start));
+			}
+
+			succeeded = decodedBytes > 0 && succeeded;
+
+			double warm = Median(warmMs);
+			json.Value("decodedBytes", decodedBytes);
+			json.Value("cacheDropped", dropped);
+			json.Value("coldMs", Median(coldMs));
+			json.Value("warmMs", warm);
+			json.Value("warmMBps", warm > 0.0 ? static_cast<double>(decodedBytes) / (warm * 1000.0) : 0.0);
+			json.EndObject();
+			std::filesystem::remove(filename, error);
+		}
+		json.EndArray();
+		json.EndObject();
+		return succeeded;
+	}
+
+	// Depths of rounded bricks with rivets on them, a displacement map with steep edges and flat tops
+	std::vector<float> MakeDepthMap(uint32_t size)
+	{
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		uint32_t brickSize = std::max(8u, size / 8);
+		std::vector<float> depths(static_cast<size_t>(size) * size);
+		for (uint32_t y = 0; y < size; ++y)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				// Every other row of bricks is offset by half a brick
+				uint32_t offset = (y / brickSize) % 2 ? brickSize / 2 : 0;
+				float u = static_cast<float>((x + offset) % brickSize) / brickSize;
+				float v = static_cast<float>(y % brickSize) / brickSize;
+				float edge = std::min({ u, 1.0f - u, v, 1.0f - v }) * 8.0f;
+				depths[static_cast<size_t>(y) * size + x] = 1.0f - 0.7f * std::min(edge, 1.0f);
+			}
+		}
+
+		uint32_t rivetCount = size / 4;
+		float rivetRadius = brickSize / 10.0f;
+		for (uint32_t i = 0; i < rivetCount; ++i)
+		{
+			float cx = unit(random) * size;
+			float cy = unit(random) * size;
+			for (int32_t dy = -static_cast<int32_t>(rivetRadius); dy <= static_cast<int32_t>(rivetRadius); ++dy)
+			{
+				for (int32_t dx = -static_cast<int32_t>(rivetRadius); dx <= static_cast<int32_t>(rivetRadius); ++dx)
+				{
+					float distance = std::sqrt(static_cast<float>(dx * dx + dy * dy)) / rivetRadius;
+					if (distance > 1.0f)
+						continue;
+
+					uint32_t x = static_cast<uint32_t>(static_cast<int32_t>(cx) + dx + size) % size;
+					uint32_t y = static_cast<uint32_t>(static_cast<int32_t>(cy) + dy + size) % size;
+					float& depth = depths[static_cast<size_t>(y) * size + x];
+					depth = std::min(depth, depth - 0.3f * std::sqrt(1.0f - distance * distance));
+				}
+			}
+		}
+
+		// Quantized the way an 8 bit displacement map holds them
+		for (float& depth : depths)
+		{
+			depth = std::round(std::clamp(depth, 0.0f, 1.0f) * 255.0f) / 255.0f;
+		}
+		return depths;
+	}
+
+	// What the GBuffer shader samples from an encoded cone step map, bilinear and wrapped
+	struct ConeStepTexture
+	{
+		uint32_t size = 0;
+		std::vector<float> depths;
+		std::vector<float> ratios;
+
+		float Sample(const std::vector<float>& values, float u, float v) const
+		{
+			float x = u * size - 0.5f;
+			float y = v * size - 0.5f;
+			float x0 = std::floor(x);
+			float y0 = std::floor(y);
+			float fx = x - x0;
+			float fy = y - y0;
+			auto at = [&](float tx, float ty)
+				{
+					int32_t n = static_cast<int32_t>(size);
+					int32_t ix = ((static_cast<int32_t>(tx) % n) + n) % n;
+					int32_t iy = ((static_cast<int32_t>(ty) % n) + n) % n;
+					return values[static_cast<size_t>(iy) * size + ix];
+				};
+			float upper = at(x0, y0) + (at(x0 + 1, y0) - at(x0, y0)) * fx;
+			float lower = at(x0, y0 + 1) + (at(x0 + 1, y0 + 1) - at(x0, y0 + 1)) * fx;
+			return upper + (lower - upper) * fy;
+		}
+	};
+
+	constexpr float ParallaxHeightScale = 0.02f; // GBufferPixelShader's heightScale
+	constexpr float ConeStepConverged = 0.5f / 255.0f; // coneStepConverged
+
+	struct ParallaxTrace
+	{
+		float u = 0.0f;
+		float v = 0.0f;
+		uint32_t samples = 0;
+	};
+
+	// The shader's ParallaxOcclusionMapping: 8 to 64 layers by view angle, then 5 refinement steps
+	ParallaxTrace TraceLayers(const ConeStepTexture& texture, float u, float v, const float view[3])
+	{
+		ParallaxTrace trace;
+		float numLayers = 64.0f + (8.0f - 64.0f) * std::fabs(view[2]);
+		float layerDepth = 1.0f / numLayers;
+		float deltaU = view[0] * ParallaxHeightScale / view[2] / numLayers;
+		float deltaV = view[1] * ParallaxHeightScale / view[2] / numLayers;
+
+		float currentU = u;
+		float currentV = v;
+		float currentLayerDepth = 0.0f;
+		trace.samples = 1; // The shader samples the start as well, and never uses it
+
+		float prevU = currentU;
+		float prevV = currentV;
+		float prevLayerDepth = 0.0f;
+		for (int i = 0; i < 64 && i < static_cast<int>(numLayers); ++i)
+		{
+			prevU = currentU;
+			prevV = currentV;
+			prevLayerDepth = currentLayerDepth;
+			currentU -= deltaU;
+			currentV -= deltaV;
+			currentLayerDepth += layerDepth;
+			++trace.samples;
+			if (currentLayerDepth > texture.Sample(texture.depths, currentU, currentV))
+				break;
+		}
+
+		for (int j = 0; j < 5; ++j)
+		{
+			float midU = (currentU + prevU) * 0.5f;
+			float midV = (currentV + prevV) * 0.5f;
+			float midLayerDepth = (currentLayerDepth + prevLayerDepth) * 0.5f;
+			++trace.samples;
+			if (midLayerDepth > texture.Sample(texture.depths, midU, midV))
+			{
+				currentU = midU;
+				currentV = midV;
+				currentLayerDepth = midLayerDepth;
+			}
+			else
+			{
+				prevU = midU;
+				prevV = midV;
+				prevLayerDepth = midLayerDepth;
+			}
+		}
+
+		trace.u = currentU;
+		trace.v = currentV;
+		return trace;
+	}
+
+	// The shader's ConeStepMapping: up to 12 cone steps, then 5 refinement steps when the ray stepped past the surface
+	ParallaxTrace TraceCones(const ConeStepTexture& texture, float u, float v, const float view[3])
+	{
+		ParallaxTrace trace;
+		float ray[3] = { -view[0] * ParallaxHeightScale / view[2], -view[1] * ParallaxHeightScale / view[2], 1.0f };
+		float rayRatio = std::sqrt(ray[0] * ray[0] + ray[1] * ray[1]);
+
+		float position[3] = { u, v, 0.0f };
+		float prevPosition[3] = { u, v, 0.0f };
+		bool crossed = false;
+		for (int i = 0; i < 12; ++i)
+		{
+			++trace.samples;
+			float depthBelow = texture.Sample(texture.depths, position[0], position[1]) - position[2];
+			crossed = depthBelow <= 0.0f;
+			if (depthBelow < ConeStepConverged)
+				break;
+
+			float coneRatio = texture.Sample(texture.ratios, position[0], position[1]);
+			float step = coneRatio * depthBelow / (rayRatio + coneRatio);
+			for (int axis = 0; axis < 3; ++axis)
+			{
+				prevPosition[axis] = position[axis];
+				position[axis] += ray[axis] * step;
+			}
+		}
+
+		for (int j = 0; j < 5 && crossed; ++j)
+		{
+			float mid[3] = { (prevPosition[0] + position[0]) * 0.5f, (prevPosition[1] + position[1]) * 0.5f, (prevPosition[2] + position[2]) * 0.5f };
+			++trace.samples;
+			float* replaced = mid[2] > texture.Sample(texture.depths, mid[0], mid[1]) ? position : prevPosition;
+			std::copy(mid, mid + 3, replaced);
+		}
+
+		trace.u = position[0];
+		trace.v = position[1];
+		return trace;
+	}
+
+	// The first crossing, marched in steps far finer than a texel and then bisected
+	ParallaxTrace TraceReference(const ConeStepTexture& texture, float u, float v, const float view[3])
+	{
+		const int steps = 4096;
+		float rayU = -view[0] * ParallaxHeightScale / view[2];
+		float rayV = -view[1] * ParallaxHeightScale / view[2];
+
+		float above = 0.0f;
+		float below = 1.0f;
+		for (int i = 1; i <= steps; ++i)
+		{
+			float depth = static_cast<float>(i) / steps;
+			if (depth > texture.Sample(texture.depths, u + rayU * depth, v + rayV * depth))
+			{
+				below = depth;
+				break;
+			}
+			above = depth;
+		}
+
+		for (int j = 0; j < 24; ++j)
+		{
+			float mid = (above + below) * 0.5f;
+			(mid > texture.Sample(texture.depths, u + rayU * mid, v + rayV * mid) ? below : above) = mid;
+		}
+
+		ParallaxTrace trace;
+		trace.u = u + rayU * below;
+		trace.v = v + rayV * below;
+		return trace;
+	}
+
+	// Relaxed cone step maps: the generator checked against the exhaustive reference on a small map,
+	// its time serially and on the job system at each thread count, and the parallax shader's two
+	// marches replayed on the CPU against a reference intersection, by samples taken and error
+	bool MeasureConeStepMaps(const BenchmarkOptions& options, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		const uint32_t referenceSize = 64;
+		const uint32_t referenceRadius = 16;
+		std::vector<float> referenceDepths = MakeDepthMap(referenceSize);
+		auto start = std::chrono::steady_clock::now();
+		std::vector<float> expected = Tools::GenerateConeRatiosReference(referenceDepths, referenceSize, referenceSize, referenceRadius);
+		double referenceMs = ElapsedMs(start);
+		start = std::chrono::steady_clock::now();
+		std::vector<float> generated = Tools::GenerateConeRatios(referenceDepths, referenceSize, referenceSize, referenceRadius);
+		double generatedMs = ElapsedMs(start);
+
+		size_t mismatches = 0;
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			mismatches += generated[i] != expected[i] ? 1 : 0;
+		}
+
+		json.BeginObject("coneStepMaps");
+		json.BeginObject("reference");
+		json.Value("size", static_cast<uint64_t>(referenceSize));
+		json.Value("searchRadius", static_cast<uint64_t>(referenceRadius));
+		json.Value("referenceMs", referenceMs);
+		json.Value("ms", generatedMs);
+		json.Value("mismatches", static_cast<uint64_t>(mismatches));
+		json.EndObject();
+
+		uint32_t size = options.coneMapSize;
+		std::vector<float> depths = MakeDepthMap(size);
+		std::vector<float> ratios;
+
+		std::vector<double> serialMs;
+		for (uint32_t i = 0; i < options.iterations; ++i)
+		{
+			start = std::chrono::steady_clock::now();
+			ratios = Tools::GenerateConeRatios(depths, size, size);
+			serialMs.push_back(ElapsedMs(start));
+		}
+
+		json.Value("size", static_cast<uint64_t>(size));
+		json.Value("searchRadius", static_cast<uint64_t>(Tools::DefaultConeSearchRadius));
+		json.Value("serialMs", Median(serialMs));
+
+		json.BeginArray("threads");
+		for (uint32_t threads : options.threadCounts)
+		{
+			Jobs::JobSystem jobSystem(threads > 1 ? threads - 1 : 1);
+
+			std::vector<double> parallelMs;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				start = std::chrono::steady_clock::now();
+				std::vector<float> parallel = Tools::GenerateConeRatios(depths, size, size, Tools::DefaultConeSearchRadius, &jobSystem);
+				parallelMs.push_back(ElapsedMs(start));
+				mismatches += parallel != ratios ? 1 : 0; // Rows are independent, any thread count gives the same map
+			}
+
+			double ms = Median(parallelMs);
+			json.BeginObject();
+			json.Value("threads", static_cast<uint64_t>(threads));
+			json.Value("ms", ms);
+			json.Value("speedup", ms > 0.0 ? Median(serialMs) / ms : 0.0);
+			json.EndObject();
+		}
+		json.EndArray();
+
+		// Replayed on what the shader reads back, quantized depths and ratios
+		std::vector<uint8_t> texels = Tools::EncodeConeStepMap(depths, ratios);
+		ConeStepTexture texture;
+		texture.size = size;
+		texture.depths.resize(depths.size());
+		texture.ratios.resize(depths.size());
+		for (size_t i = 0; i < depths.size(); ++i)
+		{
+			texture.depths[i] = texels[i * 2] / 255.0f;
+			texture.ratios[i] = Tools::DecodeConeRatio(texels[i * 2 + 1]);
+		}
+
+		struct MarchStats
+		{
+			const char* name;
+			uint64_t samples = 0;
+			double errorTexels = 0.0;
+			double maxErrorTexels = 0.0;
+		};
+		MarchStats marches[2] = { { "layers" }, { "cones" } };
+
+		// Views from straight down to 80 degrees off the normal
+		const uint32_t rayCount = 20000;
+		std::mt19937 random(11);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		for (uint32_t i = 0; i < rayCount; ++i)
+		{
+			float u = unit(random);
+			float v = unit(random);
+			float theta = unit(random) * 1.3963f;
+			float phi = unit(random) * 6.2832f;
+			float view[3] = { std::sin(theta) * std::cos(phi), std::sin(theta) * std::sin(phi), std::cos(theta) };
+
+			ParallaxTrace reference = TraceReference(texture, u, v, view);
+			ParallaxTrace traces[2] = { TraceLayers(texture, u, v, view), TraceCones(texture, u, v, view) };
+			for (int march = 0; march < 2; ++march)
+			{
+				double du = (traces[march].u - reference.u) * size;
+				double dv = (traces[march].v - reference.v) * size;
+				double error = std::sqrt(du * du + dv * dv);
+				marches[march].samples += traces[march].samples;
+				marches[march].errorTexels += error;
+				marches[march].maxErrorTexels = std::max(marches[march].maxErrorTexels, error);
+			}
+		}
+
+		json.BeginArray("marches");
+		for (const MarchStats& march : marches)
+		{
+			json.BeginObject();
+			json.Value("march", std::string(march.name));
+			json.Value("samplesPerPixel", static_cast<double>(march.samples) / rayCount);
+			json.Value("meanErrorTexels", march.errorTexels / rayCount);
+			json.Value("maxErrorTexels", march.maxErrorTexels);
+			json.EndObject();
+		}
+		json.EndArray();
+		json.EndObject();
+
+		if (mismatches > 0)
+		{
+			fprintf(stderr, "Cone step maps differ from the reference or between thread counts\n");
+		}
+		return mismatches == 0;
+	}
+
+	// Content of every mesh, imports on any number of threads have to agree on it
+	uint64_t HashModel(const BlackJawz::Scene::ImportedModel& model)
+	{
+		uint64_t hash = model.meshes.size();
+		for (const BlackJawz::Scene::ImportedMesh& mesh : model.meshes)
+		{
+			hash = hash * 31 + BlackJawz::Scene::SceneAssets::HashBytes(reinterpret_cast<const uint8_t*>(mesh.vertices.data()),
+				mesh.vertices.size() * sizeof(BlackJawz::Scene::ImportedVertex));
+			hash = hash * 31 + BlackJawz::Scene::SceneAssets::HashBytes(reinterpret_cast<const uint8_t*>(mesh.indices.data()),
+				mesh.indices.size() * sizeof(uint32_t));
+		}
+		return hash;
+	}
+
+	// Imports generated terrain from OBJ, GLB and base64 glTF files on the calling thread and on the
+	// job system, in MB of file per second. The files were just written, so they come from the page cache.
+	bool MeasureMeshImport(const BenchmarkOptions& options, BlackJawz::Tools::JsonWriter& json)
+	{
+		using namespace BlackJawz;
+
+		struct ModelFile
+		{
+			const char* type;
+			std::string filename;
+		};
+		std::vector<ModelFile> files =
+		{
+			{ "obj", (std::filesystem::path(options.directory) / "MeshImport.obj").string() },
+			{ "glb", (std::filesystem::path(options.directory) / "MeshImport.glb").string() },
+			{ "gltf", (std::filesystem::path(options.directory) / "MeshImport.gltf").string() }
+		};
+
+		std::string obj = Tools::GenerateObjModel(options.meshGridSize, options.meshBands);
+		std::vector<uint8_t> glb = Tools::GenerateGlbModel(options.meshGridSize, options.meshBands);
+		std::string gltf = Tools::GenerateGltfModel(options.meshGridSize, options.meshBands);
+		if (!Scene::SceneWriter::WriteToFile(files[0].filename, reinterpret_cast<const uint8_t*>(obj.data()), obj.size()) ||
+			!Scene::SceneWriter::WriteToFile(files[1].filename, glb.data(), glb.size()) ||
+			!Scene::SceneWriter::WriteToFile(files[2].filename, reinterpret_cast<const uint8_t*>(gltf.data()), gltf.size()))
+		{
+			fprintf(stderr, "Failed to write the mesh import files\n");
+			return false;
+		}
+		obj = std::string();
+		glb = std::vector<uint8_t>();
+		gltf = std::string();
+
+		bool succeeded = true;
+		size_t expectedTriangles = static_cast<size_t>(options.meshGridSize) * options.meshGridSize * 2;
+		json.BeginObject("meshImport");
+		json.Value("gridSize", static_cast<uint64_t>(options.meshGridSize));
+		json.Value("bands", static_cast<uint64_t>(options.meshBands));
+		json.BeginArray("files");
+		for (const ModelFile& file : files)
+		{
+			Scene::MeshImporter serialImporter;
+			Scene::ImportedModel model;
+			Scene::MeshImportStats stats;
+			std::vector<double> serialMs;
+			for (uint32_t i = 0; i < options.iterations; ++i)
+			{
+				auto start = std::chrono::steady_clock::now();
+				if (!serialImporter.Import(file.filename, model, stats))
+				{
+					fprintf(stderr, "Failed to import %s: %s\n", file.filename.c_str(), serialImporter.GetLastError().c_str());
+					succeeded = false;
+					break;
+				}
+				serialMs.push_back(ElapsedMs(start));
+			}
+			if (serialMs.empty())
+				continue;
+
+			uint64_t hash = HashModel(model);
+			succeeded = stats.triangleCount == expectedTriangles && succeeded;
+
+			double serial = Median(serialMs);
+			double megabytes = stats.fileBytes / 1.0e6;
+			json.BeginObject();
+			json.Value("type", std::string(file.type));
+			json.Value("fileBytes", stats.fileBytes);
+			json.Value("meshes", static_cast<uint64_t>(stats.meshCount));
+			json.Value("vertices", static_cast<uint64_t>(stats.vertexCount));
+			json.Value("triangles", static_cast<uint64_t>(stats.triangleCount));
+			json.Value("chunks", static_cast<uint64_t>(stats.chunks));
+			json.Value("serialMs", serial);
+			json.Value("serialMBps", serial > 0.0 ? megabytes / (serial / 1000.0) : 0.0);
+			json.Value("serialParseMs", stats.parseMs);
+			json.Value("serialBuildMs", stats.buildMs);
+
+			json.BeginArray("threads");
+			for (uint32_t threads : options.threadCounts)
+			{
+				Jobs::JobSystem jobSystem(threads > 1 ? threads - 1 : 1);
+				Scene::MeshImporter importer(&jobSystem);
+
+				std::vector<double> parallelMs;
+				for (uint32_t i = 0; i < options.iterations; ++i)
+				{
+					auto start = std::chrono::steady_clock::now();
+					bool imported = importer.Import(file.filename, model, stats);
+					parallelMs.push_back(ElapsedMs(start));
+
+					// Chunks do not depend on the thread count, neither does the model
+					if (!imported || HashModel(model) != hash)
+					{
+						fprintf(stderr, "%s imports differently on %u threads\n", file.filename.c_str(), threads);
+						succeeded = false;
+					}
+				}
+
+				double ms = Median(parallelMs);
+				json.BeginObject();
+				json.Value("threads", static_cast<uint64_t>(threads));
+				json.Value("ms", ms);
+				json.Value("MBps", ms > 0.0 ? megabytes / (ms / 1000.0) : 0.0);
+				json.Value("speedup", ms > 0.0 ? serial / ms : 0.0);
+				json.Value("parseMs", stats.parseMs);
+				json.Value("buildMs", stats.buildMs);
+				json.EndObject();
+			}
+			json.EndArray();
+			json.EndObject();
+
+			std::error_code error;
+			std::filesystem::remove(file.filename, error);
+		}
+		json.EndArray();
+		json.EndObject();
+		return succeeded;
+	}
+
+	template <typename T>
+	std::vector<T> ParseList(const char* text)
+	{
+		std::vector<T> values;
+		for (const char* p = text; *p;)
+		{
+			char* end = nullptr;
+			unsigned long long value = strtoull(p, &end, 10);
+			if (end == p)
+				break;
+
+			values.push_back(static_cast<T>(value));
+			p = *end == ',' ? end + 1 : end;
+		}
+		return values;
+	}
+
+	void PrintUsage()
+	{
+		printf("Usage: SceneBenchmark [options]\n");
+		printf("Options:\n");
+		printf("  --entities LIST      Scene sizes, default 1000,10000,50000\n");
+		printf("  --texture-sets LIST  Unique texture sets per scene, default 4,64\n");
+		printf("  --texture-size N     Texture width and height, default 256\n");
+		printf("  --threads LIST       Thread counts for the load scaling run, default 1,2,4,... up to the hardware\n");
+		printf("  --iterations N       Runs per measurement, the median is reported, default 3\n");
+		printf("  --instances N        Objects in the instancing comparison, 0 skips it, default 100000\n");
+		printf("  --compress-sets N    Texture sets in the block compression comparison, 0 skips it, default 4\n");
+		printf("  --compress-preset P  fast or quality, default fast\n");
+		printf("  --load-size N        Texture loaded from DDS, HDR and TGA files, 0 skips it, default 4096\n");
+		printf("  --cone-size N        Displacement map the cone step maps are built from, 0 skips it, default 256\n");
+		printf("  --mesh-size N        Quads along each side of the imported OBJ and glTF terrain, 0 skips it, default 512\n");
+		printf("  --mesh-bands N       Objects the terrain is cut into, default 16\n");
+		printf("  --directory DIR      Where the scene files are written, default the temp directory\n");
+		printf("  --output FILE        JSON results, default stdout\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BenchmarkOptions options;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (strcmp(argv[i], "--entities") == 0 && hasValue)
+			options.entityCounts = ParseList<size_t>(argv[++i]);
+		else if (strcmp(argv[i], "--texture-sets") == 0 && hasValue)
+			options.textureSetCounts = ParseList<size_t>(argv[++i]);
+		else if (strcmp(argv[i], "--texture-size") == 0 && hasValue)
+			options.textureSize = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+			options.threadCounts = ParseList<uint32_t>(argv[++i]);
+		else if (strcmp(argv[i], "--iterations") == 0 && hasValue)
+			options.iterations = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+		else if (strcmp(argv[i], "--instances") == 0 && hasValue)
+			options.instanceCount = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--compress-sets") == 0 && hasValue)
+			options.compressTextureSets = static_cast<size_t>(strtoull(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--compress-preset") == 0 && hasValue)
+			options.compressionPreset = strcmp(argv[++i], "quality") == 0 ?
+				BlackJawz::Tools::CompressionPreset::Quality : BlackJawz::Tools::CompressionPreset::Fast;
+		else if (strcmp(argv[i], "--load-size") == 0 && hasValue)
+			options.loadTextureSize = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--cone-size") == 0 && hasValue)
+			options.coneMapSize = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--mesh-size") == 0 && hasValue)
+			options.meshGridSize = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--mesh-bands") == 0 && hasValue)
+			options.meshBands = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+		else if (strcmp(argv[i], "--directory") == 0 && hasValue)
+			options.directory = argv[++i];
+		else if (strcmp(argv[i], "--output") == 0 && hasValue)
+			options.output = argv[++i];
+		else
+		{
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	if (options.entityCounts.empty() || options.textureSetCounts.empty())
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	if (options.threadCounts.empty())
+	{
+		uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+		for (uint32_t threads = 1; threads < hardwareThreads; threads *= 2)
+		{
+			options.threadCounts.push_back(threads);
+		}
+		options.threadCounts.push_back(hardwareThreads);
+	}
+
+	if (options.directory.empty())
+	{
+		options.directory = (std::filesystem::temp_directory_path() / "BlackJawzBenchmark").string();
+	}
+	std::error_code error;
+	std::filesystem::create_directories(options.directory, error);
+
+	BlackJawz::Tools::JsonWriter json;
+	json.BeginObject();
+	json.Value("hardwareThreads", static_cast<uint64_t>(std::thread::hardware_concurrency()));
+	json.Value("textureSize", static_cast<uint64_t>(options.textureSize));
+	json.Value("iterations", static_cast<uint64_t>(options.iterations));
+
+	bool succeeded = CheckVertexPacking(json);
+
+	if (BlackJawz::Tools::HasTaskExecutor())
+	{
+		succeeded = CheckTaskExecutor(json) && succeeded;
+	}
+
+	json.BeginArray("cases");
+	for (size_t entityCount : options.entityCounts)
+	{
+		for (size_t textureSetCount : options.textureSetCounts)
+		{
+			succeeded = RunCase(options, entityCount, textureSetCount, json) && succeeded;
+		}
+	}
+	json.EndArray();
+
+	if (options.instanceCount > 0)
+	{
+		succeeded = MeasureInstancing(options, json) && succeeded;
+	}
+
+	if (options.compressTextureSets > 0 && BlackJawz::Tools::HasTextureProcessing())
+	{
+		succeeded = MeasureTextureCompression(options, json) && succeeded;
+	}
+
+	if (options.loadTextureSize > 0 && BlackJawz::Tools::HasTextureProcessing())
+	{
+		succeeded = MeasureTextureLoads(options, json) && succeeded;
+	}
+
+	if (options.coneMapSize > 0)
+	{
+		succeeded = MeasureConeStepMaps(options, json) && succeeded;
+	}
+
+	if (options.meshGridSize > 0)
+	{
+		succeeded = MeasureMeshImport(options, json) && succeeded;
+	}
+	json.EndObject();
+
+	std::string text = json.GetText() + "\n";
+	if (options.output.empty())
+	{
+		fwrite(text.data(), 1, text.size(), stdout);
+	}
+	else
+	{
+		std::ofstream outFile(options.output, std::ios::binary | std::ios::trunc);
+		outFile << text;
+		if (!outFile)
+		{
+			fprintf(stderr, "Failed to write %s\n", options.output.c_str());
+			return 1;
+		}
+	}
+
+	return succeeded ? 0 : 1;
+}
@@ -0,0 +1,256 @@
+#include "ConeStepMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+	// The depths with a wrapped border, rays and row scans read past the edges without wrapping every
+	// texel they touch
+	struct PaddedDepths
+	{
+		std::vector<float> values;
+		int32_t border = 0;
+		int32_t stride = 0;
+
+		PaddedDepths(const std::vector<float>& depths, uint32_t width, uint32_t height, int32_t searchRadius)
+		{
+			// Rays stop within the radius, the bilinear sample there reads one texel further
+			border = searchRadius + 2;
+			stride = static_cast<int32_t>(width) + 2 * border;
+			int32_t rows = static_cast<int32_t>(height) + 2 * border;
+			values.resize(static_cast<size_t>(stride) * rows);
+
+			for (int32_t y = 0; y < rows; ++y)
+			{
+				int32_t sourceY = Wrap(y - border, static_cast<int32_t>(height));
+				for (int32_t x = 0; x < stride; ++x)
+				{
+					values[static_cast<size_t>(y) * stride + x] = depths[static_cast<size_t>(sourceY) * width + Wrap(x - border, static_cast<int32_t>(width))];
+				}
+			}
+		}
+
+		static int32_t Wrap(int32_t value, int32_t size)
+		{
+			return ((value % size) + size) % size;
+		}
+
+		// x and y from -border up to the size plus the border
+		const float* Row(int32_t y) const { return values.data() + static_cast<size_t>(y + border) * stride + border; }
+		float At(int32_t x, int32_t y) const { return Row(y)[x]; }
+
+		// Bilinear, in texels with texel centres on whole numbers
+		float Sample(float x, float y) const
+		{
+			float x0 = std::floor(x);
+			float y0 = std::floor(y);
+			float fx = x - x0;
+			float fy = y - y0;
+			const float* top = Row(static_cast<int32_t>(y0)) + static_cast<int32_t>(x0);
+			const float* bottom = top + stride;
+			float upper = top[0] + (top[1] - top[0]) * fx;
+			float lower = bottom[0] + (bottom[1] - bottom[0]) * fx;
+			return upper + (lower - upper) * fy;
+		}
+	};
+
+	struct ConeSearch
+	{
+		float texelU = 0.0f; // Texture coordinates across one texel
+		float texelV = 0.0f;
+		float maxRatio = 0.0f;
+		int32_t radius = 0;
+	};
+
+	ConeSearch MakeConeSearch(uint32_t width, uint32_t height, uint32_t searchRadius)
+	{
+		ConeSearch search;
+		search.texelU = 1.0f / width;
+		search.texelV = 1.0f / height;
+		// A cone this wide reaches searchRadius texels across at the deepest, along either axis
+		search.maxRatio = std::min(1.0f, static_cast<float>(searchRadius) / std::max(width, height));
+		search.radius = static_cast<int32_t>(searchRadius);
+		return search;
+	}
+
+	// The ray from the top above the source texel through the surface at the texel dx, dy away is
+	// followed on until it leaves the surface again. The cone must not reach that point, else a ray
+	// could cross the surface there and again inside the cone. The ratio a point on the ray asks for
+	// only grows along it, so the march stops with best once it reaches best or the cone's apex.
+	float TraceConeRatio(const PaddedDepths& depths, const ConeSearch& search, int32_t x, int32_t y, float sourceDepth,
+		int32_t dx, int32_t dy, float targetDepth, float best)
+	{
+		float length = std::sqrt(static_cast<float>(dx * dx + dy * dy));
+		float u = dx * search.texelU;
+		float v = dy * search.texelV;
+		float across = std::sqrt(u * u + v * v);
+
+		// Per texel along the ray
+		float stepX = dx / length;
+		float stepY = dy / length;
+		float stepDepth = targetDepth / length;
+		float stepAcross = across / length;
+
+		for (float distance = length + 1.0f;; distance += 1.0f)
+		{
+			float rayDepth = distance * stepDepth;
+			if (rayDepth >= sourceDepth)
+				return best;
+
+			float ratio = distance * stepAcross / (sourceDepth - rayDepth);
+			if (ratio >= best)
+				return best;
+
+			// Still inside while the surface is at or above the ray
+			float surface = depths.Sample(x + stepX * distance, y + stepY * distance);
+			if (surface > rayDepth)
+				return ratio;
+		}
+	}
+
+	float GetConeRatio(const PaddedDepths& depths, const ConeSearch& search, int32_t x, int32_t y, std::vector<float>& bounds)
+	{
+		float sourceDepth = depths.At(x, y);
+		float best = search.maxRatio;
+
+		// Only texels above this one narrow its cone, nothing is above the top
+		if (sourceDepth <= 0.0f)
+			return best;
+
+		int32_t radius = search.radius;
+		for (int32_t row = 0; row <= radius; ++row)
+		{
+			// Every texel in this row and further out is at least this far across
+			if (row * search.texelV >= best * sourceDepth)
+				break;
+
+			for (int32_t dy : { row, -row })
+			{
+				// The narrowest cone each texel in the row could give, the ray leaves the surface past the
+				// texel at the earliest. Infinite for texels no higher than this one. Free of branches so
+				// the compiler vectorizes it.
+				const float* depthRow = depths.Row(y + dy) + x - radius;
+				float v = dy * search.texelV;
+				for (int32_t i = 0; i <= 2 * radius; ++i)
+				{
+					float u = (i - radius) * search.texelU;
+					float bound = std::sqrt(u * u + v * v) / (sourceDepth - depthRow[i]);
+					bounds[i] = depthRow[i] < sourceDepth ? bound : std::numeric_limits<float>::infinity();
+				}
+
+				// Nearest first, they narrow the cone the most and cut the rest of the search short
+				for (int32_t column = 0; column <= radius; ++column)
+				{
+					if (column * search.texelU >= best * sourceDepth)
+						break;
+
+					for (int32_t dx : { column, -column })
+					{
+						if (bounds[radius + dx] < best)
+						{
+							best = TraceConeRatio(depths, search, x, y, sourceDepth, dx, dy, depthRow[radius + dx], best);
+						}
+						if (column == 0)
+							break;
+					}
+				}
+
+				if (row == 0)
+					break;
+			}
+		}
+		return best;
+	}
+}
+
+std::vector<float> BlackJawz::Tools::GenerateConeRatios(const std::vector<float>& depths, uint32_t width, uint32_t height,
+	uint32_t searchRadius, Jobs::JobSystem* jobSystem)
+{
+	std::vector<float> ratios;
+	if (width == 0 || height == 0 || depths.size() != static_cast<size_t>(width) * height)
+		return ratios;
+
+	ratios.resize(depths.size());
+	PaddedDepths padded(depths, width, height, static_cast<int32_t>(searchRadius));
+	ConeSearch search = MakeConeSearch(width, height, searchRadius);
+
+	auto generateRow = [&](uint32_t y)
+		{
+			std::vector<float> bounds(2 * static_cast<size_t>(searchRadius) + 1);
+			for (uint32_t x = 0; x < width; ++x)
+			{
+				ratios[static_cast<size_t>(y) * width + x] = GetConeRatio(padded, search, static_cast<int32_t>(x), static_cast<int32_t>(y), bounds);
+			}
+		};
+
+	if (jobSystem)
+	{
+		Jobs::JobCounter counter;
+		jobSystem->Dispatch(counter, height, 1, generateRow);
+		jobSystem->Wait(counter);
+	}
+	else
+	{
+		for (uint32_t y = 0; y < height; ++y)
+		{
+			generateRow(y);
+		}
+	}
+	return ratios;
+}
+
+std::vector<float> BlackJawz::Tools::GenerateConeRatiosReference(const std::vector<float>& depths, uint32_t width, uint32_t height,
+	uint32_t searchRadius)
+{
+	std::vector<float> ratios;
+	if (width == 0 || height == 0 || depths.size() != static_cast<size_t>(width) * height)
+		return ratios;
+
+	ratios.resize(depths.size());
+	PaddedDepths padded(depths, width, height, static_cast<int32_t>(searchRadius));
+	ConeSearch search = MakeConeSearch(width, height, searchRadius);
+	int32_t radius = search.radius;
+
+	for (int32_t y = 0; y < static_cast<int32_t>(height); ++y)
+	{
+		for (int32_t x = 0; x < static_cast<int32_t>(width); ++x)
+		{
+			float sourceDepth = padded.At(x, y);
+			float best = search.maxRatio;
+			for (int32_t dy = -radius; dy <= radius; ++dy)
+			{
+				for (int32_t dx = -radius; dx <= radius; ++dx)
+				{
+					float targetDepth = padded.At(x + dx, y + dy);
+					if (targetDepth < sourceDepth)
+					{
+						best = std::min(best, TraceConeRatio(padded, search, x, y, sourceDepth, dx, dy, targetDepth, search.maxRatio));
+					}
+				}
+			}
+			ratios[static_cast<size_t>(y) * width + x] = best;
+		}
+	}
+	return ratios;
+}
+
+std::vector<uint8_t> BlackJawz::Tools::EncodeConeStepMap(const std::vector<float>& depths, const std::vector<float>& coneRatios)
+{
+	std::vector<uint8_t> texels(depths.size() * 2);
+	for (size_t i = 0; i < depths.size() && i < coneRatios.size(); ++i)
+	{
+		texels[i * 2] = static_cast<uint8_t>(std::clamp(depths[i], 0.0f, 1.0f) * 255.0f + 0.5f);
+
+		// The square root can round up, step down until the decoded cone is no wider
+		float ratio = std::clamp(coneRatios[i], 0.0f, 1.0f);
+		uint8_t root = static_cast<uint8_t>(std::sqrt(ratio) * 255.0f);
+		while (root > 0 && DecodeConeRatio(root) > ratio)
+		{
+			--root;
+		}
+		texels[i * 2 + 1] = root;
+	}
+	return texels;
+}
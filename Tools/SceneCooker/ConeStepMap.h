@@ -0,0 +1,42 @@
+#pragma once
+#include "Util/JobSystem.h"
+
+#include <cstdint>
+#include <vector>
+
+// Relaxed cone step maps, after Policarpo and Oliveira, "Relaxed Cone Stepping for Relief Mapping"
+// (GPU Gems 3). Every texel stores the widest cone standing on the surface there, opening towards the
+// top, that no view ray can cross the surface twice inside. A shader stepping a ray to the edge of
+// the cone under it lands at most one crossing past the surface, so a few steps and a short binary
+// search find what a linear march needs tens of samples for.
+//
+// Free of DirectXTex, the maps are plain arrays so the generator runs and can be checked headless.
+namespace BlackJawz::Tools
+{
+	// Texels searched around each texel. Cone ratios are capped at this many texels across per unit of
+	// depth, the search never has to look further.
+	constexpr uint32_t DefaultConeSearchRadius = 32;
+
+	// Depths are row major in [0, 1], 0 at the top of the surface and 1 at its deepest, the way the
+	// GBuffer shader reads displacement. The surface tiles. Returns one cone ratio per texel in texture
+	// coordinates across per unit of depth. Nearer texels are searched first and the search stops once
+	// no texel further out can narrow the cone. Given a job system, rows are generated as jobs.
+	std::vector<float> GenerateConeRatios(const std::vector<float>& depths, uint32_t width, uint32_t height,
+		uint32_t searchRadius = DefaultConeSearchRadius, Jobs::JobSystem* jobSystem = nullptr);
+
+	// The same ratios from tracing every texel within the radius, serially. Slow, it is the reference
+	// GenerateConeRatios has to match exactly.
+	std::vector<float> GenerateConeRatiosReference(const std::vector<float>& depths, uint32_t width, uint32_t height,
+		uint32_t searchRadius = DefaultConeSearchRadius);
+
+	// Two bytes per texel: depth in red, the square root of the cone ratio in green for precision near
+	// zero. Ratios round down, quantizing never widens a cone.
+	std::vector<uint8_t> EncodeConeStepMap(const std::vector<float>& depths, const std::vector<float>& coneRatios);
+
+	// The ratio the shader reads back from an encoded texel
+	inline float DecodeConeRatio(uint8_t value)
+	{
+		float root = value / 255.0f;
+		return root * root;
+	}
+}
@@ -0,0 +1,566 @@
+#include "SceneCooker.h"
+#include "Scene/SceneBounds.h"
+#include "Scene/SceneJournal.h"
+#include "Scene/SceneWriter.h"
+#include "Scene/SpatialIndex.h"
+#include "TextureProcessing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+namespace
+{
+	double ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+BlackJawz::Tools::SceneCooker::SceneCooker(Jobs::JobSystem& jobSystem, const CookOptions& options)
+	: jobSystem(jobSystem), options(options), loader(jobSystem, backend)
+{
+	// Entities are reordered before writing, so an index built while loading would be thrown away
+	loader.SetBuildSpatialIndex(false);
+}
+
+bool BlackJawz::Tools::SceneCooker::Cook(const std::string& input, const std::string& output, CookStats& stats)
+{
+	stats = CookStats();
+	lastError.clear();
+
+	// The null backend turns down every upload, so this only decodes and replays the journal
+	auto start = std::chrono::steady_clock::now();
+	Scene::LoadedScene scene;
+	if (!loader.Load(input, scene))
+	{
+		lastError = "Failed to read " + input;
+		return false;
+	}
+
+	stats.loadMs = ElapsedMs(start);
+	stats.inputBytes = loader.GetStats().fileBytes;
+	stats.entityCount = scene.entities.size();
+
+	start = std::chrono::steady_clock::now();
+
+	if (textureResolver)
+	{
+		ResolveTextures(scene.entities, stats);
+	}
+
+	// Before the mips, so the packed textures get theirs and are compressed as one
+	if (options.packChannels && HasTextureProcessing())
+	{
+		PackChannels(scene.entities, stats);
+	}
+
+	if (options.generateMips && HasTextureProcessing())
+	{
+		GenerateMips(scene.entities, stats);
+	}
+
+	// After the mips, the maps keep a single level. Before the compression, which leaves them as they are
+	// but would make the displacement they are built from lossy.
+	if (options.coneStepMaps && HasTextureProcessing())
+	{
+		auto coneStart = std::chrono::steady_clock::now();
+		GenerateConeStepMaps(scene.entities, stats);
+		stats.coneStepMs = ElapsedMs(coneStart);
+	}
+
+	// After the mips, the encoder compresses the levels it is given
+	if (options.compressTextures && HasTextureProcessing())
+	{
+		auto compressStart = std::chrono::steady_clock::now();
+		BlockCompressTextures(scene.entities, stats);
+		stats.textureCompressMs = ElapsedMs(compressStart);
+	}
+
+	if (options.computeBounds)
+	{
+		ComputeBounds(scene.entities, stats);
+	}
+
+	if (options.packVertices)
+	{
+		PackVertices(scene.entities, stats);
+	}
+
+	Scene::SceneAssets assets(options.compressAssets);
+	BuildAssets(scene.entities, assets, stats);
+
+	if (options.reorderEntities)
+	{
+		ReorderEntities(scene.entities, assets);
+	}
+
+	stats.processMs = ElapsedMs(start);
+
+	// Numbered in the order the entities are written, so it has to come after the reordering
+	Scene::SpatialIndex spatialIndex;
+	if (options.buildSpatialIndex)
+	{
+		start = std::chrono::steady_clock::now();
+		spatialIndex.Build(scene.entities, jobSystem);
+		stats.spatialIndexNodes = spatialIndex.GetNodeCount();
+		stats.spatialIndexMs = ElapsedMs(start);
+	}
+
+	start = std::chrono::steady_clock::now();
+
+	size_t chunkCount = Scene::SceneWriter::GetChunkCount(scene.entities.size());
+	std::vector<flatbuffers::DetachedBuffer> chunks(chunkCount);
+
+	Jobs::JobCounter chunkCounter;
+	jobSystem.Dispatch(chunkCounter, static_cast<uint32_t>(chunkCount), 1, [&](uint32_t index)
+		{
+			size_t begin = index * Scene::SceneWriter::EntitiesPerChunk;
+			size_t count = std::min(Scene::SceneWriter::EntitiesPerChunk, scene.entities.size() - begin);
+
+			chunks[index] = Scene::SceneWriter::WriteChunk(scene.entities.data() + begin, count, &assets);
+		});
+	jobSystem.Wait(chunkCounter);
+
+	// Runtime scenes are never journaled, a journal left next to the output belongs to an old file
+	flatbuffers::DetachedBuffer cooked = Scene::SceneWriter::MergeChunks(chunks, 0, &assets, &spatialIndex);
+	chunks.clear();
+
+	if (!Scene::SceneWriter::WriteToFile(output, cooked.data(), cooked.size()))
+	{
+		lastError = "Failed to write " + output;
+		return false;
+	}
+	Scene::SceneJournal::Discard(output);
+
+	stats.outputBytes = cooked.size();
+	stats.writeMs = ElapsedMs(start);
+	return true;
+}
+
+std::vector<BlackJawz::Scene::Blob> BlackJawz::Tools::SceneCooker::CollectTextures(const std::vector<Scene::EntityData>& entities,
+	TextureIndices& indices)
+{
+	std::vector<Scene::Blob> textures;
+	for (const auto& entity : entities)
+	{
+		if (!entity.appearance)
+			continue;
+
+		for (const Scene::Blob& texture : entity.appearance->textures)
+		{
+			if (!texture.Empty() && indices.emplace(texture.data, textures.size()).second)
+				textures.push_back(texture);
+		}
+	}
+	return textures;
+}
+
+size_t BlackJawz::Tools::SceneCooker::ReplaceTextures(std::vector<Scene::EntityData>& entities, const TextureIndices& indices,
+	const std::vector<Scene::Blob>& replacements)
+{
+	for (auto& entity : entities)
+	{
+		if (!entity.appearance)
+			continue;
+
+		for (Scene::Blob& texture : entity.appearance->textures)
+		{
+			if (texture.Empty())
+				continue;
+
+			const Scene::Blob& replacement = replacements[indices.at(texture.data)];
+			if (!replacement.Empty())
+				texture = replacement;
+		}
+	}
+
+	return std::count_if(replacements.begin(), replacements.end(), [](const Scene::Blob& blob) { return !blob.Empty(); });
+}
+
+void BlackJawz::Tools::SceneCooker::ResolveTextures(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	TextureIndices indices;
+	std::vector<Scene::Blob> textures = CollectTextures(entities, indices);
+
+	stats.textureHashes.resize(textures.size());
+	Jobs::JobCounter hashCounter;
+	jobSystem.Dispatch(hashCounter, static_cast<uint32_t>(textures.size()), 1, [&](uint32_t index)
+		{
+			stats.textureHashes[index] = Scene::SceneAssets::HashBytes(textures[index].data, textures[index].size);
+		});
+	jobSystem.Wait(hashCounter);
+
+	// The resolver may read files, but it is called once per unique texture and only from this thread
+	std::vector<Scene::Blob> replacements(textures.size());
+	for (size_t i = 0; i < textures.size(); ++i)
+	{
+		replacements[i] = textureResolver(stats.textureHashes[i]);
+	}
+
+	stats.texturesResolved = ReplaceTextures(entities, indices, replacements);
+}
+
+void BlackJawz::Tools::SceneCooker::PackChannels(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	// Materials are the combinations of maps, entities sharing one share the packed texture
+	using ChannelKey = std::array<const uint8_t*, 4>;
+	std::map<ChannelKey, size_t> materialIndices;
+	std::vector<std::array<Scene::Blob, 4>> materials;
+
+	auto getKey = [](const Scene::AppearanceData& appearance, ChannelKey& key)
+		{
+			size_t mapCount = 0;
+			for (size_t channel = 0; channel < PackedChannelSlots.size(); ++channel)
+			{
+				key[channel] = appearance.textures[static_cast<size_t>(PackedChannelSlots[channel])].data;
+				mapCount += key[channel] ? 1 : 0;
+			}
+			return mapCount;
+		};
+
+	for (const auto& entity : entities)
+	{
+		// A single map saves no binds, and already packed entities keep their texture
+		ChannelKey key;
+		if (!entity.appearance || !entity.appearance->textures[static_cast<size_t>(Scene::TextureSlot::Packed)].Empty() ||
+			getKey(*entity.appearance, key) < 2)
+			continue;
+
+		if (!materialIndices.emplace(key, materials.size()).second)
+			continue;
+
+		std::array<Scene::Blob, 4>& channels = materials.emplace_back();
+		for (size_t channel = 0; channel < PackedChannelSlots.size(); ++channel)
+		{
+			channels[channel] = entity.appearance->textures[static_cast<size_t>(PackedChannelSlots[channel])];
+		}
+	}
+
+	std::vector<Scene::Blob> packed(materials.size());
+	Jobs::JobCounter packCounter;
+	jobSystem.Dispatch(packCounter, static_cast<uint32_t>(materials.size()), 1, [&](uint32_t index)
+		{
+			packed[index] = PackTextureChannels(materials[index]);
+		});
+	jobSystem.Wait(packCounter);
+
+	// Maps shared between materials are counted once
+	std::unordered_map<const uint8_t*, uint64_t> packedMaps;
+	for (size_t i = 0; i < materials.size(); ++i)
+	{
+		if (packed[i].Empty())
+			continue;
+
+		++stats.texturesPacked;
+		stats.packedTextureBytes += packed[i].size;
+		for (const Scene::Blob& map : materials[i])
+		{
+			if (!map.Empty())
+				packedMaps.emplace(map.data, map.size);
+		}
+	}
+
+	stats.packedMaps = packedMaps.size();
+	for (const auto& map : packedMaps)
+	{
+		stats.packedMapBytes += map.second;
+	}
+
+	for (auto& entity : entities)
+	{
+		ChannelKey key;
+		if (!entity.appearance || !entity.appearance->textures[static_cast<size_t>(Scene::TextureSlot::Packed)].Empty())
+			continue;
+
+		size_t mapCount = getKey(*entity.appearance, key);
+		auto it = materialIndices.find(key);
+		if (it == materialIndices.end() || packed[it->second].Empty())
+			continue;
+
+		Scene::AppearanceData& appearance = *entity.appearance;
+		appearance.textures[static_cast<size_t>(Scene::TextureSlot::Packed)] = packed[it->second];
+		for (Scene::TextureSlot slot : PackedChannelSlots)
+		{
+			appearance.textures[static_cast<size_t>(slot)] = Scene::Blob();
+		}
+		stats.textureBindsSaved += mapCount - 1;
+	}
+}
+
+void BlackJawz::Tools::SceneCooker::GenerateMips(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	// One job per unique texture, entities sharing a texture share the result. Each texture's levels are
+	// split into more jobs, so one large texture does not leave the other workers idle.
+	TextureIndices indices;
+	std::vector<Scene::Blob> textures = CollectTextures(entities, indices);
+
+	std::vector<Scene::Blob> processed(textures.size());
+	Jobs::JobCounter textureCounter;
+	jobSystem.Dispatch(textureCounter, static_cast<uint32_t>(textures.size()), 1, [&](uint32_t index)
+		{
+			processed[index] = GenerateTextureMips(textures[index], &jobSystem);
+		});
+	jobSystem.Wait(textureCounter);
+
+	stats.texturesProcessed = ReplaceTextures(entities, indices, processed);
+}
+
+void BlackJawz::Tools::SceneCooker::GenerateConeStepMaps(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	// The displacement is the red channel of a displacement map, or the alpha channel of a packed texture
+	using HeightKey = std::pair<const uint8_t*, size_t>;
+	std::map<HeightKey, size_t> sourceIndices;
+	std::vector<std::pair<Scene::Blob, size_t>> sources;
+
+	auto getSource = [](const Scene::AppearanceData& appearance, HeightKey& key, Scene::Blob& blob)
+		{
+			const Scene::Blob& displacement = appearance.textures[static_cast<size_t>(Scene::TextureSlot::Displacement)];
+			const Scene::Blob& packed = appearance.textures[static_cast<size_t>(Scene::TextureSlot::Packed)];
+			blob = !packed.Empty() ? packed : displacement;
+			key = { blob.data, !packed.Empty() ? 3 : 0 };
+			return !blob.Empty();
+		};
+
+	for (const auto& entity : entities)
+	{
+		HeightKey key;
+		Scene::Blob blob;
+		if (!entity.appearance || !entity.appearance->textures[static_cast<size_t>(Scene::TextureSlot::ConeStep)].Empty() ||
+			!getSource(*entity.appearance, key, blob))
+			continue;
+
+		if (sourceIndices.emplace(key, sources.size()).second)
+		{
+			sources.emplace_back(blob, key.second);
+		}
+	}
+
+	// One job per map, each map's rows are more jobs, so a single large map still keeps every worker busy
+	std::vector<Scene::Blob> coneMaps(sources.size());
+	Jobs::JobCounter coneCounter;
+	jobSystem.Dispatch(coneCounter, static_cast<uint32_t>(sources.size()), 1, [&](uint32_t index)
+		{
+			coneMaps[index] = GenerateConeStepMap(sources[index].first, sources[index].second, &jobSystem, options.coneSearchRadius);
+		});
+	jobSystem.Wait(coneCounter);
+
+	for (const Scene::Blob& coneMap : coneMaps)
+	{
+		stats.coneStepMaps += coneMap.Empty() ? 0 : 1;
+	}
+
+	for (auto& entity : entities)
+	{
+		HeightKey key;
+		Scene::Blob blob;
+		if (!entity.appearance || !entity.appearance->textures[static_cast<size_t>(Scene::TextureSlot::ConeStep)].Empty() ||
+			!getSource(*entity.appearance, key, blob))
+			continue;
+
+		auto it = sourceIndices.find(key);
+		if (it != sourceIndices.end() && !coneMaps[it->second].Empty())
+		{
+			entity.appearance->textures[static_cast<size_t>(Scene::TextureSlot::ConeStep)] = coneMaps[it->second];
+		}
+	}
+}
+
+void BlackJawz::Tools::SceneCooker::BlockCompressTextures(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	TextureIndices indices;
+	std::vector<Scene::Blob> textures = CollectTextures(entities, indices);
+
+	// A texture takes its role from the slots it is bound to
+	std::vector<TextureRole> roles(textures.size(), TextureRole::Mixed);
+	std::vector<uint8_t> bound(textures.size(), 0);
+	for (const auto& entity : entities)
+	{
+		if (!entity.appearance)
+			continue;
+
+		for (size_t slot = 0; slot < Scene::TextureSlotCount; ++slot)
+		{
+			const Scene::Blob& texture = entity.appearance->textures[slot];
+			if (texture.Empty())
+				continue;
+
+			size_t index = indices.at(texture.data);
+			TextureRole role = GetTextureRole(static_cast<Scene::TextureSlot>(slot));
+			roles[index] = bound[index] ? CombineTextureRoles(roles[index], role) : role;
+			bound[index] = 1;
+		}
+	}
+
+	TextureCompressStats compressStats;
+	std::vector<Scene::Blob> compressed = CompressTextures(textures, roles, options.compressionPreset, jobSystem, compressStats);
+
+	stats.texturesCompressed = ReplaceTextures(entities, indices, compressed);
+	stats.textureBlockJobs = compressStats.blockJobs;
+}
+
+void BlackJawz::Tools::SceneCooker::ComputeBounds(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	// Bounds depend on the vertex data and its layout, computed once per combination
+	using GeometryKey = std::tuple<const uint8_t*, uint32_t, uint32_t>;
+	std::map<GeometryKey, size_t> geometryIndices;
+	std::vector<const Scene::GeometryData*> geometries;
+
+	for (const auto& entity : entities)
+	{
+		if (!entity.appearance)
+			continue;
+
+		const Scene::GeometryData& geometry = entity.appearance->geometry;
+		GeometryKey key(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset);
+		if (geometryIndices.emplace(key, geometries.size()).second)
+			geometries.push_back(&geometry);
+	}
+
+	std::vector<std::optional<Scene::BoundsData>> bounds(geometries.size());
+	Jobs::JobCounter boundsCounter;
+	jobSystem.Dispatch(boundsCounter, static_cast<uint32_t>(geometries.size()), 1, [&](uint32_t index)
+		{
+			bounds[index] = Scene::ComputeBounds(*geometries[index]);
+		});
+	jobSystem.Wait(boundsCounter);
+
+	for (auto& entity : entities)
+	{
+		if (!entity.appearance)
+			continue;
+
+		Scene::GeometryData& geometry = entity.appearance->geometry;
+		geometry.bounds = bounds[geometryIndices[GeometryKey(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset)]];
+		if (geometry.bounds)
+			++stats.boundsComputed;
+	}
+}
+
+void BlackJawz::Tools::SceneCooker::PackVertices(std::vector<Scene::EntityData>& entities, CookStats& stats)
+{
+	// Same grouping as the bounds, entities sharing vertex data share the packed copy
+	using GeometryKey = std::tuple<const uint8_t*, uint32_t, uint32_t>;
+	std::map<GeometryKey, size_t> geometryIndices;
+	std::vector<const Scene::GeometryData*> geometries;
+
+	for (const auto& entity : entities)
+	{
+		if (!entity.appearance || entity.appearance->geometry.vertexFormat != Scene::VertexFormat::Float)
+			continue;
+
+		const Scene::GeometryData& geometry = entity.appearance->geometry;
+		GeometryKey key(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset);
+		if (geometryIndices.emplace(key, geometries.size()).second)
+			geometries.push_back(&geometry);
+	}
+
+	std::vector<std::optional<Scene::GeometryData>> packed(geometries.size());
+	std::vector<Scene::PackingError> errors(geometries.size());
+	Jobs::JobCounter packCounter;
+	jobSystem.Dispatch(packCounter, static_cast<uint32_t>(geometries.size()), 1, [&](uint32_t index)
+		{
+			Scene::GeometryData geometry = *geometries[index];
+			if (Scene::PackVertices(geometry))
+			{
+				errors[index] = Scene::MeasurePackingError(*geometries[index], geometry);
+				packed[index] = std::move(geometry);
+			}
+		});
+	jobSystem.Wait(packCounter);
+
+	for (size_t i = 0; i < geometries.size(); ++i)
+	{
+		if (!packed[i])
+			continue;
+
+		++stats.geometriesPacked;
+		stats.unpackedVertexBytes += geometries[i]->vertexBuffer.size - geometries[i]->vertexBufferOffset;
+		stats.packedVertexBytes += packed[i]->vertexBuffer.size;
+
+		Scene::PackingError& error = stats.packingError;
+		error.position = std::max(error.position, errors[i].position);
+		error.positionBound = std::max(error.positionBound, errors[i].positionBound);
+		error.normalDegrees = std::max(error.normalDegrees, errors[i].normalDegrees);
+		error.tangentDegrees = std::max(error.tangentDegrees, errors[i].tangentDegrees);
+		error.texC = std::max(error.texC, errors[i].texC);
+		error.vertexCount += errors[i].vertexCount;
+	}
+
+	// The lookup has to happen before the geometry is replaced, its key points at the old vertex data
+	for (auto& entity : entities)
+	{
+		if (!entity.appearance || entity.appearance->geometry.vertexFormat != Scene::VertexFormat::Float)
+			continue;
+
+		Scene::GeometryData& geometry = entity.appearance->geometry;
+		const std::optional<Scene::GeometryData>& result =
+			packed[geometryIndices.at(GeometryKey(geometry.vertexBuffer.data, geometry.vertexBufferStride, geometry.vertexBufferOffset))];
+		if (!result)
+			continue;
+
+		geometry.vertexBuffer = result->vertexBuffer;
+		geometry.vertexBufferStride = result->vertexBufferStride;
+		geometry.vertexBufferOffset = result->vertexBufferOffset;
+		geometry.vertexFormat = result->vertexFormat;
+		geometry.bounds = result->bounds;
+	}
+}
+
+void BlackJawz::Tools::SceneCooker::BuildAssets(std::vector<Scene::EntityData>& entities, Scene::SceneAssets& assets, CookStats& stats)
+{
+	assets.Collect(entities.data(), entities.size());
+	size_t collectedCount = assets.GetCount();
+
+	Jobs::JobCounter hashCounter;
+	jobSystem.Dispatch(hashCounter, static_cast<uint32_t>(collectedCount), 1, [&assets](uint32_t index) { assets.Hash(index); });
+	jobSystem.Wait(hashCounter);
+
+	assets.Deduplicate();
+
+	Jobs::JobCounter compressCounter;
+	jobSystem.Dispatch(compressCounter, static_cast<uint32_t>(assets.GetCount()), 1, [&assets](uint32_t index) { assets.Compress(index); });
+	jobSystem.Wait(compressCounter);
+
+	stats.assetCount = assets.GetCount();
+	stats.duplicateAssets = collectedCount - assets.GetCount();
+	stats.rawAssetBytes = assets.GetRawBytes();
+	stats.storedAssetBytes = assets.GetStoredBytes();
+}
+
+void BlackJawz::Tools::SceneCooker::ReorderEntities(std::vector<Scene::EntityData>& entities, const Scene::SceneAssets& assets)
+{
+	// Entities without geometry first, then grouped by mesh and diffuse texture, so a chunk's
+	// entities share uploads and draws with the same state end up next to each other
+	auto sortKey = [&assets](const Scene::EntityData& entity)
+		{
+			if (!entity.appearance)
+				return std::make_tuple(-1, -1, -1);
+
+			const Scene::AppearanceData& appearance = *entity.appearance;
+			return std::make_tuple(
+				assets.GetIndex(appearance.geometry.vertexBuffer),
+				assets.GetIndex(appearance.geometry.indexBuffer),
+				assets.GetIndex(appearance.textures[static_cast<size_t>(Scene::TextureSlot::Diffuse)]));
+		};
+
+	std::vector<std::pair<std::tuple<int32_t, int32_t, int32_t>, size_t>> keys;
+	keys.reserve(entities.size());
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		keys.emplace_back(sortKey(entities[i]), i);
+	}
+
+	// Ties keep their editor order
+	std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+	std::vector<Scene::EntityData> sorted;
+	sorted.reserve(entities.size());
+	for (const auto& key : keys)
+	{
+		sorted.push_back(std::move(entities[key.second]));
+	}
+	entities = std::move(sorted);
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "Scene/NullResourceBackend.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneLoader.h"
+#include "Scene/VertexPacking.h"
+#include "Util/JobSystem.h"
+#include "TextureProcessing.h"
+
+#include <functional>
+
+namespace BlackJawz::Tools
+{
+	struct CookOptions
+	{
+		bool compressAssets = true;
+		bool reorderEntities = true; // Group entities by mesh and material
+		bool computeBounds = true;
+		bool packChannels = false; // Metal, roughness, AO and displacement into one RGBA texture, needs DirectXTex
+		bool generateMips = true; // Uncompressed single mip textures, needs DirectXTex
+		bool coneStepMaps = false; // Relaxed cone step maps from displacement, needs DirectXTex
+		uint32_t coneSearchRadius = DefaultConeSearchRadius;
+		bool compressTextures = false; // Block compress by texture role, needs DirectXTex
+		CompressionPreset compressionPreset = CompressionPreset::Fast;
+		bool packVertices = false; // Quantized 20 byte vertices, see Scene/VertexPacking.h
+		bool buildSpatialIndex = true; // Entity bounds and a BVH the loader uses instead of building its own
+	};
+
+	struct CookStats
+	{
+		size_t entityCount = 0;
+		size_t assetCount = 0;
+		size_t duplicateAssets = 0; // Payloads merged with an identical one
+		size_t boundsComputed = 0;
+		size_t texturesResolved = 0; // Replaced through the texture resolver
+		size_t texturesProcessed = 0;
+		size_t texturesPacked = 0; // Unique packed textures made
+		size_t packedMaps = 0; // Unique maps folded into them
+		size_t textureBindsSaved = 0; // Pixel shader texture binds per frame, summed over the packed entities
+		size_t coneStepMaps = 0; // Unique cone step maps made
+		size_t texturesCompressed = 0;
+		size_t textureBlockJobs = 0;
+		size_t geometriesPacked = 0; // Unique vertex buffers
+		size_t spatialIndexNodes = 0;
+
+		uint64_t unpackedVertexBytes = 0;
+		uint64_t packedVertexBytes = 0;
+		Scene::PackingError packingError; // Largest of each error across the packed geometries
+
+		// Content hashes of the input's unique textures, filled in when there is a resolver
+		std::vector<uint64_t> textureHashes;
+
+		uint64_t inputBytes = 0;
+		uint64_t outputBytes = 0;
+		uint64_t packedMapBytes = 0; // The maps before packing
+		uint64_t packedTextureBytes = 0; // The packed textures, before mips and compression
+		uint64_t rawAssetBytes = 0;
+		uint64_t storedAssetBytes = 0;
+
+		double loadMs = 0.0;
+		double processMs = 0.0;
+		double textureCompressMs = 0.0; // Part of processMs
+		double coneStepMs = 0.0; // Part of processMs
+		double spatialIndexMs = 0.0;
+		double writeMs = 0.0;
+	};
+
+	// Turns editor scenes into runtime scenes without a GPU. Work is spread across assets
+	// and chunks on the job system, one scene is cooked at a time.
+	class SceneCooker
+	{
+	public:
+		SceneCooker(Jobs::JobSystem& jobSystem, const CookOptions& options);
+
+		// Looks up a replacement for a texture payload by its content hash, an empty blob keeps the payload
+		using TextureResolver = std::function<Scene::Blob(uint64_t hash)>;
+
+		// Textures are resolved before any other processing, pass nullptr to keep every payload
+		void SetTextureResolver(TextureResolver resolver) { textureResolver = std::move(resolver); }
+
+		bool Cook(const std::string& input, const std::string& output, CookStats& stats);
+
+		const std::string& GetLastError() const { return lastError; }
+
+	private:
+		// Unique textures across the entities, indices maps a payload to its position in the result
+		using TextureIndices = std::unordered_map<const uint8_t*, size_t>;
+		static std::vector<Scene::Blob> CollectTextures(const std::vector<Scene::EntityData>& entities, TextureIndices& indices);
+
+		// Empty replacements keep the texture, returns how many textures were replaced
+		static size_t ReplaceTextures(std::vector<Scene::EntityData>& entities, const TextureIndices& indices,
+			const std::vector<Scene::Blob>& replacements);
+
+		void ResolveTextures(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void PackChannels(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void GenerateMips(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void GenerateConeStepMaps(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void BlockCompressTextures(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void ComputeBounds(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void PackVertices(std::vector<Scene::EntityData>& entities, CookStats& stats);
+		void BuildAssets(std::vector<Scene::EntityData>& entities, Scene::SceneAssets& assets, CookStats& stats);
+		static void ReorderEntities(std::vector<Scene::EntityData>& entities, const Scene::SceneAssets& assets);
+
+		Jobs::JobSystem& jobSystem;
+		CookOptions options;
+		TextureResolver textureResolver;
+
+		Scene::NullResourceBackend backend;
+		Scene::SceneLoader loader;
+
+		std::string lastError;
+	};
+}
@@ -0,0 +1,956 @@
+#include "TextureProcessing.h"
+#include "ConeStepMap.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <random>
+
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+#include <DirectXTex.h>
+#endif
+
+namespace
+{
+	using BlackJawz::Tools::CompressionPreset;
+	using BlackJawz::Tools::TextureRole;
+
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	// Rows of blocks in one encoding job, a strip of a 2048 wide BC7 texture is a few milliseconds of work
+	constexpr size_t StripBlockRows = 16;
+
+#ifdef DIRECTX_TEX_TASK_EXECUTOR
+	// Runs DirectXTex's tasks as jobs, an empty executor without a job system keeps it serial
+	DirectX::TaskExecutor MakeTaskExecutor(BlackJawz::Jobs::JobSystem* jobSystem)
+	{
+		if (!jobSystem)
+			return DirectX::TaskExecutor();
+
+		return [jobSystem](size_t count, const std::function<void(size_t)>& task)
+			{
+				BlackJawz::Jobs::JobCounter counter;
+				jobSystem->Dispatch(counter, static_cast<uint32_t>(count), 1, [&](uint32_t index) { task(index); });
+				jobSystem->Wait(counter);
+			};
+	}
+#endif
+
+	BlackJawz::Scene::Blob SaveDDS(const DirectX::ScratchImage& image)
+	{
+		auto ddsBlob = std::make_shared<DirectX::Blob>();
+		HRESULT hr = DirectX::SaveToDDSMemory(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::DDS_FLAGS_NONE, *ddsBlob);
+		if (FAILED(hr))
+			return BlackJawz::Scene::Blob();
+
+		BlackJawz::Scene::Blob result;
+		result.data = static_cast<const uint8_t*>(ddsBlob->GetBufferPointer());
+		result.size = ddsBlob->GetBufferSize();
+		result.owner = std::move(ddsBlob);
+		return result;
+	}
+
+	// A texture decoded and ready to encode
+	struct CompressWork
+	{
+		DirectX::ScratchImage source;
+		DirectX::ScratchImage output; // Allocated up front, each strip's blocks are copied into it
+		DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+		DirectX::TEX_COMPRESS_FLAGS flags = DirectX::TEX_COMPRESS_DEFAULT;
+	};
+
+	DXGI_FORMAT GetFormat(TextureRole role, CompressionPreset preset, bool opaque)
+	{
+		switch (role)
+		{
+		case TextureRole::Colour:
+			return opaque && preset == CompressionPreset::Fast ? DXGI_FORMAT_BC1_UNORM : DXGI_FORMAT_BC7_UNORM;
+		case TextureRole::Normal:
+			return DXGI_FORMAT_BC5_UNORM;
+		case TextureRole::Mask:
+			return DXGI_FORMAT_BC4_UNORM;
+		case TextureRole::Packed:
+			return DXGI_FORMAT_BC7_UNORM;
+		default:
+			return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	// False for textures left as they are
+	bool Prepare(const BlackJawz::Scene::Blob& dds, TextureRole role, CompressionPreset preset, CompressWork& work)
+	{
+		if (role == TextureRole::Mixed)
+			return false;
+
+		DirectX::TexMetadata metadata;
+		DirectX::ScratchImage image;
+		HRESULT hr = DirectX::LoadFromDDSMemory(dds.data, dds.size, DirectX::DDS_FLAGS_NONE, &metadata, image);
+		if (FAILED(hr))
+			return false;
+
+		// Block compressed textures need a top level in whole blocks
+		if (metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || metadata.width % 4 != 0 || metadata.height % 4 != 0)
+			return false;
+
+		bool opaque = !DirectX::HasAlpha(metadata.format) || image.IsAlphaAllOpaque();
+		work.format = GetFormat(role, preset, opaque);
+		if (DirectX::IsSRGB(metadata.format))
+		{
+			work.format = DirectX::MakeSRGB(work.format);
+		}
+		if (metadata.format == work.format)
+			return false;
+
+		if (work.format == DXGI_FORMAT_BC7_UNORM || work.format == DXGI_FORMAT_BC7_UNORM_SRGB)
+		{
+			work.flags = preset == CompressionPreset::Fast ? DirectX::TEX_COMPRESS_BC7_QUICK : DirectX::TEX_COMPRESS_BC7_USE_3SUBSETS;
+		}
+
+		// Poorly compressed sources are decoded first, the encoders only take uncompressed images
+		if (DirectX::IsCompressed(metadata.format))
+		{
+			DirectX::ScratchImage decoded;
+			DXGI_FORMAT decodedFormat = DirectX::IsSRGB(metadata.format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+			hr = DirectX::Decompress(image.GetImages(), image.GetImageCount(), metadata, decodedFormat, decoded);
+			if (FAILED(hr))
+				return false;
+
+			image = std::move(decoded);
+		}
+
+		work.source = std::move(image);
+		return true;
+	}
+
+	struct Strip
+	{
+		uint32_t texture = 0;
+		uint32_t image = 0; // Mip and array slice
+		uint32_t blockRow = 0;
+	};
+
+	bool EncodeStrip(CompressWork& work, const Strip& strip)
+	{
+		const DirectX::Image& source = work.source.GetImages()[strip.image];
+		const DirectX::Image& output = work.output.GetImages()[strip.image];
+
+		size_t firstRow = static_cast<size_t>(strip.blockRow) * 4;
+		DirectX::Image rows = source;
+		rows.height = std::min(StripBlockRows * 4, source.height - firstRow);
+		rows.pixels = source.pixels + firstRow * source.rowPitch;
+		rows.slicePitch = rows.rowPitch * rows.height;
+
+		// Compress only returns a new image, so each strip is encoded into its own and then copied over
+		DirectX::ScratchImage encoded;
+		HRESULT hr = DirectX::Compress(rows, work.format, work.flags, DirectX::TEX_THRESHOLD_DEFAULT, encoded);
+		if (FAILED(hr))
+			return false;
+
+		// A row of blocks has the same pitch in the strip as in the whole image
+		memcpy(output.pixels + strip.blockRow * output.rowPitch, encoded.GetPixels(), encoded.GetPixelsSize());
+		return true;
+	}
+
+	// Top level of a map as linear RGBA8
+	bool LoadChannel(const BlackJawz::Scene::Blob& dds, DirectX::ScratchImage& result, BlackJawz::Jobs::JobSystem* jobSystem = nullptr)
+	{
+		DirectX::TexMetadata metadata;
+		DirectX::ScratchImage image;
+		HRESULT hr = DirectX::LoadFromDDSMemory(dds.data, dds.size, DirectX::DDS_FLAGS_NONE, &metadata, image);
+		if (FAILED(hr) || metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D)
+			return false;
+
+		DirectX::ScratchImage top;
+		const DirectX::Image& source = *image.GetImage(0, 0, 0);
+		if (DirectX::IsCompressed(source.format))
+		{
+			hr = DirectX::Decompress(source, DirectX::IsSRGB(source.format) ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM, top);
+		}
+		else
+		{
+			hr = top.InitializeFromImage(source);
+		}
+		if (FAILED(hr))
+			return false;
+
+		// sRGB maps are converted to the values the shader would have sampled from them
+		if (top.GetMetadata().format != DXGI_FORMAT_R8G8B8A8_UNORM)
+		{
+#ifdef DIRECTX_TEX_TASK_EXECUTOR
+			DirectX::ConvertOptions options = {};
+			options.filter = DirectX::TEX_FILTER_DEFAULT;
+			options.threshold = DirectX::TEX_THRESHOLD_DEFAULT;
+			options.executor = MakeTaskExecutor(jobSystem);
+			hr = DirectX::ConvertEx(*top.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM, options, result);
+#else
+			(void)jobSystem;
+			hr = DirectX::Convert(*top.GetImage(0, 0, 0), DXGI_FORMAT_R8G8B8A8_UNORM, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, result);
+#endif
+			return SUCCEEDED(hr);
+		}
+
+		result = std::move(top);
+		return true;
+	}
+
+	void CountResults(const std::vector<BlackJawz::Scene::Blob>& textures, const std::vector<BlackJawz::Scene::Blob>& results,
+		BlackJawz::Tools::TextureCompressStats& stats)
+	{
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			if (results[i].Empty())
+				continue;
+
+			++stats.texturesCompressed;
+			stats.inputBytes += textures[i].size;
+			stats.outputBytes += results[i].size;
+		}
+	}
+#endif
+
+#if defined(BLACKJAWZ_HAS_DIRECTXTEX) && defined(DIRECTX_TEX_TASK_EXECUTOR)
+	const char* GetFormatName(DXGI_FORMAT format)
+	{
+		switch (format)
+		{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+			return "RGBA8";
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+			return "RGBA8_SRGB";
+		case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			return "RGBA16F";
+		case DXGI_FORMAT_R32G32B32A32_FLOAT:
+			return "RGBA32F";
+		case DXGI_FORMAT_R32G32B32_FLOAT:
+			return "RGB32F";
+		default:
+			return "other";
+		}
+	}
+
+	const char* GetFilterName(DirectX::TEX_FILTER_FLAGS filter)
+	{
+		switch (filter & DirectX::TEX_FILTER_MODE_MASK)
+		{
+		case DirectX::TEX_FILTER_POINT:
+			return "point";
+		case DirectX::TEX_FILTER_LINEAR:
+			return "linear";
+		case DirectX::TEX_FILTER_CUBIC:
+			return "cubic";
+		case DirectX::TEX_FILTER_BOX:
+			return "box";
+		case DirectX::TEX_FILTER_TRIANGLE:
+			return "triangle";
+		default:
+			return "default";
+		}
+	}
+
+	// Random channels between 0 and 1 for 8-bit formats, between 0 and 4 for half floats. A depth of 0 makes a 2D image.
+	bool MakeRandomImage(DXGI_FORMAT format, size_t width, size_t height, size_t depth, DirectX::ScratchImage& image)
+	{
+		DirectX::ScratchImage source;
+		HRESULT hr = depth > 0 ? source.Initialize3D(DXGI_FORMAT_R32G32B32A32_FLOAT, width, height, depth, 1)
+			: source.Initialize2D(DXGI_FORMAT_R32G32B32A32_FLOAT, width, height, 1, 1);
+		if (FAILED(hr))
+			return false;
+
+		std::mt19937 random(46);
+		std::uniform_real_distribution<float> value(0.0f, format == DXGI_FORMAT_R16G16B16A16_FLOAT ? 4.0f : 1.0f);
+		float* pixels = reinterpret_cast<float*>(source.GetPixels());
+		for (size_t i = 0; i < source.GetPixelsSize() / sizeof(float); ++i)
+		{
+			pixels[i] = value(random);
+		}
+
+		hr = DirectX::Convert(source.GetImages(), source.GetImageCount(), source.GetMetadata(), format,
+			DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, image);
+		return SUCCEEDED(hr);
+	}
+
+	// Runs an operation once without an executor and once with one, run gets null for the serial overload
+	template <typename Run>
+	BlackJawz::Tools::TaskExecutorCheck CompareExecutor(std::string name, const DirectX::TaskExecutor& executor, Run&& run)
+	{
+		BlackJawz::Tools::TaskExecutorCheck check;
+		check.name = std::move(name);
+
+		DirectX::ScratchImage results[2];
+		double times[2] = {};
+		for (int parallel = 0; parallel < 2; ++parallel)
+		{
+			auto start = std::chrono::steady_clock::now();
+			HRESULT hr = run(parallel ? &executor : nullptr, results[parallel]);
+			times[parallel] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (FAILED(hr))
+				return check;
+		}
+
+		check.serialMs = times[0];
+		check.executorMs = times[1];
+		check.bytes = results[0].GetPixelsSize();
+		if (results[1].GetPixelsSize() != check.bytes || results[1].GetMetadata().mipLevels != results[0].GetMetadata().mipLevels)
+			return check;
+
+		check.succeeded = true;
+		const uint8_t* serial = results[0].GetPixels();
+		const uint8_t* parallel = results[1].GetPixels();
+		for (size_t i = 0; i < check.bytes; ++i)
+		{
+			check.mismatchedBytes += serial[i] != parallel[i] ? 1 : 0;
+		}
+		return check;
+	}
+
+	BlackJawz::Tools::TaskExecutorCheck CompareMips(const DirectX::ScratchImage& source, DirectX::TEX_FILTER_FLAGS filter,
+		const DirectX::TaskExecutor& executor)
+	{
+		const DirectX::TexMetadata& metadata = source.GetMetadata();
+		const bool volume = metadata.dimension == DirectX::TEX_DIMENSION_TEXTURE3D;
+		std::string name = std::string(volume ? "GenerateMipMaps3D " : "GenerateMipMaps ") + GetFormatName(metadata.format) + " " +
+			std::to_string(metadata.width) + "x" + std::to_string(metadata.height) + (volume ? "x" + std::to_string(metadata.depth) : "") +
+			" " + GetFilterName(filter);
+
+		// The WIC paths stay on the calling thread, only the custom filters are split
+		filter |= DirectX::TEX_FILTER_FORCE_NON_WIC;
+		return CompareExecutor(std::move(name), executor, [&](const DirectX::TaskExecutor* parallel, DirectX::ScratchImage& result)
+			{
+				if (volume)
+				{
+					return parallel ? DirectX::GenerateMipMaps3D(source.GetImages(), source.GetImageCount(), metadata, filter, 0, *parallel, result)
+						: DirectX::GenerateMipMaps3D(source.GetImages(), source.GetImageCount(), metadata, filter, 0, result);
+				}
+				return parallel ? DirectX::GenerateMipMaps(source.GetImages(), source.GetImageCount(), metadata, filter, 0, *parallel, result)
+					: DirectX::GenerateMipMaps(source.GetImages(), source.GetImageCount(), metadata, filter, 0, result);
+			});
+	}
+
+	BlackJawz::Tools::TaskExecutorCheck CompareResize(const DirectX::ScratchImage& source, size_t width, size_t height,
+		DirectX::TEX_FILTER_FLAGS filter, const DirectX::TaskExecutor& executor)
+	{
+		const DirectX::TexMetadata& metadata = source.GetMetadata();
+		std::string name = std::string("Resize ") + GetFormatName(metadata.format) + " " + std::to_string(metadata.width) + "x" +
+			std::to_string(metadata.height) + " to " + std::to_string(width) + "x" + std::to_string(height) + " " + GetFilterName(filter);
+
+		filter |= DirectX::TEX_FILTER_FORCE_NON_WIC;
+		return CompareExecutor(std::move(name), executor, [&](const DirectX::TaskExecutor* parallel, DirectX::ScratchImage& result)
+			{
+				return parallel ? DirectX::Resize(source.GetImages(), source.GetImageCount(), metadata, width, height, filter, *parallel, result)
+					: DirectX::Resize(source.GetImages(), source.GetImageCount(), metadata, width, height, filter, result);
+			});
+	}
+
+	// Each channel of a 16-bit image holds every value four times
+	constexpr size_t ConvertCheckSize = 512;
+
+	// Float bit patterns at the edges of the half range and beyond, first in every float source
+	constexpr uint32_t SpecialFloatBits[] =
+	{
+		0x00000000, 0x80000000, // Zero, negative zero
+		0x3f800000, 0xbf800000, // 1, -1
+		0x477fe000, 0xc77fe000, // Largest half, 65504
+		0x477fe100, 0x477fefff, // Round down to it
+		0x477ff000, 0xc77ff000, // 65520, which rounds to infinity unless clamped
+		0x47c35000, 0xc7c35000, // 100000
+		0x7f7fffff, 0xff7fffff, // Largest float
+		0x7f800000, 0xff800000, // Infinities
+		0x7fc00000, 0xffc00000, 0x7f800001, 0x7fbfffff, // Quiet, negative and signalling NaNs
+		0x38800000, 0x387fffff, // Smallest normal half and just below it
+		0x33800000, 0x33000000, 0x32ffffff, // Smallest half subnormal, half of it, just below half of it
+		0x2edbe6ff, 0x00800000, 0x000116c2 // 1e-10, smallest normal float, a float subnormal
+	};
+
+	// Consecutive pixels step each channel through every value, with a different odd stride per channel
+	template <typename T>
+	bool MakeEveryValueImage(DXGI_FORMAT format, DirectX::ScratchImage& image)
+	{
+		if (FAILED(image.Initialize2D(format, ConvertCheckSize, ConvertCheckSize, 1, 1)))
+			return false;
+
+		constexpr uint32_t strides[4] = { 1, 3, 5, 11 };
+		const DirectX::Image& target = *image.GetImage(0, 0, 0);
+		for (size_t y = 0; y < target.height; ++y)
+		{
+			T* row = reinterpret_cast<T*>(target.pixels + y * target.rowPitch);
+			for (size_t x = 0; x < target.width; ++x)
+			{
+				uint32_t index = static_cast<uint32_t>(y * target.width + x);
+				for (uint32_t channel = 0; channel < 4; ++channel)
+				{
+					row[x * 4 + channel] = static_cast<T>(index * strides[channel] + channel);
+				}
+			}
+		}
+		return true;
+	}
+
+	// The special values, then random bit patterns and random values around the half range in turn
+	bool MakeFloatImage(DXGI_FORMAT format, size_t channels, DirectX::ScratchImage& image)
+	{
+		if (FAILED(image.Initialize2D(format, ConvertCheckSize, ConvertCheckSize, 1, 1)))
+			return false;
+
+		std::mt19937 random(47);
+		std::uniform_real_distribution<float> nearHalfRange(-70000.0f, 70000.0f);
+
+		const DirectX::Image& target = *image.GetImage(0, 0, 0);
+		size_t index = 0;
+		for (size_t y = 0; y < target.height; ++y)
+		{
+			uint8_t* row = target.pixels + y * target.rowPitch;
+			for (size_t x = 0; x < target.width * channels; ++x, ++index)
+			{
+				uint32_t bits = 0;
+				if (index < std::size(SpecialFloatBits))
+				{
+					bits = SpecialFloatBits[index];
+				}
+				else if (index % 2)
+				{
+					bits = static_cast<uint32_t>(random());
+				}
+				else
+				{
+					float value = nearHalfRange(random);
+					memcpy(&bits, &value, sizeof(bits));
+				}
+				memcpy(row + x * sizeof(bits), &bits, sizeof(bits));
+			}
+		}
+		return true;
+	}
+
+	BlackJawz::Tools::TaskExecutorCheck CompareConversion(const DirectX::Image& source, DXGI_FORMAT format,
+		DirectX::TEX_FILTER_FLAGS filter, const DirectX::TaskExecutor& executor)
+	{
+		std::string name = std::string("Convert ") + GetFormatName(source.format) + " " + std::to_string(source.width) + "x" +
+			std::to_string(source.height) + " to " + GetFormatName(format);
+		if (filter & DirectX::TEX_FILTER_SRGB_IN)
+		{
+			name += ", sRGB in";
+		}
+		if (filter & DirectX::TEX_FILTER_SRGB_OUT)
+		{
+			name += ", sRGB out";
+		}
+
+		return CompareExecutor(std::move(name), executor, [&](const DirectX::TaskExecutor* parallel, DirectX::ScratchImage& result)
+			{
+				DirectX::ConvertOptions options = {};
+				options.filter = filter | DirectX::TEX_FILTER_FORCE_NON_WIC;
+				options.threshold = DirectX::TEX_THRESHOLD_DEFAULT;
+				if (parallel)
+				{
+					options.executor = *parallel;
+				}
+				return DirectX::ConvertEx(source, format, options, result);
+			});
+	}
+#endif
+
+}
+
+bool BlackJawz::Tools::HasTextureProcessing()
+{
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	return true;
+#else
+	return false;
+#endif
+}
+
+BlackJawz::Scene::Blob BlackJawz::Tools::GenerateTextureMips(const Scene::Blob& dds, Jobs::JobSystem* jobSystem)
+{
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	DirectX::TexMetadata metadata;
+	DirectX::ScratchImage image;
+	HRESULT hr = DirectX::LoadFromDDSMemory(dds.data, dds.size, DirectX::DDS_FLAGS_NONE, &metadata, image);
+	if (FAILED(hr))
+		return Scene::Blob();
+
+	// Block compressed textures are left to the BC encoder, which builds their mips itself
+	if (metadata.mipLevels > 1 || metadata.dimension != DirectX::TEX_DIMENSION_TEXTURE2D || DirectX::IsCompressed(metadata.format))
+		return Scene::Blob();
+
+	DirectX::ScratchImage mipChain;
+#ifdef DIRECTX_TEX_TASK_EXECUTOR
+	// The same filter as before, so the chain does not change. Formats that go through WIC stay serial.
+	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), metadata, DirectX::TEX_FILTER_DEFAULT, 0,
+		MakeTaskExecutor(jobSystem), mipChain);
+#else
+	(void)jobSystem;
+	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), metadata, DirectX::TEX_FILTER_DEFAULT, 0, mipChain);
+#endif
+	if (FAILED(hr))
+		return Scene::Blob();
+
+	return SaveDDS(mipChain);
+#else
+	(void)dds;
+	(void)jobSystem;
+	return Scene::Blob();
+#endif
+}
+
+BlackJawz::Scene::Blob BlackJawz::Tools::PackTextureChannels(const std::array<Scene::Blob, 4>& channels)
+{
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	std::array<DirectX::ScratchImage, 4> images;
+	size_t width = 0;
+	size_t height = 0;
+	for (size_t channel = 0; channel < channels.size(); ++channel)
+	{
+		if (channels[channel].Empty())
+			continue;
+
+		if (!LoadChannel(channels[channel], images[channel]))
+			return Scene::Blob();
+
+		width = std::max(width, images[channel].GetMetadata().width);
+		height = std::max(height, images[channel].GetMetadata().height);
+	}
+
+	if (width == 0 || height == 0)
+		return Scene::Blob();
+
+	// Smaller maps are scaled up to the largest, a 1K AO map next to a 2K roughness map is common
+	for (DirectX::ScratchImage& image : images)
+	{
+		if (image.GetImageCount() == 0 || (image.GetMetadata().width == width && image.GetMetadata().height == height))
+			continue;
+
+		DirectX::ScratchImage resized;
+		HRESULT hr = DirectX::Resize(*image.GetImage(0, 0, 0), width, height, DirectX::TEX_FILTER_DEFAULT, resized);
+		if (FAILED(hr))
+			return Scene::Blob();
+
+		image = std::move(resized);
+	}
+
+	DirectX::ScratchImage packed;
+	HRESULT hr = packed.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, 1, 1);
+	if (FAILED(hr))
+		return Scene::Blob();
+
+	const DirectX::Image& output = *packed.GetImage(0, 0, 0);
+	for (size_t channel = 0; channel < images.size(); ++channel)
+	{
+		const DirectX::Image* input = images[channel].GetImageCount() > 0 ? images[channel].GetImage(0, 0, 0) : nullptr;
+		for (size_t y = 0; y < height; ++y)
+		{
+			uint8_t* outputRow = output.pixels + y * output.rowPitch;
+			const uint8_t* inputRow = input ? input->pixels + y * input->rowPitch : nullptr;
+			for (size_t x = 0; x < width; ++x)
+			{
+				outputRow[x * 4 + channel] = inputRow ? inputRow[x * 4] : PackedChannelDefaults[channel];
+			}
+		}
+	}
+
+	return SaveDDS(packed);
+#else
+	(void)channels;
+	return Scene::Blob();
+#endif
+}
+
+BlackJawz::Scene::Blob BlackJawz::Tools::GenerateConeStepMap(const Scene::Blob& dds, size_t channel, Jobs::JobSystem* jobSystem,
+	uint32_t searchRadius)
+{
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	DirectX::ScratchImage image;
+	if (channel >= 4 || !LoadChannel(dds, image, jobSystem))
+		return Scene::Blob();
+
+	const DirectX::Image& input = *image.GetImage(0, 0, 0);
+	std::vector<float> depths(input.width * input.height);
+	bool flat = true;
+	for (size_t y = 0; y < input.height; ++y)
+	{
+		const uint8_t* inputRow = input.pixels + y * input.rowPitch;
+		for (size_t x = 0; x < input.width; ++x)
+		{
+			uint8_t depth = inputRow[x * 4 + channel];
+			depths[y * input.width + x] = depth / 255.0f;
+			flat = flat && depth == 0;
+		}
+	}
+
+	// Nothing to march through, the shader would not move the texture coordinates
+	if (flat)
+		return Scene::Blob();
+
+	uint32_t width = static_cast<uint32_t>(input.width);
+	uint32_t height = static_cast<uint32_t>(input.height);
+	std::vector<uint8_t> texels = EncodeConeStepMap(depths, GenerateConeRatios(depths, width, height, searchRadius, jobSystem));
+
+	DirectX::ScratchImage coneMap;
+	HRESULT hr = coneMap.Initialize2D(DXGI_FORMAT_R8G8_UNORM, width, height, 1, 1);
+	if (FAILED(hr))
+		return Scene::Blob();
+
+	const DirectX::Image& output = *coneMap.GetImage(0, 0, 0);
+	for (size_t y = 0; y < height; ++y)
+	{
+		memcpy(output.pixels + y * output.rowPitch, texels.data() + y * width * 2, width * 2);
+	}
+
+	return SaveDDS(coneMap);
+#else
+	(void)dds;
+	(void)channel;
+	(void)jobSystem;
+	(void)searchRadius;
+	return Scene::Blob();
+#endif
+}
+
+BlackJawz::Tools::TextureRole BlackJawz::Tools::GetTextureRole(Scene::TextureSlot slot)
+{
+	switch (slot)
+	{
+	case Scene::TextureSlot::Diffuse:
+		return TextureRole::Colour;
+	case Scene::TextureSlot::Normal:
+		return TextureRole::Normal;
+	case Scene::TextureSlot::Metal:
+	case Scene::TextureSlot::Roughness:
+	case Scene::TextureSlot::AO:
+	case Scene::TextureSlot::Displacement:
+		return TextureRole::Mask;
+	case Scene::TextureSlot::Packed:
+		return TextureRole::Packed;
+	case Scene::TextureSlot::ConeStep:
+		return TextureRole::Mixed; // Block compression could widen the cones
+	default:
+		return TextureRole::Mixed;
+	}
+}
+
+BlackJawz::Tools::TextureRole BlackJawz::Tools::CombineTextureRoles(TextureRole a, TextureRole b)
+{
+	return a == b ? a : TextureRole::Mixed;
+}
+
+std::vector<BlackJawz::Scene::Blob> BlackJawz::Tools::CompressTextures(const std::vector<Scene::Blob>& textures,
+	const std::vector<TextureRole>& roles, CompressionPreset preset, Jobs::JobSystem& jobSystem, TextureCompressStats& stats)
+{
+	stats = TextureCompressStats();
+	std::vector<Scene::Blob> results(textures.size());
+
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	std::vector<CompressWork> work(textures.size());
+	std::vector<uint8_t> prepared(textures.size(), 0);
+
+	Jobs::JobCounter prepareCounter;
+	jobSystem.Dispatch(prepareCounter, static_cast<uint32_t>(textures.size()), 1, [&](uint32_t index)
+		{
+			if (!Prepare(textures[index], roles[index], preset, work[index]))
+				return;
+
+			DirectX::TexMetadata metadata = work[index].source.GetMetadata();
+			metadata.format = work[index].format;
+			prepared[index] = SUCCEEDED(work[index].output.Initialize(metadata));
+		});
+	jobSystem.Wait(prepareCounter);
+
+	// Every mip of every texture in one dispatch, the small mips are cheap and fill in around the large strips
+	std::vector<Strip> strips;
+	for (uint32_t texture = 0; texture < textures.size(); ++texture)
+	{
+		if (!prepared[texture])
+			continue;
+
+		const DirectX::ScratchImage& source = work[texture].source;
+		for (uint32_t image = 0; image < source.GetImageCount(); ++image)
+		{
+			size_t blockRows = (source.GetImages()[image].height + 3) / 4;
+			for (size_t blockRow = 0; blockRow < blockRows; blockRow += StripBlockRows)
+			{
+				strips.push_back({ texture, image, static_cast<uint32_t>(blockRow) });
+			}
+		}
+	}
+
+	std::vector<std::atomic<bool>> failed(textures.size());
+	Jobs::JobCounter encodeCounter;
+	jobSystem.Dispatch(encodeCounter, static_cast<uint32_t>(strips.size()), 1, [&](uint32_t index)
+		{
+			const Strip& strip = strips[index];
+			if (!EncodeStrip(work[strip.texture], strip))
+			{
+				failed[strip.texture].store(true, std::memory_order_relaxed);
+			}
+		});
+	jobSystem.Wait(encodeCounter);
+
+	Jobs::JobCounter saveCounter;
+	jobSystem.Dispatch(saveCounter, static_cast<uint32_t>(textures.size()), 1, [&](uint32_t index)
+		{
+			if (prepared[index] && !failed[index].load(std::memory_order_relaxed))
+			{
+				results[index] = SaveDDS(work[index].output);
+			}
+			work[index] = CompressWork();
+		});
+	jobSystem.Wait(saveCounter);
+
+	stats.blockJobs = strips.size();
+	CountResults(textures, results, stats);
+#else
+	(void)roles;
+	(void)preset;
+	(void)jobSystem;
+#endif
+
+	return results;
+}
+
+std::vector<BlackJawz::Scene::Blob> BlackJawz::Tools::CompressTexturesSerial(const std::vector<Scene::Blob>& textures,
+	const std::vector<TextureRole>& roles, CompressionPreset preset, TextureCompressStats& stats)
+{
+	stats = TextureCompressStats();
+	std::vector<Scene::Blob> results(textures.size());
+
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	for (size_t i = 0; i < textures.size(); ++i)
+	{
+		CompressWork work;
+		if (!Prepare(textures[i], roles[i], preset, work))
+			continue;
+
+		DirectX::ScratchImage encoded;
+		HRESULT hr = DirectX::Compress(work.source.GetImages(), work.source.GetImageCount(), work.source.GetMetadata(),
+			work.format, work.flags, DirectX::TEX_THRESHOLD_DEFAULT, encoded);
+		if (SUCCEEDED(hr))
+		{
+			results[i] = SaveDDS(encoded);
+		}
+	}
+
+	CountResults(textures, results, stats);
+#else
+	(void)roles;
+	(void)preset;
+#endif
+
+	return results;
+}
+
+bool BlackJawz::Tools::SaveTextureFile(const Scene::Blob& dds, TextureFileType type, const std::string& filename)
+{
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	if (type == TextureFileType::DDS)
+	{
+		std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(dds.data), static_cast<std::streamsize>(dds.size));
+		return static_cast<bool>(file);
+	}
+
+	DirectX::ScratchImage top;
+	if (!LoadChannel(dds, top))
+		return false;
+
+	std::wstring path = std::filesystem::path(filename).wstring();
+	if (type == TextureFileType::TGA)
+	{
+		HRESULT hr = DirectX::SaveToTGAFile(*top.GetImage(0, 0, 0), DirectX::TGA_FLAGS_NONE, path.c_str());
+		return SUCCEEDED(hr);
+	}
+
+	DirectX::ScratchImage hdr;
+	HRESULT hr = DirectX::Convert(*top.GetImage(0, 0, 0), DXGI_FORMAT_R32G32B32A32_FLOAT, DirectX::TEX_FILTER_DEFAULT,
+		DirectX::TEX_THRESHOLD_DEFAULT, hdr);
+	if (FAILED(hr))
+		return false;
+
+	hr = DirectX::SaveToHDRFile(*hdr.GetImage(0, 0, 0), path.c_str());
+	return SUCCEEDED(hr);
+#else
+	(void)dds;
+	(void)type;
+	(void)filename;
+	return false;
+#endif
+}
+
+uint64_t BlackJawz::Tools::LoadTextureFile(const std::string& filename, TextureFileType type)
+{
+#ifdef BLACKJAWZ_HAS_DIRECTXTEX
+	std::wstring path = std::filesystem::path(filename).wstring();
+	DirectX::ScratchImage image;
+	HRESULT hr = E_FAIL;
+	switch (type)
+	{
+	case TextureFileType::DDS:
+		hr = DirectX::LoadFromDDSFile(path.c_str(), DirectX::DDS_FLAGS_NONE, nullptr, image);
+		break;
+	case TextureFileType::HDR:
+		hr = DirectX::LoadFromHDRFile(path.c_str(), nullptr, image);
+		break;
+	case TextureFileType::TGA:
+		hr = DirectX::LoadFromTGAFile(path.c_str(), DirectX::TGA_FLAGS_NONE, nullptr, image);
+		break;
+	}
+
+	return SUCCEEDED(hr) ? image.GetPixelsSize() : 0;
+#else
+	(void)filename;
+	(void)type;
+	return 0;
+#endif
+}
+
+bool BlackJawz::Tools::HasTaskExecutor()
+{
+#if defined(BLACKJAWZ_HAS_DIRECTXTEX) && defined(DIRECTX_TEX_TASK_EXECUTOR)
+	return true;
+#else
+	return false;
+#endif
+}
+
+std::vector<BlackJawz::Tools::TaskExecutorCheck> BlackJawz::Tools::CheckTaskExecutor(Jobs::JobSystem& jobSystem)
+{
+	std::vector<TaskExecutorCheck> checks;
+#if defined(BLACKJAWZ_HAS_DIRECTXTEX) && defined(DIRECTX_TEX_TASK_EXECUTOR)
+	const DirectX::TaskExecutor executor = MakeTaskExecutor(&jobSystem);
+	const DirectX::TEX_FILTER_FLAGS filters[] =
+	{
+		DirectX::TEX_FILTER_POINT,
+		DirectX::TEX_FILTER_LINEAR,
+		DirectX::TEX_FILTER_CUBIC,
+		DirectX::TEX_FILTER_BOX,
+		DirectX::TEX_FILTER_TRIANGLE
+	};
+
+	// Power of two, odd and one pixel wide or high, the last levels of each are a single strip
+	const std::array<size_t, 2> sizes[] = { { 1024, 1024 }, { 1023, 517 }, { 1, 777 }, { 777, 1 } };
+	for (DXGI_FORMAT format : { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R16G16B16A16_FLOAT })
+	{
+		for (const std::array<size_t, 2>& size : sizes)
+		{
+			DirectX::ScratchImage source;
+			if (!MakeRandomImage(format, size[0], size[1], 0, source))
+				return checks;
+
+			for (DirectX::TEX_FILTER_FLAGS filter : filters)
+			{
+				checks.push_back(CompareMips(source, filter, executor));
+			}
+		}
+
+		// Volumes split by slice, a depth of one goes through the 2D strips
+		const std::array<size_t, 3> volumes[] = { { 256, 256, 1 }, { 65, 33, 17 }, { 128, 128, 32 } };
+		for (const std::array<size_t, 3>& size : volumes)
+		{
+			DirectX::ScratchImage source;
+			if (!MakeRandomImage(format, size[0], size[1], size[2], source))
+				return checks;
+
+			for (DirectX::TEX_FILTER_FLAGS filter : filters)
+			{
+				checks.push_back(CompareMips(source, filter, executor));
+			}
+		}
+
+		// Up, down and a mix of both
+		DirectX::ScratchImage source;
+		if (!MakeRandomImage(format, 1023, 517, 0, source))
+			return checks;
+
+		const std::array<size_t, 2> targets[] = { { 1536, 1100 }, { 300, 200 }, { 2000, 77 } };
+		for (const std::array<size_t, 2>& target : targets)
+		{
+			for (DirectX::TEX_FILTER_FLAGS filter : filters)
+			{
+				checks.push_back(CompareResize(source, target[0], target[1], filter, executor));
+			}
+		}
+	}
+
+	const DirectX::TEX_FILTER_FLAGS srgbFilters[] =
+	{
+		DirectX::TEX_FILTER_DEFAULT,
+		DirectX::TEX_FILTER_SRGB_IN,
+		DirectX::TEX_FILTER_SRGB_OUT,
+		DirectX::TEX_FILTER_SRGB
+	};
+
+	// Conversions of every 8-bit value, the same bytes read as linear and as sRGB
+	for (DXGI_FORMAT sourceFormat : { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB })
+	{
+		DirectX::ScratchImage source;
+		if (!MakeEveryValueImage<uint8_t>(sourceFormat, source))
+			return checks;
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB,
+			DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT })
+		{
+			if (format == sourceFormat)
+				continue;
+
+			for (DirectX::TEX_FILTER_FLAGS filter : srgbFilters)
+			{
+				checks.push_back(CompareConversion(*source.GetImage(0, 0, 0), format, filter, executor));
+			}
+		}
+	}
+
+	// Every half, including NaNs, infinities, negatives and subnormals
+	{
+		DirectX::ScratchImage source;
+		if (!MakeEveryValueImage<uint16_t>(DXGI_FORMAT_R16G16B16A16_FLOAT, source))
+			return checks;
+
+		for (DXGI_FORMAT format : { DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB })
+		{
+			for (DirectX::TEX_FILTER_FLAGS filter : srgbFilters)
+			{
+				checks.push_back(CompareConversion(*source.GetImage(0, 0, 0), format, filter, executor));
+			}
+		}
+	}
+
+	// Floats at and beyond the half range, and RGB to RGBA
+	{
+		DirectX::ScratchImage source;
+		if (!MakeFloatImage(DXGI_FORMAT_R32G32B32A32_FLOAT, 4, source))
+			return checks;
+
+		for (DirectX::TEX_FILTER_FLAGS filter : srgbFilters)
+		{
+			checks.push_back(CompareConversion(*source.GetImage(0, 0, 0), DXGI_FORMAT_R16G16B16A16_FLOAT, filter, executor));
+		}
+	}
+	{
+		DirectX::ScratchImage source;
+		if (!MakeFloatImage(DXGI_FORMAT_R32G32B32_FLOAT, 3, source))
+			return checks;
+
+		for (DirectX::TEX_FILTER_FLAGS filter : srgbFilters)
+		{
+			checks.push_back(CompareConversion(*source.GetImage(0, 0, 0), DXGI_FORMAT_R32G32B32A32_FLOAT, filter, executor));
+		}
+	}
+
+	// Timings at the sizes the cooker sees for hero textures
+	DirectX::ScratchImage large;
+	if (!MakeRandomImage(DXGI_FORMAT_R8G8B8A8_UNORM, 4096, 4096, 0, large))
+		return checks;
+
+	for (DirectX::TEX_FILTER_FLAGS filter : { DirectX::TEX_FILTER_BOX, DirectX::TEX_FILTER_LINEAR, DirectX::TEX_FILTER_CUBIC })
+	{
+		checks.push_back(CompareMips(large, filter, executor));
+	}
+	checks.push_back(CompareResize(large, 8192, 8192, DirectX::TEX_FILTER_LINEAR, executor));
+	checks.push_back(CompareConversion(*large.GetImage(0, 0, 0), DXGI_FORMAT_R32G32B32A32_FLOAT, DirectX::TEX_FILTER_SRGB_IN, executor));
+#else
+	(void)jobSystem;
+#endif
+	return checks;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "ConeStepMap.h"
+#include "Scene/SceneData.h"
+#include "Util/JobSystem.h"
+
+#include <array>
+
+namespace BlackJawz::Tools
+{
+	// Whether this build links DirectXTex and can process textures
+	bool HasTextureProcessing();
+
+	// Adds a full mip chain to an uncompressed single mip 2D texture. Returns an empty blob when
+	// the texture is left as it is, which is always the case without DirectXTex. Given a job system,
+	// a DirectXTex that takes a task executor filters each level in strips of rows on its workers.
+	Scene::Blob GenerateTextureMips(const Scene::Blob& dds, Jobs::JobSystem* jobSystem = nullptr);
+
+	// The slots a packed texture replaces, in the order of its red, green, blue and alpha channels
+	constexpr std::array<Scene::TextureSlot, 4> PackedChannelSlots =
+	{
+		Scene::TextureSlot::Metal, Scene::TextureSlot::Roughness, Scene::TextureSlot::AO, Scene::TextureSlot::Displacement
+	};
+
+	// Channels of missing maps, the same values the editor's placeholders give the shader
+	constexpr std::array<uint8_t, 4> PackedChannelDefaults = { 0, 128, 255, 0 };
+
+	// Packs the red channel of each map's top level into one single mip RGBA8 texture, at the largest
+	// size among them. Empty maps take their channel's default. Returns an empty blob when a map is not
+	// a 2D texture or cannot be decoded, which is always the case without DirectXTex.
+	Scene::Blob PackTextureChannels(const std::array<Scene::Blob, 4>& channels);
+
+	// Builds a single mip RG8 relaxed cone step map, see ConeStepMap.h, from one channel of a map's top
+	// level: red of a displacement map, alpha of a packed texture. Returns an empty blob for flat maps
+	// and for maps that are not 2D or cannot be decoded, which is always the case without DirectXTex.
+	Scene::Blob GenerateConeStepMap(const Scene::Blob& dds, size_t channel, Jobs::JobSystem* jobSystem = nullptr,
+		uint32_t searchRadius = DefaultConeSearchRadius);
+
+	// What a texture holds, which picks its block compressed format
+	enum class TextureRole
+	{
+		Colour, // BC1, or BC7 with alpha or for quality
+		Normal, // BC5, the shader rebuilds z
+		Mask, // BC4, the shader reads red only
+		Packed, // BC7, four independent mask channels
+		Mixed // Bound to slots with different roles, or a cone step map, left as it is
+	};
+
+	TextureRole GetTextureRole(Scene::TextureSlot slot);
+
+	// Textures bound to several slots keep a role only when every slot agrees
+	TextureRole CombineTextureRoles(TextureRole a, TextureRole b);
+
+	enum class CompressionPreset
+	{
+		Fast, // BC1 colour, quick BC7 for colour with alpha
+		Quality // BC7 colour searching every partition mode
+	};
+
+	struct TextureCompressStats
+	{
+		size_t texturesCompressed = 0;
+		size_t blockJobs = 0; // Strips of block rows encoded as separate jobs
+		uint64_t inputBytes = 0;
+		uint64_t outputBytes = 0;
+	};
+
+	// Block compresses textures by role. The textures are decoded in parallel, then every mip of
+	// every texture is cut into strips of block rows encoded as separate jobs, so a single large BC7
+	// texture still keeps every worker busy. Results are empty for textures left as they are:
+	// without DirectXTex, not 2D, Mixed, or already in their format.
+	std::vector<Scene::Blob> CompressTextures(const std::vector<Scene::Blob>& textures, const std::vector<TextureRole>& roles,
+		CompressionPreset preset, Jobs::JobSystem& jobSystem, TextureCompressStats& stats);
+
+	// The same through DirectXTex's whole image compressor, one texture after another on the calling
+	// thread. The baseline CompressTextures is benchmarked against.
+	std::vector<Scene::Blob> CompressTexturesSerial(const std::vector<Scene::Blob>& textures, const std::vector<TextureRole>& roles,
+		CompressionPreset preset, TextureCompressStats& stats);
+
+	// Texture file containers DirectXTex loads from disk
+	enum class TextureFileType
+	{
+		DDS,
+		HDR, // Float RGB
+		TGA
+	};
+
+	// Writes the top level of a DDS texture as a file of the given type. False without DirectXTex.
+	bool SaveTextureFile(const Scene::Blob& dds, TextureFileType type, const std::string& filename);
+
+	// Decodes a texture file. Returns the decoded bytes, 0 when the load fails or without DirectXTex.
+	uint64_t LoadTextureFile(const std::string& filename, TextureFileType type);
+
+	// Whether DirectXTex takes a task executor for mips, resizes and conversions, only the copy in the repository does
+	bool HasTaskExecutor();
+
+	// One operation run with the serial overload and with a job system backed task executor
+	struct TaskExecutorCheck
+	{
+		std::string name;
+		bool succeeded = false; // Both runs succeeded and gave the same layout
+		uint64_t bytes = 0;
+		uint64_t mismatchedBytes = 0;
+		double serialMs = 0.0;
+		double executorMs = 0.0;
+	};
+
+	// Generates mips, volume mips and resizes of random 8-bit and half float images with every custom filter,
+	// at power of two, odd and one pixel wide sizes. Converts images holding every 8 and 16-bit channel value,
+	// and floats that are NaN, infinite, negative or out of the half range. Then times 4096 square images.
+	// Empty without the executor.
+	std::vector<TaskExecutorCheck> CheckTaskExecutor(Jobs::JobSystem& jobSystem);
+}
@@ -0,0 +1,189 @@
+#include "SceneCooker.h"
+#include "TextureProcessing.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+	void PrintUsage()
+	{
+		printf("Usage: SceneCooker [options] <input> <output>\n");
+		printf("       SceneCooker [options] -o <directory> <inputs...>\n");
+		printf("Options:\n");
+		printf("  --threads N      Worker threads, defaults to one per hardware thread\n");
+		printf("  --no-compress    Store every asset raw\n");
+		printf("  --no-reorder     Keep the editor's entity order\n");
+		printf("  --no-bounds      Do not precompute mesh bounds\n");
+		printf("  --pack-channels  Pack metal, roughness, AO and displacement into one RGBA texture per material\n");
+		printf("  --no-mips        Do not generate texture mips\n");
+		printf("  --cone-step-maps Build relaxed cone step maps from displacement for the parallax shader\n");
+		printf("  --cone-radius N  Texels the cone step maps search around each texel, default %u\n", BlackJawz::Tools::DefaultConeSearchRadius);
+		printf("  --compress-textures fast|quality  Block compress textures by role, BC1 or BC7 colour\n");
+		printf("  --pack-vertices  Quantize vertices to 20 bytes\n");
+		printf("  --no-spatial-index  Leave the entity bounds and BVH for the loader to build\n");
+	}
+
+	void PrintStats(const std::string& input, const BlackJawz::Tools::CookStats& stats)
+	{
+		printf("%s: %zu entities, %zu assets (%zu duplicates merged), %zu bounds, %zu textures processed\n",
+			input.c_str(), stats.entityCount, stats.assetCount, stats.duplicateAssets, stats.boundsComputed, stats.texturesProcessed);
+		printf("  assets %.2f MB -> %.2f MB, file %.2f MB -> %.2f MB\n",
+			stats.rawAssetBytes / (1024.0 * 1024.0), stats.storedAssetBytes / (1024.0 * 1024.0),
+			stats.inputBytes / (1024.0 * 1024.0), stats.outputBytes / (1024.0 * 1024.0));
+		if (stats.geometriesPacked > 0)
+		{
+			const BlackJawz::Scene::PackingError& error = stats.packingError;
+			printf("  vertices %.2f MB -> %.2f MB in %zu meshes, max error position %g (bound %g), normal %.3f deg, tangent %.3f deg, uv %g\n",
+				stats.unpackedVertexBytes / (1024.0 * 1024.0), stats.packedVertexBytes / (1024.0 * 1024.0), stats.geometriesPacked,
+				error.position, error.positionBound, error.normalDegrees, error.tangentDegrees, error.texC);
+		}
+		if (stats.texturesPacked > 0)
+		{
+			printf("  %zu maps %.2f MB -> %zu packed textures %.2f MB, %zu texture binds saved per frame\n",
+				stats.packedMaps, stats.packedMapBytes / (1024.0 * 1024.0), stats.texturesPacked,
+				stats.packedTextureBytes / (1024.0 * 1024.0), stats.textureBindsSaved);
+		}
+		if (stats.coneStepMaps > 0)
+		{
+			printf("  %zu cone step maps, %.1f ms\n", stats.coneStepMaps, stats.coneStepMs);
+		}
+		if (stats.texturesCompressed > 0)
+		{
+			printf("  %zu textures block compressed in %zu jobs, %.1f ms\n", stats.texturesCompressed, stats.textureBlockJobs,
+				stats.textureCompressMs);
+		}
+		if (stats.spatialIndexNodes > 0)
+		{
+			printf("  spatial index %zu nodes in %.1f ms\n", stats.spatialIndexNodes, stats.spatialIndexMs);
+		}
+		printf("  load %.1f ms, process %.1f ms, write %.1f ms\n", stats.loadMs, stats.processMs, stats.writeMs);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	BlackJawz::Tools::CookOptions options;
+	uint32_t threadCount = 0;
+	std::string outputDirectory;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			outputDirectory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--no-compress") == 0)
+		{
+			options.compressAssets = false;
+		}
+		else if (strcmp(argv[i], "--no-reorder") == 0)
+		{
+			options.reorderEntities = false;
+		}
+		else if (strcmp(argv[i], "--no-bounds") == 0)
+		{
+			options.computeBounds = false;
+		}
+		else if (strcmp(argv[i], "--pack-channels") == 0)
+		{
+			options.packChannels = true;
+		}
+		else if (strcmp(argv[i], "--no-mips") == 0)
+		{
+			options.generateMips = false;
+		}
+		else if (strcmp(argv[i], "--cone-step-maps") == 0)
+		{
+			options.coneStepMaps = true;
+		}
+		else if (strcmp(argv[i], "--cone-radius") == 0 && i + 1 < argc)
+		{
+			options.coneSearchRadius = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+		}
+		else if (strcmp(argv[i], "--compress-textures") == 0 && i + 1 < argc)
+		{
+			const char* preset = argv[++i];
+			if (strcmp(preset, "fast") != 0 && strcmp(preset, "quality") != 0)
+			{
+				PrintUsage();
+				return 2;
+			}
+			options.compressTextures = true;
+			options.compressionPreset = strcmp(preset, "quality") == 0 ?
+				BlackJawz::Tools::CompressionPreset::Quality : BlackJawz::Tools::CompressionPreset::Fast;
+		}
+		else if (strcmp(argv[i], "--pack-vertices") == 0)
+		{
+			options.packVertices = true;
+		}
+		else if (strcmp(argv[i], "--no-spatial-index") == 0)
+		{
+			options.buildSpatialIndex = false;
+		}
+		else if (argv[i][0] == '-')
+		{
+			PrintUsage();
+			return 2;
+		}
+		else
+		{
+			files.push_back(argv[i]);
+		}
+	}
+
+	// Pairs of input and output paths
+	std::vector<std::pair<std::string, std::string>> jobs;
+	if (!outputDirectory.empty())
+	{
+		std::error_code error;
+		std::filesystem::create_directories(outputDirectory, error);
+		for (const auto& file : files)
+		{
+			jobs.emplace_back(file, (std::filesystem::path(outputDirectory) / std::filesystem::path(file).filename()).string());
+		}
+	}
+	else if (files.size() == 2)
+	{
+		jobs.emplace_back(files[0], files[1]);
+	}
+
+	if (jobs.empty())
+	{
+		PrintUsage();
+		return 2;
+	}
+
+	// The calling thread helps while waiting, so it counts as a worker
+	BlackJawz::Jobs::JobSystem jobSystem(threadCount > 1 ? threadCount - 1 : threadCount);
+	BlackJawz::Tools::SceneCooker cooker(jobSystem, options);
+
+	if ((options.packChannels || options.generateMips || options.coneStepMaps || options.compressTextures) && !BlackJawz::Tools::HasTextureProcessing())
+	{
+		printf("Built without DirectXTex, textures are copied as they are\n");
+	}
+
+	int failedCount = 0;
+	for (const auto& job : jobs)
+	{
+		BlackJawz::Tools::CookStats stats;
+		if (!cooker.Cook(job.first, job.second, stats))
+		{
+			fprintf(stderr, "%s\n", cooker.GetLastError().c_str());
+			++failedCount;
+			continue;
+		}
+
+		PrintStats(job.first, stats);
+	}
+
+	return failedCount > 0 ? 1 : 0;
+}
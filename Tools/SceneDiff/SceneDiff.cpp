@@ -0,0 +1,417 @@
+#include "SceneDiff.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneJournal.h"
+#include "Scene/SceneReader.h"
+#include "Scene/SceneVerifier.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+	const char* const TextureSlotNames[BlackJawz::Scene::TextureSlotCount] =
+	{
+		"diffuse", "normal", "metal", "roughness", "ao", "displacement", "packed", "cone step"
+	};
+
+	template <typename T>
+	void DiffRecord(const char* component, const std::optional<T>& a, const std::optional<T>& b, std::vector<std::string>& fields)
+	{
+		if (a.has_value() != b.has_value())
+		{
+			fields.push_back(component);
+			return;
+		}
+		if (!a)
+			return;
+
+		for (const BlackJawz::Scene::Reflection::FieldInfo& field : BlackJawz::Scene::Reflection::Reflect<T>::Fields)
+		{
+			if (BlackJawz::Tools::IsComparedField<T>(field) && !BlackJawz::Tools::SameField(*a, *b, field))
+				fields.push_back(std::string(component) + "." + field.name);
+		}
+	}
+}
+
+bool BlackJawz::Tools::SceneSummary::Open(const std::string& filename, Jobs::JobSystem& jobSystem)
+{
+	lastError.clear();
+	entities.clear();
+	indices.clear();
+	assets.clear();
+	journalRecords.clear();
+	fileScene = nullptr;
+
+	if (!Scene::SceneReader::MapFile(filename, fileData))
+	{
+		lastError = "Failed to read " + filename;
+		return false;
+	}
+
+	// Walks the tables only, the bytes of the payloads are not touched
+	Scene::VerifyResult verifyResult = Scene::SceneVerifier::VerifyStructure(fileData.data, fileData.size);
+	if (verifyResult != Scene::VerifyResult::Valid)
+	{
+		lastError = filename + ": " + Scene::GetVerifyResultName(verifyResult);
+		return false;
+	}
+
+	fileScene = ECS::GetScene(fileData.data);
+	if (fileScene->journal_id() != 0)
+	{
+		Scene::SceneJournal::ReadDeltas(filename, fileScene->journal_id(), journalRecords);
+	}
+
+	size_t count = 0;
+	std::vector<Scene::SceneReader::EntityRange> ranges = Scene::SceneReader::GetEntityRanges(fileScene, count);
+	size_t baseCount = count;
+	for (const Scene::Blob& record : journalRecords)
+	{
+		Scene::SceneReader::AddDeltaRanges(record, ranges, count);
+	}
+
+	std::vector<EntitySummary> decoded(count);
+
+	Jobs::JobCounter summaryCounter;
+	jobSystem.Dispatch(summaryCounter, static_cast<uint32_t>(ranges.size()), 1, [this, &ranges, &decoded](uint32_t index)
+		{
+			const Scene::SceneReader::EntityRange& range = ranges[index];
+			int32_t record = range.recordData ? static_cast<int32_t>(range.recordData - journalRecords.data()) : -1;
+
+			// Entities in a chunk share inline payloads, each is hashed once
+			std::unordered_map<const uint8_t*, uint64_t> inlineHashes;
+			for (uint32_t i = 0; i < range.count; ++i)
+			{
+				Summarise(range.entities->Get(range.begin + i), record, decoded[range.firstEntity + i], inlineHashes);
+			}
+		});
+	jobSystem.Wait(summaryCounter);
+
+	ReplayJournal(decoded, baseCount);
+	return true;
+}
+
+const BlackJawz::Tools::EntitySummary* BlackJawz::Tools::SceneSummary::Find(uint32_t id) const
+{
+	auto it = indices.find(id);
+	return it != indices.end() ? &entities[it->second] : nullptr;
+}
+
+uint64_t BlackJawz::Tools::SceneSummary::HashBlob(const flatbuffers::Vector<uint8_t>* vector, int32_t assetIndex,
+	std::unordered_map<const uint8_t*, uint64_t>& inlineHashes) const
+{
+	// Matches SceneReader::ReadBlob, asset indices win over inline bytes
+	if (assetIndex >= 0)
+	{
+		const auto* fileAssets = fileScene->assets();
+		if (!fileAssets || static_cast<uint32_t>(assetIndex) >= fileAssets->size())
+			return 0;
+		return fileAssets->Get(assetIndex)->hash();
+	}
+
+	if (!vector || vector->size() == 0)
+		return 0;
+
+	auto it = inlineHashes.find(vector->data());
+	if (it != inlineHashes.end())
+		return it->second;
+
+	uint64_t hash = Scene::SceneAssets::HashBytes(vector->data(), vector->size());
+	inlineHashes.emplace(vector->data(), hash);
+	return hash;
+}
+
+void BlackJawz::Tools::SceneSummary::Summarise(const ECS::Entity* entity, int32_t record, EntitySummary& summary,
+	std::unordered_map<const uint8_t*, uint64_t>& inlineHashes) const
+{
+	summary.id = entity->id();
+	if (entity->name())
+	{
+		summary.name = entity->name()->str();
+	}
+	summary.sources.push_back({ entity, record });
+
+	if (auto transform = entity->transform())
+	{
+		Scene::Reflection::ReadTable(transform, summary.transform.emplace());
+	}
+
+	// Only meaningful with geometry, as in SceneReader::ReadEntity
+	auto appearance = entity->appearance();
+	if (appearance && appearance->geometry())
+	{
+		auto geometry = appearance->geometry();
+
+		AppearanceSummary& appearanceSummary = summary.appearance.emplace();
+		appearanceSummary.indicesCount = geometry->indices_count();
+		appearanceSummary.vertexBufferStride = geometry->vertex_buffer_stride();
+		appearanceSummary.vertexBufferOffset = geometry->vertex_buffer_offset();
+		appearanceSummary.vertexFormat = static_cast<Scene::VertexFormat>(geometry->vertex_format());
+		appearanceSummary.vertexBufferHash = HashBlob(geometry->vertex_buffer(), geometry->vertex_buffer_asset(), inlineHashes);
+		appearanceSummary.indexBufferHash = HashBlob(geometry->index_buffer(), geometry->index_buffer_asset(), inlineHashes);
+
+		if (geometry->bounds_min() && geometry->bounds_min()->size() >= 3 && geometry->bounds_max() && geometry->bounds_max()->size() >= 3)
+		{
+			Scene::BoundsData& bounds = appearanceSummary.bounds.emplace();
+			memcpy(bounds.min, geometry->bounds_min()->data(), sizeof(bounds.min));
+			memcpy(bounds.max, geometry->bounds_max()->data(), sizeof(bounds.max));
+		}
+
+		if (auto texture = appearance->texture())
+		{
+			auto& hashes = appearanceSummary.textureHashes;
+			hashes[static_cast<size_t>(Scene::TextureSlot::Diffuse)] = HashBlob(texture->dds_data_diffuse(), texture->dds_asset_diffuse(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::Normal)] = HashBlob(texture->dds_data_normal(), texture->dds_asset_normal(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::Metal)] = HashBlob(texture->dds_data_metal(), texture->dds_asset_metal(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::Roughness)] = HashBlob(texture->dds_data_roughness(), texture->dds_asset_roughness(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::AO)] = HashBlob(texture->dds_data_ao(), texture->dds_asset_ao(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::Displacement)] = HashBlob(texture->dds_data_displacement(), texture->dds_asset_displacement(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::Packed)] = HashBlob(texture->dds_data_packed(), texture->dds_asset_packed(), inlineHashes);
+			hashes[static_cast<size_t>(Scene::TextureSlot::ConeStep)] = HashBlob(texture->dds_data_cone_step(), texture->dds_asset_cone_step(), inlineHashes);
+		}
+
+		if (auto instances = appearance->instances())
+		{
+			appearanceSummary.hasInstances = true;
+			if (auto transforms = instances->transforms())
+			{
+				appearanceSummary.instanceCount = transforms->size();
+				appearanceSummary.instanceTransformsHash = Scene::SceneAssets::HashBytes(reinterpret_cast<const uint8_t*>(transforms->Data()),
+					transforms->size() * sizeof(Scene::InstanceTransformData));
+			}
+
+			// Params the loader would drop are left out here too
+			auto params = instances->params();
+			if (params && instances->param_stride() > 0 &&
+				params->size() == static_cast<uint64_t>(instances->param_stride()) * appearanceSummary.instanceCount)
+			{
+				appearanceSummary.instanceParamStride = instances->param_stride();
+				appearanceSummary.instanceParamsHash = Scene::SceneAssets::HashBytes(reinterpret_cast<const uint8_t*>(params->data()),
+					params->size() * sizeof(float));
+			}
+		}
+	}
+
+	if (auto light = entity->light())
+	{
+		Scene::Reflection::ReadTable(light, summary.light.emplace());
+	}
+}
+
+void BlackJawz::Tools::SceneSummary::ReplayJournal(std::vector<EntitySummary>& decoded, size_t baseCount)
+{
+	// The same rules as SceneLoader::ReplayJournal, summaries stand in for the decoded entities
+	std::vector<bool> live(decoded.size(), false);
+	std::unordered_map<uint32_t, size_t> liveIndices;
+	liveIndices.reserve(decoded.size());
+
+	for (size_t i = 0; i < baseCount; ++i)
+	{
+		live[i] = true;
+		liveIndices[decoded[i].id] = i;
+	}
+
+	size_t next = baseCount;
+	for (const Scene::Blob& record : journalRecords)
+	{
+		const ECS::SceneDelta* delta = flatbuffers::GetRoot<ECS::SceneDelta>(record.data);
+
+		if (delta->removed())
+		{
+			for (uint32_t id : *delta->removed())
+			{
+				auto it = liveIndices.find(id);
+				if (it != liveIndices.end())
+				{
+					live[it->second] = false;
+					liveIndices.erase(it);
+				}
+			}
+		}
+
+		uint32_t deltaCount = delta->entities() ? delta->entities()->size() : 0;
+		for (uint32_t i = 0; i < deltaCount; ++i, ++next)
+		{
+			EntitySummary& update = decoded[next];
+
+			auto it = liveIndices.find(update.id);
+			if (it == liveIndices.end())
+			{
+				live[next] = true;
+				liveIndices.emplace(update.id, next);
+				continue;
+			}
+
+			EntitySummary& target = decoded[it->second];
+			if (update.sources.front().entity->name())
+				target.name = std::move(update.name);
+			if (update.transform)
+				target.transform = std::move(update.transform);
+			if (update.appearance)
+				target.appearance = std::move(update.appearance);
+			if (update.light)
+				target.light = std::move(update.light);
+			target.sources.push_back(update.sources.front());
+		}
+	}
+
+	entities.reserve(liveIndices.size());
+	for (size_t i = 0; i < decoded.size(); ++i)
+	{
+		if (!live[i])
+			continue;
+
+		indices[decoded[i].id] = entities.size();
+		entities.push_back(std::move(decoded[i]));
+	}
+}
+
+bool BlackJawz::Tools::SceneSummary::DecodeAssets(const std::vector<const EntitySummary*>& used, Jobs::JobSystem& jobSystem)
+{
+	const auto* fileAssets = fileScene ? fileScene->assets() : nullptr;
+	if (!fileAssets || fileAssets->size() == 0)
+		return true;
+
+	assets.resize(fileAssets->size());
+
+	std::vector<uint32_t> pending;
+	std::vector<bool> needed(fileAssets->size(), false);
+	for (const EntitySummary* summary : used)
+	{
+		for (const EntitySource& source : summary->sources)
+		{
+			Scene::SceneReader::ForEachAssetIndex(source.entity, [&](int32_t index)
+				{
+					if (index < 0 || static_cast<uint32_t>(index) >= fileAssets->size() || needed[index] || !assets[index].Empty())
+						return;
+
+					needed[index] = true;
+					pending.push_back(static_cast<uint32_t>(index));
+				});
+		}
+	}
+
+	std::atomic<size_t> failedCount{ 0 };
+
+	Jobs::JobCounter assetCounter;
+	jobSystem.Dispatch(assetCounter, static_cast<uint32_t>(pending.size()), 1, [&](uint32_t index)
+		{
+			uint32_t asset = pending[index];
+			if (!Scene::SceneAssets::Decode(fileAssets->Get(asset), fileData, assets[asset]))
+				failedCount.fetch_add(1, std::memory_order_relaxed);
+		});
+	jobSystem.Wait(assetCounter);
+
+	if (failedCount.load() > 0)
+	{
+		lastError = std::to_string(failedCount.load()) + " assets failed to decode";
+		return false;
+	}
+	return true;
+}
+
+void BlackJawz::Tools::SceneSummary::ReadEntity(const EntitySummary& summary, Scene::EntityData& data) const
+{
+	data = Scene::EntityData();
+
+	for (const EntitySource& source : summary.sources)
+	{
+		const Scene::Blob& sourceData = source.record < 0 ? fileData : journalRecords[source.record];
+
+		if (&source == &summary.sources.front())
+		{
+			Scene::SceneReader::ReadEntity(source.entity, sourceData, assets, data);
+			continue;
+		}
+
+		// Journal entries only carry what changed
+		Scene::EntityData update;
+		Scene::SceneReader::ReadEntity(source.entity, sourceData, assets, update);
+		if (source.entity->name())
+			data.name = std::move(update.name);
+		if (update.transform)
+			data.transform = std::move(update.transform);
+		if (update.appearance)
+			data.appearance = std::move(update.appearance);
+		if (update.light)
+			data.light = std::move(update.light);
+	}
+}
+
+void BlackJawz::Tools::DiffAppearance(const AppearanceSummary& a, const AppearanceSummary& b, std::vector<std::string>& fields)
+{
+	auto compare = [&fields](const std::string& field, bool same)
+		{
+			if (!same)
+				fields.push_back("appearance." + field);
+		};
+
+	compare("indicesCount", a.indicesCount == b.indicesCount);
+	compare("vertexBufferStride", a.vertexBufferStride == b.vertexBufferStride);
+	compare("vertexBufferOffset", a.vertexBufferOffset == b.vertexBufferOffset);
+	compare("vertexFormat", a.vertexFormat == b.vertexFormat);
+	compare("bounds", a.bounds.has_value() == b.bounds.has_value() &&
+		(!a.bounds || memcmp(&*a.bounds, &*b.bounds, sizeof(Scene::BoundsData)) == 0));
+	compare("vertexBuffer", a.vertexBufferHash == b.vertexBufferHash);
+	compare("indexBuffer", a.indexBufferHash == b.indexBufferHash);
+
+	for (size_t slot = 0; slot < Scene::TextureSlotCount; ++slot)
+	{
+		compare(std::string("textures.") + TextureSlotNames[slot], a.textureHashes[slot] == b.textureHashes[slot]);
+	}
+
+	if (a.hasInstances != b.hasInstances)
+	{
+		compare("instances", false);
+		return;
+	}
+	compare("instances.transforms", a.instanceCount == b.instanceCount && a.instanceTransformsHash == b.instanceTransformsHash);
+	compare("instances.params", a.instanceParamStride == b.instanceParamStride && a.instanceParamsHash == b.instanceParamsHash);
+}
+
+void BlackJawz::Tools::DiffEntity(const EntitySummary& a, const EntitySummary& b, std::vector<std::string>& fields)
+{
+	if (a.name != b.name)
+		fields.push_back("name");
+
+	DiffRecord("transform", a.transform, b.transform, fields);
+
+	if (a.appearance.has_value() != b.appearance.has_value())
+	{
+		fields.push_back("appearance");
+	}
+	else if (a.appearance)
+	{
+		DiffAppearance(*a.appearance, *b.appearance, fields);
+	}
+
+	DiffRecord("light", a.light, b.light, fields);
+}
+
+std::vector<BlackJawz::Tools::EntityChange> BlackJawz::Tools::DiffScenes(const SceneSummary& a, const SceneSummary& b)
+{
+	std::vector<EntityChange> changes;
+
+	for (const EntitySummary& entity : a.GetEntities())
+	{
+		const EntitySummary* other = b.Find(entity.id);
+		if (!other)
+		{
+			changes.push_back({ ChangeKind::Removed, entity.id, entity.name, {} });
+			continue;
+		}
+
+		EntityChange change{ ChangeKind::Changed, entity.id, other->name, {} };
+		DiffEntity(entity, *other, change.fields);
+		if (!change.fields.empty())
+			changes.push_back(std::move(change));
+	}
+
+	for (const EntitySummary& entity : b.GetEntities())
+	{
+		if (!a.Find(entity.id))
+			changes.push_back({ ChangeKind::Added, entity.id, entity.name, {} });
+	}
+
+	return changes;
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "Scene/SceneData.h"
+#include "Scene/SceneReflection.h"
+#include "Util/JobSystem.h"
+
+#include <unordered_map>
+
+#undef min
+#undef max
+#include <flatbuffers/flatbuffers.h>
+#include "ecs_generated.h"
+
+namespace BlackJawz::Tools
+{
+	// An appearance with its payloads reduced to content hashes, 0 for an empty payload
+	struct AppearanceSummary
+	{
+		uint32_t indicesCount = 0;
+		uint32_t vertexBufferStride = 0;
+		uint32_t vertexBufferOffset = 0;
+		Scene::VertexFormat vertexFormat = Scene::VertexFormat::Float;
+		std::optional<Scene::BoundsData> bounds;
+
+		uint64_t vertexBufferHash = 0;
+		uint64_t indexBufferHash = 0;
+		std::array<uint64_t, Scene::TextureSlotCount> textureHashes = {};
+
+		bool hasInstances = false;
+		size_t instanceCount = 0;
+		uint32_t instanceParamStride = 0;
+		uint64_t instanceTransformsHash = 0;
+		uint64_t instanceParamsHash = 0;
+	};
+
+	// One version of an entity as stored, in the scene file or in a journal record
+	struct EntitySource
+	{
+		const ECS::Entity* entity = nullptr;
+		int32_t record = -1; // Journal record holding it, -1 for the scene file
+	};
+
+	struct EntitySummary
+	{
+		uint32_t id = 0;
+		std::string name;
+
+		std::optional<Scene::TransformData> transform;
+		std::optional<AppearanceSummary> appearance;
+		std::optional<Scene::LightData> light;
+
+		// The base entity and the journal entries replayed over it, in order
+		std::vector<EntitySource> sources;
+	};
+
+	// A scene file and its journal mapped into memory and reduced to one summary per live entity.
+	// Asset payloads are compared by the hash stored next to them, so their pages are never read,
+	// and only the entities a merge keeps are decoded in full.
+	class SceneSummary
+	{
+	public:
+		SceneSummary() = default;
+		SceneSummary(const SceneSummary&) = delete;
+		SceneSummary& operator=(const SceneSummary&) = delete;
+
+		// Summarises each chunk on the job system, then replays the journal like the loader does
+		bool Open(const std::string& filename, Jobs::JobSystem& jobSystem);
+
+		// Live entities in file order, entities added by the journal last
+		const std::vector<EntitySummary>& GetEntities() const { return entities; }
+		const EntitySummary* Find(uint32_t id) const;
+
+		// Decompresses every asset the entities reference, ReadEntity needs them
+		bool DecodeAssets(const std::vector<const EntitySummary*>& used, Jobs::JobSystem& jobSystem);
+
+		// The entity with its payloads, which point into the mapped file or the decoded assets
+		void ReadEntity(const EntitySummary& summary, Scene::EntityData& data) const;
+
+		uint64_t GetFileBytes() const { return fileData.size; }
+		size_t GetJournalRecordCount() const { return journalRecords.size(); }
+		const std::string& GetLastError() const { return lastError; }
+
+	private:
+		void Summarise(const ECS::Entity* entity, int32_t record, EntitySummary& summary,
+			std::unordered_map<const uint8_t*, uint64_t>& inlineHashes) const;
+		uint64_t HashBlob(const flatbuffers::Vector<uint8_t>* vector, int32_t assetIndex,
+			std::unordered_map<const uint8_t*, uint64_t>& inlineHashes) const;
+		void ReplayJournal(std::vector<EntitySummary>& decoded, size_t baseCount);
+
+		Scene::Blob fileData;
+		std::vector<Scene::Blob> journalRecords;
+		const ECS::Scene* fileScene = nullptr;
+
+		std::vector<EntitySummary> entities;
+		std::unordered_map<uint32_t, size_t> indices;
+
+		std::vector<Scene::Blob> assets; // Filled in by DecodeAssets
+		std::string lastError;
+	};
+
+	// Stored fields that are not worked out from others, the world matrix follows from the rest of the transform
+	template <typename T>
+	bool IsComparedField(const Scene::Reflection::FieldInfo& field)
+	{
+		if constexpr (std::is_same_v<T, Scene::TransformData>)
+		{
+			if (field.slot == ECS::Transform::VT_WORLD_MATRIX)
+				return false;
+		}
+		return field.slot != 0;
+	}
+
+	// Fields are compared as stored, bit for bit
+	template <typename T>
+	bool SameField(const T& a, const T& b, const Scene::Reflection::FieldInfo& field)
+	{
+		return memcmp(reinterpret_cast<const uint8_t*>(&a) + field.offset, reinterpret_cast<const uint8_t*>(&b) + field.offset, field.size) == 0;
+	}
+
+	template <typename T>
+	bool SameRecord(const T& a, const T& b)
+	{
+		for (const Scene::Reflection::FieldInfo& field : Scene::Reflection::Reflect<T>::Fields)
+		{
+			if (IsComparedField<T>(field) && !SameField(a, b, field))
+				return false;
+		}
+		return true;
+	}
+
+	// Changed appearance fields, named like "appearance.textures.normal"
+	void DiffAppearance(const AppearanceSummary& a, const AppearanceSummary& b, std::vector<std::string>& fields);
+
+	// Changed fields of an entity, named like "transform.position", a whole component when it was
+	// added or removed. The world matrix is derived from the other transform fields and skipped.
+	void DiffEntity(const EntitySummary& a, const EntitySummary& b, std::vector<std::string>& fields);
+
+	enum class ChangeKind
+	{
+		Added,
+		Removed,
+		Changed
+	};
+
+	struct EntityChange
+	{
+		ChangeKind kind = ChangeKind::Changed;
+		uint32_t id = 0;
+		std::string name;
+		std::vector<std::string> fields; // Only for changed entities
+	};
+
+	// Entities are matched by id. Changes follow a's order, entities only in b come last.
+	std::vector<EntityChange> DiffScenes(const SceneSummary& a, const SceneSummary& b);
+}
@@ -0,0 +1,296 @@
+#include "SceneMerge.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneBounds.h"
+#include "Scene/SceneJournal.h"
+#include "Scene/SceneWriter.h"
+#include "Scene/SpatialIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+	using BlackJawz::Tools::AppearanceSummary;
+	using BlackJawz::Tools::EntitySummary;
+	using BlackJawz::Tools::MergePolicy;
+
+	enum class Side
+	{
+		Ours,
+		Theirs,
+		Conflict
+	};
+
+	// The side that changed a value wins, the same change on both sides is no conflict
+	Side PickSide(bool sameOursTheirs, bool sameBaseOurs, bool sameBaseTheirs)
+	{
+		if (sameOursTheirs || sameBaseTheirs)
+			return Side::Ours;
+		if (sameBaseOurs)
+			return Side::Theirs;
+		return Side::Conflict;
+	}
+
+	// Returns true to take theirs
+	bool Resolve(Side side, MergePolicy policy, const std::string& field, std::vector<std::string>& conflicts)
+	{
+		if (side == Side::Conflict)
+		{
+			conflicts.push_back(field);
+			return policy == MergePolicy::Theirs;
+		}
+		return side == Side::Theirs;
+	}
+
+	template <typename T>
+	bool SameOptional(const std::optional<T>& a, const std::optional<T>& b)
+	{
+		return a.has_value() == b.has_value() && (!a || BlackJawz::Tools::SameRecord(*a, *b));
+	}
+
+	bool SameAppearance(const std::optional<AppearanceSummary>& a, const std::optional<AppearanceSummary>& b)
+	{
+		if (a.has_value() != b.has_value())
+			return false;
+		if (!a)
+			return true;
+
+		std::vector<std::string> fields;
+		BlackJawz::Tools::DiffAppearance(*a, *b, fields);
+		return fields.empty();
+	}
+
+	bool Unchanged(const EntitySummary& base, const EntitySummary& entity)
+	{
+		std::vector<std::string> fields;
+		BlackJawz::Tools::DiffEntity(base, entity, fields);
+		return fields.empty();
+	}
+
+	// Field by field when every side has the component, whole when it was added or removed
+	template <typename T>
+	void MergeRecord(const char* component, const std::optional<T>* base, const std::optional<T>& ours, const std::optional<T>& theirs,
+		MergePolicy policy, std::optional<T>& result, std::vector<std::string>& conflicts)
+	{
+		if (!base || !*base || !ours || !theirs)
+		{
+			Side side = PickSide(SameOptional(ours, theirs), base && SameOptional(*base, ours), base && SameOptional(*base, theirs));
+			result = Resolve(side, policy, component, conflicts) ? theirs : ours;
+			return;
+		}
+
+		result = ours;
+		uint8_t* resultBytes = reinterpret_cast<uint8_t*>(&*result);
+		const uint8_t* theirsBytes = reinterpret_cast<const uint8_t*>(&*theirs);
+
+		for (const BlackJawz::Scene::Reflection::FieldInfo& field : BlackJawz::Scene::Reflection::Reflect<T>::Fields)
+		{
+			if (!BlackJawz::Tools::IsComparedField<T>(field))
+				continue;
+
+			Side side = PickSide(BlackJawz::Tools::SameField(*ours, *theirs, field),
+				BlackJawz::Tools::SameField(**base, *ours, field), BlackJawz::Tools::SameField(**base, *theirs, field));
+			if (Resolve(side, policy, std::string(component) + "." + field.name, conflicts))
+				memcpy(resultBytes + field.offset, theirsBytes + field.offset, field.size);
+		}
+	}
+
+	BlackJawz::Tools::MergedEntity FromSummary(const BlackJawz::Tools::SceneSummary& scene, const EntitySummary& summary)
+	{
+		BlackJawz::Tools::MergedEntity merged;
+		merged.id = summary.id;
+		merged.name = summary.name;
+		merged.transform = summary.transform;
+		merged.light = summary.light;
+		if (summary.appearance)
+		{
+			merged.appearanceScene = &scene;
+			merged.appearanceSource = &summary;
+		}
+		return merged;
+	}
+}
+
+BlackJawz::Tools::MergeResult BlackJawz::Tools::MergeScenes(const SceneSummary& base, const SceneSummary& ours, const SceneSummary& theirs,
+	MergePolicy policy)
+{
+	MergeResult result;
+	result.entities.reserve(std::max(ours.GetEntities().size(), theirs.GetEntities().size()));
+
+	for (const EntitySummary& entity : ours.GetEntities())
+	{
+		const EntitySummary* baseEntity = base.Find(entity.id);
+		const EntitySummary* theirsEntity = theirs.Find(entity.id);
+
+		if (!theirsEntity)
+		{
+			// Added by ours, or removed by theirs
+			if (baseEntity && Unchanged(*baseEntity, entity))
+				continue;
+
+			if (baseEntity)
+			{
+				result.conflicts.push_back({ entity.id, entity.name, { "entity" } });
+				if (policy == MergePolicy::Theirs)
+					continue;
+			}
+			result.entities.push_back(FromSummary(ours, entity));
+			continue;
+		}
+
+		MergedEntity merged;
+		merged.id = entity.id;
+		std::vector<std::string> conflicts;
+
+		Side nameSide = PickSide(entity.name == theirsEntity->name,
+			baseEntity && baseEntity->name == entity.name, baseEntity && baseEntity->name == theirsEntity->name);
+		merged.name = Resolve(nameSide, policy, "name", conflicts) ? theirsEntity->name : entity.name;
+
+		MergeRecord("transform", baseEntity ? &baseEntity->transform : nullptr, entity.transform, theirsEntity->transform,
+			policy, merged.transform, conflicts);
+
+		Side appearanceSide = PickSide(SameAppearance(entity.appearance, theirsEntity->appearance),
+			baseEntity && SameAppearance(baseEntity->appearance, entity.appearance),
+			baseEntity && SameAppearance(baseEntity->appearance, theirsEntity->appearance));
+		bool theirsAppearance = Resolve(appearanceSide, policy, "appearance", conflicts);
+		const EntitySummary& appearanceSource = theirsAppearance ? *theirsEntity : entity;
+		if (appearanceSource.appearance)
+		{
+			merged.appearanceScene = theirsAppearance ? &theirs : &ours;
+			merged.appearanceSource = &appearanceSource;
+		}
+
+		MergeRecord("light", baseEntity ? &baseEntity->light : nullptr, entity.light, theirsEntity->light,
+			policy, merged.light, conflicts);
+
+		// The stored world matrix may be from either side, it has to match the merged fields
+		if (merged.transform)
+		{
+			Scene::TransformData& transform = *merged.transform;
+			Scene::ComposeWorldMatrix(transform.position, transform.rotation, transform.scale, transform.worldMatrix);
+		}
+
+		if (!conflicts.empty())
+			result.conflicts.push_back({ entity.id, merged.name, std::move(conflicts) });
+
+		result.entities.push_back(std::move(merged));
+	}
+
+	for (const EntitySummary& entity : theirs.GetEntities())
+	{
+		if (ours.Find(entity.id))
+			continue;
+
+		// Added by theirs, or removed by ours
+		const EntitySummary* baseEntity = base.Find(entity.id);
+		if (baseEntity && Unchanged(*baseEntity, entity))
+			continue;
+
+		if (baseEntity)
+		{
+			result.conflicts.push_back({ entity.id, entity.name, { "entity" } });
+			if (policy != MergePolicy::Theirs)
+				continue;
+		}
+		result.entities.push_back(FromSummary(theirs, entity));
+	}
+
+	return result;
+}
+
+bool BlackJawz::Tools::WriteMergedScene(const std::string& output, const MergeResult& result, SceneSummary& ours, SceneSummary& theirs,
+	const MergeWriteOptions& options, Jobs::JobSystem& jobSystem, std::string& error)
+{
+	// Only the assets the kept appearances use are decompressed
+	std::vector<const EntitySummary*> oursUsed;
+	std::vector<const EntitySummary*> theirsUsed;
+	for (const MergedEntity& merged : result.entities)
+	{
+		if (merged.appearanceSource)
+			(merged.appearanceScene == &ours ? oursUsed : theirsUsed).push_back(merged.appearanceSource);
+	}
+
+	if (!ours.DecodeAssets(oursUsed, jobSystem))
+	{
+		error = ours.GetLastError();
+		return false;
+	}
+	if (!theirs.DecodeAssets(theirsUsed, jobSystem))
+	{
+		error = theirs.GetLastError();
+		return false;
+	}
+
+	std::vector<Scene::EntityData> entities(result.entities.size());
+	size_t chunkCount = Scene::SceneWriter::GetChunkCount(entities.size());
+
+	Jobs::JobCounter decodeCounter;
+	jobSystem.Dispatch(decodeCounter, static_cast<uint32_t>(chunkCount), 1, [&](uint32_t index)
+		{
+			size_t begin = index * Scene::SceneWriter::EntitiesPerChunk;
+			size_t end = std::min(begin + Scene::SceneWriter::EntitiesPerChunk, entities.size());
+			for (size_t i = begin; i < end; ++i)
+			{
+				const MergedEntity& merged = result.entities[i];
+				Scene::EntityData& data = entities[i];
+				data.id = merged.id;
+				data.name = merged.name;
+				data.transform = merged.transform;
+				data.light = merged.light;
+
+				if (merged.appearanceSource)
+				{
+					Scene::EntityData decoded;
+					merged.appearanceScene->ReadEntity(*merged.appearanceSource, decoded);
+					data.appearance = std::move(decoded.appearance);
+				}
+			}
+		});
+	jobSystem.Wait(decodeCounter);
+
+	Scene::SceneAssets assets(options.compressAssets);
+	assets.Collect(entities.data(), entities.size());
+
+	Jobs::JobCounter hashCounter;
+	jobSystem.Dispatch(hashCounter, static_cast<uint32_t>(assets.GetCount()), 1, [&assets](uint32_t index) { assets.Hash(index); });
+	jobSystem.Wait(hashCounter);
+
+	assets.Deduplicate();
+
+	Jobs::JobCounter compressCounter;
+	jobSystem.Dispatch(compressCounter, static_cast<uint32_t>(assets.GetCount()), 1, [&assets](uint32_t index) { assets.Compress(index); });
+	jobSystem.Wait(compressCounter);
+
+	Scene::SpatialIndex spatialIndex;
+	if (options.buildSpatialIndex)
+	{
+		spatialIndex.Build(entities, jobSystem);
+	}
+
+	// Chunks go to disk as they are encoded, the merged scene is never held in memory as a whole
+	Scene::SceneFileWriter writer(chunkCount, &assets, &spatialIndex);
+	if (!writer.Open(output))
+	{
+		error = "Failed to write " + output;
+		return false;
+	}
+
+	Jobs::JobCounter chunkCounter;
+	jobSystem.Dispatch(chunkCounter, static_cast<uint32_t>(chunkCount), 1, [&](uint32_t index)
+		{
+			size_t begin = index * Scene::SceneWriter::EntitiesPerChunk;
+			size_t count = std::min(Scene::SceneWriter::EntitiesPerChunk, entities.size() - begin);
+
+			writer.AddChunk(index, Scene::SceneWriter::WriteChunk(entities.data() + begin, count, &assets));
+		});
+	jobSystem.Wait(chunkCounter);
+
+	if (!writer.Finish())
+	{
+		error = "Failed to write " + output;
+		return false;
+	}
+
+	// The journal replayed into the inputs is part of the merged file, one left next to the output is stale
+	Scene::SceneJournal::Discard(output);
+	return true;
+}
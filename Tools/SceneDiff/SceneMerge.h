@@ -0,0 +1,53 @@
+#pragma once
+#include "SceneDiff.h"
+
+namespace BlackJawz::Tools
+{
+	// What to do with fields both sides changed differently
+	enum class MergePolicy
+	{
+		Report, // Keep ours and report the conflict, nothing should be written
+		Ours,
+		Theirs
+	};
+
+	struct MergedEntity
+	{
+		uint32_t id = 0;
+		std::string name;
+		std::optional<Scene::TransformData> transform;
+		std::optional<Scene::LightData> light;
+
+		// The appearance is taken whole from one side and decoded from there when writing
+		const SceneSummary* appearanceScene = nullptr;
+		const EntitySummary* appearanceSource = nullptr;
+	};
+
+	struct MergeConflict
+	{
+		uint32_t id = 0;
+		std::string name;
+		std::vector<std::string> fields; // "entity" when one side removed what the other changed
+	};
+
+	struct MergeResult
+	{
+		std::vector<MergedEntity> entities; // Ours order, entities only theirs has last
+		std::vector<MergeConflict> conflicts;
+	};
+
+	// Three-way merge by entity id. Names and appearances are merged whole, transforms and lights
+	// field by field, so moving an entity on one side and renaming it on the other does not conflict.
+	MergeResult MergeScenes(const SceneSummary& base, const SceneSummary& ours, const SceneSummary& theirs, MergePolicy policy);
+
+	struct MergeWriteOptions
+	{
+		bool compressAssets = true;
+		bool buildSpatialIndex = true;
+	};
+
+	// Decodes the payloads the merged entities keep and writes them as a new chunked scene with an
+	// asset section. The file is built in memory before it is written, like the cooker's output.
+	bool WriteMergedScene(const std::string& output, const MergeResult& result, SceneSummary& ours, SceneSummary& theirs,
+		const MergeWriteOptions& options, Jobs::JobSystem& jobSystem, std::string& error);
+}
@@ -0,0 +1,189 @@
+#include "SceneDiff.h"
+#include "SceneMerge.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+namespace
+{
+	void PrintUsage()
+	{
+		printf("Usage: SceneDiff [options] diff <a> <b>\n");
+		printf("       SceneDiff [options] merge <base> <ours> <theirs> -o <output>\n");
+		printf("Options:\n");
+		printf("  --threads N         Worker threads, defaults to one per hardware thread\n");
+		printf("  --ours, --theirs    Resolve merge conflicts towards one side instead of failing\n");
+		printf("  --no-compress       Store every asset of the merged scene raw\n");
+		printf("  --no-spatial-index  Leave the merged scene's BVH for the loader to build\n");
+		printf("Exit code 0 when the scenes match or merge cleanly, 1 when they differ or conflict, 2 on errors\n");
+	}
+
+	double ElapsedMs(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	void PrintFields(const std::vector<std::string>& fields)
+	{
+		for (size_t i = 0; i < fields.size(); ++i)
+		{
+			printf("%s%s", i > 0 ? ", " : "", fields[i].c_str());
+		}
+		printf("\n");
+	}
+
+	bool OpenScene(const std::string& filename, BlackJawz::Tools::SceneSummary& summary, BlackJawz::Jobs::JobSystem& jobSystem)
+	{
+		if (summary.Open(filename, jobSystem))
+			return true;
+
+		fprintf(stderr, "%s\n", summary.GetLastError().c_str());
+		return false;
+	}
+
+	int Diff(const std::string& a, const std::string& b, BlackJawz::Jobs::JobSystem& jobSystem)
+	{
+		using namespace BlackJawz::Tools;
+
+		auto start = std::chrono::steady_clock::now();
+		SceneSummary sceneA;
+		SceneSummary sceneB;
+		if (!OpenScene(a, sceneA, jobSystem) || !OpenScene(b, sceneB, jobSystem))
+			return 2;
+
+		std::vector<EntityChange> changes = DiffScenes(sceneA, sceneB);
+
+		size_t counts[3] = {};
+		for (const EntityChange& change : changes)
+		{
+			const char marker = change.kind == ChangeKind::Added ? '+' : change.kind == ChangeKind::Removed ? '-' : '~';
+			printf("%c %u \"%s\"", marker, change.id, change.name.c_str());
+			if (change.kind == ChangeKind::Changed)
+			{
+				printf(": ");
+				PrintFields(change.fields);
+			}
+			else
+			{
+				printf("\n");
+			}
+			++counts[static_cast<size_t>(change.kind)];
+		}
+
+		printf("%zu added, %zu removed, %zu changed of %zu -> %zu entities (%.2f MB -> %.2f MB) in %.1f ms\n",
+			counts[static_cast<size_t>(ChangeKind::Added)], counts[static_cast<size_t>(ChangeKind::Removed)],
+			counts[static_cast<size_t>(ChangeKind::Changed)], sceneA.GetEntities().size(), sceneB.GetEntities().size(),
+			sceneA.GetFileBytes() / (1024.0 * 1024.0), sceneB.GetFileBytes() / (1024.0 * 1024.0), ElapsedMs(start));
+
+		return changes.empty() ? 0 : 1;
+	}
+
+	int Merge(const std::string& base, const std::string& ours, const std::string& theirs, const std::string& output,
+		BlackJawz::Tools::MergePolicy policy, const BlackJawz::Tools::MergeWriteOptions& options, BlackJawz::Jobs::JobSystem& jobSystem)
+	{
+		using namespace BlackJawz::Tools;
+
+		// The inputs stay mapped while the output is written
+		for (const std::string& input : { base, ours, theirs })
+		{
+			std::error_code error;
+			if (std::filesystem::equivalent(input, output, error))
+			{
+				fprintf(stderr, "The output cannot replace an input: %s\n", output.c_str());
+				return 2;
+			}
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		SceneSummary baseScene;
+		SceneSummary oursScene;
+		SceneSummary theirsScene;
+		if (!OpenScene(base, baseScene, jobSystem) || !OpenScene(ours, oursScene, jobSystem) || !OpenScene(theirs, theirsScene, jobSystem))
+			return 2;
+
+		MergeResult result = MergeScenes(baseScene, oursScene, theirsScene, policy);
+		for (const MergeConflict& conflict : result.conflicts)
+		{
+			printf("! %u \"%s\": ", conflict.id, conflict.name.c_str());
+			PrintFields(conflict.fields);
+		}
+
+		if (!result.conflicts.empty() && policy == MergePolicy::Report)
+		{
+			printf("%zu conflicting entities, nothing written. Resolve them with --ours or --theirs\n", result.conflicts.size());
+			return 1;
+		}
+
+		std::string error;
+		if (!WriteMergedScene(output, result, oursScene, theirsScene, options, jobSystem, error))
+		{
+			fprintf(stderr, "%s\n", error.c_str());
+			return 2;
+		}
+
+		printf("%zu entities written to %s, %zu conflicts resolved, in %.1f ms\n",
+			result.entities.size(), output.c_str(), result.conflicts.size(), ElapsedMs(start));
+		return 0;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t threadCount = 0;
+	BlackJawz::Tools::MergePolicy policy = BlackJawz::Tools::MergePolicy::Report;
+	BlackJawz::Tools::MergeWriteOptions options;
+	std::string output;
+	std::vector<std::string> arguments;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+		{
+			threadCount = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else if (strcmp(argv[i], "--ours") == 0)
+		{
+			policy = BlackJawz::Tools::MergePolicy::Ours;
+		}
+		else if (strcmp(argv[i], "--theirs") == 0)
+		{
+			policy = BlackJawz::Tools::MergePolicy::Theirs;
+		}
+		else if (strcmp(argv[i], "--no-compress") == 0)
+		{
+			options.compressAssets = false;
+		}
+		else if (strcmp(argv[i], "--no-spatial-index") == 0)
+		{
+			options.buildSpatialIndex = false;
+		}
+		else if (argv[i][0] == '-')
+		{
+			PrintUsage();
+			return 2;
+		}
+		else
+		{
+			arguments.push_back(argv[i]);
+		}
+	}
+
+	// The calling thread helps while waiting, so it counts as a worker
+	BlackJawz::Jobs::JobSystem jobSystem(threadCount > 1 ? threadCount - 1 : threadCount);
+
+	if (arguments.size() == 3 && arguments[0] == "diff")
+		return Diff(arguments[1], arguments[2], jobSystem);
+
+	if (arguments.size() == 4 && arguments[0] == "merge" && !output.empty())
+		return Merge(arguments[1], arguments[2], arguments[3], output, policy, options, jobSystem);
+
+	PrintUsage();
+	return 2;
+}
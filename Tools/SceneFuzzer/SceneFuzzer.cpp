@@ -0,0 +1,124 @@
+#include "SceneFuzzer.h"
+#include "SceneBenchmark/SceneGenerator.h"
+#include "Scene/NullResourceBackend.h"
+#include "Scene/SceneAssets.h"
+#include "Scene/SceneBounds.h"
+#include "Scene/SceneLoader.h"
+#include "Scene/SceneWriter.h"
+#include "Scene/VertexPacking.h"
+
+#include <algorithm>
+
+namespace
+{
+	std::vector<uint8_t> WriteSeed(const std::vector<BlackJawz::Scene::EntityData>& entities, bool withAssets)
+	{
+		using namespace BlackJawz;
+
+		Scene::SceneAssets assets(true);
+		if (withAssets)
+		{
+			assets.Collect(entities.data(), entities.size());
+			for (size_t i = 0; i < assets.GetCount(); ++i)
+			{
+				assets.Hash(i);
+			}
+			assets.Deduplicate();
+			for (size_t i = 0; i < assets.GetCount(); ++i)
+			{
+				assets.Compress(i);
+			}
+		}
+
+		// Small chunks so the seeds hold several nested buffers
+		const size_t chunkSize = 4;
+		std::vector<flatbuffers::DetachedBuffer> chunks;
+		for (size_t begin = 0; begin < entities.size(); begin += chunkSize)
+		{
+			chunks.push_back(Scene::SceneWriter::WriteChunk(entities.data() + begin, std::min(chunkSize, entities.size() - begin),
+				withAssets ? &assets : nullptr));
+		}
+
+		// Every seed carries a spatial index, so its validation is fuzzed too
+		Scene::SpatialIndex spatialIndex;
+		Jobs::JobSystem jobSystem(1);
+		spatialIndex.Build(entities, jobSystem);
+
+		flatbuffers::DetachedBuffer scene = Scene::SceneWriter::MergeChunks(chunks, 0, withAssets ? &assets : nullptr, &spatialIndex);
+		return std::vector<uint8_t>(scene.data(), scene.data() + scene.size());
+	}
+}
+
+std::vector<std::vector<uint8_t>> BlackJawz::Tools::GenerateFuzzSeeds()
+{
+	GeneratorOptions options;
+	options.entityCount = 12;
+	options.textureSetCount = 2;
+	options.textureSize = 8;
+	options.lightFraction = 0.25f;
+
+	std::vector<Scene::EntityData> entities = GenerateScene(options);
+
+	// Packed vertices and instances on the same meshes
+	options.seed = 2;
+	options.instancesPerEntity = 3;
+	options.instanceParamStride = 2;
+	std::vector<Scene::EntityData> packed = GenerateScene(options);
+	for (auto& entity : packed)
+	{
+		if (entity.appearance)
+			Scene::PackVertices(entity.appearance->geometry);
+	}
+
+	return { WriteSeed(entities, false), WriteSeed(entities, true), WriteSeed(packed, true) };
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+	using namespace BlackJawz;
+
+	// Shared between runs, the loader waits for its jobs before returning
+	static Jobs::JobSystem jobSystem(1);
+
+	// Accepting uploads runs every resource through the upload queue
+	Scene::NullResourceBackend backend(true);
+	Scene::SceneLoader loader(jobSystem, backend);
+
+	Scene::LoadedScene scene;
+	if (!loader.BeginMemory(Scene::Blob::FromVector(std::vector<uint8_t>(data, data + size)), scene))
+		return 0;
+
+	loader.Wait();
+	if (loader.GetState() != Scene::SceneLoader::State::Decoded)
+		return 0;
+
+	// A stored index is walked as read, every query has to stay inside it
+	const float planes[6][4] =
+	{
+		{ 1.0f, 0.0f, 0.0f, 100.0f }, { -1.0f, 0.0f, 0.0f, 100.0f },
+		{ 0.0f, 1.0f, 0.0f, 100.0f }, { 0.0f, -1.0f, 0.0f, 100.0f },
+		{ 0.0f, 0.0f, 1.0f, 100.0f }, { 0.0f, 0.0f, -1.0f, 100.0f }
+	};
+	std::vector<uint32_t> visible;
+	scene.spatialIndex.QueryFrustum(planes, visible);
+
+	const float origin[3] = { -100.0f, 0.5f, 0.25f };
+	const float direction[3] = { 1.0f, 0.0f, 0.0f };
+	scene.spatialIndex.Raycast(origin, direction, 200.0f);
+
+	// The tools that read vertex data straight from decoded scenes
+	for (const Scene::EntityData& entity : scene.entities)
+	{
+		if (!entity.appearance)
+			continue;
+
+		Scene::ComputeBounds(entity.appearance->geometry);
+		if (entity.appearance->geometry.vertexFormat == Scene::VertexFormat::Packed)
+		{
+			Scene::GeometryData geometry = entity.appearance->geometry;
+			Scene::UnpackVertices(geometry);
+		}
+	}
+
+	return 0;
+}
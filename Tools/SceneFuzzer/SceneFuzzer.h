@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// libFuzzer entry point, also called by the standalone driver in main.cpp
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace BlackJawz::Tools
+{
+	// Small valid scenes covering every feature of the format, a starting corpus for the mutator
+	std::vector<std::vector<uint8_t>> GenerateFuzzSeeds();
+}
@@ -0,0 +1,211 @@
+// Standalone driver for compilers without libFuzzer. Replays the inputs it is given, then mutates
+// them at random. Flags follow libFuzzer's, so the same command line works with either build.
+#include "SceneFuzzer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+namespace
+{
+	// The input running when a sanitizer reports, written out so the crash can be replayed
+	const std::vector<uint8_t>* currentInput = nullptr;
+
+	void WriteCrashInput()
+	{
+		if (!currentInput)
+			return;
+
+		std::ofstream outFile("crash-input.bin", std::ios::binary | std::ios::trunc);
+		outFile.write(reinterpret_cast<const char*>(currentInput->data()), static_cast<std::streamsize>(currentInput->size()));
+		fprintf(stderr, "Input written to crash-input.bin\n");
+	}
+
+	void Run(const std::vector<uint8_t>& input)
+	{
+		currentInput = &input;
+		LLVMFuzzerTestOneInput(input.data(), input.size());
+		currentInput = nullptr;
+	}
+
+	bool ReadInput(const std::filesystem::path& path, std::vector<uint8_t>& input)
+	{
+		std::ifstream inFile(path, std::ios::binary);
+		if (!inFile)
+			return false;
+
+		input.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// A few edits of the kinds that break a FlatBuffer in interesting ways
+	void Mutate(std::vector<uint8_t>& input, std::mt19937& random, size_t maxLength)
+	{
+		auto pick = [&random](size_t count) { return count > 0 ? std::uniform_int_distribution<size_t>(0, count - 1)(random) : 0; };
+
+		uint32_t editCount = 1 + static_cast<uint32_t>(pick(8));
+		for (uint32_t edit = 0; edit < editCount; ++edit)
+		{
+			switch (pick(7))
+			{
+			case 0: // Flip a bit
+				if (!input.empty())
+					input[pick(input.size())] ^= static_cast<uint8_t>(1u << pick(8));
+				break;
+			case 1: // Random byte
+				if (!input.empty())
+					input[pick(input.size())] = static_cast<uint8_t>(random());
+				break;
+			case 2: // Offsets and sizes at the edges of their range
+				if (input.size() >= 4)
+				{
+					const uint32_t values[] = { 0, 1, 0x7F, 0x80, 0xFF, 0xFFFF, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF };
+					uint32_t value = values[pick(std::size(values))];
+					memcpy(input.data() + pick(input.size() - 3), &value, sizeof(value));
+				}
+				break;
+			case 3: // Truncate
+				input.resize(pick(input.size() + 1));
+				break;
+			case 4: // Erase a range
+				if (!input.empty())
+				{
+					size_t begin = pick(input.size());
+					input.erase(input.begin() + begin, input.begin() + begin + pick(input.size() - begin) + 1);
+				}
+				break;
+			case 5: // Insert random bytes
+			{
+				size_t position = pick(input.size() + 1);
+				std::vector<uint8_t> bytes(1 + pick(16));
+				for (uint8_t& byte : bytes)
+				{
+					byte = static_cast<uint8_t>(random());
+				}
+				input.insert(input.begin() + position, bytes.begin(), bytes.end());
+				break;
+			}
+			case 6: // Copy a range over another
+				if (input.size() >= 2)
+				{
+					size_t length = 1 + pick(std::min<size_t>(input.size() / 2, 64));
+					size_t from = pick(input.size() - length + 1);
+					size_t to = pick(input.size() - length + 1);
+					memmove(input.data() + to, input.data() + from, length);
+				}
+				break;
+			}
+		}
+
+		if (input.size() > maxLength)
+			input.resize(maxLength);
+	}
+
+	void PrintUsage()
+	{
+		printf("Usage: SceneFuzzer [options] [files or directories...]\n");
+		printf("Replays every input, then runs mutated copies of them. Without inputs it starts from generated scenes.\n");
+		printf("Options:\n");
+		printf("  -runs=N      Mutated runs after the replay, default 10000, -1 runs until stopped\n");
+		printf("  -seed=N      Mutation seed, default from the clock\n");
+		printf("  -max_len=N   Longest mutated input, default 1 MB\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	long long runs = 10000;
+	uint32_t seed = static_cast<uint32_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+	size_t maxLength = 1024 * 1024;
+	std::vector<std::vector<uint8_t>> corpus;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strncmp(argv[i], "-runs=", 6) == 0)
+			runs = strtoll(argv[i] + 6, nullptr, 10);
+		else if (strncmp(argv[i], "-seed=", 6) == 0)
+			seed = static_cast<uint32_t>(strtoul(argv[i] + 6, nullptr, 10));
+		else if (strncmp(argv[i], "-max_len=", 9) == 0)
+			maxLength = static_cast<size_t>(strtoull(argv[i] + 9, nullptr, 10));
+		else if (argv[i][0] == '-')
+		{
+			PrintUsage();
+			return 2;
+		}
+		else
+		{
+			std::error_code error;
+			std::filesystem::path path(argv[i]);
+			std::vector<std::filesystem::path> files;
+			if (std::filesystem::is_directory(path, error))
+			{
+				for (const auto& entry : std::filesystem::directory_iterator(path, error))
+				{
+					if (entry.is_regular_file())
+						files.push_back(entry.path());
+				}
+			}
+			else
+			{
+				files.push_back(path);
+			}
+
+			for (const auto& file : files)
+			{
+				std::vector<uint8_t> input;
+				if (!ReadInput(file, input))
+				{
+					fprintf(stderr, "Failed to read %s\n", file.string().c_str());
+					return 1;
+				}
+				corpus.push_back(std::move(input));
+			}
+		}
+	}
+
+#ifdef __SANITIZE_ADDRESS__
+	__sanitizer_set_death_callback(WriteCrashInput);
+#endif
+
+	if (corpus.empty())
+	{
+		corpus = BlackJawz::Tools::GenerateFuzzSeeds();
+	}
+
+	for (const auto& input : corpus)
+	{
+		Run(input);
+	}
+	printf("Replayed %zu inputs\n", corpus.size());
+
+	std::mt19937 random(seed);
+	auto start = std::chrono::steady_clock::now();
+	long long run = 0;
+	for (; runs < 0 || run < runs; ++run)
+	{
+		std::vector<uint8_t> input = corpus[std::uniform_int_distribution<size_t>(0, corpus.size() - 1)(random)];
+		Mutate(input, random, maxLength);
+		Run(input);
+
+		if ((run + 1) % 10000 == 0)
+		{
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			printf("#%lld runs, %.0f per second\n", run + 1, (run + 1) / seconds);
+			fflush(stdout);
+		}
+	}
+
+	printf("Done %lld runs with seed %u\n", run, seed);
+	return 0;
+}